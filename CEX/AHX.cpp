@@ -4,7 +4,6 @@
 #include "HKDF.h"
 #include "IntUtils.h"
 #include "MemUtils.h"
-#include "UInt128.h"
 
 NAMESPACE_BLOCK
 
@@ -49,6 +48,11 @@ const Digests AHX::KdfEngine()
 	return m_kdfEngineType;
 }
 
+KeyScheduleCache* &AHX::KeyCache()
+{
+	return m_keyCache;
+}
+
 const std::vector<SymmetricKeySize> &AHX::LegalKeySizes()
 {
 	return m_legalKeySizes;
@@ -93,6 +97,7 @@ AHX::AHX(Digests KdfEngineType, size_t Rounds)
 	m_isDestroyed(false),
 	m_isEncryption(false),
 	m_isInitialized(false),
+	m_keyCache(0),
 	m_legalKeySizes(0),
 	m_legalRounds(0),
 	m_rndCount(Rounds)
@@ -120,6 +125,7 @@ AHX::AHX(IDigest *KdfEngine, size_t Rounds)
 	m_isDestroyed(false),
 	m_isEncryption(false),
 	m_isInitialized(false),
+	m_keyCache(0),
 	m_legalKeySizes(0),
 	m_legalRounds(0),
 	m_rndCount(Rounds)
@@ -137,14 +143,22 @@ AHX::~AHX()
 
 //~~~Public Functions~~~//
 
-void AHX::DecryptBlock(const std::vector<byte> &Input, std::vector<byte> &Output)
+AHX* AHX::Clone()
 {
-	Decrypt128(Input, 0, Output, 0);
-}
+	if (!m_isInitialized)
+		throw CryptoSymmetricCipherException("AHX:Clone", "The cipher has not been initialized!");
 
-void AHX::DecryptBlock(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
-{
-	Decrypt128(Input, InOffset, Output, OutOffset);
+	// the copy owns a digest of the same type, and takes the expanded schedule as is
+	AHX* cpr = new AHX(m_kdfEngineType, m_rndCount);
+	cpr->m_cprKeySize = m_cprKeySize;
+	cpr->m_expKey = m_expKey;
+	cpr->m_kdfInfo = m_kdfInfo;
+	cpr->m_isEncryption = m_isEncryption;
+	cpr->m_keyCache = m_keyCache;
+	cpr->m_rndCount = m_rndCount;
+	cpr->m_isInitialized = true;
+
+	return cpr;
 }
 
 void AHX::Destroy()
@@ -173,16 +187,6 @@ void AHX::Destroy()
 	}
 }
 
-void AHX::EncryptBlock(const std::vector<byte> &Input, std::vector<byte> &Output)
-{
-	Encrypt128(Input, 0, Output, 0);
-}
-
-void AHX::EncryptBlock(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
-{
-	Encrypt128(Input, InOffset, Output, OutOffset);
-}
-
 void AHX::Initialize(bool Encryption, ISymmetricKey &KeyParams)
 {
 	if (!SymmetricKeySize::Contains(m_legalKeySizes, KeyParams.Key().size()))
@@ -201,47 +205,194 @@ void AHX::Initialize(bool Encryption, ISymmetricKey &KeyParams)
 	m_isInitialized = true;
 }
 
-void AHX::Transform(const std::vector<byte> &Input, std::vector<byte> &Output)
+void AHX::InitializeBatch(std::vector<AHX*> &Encryptors, std::vector<AHX*> &Decryptors, const std::vector<ISymmetricKey*> &KeyParams)
 {
-	if (m_isEncryption)
-		Encrypt128(Input, 0, Output, 0);
-	else
-		Decrypt128(Input, 0, Output, 0);
-}
+	const size_t KEYCNT = KeyParams.size();
 
-void AHX::Transform(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
-{
-	if (m_isEncryption)
-		Encrypt128(Input, InOffset, Output, OutOffset);
-	else
-		Decrypt128(Input, InOffset, Output, OutOffset);
+	if (Encryptors.size() == 0 && Decryptors.size() == 0)
+		throw CryptoSymmetricCipherException("AHX:InitializeBatch", "At least one set of ciphers is required!");
+	if (Encryptors.size() != 0 && Encryptors.size() != KEYCNT)
+		throw CryptoSymmetricCipherException("AHX:InitializeBatch", "The number of encryption ciphers must match the number of keys!");
+	if (Decryptors.size() != 0 && Decryptors.size() != KEYCNT)
+		throw CryptoSymmetricCipherException("AHX:InitializeBatch", "The number of decryption ciphers must match the number of keys!");
+
+	// batches are grouped by key length; 128, 256 and 512 bit keys
+	std::vector<size_t> idx128;
+	std::vector<size_t> idx256;
+	std::vector<size_t> idx512;
+
+	for (size_t i = 0; i < KEYCNT; ++i)
+	{
+		AHX* enc = (Encryptors.size() != 0) ? Encryptors[i] : 0;
+		AHX* dec = (Decryptors.size() != 0) ? Decryptors[i] : 0;
+
+		if ((Encryptors.size() != 0 && enc == 0) || (Decryptors.size() != 0 && dec == 0) || KeyParams[i] == 0)
+			throw CryptoSymmetricCipherException("AHX:InitializeBatch", "The cipher and key sets can not contain null members!");
+
+		// these are always legal key sizes for the standard key schedule
+		const size_t KEYLEN = KeyParams[i]->Key().size();
+		bool batch = (KEYLEN == 16 || KEYLEN == 32 || KEYLEN == 64);
+
+		if (enc != 0)
+			batch &= enc->m_kdfEngineType == Digests::None;
+		if (dec != 0)
+			batch &= dec->m_kdfEngineType == Digests::None;
+
+		if (!batch)
+		{
+			// hkdf and 192 bit key schedules are expanded individually
+			if (enc != 0)
+				enc->Initialize(true, *KeyParams[i]);
+			if (dec != 0)
+				dec->Initialize(false, *KeyParams[i]);
+		}
+		else
+		{
+			std::vector<size_t> &grp = (KEYLEN == 16) ? idx128 : (KEYLEN == 32) ? idx256 : idx512;
+			grp.push_back(i);
+
+			if (grp.size() == BATCH_KEYS)
+			{
+				ExpandBatch(Encryptors, Decryptors, KeyParams, grp);
+				grp.clear();
+			}
+		}
+	}
+
+	if (idx128.size() != 0)
+		ExpandBatch(Encryptors, Decryptors, KeyParams, idx128);
+	if (idx256.size() != 0)
+		ExpandBatch(Encryptors, Decryptors, KeyParams, idx256);
+	if (idx512.size() != 0)
+		ExpandBatch(Encryptors, Decryptors, KeyParams, idx512);
 }
 
-void AHX::Transform512(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
+void AHX::Rekey(ISymmetricKey &KeyParams)
 {
-	if (m_isEncryption)
-		Encrypt512(Input, InOffset, Output, OutOffset);
-	else
-		Decrypt512(Input, InOffset, Output, OutOffset);
+	if (!m_isInitialized)
+		throw CryptoSymmetricCipherException("AHX:Rekey", "The cipher has not been initialized!");
+	if (KeyParams.Key().size() * 8 != m_cprKeySize)
+		throw CryptoSymmetricCipherException("AHX:Rekey", "Invalid key size! The new key must be the same length as the current key.");
+	if (m_kdfEngineType != Enumeration::Digests::None && KeyParams.Info().size() > m_kdfInfoMax)
+		throw CryptoSymmetricCipherException("AHX:Rekey", "Invalid info size! Info parameter must be no longer than DistributionCodeMax size.");
+
+	if (KeyParams.Info().size() > 0)
+		m_kdfInfo = KeyParams.Info();
+
+	// the schedule is the same size, so the working key is overwritten in place
+	ExpandKey(m_isEncryption, KeyParams.Key());
 }
 
-void AHX::Transform1024(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
-{
-	if (m_isEncryption)
-		Encrypt1024(Input, InOffset, Output, OutOffset);
-	else
-		Decrypt1024(Input, InOffset, Output, OutOffset);
+//~~~Key Schedule~~~//
+
+void AHX::ExpandBatch(std::vector<AHX*> &Encryptors, std::vector<AHX*> &Decryptors, const std::vector<ISymmetricKey*> &KeyParams, const std::vector<size_t> &Index)
+{
+	const uint RCON[10] = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1B, 0x36 };
+	const size_t KEYCNT = Index.size();
+	const size_t KEYLEN = KeyParams[Index[0]]->Key().size();
+	// 1, 2, or 4 round keys are copied from the input key
+	const size_t KEYBLK = KEYLEN / 16;
+	// 10, 14, or 22 rounds
+	const size_t RNDCNT = (KEYLEN / 4) + 6;
+	const size_t SCHSZE = RNDCNT + 1;
+	const bool DECRYPT = Decryptors.size() != 0;
+	// schedules are built on the stack, the largest batch is 8 x 23 round keys
+	__m128i encKey[BATCH_KEYS * (MAXBATCH_ROUNDS + 1)];
+	__m128i decKey[BATCH_KEYS * (MAXBATCH_ROUNDS + 1)];
+
+	for (size_t j = 0; j < KEYCNT; ++j)
+	{
+		const std::vector<byte> &key = KeyParams[Index[j]]->Key();
+
+		for (size_t i = 0; i < KEYBLK; ++i)
+			encKey[(j * SCHSZE) + i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(key.data() + (i * 16)));
+	}
+
+	// the inverse schedule is reversed, with aesimc applied to all but the first and last round keys
+	if (DECRYPT)
+	{
+		for (size_t j = 0; j < KEYCNT; ++j)
+		{
+			for (size_t i = 0; i < KEYBLK; ++i)
+				decKey[(j * SCHSZE) + RNDCNT - i] = (i == 0) ? encKey[j * SCHSZE] : _mm_aesimc_si128(encKey[(j * SCHSZE) + i]);
+		}
+	}
+
+	// each round key depends on the previous one, so the keys are stepped together and the
+	// independent aeskeygenassist and aesimc instructions overlap in the AES unit
+	for (size_t i = KEYBLK, rcnCtr = 0; i < SCHSZE; ++i)
+	{
+		if (KEYBLK == 1 || (i & 1) == 0)
+		{
+			// the round constant is added after the key assist, so it need not be an immediate
+			const __m128i RC = _mm_set1_epi32(static_cast<int>(RCON[rcnCtr]));
+			++rcnCtr;
+
+			for (size_t j = 0; j < KEYCNT; ++j)
+			{
+				const size_t KOFF = (j * SCHSZE) + i;
+				__m128i rk = _mm_xor_si128(_mm_shuffle_epi32(_mm_aeskeygenassist_si128(encKey[KOFF - 1], 0x00), 0xFF), RC);
+				encKey[KOFF] = ExpandBatchBlock(encKey[KOFF - KEYBLK], rk);
+			}
+		}
+		else
+		{
+			for (size_t j = 0; j < KEYCNT; ++j)
+			{
+				const size_t KOFF = (j * SCHSZE) + i;
+				__m128i rk = _mm_shuffle_epi32(_mm_aeskeygenassist_si128(encKey[KOFF - 1], 0x00), 0xAA);
+				encKey[KOFF] = ExpandBatchBlock(encKey[KOFF - KEYBLK], rk);
+			}
+		}
+
+		if (DECRYPT)
+		{
+			for (size_t j = 0; j < KEYCNT; ++j)
+			{
+				const size_t KOFF = (j * SCHSZE) + i;
+				decKey[(j * SCHSZE) + RNDCNT - i] = (i == RNDCNT) ? encKey[KOFF] : _mm_aesimc_si128(encKey[KOFF]);
+			}
+		}
+	}
+
+	for (size_t j = 0; j < KEYCNT; ++j)
+	{
+		if (Encryptors.size() != 0)
+		{
+			AHX* cpr = Encryptors[Index[j]];
+			cpr->m_rndCount = RNDCNT;
+			cpr->m_expKey.assign(encKey + (j * SCHSZE), encKey + ((j + 1) * SCHSZE));
+			cpr->m_cprKeySize = KEYLEN * 8;
+			cpr->m_isEncryption = true;
+			cpr->m_isInitialized = true;
+		}
+
+		if (DECRYPT)
+		{
+			AHX* cpr = Decryptors[Index[j]];
+			cpr->m_rndCount = RNDCNT;
+			cpr->m_expKey.assign(decKey + (j * SCHSZE), decKey + ((j + 1) * SCHSZE));
+			cpr->m_cprKeySize = KEYLEN * 8;
+			cpr->m_isEncryption = false;
+			cpr->m_isInitialized = true;
+		}
+	}
+
+	std::memset(encKey, 0, sizeof(encKey));
+
+	if (DECRYPT)
+		std::memset(decKey, 0, sizeof(decKey));
 }
 
-void AHX::Transform2048(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
+__m128i AHX::ExpandBatchBlock(__m128i Previous, __m128i Assist)
 {
-	if (m_isEncryption)
-		Encrypt2048(Input, InOffset, Output, OutOffset);
-	else
-		Decrypt2048(Input, InOffset, Output, OutOffset);
-}
+	// 128, 256, 512 bit key method; the assist word is already broadcast
+	Previous = _mm_xor_si128(Previous, _mm_slli_si128(Previous, 0x4));
+	Previous = _mm_xor_si128(Previous, _mm_slli_si128(Previous, 0x4));
+	Previous = _mm_xor_si128(Previous, _mm_slli_si128(Previous, 0x4));
 
-//~~~Key Schedule~~~//
+	return _mm_xor_si128(Previous, Assist);
+}
 
 void AHX::ExpandKey(bool Encryption, const std::vector<byte> &Key)
 {
@@ -281,33 +432,41 @@ void AHX::SecureExpand(const std::vector<byte> &Key)
 	// expanded key size
 	size_t keySize = (blkWords * (m_rndCount + 1)) / 4;
 
-	// HKDF generator expands array 
-	Kdf::HKDF gen(m_kdfEngine);
+	std::vector<byte> rawKey(keySize * 16, 0);
 
-	// change 1.2: use extract only on an oversized key
-	if (Key.size() > m_kdfEngine->BlockSize())
-	{
-		// seperate salt and key
-		m_kdfKeySize = m_kdfEngine->BlockSize();
-		std::vector<byte> kdfKey(m_kdfKeySize, 0);
-		Utility::MemUtils::Copy(Key, 0, kdfKey, 0, m_kdfKeySize);
-		size_t saltSize = Key.size() - m_kdfKeySize;
-		std::vector<byte> kdfSalt(saltSize, 0);
-		Utility::MemUtils::Copy(Key, m_kdfKeySize, kdfSalt, 0, saltSize);
-		// info can be null
-		gen.Initialize(kdfKey, kdfSalt, m_kdfInfo);
-	}
-	else
+	// copy a cached schedule, or run the HKDF expansion and add the schedule to the cache
+	if (m_keyCache == 0 || !m_keyCache->Find(Enumeral(), m_kdfEngineType, m_rndCount, Key, m_kdfInfo, rawKey))
 	{
-		if (m_kdfInfo.size() != 0)
-			gen.Info() = m_kdfInfo;
+		// HKDF generator expands array 
+		Kdf::HKDF gen(m_kdfEngine);
 
-		gen.Initialize(Key);
-	}
+		// change 1.2: use extract only on an oversized key
+		if (Key.size() > m_kdfEngine->BlockSize())
+		{
+			// seperate salt and key
+			m_kdfKeySize = m_kdfEngine->BlockSize();
+			std::vector<byte> kdfKey(m_kdfKeySize, 0);
+			Utility::MemUtils::Copy(Key, 0, kdfKey, 0, m_kdfKeySize);
+			size_t saltSize = Key.size() - m_kdfKeySize;
+			std::vector<byte> kdfSalt(saltSize, 0);
+			Utility::MemUtils::Copy(Key, m_kdfKeySize, kdfSalt, 0, saltSize);
+			// info can be null
+			gen.Initialize(kdfKey, kdfSalt, m_kdfInfo);
+		}
+		else
+		{
+			if (m_kdfInfo.size() != 0)
+				gen.Info() = m_kdfInfo;
 
-	// generate the round keys
-	std::vector<byte> rawKey(keySize * 16, 0);
-	gen.Generate(rawKey);
+			gen.Initialize(Key);
+		}
+
+		// expand the round keys
+		gen.Generate(rawKey);
+
+		if (m_keyCache != 0)
+			m_keyCache->Add(Enumeral(), m_kdfEngineType, m_rndCount, Key, m_kdfInfo, rawKey);
+	}
 
 	// initialize working key
 	m_expKey.resize(keySize);
@@ -492,129 +651,6 @@ void AHX::ExpandSubBlock(std::vector<__m128i> &Key, const size_t Index, const si
 	Key[Index] = _mm_xor_si128(pkb, Key[Index]);
 }
 
-//~~~Rounds Processing~~~//
-
-void AHX::Decrypt128(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
-{
-	const size_t LRD = m_expKey.size() - 2;
-	size_t keyCtr = 0;
-
-	__m128i X = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Input[InOffset]));
-	X = _mm_xor_si128(X, m_expKey[keyCtr]);
-
-	while (keyCtr != LRD)
-		X = _mm_aesdec_si128(X, m_expKey[++keyCtr]);
-
-	_mm_storeu_si128(reinterpret_cast<__m128i*>(&Output[OutOffset]), _mm_aesdeclast_si128(X, m_expKey[++keyCtr]));
-}
-
-void AHX::Decrypt512(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
-{
-	const size_t LRD = m_expKey.size() - 2;
-	size_t keyCtr = 0;
-
-	Numeric::UInt128 X0(Input, InOffset);
-	Numeric::UInt128 X1(Input, InOffset + 16);
-	Numeric::UInt128 X2(Input, InOffset + 32);
-	Numeric::UInt128 X3(Input, InOffset + 48);
-
-	X0.xmm = _mm_xor_si128(X0.xmm, m_expKey[keyCtr]);
-	X1.xmm = _mm_xor_si128(X1.xmm, m_expKey[keyCtr]);
-	X2.xmm = _mm_xor_si128(X2.xmm, m_expKey[keyCtr]);
-	X3.xmm = _mm_xor_si128(X3.xmm, m_expKey[keyCtr]);
-
-	while (keyCtr != LRD)
-	{
-		X0.xmm = _mm_aesdec_si128(X0.xmm, m_expKey[++keyCtr]);
-		X1.xmm = _mm_aesdec_si128(X1.xmm, m_expKey[keyCtr]);
-		X2.xmm = _mm_aesdec_si128(X2.xmm, m_expKey[keyCtr]);
-		X3.xmm = _mm_aesdec_si128(X3.xmm, m_expKey[keyCtr]);
-	}
-
-	X0.xmm = _mm_aesdeclast_si128(X0.xmm, m_expKey[++keyCtr]);
-	X1.xmm = _mm_aesdeclast_si128(X1.xmm, m_expKey[keyCtr]);
-	X2.xmm = _mm_aesdeclast_si128(X2.xmm, m_expKey[keyCtr]);
-	X3.xmm = _mm_aesdeclast_si128(X3.xmm, m_expKey[keyCtr]);
-
-	X0.Store(Output, OutOffset);
-	X1.Store(Output, OutOffset + 16);
-	X2.Store(Output, OutOffset + 32);
-	X3.Store(Output, OutOffset + 48);
-}
-
-void AHX::Decrypt1024(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
-{
-	// no aes-ni 256 api.. yet
-	Decrypt512(Input, InOffset, Output, OutOffset);
-	Decrypt512(Input, InOffset + 64, Output, OutOffset + 64);
-}
-
-void AHX::Decrypt2048(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
-{
-	Decrypt1024(Input, InOffset, Output, OutOffset);
-	Decrypt1024(Input, InOffset + 128, Output, OutOffset + 128);
-}
-
-void AHX::Encrypt128(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
-{
-	const size_t LRD = m_expKey.size() - 2;
-	size_t keyCtr = 0;
-
-	__m128i X = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Input[InOffset]));
-	X = _mm_xor_si128(X, m_expKey[keyCtr]);
-
-	while (keyCtr != LRD)
-		X = _mm_aesenc_si128(X, m_expKey[++keyCtr]);
-
-	_mm_storeu_si128(reinterpret_cast<__m128i*>(&Output[OutOffset]), _mm_aesenclast_si128(X, m_expKey[++keyCtr]));
-}
-
-void AHX::Encrypt512(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
-{
-	const size_t LRD = m_expKey.size() - 2;
-	size_t keyCtr = 0;
-
-	Numeric::UInt128 X0(Input, InOffset);
-	Numeric::UInt128 X1(Input, InOffset + 16);
-	Numeric::UInt128 X2(Input, InOffset + 32);
-	Numeric::UInt128 X3(Input, InOffset + 48);
-
-	X0.xmm = _mm_xor_si128(X0.xmm, m_expKey[keyCtr]);
-	X1.xmm = _mm_xor_si128(X1.xmm, m_expKey[keyCtr]);
-	X2.xmm = _mm_xor_si128(X2.xmm, m_expKey[keyCtr]);
-	X3.xmm = _mm_xor_si128(X3.xmm, m_expKey[keyCtr]);
-
-	while (keyCtr != LRD)
-	{
-		X0.xmm = _mm_aesenc_si128(X0.xmm, m_expKey[++keyCtr]);
-		X1.xmm = _mm_aesenc_si128(X1.xmm, m_expKey[keyCtr]);
-		X2.xmm = _mm_aesenc_si128(X2.xmm, m_expKey[keyCtr]);
-		X3.xmm = _mm_aesenc_si128(X3.xmm, m_expKey[keyCtr]);
-	}
-
-	X0.xmm = _mm_aesenclast_si128(X0.xmm, m_expKey[++keyCtr]);
-	X1.xmm = _mm_aesenclast_si128(X1.xmm, m_expKey[keyCtr]);
-	X2.xmm = _mm_aesenclast_si128(X2.xmm, m_expKey[keyCtr]);
-	X3.xmm = _mm_aesenclast_si128(X3.xmm, m_expKey[keyCtr]);
-
-	X0.Store(Output, OutOffset);
-	X1.Store(Output, OutOffset + 16);
-	X2.Store(Output, OutOffset + 32);
-	X3.Store(Output, OutOffset + 48);
-}
-
-void AHX::Encrypt1024(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
-{
-	Encrypt512(Input, InOffset, Output, OutOffset);
-	Encrypt512(Input, InOffset + 64, Output, OutOffset + 64);
-}
-
-void AHX::Encrypt2048(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
-{
-	Encrypt1024(Input, InOffset, Output, OutOffset);
-	Encrypt1024(Input, InOffset + 128, Output, OutOffset + 128);
-}
-
 //~~~Helpers~~~//
 
 void AHX::LoadState(Digests KdfEngineType)
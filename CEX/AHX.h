@@ -37,6 +37,8 @@
 #if defined(__AVX__)
 
 #include "IBlockCipher.h"
+#include "KeyScheduleCache.h"
+#include "Rijndael.h"
 #include <wmmintrin.h>
 
 NAMESPACE_BLOCK
@@ -95,6 +97,9 @@ NAMESPACE_BLOCK
 /// <item><description>The recommended size for maximum security is 2* the digests block size; this calls HKDF Extract using full blocks of key and salt.</description></item>
 /// <item><description>Valid key sizes can be determined at run time using the <see cref="LegalKeySizes"/> property.</description></item>
 /// <item><description>The internal block size is 16 bytes wide.</description></item>
+/// <item><description>When compiled with AVX512 and VAES support (CEX_HAS_VAES), the 1024 and 2048 bit transforms process four blocks per 512bit instruction.</description></item>
+/// <item><description>The block transforms are defined in this header over the AHXEncryptW and AHXDecryptW kernels in Rijndael.h, so a cipher mode template specialized for AHX, ex. CTRT&lt;AHX&gt;, inlines the rounds into its loops.</description></item>
+/// <item><description>Many standard key schedules can be set up at once with InitializeBatch(), which interleaves the expansion of up to eight keys and builds the encryption and decryption schedules together.</description></item>
 /// <item><description>Diffusion rounds assignments are 10 to 38, the default is 22 (128-256 bit key), a 512 bit key is automatically assigned 22 rounds.</description></item>
 /// <item><description>Valid rounds assignments can be found in the <see cref="LegalRounds"/> property.</description></item>
 /// </list>
@@ -121,6 +126,9 @@ private:
 	static const std::string CLASS_NAME;
 	static const std::string DEF_DSTINFO;
 	static const size_t AES256_ROUNDS = 14;
+	// number of key schedules expanded in parallel by InitializeBatch
+	static const size_t BATCH_KEYS = 8;
+	static const size_t MAXBATCH_ROUNDS = 22;
 	static const size_t MAX_ROUNDS = 38;
 	static const size_t MIN_ROUNDS = 10;
 	// size of state buffer subtracted parallel size calculations
@@ -138,6 +146,7 @@ private:
 	bool m_isDestroyed;
 	bool m_isEncryption;
 	bool m_isInitialized;
+	KeyScheduleCache* m_keyCache;
 	std::vector<SymmetricKeySize> m_legalKeySizes;
 	std::vector<size_t> m_legalRounds;
 	size_t m_rndCount;
@@ -194,6 +203,13 @@ public:
 	/// </summary>
 	const Digests KdfEngine() override;
 
+	/// <summary>
+	/// Get/Set: An optional cache of HKDF expanded key schedules, shared between cipher instances.
+	/// <para>When set, and the cipher uses a KdfEngine, the key expansion copies a cached schedule instead of running HKDF.
+	/// The cache is not owned by the cipher, and must outlive it.</para>
+	/// </summary>
+	KeyScheduleCache* &KeyCache();
+
 	/// <summary>
 	/// Get: Available Encryption Key Sizes in bytes
 	/// </summary>
@@ -257,6 +273,18 @@ public:
 
 	//~~~Public Functions~~~//
 
+	/// <summary>
+	/// Create an initialized copy of this cipher.
+	/// <para>The expanded key schedule, direction, rounds and distribution code are copied, so the copy does not run the key expansion or HKDF again.
+	/// A KdfEngine instance passed to the constructor is not shared; the copy creates its own digest of the same type.
+	/// The KeyCache() pointer is copied. The caller is responsible for destroying the returned cipher.</para>
+	/// </summary>
+	///
+	/// <returns>A new, initialized AHX instance</returns>
+	///
+	/// <exception cref="Exception::CryptoSymmetricCipherException">Thrown if the cipher has not been initialized</exception>
+	AHX* Clone() override;
+
 	/// <summary>
 	/// Decrypt a single block of bytes.
 	/// <para><see cref="Initialize(bool, ISymmetricKey)"/> must be called with the Encryption flag set to <c>false</c> before this method can be used.
@@ -265,7 +293,10 @@ public:
 	/// 
 	/// <param name="Input">Encrypted bytes</param>
 	/// <param name="Output">Decrypted bytes</param>
-	void DecryptBlock(const std::vector<byte> &Input, std::vector<byte> &Output) override;
+	void DecryptBlock(const std::vector<byte> &Input, std::vector<byte> &Output) override
+	{
+		Decrypt128(Input, 0, Output, 0);
+	}
 
 	/// <summary>
 	/// Decrypt a block of bytes with offset parameters.
@@ -277,7 +308,10 @@ public:
 	/// <param name="InOffset">Starting offset within the input array</param>
 	/// <param name="Output">Decrypted bytes</param>
 	/// <param name="OutOffset">Starting offset within the output array</param>
-	void DecryptBlock(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset) override;
+	void DecryptBlock(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset) override
+	{
+		Decrypt128(Input, InOffset, Output, OutOffset);
+	}
 
 	/// <summary>
 	/// Clear the buffers and reset
@@ -292,7 +326,10 @@ public:
 	/// 
 	/// <param name="Input">The input array of bytes to transform</param>
 	/// <param name="Output">The output array of transformed bytes</param>
-	void EncryptBlock(const std::vector<byte> &Input, std::vector<byte> &Output) override;
+	void EncryptBlock(const std::vector<byte> &Input, std::vector<byte> &Output) override
+	{
+		Encrypt128(Input, 0, Output, 0);
+	}
 
 	/// <summary>
 	/// Encrypt a block of bytes with offset parameters.
@@ -304,7 +341,10 @@ public:
 	/// <param name="InOffset">Starting offset within the input array</param>
 	/// <param name="Output">The output array of transformed bytes</param>
 	/// <param name="OutOffset">Starting offset within the output array</param>
-	void EncryptBlock(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset) override;
+	void EncryptBlock(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset) override
+	{
+		Encrypt128(Input, InOffset, Output, OutOffset);
+	}
 
 	/// <summary>
 	/// Initialize the cipher
@@ -316,6 +356,31 @@ public:
 	/// <exception cref="CryptoSymmetricCipherException">Thrown if a null or invalid key is used</exception>
 	void Initialize(bool Encryption, ISymmetricKey &KeyParams) override;
 
+	/// <summary>
+	/// Initialize a set of ciphers from a set of keys, expanding the standard key schedules of up to eight keys at a time.
+	/// <para>The key generation steps of independent keys are interleaved, hiding the latency of the serial AES-NI key expansion chain.
+	/// The encryption and decryption schedules of a key are built in the same pass; either cipher set can be empty if only one direction is required.
+	/// 128, 256, and 512 bit keys used with the standard (Digests::None) key schedule are batched, other ciphers and key sizes are initialized individually.</para>
+	/// </summary>
+	///
+	/// <param name="Encryptors">The ciphers initialized for encryption, one per key; can be empty</param>
+	/// <param name="Decryptors">The ciphers initialized for decryption, one per key; can be empty</param>
+	/// <param name="KeyParams">The cipher key containers</param>
+	///
+	/// <exception cref="CryptoSymmetricCipherException">Thrown if the cipher sets do not match the number of keys, or a null cipher or invalid key is used</exception>
+	static void InitializeBatch(std::vector<AHX*> &Encryptors, std::vector<AHX*> &Decryptors, const std::vector<ISymmetricKey*> &KeyParams);
+
+	/// <summary>
+	/// Replace the cipher key, retaining the direction and the allocated cipher state.
+	/// <para>The cipher must be initialized, and the new key must be the same length as the current key.
+	/// With a KeyCache() assigned, rekeying to a previously used key and info skips the HKDF expansion.</para>
+	/// </summary>
+	///
+	/// <param name="KeyParams">Cipher key container; the key must be the same size as the current key</param>
+	///
+	/// <exception cref="Exception::CryptoSymmetricCipherException">Thrown if the cipher is not initialized, or the key or info size is invalid</exception>
+	void Rekey(ISymmetricKey &KeyParams);
+
 	/// <summary>
 	/// Transform a block of bytes.
 	/// <para><see cref="Initialize(bool, ISymmetricKey)"/> must be called before this method can be used.
@@ -324,7 +389,13 @@ public:
 	/// 
 	/// <param name="Input">The input array of bytes to transform or Decrypt</param>
 	/// <param name="Output">The output array of transformed bytes</param>
-	void Transform(const std::vector<byte> &Input, std::vector<byte> &Output) override;
+	void Transform(const std::vector<byte> &Input, std::vector<byte> &Output) override
+	{
+		if (m_isEncryption)
+			Encrypt128(Input, 0, Output, 0);
+		else
+			Decrypt128(Input, 0, Output, 0);
+	}
 
 	/// <summary>
 	/// Transform a block of bytes with offset parameters.
@@ -336,7 +407,13 @@ public:
 	/// <param name="InOffset">Starting offset in the Input array</param>
 	/// <param name="Output">The output array of transformed bytes</param>
 	/// <param name="OutOffset">Starting offset in the output array</param>
-	void Transform(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset) override;
+	void Transform(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset) override
+	{
+		if (m_isEncryption)
+			Encrypt128(Input, InOffset, Output, OutOffset);
+		else
+			Decrypt128(Input, InOffset, Output, OutOffset);
+	}
 
 	/// <summary>
 	/// Transform 4 blocks of bytes.
@@ -348,7 +425,13 @@ public:
 	/// <param name="InOffset">Starting offset in the Input array</param>
 	/// <param name="Output">The output array of transformed bytes</param>
 	/// <param name="OutOffset">Starting offset in the output array</param>
-	void Transform512(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset) override;
+	void Transform512(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset) override
+	{
+		if (m_isEncryption)
+			Encrypt512(Input, InOffset, Output, OutOffset);
+		else
+			Decrypt512(Input, InOffset, Output, OutOffset);
+	}
 
 	/// <summary>
 	/// Transform 8 blocks of bytes.
@@ -360,7 +443,13 @@ public:
 	/// <param name="InOffset">Starting offset in the Input array</param>
 	/// <param name="Output">The output array of transformed bytes</param>
 	/// <param name="OutOffset">Starting offset in the output array</param>
-	void Transform1024(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset) override;
+	void Transform1024(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset) override
+	{
+		if (m_isEncryption)
+			Encrypt1024(Input, InOffset, Output, OutOffset);
+		else
+			Decrypt1024(Input, InOffset, Output, OutOffset);
+	}
 
 	/// <summary>
 	/// Transform 16 blocks of bytes.
@@ -372,18 +461,74 @@ public:
 	/// <param name="InOffset">Starting offset in the Input array</param>
 	/// <param name="Output">The output array of transformed bytes</param>
 	/// <param name="OutOffset">Starting offset in the output array</param>
-	void Transform2048(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset) override;
+	void Transform2048(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset) override
+	{
+		if (m_isEncryption)
+			Encrypt2048(Input, InOffset, Output, OutOffset);
+		else
+			Decrypt2048(Input, InOffset, Output, OutOffset);
+	}
 
 private:
 
-	void Decrypt128(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset);
-	void Decrypt512(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset);
-	void Decrypt1024(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset);
-	void Decrypt2048(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset);
-	void Encrypt128(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset);
-	void Encrypt512(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset);
-	void Encrypt1024(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset);
-	void Encrypt2048(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset);
+	void Decrypt128(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
+	{
+		AHXDecryptW<1>(Input, InOffset, Output, OutOffset, m_expKey);
+	}
+
+	void Decrypt512(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
+	{
+		AHXDecryptW<4>(Input, InOffset, Output, OutOffset, m_expKey);
+	}
+
+	void Decrypt1024(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
+	{
+#if defined(CEX_HAS_VAES)
+		AHXDecryptVaes<2>(Input, InOffset, Output, OutOffset, m_expKey);
+#else
+		AHXDecryptW<8>(Input, InOffset, Output, OutOffset, m_expKey);
+#endif
+	}
+
+	void Decrypt2048(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
+	{
+#if defined(CEX_HAS_VAES)
+		AHXDecryptVaes<4>(Input, InOffset, Output, OutOffset, m_expKey);
+#else
+		AHXDecryptW<16>(Input, InOffset, Output, OutOffset, m_expKey);
+#endif
+	}
+
+	void Encrypt128(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
+	{
+		AHXEncryptW<1>(Input, InOffset, Output, OutOffset, m_expKey);
+	}
+
+	void Encrypt512(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
+	{
+		AHXEncryptW<4>(Input, InOffset, Output, OutOffset, m_expKey);
+	}
+
+	void Encrypt1024(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
+	{
+#if defined(CEX_HAS_VAES)
+		AHXEncryptVaes<2>(Input, InOffset, Output, OutOffset, m_expKey);
+#else
+		AHXEncryptW<8>(Input, InOffset, Output, OutOffset, m_expKey);
+#endif
+	}
+
+	void Encrypt2048(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
+	{
+#if defined(CEX_HAS_VAES)
+		AHXEncryptVaes<4>(Input, InOffset, Output, OutOffset, m_expKey);
+#else
+		AHXEncryptW<16>(Input, InOffset, Output, OutOffset, m_expKey);
+#endif
+	}
+
+	static void ExpandBatch(std::vector<AHX*> &Encryptors, std::vector<AHX*> &Decryptors, const std::vector<ISymmetricKey*> &KeyParams, const std::vector<size_t> &Index);
+	static __m128i ExpandBatchBlock(__m128i Previous, __m128i Assist);
 	void ExpandKey(bool Encryption, const std::vector<byte> &Key);
 	void ExpandRotBlock(std::vector<__m128i> &Key, __m128i* K1, __m128i* K2, __m128i KR, size_t Offset);
 	void ExpandRotBlock(std::vector<__m128i> &Key, const size_t Index, const size_t Offset);
@@ -0,0 +1,799 @@
+#include "AeadOneShot.h"
+#include "MemUtils.h"
+
+NAMESPACE_MODE
+
+//~~~Public Functions~~~//
+
+bool AeadOneShot::ChaChaPolyOpen(const std::vector<byte> &Key, const std::vector<byte> &Nonce, const std::vector<byte> &Associated, const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset, size_t Length)
+{
+	if (Key.size() != CHACHA_KEYSIZE)
+		throw CryptoCipherModeException("AeadOneShot:ChaChaPolyOpen", "Invalid key size! The key must be 32 bytes in length.");
+	if (Nonce.size() != IETF_NONCESIZE)
+		throw CryptoCipherModeException("AeadOneShot:ChaChaPolyOpen", "Invalid nonce size! The nonce must be 12 bytes in length.");
+
+	CheckBounds("AeadOneShot:ChaChaPolyOpen", Input.size(), InOffset, Length + TAG_SIZE, Output.size(), OutOffset, Length);
+
+	std::array<byte, CHACHA_BLOCK> polyKey;
+	std::array<byte, TAG_SIZE> code;
+
+	// block zero keys the authenticator, the cipher-text is verified before it is decrypted
+	ChaChaBlock(Key, Nonce, 0, polyKey);
+	PolyTag(polyKey, Associated, Input, InOffset, Length, code);
+	const bool AUTH = VerifyTag(code, Input, InOffset + Length);
+
+	if (AUTH)
+		ChaChaTransform(Key, Nonce, Input, InOffset, Output, OutOffset, Length);
+	else
+		Utility::MemUtils::Clear(Output, OutOffset, Length);
+
+	Utility::MemUtils::Clear(polyKey, 0, polyKey.size());
+	Utility::MemUtils::Clear(code, 0, code.size());
+
+	return AUTH;
+}
+
+void AeadOneShot::ChaChaPolySeal(const std::vector<byte> &Key, const std::vector<byte> &Nonce, const std::vector<byte> &Associated, const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset, size_t Length)
+{
+	if (Key.size() != CHACHA_KEYSIZE)
+		throw CryptoCipherModeException("AeadOneShot:ChaChaPolySeal", "Invalid key size! The key must be 32 bytes in length.");
+	if (Nonce.size() != IETF_NONCESIZE)
+		throw CryptoCipherModeException("AeadOneShot:ChaChaPolySeal", "Invalid nonce size! The nonce must be 12 bytes in length.");
+
+	CheckBounds("AeadOneShot:ChaChaPolySeal", Input.size(), InOffset, Length, Output.size(), OutOffset, Length + TAG_SIZE);
+
+	std::array<byte, CHACHA_BLOCK> polyKey;
+	std::array<byte, TAG_SIZE> code;
+
+	ChaChaBlock(Key, Nonce, 0, polyKey);
+	ChaChaTransform(Key, Nonce, Input, InOffset, Output, OutOffset, Length);
+	PolyTag(polyKey, Associated, Output, OutOffset, Length, code);
+	Utility::MemUtils::Copy(code, 0, Output, OutOffset + Length, TAG_SIZE);
+
+	Utility::MemUtils::Clear(polyKey, 0, polyKey.size());
+	Utility::MemUtils::Clear(code, 0, code.size());
+}
+
+#if defined(__AVX__)
+
+bool AeadOneShot::GcmOpen(const std::vector<byte> &Key, const std::vector<byte> &Nonce, const std::vector<byte> &Associated, const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset, size_t Length)
+{
+	if (Key.size() != 16 && Key.size() != 24 && Key.size() != 32)
+		throw CryptoCipherModeException("AeadOneShot:GcmOpen", "Invalid key size! The key must be 16, 24 or 32 bytes in length.");
+	if (Nonce.size() != GCM_NONCESIZE)
+		throw CryptoCipherModeException("AeadOneShot:GcmOpen", "Invalid nonce size! The nonce must be 12 bytes in length.");
+
+	CheckBounds("AeadOneShot:GcmOpen", Input.size(), InOffset, Length + TAG_SIZE, Output.size(), OutOffset, Length);
+
+	const __m128i BSWAP = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+	std::array<__m128i, 15> rndKey;
+	std::array<byte, BLOCK_SIZE> code;
+	const size_t RNDCNT = AesExpand(Key, rndKey);
+
+	// the hash key and the 96 bit nonce counter block J0
+	const __m128i H = _mm_shuffle_epi8(AesEncrypt(_mm_setzero_si128(), rndKey, RNDCNT), BSWAP);
+	code.fill(0);
+	Utility::MemUtils::Copy(Nonce, 0, code, 0, GCM_NONCESIZE);
+	code[BLOCK_SIZE - 1] = 1;
+	const __m128i J0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(code.data()));
+
+	__m128i tag = GcmAuthenticate(H, Associated, Input, InOffset, Length);
+	tag = _mm_xor_si128(tag, AesEncrypt(J0, rndKey, RNDCNT));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(code.data()), tag);
+	const bool AUTH = VerifyTag(code, Input, InOffset + Length);
+
+	if (AUTH)
+		GcmCtr(rndKey, RNDCNT, _mm_add_epi32(_mm_shuffle_epi8(J0, BSWAP), _mm_set_epi32(0, 0, 0, 1)), Input, InOffset, Output, OutOffset, Length);
+	else
+		Utility::MemUtils::Clear(Output, OutOffset, Length);
+
+	Utility::MemUtils::Clear(rndKey, 0, rndKey.size() * sizeof(__m128i));
+	Utility::MemUtils::Clear(code, 0, code.size());
+
+	return AUTH;
+}
+
+void AeadOneShot::GcmSeal(const std::vector<byte> &Key, const std::vector<byte> &Nonce, const std::vector<byte> &Associated, const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset, size_t Length)
+{
+	if (Key.size() != 16 && Key.size() != 24 && Key.size() != 32)
+		throw CryptoCipherModeException("AeadOneShot:GcmSeal", "Invalid key size! The key must be 16, 24 or 32 bytes in length.");
+	if (Nonce.size() != GCM_NONCESIZE)
+		throw CryptoCipherModeException("AeadOneShot:GcmSeal", "Invalid nonce size! The nonce must be 12 bytes in length.");
+
+	CheckBounds("AeadOneShot:GcmSeal", Input.size(), InOffset, Length, Output.size(), OutOffset, Length + TAG_SIZE);
+
+	const __m128i BSWAP = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+	std::array<__m128i, 15> rndKey;
+	std::array<byte, BLOCK_SIZE> code;
+	const size_t RNDCNT = AesExpand(Key, rndKey);
+
+	const __m128i H = _mm_shuffle_epi8(AesEncrypt(_mm_setzero_si128(), rndKey, RNDCNT), BSWAP);
+	code.fill(0);
+	Utility::MemUtils::Copy(Nonce, 0, code, 0, GCM_NONCESIZE);
+	code[BLOCK_SIZE - 1] = 1;
+	const __m128i J0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(code.data()));
+
+	// the counter is held byte reversed so the 32 bit increment is a single add
+	GcmCtr(rndKey, RNDCNT, _mm_add_epi32(_mm_shuffle_epi8(J0, BSWAP), _mm_set_epi32(0, 0, 0, 1)), Input, InOffset, Output, OutOffset, Length);
+	__m128i tag = GcmAuthenticate(H, Associated, Output, OutOffset, Length);
+	tag = _mm_xor_si128(tag, AesEncrypt(J0, rndKey, RNDCNT));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(&Output[OutOffset + Length]), tag);
+
+	Utility::MemUtils::Clear(rndKey, 0, rndKey.size() * sizeof(__m128i));
+	Utility::MemUtils::Clear(code, 0, code.size());
+}
+
+bool AeadOneShot::OcbOpen(const std::vector<byte> &Key, const std::vector<byte> &Nonce, const std::vector<byte> &Associated, const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset, size_t Length)
+{
+	if (Key.size() != 16 && Key.size() != 24 && Key.size() != 32)
+		throw CryptoCipherModeException("AeadOneShot:OcbOpen", "Invalid key size! The key must be 16, 24 or 32 bytes in length.");
+	if (Nonce.size() < OCB_MINNONCE || Nonce.size() > OCB_MAXNONCE)
+		throw CryptoCipherModeException("AeadOneShot:OcbOpen", "Invalid nonce size! The nonce must be between 12 and 15 bytes in length.");
+
+	CheckBounds("AeadOneShot:OcbOpen", Input.size(), InOffset, Length + TAG_SIZE, Output.size(), OutOffset, Length);
+
+	// the checksum is taken over the plain-text, so the output is decrypted first and cleared on failure
+	std::array<byte, TAG_SIZE> code;
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(code.data()), OcbProcess(false, Key, Nonce, Associated, Input, InOffset, Output, OutOffset, Length));
+	const bool AUTH = VerifyTag(code, Input, InOffset + Length);
+
+	if (!AUTH)
+		Utility::MemUtils::Clear(Output, OutOffset, Length);
+
+	Utility::MemUtils::Clear(code, 0, code.size());
+
+	return AUTH;
+}
+
+void AeadOneShot::OcbSeal(const std::vector<byte> &Key, const std::vector<byte> &Nonce, const std::vector<byte> &Associated, const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset, size_t Length)
+{
+	if (Key.size() != 16 && Key.size() != 24 && Key.size() != 32)
+		throw CryptoCipherModeException("AeadOneShot:OcbSeal", "Invalid key size! The key must be 16, 24 or 32 bytes in length.");
+	if (Nonce.size() < OCB_MINNONCE || Nonce.size() > OCB_MAXNONCE)
+		throw CryptoCipherModeException("AeadOneShot:OcbSeal", "Invalid nonce size! The nonce must be between 12 and 15 bytes in length.");
+
+	CheckBounds("AeadOneShot:OcbSeal", Input.size(), InOffset, Length, Output.size(), OutOffset, Length + TAG_SIZE);
+
+	const __m128i TAG = OcbProcess(true, Key, Nonce, Associated, Input, InOffset, Output, OutOffset, Length);
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(&Output[OutOffset + Length]), TAG);
+}
+
+#endif
+
+//~~~Private Functions~~~//
+
+void AeadOneShot::ChaChaBlock(const std::vector<byte> &Key, const std::vector<byte> &Nonce, uint Counter, std::array<byte, CHACHA_BLOCK> &Output)
+{
+	std::array<uint, 16> state;
+	std::array<uint, 16> x;
+
+	state[0] = 0x61707865;
+	state[1] = 0x3320646E;
+	state[2] = 0x79622D32;
+	state[3] = 0x6B206574;
+
+	for (size_t i = 0; i < 8; ++i)
+		state[4 + i] = Utility::IntUtils::LeBytesTo32(Key, i * sizeof(uint));
+
+	state[12] = Counter;
+	state[13] = Utility::IntUtils::LeBytesTo32(Nonce, 0);
+	state[14] = Utility::IntUtils::LeBytesTo32(Nonce, 4);
+	state[15] = Utility::IntUtils::LeBytesTo32(Nonce, 8);
+	x = state;
+
+	for (size_t i = 0; i < 10; ++i)
+	{
+		ChaChaRound(x, 0, 4, 8, 12);
+		ChaChaRound(x, 1, 5, 9, 13);
+		ChaChaRound(x, 2, 6, 10, 14);
+		ChaChaRound(x, 3, 7, 11, 15);
+		ChaChaRound(x, 0, 5, 10, 15);
+		ChaChaRound(x, 1, 6, 11, 12);
+		ChaChaRound(x, 2, 7, 8, 13);
+		ChaChaRound(x, 3, 4, 9, 14);
+	}
+
+	for (size_t i = 0; i < 16; ++i)
+		Utility::IntUtils::Le32ToBytes(x[i] + state[i], Output, i * sizeof(uint));
+
+	Utility::MemUtils::Clear(state, 0, state.size() * sizeof(uint));
+	Utility::MemUtils::Clear(x, 0, x.size() * sizeof(uint));
+}
+
+void AeadOneShot::ChaChaRound(std::array<uint, 16> &State, size_t A, size_t B, size_t C, size_t D)
+{
+	State[A] += State[B];
+	State[D] = Utility::IntUtils::RotFL32(State[D] ^ State[A], 16);
+	State[C] += State[D];
+	State[B] = Utility::IntUtils::RotFL32(State[B] ^ State[C], 12);
+	State[A] += State[B];
+	State[D] = Utility::IntUtils::RotFL32(State[D] ^ State[A], 8);
+	State[C] += State[D];
+	State[B] = Utility::IntUtils::RotFL32(State[B] ^ State[C], 7);
+}
+
+void AeadOneShot::ChaChaTransform(const std::vector<byte> &Key, const std::vector<byte> &Nonce, const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset, size_t Length)
+{
+	std::array<byte, CHACHA_BLOCK> keyStream;
+	uint ctr = 1;
+
+	while (Length != 0)
+	{
+		const size_t BLKLEN = Utility::IntUtils::Min(Length, CHACHA_BLOCK);
+
+		ChaChaBlock(Key, Nonce, ctr, keyStream);
+
+		for (size_t i = 0; i < BLKLEN; ++i)
+			Output[OutOffset + i] = Input[InOffset + i] ^ keyStream[i];
+
+		InOffset += BLKLEN;
+		OutOffset += BLKLEN;
+		Length -= BLKLEN;
+		++ctr;
+	}
+
+	Utility::MemUtils::Clear(keyStream, 0, keyStream.size());
+}
+
+void AeadOneShot::CheckBounds(const char* Origin, size_t InSize, size_t InOffset, size_t InLength, size_t OutSize, size_t OutOffset, size_t OutLength)
+{
+	if (InOffset > InSize || InSize - InOffset < InLength)
+		throw CryptoCipherModeException(std::string(Origin), "The input array is too small for the specified length!");
+	if (OutOffset > OutSize || OutSize - OutOffset < OutLength)
+		throw CryptoCipherModeException(std::string(Origin), "The output array is too small for the specified length!");
+}
+
+void AeadOneShot::PolyTag(const std::array<byte, CHACHA_BLOCK> &PolyKey, const std::vector<byte> &Associated, const std::vector<byte> &Input, size_t InOffset, size_t Length, std::array<byte, TAG_SIZE> &Tag)
+{
+	const uint MASK26 = 0x03FFFFFF;
+	std::array<uint, 5> h = { 0, 0, 0, 0, 0 };
+	std::array<uint, 5> r;
+	std::array<byte, BLOCK_SIZE> lenBlock;
+
+	// clamp r, the first half of the one-time key
+	r[0] = Utility::IntUtils::LeBytesTo32(PolyKey, 0) & 0x03FFFFFF;
+	r[1] = (Utility::IntUtils::LeBytesTo32(PolyKey, 3) >> 2) & 0x03FFFF03;
+	r[2] = (Utility::IntUtils::LeBytesTo32(PolyKey, 6) >> 4) & 0x03FFC0FF;
+	r[3] = (Utility::IntUtils::LeBytesTo32(PolyKey, 9) >> 6) & 0x03F03FFF;
+	r[4] = (Utility::IntUtils::LeBytesTo32(PolyKey, 12) >> 8) & 0x000FFFFF;
+
+	// AD || pad16(AD) || C || pad16(C) || le64(len(AD)) || le64(len(C))
+	PolyUpdate(h, r, Associated, 0, Associated.size());
+	PolyUpdate(h, r, Input, InOffset, Length);
+	Utility::IntUtils::Le64ToBytes(static_cast<ulong>(Associated.size()), lenBlock, 0);
+	Utility::IntUtils::Le64ToBytes(static_cast<ulong>(Length), lenBlock, 8);
+	PolyBlock(h, r, lenBlock, 0);
+
+	// fully carry h, then compute h + -p and select h mod p in constant time
+	uint c = h[1] >> 26;
+	h[1] &= MASK26;
+	h[2] += c;
+	c = h[2] >> 26;
+	h[2] &= MASK26;
+	h[3] += c;
+	c = h[3] >> 26;
+	h[3] &= MASK26;
+	h[4] += c;
+	c = h[4] >> 26;
+	h[4] &= MASK26;
+	h[0] += c * 5;
+	c = h[0] >> 26;
+	h[0] &= MASK26;
+	h[1] += c;
+
+	std::array<uint, 5> g;
+	g[0] = h[0] + 5;
+	c = g[0] >> 26;
+	g[0] &= MASK26;
+	g[1] = h[1] + c;
+	c = g[1] >> 26;
+	g[1] &= MASK26;
+	g[2] = h[2] + c;
+	c = g[2] >> 26;
+	g[2] &= MASK26;
+	g[3] = h[3] + c;
+	c = g[3] >> 26;
+	g[3] &= MASK26;
+	g[4] = h[4] + c - (1U << 26);
+
+	uint mask = (g[4] >> 31) - 1;
+
+	for (size_t i = 0; i < 5; ++i)
+		h[i] = (h[i] & ~mask) | (g[i] & mask);
+
+	// h = h % 2^128, then add the second half of the key
+	const uint H0 = h[0] | (h[1] << 26);
+	const uint H1 = (h[1] >> 6) | (h[2] << 20);
+	const uint H2 = (h[2] >> 12) | (h[3] << 14);
+	const uint H3 = (h[3] >> 18) | (h[4] << 8);
+
+	ulong f = static_cast<ulong>(H0) + Utility::IntUtils::LeBytesTo32(PolyKey, 16);
+	Utility::IntUtils::Le32ToBytes(static_cast<uint>(f), Tag, 0);
+	f = static_cast<ulong>(H1) + Utility::IntUtils::LeBytesTo32(PolyKey, 20) + (f >> 32);
+	Utility::IntUtils::Le32ToBytes(static_cast<uint>(f), Tag, 4);
+	f = static_cast<ulong>(H2) + Utility::IntUtils::LeBytesTo32(PolyKey, 24) + (f >> 32);
+	Utility::IntUtils::Le32ToBytes(static_cast<uint>(f), Tag, 8);
+	f = static_cast<ulong>(H3) + Utility::IntUtils::LeBytesTo32(PolyKey, 28) + (f >> 32);
+	Utility::IntUtils::Le32ToBytes(static_cast<uint>(f), Tag, 12);
+
+	Utility::MemUtils::Clear(h, 0, h.size() * sizeof(uint));
+	Utility::MemUtils::Clear(g, 0, g.size() * sizeof(uint));
+	Utility::MemUtils::Clear(r, 0, r.size() * sizeof(uint));
+}
+
+void AeadOneShot::PolyUpdate(std::array<uint, 5> &H, const std::array<uint, 5> &R, const std::vector<byte> &Input, size_t InOffset, size_t Length)
+{
+	while (Length >= BLOCK_SIZE)
+	{
+		PolyBlock(H, R, Input, InOffset);
+		InOffset += BLOCK_SIZE;
+		Length -= BLOCK_SIZE;
+	}
+
+	// the AEAD construction zero pads each section, so the final block is always full length
+	if (Length != 0)
+	{
+		std::array<byte, BLOCK_SIZE> tmp;
+		tmp.fill(0);
+		Utility::MemUtils::Copy(Input, InOffset, tmp, 0, Length);
+		PolyBlock(H, R, tmp, 0);
+	}
+}
+
+bool AeadOneShot::VerifyTag(const std::array<byte, TAG_SIZE> &Code, const std::vector<byte> &Input, size_t InOffset)
+{
+	uint delta = 0;
+
+	for (size_t i = 0; i < TAG_SIZE; ++i)
+		delta |= (Code[i] ^ Input[InOffset + i]);
+
+	return (delta == 0);
+}
+
+#if defined(__AVX__)
+
+__m128i AeadOneShot::AesDecrypt(__m128i Block, const std::array<__m128i, 15> &Round, size_t Rounds)
+{
+	Block = _mm_xor_si128(Block, Round[0]);
+
+	for (size_t i = 1; i < Rounds; ++i)
+		Block = _mm_aesdec_si128(Block, Round[i]);
+
+	return _mm_aesdeclast_si128(Block, Round[Rounds]);
+}
+
+__m128i AeadOneShot::AesEncrypt(__m128i Block, const std::array<__m128i, 15> &Round, size_t Rounds)
+{
+	Block = _mm_xor_si128(Block, Round[0]);
+
+	for (size_t i = 1; i < Rounds; ++i)
+		Block = _mm_aesenc_si128(Block, Round[i]);
+
+	return _mm_aesenclast_si128(Block, Round[Rounds]);
+}
+
+size_t AeadOneShot::AesExpand(const std::vector<byte> &Key, std::array<__m128i, 15> &Round)
+{
+	if (Key.size() == 32)
+	{
+		Round[0] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Key.data()));
+		Round[1] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Key.data() + 16));
+		Round[2] = AesExpandRot(Round[0], _mm_aeskeygenassist_si128(Round[1], 0x01));
+		Round[3] = AesExpandSub(Round[1], Round[2]);
+		Round[4] = AesExpandRot(Round[2], _mm_aeskeygenassist_si128(Round[3], 0x02));
+		Round[5] = AesExpandSub(Round[3], Round[4]);
+		Round[6] = AesExpandRot(Round[4], _mm_aeskeygenassist_si128(Round[5], 0x04));
+		Round[7] = AesExpandSub(Round[5], Round[6]);
+		Round[8] = AesExpandRot(Round[6], _mm_aeskeygenassist_si128(Round[7], 0x08));
+		Round[9] = AesExpandSub(Round[7], Round[8]);
+		Round[10] = AesExpandRot(Round[8], _mm_aeskeygenassist_si128(Round[9], 0x10));
+		Round[11] = AesExpandSub(Round[9], Round[10]);
+		Round[12] = AesExpandRot(Round[10], _mm_aeskeygenassist_si128(Round[11], 0x20));
+		Round[13] = AesExpandSub(Round[11], Round[12]);
+		Round[14] = AesExpandRot(Round[12], _mm_aeskeygenassist_si128(Round[13], 0x40));
+
+		return 14;
+	}
+	else if (Key.size() == 24)
+	{
+		// 192 bit keys produce one and a half round keys per step
+		__m128i k1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Key.data()));
+		__m128i k3 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(Key.data() + 16));
+
+		Round[0] = k1;
+		Round[1] = k3;
+		AesExpand192(k1, _mm_aeskeygenassist_si128(k3, 0x01), k3);
+		Round[1] = _mm_castpd_si128(_mm_shuffle_pd(_mm_castsi128_pd(Round[1]), _mm_castsi128_pd(k1), 0));
+		Round[2] = _mm_castpd_si128(_mm_shuffle_pd(_mm_castsi128_pd(k1), _mm_castsi128_pd(k3), 1));
+		AesExpand192(k1, _mm_aeskeygenassist_si128(k3, 0x02), k3);
+		Round[3] = k1;
+		Round[4] = k3;
+		AesExpand192(k1, _mm_aeskeygenassist_si128(k3, 0x04), k3);
+		Round[4] = _mm_castpd_si128(_mm_shuffle_pd(_mm_castsi128_pd(Round[4]), _mm_castsi128_pd(k1), 0));
+		Round[5] = _mm_castpd_si128(_mm_shuffle_pd(_mm_castsi128_pd(k1), _mm_castsi128_pd(k3), 1));
+		AesExpand192(k1, _mm_aeskeygenassist_si128(k3, 0x08), k3);
+		Round[6] = k1;
+		Round[7] = k3;
+		AesExpand192(k1, _mm_aeskeygenassist_si128(k3, 0x10), k3);
+		Round[7] = _mm_castpd_si128(_mm_shuffle_pd(_mm_castsi128_pd(Round[7]), _mm_castsi128_pd(k1), 0));
+		Round[8] = _mm_castpd_si128(_mm_shuffle_pd(_mm_castsi128_pd(k1), _mm_castsi128_pd(k3), 1));
+		AesExpand192(k1, _mm_aeskeygenassist_si128(k3, 0x20), k3);
+		Round[9] = k1;
+		Round[10] = k3;
+		AesExpand192(k1, _mm_aeskeygenassist_si128(k3, 0x40), k3);
+		Round[10] = _mm_castpd_si128(_mm_shuffle_pd(_mm_castsi128_pd(Round[10]), _mm_castsi128_pd(k1), 0));
+		Round[11] = _mm_castpd_si128(_mm_shuffle_pd(_mm_castsi128_pd(k1), _mm_castsi128_pd(k3), 1));
+		AesExpand192(k1, _mm_aeskeygenassist_si128(k3, 0x80), k3);
+		Round[12] = k1;
+
+		return 12;
+	}
+	else
+	{
+		Round[0] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Key.data()));
+		Round[1] = AesExpandRot(Round[0], _mm_aeskeygenassist_si128(Round[0], 0x01));
+		Round[2] = AesExpandRot(Round[1], _mm_aeskeygenassist_si128(Round[1], 0x02));
+		Round[3] = AesExpandRot(Round[2], _mm_aeskeygenassist_si128(Round[2], 0x04));
+		Round[4] = AesExpandRot(Round[3], _mm_aeskeygenassist_si128(Round[3], 0x08));
+		Round[5] = AesExpandRot(Round[4], _mm_aeskeygenassist_si128(Round[4], 0x10));
+		Round[6] = AesExpandRot(Round[5], _mm_aeskeygenassist_si128(Round[5], 0x20));
+		Round[7] = AesExpandRot(Round[6], _mm_aeskeygenassist_si128(Round[6], 0x40));
+		Round[8] = AesExpandRot(Round[7], _mm_aeskeygenassist_si128(Round[7], 0x80));
+		Round[9] = AesExpandRot(Round[8], _mm_aeskeygenassist_si128(Round[8], 0x1B));
+		Round[10] = AesExpandRot(Round[9], _mm_aeskeygenassist_si128(Round[9], 0x36));
+
+		return 10;
+	}
+}
+
+void AeadOneShot::AesExpand192(__m128i &K1, __m128i KR, __m128i &K3)
+{
+	KR = _mm_shuffle_epi32(KR, 0x55);
+	K1 = _mm_xor_si128(K1, _mm_slli_si128(K1, 4));
+	K1 = _mm_xor_si128(K1, _mm_slli_si128(K1, 4));
+	K1 = _mm_xor_si128(K1, _mm_slli_si128(K1, 4));
+	K1 = _mm_xor_si128(K1, KR);
+	K3 = _mm_xor_si128(K3, _mm_slli_si128(K3, 4));
+	K3 = _mm_xor_si128(K3, _mm_shuffle_epi32(K1, 0xFF));
+}
+
+__m128i AeadOneShot::AesExpandRot(__m128i K, __m128i KR)
+{
+	// 128 and 256 bit key method
+	KR = _mm_shuffle_epi32(KR, 0xFF);
+	K = _mm_xor_si128(K, _mm_slli_si128(K, 4));
+	K = _mm_xor_si128(K, _mm_slli_si128(K, 4));
+	K = _mm_xor_si128(K, _mm_slli_si128(K, 4));
+
+	return _mm_xor_si128(K, KR);
+}
+
+__m128i AeadOneShot::AesExpandSub(__m128i K, __m128i KP)
+{
+	// odd round keys of a 256 bit key
+	const __m128i KR = _mm_shuffle_epi32(_mm_aeskeygenassist_si128(KP, 0x00), 0xAA);
+	K = _mm_xor_si128(K, _mm_slli_si128(K, 4));
+	K = _mm_xor_si128(K, _mm_slli_si128(K, 4));
+	K = _mm_xor_si128(K, _mm_slli_si128(K, 4));
+
+	return _mm_xor_si128(K, KR);
+}
+
+void AeadOneShot::AesInverse(const std::array<__m128i, 15> &Round, std::array<__m128i, 15> &Inverse, size_t Rounds)
+{
+	Inverse[0] = Round[Rounds];
+
+	for (size_t i = 1; i < Rounds; ++i)
+		Inverse[i] = _mm_aesimc_si128(Round[Rounds - i]);
+
+	Inverse[Rounds] = Round[0];
+}
+
+__m128i AeadOneShot::GcmAuthenticate(__m128i H, const std::vector<byte> &Associated, const std::vector<byte> &Input, size_t InOffset, size_t Length)
+{
+	const __m128i BSWAP = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+	__m128i x = _mm_setzero_si128();
+
+	x = GcmHash(x, H, Associated, 0, Associated.size());
+	x = GcmHash(x, H, Input, InOffset, Length);
+	// len(A) || len(C) in bits, in the byte reversed order of the hash state
+	x = _mm_xor_si128(x, _mm_set_epi64x(static_cast<long long>(Associated.size() * 8), static_cast<long long>(Length * 8)));
+	x = GcmMultiply(x, H);
+
+	return _mm_shuffle_epi8(x, BSWAP);
+}
+
+void AeadOneShot::GcmCtr(const std::array<__m128i, 15> &Round, size_t Rounds, __m128i Counter, const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset, size_t Length)
+{
+	const __m128i BSWAP = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+	const __m128i ONE = _mm_set_epi32(0, 0, 0, 1);
+
+	// four counters are encrypted in parallel to fill the aesenc pipeline
+	while (Length >= 4 * BLOCK_SIZE)
+	{
+		__m128i b0 = _mm_xor_si128(_mm_shuffle_epi8(Counter, BSWAP), Round[0]);
+		Counter = _mm_add_epi32(Counter, ONE);
+		__m128i b1 = _mm_xor_si128(_mm_shuffle_epi8(Counter, BSWAP), Round[0]);
+		Counter = _mm_add_epi32(Counter, ONE);
+		__m128i b2 = _mm_xor_si128(_mm_shuffle_epi8(Counter, BSWAP), Round[0]);
+		Counter = _mm_add_epi32(Counter, ONE);
+		__m128i b3 = _mm_xor_si128(_mm_shuffle_epi8(Counter, BSWAP), Round[0]);
+		Counter = _mm_add_epi32(Counter, ONE);
+
+		for (size_t i = 1; i < Rounds; ++i)
+		{
+			b0 = _mm_aesenc_si128(b0, Round[i]);
+			b1 = _mm_aesenc_si128(b1, Round[i]);
+			b2 = _mm_aesenc_si128(b2, Round[i]);
+			b3 = _mm_aesenc_si128(b3, Round[i]);
+		}
+
+		b0 = _mm_aesenclast_si128(b0, Round[Rounds]);
+		b1 = _mm_aesenclast_si128(b1, Round[Rounds]);
+		b2 = _mm_aesenclast_si128(b2, Round[Rounds]);
+		b3 = _mm_aesenclast_si128(b3, Round[Rounds]);
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&Output[OutOffset]), _mm_xor_si128(b0, _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Input[InOffset]))));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&Output[OutOffset + 16]), _mm_xor_si128(b1, _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Input[InOffset + 16]))));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&Output[OutOffset + 32]), _mm_xor_si128(b2, _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Input[InOffset + 32]))));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&Output[OutOffset + 48]), _mm_xor_si128(b3, _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Input[InOffset + 48]))));
+
+		InOffset += 4 * BLOCK_SIZE;
+		OutOffset += 4 * BLOCK_SIZE;
+		Length -= 4 * BLOCK_SIZE;
+	}
+
+	while (Length >= BLOCK_SIZE)
+	{
+		const __m128i KS = AesEncrypt(_mm_shuffle_epi8(Counter, BSWAP), Round, Rounds);
+		Counter = _mm_add_epi32(Counter, ONE);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&Output[OutOffset]), _mm_xor_si128(KS, _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Input[InOffset]))));
+
+		InOffset += BLOCK_SIZE;
+		OutOffset += BLOCK_SIZE;
+		Length -= BLOCK_SIZE;
+	}
+
+	if (Length != 0)
+	{
+		std::array<byte, BLOCK_SIZE> tmp;
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(tmp.data()), AesEncrypt(_mm_shuffle_epi8(Counter, BSWAP), Round, Rounds));
+
+		for (size_t i = 0; i < Length; ++i)
+			Output[OutOffset + i] = Input[InOffset + i] ^ tmp[i];
+
+		Utility::MemUtils::Clear(tmp, 0, tmp.size());
+	}
+}
+
+__m128i AeadOneShot::GcmHash(__m128i X, __m128i H, const std::vector<byte> &Input, size_t InOffset, size_t Length)
+{
+	const __m128i BSWAP = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+
+	while (Length >= BLOCK_SIZE)
+	{
+		X = _mm_xor_si128(X, _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&Input[InOffset])), BSWAP));
+		X = GcmMultiply(X, H);
+		InOffset += BLOCK_SIZE;
+		Length -= BLOCK_SIZE;
+	}
+
+	if (Length != 0)
+	{
+		std::array<byte, BLOCK_SIZE> tmp;
+		tmp.fill(0);
+		Utility::MemUtils::Copy(Input, InOffset, tmp, 0, Length);
+		X = _mm_xor_si128(X, _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(tmp.data())), BSWAP));
+		X = GcmMultiply(X, H);
+	}
+
+	return X;
+}
+
+__m128i AeadOneShot::GcmMultiply(__m128i A, __m128i B)
+{
+	// carry-less multiply and reduce, both operands and the product are byte reversed
+	__m128i T0, T1, T2, T3, T4, T5;
+
+	T0 = _mm_clmulepi64_si128(A, B, 0x00);
+	T1 = _mm_clmulepi64_si128(A, B, 0x01);
+	T2 = _mm_clmulepi64_si128(A, B, 0x10);
+	T3 = _mm_clmulepi64_si128(A, B, 0x11);
+	T1 = _mm_xor_si128(T1, T2);
+	T2 = _mm_slli_si128(T1, 8);
+	T1 = _mm_srli_si128(T1, 8);
+	T0 = _mm_xor_si128(T0, T2);
+	T3 = _mm_xor_si128(T3, T1);
+	T4 = _mm_srli_epi32(T0, 31);
+	T0 = _mm_slli_epi32(T0, 1);
+	T5 = _mm_srli_epi32(T3, 31);
+	T3 = _mm_slli_epi32(T3, 1);
+	T2 = _mm_srli_si128(T4, 12);
+	T5 = _mm_slli_si128(T5, 4);
+	T4 = _mm_slli_si128(T4, 4);
+	T0 = _mm_or_si128(T0, T4);
+	T3 = _mm_or_si128(T3, T5);
+	T3 = _mm_or_si128(T3, T2);
+	T4 = _mm_slli_epi32(T0, 31);
+	T5 = _mm_slli_epi32(T0, 30);
+	T2 = _mm_slli_epi32(T0, 25);
+	T4 = _mm_xor_si128(T4, T5);
+	T4 = _mm_xor_si128(T4, T2);
+	T5 = _mm_srli_si128(T4, 4);
+	T3 = _mm_xor_si128(T3, T5);
+	T4 = _mm_slli_si128(T4, 12);
+	T0 = _mm_xor_si128(T0, T4);
+	T3 = _mm_xor_si128(T3, T0);
+	T4 = _mm_srli_epi32(T0, 1);
+	T1 = _mm_srli_epi32(T0, 2);
+	T2 = _mm_srli_epi32(T0, 7);
+	T3 = _mm_xor_si128(T3, T1);
+	T3 = _mm_xor_si128(T3, T2);
+	T3 = _mm_xor_si128(T3, T4);
+
+	return T3;
+}
+
+size_t AeadOneShot::Ntz(ulong X)
+{
+	size_t zCnt = 0;
+
+	while (!(X & 1))
+	{
+		X >>= 1;
+		++zCnt;
+	}
+
+	return zCnt;
+}
+
+__m128i AeadOneShot::OcbDouble(__m128i X)
+{
+	// big endian shift left by one, the carry out is reduced with 0x87
+	const __m128i BSWAP = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+	__m128i x = _mm_shuffle_epi8(X, BSWAP);
+	const __m128i CRY = _mm_srli_epi64(x, 63);
+	const __m128i RED = _mm_and_si128(_mm_shuffle_epi32(_mm_sub_epi32(_mm_setzero_si128(), CRY), 0xAA), _mm_set_epi32(0, 0, 0, 0x87));
+
+	x = _mm_or_si128(_mm_slli_epi64(x, 1), _mm_slli_si128(CRY, 8));
+	x = _mm_xor_si128(x, RED);
+
+	return _mm_shuffle_epi8(x, BSWAP);
+}
+
+__m128i AeadOneShot::OcbProcess(bool Encryption, const std::vector<byte> &Key, const std::vector<byte> &Nonce, const std::vector<byte> &Associated, const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset, size_t Length)
+{
+	std::array<__m128i, 15> encKey;
+	std::array<__m128i, 15> decKey;
+	std::array<__m128i, 64> lTable;
+	std::array<byte, 24> stretch;
+	std::array<byte, BLOCK_SIZE> tmp;
+	const size_t RNDCNT = AesExpand(Key, encKey);
+	size_t lCount = 1;
+
+	if (!Encryption)
+		AesInverse(encKey, decKey, RNDCNT);
+
+	// L* = E(0), L$ = double(L*), L0 = double(L$), Li = double(Li-1), extended as the block count requires
+	const __m128i LSTAR = AesEncrypt(_mm_setzero_si128(), encKey, RNDCNT);
+	const __m128i LDOLLAR = OcbDouble(LSTAR);
+	lTable[0] = OcbDouble(LDOLLAR);
+
+	// the 128 bit tag length encodes as zero in the first byte of the formatted nonce
+	tmp.fill(0);
+	Utility::MemUtils::Copy(Nonce, 0, tmp, BLOCK_SIZE - Nonce.size(), Nonce.size());
+	tmp[OCB_MAXNONCE - Nonce.size()] |= 1;
+	const size_t BOTTOM = tmp[OCB_MAXNONCE] & 0x3F;
+	tmp[OCB_MAXNONCE] &= 0xC0;
+
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(stretch.data()), AesEncrypt(_mm_loadu_si128(reinterpret_cast<const __m128i*>(tmp.data())), encKey, RNDCNT));
+
+	for (size_t i = 0; i < 8; ++i)
+		stretch[BLOCK_SIZE + i] = stretch[i] ^ stretch[i + 1];
+
+	const size_t BTMSFT = BOTTOM % 8;
+	const size_t BTMOFF = BOTTOM / 8;
+
+	for (size_t i = 0; i < BLOCK_SIZE; ++i)
+		tmp[i] = (BTMSFT == 0) ? stretch[BTMOFF + i] : static_cast<byte>((stretch[BTMOFF + i] << BTMSFT) | (stretch[BTMOFF + i + 1] >> (8 - BTMSFT)));
+
+	__m128i offset = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tmp.data()));
+	__m128i checkSum = _mm_setzero_si128();
+	size_t blkCtr = 0;
+
+	while (Length >= BLOCK_SIZE)
+	{
+		const size_t NTZ = Ntz(++blkCtr);
+
+		while (NTZ >= lCount)
+		{
+			lTable[lCount] = OcbDouble(lTable[lCount - 1]);
+			++lCount;
+		}
+
+		offset = _mm_xor_si128(offset, lTable[NTZ]);
+		__m128i blk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Input[InOffset]));
+
+		if (Encryption)
+		{
+			checkSum = _mm_xor_si128(checkSum, blk);
+			blk = _mm_xor_si128(AesEncrypt(_mm_xor_si128(blk, offset), encKey, RNDCNT), offset);
+		}
+		else
+		{
+			blk = _mm_xor_si128(AesDecrypt(_mm_xor_si128(blk, offset), decKey, RNDCNT), offset);
+			checkSum = _mm_xor_si128(checkSum, blk);
+		}
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&Output[OutOffset]), blk);
+		InOffset += BLOCK_SIZE;
+		OutOffset += BLOCK_SIZE;
+		Length -= BLOCK_SIZE;
+	}
+
+	if (Length != 0)
+	{
+		// the final partial block is xored with E(offset ^ L*), and added to the checksum as P* || 1 || 0..
+		offset = _mm_xor_si128(offset, LSTAR);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(stretch.data()), AesEncrypt(offset, encKey, RNDCNT));
+		tmp.fill(0);
+
+		for (size_t i = 0; i < Length; ++i)
+		{
+			Output[OutOffset + i] = Input[InOffset + i] ^ stretch[i];
+			tmp[i] = Encryption ? Input[InOffset + i] : Output[OutOffset + i];
+		}
+
+		tmp[Length] = 0x80;
+		checkSum = _mm_xor_si128(checkSum, _mm_loadu_si128(reinterpret_cast<const __m128i*>(tmp.data())));
+	}
+
+	// tag = E(checksum ^ offset ^ L$) ^ HASH(A)
+	__m128i tag = AesEncrypt(_mm_xor_si128(_mm_xor_si128(checkSum, offset), LDOLLAR), encKey, RNDCNT);
+
+	const size_t ADLEN = Associated.size();
+	__m128i adOffset = _mm_setzero_si128();
+	__m128i adSum = _mm_setzero_si128();
+	size_t adOff = 0;
+	blkCtr = 0;
+
+	while (ADLEN - adOff >= BLOCK_SIZE)
+	{
+		const size_t NTZ = Ntz(++blkCtr);
+
+		while (NTZ >= lCount)
+		{
+			lTable[lCount] = OcbDouble(lTable[lCount - 1]);
+			++lCount;
+		}
+
+		adOffset = _mm_xor_si128(adOffset, lTable[NTZ]);
+		const __m128i BLK = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Associated[adOff]));
+		adSum = _mm_xor_si128(adSum, AesEncrypt(_mm_xor_si128(BLK, adOffset), encKey, RNDCNT));
+		adOff += BLOCK_SIZE;
+	}
+
+	if (ADLEN != adOff)
+	{
+		tmp.fill(0);
+		Utility::MemUtils::Copy(Associated, adOff, tmp, 0, ADLEN - adOff);
+		tmp[ADLEN - adOff] = 0x80;
+		adOffset = _mm_xor_si128(adOffset, LSTAR);
+		const __m128i BLK = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tmp.data()));
+		adSum = _mm_xor_si128(adSum, AesEncrypt(_mm_xor_si128(BLK, adOffset), encKey, RNDCNT));
+	}
+
+	tag = _mm_xor_si128(tag, adSum);
+
+	Utility::MemUtils::Clear(encKey, 0, encKey.size() * sizeof(__m128i));
+	Utility::MemUtils::Clear(decKey, 0, decKey.size() * sizeof(__m128i));
+	Utility::MemUtils::Clear(lTable, 0, lCount * sizeof(__m128i));
+	Utility::MemUtils::Clear(stretch, 0, stretch.size());
+	Utility::MemUtils::Clear(tmp, 0, tmp.size());
+
+	return tag;
+}
+
+#endif
+
+NAMESPACE_MODEEND
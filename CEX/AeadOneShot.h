@@ -0,0 +1,275 @@
+// The GPL version 3 License (GPLv3)
+//
+// Copyright (c) 2017 vtdev.com
+// This file is part of the CEX Cryptographic library.
+//
+// This program is free software : you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+//
+// Implementation Details:
+// One-shot AEAD functions; AES-GCM, AES-OCB and ChaCha20-Poly1305 (RFC 8439),
+// with all cipher and authenticator state held on the stack.
+
+#ifndef CEX_AEADONESHOT_H
+#define CEX_AEADONESHOT_H
+
+#include "CexDomain.h"
+#include "CryptoCipherModeException.h"
+#include "IntUtils.h"
+#include <array>
+#if defined(__AVX__)
+#	include <wmmintrin.h>
+#	include "Intrinsics.h"
+#endif
+
+NAMESPACE_MODE
+
+using Exception::CryptoCipherModeException;
+
+/// <summary>
+/// Stateless one-shot AEAD Seal and Open functions
+/// </summary>
+///
+/// <example>
+/// <description>Sealing and opening a message with AES-GCM:</description>
+/// <code>
+/// // the output holds the cipher-text followed by the 16 byte tag
+/// std::vector&lt;byte&gt; cpt(msg.size() + AeadOneShot::TAG_SIZE);
+/// AeadOneShot::GcmSeal(Key, Nonce, Associated, msg, 0, cpt, 0, msg.size());
+///
+/// std::vector&lt;byte&gt; dec(msg.size());
+/// if (!AeadOneShot::GcmOpen(Key, Nonce, Associated, cpt, 0, dec, 0, msg.size()))
+///		throw;
+/// </code>
+/// </example>
+///
+/// <remarks>
+/// <description><B>Overview:</B></description>
+/// <para>Each function processes a complete message in a single call; no cipher, mode, hash or key container objects are constructed. \n
+/// The key schedule, counters, hash state and tag are held in local arrays and registers, and are cleared before the function returns, so a call never allocates from the heap. \n
+/// This is intended for processes that encrypt a single small payload under a fresh key, where constructing and initializing a GCM or OCB instance costs more than the message transform.</para>
+///
+/// <description>Implementation Notes:</description>
+/// <list type="bullet">
+/// <item><description>Seal writes the cipher-text to Output at OutOffset, followed by the 16 byte authentication tag; the output must have Length + TAG_SIZE bytes available.</description></item>
+/// <item><description>Open reads Length bytes of cipher-text followed by the 16 byte tag from Input at InOffset, and writes Length bytes of plain-text to Output.</description></item>
+/// <item><description>Open compares the tag in constant time; if authentication fails the output range is zeroed and the function returns false.</description></item>
+/// <item><description>GCM and ChaCha20-Poly1305 authenticate the cipher-text before decrypting, OCB decrypts first because its checksum is calculated over the plain-text.</description></item>
+/// <item><description>The AES-GCM and AES-OCB functions are only available when compiled with AES-NI and PCLMULQDQ support (__AVX__), and use the standard AES round counts for 128, 192 and 256 bit keys.</description></item>
+/// <item><description>GCM uses a 12 byte nonce, OCB a nonce of 12 to 15 bytes, and both produce output identical to the GCM and OCB modes keyed with Rijndael and a 16 byte tag.</description></item>
+/// <item><description>ChaCha20-Poly1305 is the IETF construction; a 32 byte key, 12 byte nonce and 32 bit block counter, this is not compatible with the 8 byte nonce ChaCha20 stream cipher.</description></item>
+/// </list>
+///
+/// <description>Guiding Publications:</description>
+/// <list type="number">
+/// <item><description>NIST <a href="http://csrc.nist.gov/publications/nistpubs/800-38D/SP-800-38D.pdf">SP800-38D</a>.</description></item>
+/// <item><description>RFC 7253: <a href="https://tools.ietf.org/html/rfc7253">The OCB Authenticated-Encryption Algorithm</a>.</description></item>
+/// <item><description>RFC 8439: <a href="https://tools.ietf.org/html/rfc8439">ChaCha20 and Poly1305 for IETF Protocols</a>.</description></item>
+/// </list>
+/// </remarks>
+class AeadOneShot
+{
+private:
+
+	static const size_t BLOCK_SIZE = 16;
+	static const size_t CHACHA_BLOCK = 64;
+	static const size_t CHACHA_KEYSIZE = 32;
+	static const size_t GCM_NONCESIZE = 12;
+	static const size_t IETF_NONCESIZE = 12;
+	static const size_t OCB_MAXNONCE = 15;
+	static const size_t OCB_MINNONCE = 12;
+
+public:
+
+	/// <summary>
+	/// The authentication tag size in bytes, appended to the cipher-text by each Seal function
+	/// </summary>
+	static const size_t TAG_SIZE = 16;
+
+	AeadOneShot() = delete;
+	AeadOneShot(const AeadOneShot&) = delete;
+	AeadOneShot& operator=(const AeadOneShot&) = delete;
+
+	/// <summary>
+	/// Decrypt and authenticate a ChaCha20-Poly1305 message
+	/// </summary>
+	///
+	/// <param name="Key">The 32 byte cipher key</param>
+	/// <param name="Nonce">The 12 byte nonce</param>
+	/// <param name="Associated">The associated data, can be empty</param>
+	/// <param name="Input">The cipher-text followed by the authentication tag</param>
+	/// <param name="InOffset">The starting offset within the input array</param>
+	/// <param name="Output">The plain-text output array</param>
+	/// <param name="OutOffset">The starting offset within the output array</param>
+	/// <param name="Length">The cipher-text length in bytes, not including the tag</param>
+	///
+	/// <returns>Returns true if the tag is authenticated, false if authentication failed and the output was cleared</returns>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the key or nonce size is invalid, or the arrays are too small</exception>
+	static bool ChaChaPolyOpen(const std::vector<byte> &Key, const std::vector<byte> &Nonce, const std::vector<byte> &Associated, const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset, size_t Length);
+
+	/// <summary>
+	/// Encrypt and authenticate a message with ChaCha20-Poly1305
+	/// </summary>
+	///
+	/// <param name="Key">The 32 byte cipher key</param>
+	/// <param name="Nonce">The 12 byte nonce</param>
+	/// <param name="Associated">The associated data, can be empty</param>
+	/// <param name="Input">The plain-text input array</param>
+	/// <param name="InOffset">The starting offset within the input array</param>
+	/// <param name="Output">Receives the cipher-text followed by the authentication tag</param>
+	/// <param name="OutOffset">The starting offset within the output array</param>
+	/// <param name="Length">The number of plain-text bytes to encrypt</param>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the key or nonce size is invalid, or the arrays are too small</exception>
+	static void ChaChaPolySeal(const std::vector<byte> &Key, const std::vector<byte> &Nonce, const std::vector<byte> &Associated, const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset, size_t Length);
+
+#if defined(__AVX__)
+
+	/// <summary>
+	/// Decrypt and authenticate an AES-GCM message
+	/// </summary>
+	///
+	/// <param name="Key">The 16, 24 or 32 byte AES key</param>
+	/// <param name="Nonce">The 12 byte nonce</param>
+	/// <param name="Associated">The associated data, can be empty</param>
+	/// <param name="Input">The cipher-text followed by the authentication tag</param>
+	/// <param name="InOffset">The starting offset within the input array</param>
+	/// <param name="Output">The plain-text output array</param>
+	/// <param name="OutOffset">The starting offset within the output array</param>
+	/// <param name="Length">The cipher-text length in bytes, not including the tag</param>
+	///
+	/// <returns>Returns true if the tag is authenticated, false if authentication failed and the output was cleared</returns>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the key or nonce size is invalid, or the arrays are too small</exception>
+	static bool GcmOpen(const std::vector<byte> &Key, const std::vector<byte> &Nonce, const std::vector<byte> &Associated, const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset, size_t Length);
+
+	/// <summary>
+	/// Encrypt and authenticate a message with AES-GCM
+	/// </summary>
+	///
+	/// <param name="Key">The 16, 24 or 32 byte AES key</param>
+	/// <param name="Nonce">The 12 byte nonce</param>
+	/// <param name="Associated">The associated data, can be empty</param>
+	/// <param name="Input">The plain-text input array</param>
+	/// <param name="InOffset">The starting offset within the input array</param>
+	/// <param name="Output">Receives the cipher-text followed by the authentication tag</param>
+	/// <param name="OutOffset">The starting offset within the output array</param>
+	/// <param name="Length">The number of plain-text bytes to encrypt</param>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the key or nonce size is invalid, or the arrays are too small</exception>
+	static void GcmSeal(const std::vector<byte> &Key, const std::vector<byte> &Nonce, const std::vector<byte> &Associated, const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset, size_t Length);
+
+	/// <summary>
+	/// Decrypt and authenticate an AES-OCB message
+	/// </summary>
+	///
+	/// <param name="Key">The 16, 24 or 32 byte AES key</param>
+	/// <param name="Nonce">The nonce, between 12 and 15 bytes in length</param>
+	/// <param name="Associated">The associated data, can be empty</param>
+	/// <param name="Input">The cipher-text followed by the authentication tag</param>
+	/// <param name="InOffset">The starting offset within the input array</param>
+	/// <param name="Output">The plain-text output array</param>
+	/// <param name="OutOffset">The starting offset within the output array</param>
+	/// <param name="Length">The cipher-text length in bytes, not including the tag</param>
+	///
+	/// <returns>Returns true if the tag is authenticated, false if authentication failed and the output was cleared</returns>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the key or nonce size is invalid, or the arrays are too small</exception>
+	static bool OcbOpen(const std::vector<byte> &Key, const std::vector<byte> &Nonce, const std::vector<byte> &Associated, const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset, size_t Length);
+
+	/// <summary>
+	/// Encrypt and authenticate a message with AES-OCB
+	/// </summary>
+	///
+	/// <param name="Key">The 16, 24 or 32 byte AES key</param>
+	/// <param name="Nonce">The nonce, between 12 and 15 bytes in length</param>
+	/// <param name="Associated">The associated data, can be empty</param>
+	/// <param name="Input">The plain-text input array</param>
+	/// <param name="InOffset">The starting offset within the input array</param>
+	/// <param name="Output">Receives the cipher-text followed by the authentication tag</param>
+	/// <param name="OutOffset">The starting offset within the output array</param>
+	/// <param name="Length">The number of plain-text bytes to encrypt</param>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the key or nonce size is invalid, or the arrays are too small</exception>
+	static void OcbSeal(const std::vector<byte> &Key, const std::vector<byte> &Nonce, const std::vector<byte> &Associated, const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset, size_t Length);
+
+#endif
+
+private:
+
+	static void ChaChaBlock(const std::vector<byte> &Key, const std::vector<byte> &Nonce, uint Counter, std::array<byte, CHACHA_BLOCK> &Output);
+	static void ChaChaRound(std::array<uint, 16> &State, size_t A, size_t B, size_t C, size_t D);
+	static void ChaChaTransform(const std::vector<byte> &Key, const std::vector<byte> &Nonce, const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset, size_t Length);
+	static void CheckBounds(const char* Origin, size_t InSize, size_t InOffset, size_t InLength, size_t OutSize, size_t OutOffset, size_t OutLength);
+	static void PolyTag(const std::array<byte, CHACHA_BLOCK> &PolyKey, const std::vector<byte> &Associated, const std::vector<byte> &Input, size_t InOffset, size_t Length, std::array<byte, TAG_SIZE> &Tag);
+	static void PolyUpdate(std::array<uint, 5> &H, const std::array<uint, 5> &R, const std::vector<byte> &Input, size_t InOffset, size_t Length);
+	static bool VerifyTag(const std::array<byte, TAG_SIZE> &Code, const std::vector<byte> &Input, size_t InOffset);
+
+	template <typename Array>
+	static void PolyBlock(std::array<uint, 5> &H, const std::array<uint, 5> &R, const Array &Input, size_t InOffset)
+	{
+		// one full 16 byte block with the 2^128 bit set, in 26 bit limbs
+		const uint MASK26 = 0x03FFFFFF;
+		const uint S1 = R[1] * 5;
+		const uint S2 = R[2] * 5;
+		const uint S3 = R[3] * 5;
+		const uint S4 = R[4] * 5;
+
+		H[0] += Utility::IntUtils::LeBytesTo32(Input, InOffset) & MASK26;
+		H[1] += (Utility::IntUtils::LeBytesTo32(Input, InOffset + 3) >> 2) & MASK26;
+		H[2] += (Utility::IntUtils::LeBytesTo32(Input, InOffset + 6) >> 4) & MASK26;
+		H[3] += (Utility::IntUtils::LeBytesTo32(Input, InOffset + 9) >> 6) & MASK26;
+		H[4] += (Utility::IntUtils::LeBytesTo32(Input, InOffset + 12) >> 8) | (1U << 24);
+
+		ulong d0 = ((ulong)H[0] * R[0]) + ((ulong)H[1] * S4) + ((ulong)H[2] * S3) + ((ulong)H[3] * S2) + ((ulong)H[4] * S1);
+		ulong d1 = ((ulong)H[0] * R[1]) + ((ulong)H[1] * R[0]) + ((ulong)H[2] * S4) + ((ulong)H[3] * S3) + ((ulong)H[4] * S2);
+		ulong d2 = ((ulong)H[0] * R[2]) + ((ulong)H[1] * R[1]) + ((ulong)H[2] * R[0]) + ((ulong)H[3] * S4) + ((ulong)H[4] * S3);
+		ulong d3 = ((ulong)H[0] * R[3]) + ((ulong)H[1] * R[2]) + ((ulong)H[2] * R[1]) + ((ulong)H[3] * R[0]) + ((ulong)H[4] * S4);
+		ulong d4 = ((ulong)H[0] * R[4]) + ((ulong)H[1] * R[3]) + ((ulong)H[2] * R[2]) + ((ulong)H[3] * R[1]) + ((ulong)H[4] * R[0]);
+
+		d1 += d0 >> 26;
+		H[0] = static_cast<uint>(d0) & MASK26;
+		d2 += d1 >> 26;
+		H[1] = static_cast<uint>(d1) & MASK26;
+		d3 += d2 >> 26;
+		H[2] = static_cast<uint>(d2) & MASK26;
+		d4 += d3 >> 26;
+		H[3] = static_cast<uint>(d3) & MASK26;
+		H[4] = static_cast<uint>(d4) & MASK26;
+		H[0] += static_cast<uint>(d4 >> 26) * 5;
+		H[1] += H[0] >> 26;
+		H[0] &= MASK26;
+	}
+
+#if defined(__AVX__)
+	static __m128i AesDecrypt(__m128i Block, const std::array<__m128i, 15> &Round, size_t Rounds);
+	static __m128i AesEncrypt(__m128i Block, const std::array<__m128i, 15> &Round, size_t Rounds);
+	static size_t AesExpand(const std::vector<byte> &Key, std::array<__m128i, 15> &Round);
+	static void AesExpand192(__m128i &K1, __m128i KR, __m128i &K3);
+	static __m128i AesExpandRot(__m128i K, __m128i KR);
+	static __m128i AesExpandSub(__m128i K, __m128i KP);
+	static void AesInverse(const std::array<__m128i, 15> &Round, std::array<__m128i, 15> &Inverse, size_t Rounds);
+	static __m128i GcmAuthenticate(__m128i H, const std::vector<byte> &Associated, const std::vector<byte> &Input, size_t InOffset, size_t Length);
+	static void GcmCtr(const std::array<__m128i, 15> &Round, size_t Rounds, __m128i Counter, const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset, size_t Length);
+	static __m128i GcmHash(__m128i X, __m128i H, const std::vector<byte> &Input, size_t InOffset, size_t Length);
+	static __m128i GcmMultiply(__m128i A, __m128i B);
+	static size_t Ntz(ulong X);
+	static __m128i OcbDouble(__m128i X);
+	static __m128i OcbProcess(bool Encryption, const std::vector<byte> &Key, const std::vector<byte> &Nonce, const std::vector<byte> &Associated, const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset, size_t Length);
+#endif
+};
+
+NAMESPACE_MODEEND
+#endif
@@ -0,0 +1,115 @@
+// The GPL version 3 License (GPLv3)
+//
+// Copyright (c) 2017 vtdev.com
+// This file is part of the CEX Cryptographic library.
+//
+// This program is free software : you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef CEX_AEADPACKET_H
+#define CEX_AEADPACKET_H
+
+#include "CexDomain.h"
+
+NAMESPACE_MODE
+
+/// <summary>
+/// An AEAD packet descriptor used by the batch Seal/Open functions.
+/// <para>Describes one message within a batch; the associated data, message, and tag are referenced by offset and length
+/// within the shared arrays passed to the batch function, so packets are never copied.</para>
+/// </summary>
+struct AeadPacket
+{
+	/// <summary>
+	/// The length of the associated data in bytes
+	/// </summary>
+	size_t AdLength;
+
+	/// <summary>
+	/// The starting offset of the associated data within the associated data array
+	/// </summary>
+	size_t AdOffset;
+
+	/// <summary>
+	/// Set by the Open function; true if the packet tag was verified
+	/// </summary>
+	bool Authentic;
+
+	/// <summary>
+	/// The starting offset of the message within the input array
+	/// </summary>
+	size_t InOffset;
+
+	/// <summary>
+	/// The length of the message in bytes
+	/// </summary>
+	size_t Length;
+
+	/// <summary>
+	/// The packet nonce
+	/// </summary>
+	std::vector<byte> Nonce;
+
+	/// <summary>
+	/// The starting offset of the transformed message within the output array
+	/// </summary>
+	size_t OutOffset;
+
+	/// <summary>
+	/// The starting offset of the packet tag within the tag array
+	/// </summary>
+	size_t TagOffset;
+
+	/// <summary>
+	/// Initialize an empty packet descriptor
+	/// </summary>
+	AeadPacket()
+		:
+		AdLength(0),
+		AdOffset(0),
+		Authentic(false),
+		InOffset(0),
+		Length(0),
+		Nonce(0),
+		OutOffset(0),
+		TagOffset(0)
+	{
+	}
+
+	/// <summary>
+	/// Initialize the packet descriptor
+	/// </summary>
+	///
+	/// <param name="PacketNonce">The packet nonce</param>
+	/// <param name="InputOffset">The starting offset of the message within the input array</param>
+	/// <param name="OutputOffset">The starting offset of the transformed message within the output array</param>
+	/// <param name="MessageLength">The length of the message in bytes</param>
+	/// <param name="TagPosition">The starting offset of the packet tag within the tag array</param>
+	/// <param name="AdPosition">The starting offset of the associated data within the associated data array</param>
+	/// <param name="AdSize">The length of the associated data in bytes</param>
+	AeadPacket(const std::vector<byte> &PacketNonce, size_t InputOffset, size_t OutputOffset, size_t MessageLength, size_t TagPosition, size_t AdPosition = 0, size_t AdSize = 0)
+		:
+		AdLength(AdSize),
+		AdOffset(AdPosition),
+		Authentic(false),
+		InOffset(InputOffset),
+		Length(MessageLength),
+		Nonce(PacketNonce),
+		OutOffset(OutputOffset),
+		TagOffset(TagPosition)
+	{
+	}
+};
+
+NAMESPACE_MODEEND
+#endif
@@ -0,0 +1,242 @@
+#include "AeadStream.h"
+#include "IntUtils.h"
+#include "MemUtils.h"
+#include "ParallelUtils.h"
+
+NAMESPACE_PROCESSING
+
+//~~~Constructor~~~//
+
+AeadStream::AeadStream(GCM* Cipher, const std::vector<byte> &Nonce, size_t TagSize)
+	:
+	m_cipherMode(Cipher),
+	m_streamNonce(Nonce),
+	m_tagSize(TagSize)
+{
+	if (Cipher == nullptr)
+	{
+		throw CryptoProcessingException("AeadStream:CTor", "The cipher mode can not be null!");
+	}
+	if (!Cipher->IsInitialized())
+	{
+		throw CryptoProcessingException("AeadStream:CTor", "The cipher mode has not been keyed!");
+	}
+	if (Nonce.size() < NONCE_MIN)
+	{
+		throw CryptoProcessingException("AeadStream:CTor", "The nonce must be at least 12 bytes in length!");
+	}
+	if (TagSize < 12 || TagSize > 16)
+	{
+		throw CryptoProcessingException("AeadStream:CTor", "The tag size must be a minimum of 12 and maximum of 16 bytes!");
+	}
+}
+
+AeadStream::~AeadStream()
+{
+	Destroy();
+}
+
+//~~~Public Functions~~~//
+
+void AeadStream::Open(IByteStream* Input, IByteStream* Output)
+{
+	CexAssert(Input->CanRead(), "the input stream is set to write only!");
+	CexAssert(Output->CanWrite(), "the output stream is set to read only!");
+
+	const size_t THDCNT = Utility::ParallelUtils::ProcessorCount();
+	const size_t SEALSZE = CHUNK_SIZE + m_tagSize;
+	const size_t WNDSZE = THDCNT * WINDOW_CHUNKS * SEALSZE;
+	ulong inpLen = Input->Length() - Input->Position();
+	std::vector<std::unique_ptr<GCM>> modes(THDCNT);
+	std::vector<byte> inpBuffer(static_cast<size_t>(Utility::IntUtils::Min(inpLen, static_cast<ulong>(WNDSZE))));
+	std::vector<byte> outBuffer(0);
+	std::vector<AeadPacket> pkts(0);
+	std::vector<byte> ad(0);
+	ulong index = 0;
+
+	for (size_t i = 0; i < THDCNT; ++i)
+	{
+		modes[i].reset(m_cipherMode->Clone());
+	}
+
+	do
+	{
+		const size_t PRCLEN = static_cast<size_t>(Utility::IntUtils::Min(inpLen, static_cast<ulong>(WNDSZE)));
+		// every chunk carries a tag, so a trailing fragment shorter than a tag can only be a truncated stream
+		const size_t PRTLEN = PRCLEN % SEALSZE;
+
+		if (PRCLEN == 0 || (PRTLEN != 0 && PRTLEN < m_tagSize))
+		{
+			throw CryptoAuthenticationFailure("AeadStream:Open", "The sealed stream has been truncated!");
+		}
+		if (Input->Read(inpBuffer, 0, PRCLEN) != PRCLEN)
+		{
+			throw CryptoAuthenticationFailure("AeadStream:Open", "The sealed stream has been truncated!");
+		}
+
+		inpLen -= PRCLEN;
+		const size_t CNKCNT = (PRCLEN + SEALSZE - 1) / SEALSZE;
+		const size_t MSGLEN = PRCLEN - (CNKCNT * m_tagSize);
+
+		// a trailing fragment of exactly one tag would count as a chunk with no message; only the empty stream is sealed that way
+		if (CNKCNT != ((MSGLEN == 0) ? 1 : (MSGLEN + CHUNK_SIZE - 1) / CHUNK_SIZE))
+		{
+			throw CryptoAuthenticationFailure("AeadStream:Open", "The sealed stream has an invalid length!");
+		}
+
+		Packets(pkts, ad, index, MSGLEN, false, inpLen == 0);
+		outBuffer.resize(MSGLEN);
+
+		// the window is authenticated as a whole before any of its plain-text is released
+		if (!Process(modes, pkts, ad, inpBuffer, outBuffer, false))
+		{
+			Utility::MemUtils::Clear(outBuffer, 0, outBuffer.size());
+			throw CryptoAuthenticationFailure("AeadStream:Open", "The stream has failed authentication!");
+		}
+
+		if (MSGLEN != 0)
+		{
+			Output->Write(outBuffer, 0, MSGLEN);
+		}
+
+		index += pkts.size();
+	}
+	while (inpLen != 0);
+
+	Utility::MemUtils::Clear(outBuffer, 0, outBuffer.size());
+}
+
+void AeadStream::Seal(IByteStream* Input, IByteStream* Output)
+{
+	CexAssert(Input->CanRead(), "the input stream is set to write only!");
+	CexAssert(Output->CanWrite(), "the output stream is set to read only!");
+
+	const size_t THDCNT = Utility::ParallelUtils::ProcessorCount();
+	const size_t WNDSZE = THDCNT * WINDOW_CHUNKS * CHUNK_SIZE;
+	ulong inpLen = Input->Length() - Input->Position();
+	std::vector<std::unique_ptr<GCM>> modes(THDCNT);
+	std::vector<byte> inpBuffer(static_cast<size_t>(Utility::IntUtils::Min(inpLen, static_cast<ulong>(WNDSZE))));
+	std::vector<byte> outBuffer(0);
+	std::vector<AeadPacket> pkts(0);
+	std::vector<byte> ad(0);
+	ulong index = 0;
+
+	for (size_t i = 0; i < THDCNT; ++i)
+	{
+		modes[i].reset(m_cipherMode->Clone());
+	}
+
+	// an empty stream is sealed as a single empty final chunk
+	do
+	{
+		const size_t PRCLEN = static_cast<size_t>(Utility::IntUtils::Min(inpLen, static_cast<ulong>(WNDSZE)));
+
+		if (PRCLEN != 0 && Input->Read(inpBuffer, 0, PRCLEN) != PRCLEN)
+		{
+			throw CryptoProcessingException("AeadStream:Seal", "The input stream could not be read!");
+		}
+
+		inpLen -= PRCLEN;
+		Packets(pkts, ad, index, PRCLEN, true, inpLen == 0);
+		outBuffer.resize(PRCLEN + (pkts.size() * m_tagSize));
+		Process(modes, pkts, ad, inpBuffer, outBuffer, true);
+		Output->Write(outBuffer, 0, outBuffer.size());
+		index += pkts.size();
+	}
+	while (inpLen != 0);
+
+	Utility::MemUtils::Clear(inpBuffer, 0, inpBuffer.size());
+}
+
+ulong AeadStream::SealedLength(ulong Length, size_t TagSize)
+{
+	const ulong CNKCNT = (Length == 0) ? 1 : (Length + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+	return Length + (CNKCNT * TagSize);
+}
+
+//~~~Private Functions~~~//
+
+void AeadStream::ChunkNonce(std::vector<byte> &Nonce, ulong Index)
+{
+	const size_t NNCOFF = m_streamNonce.size() - sizeof(ulong);
+
+	Nonce = m_streamNonce;
+
+	for (size_t i = 0; i < sizeof(ulong); ++i)
+	{
+		Nonce[NNCOFF + i] ^= static_cast<byte>(Index >> (56 - (i * 8)));
+	}
+}
+
+void AeadStream::Destroy()
+{
+	m_cipherMode = nullptr;
+	m_tagSize = 0;
+	Utility::IntUtils::ClearVector(m_streamNonce);
+}
+
+void AeadStream::Packets(std::vector<AeadPacket> &Packets, std::vector<byte> &Associated, ulong Index, size_t Length, bool Encryption, bool Final)
+{
+	const size_t CNKCNT = (Length == 0) ? 1 : (Length + CHUNK_SIZE - 1) / CHUNK_SIZE;
+	const size_t SEALSZE = CHUNK_SIZE + m_tagSize;
+
+	Packets.resize(CNKCNT);
+	Associated.resize(CNKCNT * AD_SIZE);
+
+	for (size_t i = 0; i < CNKCNT; ++i)
+	{
+		const size_t MSGLEN = (i == CNKCNT - 1) ? Length - (i * CHUNK_SIZE) : CHUNK_SIZE;
+		const size_t MSGOFF = i * CHUNK_SIZE;
+		const size_t SLDOFF = i * SEALSZE;
+
+		// the chunk index and final flag are authenticated, so chunks can not be moved, dropped, or appended
+		Utility::IntUtils::Le64ToBytes(Index + i, Associated, i * AD_SIZE);
+		Associated[(i * AD_SIZE) + sizeof(ulong)] = (Final && i == CNKCNT - 1) ? 1 : 0;
+
+		Packets[i].AdLength = AD_SIZE;
+		Packets[i].AdOffset = i * AD_SIZE;
+		Packets[i].Authentic = false;
+		Packets[i].InOffset = Encryption ? MSGOFF : SLDOFF;
+		Packets[i].Length = MSGLEN;
+		Packets[i].OutOffset = Encryption ? SLDOFF : MSGOFF;
+		Packets[i].TagOffset = SLDOFF + MSGLEN;
+		ChunkNonce(Packets[i].Nonce, Index + i);
+	}
+}
+
+bool AeadStream::Process(std::vector<std::unique_ptr<GCM>> &Modes, const std::vector<AeadPacket> &Packets, const std::vector<byte> &Associated, const std::vector<byte> &Input, std::vector<byte> &Output, bool Encryption)
+{
+	const size_t THDCNT = Utility::IntUtils::Min(Modes.size(), Packets.size());
+	const size_t TAGLEN = m_tagSize;
+	std::vector<byte> ret(THDCNT, 1);
+
+	// each core seals or opens a contiguous run of chunks with its own copy of the keyed mode;
+	// the tags are interleaved with the cipher-text, so they are read from the input, or written to the output array
+	Utility::ParallelUtils::ParallelFor(0, THDCNT, [&Modes, &Packets, &Associated, &Input, &Output, &ret, Encryption, TAGLEN, THDCNT](size_t i)
+	{
+		const size_t PKTFRST = (i * Packets.size()) / THDCNT;
+		const size_t PKTLAST = ((i + 1) * Packets.size()) / THDCNT;
+		std::vector<AeadPacket> pkts(Packets.begin() + PKTFRST, Packets.begin() + PKTLAST);
+
+		if (Encryption)
+		{
+			Modes[i]->SealBatch(pkts, Associated, Input, Output, Output, TAGLEN);
+		}
+		else
+		{
+			ret[i] = Modes[i]->OpenBatch(pkts, Associated, Input, Output, Input, TAGLEN) ? 1 : 0;
+		}
+	});
+
+	byte valid = 1;
+
+	for (size_t i = 0; i < THDCNT; ++i)
+	{
+		valid &= ret[i];
+	}
+
+	return (valid == 1);
+}
+
+NAMESPACE_PROCESSINGEND
@@ -0,0 +1,146 @@
+// The GPL version 3 License (GPLv3)
+//
+// Copyright (c) 2017 vtdev.com
+// This file is part of the CEX Cryptographic library.
+//
+// This program is free software : you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef CEX_AEADSTREAM_H
+#define CEX_AEADSTREAM_H
+
+#include "CexDomain.h"
+#include "AeadPacket.h"
+#include "CryptoAuthenticationFailure.h"
+#include "CryptoProcessingException.h"
+#include "GCM.h"
+#include "IByteStream.h"
+
+NAMESPACE_PROCESSING
+
+using Cipher::Symmetric::Block::Mode::AeadPacket;
+using Exception::CryptoAuthenticationFailure;
+using Exception::CryptoProcessingException;
+using Cipher::Symmetric::Block::Mode::GCM;
+using IO::IByteStream;
+
+/// <summary>
+/// Chunked authenticated stream encryption.
+/// <para>Encrypts a stream of any length with a keyed GCM instance, as a sequence of independently authenticated chunks.
+/// The chunks of a window are divided between the processor cores, each core sealing or opening its share as a batch with its own copy of the keyed mode,
+/// so memory use is bounded by the window size rather than the length of the stream.</para>
+/// </summary>
+///
+/// <example>
+/// <description>Sealing a stream:</description>
+/// <code>
+/// GCM cpr(BlockCiphers::Rijndael);
+/// cpr.Initialize(true, kp);
+/// AeadStream as(&amp;cpr, Nonce, 16);
+/// as.Seal(InStream, OutStream);
+/// </code>
+/// </example>
+///
+/// <remarks>
+/// <description>Implementation Notes:</description>
+/// <list type="bullet">
+/// <item><description>The plain-text is divided into chunks of CHUNK_SIZE bytes, the last chunk may be shorter, and an empty stream produces a single empty chunk.</description></item>
+/// <item><description>Each chunk is written as its cipher-text followed by its tag; the sealed length is returned by SealedLength(Length, TagSize).</description></item>
+/// <item><description>The nonce of a chunk is the stream nonce with the big endian chunk index XORed into its last 8 bytes; the index and a final-chunk flag are authenticated as associated data, so chunks can not be reordered, and a stream truncated on a chunk boundary fails authentication.</description></item>
+/// <item><description>Open authenticates every chunk of a window before any of its plain-text is written; on failure nothing from that window is written and CryptoAuthenticationFailure is thrown.
+/// Windows written before the failure have been authenticated, but the stream as a whole is only authentic if Open returns.</description></item>
+/// <item><description>The key and nonce of the mode must not be used to seal more than one stream.</description></item>
+/// </list>
+/// </remarks>
+class AeadStream
+{
+private:
+
+	static const size_t AD_SIZE = 9;
+	static const size_t NONCE_MIN = 12;
+	static const size_t WINDOW_CHUNKS = 4;
+
+	GCM* m_cipherMode;
+	std::vector<byte> m_streamNonce;
+	size_t m_tagSize;
+
+public:
+
+	/// <summary>
+	/// The plain-text size of a chunk in bytes
+	/// </summary>
+	static const size_t CHUNK_SIZE = 64 * 1024;
+
+	AeadStream() = delete;
+	AeadStream(const AeadStream&) = delete;
+	AeadStream& operator=(const AeadStream&) = delete;
+	AeadStream& operator=(AeadStream&&) = delete;
+
+	//~~~Constructor~~~//
+
+	/// <summary>
+	/// Initialize the class with a keyed GCM instance
+	/// </summary>
+	///
+	/// <param name="Cipher">The GCM mode, initialized with a key; the instance is not owned or modified by this class</param>
+	/// <param name="Nonce">The stream nonce; a minimum of 12 bytes</param>
+	/// <param name="TagSize">The byte length of each chunk tag; a minimum of 12 and maximum of 16 bytes</param>
+	///
+	/// <exception cref="Exception::CryptoProcessingException">Thrown if the mode is null or not keyed, or the nonce or tag size is invalid</exception>
+	AeadStream(GCM* Cipher, const std::vector<byte> &Nonce, size_t TagSize);
+
+	/// <summary>
+	/// Finalize objects
+	/// </summary>
+	~AeadStream();
+
+	//~~~Public Functions~~~//
+
+	/// <summary>
+	/// Decrypt and authenticate the stream, from the input position to its end
+	/// </summary>
+	///
+	/// <param name="Input">The sealed input stream</param>
+	/// <param name="Output">The stream receiving the plain-text</param>
+	///
+	/// <exception cref="Exception::CryptoAuthenticationFailure">Thrown if a chunk fails authentication, or the stream has been truncated or extended</exception>
+	void Open(IByteStream* Input, IByteStream* Output);
+
+	/// <summary>
+	/// Encrypt and authenticate the stream, from the input position to its end
+	/// </summary>
+	///
+	/// <param name="Input">The plain-text input stream</param>
+	/// <param name="Output">The stream receiving the sealed chunks</param>
+	void Seal(IByteStream* Input, IByteStream* Output);
+
+	/// <summary>
+	/// Get the sealed length of a plain-text stream
+	/// </summary>
+	///
+	/// <param name="Length">The plain-text length in bytes</param>
+	/// <param name="TagSize">The byte length of each chunk tag</param>
+	///
+	/// <returns>The length of the sealed stream in bytes</returns>
+	static ulong SealedLength(ulong Length, size_t TagSize);
+
+private:
+
+	void ChunkNonce(std::vector<byte> &Nonce, ulong Index);
+	void Destroy();
+	void Packets(std::vector<AeadPacket> &Packets, std::vector<byte> &Associated, ulong Index, size_t Length, bool Encryption, bool Final);
+	bool Process(std::vector<std::unique_ptr<GCM>> &Modes, const std::vector<AeadPacket> &Packets, const std::vector<byte> &Associated, const std::vector<byte> &Input, std::vector<byte> &Output, bool Encryption);
+};
+
+NAMESPACE_PROCESSINGEND
+#endif
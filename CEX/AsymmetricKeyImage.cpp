@@ -0,0 +1,58 @@
+#include "AsymmetricKeyImage.h"
+#include "IntUtils.h"
+
+NAMESPACE_ASYMMETRICKEY
+
+std::vector<byte> AsymmetricKeyImage::Create(AsymmetricEngines Engine, byte Parameters, KeyClass Class, const IO::ByteView &Key)
+{
+	std::vector<byte> image(HEADER_SIZE + Key.size(), 0);
+
+	Utility::IntUtils::Le32ToBytes(IMAGE_MAGIC, image, 0);
+	image[4] = IMAGE_VERSION;
+	image[5] = static_cast<byte>(Engine);
+	image[6] = Parameters;
+	image[7] = static_cast<byte>(Class);
+	Utility::IntUtils::Le64ToBytes(static_cast<ulong>(Key.size()), image, 8);
+	Utility::IntUtils::Le32ToBytes(static_cast<uint>(HEADER_SIZE), image, 16);
+
+	if (Key.size() != 0)
+	{
+		std::memcpy(&image[HEADER_SIZE], Key.data(), Key.size());
+	}
+
+	return image;
+}
+
+IO::ByteView AsymmetricKeyImage::Open(const IO::ByteView &Image, AsymmetricEngines Engine, KeyClass Class, byte &Parameters)
+{
+	if (Image.size() < HEADER_SIZE)
+	{
+		throw CryptoAsymmetricException("AsymmetricKeyImage:Open", "The key image is truncated!");
+	}
+	if (Utility::IntUtils::LeBytesTo32(Image, 0) != IMAGE_MAGIC)
+	{
+		throw CryptoAsymmetricException("AsymmetricKeyImage:Open", "The data is not a key image!");
+	}
+	if (Image[4] == 0 || Image[4] > IMAGE_VERSION)
+	{
+		throw CryptoAsymmetricException("AsymmetricKeyImage:Open", "The key image version is not supported!");
+	}
+	if (Image[5] != static_cast<byte>(Engine) || Image[7] != static_cast<byte>(Class))
+	{
+		throw CryptoAsymmetricException("AsymmetricKeyImage:Open", "The key image does not contain the expected key type!");
+	}
+
+	const ulong KEYLEN = Utility::IntUtils::LeBytesTo64(Image, 8);
+	const uint KEYOFF = Utility::IntUtils::LeBytesTo32(Image, 16);
+
+	if (KEYOFF < HEADER_SIZE || (KEYOFF % HEADER_SIZE) != 0 || KEYOFF > Image.size() || KEYLEN > Image.size() - KEYOFF)
+	{
+		throw CryptoAsymmetricException("AsymmetricKeyImage:Open", "The key image is truncated!");
+	}
+
+	Parameters = Image[6];
+
+	return IO::ByteView(Image.data() + KEYOFF, static_cast<size_t>(KEYLEN));
+}
+
+NAMESPACE_ASYMMETRICKEYEND
@@ -0,0 +1,121 @@
+// The GPL version 3 License (GPLv3)
+//
+// Copyright (c) 2017 vtdev.com
+// This file is part of the CEX Cryptographic library.
+//
+// This program is free software : you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef CEX_ASYMMETRICKEYIMAGE_H
+#define CEX_ASYMMETRICKEYIMAGE_H
+
+#include "CexDomain.h"
+#include "AsymmetricEngines.h"
+#include "ByteView.h"
+#include "CryptoAsymmetricException.h"
+
+NAMESPACE_ASYMMETRICKEY
+
+using Enumeration::AsymmetricEngines;
+using Exception::CryptoAsymmetricException;
+
+/// <summary>
+/// The asymmetric key image format.
+/// <para>A key image is a fixed 64 byte header followed by the raw key, laid out so that a mapped image can be used in place:
+/// the key begins on a 64 byte boundary of the image, and a memory mapped file begins on a page boundary, so the key of a mapped
+/// image is cache-line aligned and is read directly by the cipher without a parse or copy.</para>
+///
+/// <list type="table">
+/// <item><description>0: magic, 4 bytes, 'CEXK'</description></item>
+/// <item><description>4: format version, 1 byte</description></item>
+/// <item><description>5: the AsymmetricEngines cipher type, 1 byte</description></item>
+/// <item><description>6: the cipher parameter set, 1 byte</description></item>
+/// <item><description>7: the key class (public or private), 1 byte</description></item>
+/// <item><description>8: the key length in bytes, 8 bytes little endian</description></item>
+/// <item><description>16: the key offset within the image, 4 bytes little endian; a multiple of 64</description></item>
+/// <item><description>20: reserved, zeroes</description></item>
+/// </list>
+///
+/// <para>Readers reject a newer version number, so the header can grow in later versions by moving the key offset.</para>
+/// </summary>
+class AsymmetricKeyImage
+{
+public:
+
+	/// <summary>
+	/// The key class stored in an image
+	/// </summary>
+	enum class KeyClass : byte
+	{
+		/// <summary>
+		/// No key class is specified
+		/// </summary>
+		None = 0,
+		/// <summary>
+		/// The image contains a public key
+		/// </summary>
+		PublicKey = 1,
+		/// <summary>
+		/// The image contains a private key
+		/// </summary>
+		PrivateKey = 2
+	};
+
+	/// <summary>
+	/// The image header size, and the alignment of the key within the image
+	/// </summary>
+	static const size_t HEADER_SIZE = 64;
+
+	/// <summary>
+	/// The image magic number; 'CEXK' in little endian order
+	/// </summary>
+	static const uint IMAGE_MAGIC = 0x4B584543;
+
+	/// <summary>
+	/// The image format version written by this library
+	/// </summary>
+	static const byte IMAGE_VERSION = 1;
+
+	AsymmetricKeyImage() = delete;
+	AsymmetricKeyImage(const AsymmetricKeyImage&) = delete;
+	AsymmetricKeyImage& operator=(const AsymmetricKeyImage&) = delete;
+
+	/// <summary>
+	/// Create a key image
+	/// </summary>
+	///
+	/// <param name="Engine">The cipher type the key belongs to</param>
+	/// <param name="Parameters">The cipher parameter set enumeration value</param>
+	/// <param name="Class">The key class</param>
+	/// <param name="Key">The raw key</param>
+	///
+	/// <returns>The key image; write it to a file as-is to produce a mappable key</returns>
+	static std::vector<byte> Create(AsymmetricEngines Engine, byte Parameters, KeyClass Class, const IO::ByteView &Key);
+
+	/// <summary>
+	/// Validate a key image and return a view of the key within it
+	/// </summary>
+	///
+	/// <param name="Image">The key image, typically the view of a memory mapped file</param>
+	/// <param name="Engine">The expected cipher type</param>
+	/// <param name="Class">The expected key class</param>
+	/// <param name="Parameters">Receives the cipher parameter set enumeration value</param>
+	///
+	/// <returns>A view of the key; it references the image memory and does not copy it</returns>
+	///
+	/// <exception cref="Exception::CryptoAsymmetricException">Thrown if the image is truncated, has an unknown version, or does not hold the expected key</exception>
+	static IO::ByteView Open(const IO::ByteView &Image, AsymmetricEngines Engine, KeyClass Class, byte &Parameters);
+};
+
+NAMESPACE_ASYMMETRICKEYEND
+#endif
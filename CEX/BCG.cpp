@@ -1,5 +1,6 @@
 #include "BCG.h"
 #include "BlockCipherFromName.h"
+#include "CounterUtils.h"
 #include "DigestFromName.h"
 #include "KDF2.h"
 #include "IntUtils.h"
@@ -394,44 +395,12 @@ void BCG::Transform(std::vector<byte> &Output, const size_t OutOffset, const siz
 	if (Length >= AVX512BLK)
 	{
 		const size_t PBKALN = Length - (Length % AVX512BLK);
-		std::vector<byte> ctrBlk(AVX512BLK);
 
-		// stagger counters and process 8 blocks with avx
+		// write the staggered counters to the output and transform 16 blocks in-place with avx512
 		while (blkCtr != PBKALN)
 		{
-			Utility::MemUtils::COPY128(Counter, 0, ctrBlk, 0);
-			Utility::IntUtils::BeIncrement8(Counter);
-			Utility::MemUtils::COPY128(Counter, 0, ctrBlk, 16);
-			Utility::IntUtils::BeIncrement8(Counter);
-			Utility::MemUtils::COPY128(Counter, 0, ctrBlk, 32);
-			Utility::IntUtils::BeIncrement8(Counter);
-			Utility::MemUtils::COPY128(Counter, 0, ctrBlk, 48);
-			Utility::IntUtils::BeIncrement8(Counter);
-			Utility::MemUtils::COPY128(Counter, 0, ctrBlk, 64);
-			Utility::IntUtils::BeIncrement8(Counter);
-			Utility::MemUtils::COPY128(Counter, 0, ctrBlk, 80);
-			Utility::IntUtils::BeIncrement8(Counter);
-			Utility::MemUtils::COPY128(Counter, 0, ctrBlk, 96);
-			Utility::IntUtils::BeIncrement8(Counter);
-			Utility::MemUtils::COPY128(Counter, 0, ctrBlk, 112);
-			Utility::IntUtils::BeIncrement8(Counter);
-			Utility::MemUtils::COPY128(Counter, 0, ctrBlk, 128);
-			Utility::IntUtils::BeIncrement8(Counter);
-			Utility::MemUtils::COPY128(Counter, 0, ctrBlk, 144);
-			Utility::IntUtils::BeIncrement8(Counter);
-			Utility::MemUtils::COPY128(Counter, 0, ctrBlk, 160);
-			Utility::IntUtils::BeIncrement8(Counter);
-			Utility::MemUtils::COPY128(Counter, 0, ctrBlk, 176);
-			Utility::IntUtils::BeIncrement8(Counter);
-			Utility::MemUtils::COPY128(Counter, 0, ctrBlk, 192);
-			Utility::IntUtils::BeIncrement8(Counter);
-			Utility::MemUtils::COPY128(Counter, 0, ctrBlk, 208);
-			Utility::IntUtils::BeIncrement8(Counter);
-			Utility::MemUtils::COPY128(Counter, 0, ctrBlk, 224);
-			Utility::IntUtils::BeIncrement8(Counter);
-			Utility::MemUtils::COPY128(Counter, 0, ctrBlk, 240);
-			Utility::IntUtils::BeIncrement8(Counter);
-			m_blockCipher->Transform2048(ctrBlk, 0, Output, OutOffset + blkCtr);
+			Utility::CounterUtils::BeGenerate128(Counter, Output, OutOffset + blkCtr, 16);
+			m_blockCipher->Transform2048(Output, OutOffset + blkCtr, Output, OutOffset + blkCtr);
 			blkCtr += AVX512BLK;
 		}
 	}
@@ -440,28 +409,12 @@ void BCG::Transform(std::vector<byte> &Output, const size_t OutOffset, const siz
 	if (Length >= AVX2BLK)
 	{
 		const size_t PBKALN = Length - (Length % AVX2BLK);
-		std::vector<byte> ctrBlk(AVX2BLK);
 
-		// stagger counters and process 8 blocks with avx
+		// 8 blocks with avx2
 		while (blkCtr != PBKALN)
 		{
-			Utility::MemUtils::COPY128(Counter, 0, ctrBlk, 0);
-			Utility::IntUtils::BeIncrement8(Counter);
-			Utility::MemUtils::COPY128(Counter, 0, ctrBlk, 16);
-			Utility::IntUtils::BeIncrement8(Counter);
-			Utility::MemUtils::COPY128(Counter, 0, ctrBlk, 32);
-			Utility::IntUtils::BeIncrement8(Counter);
-			Utility::MemUtils::COPY128(Counter, 0, ctrBlk, 48);
-			Utility::IntUtils::BeIncrement8(Counter);
-			Utility::MemUtils::COPY128(Counter, 0, ctrBlk, 64);
-			Utility::IntUtils::BeIncrement8(Counter);
-			Utility::MemUtils::COPY128(Counter, 0, ctrBlk, 80);
-			Utility::IntUtils::BeIncrement8(Counter);
-			Utility::MemUtils::COPY128(Counter, 0, ctrBlk, 96);
-			Utility::IntUtils::BeIncrement8(Counter);
-			Utility::MemUtils::COPY128(Counter, 0, ctrBlk, 112);
-			Utility::IntUtils::BeIncrement8(Counter);
-			m_blockCipher->Transform1024(ctrBlk, 0, Output, OutOffset + blkCtr);
+			Utility::CounterUtils::BeGenerate128(Counter, Output, OutOffset + blkCtr, 8);
+			m_blockCipher->Transform1024(Output, OutOffset + blkCtr, Output, OutOffset + blkCtr);
 			blkCtr += AVX2BLK;
 		}
 	}
@@ -470,20 +423,12 @@ void BCG::Transform(std::vector<byte> &Output, const size_t OutOffset, const siz
 	if (Length >= AVXBLK)
 	{
 		const size_t PBKALN = Length - (Length % AVXBLK);
-		std::vector<byte> ctrBlk(AVXBLK);
 
 		// 4 blocks with sse
 		while (blkCtr != PBKALN)
 		{
-			Utility::MemUtils::COPY128(Counter, 0, ctrBlk, 0);
-			Utility::IntUtils::BeIncrement8(Counter);
-			Utility::MemUtils::COPY128(Counter, 0, ctrBlk, 16);
-			Utility::IntUtils::BeIncrement8(Counter);
-			Utility::MemUtils::COPY128(Counter, 0, ctrBlk, 32);
-			Utility::IntUtils::BeIncrement8(Counter);
-			Utility::MemUtils::COPY128(Counter, 0, ctrBlk, 48);
-			Utility::IntUtils::BeIncrement8(Counter);
-			m_blockCipher->Transform512(ctrBlk, 0, Output, OutOffset + blkCtr);
+			Utility::CounterUtils::BeGenerate128(Counter, Output, OutOffset + blkCtr, 4);
+			m_blockCipher->Transform512(Output, OutOffset + blkCtr, Output, OutOffset + blkCtr);
 			blkCtr += AVXBLK;
 		}
 	}
@@ -0,0 +1,143 @@
+// The GPL version 3 License (GPLv3)
+//
+// Copyright (c) 2017 vtdev.com
+// This file is part of the CEX Cryptographic library.
+//
+// This program is free software : you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef CEX_BYTEVIEW_H
+#define CEX_BYTEVIEW_H
+
+#include "CexDomain.h"
+#include <cstring>
+
+NAMESPACE_IO
+
+/// <summary>
+/// A read-only, non-owning view of a contiguous byte array.
+/// <para>The view exposes the indexing and size members used by the library array templates (IntUtils, MemUtils, and the SIMD loaders),
+/// so a key held in a vector or in a memory mapped file can be read in place through the same code.
+/// A vector converts to a view implicitly. The view does not extend the lifetime of the memory it references.</para>
+/// </summary>
+class ByteView
+{
+private:
+
+	const byte* m_viewData;
+	size_t m_viewSize;
+
+public:
+
+	/// <summary>
+	/// Initialize an empty view
+	/// </summary>
+	ByteView()
+		:
+		m_viewData(nullptr),
+		m_viewSize(0)
+	{
+	}
+
+	/// <summary>
+	/// Initialize a view over a byte array
+	/// </summary>
+	///
+	/// <param name="Data">A pointer to the first byte</param>
+	/// <param name="Length">The number of bytes in the view</param>
+	ByteView(const byte* Data, size_t Length)
+		:
+		m_viewData(Data),
+		m_viewSize(Length)
+	{
+	}
+
+	/// <summary>
+	/// Initialize a view over the contents of a vector
+	/// </summary>
+	///
+	/// <param name="Input">The source vector; must not be resized while the view is in use</param>
+	ByteView(const std::vector<byte> &Input)
+		:
+		m_viewData(Input.size() != 0 ? Input.data() : nullptr),
+		m_viewSize(Input.size())
+	{
+	}
+
+	/// <summary>
+	/// Get: A pointer to the first byte of the view
+	/// </summary>
+	const byte* data() const
+	{
+		return m_viewData;
+	}
+
+	/// <summary>
+	/// Get: The view is empty
+	/// </summary>
+	bool empty() const
+	{
+		return m_viewSize == 0;
+	}
+
+	/// <summary>
+	/// Get: The number of bytes in the view
+	/// </summary>
+	size_t size() const
+	{
+		return m_viewSize;
+	}
+
+	/// <summary>
+	/// Copy the viewed bytes into a new vector
+	/// </summary>
+	///
+	/// <returns>A vector containing a copy of the view</returns>
+	std::vector<byte> ToVector() const
+	{
+		return (m_viewSize != 0) ? std::vector<byte>(m_viewData, m_viewData + m_viewSize) : std::vector<byte>(0);
+	}
+
+	/// <summary>
+	/// Read a byte from the view
+	/// </summary>
+	///
+	/// <param name="Index">The byte position</param>
+	const byte &operator [] (size_t Index) const
+	{
+		return m_viewData[Index];
+	}
+
+	/// <summary>
+	/// Compare the contents of two views
+	/// </summary>
+	///
+	/// <param name="X">The view to compare</param>
+	bool operator == (const ByteView &X) const
+	{
+		return (m_viewSize == X.m_viewSize) && (m_viewSize == 0 || std::memcmp(m_viewData, X.m_viewData, m_viewSize) == 0);
+	}
+
+	/// <summary>
+	/// Compare the contents of two views
+	/// </summary>
+	///
+	/// <param name="X">The view to compare</param>
+	bool operator != (const ByteView &X) const
+	{
+		return !(*this == X);
+	}
+};
+
+NAMESPACE_IOEND
+#endif
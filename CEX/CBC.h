@@ -27,7 +27,7 @@
 #ifndef CEX_CBC_H
 #define CEX_CBC_H
 
-#include "ICipherMode.h"
+#include "CBCT.h"
 
 NAMESPACE_MODE
 
@@ -107,6 +107,7 @@ NAMESPACE_MODE
 /// <item><description>CBC-WBV uses the Transform512() or Transform1024() functions to process input in 64 or 128 byte message blocks in sequential mode.</description></item>
 /// <item><description>CBC-WBV output is <B>not equal</B> to the mode run with a smaller block size; Encryption and Decryption must be performed using an identical block length.</description></item>
 /// <item><description>CBC-WBV uses ParallelBlockSize() sized input message blocks to process in multi-threaded mode.</description></item>
+/// <item><description>The mode is implemented by the CBCT&lt;TCipher&gt; template in CBCT.h; this class wraps CBCT&lt;IBlockCipher&gt;. When the cipher type is known at compile time, CBCT with a final cipher class, ex. CBCT&lt;AHX&gt;, produces the same output without the virtual calls in the chaining and parallel decryption loops.</description></item>
 /// </list>
 /// 
 /// <description>Guiding Publications:</description>
@@ -119,18 +120,9 @@ class CBC final : public ICipherMode
 {
 private:
 
-	static const size_t BLOCK_SIZE = 16;
-	static const std::string CLASS_NAME;
-
-	IBlockCipher* m_blockCipher;
-	std::vector<byte> m_cbcVector;
+	std::unique_ptr<CBCT<IBlockCipher>> m_cbcMode;
 	BlockCiphers m_cipherType;
-	bool m_destroyEngine;
 	bool m_isDestroyed;
-	bool m_isEncryption;
-	bool m_isInitialized;
-	bool m_isLoaded;
-	ParallelOptions m_parallelProfile;
 
 public:
 
@@ -190,7 +182,7 @@ public:
 	/// <summary>
 	/// Get: The CBC initialization vector (exposed for CMAC)
 	/// </summary>
-	std::vector<byte> &Nonce() { return m_cbcVector; }
+	std::vector<byte> &Nonce();
 
 	/// <summary>
 	/// Get: Parallel block size; the byte-size of the input/output data arrays passed to a transform that trigger parallel processing.
@@ -230,6 +222,17 @@ public:
 
 	//~~~Public Functions~~~//
 
+	/// <summary>
+	/// Create an initialized copy of this cipher mode.
+	/// <para>The block cipher is copied with its Clone() function, so the key is not expanded again, and the copy owns its cipher instance.
+	/// The chaining vector, direction, and parallel profile are copied. The caller is responsible for destroying the returned mode.</para>
+	/// </summary>
+	///
+	/// <returns>A new, initialized CBC instance</returns>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the cipher mode has not been initialized</exception>
+	CBC* Clone() override;
+
 	/// <summary>
 	/// Decrypt a single block of bytes.
 	/// <para>Decrypts one block of bytes beginning at a zero index.
@@ -320,12 +323,7 @@ public:
 
 private:
 
-	void Decrypt128(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset);
-	void DecryptParallel(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset);
-	void DecryptSegment(const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset, std::vector<byte> &Iv, const size_t BlockCount);
-	void Encrypt128(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset);
-	void Process(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset, const size_t Length);
-	void Scope();
+	CBC(CBCT<IBlockCipher>* Mode, BlockCiphers CipherType);
 };
 
 NAMESPACE_MODEEND
@@ -0,0 +1,554 @@
+// The GPL version 3 License (GPLv3)
+//
+// Copyright (c) 2017 vtdev.com
+// This file is part of the CEX Cryptographic library.
+//
+// This program is free software : you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+//
+// Implementation Details:
+// A cipher specialized template of the Cipher Block Chaining Mode (CBC); the CBC class is this template instantiated with the IBlockCipher interface.
+
+#ifndef CEX_CBCT_H
+#define CEX_CBCT_H
+
+#include "ICipherMode.h"
+#include "IntUtils.h"
+#include "MemUtils.h"
+#include "ParallelUtils.h"
+
+NAMESPACE_MODE
+
+/// <summary>
+/// A Cipher Block Chaining Mode template, specialized at compile time for a block cipher type
+/// </summary>
+///
+/// <example>
+/// <description>Decrypting a message with a specialized AES-NI CBC mode:</description>
+/// <code>
+/// CBCT&lt;AHX&gt; cipher;
+/// // initialize for decryption
+/// cipher.Initialize(false, SymmetricKey(Key, Nonce));
+/// // decrypt the message
+/// cipher.Transform(Input, 0, Output, 0, Input.size());
+/// </code>
+/// </example>
+///
+/// <remarks>
+/// <para>CBCT is the single implementation of the CBC mode; the CBC class wraps CBCT&lt;IBlockCipher&gt;, so the two produce identical output.
+/// The cipher is held as a pointer to the template type; when the type is a final cipher class such as AHX, the calls in the chaining and parallel decryption loops are resolved at compile time. AHX defines its transforms in AHX.h, so CBCT&lt;AHX&gt; decrypts with the AES-NI rounds inlined into the segment loop.
+/// The SIMD width of the parallel decryption transform (4, 8, or 16 blocks) is a compile time constant.
+/// The class implements ICipherMode, and can be used anywhere the interface is accepted.</para>
+///
+/// <list type="bullet">
+/// <item><description>The template parameter is a block cipher class, ex. CBCT&lt;AHX&gt; or CBCT&lt;SHX&gt;; the constructor arguments are forwarded to the ciphers constructor, and the mode owns the cipher it creates.</description></item>
+/// <item><description>A cipher instance can also be passed to the CBCT(TCipher*, bool) constructor; it is deleted with the mode only if DestroyEngine is true.</description></item>
+/// <item><description>Clone() copies the keyed cipher and the chaining vector into a new instance, so a template mode can be used as a ModeContextPool prototype.</description></item>
+/// <item><description>Only the decryption function can be processed in parallel, as it is in CBC.</description></item>
+/// </list>
+/// </remarks>
+template <typename TCipher>
+class CBCT final : public ICipherMode
+{
+private:
+
+	static const size_t BLOCK_SIZE = 16;
+
+	// number of blocks decrypted by the widest cipher transform
+#if defined(__AVX512__)
+	static constexpr size_t SIMD_BLOCKS = 16;
+#elif defined(__AVX2__)
+	static constexpr size_t SIMD_BLOCKS = 8;
+#elif defined(__AVX__)
+	static constexpr size_t SIMD_BLOCKS = 4;
+#else
+	static constexpr size_t SIMD_BLOCKS = 1;
+#endif
+	static constexpr size_t SIMD_SIZE = SIMD_BLOCKS * BLOCK_SIZE;
+
+	TCipher* m_blockCipher;
+	std::vector<byte> m_cbcVector;
+	bool m_destroyEngine;
+	bool m_isDestroyed;
+	bool m_isEncryption;
+	bool m_isInitialized;
+	ParallelOptions m_parallelProfile;
+
+public:
+
+	CBCT(const CBCT&) = delete;
+	CBCT& operator=(const CBCT&) = delete;
+	CBCT& operator=(CBCT&&) = delete;
+
+	//~~~Properties~~~//
+
+	/// <summary>
+	/// Get: Block size of internal cipher in bytes
+	/// </summary>
+	const size_t BlockSize() override
+	{
+		return BLOCK_SIZE;
+	}
+
+	/// <summary>
+	/// Get: The block ciphers formal type name
+	/// </summary>
+	const BlockCiphers CipherType() override
+	{
+		return m_blockCipher->Enumeral();
+	}
+
+	/// <summary>
+	/// Get: The underlying Block Cipher instance
+	/// </summary>
+	IBlockCipher* Engine() override
+	{
+		return m_blockCipher;
+	}
+
+	/// <summary>
+	/// Get: The cipher modes type name
+	/// </summary>
+	const CipherModes Enumeral() override
+	{
+		return CipherModes::CBC;
+	}
+
+	/// <summary>
+	/// Get: True if initialized for encryption, False for decryption
+	/// </summary>
+	const bool IsEncryption() override
+	{
+		return m_isEncryption;
+	}
+
+	/// <summary>
+	/// Get: The Block Cipher is ready to transform data
+	/// </summary>
+	const bool IsInitialized() override
+	{
+		return m_isInitialized;
+	}
+
+	/// <summary>
+	/// Get: Processor parallelization availability.
+	/// <para>Indicates whether parallel processing is available with this mode.
+	/// If parallel capable, input/output data arrays passed to the transform must be ParallelBlockSize in bytes to trigger parallelization.</para>
+	/// </summary>
+	const bool IsParallel() override
+	{
+		return m_parallelProfile.IsParallel();
+	}
+
+	/// <summary>
+	/// Get: Array of allowed cipher input key byte-sizes
+	/// </summary>
+	const std::vector<SymmetricKeySize> &LegalKeySizes() override
+	{
+		return m_blockCipher->LegalKeySizes();
+	}
+
+	/// <summary>
+	/// Get: The cipher modes class name
+	/// </summary>
+	const std::string Name() override
+	{
+		return std::string("CBC-") + m_blockCipher->Name();
+	}
+
+	/// <summary>
+	/// Get: The CBC initialization vector (exposed for CMAC)
+	/// </summary>
+	std::vector<byte> &Nonce()
+	{
+		return m_cbcVector;
+	}
+
+	/// <summary>
+	/// Get: Parallel block size; the byte-size of the input/output data arrays passed to a transform that trigger parallel processing.
+	/// <para>This value can be changed through the ParallelProfile class.<para>
+	/// </summary>
+	const size_t ParallelBlockSize() override
+	{
+		return m_parallelProfile.ParallelBlockSize();
+	}
+
+	/// <summary>
+	/// Get/Set: Parallel and SIMD capability flags and sizes
+	/// </summary>
+	ParallelOptions &ParallelProfile() override
+	{
+		return m_parallelProfile;
+	}
+
+	//~~~Constructor~~~//
+
+	/// <summary>
+	/// Initialize the Cipher Mode, constructing the block cipher; the cipher is owned by the mode
+	/// </summary>
+	///
+	/// <param name="CipherArgs">The block cipher constructor arguments, ex. the HKDF digest type and the number of rounds; can be empty</param>
+	template <typename... TArgs>
+	explicit CBCT(TArgs&&... CipherArgs)
+		:
+		m_blockCipher(new TCipher(std::forward<TArgs>(CipherArgs)...)),
+		m_cbcVector(BLOCK_SIZE),
+		m_destroyEngine(true),
+		m_isDestroyed(false),
+		m_isEncryption(false),
+		m_isInitialized(false),
+		m_parallelProfile(BLOCK_SIZE, true, m_blockCipher->StateCacheSize(), true)
+	{
+	}
+
+	/// <summary>
+	/// Initialize the Cipher Mode using a block cipher instance
+	/// </summary>
+	///
+	/// <param name="Cipher">The uninitialized block cipher instance; can not be null</param>
+	/// <param name="DestroyEngine">Delete the cipher when the mode is destroyed</param>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if a null block cipher is used</exception>
+	CBCT(TCipher* Cipher, bool DestroyEngine)
+		:
+		m_blockCipher(Cipher != 0 ? Cipher : throw CryptoCipherModeException("CBCT:CTor", "The Cipher can not be null!")),
+		m_cbcVector(BLOCK_SIZE),
+		m_destroyEngine(DestroyEngine),
+		m_isDestroyed(false),
+		m_isEncryption(false),
+		m_isInitialized(false),
+		m_parallelProfile(BLOCK_SIZE, true, m_blockCipher->StateCacheSize(), true)
+	{
+	}
+
+	/// <summary>
+	/// Finalize objects
+	/// </summary>
+	~CBCT() override
+	{
+		Destroy();
+	}
+
+	//~~~Public Functions~~~//
+
+	/// <summary>
+	/// Create an initialized copy of this cipher mode.
+	/// <para>The block cipher is copied with its Clone() function, so the key is not expanded again, and the copy owns its cipher instance.
+	/// The chaining vector, direction, and parallel profile are copied. The caller is responsible for destroying the returned mode.</para>
+	/// </summary>
+	///
+	/// <returns>A new, initialized CBCT instance</returns>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the cipher mode has not been initialized</exception>
+	CBCT* Clone() override
+	{
+		if (!m_isInitialized)
+			throw CryptoCipherModeException("CBCT:Clone", "The cipher mode has not been initialized!");
+
+		CBCT* mode = new CBCT(static_cast<TCipher*>(m_blockCipher->Clone()), true);
+		mode->m_cbcVector = m_cbcVector;
+		mode->m_isEncryption = m_isEncryption;
+		mode->m_isInitialized = true;
+		mode->m_parallelProfile = m_parallelProfile;
+
+		return mode;
+	}
+
+	/// <summary>
+	/// Decrypt a single block of bytes.
+	/// <para>Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	///
+	/// <param name="Input">The input array of encrypted bytes</param>
+	/// <param name="Output">The output array of decrypted bytes</param>
+	void DecryptBlock(const std::vector<byte> &Input, std::vector<byte> &Output) override
+	{
+		Decrypt128(Input, 0, Output, 0);
+	}
+
+	/// <summary>
+	/// Decrypt a block of bytes with offset parameters.
+	/// <para>Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	///
+	/// <param name="Input">The input array of encrypted bytes</param>
+	/// <param name="InOffset">Starting offset within the Input array</param>
+	/// <param name="Output">The output array of decrypted bytes</param>
+	/// <param name="OutOffset">Starting offset within the Output array</param>
+	void DecryptBlock(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset) override
+	{
+		Decrypt128(Input, InOffset, Output, OutOffset);
+	}
+
+	/// <summary>
+	/// Release all resources associated with the object; optional, called by the finalizer
+	/// </summary>
+	void Destroy() override
+	{
+		if (!m_isDestroyed)
+		{
+			m_isDestroyed = true;
+			m_isEncryption = false;
+			m_isInitialized = false;
+			m_parallelProfile.Reset();
+
+			if (m_destroyEngine)
+			{
+				m_destroyEngine = false;
+
+				if (m_blockCipher != 0)
+					delete m_blockCipher;
+			}
+
+			Utility::IntUtils::ClearVector(m_cbcVector);
+		}
+	}
+
+	/// <summary>
+	/// Encrypt a single block of bytes.
+	/// <para>Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	///
+	/// <param name="Input">The input array of plain text bytes</param>
+	/// <param name="Output">The output array of encrypted bytes</param>
+	void EncryptBlock(const std::vector<byte> &Input, std::vector<byte> &Output) override
+	{
+		Encrypt128(Input, 0, Output, 0);
+	}
+
+	/// <summary>
+	/// Encrypt a block of bytes using offset parameters.
+	/// <para>Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	///
+	/// <param name="Input">The input array of plain text bytes</param>
+	/// <param name="InOffset">Starting offset within the input array</param>
+	/// <param name="Output">The output array of encrypted bytes</param>
+	/// <param name="OutOffset">Starting offset within the output array</param>
+	void EncryptBlock(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset) override
+	{
+		Encrypt128(Input, InOffset, Output, OutOffset);
+	}
+
+	/// <summary>
+	/// Initialize the Cipher instance
+	/// </summary>
+	///
+	/// <param name="Encryption">True if cipher is used for encryption, False to decrypt</param>
+	/// <param name="KeyParams">SymmetricKey containing the encryption Key and Initialization Vector</param>
+	///
+	/// <exception cref="CryptoSymmetricCipherException">Thrown if an invalid key or nonce size, or parallel block size is used</exception>
+	void Initialize(bool Encryption, ISymmetricKey &KeyParams) override
+	{
+		if (KeyParams.Nonce().size() < BLOCK_SIZE)
+			throw CryptoSymmetricCipherException("CBCT:Initialize", "Requires a minimum 16 bytes of Nonce!");
+		if (!SymmetricKeySize::Contains(LegalKeySizes(), KeyParams.Key().size()))
+			throw CryptoSymmetricCipherException("CBCT:Initialize", "Invalid key size! Key must be one of the LegalKeySizes() in length.");
+		if (m_parallelProfile.IsParallel() && m_parallelProfile.ParallelBlockSize() < m_parallelProfile.ParallelMinimumSize() || m_parallelProfile.ParallelBlockSize() > m_parallelProfile.ParallelMaximumSize())
+			throw CryptoSymmetricCipherException("CBCT:Initialize", "The parallel block size is out of bounds!");
+		if (m_parallelProfile.IsParallel() && m_parallelProfile.ParallelBlockSize() % m_parallelProfile.ParallelMinimumSize() != 0)
+			throw CryptoSymmetricCipherException("CBCT:Initialize", "The parallel block size must be evenly aligned to the ParallelMinimumSize!");
+
+		if (!m_parallelProfile.IsDefault())
+			m_parallelProfile.Calculate();
+
+		m_blockCipher->Initialize(Encryption, KeyParams);
+		m_cbcVector = KeyParams.Nonce();
+		m_isEncryption = Encryption;
+		m_isInitialized = true;
+	}
+
+	/// <summary>
+	/// Set the maximum number of threads allocated when using multi-threaded processing.
+	/// <para>Thread count must be an even number, and not exceed the number of processor cores.</para>
+	/// </summary>
+	///
+	/// <param name="Degree">The desired number of threads</param>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if an invalid degree setting is used</exception>
+	void ParallelMaxDegree(size_t Degree) override
+	{
+		if (Degree == 0)
+			throw CryptoCipherModeException("CBCT:ParallelMaxDegree", "Parallel degree can not be zero!");
+		if (Degree % 2 != 0)
+			throw CryptoCipherModeException("CBCT:ParallelMaxDegree", "Parallel degree must be an even number!");
+		if (Degree > m_parallelProfile.ProcessorCount())
+			throw CryptoCipherModeException("CBCT:ParallelMaxDegree", "Parallel degree can not exceed processor count!");
+
+		m_parallelProfile.SetMaxDegree(Degree);
+	}
+
+	/// <summary>
+	/// Transform a length of bytes with offset parameters.
+	/// <para>If IsParallel() is set to true, and the length is at least ParallelBlockSize(), decryption is run in parallel processing mode; encryption is always sequential.
+	/// The length must be a multiple of the block size. Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	///
+	/// <param name="Input">The input array of bytes to transform</param>
+	/// <param name="InOffset">Starting offset within the input array</param>
+	/// <param name="Output">The output array of transformed bytes</param>
+	/// <param name="OutOffset">Starting offset within the output array</param>
+	/// <param name="Length">The number of bytes to transform</param>
+	void Transform(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset, const size_t Length) override
+	{
+		CexAssert(m_isInitialized, "The cipher mode has not been initialized!");
+		CexAssert(Utility::IntUtils::Min(Input.size() - InOffset, Output.size() - OutOffset) >= Length, "The data arrays are smaller than the the block-size!");
+		CexAssert(Length % BLOCK_SIZE == 0, "The length must be evenly divisible by the block ciphers block-size!");
+
+		size_t blkCtr = Length / BLOCK_SIZE;
+
+		if (m_isEncryption)
+		{
+			for (size_t i = 0; i < blkCtr; ++i)
+				Encrypt128(Input, (i * BLOCK_SIZE) + InOffset, Output, (i * BLOCK_SIZE) + OutOffset);
+		}
+		else
+		{
+			if (m_parallelProfile.IsParallel() && Length >= m_parallelProfile.ParallelBlockSize())
+			{
+				const size_t PRBCNT = Length / m_parallelProfile.ParallelBlockSize();
+
+				for (size_t i = 0; i < PRBCNT; ++i)
+					DecryptParallel(Input, (i * m_parallelProfile.ParallelBlockSize()) + InOffset, Output, (i * m_parallelProfile.ParallelBlockSize()) + OutOffset);
+
+				const size_t PRCBLK = (m_parallelProfile.ParallelBlockSize() / BLOCK_SIZE) * PRBCNT;
+				blkCtr -= PRCBLK;
+
+				for (size_t i = 0; i < blkCtr; ++i)
+					Decrypt128(Input, ((i + PRCBLK) * BLOCK_SIZE) + InOffset, Output, ((i + PRCBLK) * BLOCK_SIZE) + OutOffset);
+			}
+			else
+			{
+				for (size_t i = 0; i < blkCtr; ++i)
+					Decrypt128(Input, (i * BLOCK_SIZE) + InOffset, Output, (i * BLOCK_SIZE) + OutOffset);
+			}
+		}
+	}
+
+private:
+
+	void Decrypt128(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
+	{
+		CexAssert(m_isInitialized, "The cipher mode has not been initialized!");
+		CexAssert(Utility::IntUtils::Min(Input.size() - InOffset, Output.size() - OutOffset) >= BLOCK_SIZE, "The data arrays are smaller than the the block-size!");
+
+		std::vector<byte> nxtIv(BLOCK_SIZE);
+		Utility::MemUtils::COPY128(Input, InOffset, nxtIv, 0);
+		m_blockCipher->DecryptBlock(Input, InOffset, Output, OutOffset);
+		Utility::MemUtils::XOR128(m_cbcVector, 0, Output, OutOffset);
+		Utility::MemUtils::COPY128(nxtIv, 0, m_cbcVector, 0);
+	}
+
+	void DecryptParallel(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
+	{
+		const size_t SEGSZE = m_parallelProfile.ParallelBlockSize() / m_parallelProfile.ParallelMaxDegree();
+		const size_t BLKCNT = (SEGSZE / BLOCK_SIZE);
+		std::vector<byte> tmpIv(BLOCK_SIZE);
+
+		Utility::ParallelUtils::ParallelFor(0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset, &Output, OutOffset, &tmpIv, SEGSZE, BLKCNT](size_t i)
+		{
+			std::vector<byte> thdIv(BLOCK_SIZE);
+
+			if (i != 0)
+				Utility::MemUtils::COPY128(Input, (InOffset + (i * SEGSZE)) - BLOCK_SIZE, thdIv, 0);
+			else
+				Utility::MemUtils::COPY128(m_cbcVector, 0, thdIv, 0);
+
+			this->DecryptSegment(Input, InOffset + i * SEGSZE, Output, OutOffset + i * SEGSZE, thdIv, BLKCNT);
+
+			if (i == m_parallelProfile.ParallelMaxDegree() - 1)
+				Utility::MemUtils::COPY128(thdIv, 0, tmpIv, 0);
+		});
+
+		Utility::MemUtils::COPY128(tmpIv, 0, m_cbcVector, 0);
+	}
+
+	void DecryptSegment(const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset, std::vector<byte> &Iv, const size_t BlockCount)
+	{
+		size_t blkCtr = BlockCount;
+
+		if (SIMD_BLOCKS > 1 && blkCtr >= SIMD_BLOCKS)
+		{
+			size_t rndCtr = (blkCtr / SIMD_BLOCKS);
+			std::vector<byte> blkIv(SIMD_SIZE);
+			std::vector<byte> blkNxt(SIMD_SIZE);
+			const size_t BLKOFT = SIMD_SIZE - Iv.size();
+
+			// build the wide iv from the previous cipher-text blocks
+			Utility::MemUtils::COPY128(Iv, 0, blkIv, 0);
+			Utility::MemUtils::Copy(Input, InOffset, blkIv, BLOCK_SIZE, BLKOFT);
+
+			while (rndCtr != 0)
+			{
+				const size_t INPOFT = InOffset + BLKOFT;
+				// store next iv
+				Utility::MemUtils::Copy(Input, INPOFT, blkNxt, 0, (Input.size() - INPOFT >= SIMD_SIZE) ? SIMD_SIZE : Input.size() - INPOFT);
+				// decrypt the set with the widest cipher transform
+				TransformW(Input, InOffset, Output, OutOffset);
+				Utility::MemUtils::XorBlock(blkIv, 0, Output, OutOffset, SIMD_SIZE);
+				// swap iv
+				Utility::MemUtils::Copy(blkNxt, 0, blkIv, 0, SIMD_SIZE);
+				InOffset += SIMD_SIZE;
+				OutOffset += SIMD_SIZE;
+				blkCtr -= SIMD_BLOCKS;
+				--rndCtr;
+			}
+
+			Utility::MemUtils::COPY128(blkNxt, 0, Iv, 0);
+		}
+
+		if (blkCtr != 0)
+		{
+			// Note: if it's hitting this, your parallel block size is misaligned
+			std::vector<byte> nxtIv(BLOCK_SIZE);
+
+			while (blkCtr != 0)
+			{
+				Utility::MemUtils::COPY128(Input, InOffset, nxtIv, 0);
+				m_blockCipher->DecryptBlock(Input, InOffset, Output, OutOffset);
+				Utility::MemUtils::XOR128(Iv, 0, Output, OutOffset);
+				Utility::MemUtils::COPY128(nxtIv, 0, Iv, 0);
+				InOffset += BLOCK_SIZE;
+				OutOffset += BLOCK_SIZE;
+				--blkCtr;
+			}
+		}
+	}
+
+	void Encrypt128(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
+	{
+		CexAssert(m_isInitialized, "The cipher mode has not been initialized!");
+		CexAssert(Utility::IntUtils::Min(Input.size() - InOffset, Output.size() - OutOffset) >= BLOCK_SIZE, "The data arrays are smaller than the the block-size!");
+
+		Utility::MemUtils::XOR128(Input, InOffset, m_cbcVector, 0);
+		m_blockCipher->EncryptBlock(m_cbcVector, 0, Output, OutOffset);
+		Utility::MemUtils::COPY128(Output, OutOffset, m_cbcVector, 0);
+	}
+
+	void TransformW(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
+	{
+#if defined(__AVX512__)
+		m_blockCipher->Transform2048(Input, InOffset, Output, OutOffset);
+#elif defined(__AVX2__)
+		m_blockCipher->Transform1024(Input, InOffset, Output, OutOffset);
+#elif defined(__AVX__)
+		m_blockCipher->Transform512(Input, InOffset, Output, OutOffset);
+#else
+		m_blockCipher->Transform(Input, InOffset, Output, OutOffset);
+#endif
+	}
+};
+
+NAMESPACE_MODEEND
+#endif
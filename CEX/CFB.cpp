@@ -112,6 +112,21 @@ CFB::~CFB()
 
 //~~~Public Functions~~~//
 
+CFB* CFB::Clone()
+{
+	if (!m_isInitialized)
+		throw CryptoCipherModeException("CFB:Clone", "The cipher mode has not been initialized!");
+
+	CFB* mode = new CFB(m_blockCipher->Clone(), m_blockSize);
+	mode->m_cfbVector = m_cfbVector;
+	mode->m_destroyEngine = true;
+	mode->m_isEncryption = m_isEncryption;
+	mode->m_isInitialized = true;
+	mode->m_parallelProfile = m_parallelProfile;
+
+	return mode;
+}
+
 void CFB::DecryptBlock(const std::vector<byte> &Input, std::vector<byte> &Output)
 {
 	Decrypt128(Input, 0, Output, 0);
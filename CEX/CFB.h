@@ -221,6 +221,17 @@ public:
 
 	//~~~Public Functions~~~//
 
+	/// <summary>
+	/// Create an initialized copy of this cipher mode.
+	/// <para>The block cipher is copied with its Clone() function, so the key is not expanded again, and the copy owns its cipher instance.
+	/// The feedback register, direction, and parallel profile are copied. The caller is responsible for destroying the returned mode.</para>
+	/// </summary>
+	///
+	/// <returns>A new, initialized CFB instance</returns>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the cipher mode has not been initialized</exception>
+	CFB* Clone() override;
+
 
 	/// <summary>
 	/// Decrypt a single block of bytes.
@@ -27,7 +27,7 @@
 #ifndef CEX_CTR_H
 #define CEX_CTR_H
 
-#include "ICipherMode.h"
+#include "CTRT.h"
 
 NAMESPACE_MODE
 
@@ -93,6 +93,9 @@ NAMESPACE_MODE
 /// <item><description>ParallelBlockSize() is calculated automatically based on the processor(s) L1 data cache size, this property can be user defined, and must be evenly divisible by ParallelMinimumSize().</description></item>
 /// <item><description>The ParallelBlockSize() can be changed through the ParallelProfile() property</description></item>
 /// <item><description>Parallel block calculation ex. <c>ParallelBlockSize = N - (N % .ParallelMinimumSize);</c></description></item>
+/// <item><description>The key-stream is randomly accessible; Seek(ulong) moves the counter to a block aligned position, and the positional Transform(ulong, ...) processes data starting at any byte offset within the stream.</description></item>
+/// <item><description>Counter blocks are encrypted in a small cache resident buffer and xored with the input as the output is written, so the output array is written once.</description></item>
+/// <item><description>The mode is implemented by the CTRT&lt;TCipher&gt; template in CTRT.h; this class wraps CTRT&lt;IBlockCipher&gt;. When the cipher type is known at compile time, CTRT with a final cipher class, ex. CTRT&lt;AHX&gt;, produces the same output without the virtual calls in the key-stream loops.</description></item>
 /// </list>
 /// 
 /// <description>Guiding Publications:</description>
@@ -106,18 +109,9 @@ class CTR final : public ICipherMode
 {
 private:
 
-	static const size_t BLOCK_SIZE = 16;
-	static const std::string CLASS_NAME;
-
-	IBlockCipher* m_blockCipher;
 	BlockCiphers m_cipherType;
-	std::vector<byte> m_ctrVector;
-	bool m_destroyEngine;
+	std::unique_ptr<CTRT<IBlockCipher>> m_ctrMode;
 	bool m_isDestroyed;
-	bool m_isEncryption;
-	bool m_isInitialized;
-	bool m_isLoaded;
-	ParallelOptions m_parallelProfile;
 
 public:
 
@@ -177,7 +171,7 @@ public:
 	/// <summary>
 	/// Get: The CBC initialization vector (exposed for CMAC)
 	/// </summary>
-	const std::vector<byte> &Nonce() { return m_ctrVector; }
+	const std::vector<byte> &Nonce() { return m_ctrMode->Nonce(); }
 
 	/// <summary>
 	/// Get: Parallel block size; the byte-size of the input/output data arrays passed to a transform that trigger parallel processing.
@@ -217,6 +211,17 @@ public:
 
 	//~~~Public Functions~~~//
 
+	/// <summary>
+	/// Create an initialized copy of this cipher mode.
+	/// <para>The block cipher is copied with its Clone() function, so the key is not expanded again, and the copy owns its cipher instance.
+	/// The nonce and counter position, direction, and parallel profile are copied. The caller is responsible for destroying the returned mode.</para>
+	/// </summary>
+	///
+	/// <returns>A new, initialized CTR instance</returns>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the cipher mode has not been initialized</exception>
+	CTR* Clone() override;
+
 	/// <summary>
 	/// Decrypt a single block of bytes.
 	/// <para>Decrypts one block of bytes beginning at a zero index.
@@ -273,7 +278,8 @@ public:
 	/// </summary>
 	/// 
 	/// <param name="Encryption">True if cipher is used for encryption, False to decrypt</param>
-	/// <param name="KeyParams">SymmetricKey containing the encryption Key and Initialization Vector</param>
+	/// <param name="KeyParams">SymmetricKey containing the encryption Key and Initialization Vector.
+	/// <para>Once the cipher is keyed, a key with an empty key and a new nonce resets the counter without expanding the key again.</para></param>
 	/// 
 	/// <exception cref="CryptoCipherModeException">Thrown if a null Key or Nonce is used</exception>
 	void Initialize(bool Encryption, ISymmetricKey &KeyParams) override;
@@ -289,6 +295,33 @@ public:
 	/// <exception cref="Exception::CryptoCipherModeException">Thrown if an invalid degree setting is used</exception>
 	void ParallelMaxDegree(size_t Degree) override;
 
+	/// <summary>
+	/// Set the key-stream position.
+	/// <para>The counter is calculated directly from the initial nonce, the next transform call begins at the Position byte of the key-stream.
+	/// The position must be a multiple of the block size, use the positional Transform(ulong, ...) function to access an unaligned offset.
+	/// Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	///
+	/// <param name="Position">The block aligned byte offset within the key-stream</param>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the position is not block aligned</exception>
+	void Seek(ulong Position);
+
+	/// <summary>
+	/// Transform a length of bytes beginning at a key-stream position.
+	/// <para>Random access transform; the counter is set to the block containing Position, and a partial leading block is aligned to the offset.
+	/// Processing continues with the standard Transform, the counter is left positioned after the last processed block.
+	/// Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	///
+	/// <param name="Position">The byte offset within the key-stream corresponding to the first input byte</param>
+	/// <param name="Input">The input array of bytes to transform</param>
+	/// <param name="InOffset">Starting offset within the input array</param>
+	/// <param name="Output">The output array of transformed bytes</param>
+	/// <param name="OutOffset">Starting offset within the output array</param>
+	/// <param name="Length">The number of bytes to transform</param>
+	void Transform(ulong Position, const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset, const size_t Length);
+
 	/// <summary>
 	/// Transform a length of bytes with offset parameters. 
 	/// <para>This method processes a specified length of bytes, utilizing offsets incremented by the caller.
@@ -306,11 +339,7 @@ public:
 
 private:
 
-	void Encrypt128(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset);
-	void Generate(std::vector<byte> &Output, const size_t OutOffset, const size_t Length, std::vector<byte> &Counter);
-	void Scope();
-	void ProcessParallel(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset, const size_t Length);
-	void ProcessSequential(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset, const size_t Length);
+	CTR(CTRT<IBlockCipher>* Mode, BlockCiphers CipherType);
 };
 
 NAMESPACE_MODEEND
@@ -0,0 +1,595 @@
+// The GPL version 3 License (GPLv3)
+//
+// Copyright (c) 2017 vtdev.com
+// This file is part of the CEX Cryptographic library.
+//
+// This program is free software : you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+//
+// Implementation Details:
+// A cipher specialized template of the integer Counter Mode (CTR); the CTR class is this template instantiated with the IBlockCipher interface.
+
+#ifndef CEX_CTRT_H
+#define CEX_CTRT_H
+
+#include "ICipherMode.h"
+#include "CounterUtils.h"
+#include "IntUtils.h"
+#include "MemUtils.h"
+#include "ParallelUtils.h"
+
+NAMESPACE_MODE
+
+/// <summary>
+/// A Big-Endian integer Counter Mode template, specialized at compile time for a block cipher type
+/// </summary>
+///
+/// <example>
+/// <description>Encrypting a packet with a specialized AES-NI counter mode:</description>
+/// <code>
+/// CTRT&lt;AHX&gt; cipher;
+/// // initialize for encryption
+/// cipher.Initialize(true, SymmetricKey(Key, Nonce));
+/// // encrypt the packet
+/// cipher.Transform(Input, 0, Output, 0, Input.size());
+/// </code>
+/// </example>
+///
+/// <remarks>
+/// <para>CTRT is the single implementation of the counter mode; the CTR class wraps CTRT&lt;IBlockCipher&gt;, so the two produce identical output.
+/// The cipher is held as a pointer to the template type; when the type is a final cipher class such as AHX, the calls in the key-stream loops are resolved at compile time rather than through the vtable.
+/// Ciphers that define their transforms in the header, as AHX does over the AHXEncryptW kernels in Rijndael.h, have the rounds inlined into the key-stream loops; for the others these are direct calls into the ciphers translation unit, and the saving is the per-block virtual dispatch, which dominates the cost of small packets.
+/// The SIMD width of the counter transform (4, 8, or 16 blocks) is a compile time constant.
+/// The class implements ICipherMode, and can be used anywhere the interface is accepted.</para>
+///
+/// <list type="bullet">
+/// <item><description>The template parameter is a block cipher class, ex. CTRT&lt;AHX&gt; or CTRT&lt;RHX&gt;; the constructor arguments are forwarded to the ciphers constructor, and the mode owns the cipher it creates.</description></item>
+/// <item><description>A cipher instance can also be passed to the CTRT(TCipher*, bool) constructor; it is deleted with the mode only if DestroyEngine is true.</description></item>
+/// <item><description>Clone() copies the keyed cipher and the counter position into a new instance, so a template mode can be used as a ModeContextPool prototype.</description></item>
+/// <item><description>Short inputs use a cache resident key-stream buffer allocated with the class, so a sequential transform does not allocate memory.</description></item>
+/// <item><description>Parallel processing and the random access Seek and positional Transform functions behave as they do in CTR.</description></item>
+/// </list>
+/// </remarks>
+template <typename TCipher>
+class CTRT final : public ICipherMode
+{
+private:
+
+	static const size_t BLOCK_SIZE = 16;
+
+	// number of counter blocks encrypted by the widest cipher transform
+#if defined(__AVX512__)
+	static constexpr size_t SIMD_BLOCKS = 16;
+#elif defined(__AVX2__)
+	static constexpr size_t SIMD_BLOCKS = 8;
+#elif defined(__AVX__)
+	static constexpr size_t SIMD_BLOCKS = 4;
+#else
+	static constexpr size_t SIMD_BLOCKS = 1;
+#endif
+	static constexpr size_t SIMD_SIZE = SIMD_BLOCKS * BLOCK_SIZE;
+
+	TCipher* m_blockCipher;
+	std::vector<byte> m_ctrNonce;
+	std::vector<byte> m_ctrVector;
+	bool m_destroyEngine;
+	bool m_isDestroyed;
+	bool m_isEncryption;
+	bool m_isInitialized;
+	std::vector<byte> m_ksBuffer;
+	ParallelOptions m_parallelProfile;
+
+public:
+
+	CTRT(const CTRT&) = delete;
+	CTRT& operator=(const CTRT&) = delete;
+	CTRT& operator=(CTRT&&) = delete;
+
+	//~~~Properties~~~//
+
+	/// <summary>
+	/// Get: Block size of internal cipher in bytes
+	/// </summary>
+	const size_t BlockSize() override
+	{
+		return BLOCK_SIZE;
+	}
+
+	/// <summary>
+	/// Get: The block ciphers formal type name
+	/// </summary>
+	const BlockCiphers CipherType() override
+	{
+		return m_blockCipher->Enumeral();
+	}
+
+	/// <summary>
+	/// Get: The underlying Block Cipher instance
+	/// </summary>
+	IBlockCipher* Engine() override
+	{
+		return m_blockCipher;
+	}
+
+	/// <summary>
+	/// Get: The cipher modes type name
+	/// </summary>
+	const CipherModes Enumeral() override
+	{
+		return CipherModes::CTR;
+	}
+
+	/// <summary>
+	/// Get: True if initialized for encryption, False for decryption
+	/// </summary>
+	const bool IsEncryption() override
+	{
+		return m_isEncryption;
+	}
+
+	/// <summary>
+	/// Get: The Block Cipher is ready to transform data
+	/// </summary>
+	const bool IsInitialized() override
+	{
+		return m_isInitialized;
+	}
+
+	/// <summary>
+	/// Get: Processor parallelization availability.
+	/// <para>Indicates whether parallel processing is available with this mode.
+	/// If parallel capable, input/output data arrays passed to the transform must be ParallelBlockSize in bytes to trigger parallelization.</para>
+	/// </summary>
+	const bool IsParallel() override
+	{
+		return m_parallelProfile.IsParallel();
+	}
+
+	/// <summary>
+	/// Get: Array of allowed cipher input key byte-sizes
+	/// </summary>
+	const std::vector<SymmetricKeySize> &LegalKeySizes() override
+	{
+		return m_blockCipher->LegalKeySizes();
+	}
+
+	/// <summary>
+	/// Get: The cipher modes class name
+	/// </summary>
+	const std::string Name() override
+	{
+		return std::string("CTR-") + m_blockCipher->Name();
+	}
+
+	/// <summary>
+	/// Get: The current counter (exposed for CMAC)
+	/// </summary>
+	const std::vector<byte> &Nonce()
+	{
+		return m_ctrVector;
+	}
+
+	/// <summary>
+	/// Get: Parallel block size; the byte-size of the input/output data arrays passed to a transform that trigger parallel processing.
+	/// <para>This value can be changed through the ParallelProfile class.<para>
+	/// </summary>
+	const size_t ParallelBlockSize() override
+	{
+		return m_parallelProfile.ParallelBlockSize();
+	}
+
+	/// <summary>
+	/// Get/Set: Parallel and SIMD capability flags and sizes
+	/// </summary>
+	ParallelOptions &ParallelProfile() override
+	{
+		return m_parallelProfile;
+	}
+
+	//~~~Constructor~~~//
+
+	/// <summary>
+	/// Initialize the Cipher Mode, constructing the block cipher; the cipher is owned by the mode
+	/// </summary>
+	///
+	/// <param name="CipherArgs">The block cipher constructor arguments, ex. the HKDF digest type and the number of rounds; can be empty</param>
+	template <typename... TArgs>
+	explicit CTRT(TArgs&&... CipherArgs)
+		:
+		m_blockCipher(new TCipher(std::forward<TArgs>(CipherArgs)...)),
+		m_ctrNonce(BLOCK_SIZE),
+		m_ctrVector(BLOCK_SIZE),
+		m_destroyEngine(true),
+		m_isDestroyed(false),
+		m_isEncryption(false),
+		m_isInitialized(false),
+		m_ksBuffer(SIMD_SIZE),
+		m_parallelProfile(BLOCK_SIZE, true, m_blockCipher->StateCacheSize(), true)
+	{
+	}
+
+	/// <summary>
+	/// Initialize the Cipher Mode using a block cipher instance
+	/// </summary>
+	///
+	/// <param name="Cipher">The uninitialized block cipher instance; can not be null</param>
+	/// <param name="DestroyEngine">Delete the cipher when the mode is destroyed</param>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if a null block cipher is used</exception>
+	CTRT(TCipher* Cipher, bool DestroyEngine)
+		:
+		m_blockCipher(Cipher != 0 ? Cipher : throw CryptoCipherModeException("CTRT:CTor", "The Cipher can not be null!")),
+		m_ctrNonce(BLOCK_SIZE),
+		m_ctrVector(BLOCK_SIZE),
+		m_destroyEngine(DestroyEngine),
+		m_isDestroyed(false),
+		m_isEncryption(false),
+		m_isInitialized(false),
+		m_ksBuffer(SIMD_SIZE),
+		m_parallelProfile(BLOCK_SIZE, true, m_blockCipher->StateCacheSize(), true)
+	{
+	}
+
+	/// <summary>
+	/// Finalize objects
+	/// </summary>
+	~CTRT() override
+	{
+		Destroy();
+	}
+
+	//~~~Public Functions~~~//
+
+	/// <summary>
+	/// Create an initialized copy of this cipher mode.
+	/// <para>The block cipher is copied with its Clone() function, so the key is not expanded again, and the copy owns its cipher instance.
+	/// The nonce and counter position, direction, and parallel profile are copied. The caller is responsible for destroying the returned mode.</para>
+	/// </summary>
+	///
+	/// <returns>A new, initialized CTRT instance</returns>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the cipher mode has not been initialized</exception>
+	CTRT* Clone() override
+	{
+		if (!m_isInitialized)
+			throw CryptoCipherModeException("CTRT:Clone", "The cipher mode has not been initialized!");
+
+		CTRT* mode = new CTRT(static_cast<TCipher*>(m_blockCipher->Clone()), true);
+		mode->m_ctrNonce = m_ctrNonce;
+		mode->m_ctrVector = m_ctrVector;
+		mode->m_isEncryption = m_isEncryption;
+		mode->m_isInitialized = true;
+		mode->m_parallelProfile = m_parallelProfile;
+
+		return mode;
+	}
+
+	/// <summary>
+	/// Decrypt a single block of bytes.
+	/// <para>Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	///
+	/// <param name="Input">The input array of encrypted bytes</param>
+	/// <param name="Output">The output array of decrypted bytes</param>
+	void DecryptBlock(const std::vector<byte> &Input, std::vector<byte> &Output) override
+	{
+		Encrypt128(Input, 0, Output, 0);
+	}
+
+	/// <summary>
+	/// Decrypt a block of bytes with offset parameters.
+	/// <para>Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	///
+	/// <param name="Input">The input array of encrypted bytes</param>
+	/// <param name="InOffset">Starting offset within the Input array</param>
+	/// <param name="Output">The output array of decrypted bytes</param>
+	/// <param name="OutOffset">Starting offset within the Output array</param>
+	void DecryptBlock(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset) override
+	{
+		Encrypt128(Input, InOffset, Output, OutOffset);
+	}
+
+	/// <summary>
+	/// Release all resources associated with the object; optional, called by the finalizer
+	/// </summary>
+	void Destroy() override
+	{
+		if (!m_isDestroyed)
+		{
+			m_isDestroyed = true;
+			m_isEncryption = false;
+			m_isInitialized = false;
+			m_parallelProfile.Reset();
+
+			if (m_destroyEngine)
+			{
+				m_destroyEngine = false;
+
+				if (m_blockCipher != 0)
+					delete m_blockCipher;
+			}
+
+			Utility::IntUtils::ClearVector(m_ctrNonce);
+			Utility::IntUtils::ClearVector(m_ctrVector);
+			Utility::IntUtils::ClearVector(m_ksBuffer);
+		}
+	}
+
+	/// <summary>
+	/// Encrypt a single block of bytes.
+	/// <para>Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	///
+	/// <param name="Input">The input array of plain text bytes</param>
+	/// <param name="Output">The output array of encrypted bytes</param>
+	void EncryptBlock(const std::vector<byte> &Input, std::vector<byte> &Output) override
+	{
+		Encrypt128(Input, 0, Output, 0);
+	}
+
+	/// <summary>
+	/// Encrypt a block of bytes using offset parameters.
+	/// <para>Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	///
+	/// <param name="Input">The input array of plain text bytes</param>
+	/// <param name="InOffset">Starting offset within the input array</param>
+	/// <param name="Output">The output array of encrypted bytes</param>
+	/// <param name="OutOffset">Starting offset within the output array</param>
+	void EncryptBlock(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset) override
+	{
+		Encrypt128(Input, InOffset, Output, OutOffset);
+	}
+
+	/// <summary>
+	/// Initialize the Cipher instance
+	/// </summary>
+	///
+	/// <param name="Encryption">True if cipher is used for encryption, False to decrypt</param>
+	/// <param name="KeyParams">SymmetricKey containing the encryption Key and Initialization Vector.
+	/// <para>If the key is empty and the cipher has been keyed, only the counter is reset to the new nonce; the key schedule is not expanded again.</para></param>
+	///
+	/// <exception cref="CryptoSymmetricCipherException">Thrown if an invalid key or nonce size, or parallel block size is used</exception>
+	void Initialize(bool Encryption, ISymmetricKey &KeyParams) override
+	{
+		if (KeyParams.Key().size() == 0)
+		{
+			// a nonce only key resets the counter, and keeps the current key schedule
+			if (!m_blockCipher->IsInitialized() || !m_blockCipher->IsEncryption())
+				throw CryptoSymmetricCipherException("CTRT:Initialize", "First initialization requires a key and nonce!");
+			if (KeyParams.Nonce().size() != BLOCK_SIZE)
+				throw CryptoSymmetricCipherException("CTRT:Initialize", "Invalid nonce size! The nonce must be one block in length.");
+		}
+		else if (!SymmetricKeySize::Contains(LegalKeySizes(), KeyParams.Key().size(), KeyParams.Nonce().size()))
+		{
+			throw CryptoSymmetricCipherException("CTRT:Initialize", "Invalid key or nonce size! Key and nonce must be one of the LegalKeySizes() members in length.");
+		}
+		if (m_parallelProfile.IsParallel() && m_parallelProfile.ParallelBlockSize() < m_parallelProfile.ParallelMinimumSize() || m_parallelProfile.ParallelBlockSize() > m_parallelProfile.ParallelMaximumSize())
+			throw CryptoSymmetricCipherException("CTRT:Initialize", "The parallel block size is out of bounds!");
+		if (m_parallelProfile.IsParallel() && m_parallelProfile.ParallelBlockSize() % m_parallelProfile.ParallelMinimumSize() != 0)
+			throw CryptoSymmetricCipherException("CTRT:Initialize", "The parallel block size must be evenly aligned to the ParallelMinimumSize!");
+
+		if (!m_parallelProfile.IsDefault())
+			m_parallelProfile.Calculate();
+
+		if (KeyParams.Key().size() != 0)
+			m_blockCipher->Initialize(true, KeyParams);
+
+		m_ctrNonce = KeyParams.Nonce();
+		m_ctrVector = KeyParams.Nonce();
+		m_isEncryption = Encryption;
+		m_isInitialized = true;
+	}
+
+	/// <summary>
+	/// Set the maximum number of threads allocated when using multi-threaded processing.
+	/// <para>Thread count must be an even number, and not exceed the number of processor cores.</para>
+	/// </summary>
+	///
+	/// <param name="Degree">The desired number of threads</param>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if an invalid degree setting is used</exception>
+	void ParallelMaxDegree(size_t Degree) override
+	{
+		if (Degree == 0)
+			throw CryptoCipherModeException("CTRT:ParallelMaxDegree", "Parallel degree can not be zero!");
+		if (Degree % 2 != 0)
+			throw CryptoCipherModeException("CTRT:ParallelMaxDegree", "Parallel degree must be an even number!");
+		if (Degree > m_parallelProfile.ProcessorCount())
+			throw CryptoCipherModeException("CTRT:ParallelMaxDegree", "Parallel degree can not exceed processor count!");
+
+		m_parallelProfile.SetMaxDegree(Degree);
+	}
+
+	/// <summary>
+	/// Set the key-stream position.
+	/// <para>The position must be a multiple of the block size, use the positional Transform(ulong, ...) function to access an unaligned offset.</para>
+	/// </summary>
+	///
+	/// <param name="Position">The block aligned byte offset within the key-stream</param>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the position is not block aligned</exception>
+	void Seek(ulong Position)
+	{
+		CexAssert(m_isInitialized, "The cipher mode has not been initialized!");
+
+		if (Position % BLOCK_SIZE != 0)
+			throw CryptoCipherModeException("CTRT:Seek", "The position must be aligned to the block size!");
+
+		Utility::IntUtils::BeIncrease8(m_ctrNonce, m_ctrVector, Position / BLOCK_SIZE);
+	}
+
+	/// <summary>
+	/// Transform a length of bytes beginning at a key-stream position.
+	/// <para>The counter is set to the block containing Position, and a partial leading block is aligned to the offset.</para>
+	/// </summary>
+	///
+	/// <param name="Position">The byte offset within the key-stream corresponding to the first input byte</param>
+	/// <param name="Input">The input array of bytes to transform</param>
+	/// <param name="InOffset">Starting offset within the input array</param>
+	/// <param name="Output">The output array of transformed bytes</param>
+	/// <param name="OutOffset">Starting offset within the output array</param>
+	/// <param name="Length">The number of bytes to transform</param>
+	void Transform(ulong Position, const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset, const size_t Length)
+	{
+		CexAssert(m_isInitialized, "The cipher mode has not been initialized!");
+		CexAssert(Utility::IntUtils::Min(Input.size() - InOffset, Output.size() - OutOffset) >= Length, "The data arrays are smaller than the the block-size!");
+
+		const size_t BLKOFF = static_cast<size_t>(Position % BLOCK_SIZE);
+		size_t prcLen = 0;
+
+		Seek(Position - BLKOFF);
+
+		if (BLKOFF != 0)
+		{
+			// unaligned position; xor the tail of the leading key-stream block
+			m_blockCipher->EncryptBlock(m_ctrVector, 0, m_ksBuffer, 0);
+			Utility::IntUtils::BeIncrement8(m_ctrVector);
+			prcLen = Utility::IntUtils::Min(BLOCK_SIZE - BLKOFF, Length);
+
+			for (size_t i = 0; i < prcLen; ++i)
+				Output[OutOffset + i] = Input[InOffset + i] ^ m_ksBuffer[BLKOFF + i];
+		}
+
+		if (prcLen != Length)
+			Transform(Input, InOffset + prcLen, Output, OutOffset + prcLen, Length - prcLen);
+	}
+
+	/// <summary>
+	/// Transform a length of bytes with offset parameters.
+	/// <para>If IsParallel() is set to true, and the length is at least ParallelBlockSize(), the transform is run in parallel processing mode.
+	/// Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	///
+	/// <param name="Input">The input array of bytes to transform</param>
+	/// <param name="InOffset">Starting offset within the input array</param>
+	/// <param name="Output">The output array of transformed bytes</param>
+	/// <param name="OutOffset">Starting offset within the output array</param>
+	/// <param name="Length">The number of bytes to transform</param>
+	void Transform(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset, const size_t Length) override
+	{
+		CexAssert(m_isInitialized, "The cipher mode has not been initialized!");
+		CexAssert(Utility::IntUtils::Min(Input.size() - InOffset, Output.size() - OutOffset) >= Length, "The data arrays are smaller than the the block-size!");
+
+		if (m_parallelProfile.IsParallel() && Length >= m_parallelProfile.ParallelBlockSize())
+			ProcessParallel(Input, InOffset, Output, OutOffset, Length);
+		else
+			Generate(Input, InOffset, Output, OutOffset, Length, m_ctrVector, m_ksBuffer);
+	}
+
+private:
+
+	void Encrypt128(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
+	{
+		CexAssert(m_isInitialized, "The cipher mode has not been initialized!");
+		CexAssert(Utility::IntUtils::Min(Input.size() - InOffset, Output.size() - OutOffset) >= BLOCK_SIZE, "The data arrays are smaller than the the block-size!");
+
+		m_blockCipher->EncryptBlock(m_ctrVector, 0, m_ksBuffer, 0);
+		Utility::IntUtils::BeIncrement8(m_ctrVector);
+		Utility::MemUtils::XorBlock(Input, InOffset, m_ksBuffer, 0, Output, OutOffset, BLOCK_SIZE);
+	}
+
+	void Generate(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset, const size_t Length, std::vector<byte> &Counter, std::vector<byte> &KeyStream)
+	{
+		size_t blkCtr = 0;
+
+		if (SIMD_BLOCKS > 1 && Length >= SIMD_SIZE)
+		{
+			const size_t PBKALN = Length - (Length % SIMD_SIZE);
+
+			// encrypt staggered counters in the cache resident buffer with the widest cipher transform
+			while (blkCtr != PBKALN)
+			{
+				Utility::CounterUtils::BeGenerate128(Counter, KeyStream, 0, SIMD_BLOCKS);
+				TransformW(KeyStream);
+				Utility::MemUtils::XorBlock(Input, InOffset + blkCtr, KeyStream, 0, Output, OutOffset + blkCtr, SIMD_SIZE);
+				blkCtr += SIMD_SIZE;
+			}
+		}
+
+		if (blkCtr != Length)
+		{
+			const size_t BLKALN = Length - (Length % BLOCK_SIZE);
+
+			while (blkCtr != BLKALN)
+			{
+				m_blockCipher->EncryptBlock(Counter, 0, KeyStream, 0);
+				Utility::MemUtils::XorBlock(Input, InOffset + blkCtr, KeyStream, 0, Output, OutOffset + blkCtr, BLOCK_SIZE);
+				Utility::IntUtils::BeIncrement8(Counter);
+				blkCtr += BLOCK_SIZE;
+			}
+
+			if (blkCtr != Length)
+			{
+				m_blockCipher->EncryptBlock(Counter, 0, KeyStream, 0);
+
+				for (size_t i = 0; i < Length - BLKALN; ++i)
+					Output[OutOffset + blkCtr + i] = Input[InOffset + blkCtr + i] ^ KeyStream[i];
+
+				Utility::IntUtils::BeIncrement8(Counter);
+			}
+		}
+	}
+
+	void ProcessParallel(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset, const size_t Length)
+	{
+		const size_t OUTSZE = Output.size() - OutOffset < Length ? Output.size() - OutOffset : Length;
+		const size_t CNKSZE = m_parallelProfile.ParallelBlockSize() / m_parallelProfile.ParallelMaxDegree();
+		const size_t CTRLEN = (CNKSZE / BLOCK_SIZE);
+		std::vector<byte> tmpCtr(m_ctrVector.size());
+
+		Utility::ParallelUtils::ParallelFor(0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset, &Output, OutOffset, &tmpCtr, CNKSZE, CTRLEN](size_t i)
+		{
+			// thread level counter and key-stream buffer
+			std::vector<byte> thdCtr(m_ctrVector.size());
+			std::vector<byte> thdBlk(SIMD_SIZE);
+			// offset counter by chunk size / block size
+			Utility::IntUtils::BeIncrease8(m_ctrVector, thdCtr, CTRLEN * i);
+			// generate the key-stream and xor with input at offsets
+			this->Generate(Input, InOffset + (i * CNKSZE), Output, OutOffset + (i * CNKSZE), CNKSZE, thdCtr, thdBlk);
+
+			// store last counter
+			if (i == m_parallelProfile.ParallelMaxDegree() - 1)
+				Utility::MemUtils::COPY128(thdCtr, 0, tmpCtr, 0);
+
+			// the buffer still holds the last key-stream blocks
+			Utility::IntUtils::ClearVector(thdBlk);
+		});
+
+		// copy last counter to class variable
+		Utility::MemUtils::COPY128(tmpCtr, 0, m_ctrVector, 0);
+
+		// last block processing
+		const size_t ALNSZE = CNKSZE * m_parallelProfile.ParallelMaxDegree();
+		if (ALNSZE < OUTSZE)
+			Generate(Input, InOffset + ALNSZE, Output, OutOffset + ALNSZE, OUTSZE - ALNSZE, m_ctrVector, m_ksBuffer);
+	}
+
+	void TransformW(std::vector<byte> &KeyStream)
+	{
+#if defined(__AVX512__)
+		m_blockCipher->Transform2048(KeyStream, 0, KeyStream, 0);
+#elif defined(__AVX2__)
+		m_blockCipher->Transform1024(KeyStream, 0, KeyStream, 0);
+#elif defined(__AVX__)
+		m_blockCipher->Transform512(KeyStream, 0, KeyStream, 0);
+#else
+		m_blockCipher->EncryptBlock(KeyStream, 0, KeyStream, 0);
+#endif
+	}
+};
+
+NAMESPACE_MODEEND
+#endif
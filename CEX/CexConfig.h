@@ -312,7 +312,7 @@ typedef unsigned char byte;
 #if defined(CEX_COMPILER_MSC)
 #	define CEX_OPTIMIZE_IGNORE __pragma(optimize("", off))
 #elif defined(CEX_COMPILER_GCC) || defined(CEX_COMPILER_MINGW)
-#	define CEX_OPTIMIZE_IGNORE _Pragma(TOSTRING(GCC optimize("O0")))
+#	define CEX_OPTIMIZE_IGNORE _Pragma(TOSTRING(GCC push_options)) _Pragma(TOSTRING(GCC optimize("O0")))
 #elif defined(CEX_COMPILER_CLANG)
 #	define CEX_OPTIMIZE_IGNORE __attribute__((optnone))
 #elif defined(CEX_COMPILER_INTEL)
@@ -364,6 +364,9 @@ inline static void CexAssert(bool Condition, const char* Message)
 #define CEX_PREFETCH_RHX_TABLES
 #define CEX_PREFETCH_THX_TABLES
 
+// enables the RingLWE Q7681N256 parameter set; it is far below the 128 bit security level of the other sets, and is for testing only
+//#define CEX_RLWE_TESTSETS
+
 // AVX512 Capabilities Check
 // TODO: future expansion (if you can test it, I'll add it)
 // links: 
@@ -396,6 +399,14 @@ inline static void CexAssert(bool Condition, const char* Message)
 #	endif
 #endif
 
+// VAES and VPCLMULQDQ (Ice Lake and newer); 512bit AES-NI in AHX and the 4 block carry-less multiply in GHASH
+#if defined(__AVX512__) && defined(__VAES__)
+#	define CEX_HAS_VAES
+#endif
+#if defined(__AVX512__) && defined(__VPCLMULQDQ__) && defined(__AVX512BW__)
+#	define CEX_HAS_VPCLMULQDQ
+#endif
+
 // EOF
 #endif
 
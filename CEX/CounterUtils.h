@@ -0,0 +1,169 @@
+// The GPL version 3 License (GPLv3)
+//
+// Copyright (c) 2017 vtdev.com
+// This file is part of the CEX Cryptographic library.
+//
+// This program is free software : you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef CEX_COUNTERUTILS_H
+#define CEX_COUNTERUTILS_H
+
+#include "CexDomain.h"
+#include "IntUtils.h"
+#if defined(__AVX__)
+#	include "Intrinsics.h"
+#endif
+
+NAMESPACE_UTILITY
+
+/// <summary>
+/// Block cipher counter generation functions class
+/// <para>Writes a run of sequential 128bit counter blocks directly to an output array, so that a block cipher can transform the counters in-place with its wide SIMD functions.</para>
+/// </summary>
+///
+/// <remarks>
+/// <para>The counter is loaded once, held in registers as a pair of 64bit words, and advanced with a vector add and carry propagation;
+/// with AVX2 two counters are produced per 256bit register, with AVX one counter per 128bit register, and the big endian byte order is restored with a single byte shuffle.
+/// The counter passed to a function is advanced by the number of blocks written, with the same 128bit wrap-around as the IntUtils BeIncrement8 and LeIncrementW functions.
+/// A sequential fallback is used when AVX is not available.</para>
+/// </remarks>
+class CounterUtils
+{
+private:
+
+	static const size_t BLOCK_SIZE = 16;
+
+#if defined(__AVX2__)
+
+	inline static __m256i Add256(const __m256i &Counter, const __m256i &Addend)
+	{
+		// unsigned overflow of the low word propagates a carry into the high word of the same 128bit lane
+		const __m256i SGNBIT = _mm256_set1_epi64x(static_cast<long long>(0x8000000000000000ULL));
+		__m256i sum = _mm256_add_epi64(Counter, Addend);
+		__m256i cry = _mm256_cmpgt_epi64(_mm256_xor_si256(Addend, SGNBIT), _mm256_xor_si256(sum, SGNBIT));
+
+		return _mm256_sub_epi64(sum, _mm256_slli_si256(cry, 8));
+	}
+
+#endif
+
+#if defined(__AVX__)
+
+	inline static __m128i Add128(const __m128i &Counter, const __m128i &Addend)
+	{
+		const __m128i SGNBIT = _mm_set1_epi64x(static_cast<long long>(0x8000000000000000ULL));
+		__m128i sum = _mm_add_epi64(Counter, Addend);
+		__m128i cry = _mm_cmpgt_epi64(_mm_xor_si128(Addend, SGNBIT), _mm_xor_si128(sum, SGNBIT));
+
+		return _mm_sub_epi64(sum, _mm_slli_si128(cry, 8));
+	}
+
+	template<bool BigEndian>
+	inline static __m128i Generate(__m128i Counter, std::vector<byte> &Output, size_t OutOffset, size_t Blocks)
+	{
+		const __m128i ONE128 = _mm_set_epi64x(0, 1);
+		const __m128i SWAP128 = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+		size_t blkCtr = 0;
+
+#	if defined(__AVX2__)
+		if (Blocks >= 2)
+		{
+			const __m256i SWAP256 = _mm256_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+			const __m256i TWO256 = _mm256_set_epi64x(0, 2, 0, 2);
+			const size_t PRSALN = Blocks - (Blocks % 2);
+			// low lane is the counter, high lane is counter + 1
+			__m256i ctrW = _mm256_inserti128_si256(_mm256_castsi128_si256(Counter), Add128(Counter, ONE128), 1);
+
+			while (blkCtr != PRSALN)
+			{
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(&Output[OutOffset + (blkCtr * BLOCK_SIZE)]), BigEndian ? _mm256_shuffle_epi8(ctrW, SWAP256) : ctrW);
+				ctrW = Add256(ctrW, TWO256);
+				blkCtr += 2;
+			}
+
+			Counter = _mm256_castsi256_si128(ctrW);
+		}
+#	endif
+
+		while (blkCtr != Blocks)
+		{
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(&Output[OutOffset + (blkCtr * BLOCK_SIZE)]), BigEndian ? _mm_shuffle_epi8(Counter, SWAP128) : Counter);
+			Counter = Add128(Counter, ONE128);
+			++blkCtr;
+		}
+
+		return BigEndian ? _mm_shuffle_epi8(Counter, SWAP128) : Counter;
+	}
+
+#endif
+
+public:
+
+	/// <summary>
+	/// Write a run of sequential 128bit Big Endian counters to an output array.
+	/// <para>The counter is treated as a 16 byte Big Endian integer, as used by the CTR mode and the BCG generator, and is advanced by the number of blocks written.</para>
+	/// </summary>
+	///
+	/// <param name="Counter">The 16 byte Big Endian counter; receives the next counter in the sequence</param>
+	/// <param name="Output">The array receiving the counter blocks</param>
+	/// <param name="OutOffset">The starting offset within the output array</param>
+	/// <param name="Blocks">The number of 16 byte counter blocks to write</param>
+	inline static void BeGenerate128(std::vector<byte> &Counter, std::vector<byte> &Output, size_t OutOffset, size_t Blocks)
+	{
+		CexAssert(Counter.size() == BLOCK_SIZE, "The counter must be 16 bytes in length");
+		CexAssert(Output.size() - OutOffset >= Blocks * BLOCK_SIZE, "The output array is too small");
+
+#if defined(__AVX__)
+		const __m128i SWAP128 = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+		__m128i ctr = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&Counter[0])), SWAP128);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&Counter[0]), Generate<true>(ctr, Output, OutOffset, Blocks));
+#else
+		for (size_t i = 0; i < Blocks; ++i)
+		{
+			std::memcpy(&Output[OutOffset + (i * BLOCK_SIZE)], &Counter[0], BLOCK_SIZE);
+			IntUtils::BeIncrement8(Counter);
+		}
+#endif
+	}
+
+	/// <summary>
+	/// Write a run of sequential 128bit Little Endian counters to an output array.
+	/// <para>The counter is a pair of 64bit words, low word first, as used by the ICM mode, and is advanced by the number of blocks written.</para>
+	/// </summary>
+	///
+	/// <param name="Counter">The two word Little Endian counter; receives the next counter in the sequence</param>
+	/// <param name="Output">The array receiving the counter blocks</param>
+	/// <param name="OutOffset">The starting offset within the output array</param>
+	/// <param name="Blocks">The number of 16 byte counter blocks to write</param>
+	inline static void LeGenerate128(std::vector<ulong> &Counter, std::vector<byte> &Output, size_t OutOffset, size_t Blocks)
+	{
+		CexAssert(Counter.size() == 2, "The counter must be two 64bit words");
+		CexAssert(Output.size() - OutOffset >= Blocks * BLOCK_SIZE, "The output array is too small");
+
+#if defined(__AVX__)
+		__m128i ctr = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Counter[0]));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&Counter[0]), Generate<false>(ctr, Output, OutOffset, Blocks));
+#else
+		for (size_t i = 0; i < Blocks; ++i)
+		{
+			IntUtils::Le64ToBytes(Counter[0], Output, OutOffset + (i * BLOCK_SIZE));
+			IntUtils::Le64ToBytes(Counter[1], Output, OutOffset + (i * BLOCK_SIZE) + sizeof(ulong));
+			IntUtils::LeIncrementW(Counter);
+		}
+#endif
+	}
+};
+
+NAMESPACE_UTILITYEND
+#endif
@@ -287,6 +287,11 @@ const bool CpuDetect::SSE42()
 	return HasFeature(CpuidFlags::CPUID_SSE42); 
 }
 
+const bool CpuDetect::VAES()
+{ 
+	return HasFeature(CpuidFlags::CPUID_VAES);
+}
+
 CpuDetect::CpuVendors CpuDetect::Vendor()
 { 
 	return m_cpuVendor; 
@@ -297,6 +302,11 @@ const size_t CpuDetect::VirtualCores()
 	return m_virtCores; 
 }
 
+const bool CpuDetect::VPCLMULQDQ()
+{ 
+	return HasFeature(CpuidFlags::CPUID_VPCLMULQDQ);
+}
+
 const bool CpuDetect::XOP() 
 { 
 	return HasFeature(CpuidFlags::CPUID_XOP);
@@ -524,8 +534,10 @@ void CpuDetect::PrintCpuStats()
 	std::cout << "SSE4A: " << BoolStr(SSE4A()) << std::endl;
 	std::cout << "SSE41: " << BoolStr(SSE41()) << std::endl;
 	std::cout << "SSE42: " << BoolStr(SSE42()) << std::endl;
+	std::cout << "VAES: " << BoolStr(VAES()) << std::endl;
 	std::cout << "Vendor: " << ((Vendor() == CpuVendors::UNKNOWN) ? "Unknown" : ((Vendor() == CpuVendors::AMD) ? "AMD" : "Intel")) << std::endl;
 	std::cout << "VirtualCores: " << VirtualCores() << std::endl;
+	std::cout << "VPCLMULQDQ: " << BoolStr(VPCLMULQDQ()) << std::endl;
 	std::cout << "XOP: " << BoolStr(XOP()) << std::endl;
 }
 
@@ -66,6 +66,8 @@ private:
 		CPUID_SMAP = 64 + 20, // ebx 20
 		CPUID_SHA = 64 + 29, // ebx 29
 		CPUID_PREFETCH = 64 + 32, // ebx 32 -index 2, 3
+		CPUID_VAES = 64 + 32 + 9, // ecx 9
+		CPUID_VPCLMULQDQ = 64 + 32 + 10, // ecx 10
 		// EAX=80000001
 		CPUID_ABM = 128 + 5, // ecx 5
 		CPUID_SSE4A = 128 + 6, // ecx 6
@@ -311,6 +313,11 @@ public:
 	/// </summary>
 	const bool SSE42();
 
+	/// <summary>
+	/// Returns true if the 256/512bit vector AES-NI (VAES) instructions are detected
+	/// </summary>
+	const bool VAES();
+
 	/// <summary>
 	/// Returns the cpu vendors enumeration value
 	/// </summary>
@@ -321,6 +328,11 @@ public:
 	/// </summary>
 	const size_t VirtualCores();
 
+	/// <summary>
+	/// Returns true if the 256/512bit vector carry-less multiply (VPCLMULQDQ) instructions are detected
+	/// </summary>
+	const bool VPCLMULQDQ();
+
 	/// <summary>
 	/// Returns true if the AMD eXtended Operations feature set is detected
 	/// </summary>
@@ -106,6 +106,7 @@ NAMESPACE_ROOT
 		NAMESPACE_BLOCK
 			class AHX {};
 			class IBlockCipher {};
+			class KeyScheduleCache {};
 			class RHX {};
 			class SHX {};
 			class THX {};
@@ -116,15 +117,19 @@ NAMESPACE_ROOT
 			*  @brief Symmetric Block Cipher Mode Namespace
 			*/
 			NAMESPACE_MODE
+				class AeadOneShot {};
 				class CBC {};
 				class CFB {};
 				class CTR {};
+				class CTRT {};
 				class EAX {};
 				class ECB {};
 				class GCM {};
+				class GCMT {};
 				class IAeadMode {};
 				class ICipherMode {};
 				class ICM {};
+				class ModeContextPool {};
 				class OCB {};
 				class OFB {};
 			NAMESPACE_MODEEND
@@ -292,8 +297,10 @@ NAMESPACE_ROOT
 	*/
 	NAMESPACE_IO
 		class BitConverter {};
+		class ByteView {};
 		class FileStream {};
 		class IByteStream {};
+		class MemoryMappedFile {};
 		class MemoryStream {};
 		class SecureStream {};
 		enum class SeekOrigin {};
@@ -328,6 +335,7 @@ NAMESPACE_ROOT
 		*  @brief Asymmetric Key containers and generator
 		*/
 		NAMESPACE_ASYMMETRICKEY
+			class AsymmetricKeyImage {};
 			class IAsymmetricKey {};
 			class IAsymmetricKeyPair {};
 			class MPKCKeyPair {};
@@ -405,6 +413,7 @@ NAMESPACE_ROOT
 	*  @brief Cryptographic Processing Namespace
 	*/
 	NAMESPACE_PROCESSING
+		class AeadStream {};
 		class CipherDescription {};
 		class CipherStream {};
 		class DigestStream {};
@@ -445,6 +454,7 @@ NAMESPACE_ROOT
 	*/
 	NAMESPACE_UTILITY 
 		class ArrayUtils {};
+		class CounterUtils {};
 		class IntUtils {};
 		class MemUtils {};
 		class ParallelUtils {};
@@ -1,4 +1,5 @@
 #include "EAX.h"
+#include "BlockCipherFromName.h"
 #include "CMAC.h"
 #include "IntUtils.h"
 #include "MemUtils.h"
@@ -98,7 +99,7 @@ const std::vector<byte> EAX::Tag()
 
 EAX::EAX(BlockCiphers CipherType)
 	:
-	m_cipherMode(CipherType),
+	m_cipherMode(Helper::BlockCipherFromName::GetInstance(CipherType)),
 	m_aadData(m_cipherMode.BlockSize()),
 	m_aadLoaded(false),
 	m_aadPreserve(false),
@@ -157,6 +158,33 @@ EAX::~EAX()
 
 //~~~Public Functions~~~//
 
+EAX* EAX::Clone()
+{
+	if (!m_isInitialized)
+		throw CryptoCipherModeException("EAX:Clone", "The cipher mode has not been initialized!");
+
+	EAX* mode = new EAX(m_cipherMode.Engine()->Clone());
+	mode->m_aadPreserve = m_aadPreserve;
+	mode->m_autoIncrement = m_autoIncrement;
+	mode->m_cipherMode.ParallelProfile() = m_cipherMode.ParallelProfile();
+	mode->m_destroyEngine = true;
+	mode->m_parallelProfile = m_parallelProfile;
+
+	// the mac state can not be copied, and eax keys the mac and counter on every initialization;
+	// the copy is initialized with the same key and nonce, at the start of a message
+	Key::Symmetric::SymmetricKey kp(m_cipherKey, m_eaxNonce);
+	mode->Initialize(m_isEncryption, kp);
+
+	if (m_aadPreserve && m_aadLoaded)
+	{
+		mode->m_aadData = m_aadData;
+		mode->m_aadLoaded = true;
+		mode->UpdateTag((byte)2, std::vector<byte>(0));
+	}
+
+	return mode;
+}
+
 void EAX::DecryptBlock(const std::vector<byte> &Input, std::vector<byte> &Output)
 {
 	Decrypt128(Input, 0, Output, 0);
@@ -191,11 +219,13 @@ void EAX::Destroy()
 		if (m_destroyEngine)
 		{
 			m_destroyEngine = false;
+			// the counter mode and mac share the engine, neither owns it
+			IBlockCipher* engine = m_cipherMode.Engine();
+			m_cipherMode.Destroy();
+			m_macGenerator.Destroy();
 
-			if (m_cipherMode.IsInitialized())
-				m_cipherMode.Destroy();
-			if (m_macGenerator.IsInitialized())
-				m_macGenerator.Destroy();
+			if (engine != 0)
+				delete engine;
 		}
 	}
 }
@@ -272,6 +272,18 @@ public:
 
 	//~~~Public Functions~~~//
 
+	/// <summary>
+	/// Create an initialized copy of this cipher mode.
+	/// <para>The block cipher is copied with its Clone() function, retaining its HKDF settings and distribution code; the copy owns its cipher instance.
+	/// EAX keys the CMAC and counter on every initialization, so the copy is initialized with the same key and nonce, at the start of a message; preserved associated data and the parallel profile are copied.
+	/// The caller is responsible for destroying the returned mode.</para>
+	/// </summary>
+	///
+	/// <returns>A new, initialized EAX instance</returns>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the cipher mode has not been initialized</exception>
+	EAX* Clone() override;
+
 	/// <summary>
 	/// Decrypt a single block of bytes.
 	/// <para>Decrypts one block of bytes beginning at a zero index.
@@ -27,7 +27,7 @@
 #ifndef CEX_ECB_H
 #define CEX_ECB_H
 
-#include "ICipherMode.h"
+#include "ECBT.h"
 
 NAMESPACE_MODE
 
@@ -89,6 +89,7 @@ NAMESPACE_MODE
 /// <item><description>ParallelBlockSize() is calculated automatically based on the processor(s) L1 data cache size, this property can be user defined, and must be evenly divisible by ParallelMinimumSize().</description></item>
 /// <item><description>The ParallelBlockSize() can be changed through the ParallelProfile() property</description></item>
 /// <item><description>Parallel block calculation ex. <c>ParallelBlockSize = N - (N % .ParallelMinimumSize);</c></description></item>
+/// <item><description>The mode is implemented by the ECBT&lt;TCipher&gt; template in ECBT.h; this class wraps ECBT&lt;IBlockCipher&gt;. When the cipher type is known at compile time, ECBT with a final cipher class, ex. ECBT&lt;AHX&gt;, produces the same output without the virtual calls in the block loops.</description></item>
 /// </list>
 /// 
 /// <description>Guiding Publications:</description>
@@ -101,17 +102,9 @@ class ECB final : public ICipherMode
 {
 private:
 
-	static const size_t BLOCK_SIZE = 16;
-	static const std::string CLASS_NAME;
-
-	IBlockCipher* m_blockCipher;
 	BlockCiphers m_cipherType;
-	bool m_destroyEngine;
+	std::unique_ptr<ECBT<IBlockCipher>> m_ecbMode;
 	bool m_isDestroyed;
-	bool m_isEncryption;
-	bool m_isInitialized;
-	bool m_isLoaded;
-	ParallelOptions m_parallelProfile;
 
 public:
 
@@ -206,6 +199,17 @@ public:
 
 	//~~~Public Functions~~~//
 
+	/// <summary>
+	/// Create an initialized copy of this cipher mode.
+	/// <para>The block cipher is copied with its Clone() function, so the key is not expanded again, and the copy owns its cipher instance.
+	/// The direction and parallel profile are copied. The caller is responsible for destroying the returned mode.</para>
+	/// </summary>
+	///
+	/// <returns>A new, initialized ECB instance</returns>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the cipher mode has not been initialized</exception>
+	ECB* Clone() override;
+
 	/// <summary>
 	/// Decrypt a single block of bytes.
 	/// <para>Decrypts one block of bytes beginning at a zero index.
@@ -295,11 +299,7 @@ public:
 
 private:
 
-	void Encrypt128(const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset);
-	void Generate(const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset, size_t BlockCount);
-	void ProcessParallel(const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset, size_t Length);
-	void ProcessSequential(const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset, size_t Length);
-	void Scope();
+	ECB(ECBT<IBlockCipher>* Mode, BlockCiphers CipherType);
 };
 
 NAMESPACE_MODEEND
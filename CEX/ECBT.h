@@ -0,0 +1,473 @@
+// The GPL version 3 License (GPLv3)
+//
+// Copyright (c) 2017 vtdev.com
+// This file is part of the CEX Cryptographic library.
+//
+// This program is free software : you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+//
+// Implementation Details:
+// A cipher specialized template of the Electronic CodeBook Mode (ECB); the ECB class is this template instantiated with the IBlockCipher interface.
+
+#ifndef CEX_ECBT_H
+#define CEX_ECBT_H
+
+#include "ICipherMode.h"
+#include "IntUtils.h"
+#include "ParallelUtils.h"
+
+NAMESPACE_MODE
+
+/// <summary>
+/// An Electronic CodeBook Mode template, specialized at compile time for a block cipher type
+/// <para>ECB is an Insecure Mode; used only for testing purposes.</para>
+/// </summary>
+///
+/// <example>
+/// <description>Encrypting with a specialized AES-NI ECB mode:</description>
+/// <code>
+/// ECBT&lt;AHX&gt; cipher;
+/// // initialize for encryption
+/// cipher.Initialize(true, SymmetricKey(Key));
+/// // encrypt the message
+/// cipher.Transform(Input, 0, Output, 0, Input.size());
+/// </code>
+/// </example>
+///
+/// <remarks>
+/// <para>ECBT is the single implementation of the ECB mode; the ECB class wraps ECBT&lt;IBlockCipher&gt;, so the two produce identical output.
+/// The cipher is held as a pointer to the template type, so with a final cipher class such as AHX the block loops call the cipher directly, and a wide transform defined in the ciphers header is inlined.
+/// The SIMD width of the wide transform (4, 8, or 16 blocks) is a compile time constant.
+/// The class implements ICipherMode, and can be used anywhere the interface is accepted.</para>
+///
+/// <list type="bullet">
+/// <item><description>The template parameter is a block cipher class, ex. ECBT&lt;AHX&gt; or ECBT&lt;SHX&gt;; the constructor arguments are forwarded to the ciphers constructor, and the mode owns the cipher it creates.</description></item>
+/// <item><description>A cipher instance can also be passed to the ECBT(TCipher*, bool) constructor; it is deleted with the mode only if DestroyEngine is true.</description></item>
+/// <item><description>Clone() copies the keyed cipher into a new instance, so a template mode can be used as a ModeContextPool prototype.</description></item>
+/// <item><description>Encryption and decryption can both be processed in parallel.</description></item>
+/// </list>
+/// </remarks>
+template <typename TCipher>
+class ECBT final : public ICipherMode
+{
+private:
+
+	static const size_t BLOCK_SIZE = 16;
+
+	// number of blocks processed by the widest cipher transform
+#if defined(__AVX512__)
+	static constexpr size_t SIMD_BLOCKS = 16;
+#elif defined(__AVX2__)
+	static constexpr size_t SIMD_BLOCKS = 8;
+#elif defined(__AVX__)
+	static constexpr size_t SIMD_BLOCKS = 4;
+#else
+	static constexpr size_t SIMD_BLOCKS = 1;
+#endif
+	static constexpr size_t SIMD_SIZE = SIMD_BLOCKS * BLOCK_SIZE;
+
+	TCipher* m_blockCipher;
+	bool m_destroyEngine;
+	bool m_isDestroyed;
+	bool m_isEncryption;
+	bool m_isInitialized;
+	ParallelOptions m_parallelProfile;
+
+public:
+
+	ECBT(const ECBT&) = delete;
+	ECBT& operator=(const ECBT&) = delete;
+	ECBT& operator=(ECBT&&) = delete;
+
+	//~~~Properties~~~//
+
+	/// <summary>
+	/// Get: Block size of internal cipher in bytes
+	/// </summary>
+	const size_t BlockSize() override
+	{
+		return BLOCK_SIZE;
+	}
+
+	/// <summary>
+	/// Get: The block ciphers formal type name
+	/// </summary>
+	const BlockCiphers CipherType() override
+	{
+		return m_blockCipher->Enumeral();
+	}
+
+	/// <summary>
+	/// Get: The underlying Block Cipher instance
+	/// </summary>
+	IBlockCipher* Engine() override
+	{
+		return m_blockCipher;
+	}
+
+	/// <summary>
+	/// Get: The cipher modes type name
+	/// </summary>
+	const CipherModes Enumeral() override
+	{
+		return CipherModes::ECB;
+	}
+
+	/// <summary>
+	/// Get: True if initialized for encryption, False for decryption
+	/// </summary>
+	const bool IsEncryption() override
+	{
+		return m_isEncryption;
+	}
+
+	/// <summary>
+	/// Get: The Block Cipher is ready to transform data
+	/// </summary>
+	const bool IsInitialized() override
+	{
+		return m_isInitialized;
+	}
+
+	/// <summary>
+	/// Get: Processor parallelization availability.
+	/// <para>Indicates whether parallel processing is available with this mode.
+	/// If parallel capable, input/output data arrays passed to the transform must be ParallelBlockSize in bytes to trigger parallelization.</para>
+	/// </summary>
+	const bool IsParallel() override
+	{
+		return m_parallelProfile.IsParallel();
+	}
+
+	/// <summary>
+	/// Get: Array of allowed cipher input key byte-sizes
+	/// </summary>
+	const std::vector<SymmetricKeySize> &LegalKeySizes() override
+	{
+		return m_blockCipher->LegalKeySizes();
+	}
+
+	/// <summary>
+	/// Get: The cipher modes class name
+	/// </summary>
+	const std::string Name() override
+	{
+		return std::string("ECB-") + m_blockCipher->Name();
+	}
+
+	/// <summary>
+	/// Get: Parallel block size; the byte-size of the input/output data arrays passed to a transform that trigger parallel processing.
+	/// <para>This value can be changed through the ParallelProfile class.<para>
+	/// </summary>
+	const size_t ParallelBlockSize() override
+	{
+		return m_parallelProfile.ParallelBlockSize();
+	}
+
+	/// <summary>
+	/// Get/Set: Parallel and SIMD capability flags and sizes
+	/// </summary>
+	ParallelOptions &ParallelProfile() override
+	{
+		return m_parallelProfile;
+	}
+
+	//~~~Constructor~~~//
+
+	/// <summary>
+	/// Initialize the Cipher Mode, constructing the block cipher; the cipher is owned by the mode
+	/// </summary>
+	///
+	/// <param name="CipherArgs">The block cipher constructor arguments, ex. the HKDF digest type and the number of rounds; can be empty</param>
+	template <typename... TArgs>
+	explicit ECBT(TArgs&&... CipherArgs)
+		:
+		m_blockCipher(new TCipher(std::forward<TArgs>(CipherArgs)...)),
+		m_destroyEngine(true),
+		m_isDestroyed(false),
+		m_isEncryption(false),
+		m_isInitialized(false),
+		m_parallelProfile(BLOCK_SIZE, true, m_blockCipher->StateCacheSize(), true)
+	{
+	}
+
+	/// <summary>
+	/// Initialize the Cipher Mode using a block cipher instance
+	/// </summary>
+	///
+	/// <param name="Cipher">The uninitialized block cipher instance; can not be null</param>
+	/// <param name="DestroyEngine">Delete the cipher when the mode is destroyed</param>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if a null block cipher is used</exception>
+	ECBT(TCipher* Cipher, bool DestroyEngine)
+		:
+		m_blockCipher(Cipher != 0 ? Cipher : throw CryptoCipherModeException("ECBT:CTor", "The Cipher can not be null!")),
+		m_destroyEngine(DestroyEngine),
+		m_isDestroyed(false),
+		m_isEncryption(false),
+		m_isInitialized(false),
+		m_parallelProfile(BLOCK_SIZE, true, m_blockCipher->StateCacheSize(), true)
+	{
+	}
+
+	/// <summary>
+	/// Finalize objects
+	/// </summary>
+	~ECBT() override
+	{
+		Destroy();
+	}
+
+	//~~~Public Functions~~~//
+
+	/// <summary>
+	/// Create an initialized copy of this cipher mode.
+	/// <para>The block cipher is copied with its Clone() function, so the key is not expanded again, and the copy owns its cipher instance.
+	/// The direction and parallel profile are copied. The caller is responsible for destroying the returned mode.</para>
+	/// </summary>
+	///
+	/// <returns>A new, initialized ECBT instance</returns>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the cipher mode has not been initialized</exception>
+	ECBT* Clone() override
+	{
+		if (!m_isInitialized)
+			throw CryptoCipherModeException("ECBT:Clone", "The cipher mode has not been initialized!");
+
+		ECBT* mode = new ECBT(static_cast<TCipher*>(m_blockCipher->Clone()), true);
+		mode->m_isEncryption = m_isEncryption;
+		mode->m_isInitialized = true;
+		mode->m_parallelProfile = m_parallelProfile;
+
+		return mode;
+	}
+
+	/// <summary>
+	/// Decrypt a single block of bytes.
+	/// <para>Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	///
+	/// <param name="Input">The input array of encrypted bytes</param>
+	/// <param name="Output">The output array of decrypted bytes</param>
+	void DecryptBlock(const std::vector<byte> &Input, std::vector<byte> &Output) override
+	{
+		Encrypt128(Input, 0, Output, 0);
+	}
+
+	/// <summary>
+	/// Decrypt a block of bytes with offset parameters.
+	/// <para>Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	///
+	/// <param name="Input">The input array of encrypted bytes</param>
+	/// <param name="InOffset">Starting offset within the Input array</param>
+	/// <param name="Output">The output array of decrypted bytes</param>
+	/// <param name="OutOffset">Starting offset within the Output array</param>
+	void DecryptBlock(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset) override
+	{
+		Encrypt128(Input, InOffset, Output, OutOffset);
+	}
+
+	/// <summary>
+	/// Release all resources associated with the object; optional, called by the finalizer
+	/// </summary>
+	void Destroy() override
+	{
+		if (!m_isDestroyed)
+		{
+			m_isDestroyed = true;
+			m_isEncryption = false;
+			m_isInitialized = false;
+			m_parallelProfile.Reset();
+
+			if (m_destroyEngine)
+			{
+				m_destroyEngine = false;
+
+				if (m_blockCipher != 0)
+					delete m_blockCipher;
+			}
+		}
+	}
+
+	/// <summary>
+	/// Encrypt a single block of bytes.
+	/// <para>Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	///
+	/// <param name="Input">The input array of plain text bytes</param>
+	/// <param name="Output">The output array of encrypted bytes</param>
+	void EncryptBlock(const std::vector<byte> &Input, std::vector<byte> &Output) override
+	{
+		Encrypt128(Input, 0, Output, 0);
+	}
+
+	/// <summary>
+	/// Encrypt a block of bytes using offset parameters.
+	/// <para>Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	///
+	/// <param name="Input">The input array of plain text bytes</param>
+	/// <param name="InOffset">Starting offset within the input array</param>
+	/// <param name="Output">The output array of encrypted bytes</param>
+	/// <param name="OutOffset">Starting offset within the output array</param>
+	void EncryptBlock(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset) override
+	{
+		Encrypt128(Input, InOffset, Output, OutOffset);
+	}
+
+	/// <summary>
+	/// Initialize the Cipher instance
+	/// </summary>
+	///
+	/// <param name="Encryption">True if cipher is used for encryption, False to decrypt</param>
+	/// <param name="KeyParams">SymmetricKey containing the encryption Key</param>
+	///
+	/// <exception cref="CryptoSymmetricCipherException">Thrown if an invalid key size, or parallel block size is used</exception>
+	void Initialize(bool Encryption, ISymmetricKey &KeyParams) override
+	{
+		if (!SymmetricKeySize::Contains(LegalKeySizes(), KeyParams.Key().size()))
+			throw CryptoSymmetricCipherException("ECBT:Initialize", "Invalid key size! Key must be one of the LegalKeySizes() in length.");
+		if (m_parallelProfile.IsParallel() && m_parallelProfile.ParallelBlockSize() < m_parallelProfile.ParallelMinimumSize() || m_parallelProfile.ParallelBlockSize() > m_parallelProfile.ParallelMaximumSize())
+			throw CryptoSymmetricCipherException("ECBT:Initialize", "The parallel block size is out of bounds!");
+		if (m_parallelProfile.IsParallel() && m_parallelProfile.ParallelBlockSize() % m_parallelProfile.ParallelMinimumSize() != 0)
+			throw CryptoSymmetricCipherException("ECBT:Initialize", "The parallel block size must be evenly aligned to the ParallelMinimumSize!");
+
+		if (!m_parallelProfile.IsDefault())
+			m_parallelProfile.Calculate();
+
+		m_blockCipher->Initialize(Encryption, KeyParams);
+		m_isEncryption = Encryption;
+		m_isInitialized = true;
+	}
+
+	/// <summary>
+	/// Set the maximum number of threads allocated when using multi-threaded processing.
+	/// <para>Thread count must be an even number, and not exceed the number of processor cores.</para>
+	/// </summary>
+	///
+	/// <param name="Degree">The desired number of threads</param>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if an invalid degree setting is used</exception>
+	void ParallelMaxDegree(size_t Degree) override
+	{
+		if (Degree == 0)
+			throw CryptoCipherModeException("ECBT:ParallelMaxDegree", "Parallel degree can not be zero!");
+		if (Degree % 2 != 0)
+			throw CryptoCipherModeException("ECBT:ParallelMaxDegree", "Parallel degree must be an even number!");
+		if (Degree > m_parallelProfile.ProcessorCount())
+			throw CryptoCipherModeException("ECBT:ParallelMaxDegree", "Parallel degree can not exceed processor count!");
+
+		m_parallelProfile.SetMaxDegree(Degree);
+	}
+
+	/// <summary>
+	/// Transform a length of bytes with offset parameters.
+	/// <para>If IsParallel() is set to true, and the length is at least ParallelBlockSize(), the transform is run in parallel processing mode.
+	/// The length must be a multiple of the block size. Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	///
+	/// <param name="Input">The input array of bytes to transform</param>
+	/// <param name="InOffset">Starting offset within the input array</param>
+	/// <param name="Output">The output array of transformed bytes</param>
+	/// <param name="OutOffset">Starting offset within the output array</param>
+	/// <param name="Length">The number of bytes to transform</param>
+	void Transform(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset, const size_t Length) override
+	{
+		CexAssert(m_isInitialized, "The cipher mode has not been initialized");
+		CexAssert(Utility::IntUtils::Min(Input.size() - InOffset, Output.size() - OutOffset) >= Length, "The data arrays are smaller than the length");
+		CexAssert(Length % BLOCK_SIZE == 0, "The length must be evenly divisible by the block size");
+
+		const size_t PRLBLK = m_parallelProfile.ParallelBlockSize();
+
+		if (m_parallelProfile.IsParallel() && Length >= PRLBLK)
+		{
+			const size_t BLKCNT = Length / PRLBLK;
+
+			for (size_t i = 0; i < BLKCNT; ++i)
+				ProcessParallel(Input, InOffset + (i * PRLBLK), Output, OutOffset + (i * PRLBLK));
+
+			const size_t PRCLEN = PRLBLK * BLKCNT;
+			const size_t RMDLEN = Length - PRCLEN;
+
+			if (RMDLEN != 0)
+				Generate(Input, InOffset + PRCLEN, Output, OutOffset + PRCLEN, RMDLEN / BLOCK_SIZE);
+		}
+		else
+		{
+			Generate(Input, InOffset, Output, OutOffset, Length / BLOCK_SIZE);
+		}
+	}
+
+private:
+
+	void Encrypt128(const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset)
+	{
+		CexAssert(m_isInitialized, "The cipher mode has not been initialized!");
+		CexAssert(Utility::IntUtils::Min(Input.size() - InOffset, Output.size() - OutOffset) >= BLOCK_SIZE, "The data arrays are smaller than the the block-size!");
+
+		m_blockCipher->EncryptBlock(Input, InOffset, Output, OutOffset);
+	}
+
+	void Generate(const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset, size_t BlockCount)
+	{
+		size_t blkCtr = BlockCount;
+
+		if (SIMD_BLOCKS > 1)
+		{
+			while (blkCtr >= SIMD_BLOCKS)
+			{
+				TransformW(Input, InOffset, Output, OutOffset);
+				InOffset += SIMD_SIZE;
+				OutOffset += SIMD_SIZE;
+				blkCtr -= SIMD_BLOCKS;
+			}
+		}
+
+		while (blkCtr != 0)
+		{
+			m_blockCipher->Transform(Input, InOffset, Output, OutOffset);
+			InOffset += BLOCK_SIZE;
+			OutOffset += BLOCK_SIZE;
+			--blkCtr;
+		}
+	}
+
+	void ProcessParallel(const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset)
+	{
+		const size_t SEGSZE = m_parallelProfile.ParallelBlockSize() / m_parallelProfile.ParallelMaxDegree();
+		const size_t BLKCNT = (SEGSZE / BLOCK_SIZE);
+
+		Utility::ParallelUtils::ParallelFor(0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset, &Output, OutOffset, SEGSZE, BLKCNT](size_t i)
+		{
+			this->Generate(Input, InOffset + i * SEGSZE, Output, OutOffset + i * SEGSZE, BLKCNT);
+		});
+	}
+
+	void TransformW(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
+	{
+#if defined(__AVX512__)
+		m_blockCipher->Transform2048(Input, InOffset, Output, OutOffset);
+#elif defined(__AVX2__)
+		m_blockCipher->Transform1024(Input, InOffset, Output, OutOffset);
+#elif defined(__AVX__)
+		m_blockCipher->Transform512(Input, InOffset, Output, OutOffset);
+#else
+		m_blockCipher->Transform(Input, InOffset, Output, OutOffset);
+#endif
+	}
+};
+
+NAMESPACE_MODEEND
+#endif
@@ -4,7 +4,12 @@
 #include "IntUtils.h"
 #include "McElieceUtils.h"
 #include "MemUtils.h"
+#include "ParallelUtils.h"
 #include "SymmetricKey.h"
+#if defined(__AVX2__)
+#	include "UInt256.h"
+#	include "ULong256.h"
+#endif
 
 NAMESPACE_MCELIECE
 
@@ -334,113 +339,142 @@ const ulong FFTM12T62::ButterflyConsts[63][12] =
 
 //~~~Public Functions~~~//
 
-bool FFTM12T62::Decrypt(std::vector<byte> &E, const std::vector<byte> &PrivateKey, const std::vector<byte> &S)
+bool FFTM12T62::Decrypt(std::vector<byte> &E, const IO::ByteView &PrivateKey, const std::vector<byte> &S)
 {
-	size_t i;
-	ulong diff;
-	ulong t;
-
 	std::array<ulong, CND_SIZE / 8> cond;
+	std::array<std::array<ulong, M>, 64> inverse;
 
 	IntUtils::BlockToLe(PrivateKey, IRR_SIZE, cond, 0, CND_SIZE);
-	std::vector<ulong> recv(64);
-	PreProcess(recv, S);
-	McElieceUtils::BenesCompact(recv, cond, 1);
+	ScalingInverses(inverse, PrivateKey);
 
-	// scaling
+	return Decode(E, cond, inverse, S);
+}
+
+std::vector<bool> FFTM12T62::Decrypt(std::vector<std::vector<byte>> &E, const IO::ByteView &PrivateKey, const std::vector<std::vector<byte>> &S, bool Parallel)
+{
+	CexAssert(S.size() == E.size(), "The syndrome and error arrays must be the same size");
+
+	std::array<ulong, CND_SIZE / 8> cond;
 	std::array<std::array<ulong, M>, 64> inverse;
-	std::array<std::array<ulong, M>, 64> scaled;
-	Scaling(scaled, inverse, PrivateKey, recv);
 
-	// transposed FFT
-	std::array<std::array<ulong, M>, 2> sPriv;
-	TransposedFFT::Transform(sPriv, scaled);
-	SyndromeAdjust(sPriv);
+	// the scaling inverses depend only on the key, so they are computed once for the whole batch
+	IntUtils::BlockToLe(PrivateKey, IRR_SIZE, cond, 0, CND_SIZE);
+	ScalingInverses(inverse, PrivateKey);
 
-	// Berlekamp Massey
-	std::array<ulong, M> locator;
-	std::memset(&locator[0], byte(0), locator.size() * sizeof(ulong));
-	BerlekampMassey(locator, sPriv);
+#if defined(__AVX2__)
+	const size_t GRPCNT = (S.size() + DEC_LANES - 1) / DEC_LANES;
+#else
+	const size_t GRPCNT = S.size();
+#endif
 
-	// additive FFT
-	std::array<std::array<ulong, M>, 64> eval;
-	AdditiveFFT::Transform(eval, locator);
+	std::vector<bool> valid(S.size());
 
-	std::array<ulong, 64> error;
-	for (i = 0; i < 64; i++)
+	if (GRPCNT == 0)
 	{
-		error[i] = McElieceUtils::Or(eval[i], M);
-		error[i] = ~error[i];
+		return valid;
 	}
 
-	// re-encrypt
-	ScalingInverse(scaled, inverse, error);
-	std::array<std::array<ulong, M>, 2> sPrivCmp;
-	TransposedFFT::Transform(sPrivCmp, scaled);
-	SyndromeAdjust(sPrivCmp);
-
-	diff = 0;
-	diff |= sPriv[0][0] ^ sPrivCmp[0][0];
-	diff |= sPriv[0][1] ^ sPrivCmp[0][1];
-	diff |= sPriv[0][2] ^ sPrivCmp[0][2];
-	diff |= sPriv[0][3] ^ sPrivCmp[0][3];
-	diff |= sPriv[0][4] ^ sPrivCmp[0][4];
-	diff |= sPriv[0][5] ^ sPrivCmp[0][5];
-	diff |= sPriv[0][6] ^ sPrivCmp[0][6];
-	diff |= sPriv[0][7] ^ sPrivCmp[0][7];
-	diff |= sPriv[0][8] ^ sPrivCmp[0][8];
-	diff |= sPriv[0][9] ^ sPrivCmp[0][9];
-	diff |= sPriv[0][10] ^ sPrivCmp[0][10];
-	diff |= sPriv[0][11] ^ sPrivCmp[0][11];
-	diff |= sPriv[1][0] ^ sPrivCmp[1][0];
-	diff |= sPriv[1][1] ^ sPrivCmp[1][1];
-	diff |= sPriv[1][2] ^ sPrivCmp[1][2];
-	diff |= sPriv[1][3] ^ sPrivCmp[1][3];
-	diff |= sPriv[1][4] ^ sPrivCmp[1][4];
-	diff |= sPriv[1][5] ^ sPrivCmp[1][5];
-	diff |= sPriv[1][6] ^ sPrivCmp[1][6];
-	diff |= sPriv[1][7] ^ sPrivCmp[1][7];
-	diff |= sPriv[1][8] ^ sPrivCmp[1][8];
-	diff |= sPriv[1][9] ^ sPrivCmp[1][9];
-	diff |= sPriv[1][10] ^ sPrivCmp[1][10];
-	diff |= sPriv[1][11] ^ sPrivCmp[1][11];
-	diff |= diff >> 32;
-	diff |= diff >> 16;
-	diff |= diff >> 8;
-	t = diff & 0xFF;
+	// the threads write separate bytes; a bool vector is packed, and can not be written concurrently
+	const size_t THDCNT = !Parallel ? 1 : (Utility::ParallelUtils::ProcessorCount() < GRPCNT) ? Utility::ParallelUtils::ProcessorCount() : GRPCNT;
+	std::vector<byte> ret(S.size());
+	size_t i;
 
-	// compact and store
-	McElieceUtils::BenesCompact(error, cond, 0);
-	IntUtils::LeToBlock(error, 0, E, 0, error.size() * sizeof(ulong));
+	Utility::ParallelUtils::ParallelFor(0, THDCNT, [&E, &S, &cond, &inverse, &ret, GRPCNT, THDCNT](size_t i)
+	{
+		for (size_t j = i; j < GRPCNT; j += THDCNT)
+		{
+#if defined(__AVX2__)
+			DecodeLanes(E, ret, cond, inverse, S, j * DEC_LANES);
+#else
+			ret[j] = static_cast<byte>(Decode(E[j], cond, inverse, S[j]));
+#endif
+		}
+	});
 
-	t |= McElieceUtils::Weight(error) ^ T;
-	t -= 1;
-	t >>= 63;
+	for (i = 0; i < S.size(); ++i)
+	{
+		valid[i] = (ret[i] != 0);
+	}
 
-	return (t - 1 == 0) ? true : false;
+	return valid;
 }
 
-void FFTM12T62::Encrypt(std::vector<byte> &S, std::vector<byte> &E, const std::vector<byte> &PublicKey, std::unique_ptr<IPrng> &Random)
+void FFTM12T62::Encrypt(std::vector<byte> &S, std::vector<byte> &E, const IO::ByteView &PublicKey, std::unique_ptr<IPrng> &Random, bool Parallel)
 {
 	GenE(E, Random);
-	Syndrome(S, PublicKey, E);
+	Syndrome(S, PublicKey, E, Parallel);
+}
+
+void FFTM12T62::Encrypt(std::vector<std::vector<byte>> &S, std::vector<std::vector<byte>> &E, const IO::ByteView &PublicKey, std::unique_ptr<IPrng> &Random, bool Parallel)
+{
+	CexAssert(S.size() == E.size(), "The syndrome and error arrays must be the same size");
+
+	// the error vectors are drawn serially, then the syndromes are computed in one pass over the key
+	for (size_t i = 0; i < E.size(); ++i)
+	{
+		GenE(E[i], Random);
+	}
+
+	Syndrome(S, PublicKey, E, Parallel);
 }
 
-bool FFTM12T62::Generate(std::vector<byte> &PublicKey, std::vector<byte> &PrivateKey, std::unique_ptr<IPrng> &Random)
+bool FFTM12T62::Generate(std::vector<byte> &PublicKey, std::vector<byte> &PrivateKey, std::unique_ptr<IPrng> &Random, bool Parallel)
 {
+	// roughly one private key in four produces a systematic public matrix, so attempts run speculatively, one per core; a serial search makes one attempt at a time
+	const size_t THDCNT = Parallel ? Utility::ParallelUtils::ProcessorCount() : 1;
+	std::vector<std::vector<ulong>> arena(THDCNT, std::vector<ulong>(PKN_ARENA));
+	std::vector<std::vector<ulong>> cond(THDCNT, std::vector<ulong>(CND_SIZE / 8));
+	std::vector<std::vector<ushort>> f(THDCNT, std::vector<ushort>(T));
+	std::vector<std::vector<byte>> priKey(THDCNT, std::vector<byte>(PRIKEY_SIZE));
+	std::vector<std::vector<byte>> pubKey(THDCNT, std::vector<byte>(PUBKEY_SIZE));
+	std::vector<int> ret(THDCNT);
 	size_t ctr;
+	size_t j;
+	bool found;
+
+	found = false;
 
-	for (ctr = 0; ctr < GEN_MAXR; ++ctr)
+	for (ctr = 0; ctr < GEN_MAXR && !found; ctr += THDCNT)
 	{
-		SkGen(PrivateKey, Random);
+		// the random is drawn serially, so the attempts consume the generator in order
+		for (j = 0; j < THDCNT; ++j)
+		{
+			Random->Fill(f[j], 0, f[j].size());
+			Random->Fill(cond[j], 0, cond[j].size());
+		}
 
-		if (PkGen(PublicKey, PrivateKey) == 0) 
+		Utility::ParallelUtils::ParallelFor(0, THDCNT, [&arena, &cond, &f, &priKey, &pubKey, &ret](size_t i)
 		{
-			break;
+			ret[i] = SkGen(priKey[i], f[i], cond[i]);
+
+			if (ret[i] == 0)
+			{
+				ret[i] = PkGen(pubKey[i], priKey[i], arena[i]);
+			}
+		});
+
+		// the lowest successful attempt wins; this is the key a serial search would have returned
+		for (j = 0; j < THDCNT; ++j)
+		{
+			if (ret[j] == 0)
+			{
+				PublicKey.swap(pubKey[j]);
+				PrivateKey.swap(priKey[j]);
+				found = true;
+				break;
+			}
 		}
 	}
 
-	return (ctr < GEN_MAXR) ? true : false;
+	for (j = 0; j < THDCNT; ++j)
+	{
+		IntUtils::ClearVector(arena[j]);
+		IntUtils::ClearVector(cond[j]);
+		IntUtils::ClearVector(f[j]);
+		IntUtils::ClearVector(priKey[j]);
+	}
+
+	return found;
 }
 
 //~~~Private Functions~~~//
@@ -565,6 +599,224 @@ void FFTM12T62::BerlekampMassey(std::array<ulong, M> &Output, std::array<std::ar
 	Output[11] >>= 64 - (T + 1);
 }
 
+bool FFTM12T62::Decode(std::vector<byte> &E, const std::array<ulong, CND_SIZE / 8> &Condition, const std::array<std::array<ulong, M>, 64> &Inverse, const std::vector<byte> &S)
+{
+	size_t i;
+	ulong diff;
+	ulong t;
+
+	std::vector<ulong> recv(64);
+	PreProcess(recv, S);
+	McElieceUtils::BenesCompact(recv, Condition, 1);
+
+	// scaling
+	std::array<std::array<ulong, M>, 64> scaled;
+	Scaling(scaled, Inverse, recv);
+
+	// transposed FFT
+	std::array<std::array<ulong, M>, 2> sPriv;
+	TransposedFFT::Transform(sPriv, scaled);
+	SyndromeAdjust(sPriv);
+
+	// Berlekamp Massey
+	std::array<ulong, M> locator;
+	std::memset(&locator[0], byte(0), locator.size() * sizeof(ulong));
+	BerlekampMassey(locator, sPriv);
+
+	// additive FFT
+	std::array<std::array<ulong, M>, 64> eval;
+	AdditiveFFT::Transform(eval, locator);
+
+	std::array<ulong, 64> error;
+	for (i = 0; i < 64; i++)
+	{
+		error[i] = McElieceUtils::Or(eval[i], M);
+		error[i] = ~error[i];
+	}
+
+	// re-encrypt
+	Scaling(scaled, Inverse, error);
+	std::array<std::array<ulong, M>, 2> sPrivCmp;
+	TransposedFFT::Transform(sPrivCmp, scaled);
+	SyndromeAdjust(sPrivCmp);
+
+	diff = 0;
+	diff |= sPriv[0][0] ^ sPrivCmp[0][0];
+	diff |= sPriv[0][1] ^ sPrivCmp[0][1];
+	diff |= sPriv[0][2] ^ sPrivCmp[0][2];
+	diff |= sPriv[0][3] ^ sPrivCmp[0][3];
+	diff |= sPriv[0][4] ^ sPrivCmp[0][4];
+	diff |= sPriv[0][5] ^ sPrivCmp[0][5];
+	diff |= sPriv[0][6] ^ sPrivCmp[0][6];
+	diff |= sPriv[0][7] ^ sPrivCmp[0][7];
+	diff |= sPriv[0][8] ^ sPrivCmp[0][8];
+	diff |= sPriv[0][9] ^ sPrivCmp[0][9];
+	diff |= sPriv[0][10] ^ sPrivCmp[0][10];
+	diff |= sPriv[0][11] ^ sPrivCmp[0][11];
+	diff |= sPriv[1][0] ^ sPrivCmp[1][0];
+	diff |= sPriv[1][1] ^ sPrivCmp[1][1];
+	diff |= sPriv[1][2] ^ sPrivCmp[1][2];
+	diff |= sPriv[1][3] ^ sPrivCmp[1][3];
+	diff |= sPriv[1][4] ^ sPrivCmp[1][4];
+	diff |= sPriv[1][5] ^ sPrivCmp[1][5];
+	diff |= sPriv[1][6] ^ sPrivCmp[1][6];
+	diff |= sPriv[1][7] ^ sPrivCmp[1][7];
+	diff |= sPriv[1][8] ^ sPrivCmp[1][8];
+	diff |= sPriv[1][9] ^ sPrivCmp[1][9];
+	diff |= sPriv[1][10] ^ sPrivCmp[1][10];
+	diff |= sPriv[1][11] ^ sPrivCmp[1][11];
+	diff |= diff >> 32;
+	diff |= diff >> 16;
+	diff |= diff >> 8;
+	t = diff & 0xFF;
+
+	// compact and store
+	McElieceUtils::BenesCompact(error, Condition, 0);
+	IntUtils::LeToBlock(error, 0, E, 0, error.size() * sizeof(ulong));
+
+	t |= McElieceUtils::Weight(error) ^ T;
+	t -= 1;
+	t >>= 63;
+
+	return (t - 1 == 0) ? true : false;
+}
+
+#if defined(__AVX2__)
+void FFTM12T62::DecodeLanes(std::vector<std::vector<byte>> &E, std::vector<byte> &Valid, const std::array<ulong, CND_SIZE / 8> &Condition, const std::array<std::array<ulong, M>, 64> &Inverse, const std::vector<std::vector<byte>> &S, size_t Offset)
+{
+	// each 64-bit lane of a register carries one ciphertext through the field arithmetic;
+	// the support permutation and the Berlekamp-Massey iteration are data dependent and run per lane
+	const size_t LNECNT = ((S.size() - Offset) < DEC_LANES) ? (S.size() - Offset) : DEC_LANES;
+	std::array<std::vector<ulong>, DEC_LANES> recv;
+	std::array<std::array<ulong, 64>, DEC_LANES> error;
+	std::array<std::array<std::array<ulong, M>, 2>, DEC_LANES> sLane;
+	std::array<std::array<ulong, M>, DEC_LANES> locator;
+	std::array<ulong, DEC_LANES> lane;
+	std::array<Numeric::ULong256, 64> recvV;
+	std::array<Numeric::ULong256, 64> errorV;
+	std::array<Numeric::ULong256, M> locatorV;
+	std::array<std::array<Numeric::ULong256, M>, 64> scaled;
+	std::array<std::array<Numeric::ULong256, M>, 64> eval;
+	std::array<std::array<Numeric::ULong256, M>, 2> sPriv;
+	std::array<std::array<Numeric::ULong256, M>, 2> sPrivCmp;
+	Numeric::ULong256 diffV;
+	size_t b;
+	size_t i;
+	size_t j;
+	ulong diff;
+	ulong t;
+
+	for (j = 0; j < DEC_LANES; ++j)
+	{
+		recv[j].resize(64, 0);
+
+		if (j < LNECNT)
+		{
+			PreProcess(recv[j], S[Offset + j]);
+			McElieceUtils::BenesCompact(recv[j], Condition, 1);
+		}
+	}
+
+	for (i = 0; i < 64; ++i)
+	{
+		for (j = 0; j < DEC_LANES; ++j)
+		{
+			lane[j] = recv[j][i];
+		}
+
+		recvV[i].Load(lane, 0);
+	}
+
+	// scaling and transposed FFT
+	Scaling(scaled, Inverse, recvV);
+	TransposedFFT::Transform(sPriv, scaled);
+	SyndromeAdjust(sPriv);
+
+	// Berlekamp Massey
+	for (i = 0; i < 2; ++i)
+	{
+		for (b = 0; b < M; ++b)
+		{
+			sPriv[i][b].Store(lane, 0);
+
+			for (j = 0; j < DEC_LANES; ++j)
+			{
+				sLane[j][i][b] = lane[j];
+			}
+		}
+	}
+
+	for (j = 0; j < DEC_LANES; ++j)
+	{
+		locator[j].fill(0);
+		BerlekampMassey(locator[j], sLane[j]);
+	}
+
+	for (b = 0; b < M; ++b)
+	{
+		for (j = 0; j < DEC_LANES; ++j)
+		{
+			lane[j] = locator[j][b];
+		}
+
+		locatorV[b].Load(lane, 0);
+	}
+
+	// additive FFT
+	AdditiveFFT::Transform(eval, locatorV);
+
+	for (i = 0; i < 64; ++i)
+	{
+		errorV[i] = ~McElieceUtils::Or(eval[i], M);
+	}
+
+	// re-encrypt
+	Scaling(scaled, Inverse, errorV);
+	TransposedFFT::Transform(sPrivCmp, scaled);
+	SyndromeAdjust(sPrivCmp);
+
+	diffV = Numeric::ULong256::ZERO();
+
+	for (i = 0; i < 2; ++i)
+	{
+		for (b = 0; b < M; ++b)
+		{
+			diffV |= sPriv[i][b] ^ sPrivCmp[i][b];
+		}
+	}
+
+	for (i = 0; i < 64; ++i)
+	{
+		errorV[i].Store(lane, 0);
+
+		for (j = 0; j < DEC_LANES; ++j)
+		{
+			error[j][i] = lane[j];
+		}
+	}
+
+	diffV.Store(lane, 0);
+
+	// compact and store, the status of each lane is written to its own cipher-text
+	for (j = 0; j < LNECNT; ++j)
+	{
+		diff = lane[j];
+		diff |= diff >> 32;
+		diff |= diff >> 16;
+		diff |= diff >> 8;
+		t = diff & 0xFF;
+
+		McElieceUtils::BenesCompact(error[j], Condition, 0);
+		IntUtils::LeToBlock(error[j], 0, E[Offset + j], 0, error[j].size() * sizeof(ulong));
+
+		t |= McElieceUtils::Weight(error[j]) ^ T;
+		t -= 1;
+		t >>= 63;
+		Valid[Offset + j] = static_cast<byte>(t - 1 == 0);
+	}
+}
+#endif
+
 void FFTM12T62::PreProcess(std::vector<ulong> &Received, const std::vector<byte> &S)
 {
 	IntUtils::BlockToLe(S, 0, Received, 0, SECRET_SIZE - 5);
@@ -581,72 +833,57 @@ void FFTM12T62::PreProcess(std::vector<ulong> &Received, const std::vector<byte>
 	Received[SECRET_SIZE / 8] |= S[((SECRET_SIZE / 8) * 8)];
 }
 
-void FFTM12T62::Scaling(std::array<std::array<ulong, M>, 64> &Output, std::array<std::array<ulong, M>, 64> &Inverse, const std::vector<byte> &PrivateKey, std::vector<ulong> &Received)
+template <typename V, typename Array>
+void FFTM12T62::Scaling(std::array<std::array<V, M>, 64> &Output, const std::array<std::array<ulong, M>, 64> &Inverse, const Array &Received)
+{
+	for (size_t i = 0; i < 64; i++)
+	{
+		Output[i][0] = static_cast<V>(Inverse[i][0]) & Received[i];
+		Output[i][1] = static_cast<V>(Inverse[i][1]) & Received[i];
+		Output[i][2] = static_cast<V>(Inverse[i][2]) & Received[i];
+		Output[i][3] = static_cast<V>(Inverse[i][3]) & Received[i];
+		Output[i][4] = static_cast<V>(Inverse[i][4]) & Received[i];
+		Output[i][5] = static_cast<V>(Inverse[i][5]) & Received[i];
+		Output[i][6] = static_cast<V>(Inverse[i][6]) & Received[i];
+		Output[i][7] = static_cast<V>(Inverse[i][7]) & Received[i];
+		Output[i][8] = static_cast<V>(Inverse[i][8]) & Received[i];
+		Output[i][9] = static_cast<V>(Inverse[i][9]) & Received[i];
+		Output[i][10] = static_cast<V>(Inverse[i][10]) & Received[i];
+		Output[i][11] = static_cast<V>(Inverse[i][11]) & Received[i];
+	}
+}
+
+void FFTM12T62::ScalingInverses(std::array<std::array<ulong, M>, 64> &Output, const IO::ByteView &PrivateKey)
 {
 	int i;
 	std::array<ulong, M> skInt;
 	std::array<std::array<ulong, M>, 64> eval;
 	std::array<ulong, M> tmp;
 
-	// computing inverses
 	MemUtils::Copy(PrivateKey, 0, skInt, 0, M * sizeof(ulong));
 	AdditiveFFT::Transform(eval, skInt);
 	Square(eval[0], eval[0]);
-	McElieceUtils::Copy(eval[0], Inverse[0]);
+	McElieceUtils::Copy(eval[0], Output[0]);
 
 	for (i = 1; i < 64; i++)
 	{
 		Square(eval[i], eval[i]);
-		McElieceUtils::Multiply(Inverse[i], Inverse[i - 1], eval[i]);
+		McElieceUtils::Multiply(Output[i], Output[i - 1], eval[i]);
 	}
 
-	Invert(tmp, Inverse[63]);
+	Invert(tmp, Output[63]);
 
 	for (i = 62; i >= 0; i--)
 	{
-		McElieceUtils::Multiply(Inverse[i + 1], tmp, Inverse[i]);
+		McElieceUtils::Multiply(Output[i + 1], tmp, Output[i]);
 		McElieceUtils::Multiply(tmp, tmp, eval[i + 1]);
 	}
 
-	McElieceUtils::Copy(tmp, Inverse[0]);
-
-	for (i = 0; i < 64; i++)
-	{
-		Output[i][0] = Inverse[i][0] & Received[i];
-		Output[i][1] = Inverse[i][1] & Received[i];
-		Output[i][2] = Inverse[i][2] & Received[i];
-		Output[i][3] = Inverse[i][3] & Received[i];
-		Output[i][4] = Inverse[i][4] & Received[i];
-		Output[i][5] = Inverse[i][5] & Received[i];
-		Output[i][6] = Inverse[i][6] & Received[i];
-		Output[i][7] = Inverse[i][7] & Received[i];
-		Output[i][8] = Inverse[i][8] & Received[i];
-		Output[i][9] = Inverse[i][9] & Received[i];
-		Output[i][10] = Inverse[i][10] & Received[i];
-		Output[i][11] = Inverse[i][11] & Received[i];
-	}
+	McElieceUtils::Copy(tmp, Output[0]);
 }
 
-void FFTM12T62::ScalingInverse(std::array<std::array<ulong, M>, 64> &Output, std::array<std::array<ulong, M>, 64> &Inverse, std::array<ulong, 64> &Received)
-{
-	for (size_t i = 0; i < 64; i++)
-	{
-		Output[i][0] = Inverse[i][0] & Received[i];
-		Output[i][1] = Inverse[i][1] & Received[i];
-		Output[i][2] = Inverse[i][2] & Received[i];
-		Output[i][3] = Inverse[i][3] & Received[i];
-		Output[i][4] = Inverse[i][4] & Received[i];
-		Output[i][5] = Inverse[i][5] & Received[i];
-		Output[i][6] = Inverse[i][6] & Received[i];
-		Output[i][7] = Inverse[i][7] & Received[i];
-		Output[i][8] = Inverse[i][8] & Received[i];
-		Output[i][9] = Inverse[i][9] & Received[i];
-		Output[i][10] = Inverse[i][10] & Received[i];
-		Output[i][11] = Inverse[i][11] & Received[i];
-	}
-}
-
-void FFTM12T62::SyndromeAdjust(std::array<std::array<ulong, M>, 2> &Output)
+template <typename V>
+void FFTM12T62::SyndromeAdjust(std::array<std::array<V, M>, 2> &Output)
 {
 	const size_t SASHFT = (128 - T * 2);
 
@@ -734,50 +971,127 @@ void FFTM12T62::GenE(std::vector<byte> &E, std::unique_ptr<IPrng> &Random)
 	IntUtils::LeToBlock(eInt, 0, E, 0, eInt.size() * sizeof(ulong));
 }
 
-void FFTM12T62::Syndrome(std::vector<byte> &S, const std::vector<byte> &PublicKey, const std::vector<byte> &E)
+byte FFTM12T62::RowParity(const IO::ByteView &PublicKey, size_t Row, const std::vector<byte> &E)
 {
-	const size_t ARRSZE = ((PKN_COLS + 63) / 64); // TODO: intrinsics
 	const size_t COLSZE = PKN_COLS / 8;
 
-	std::array<ulong, ARRSZE> eInt;
-	MemUtils::Copy(E, SECRET_SIZE, eInt, 0, COLSZE);
-	std::array<ulong, ARRSZE> rowInt;
 	std::array<ulong, 8> tmp;
+	size_t j;
 	int t;
 	byte b;
 
-	for (size_t i = 0; i < PKN_ROWS; i += 8)
+	for (t = 0; t < 8; t++)
 	{
-		for (t = 0; t < 8; t++) 
+		const size_t ROWOFF = (Row + t) * COLSZE;
+		j = 0;
+
+		// the row is read in place from the key; only whole blocks are loaded, so neither array is over-read
+#if defined(__AVX512__)
+
+		__m512i acc = _mm512_setzero_si512();
+
+		for (; j + 64 <= COLSZE; j += 64)
 		{
-			rowInt[ARRSZE - 1] = 0;
-			MemUtils::Copy(PublicKey, ((i + t) * COLSZE), rowInt, 0, COLSZE);
-			tmp[t] = 0;
+			acc = _mm512_xor_si512(acc, _mm512_and_si512(_mm512_loadu_si512(reinterpret_cast<const void*>(&PublicKey[ROWOFF + j])), _mm512_loadu_si512(reinterpret_cast<const void*>(&E[SECRET_SIZE + j]))));
+		}
 
-			for (size_t j = 0; j < ARRSZE; j++)
-			{
-				tmp[t] ^= eInt[j] & rowInt[j];
-			}
+		__m256i acc256 = _mm256_xor_si256(_mm512_castsi512_si256(acc), _mm512_extracti64x4_epi64(acc, 1));
+
+		if (j + 32 <= COLSZE)
+		{
+			acc256 = _mm256_xor_si256(acc256, _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&PublicKey[ROWOFF + j])), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&E[SECRET_SIZE + j]))));
+			j += 32;
 		}
 
-		b = 0;
+		const __m128i ACC128 = _mm_xor_si128(_mm256_castsi256_si128(acc256), _mm256_extracti128_si256(acc256, 1));
+		tmp[t] = static_cast<ulong>(_mm_cvtsi128_si64(ACC128)) ^ static_cast<ulong>(_mm_extract_epi64(ACC128, 1));
+
+#elif defined(__AVX2__)
+
+		Numeric::UInt256 acc(0);
+		std::array<ulong, 4> sum;
+
+		for (; j + 32 <= COLSZE; j += 32)
+		{
+			acc ^= Numeric::UInt256(PublicKey, ROWOFF + j) & Numeric::UInt256(E, SECRET_SIZE + j);
+		}
+
+		acc.Store(sum, 0);
+		tmp[t] = sum[0] ^ sum[1] ^ sum[2] ^ sum[3];
+
+#else
 
-		for (t = 7; t >= 0; t--)
+		tmp[t] = 0;
+
+#endif
+
+		for (; j + 8 <= COLSZE; j += 8)
 		{
-			tmp[t] ^= (tmp[t] >> 32);
-			tmp[t] ^= (tmp[t] >> 16);
-			tmp[t] ^= (tmp[t] >> 8);
-			tmp[t] ^= (tmp[t] >> 4);
+			tmp[t] ^= IntUtils::LeBytesTo64(PublicKey, ROWOFF + j) & IntUtils::LeBytesTo64(E, SECRET_SIZE + j);
 		}
 
-		for (t = 7; t >= 0; t--)
+		// the parity does not depend on the bit position, so the trailing bytes fold into the low byte
+		for (; j < COLSZE; j++)
 		{
-			b <<= 1;
-			b |= (0x6996 >> (tmp[t] & 0xF)) & 1;
+			tmp[t] ^= PublicKey[ROWOFF + j] & E[SECRET_SIZE + j];
 		}
+	}
+
+	b = 0;
 
-		S[i / 8] = E[i / 8] ^ b;
+	for (t = 7; t >= 0; t--)
+	{
+		tmp[t] ^= (tmp[t] >> 32);
+		tmp[t] ^= (tmp[t] >> 16);
+		tmp[t] ^= (tmp[t] >> 8);
+		tmp[t] ^= (tmp[t] >> 4);
 	}
+
+	for (t = 7; t >= 0; t--)
+	{
+		b <<= 1;
+		b |= (0x6996 >> (tmp[t] & 0xF)) & 1;
+	}
+
+	return b;
+}
+
+void FFTM12T62::Syndrome(std::vector<byte> &S, const IO::ByteView &PublicKey, const std::vector<byte> &E, bool Parallel)
+{
+	// the key rows are divided between the cores, each computing a contiguous run of syndrome bytes
+	const size_t GRPCNT = PKN_ROWS / 8;
+	const size_t THDCNT = !Parallel ? 1 : (Utility::ParallelUtils::ProcessorCount() < GRPCNT) ? Utility::ParallelUtils::ProcessorCount() : GRPCNT;
+
+	Utility::ParallelUtils::ParallelFor(0, THDCNT, [&S, &PublicKey, &E, GRPCNT, THDCNT](size_t i)
+	{
+		const size_t GRPEND = (GRPCNT * (i + 1)) / THDCNT;
+
+		for (size_t j = (GRPCNT * i) / THDCNT; j < GRPEND; j++)
+		{
+			S[j] = E[j] ^ RowParity(PublicKey, j * 8, E);
+		}
+	});
+}
+
+void FFTM12T62::Syndrome(std::vector<std::vector<byte>> &S, const IO::ByteView &PublicKey, const std::vector<std::vector<byte>> &E, bool Parallel)
+{
+	// each core streams its slice of the key once, computing those syndrome bytes for every message in the batch
+	const size_t CNT = S.size();
+	const size_t GRPCNT = PKN_ROWS / 8;
+	const size_t THDCNT = !Parallel ? 1 : (Utility::ParallelUtils::ProcessorCount() < GRPCNT) ? Utility::ParallelUtils::ProcessorCount() : GRPCNT;
+
+	Utility::ParallelUtils::ParallelFor(0, THDCNT, [&S, &PublicKey, &E, CNT, GRPCNT, THDCNT](size_t i)
+	{
+		const size_t GRPEND = (GRPCNT * (i + 1)) / THDCNT;
+
+		for (size_t j = (GRPCNT * i) / THDCNT; j < GRPEND; j++)
+		{
+			for (size_t k = 0; k < CNT; k++)
+			{
+				S[k][j] = E[k][j] ^ RowParity(PublicKey, j * 8, E[k]);
+			}
+		}
+	});
 }
 
 //~~~KeyGen~~~//
@@ -859,25 +1173,20 @@ int FFTM12T62::IrrGen(std::array<ushort, T + 1> &Output, std::vector<ushort> &F)
 	return 0;
 }
 
-void FFTM12T62::SkGen(std::vector<byte> &PrivateKey, std::unique_ptr<Prng::IPrng> &Random)
+int FFTM12T62::SkGen(std::vector<byte> &PrivateKey, std::vector<ushort> &F, const std::vector<ulong> &Condition)
 {
 	size_t i;
 	std::array<ushort, T + 1> irr;
-	std::vector<ushort> f(T);
 
-	while (1)
+	for (i = 0; i < T; i++) 
 	{
-		Random->Fill(f, 0, f.size());
-
-		for (i = 0; i < T; i++) 
-		{
-			f[i] &= ((ushort)1 << M) - 1;
-		}
+		F[i] &= ((ushort)1 << M) - 1;
+	}
 
-		if (IrrGen(irr, f) == 0)
-		{
-			break;
-		}
+	// return if the polynomial is not irreducible
+	if (IrrGen(irr, F) != 0)
+	{
+		return -1;
 	}
 
 	std::array<ulong, M> skInt;
@@ -893,18 +1202,18 @@ void FFTM12T62::SkGen(std::vector<byte> &PrivateKey, std::unique_ptr<Prng::IPrng
 		IntUtils::Le64ToBytes(skInt[i], PrivateKey, i * 8);
 	}
 
-	std::vector<ulong> cond(CND_SIZE / 8);
-	Random->Fill(cond, 0, cond.size());
-
 	for (i = 0; i < CND_SIZE / 8; i++)
 	{
-		IntUtils::Le64ToBytes(cond[i], PrivateKey, IRR_SIZE + i * 8);
+		IntUtils::Le64ToBytes(Condition[i], PrivateKey, IRR_SIZE + i * 8);
 	}
+
+	return 0;
 }
 
-int FFTM12T62::PkGen(std::vector<byte> &PublicKey, const std::vector<byte> &PrivateKey)
+int FFTM12T62::PkGen(std::vector<byte> &PublicKey, const std::vector<byte> &PrivateKey, std::vector<ulong> &Arena)
 {
-	size_t c;
+	CexAssert(Arena.size() >= PKN_ARENA, "The arena is too small");
+
 	size_t i;
 	size_t j;
 	size_t k;
@@ -941,14 +1250,16 @@ int FFTM12T62::PkGen(std::vector<byte> &PublicKey, const std::vector<byte> &Priv
 	}
 
 	McElieceUtils::Copy(tmp, inverse[0]);
-	std::array<std::array<ulong, 64>, PKN_ROWS> mat;
+
+	// the matrix rows start on a cache line within the arena
+	ulong* mat = Arena.data() + (((PKN_ALIGN - (reinterpret_cast<size_t>(Arena.data()) % PKN_ALIGN)) % PKN_ALIGN) / sizeof(ulong));
 
 	// fill matrix 
 	for (j = 0; j < 64; j++)
 	{
 		for (k = 0; k < M; k++) 
 		{
-			mat[k][j] = inverse[j][k];
+			mat[(k * 64) + j] = inverse[j][k];
 		}
 	}
 
@@ -1284,7 +1595,7 @@ int FFTM12T62::PkGen(std::vector<byte> &PublicKey, const std::vector<byte> &Priv
 
 			for (k = 0; k < M; k++)
 			{
-				mat[i * M + k][j] = inverse[j][k];
+				mat[((i * M + k) * 64) + j] = inverse[j][k];
 			}
 		}
 	}
@@ -1298,10 +1609,13 @@ int FFTM12T62::PkGen(std::vector<byte> &PublicKey, const std::vector<byte> &Priv
 
 	for (i = 0; i < PKN_ROWS; i++)
 	{
-		McElieceUtils::BenesCompact(mat[i], cond, 0);
+		ulong* matRow = mat + (i * 64);
+		McElieceUtils::BenesCompact(matRow, cond, 0);
 	}
 
 	// gaussian elimination 
+	std::array<ulong, PKN_ROWS> masks;
+
 	for (i = 0; i < M; i++)
 	{
 		for (j = 0; j < 64; j++)
@@ -1313,39 +1627,36 @@ int FFTM12T62::PkGen(std::vector<byte> &PublicKey, const std::vector<byte> &Priv
 				break;
 			}
 
+			// the pivot word is scanned serially; the selected rows are then added across the full row width
+			u = mat[(row * 64) + i];
+
 			for (k = row + 1; k < PKN_ROWS; k++)
 			{
-				mask = mat[row][i] ^ mat[k][i];
+				mask = u ^ mat[(k * 64) + i];
 				mask >>= j;
 				mask &= 1;
 				mask = ~mask + 1;
-
-				for (c = 0; c < 64; c++)
-				{
-					mat[row][c] ^= mat[k][c] & mask;
-				}
+				u ^= mat[(k * 64) + i] & mask;
+				masks[k] = mask;
 			}
 
 			// return if not invertible
-			if (((mat[row][i] >> j) & 1) == 0) 
+			if (((u >> j) & 1) == 0) 
 			{
 				return -1;
 			}
 
+			RowAccumulate(mat, row, masks);
+
 			for (k = 0; k < PKN_ROWS; k++)
 			{
-				if (k != row)
-				{
-					mask = mat[k][i] >> j;
-					mask &= 1;
-					mask = ~mask + 1;
-
-					for (c = 0; c < 64; c++)
-					{
-						mat[k][c] ^= mat[row][c] & mask;
-					}
-				}
+				mask = mat[(k * 64) + i] >> j;
+				mask &= 1;
+				masks[k] = ~mask + 1;
 			}
+
+			masks[row] = 0;
+			RowEliminate(mat, row, masks);
 		}
 	}
 
@@ -1355,7 +1666,7 @@ int FFTM12T62::PkGen(std::vector<byte> &PublicKey, const std::vector<byte> &Priv
 
 	for (i = 0; i < PKN_ROWS; i++)
 	{
-		u = mat[i][(PKN_ROWS + 63) / 64 - 1];
+		u = mat[(i * 64) + ((PKN_ROWS + 63) / 64 - 1)];
 
 		for (k = tail; k < 8; k++)
 		{
@@ -1366,7 +1677,7 @@ int FFTM12T62::PkGen(std::vector<byte> &PublicKey, const std::vector<byte> &Priv
 
 		for (j = M; j < 64; j++)
 		{
-			IntUtils::Le64ToBytes(mat[i][j], PublicKey, pos);
+			IntUtils::Le64ToBytes(mat[(i * 64) + j], PublicKey, pos);
 			pos += 8;
 		}
 	}
@@ -1374,16 +1685,163 @@ int FFTM12T62::PkGen(std::vector<byte> &PublicKey, const std::vector<byte> &Priv
 	return 0;
 }
 
+void FFTM12T62::RowAccumulate(ulong* Matrix, size_t Row, const std::array<ulong, PKN_ROWS> &Masks)
+{
+	const size_t PVTOFF = Row * 64;
+	size_t k;
+
+#if defined(__AVX512__)
+
+	// the pivot row is held in registers while the rows below it are folded in
+	std::array<__m512i, 8> acc;
+	size_t c;
+
+	for (c = 0; c < 8; ++c)
+	{
+		acc[c] = _mm512_load_si512(reinterpret_cast<const void*>(Matrix + PVTOFF + (c * 8)));
+	}
+
+	for (k = Row + 1; k < PKN_ROWS; ++k)
+	{
+		const __m512i MSK = _mm512_set1_epi64(static_cast<long long>(Masks[k]));
+
+		for (c = 0; c < 8; ++c)
+		{
+			acc[c] = _mm512_xor_si512(acc[c], _mm512_and_si512(_mm512_load_si512(reinterpret_cast<const void*>(Matrix + (k * 64) + (c * 8))), MSK));
+		}
+	}
+
+	for (c = 0; c < 8; ++c)
+	{
+		_mm512_store_si512(reinterpret_cast<void*>(Matrix + PVTOFF + (c * 8)), acc[c]);
+	}
+
+#elif defined(__AVX2__)
+
+	// a half row of the pivot is held in registers per column block; the masks are all zeros or all ones, so 32-bit lanes are exact
+	std::array<Numeric::UInt256, 8> acc;
+	size_t blk;
+	size_t c;
+
+	for (blk = 0; blk < 64; blk += 32)
+	{
+		for (c = 0; c < 8; ++c)
+		{
+			acc[c].Load(Matrix, PVTOFF + blk + (c * 4));
+		}
+
+		for (k = Row + 1; k < PKN_ROWS; ++k)
+		{
+			Numeric::UInt256 msk(static_cast<uint>(Masks[k]));
+
+			for (c = 0; c < 8; ++c)
+			{
+				acc[c] ^= Numeric::UInt256(Matrix, (k * 64) + blk + (c * 4)) & msk;
+			}
+		}
+
+		for (c = 0; c < 8; ++c)
+		{
+			acc[c].Store(Matrix, PVTOFF + blk + (c * 4));
+		}
+	}
+
+#else
+
+	size_t c;
+
+	for (k = Row + 1; k < PKN_ROWS; ++k)
+	{
+		for (c = 0; c < 64; ++c)
+		{
+			Matrix[PVTOFF + c] ^= Matrix[(k * 64) + c] & Masks[k];
+		}
+	}
+
+#endif
+}
+
+void FFTM12T62::RowEliminate(ulong* Matrix, size_t Row, const std::array<ulong, PKN_ROWS> &Masks)
+{
+	const size_t PVTOFF = Row * 64;
+	size_t k;
+
+#if defined(__AVX512__)
+
+	std::array<__m512i, 8> pvt;
+	size_t c;
+
+	for (c = 0; c < 8; ++c)
+	{
+		pvt[c] = _mm512_load_si512(reinterpret_cast<const void*>(Matrix + PVTOFF + (c * 8)));
+	}
+
+	for (k = 0; k < PKN_ROWS; ++k)
+	{
+		const __m512i MSK = _mm512_set1_epi64(static_cast<long long>(Masks[k]));
+
+		for (c = 0; c < 8; ++c)
+		{
+			__m512i* pRow = reinterpret_cast<__m512i*>(Matrix + (k * 64) + (c * 8));
+			_mm512_store_si512(reinterpret_cast<void*>(pRow), _mm512_xor_si512(_mm512_load_si512(reinterpret_cast<const void*>(pRow)), _mm512_and_si512(pvt[c], MSK)));
+		}
+	}
+
+#elif defined(__AVX2__)
+
+	std::array<Numeric::UInt256, 8> pvt;
+	Numeric::UInt256 tmp;
+	size_t blk;
+	size_t c;
+
+	for (blk = 0; blk < 64; blk += 32)
+	{
+		for (c = 0; c < 8; ++c)
+		{
+			pvt[c].Load(Matrix, PVTOFF + blk + (c * 4));
+		}
+
+		for (k = 0; k < PKN_ROWS; ++k)
+		{
+			Numeric::UInt256 msk(static_cast<uint>(Masks[k]));
+
+			for (c = 0; c < 8; ++c)
+			{
+				tmp.Load(Matrix, (k * 64) + blk + (c * 4));
+				tmp ^= pvt[c] & msk;
+				tmp.Store(Matrix, (k * 64) + blk + (c * 4));
+			}
+		}
+	}
+
+#else
+
+	size_t c;
+
+	for (k = 0; k < PKN_ROWS; ++k)
+	{
+		for (c = 0; c < 64; ++c)
+		{
+			Matrix[(k * 64) + c] ^= Matrix[PVTOFF + c] & Masks[k];
+		}
+	}
+
+#endif
+}
+
 //~~~FFT~~~//
 
-void FFTM12T62::AdditiveFFT::Transform(std::array<std::array<ulong, M>, 64> &Output, std::array<ulong, M> &Input)
+template <typename V>
+void FFTM12T62::AdditiveFFT::Transform(std::array<std::array<V, M>, 64> &Output, std::array<V, M> &Input)
 {
 	RadixConversions(Input);
 	Butterflies(Output, Input);
 }
 
-void FFTM12T62::AdditiveFFT::Butterflies(std::array<std::array<ulong, M>, 64> &Output, std::array<ulong, M> &Input)
+template <typename V>
+void FFTM12T62::AdditiveFFT::Butterflies(std::array<std::array<V, M>, 64> &Output, std::array<V, M> &Input)
 {
+	const V ONE = static_cast<V>(1);
 	size_t b;
 	size_t i;
 	size_t j;
@@ -1406,34 +1864,34 @@ void FFTM12T62::AdditiveFFT::Butterflies(std::array<std::array<ulong, M>, 64> &O
 	// broadcast
 	for (j = 0; j < 64; j++)
 	{
-		Output[j][0] = (Input[0] >> ButterflyReverse[j]) & 1;
-		Output[j][0] = ~Output[j][0] + 1;
-		Output[j][1] = (Input[1] >> ButterflyReverse[j]) & 1;
-		Output[j][1] = ~Output[j][1] + 1;
-		Output[j][2] = (Input[2] >> ButterflyReverse[j]) & 1;
-		Output[j][2] = ~Output[j][2] + 1;
-		Output[j][3] = (Input[3] >> ButterflyReverse[j]) & 1;
-		Output[j][3] = ~Output[j][3] + 1;
-		Output[j][4] = (Input[4] >> ButterflyReverse[j]) & 1;
-		Output[j][4] = ~Output[j][4] + 1;
-		Output[j][5] = (Input[5] >> ButterflyReverse[j]) & 1;
-		Output[j][5] = ~Output[j][5] + 1;
-		Output[j][6] = (Input[6] >> ButterflyReverse[j]) & 1;
-		Output[j][6] = ~Output[j][6] + 1;
-		Output[j][7] = (Input[7] >> ButterflyReverse[j]) & 1;
-		Output[j][7] = ~Output[j][7] + 1;
-		Output[j][8] = (Input[8] >> ButterflyReverse[j]) & 1;
-		Output[j][8] = ~Output[j][8] + 1;
-		Output[j][9] = (Input[9] >> ButterflyReverse[j]) & 1;
-		Output[j][9] = ~Output[j][9] + 1;
-		Output[j][10] = (Input[10] >> ButterflyReverse[j]) & 1;
-		Output[j][10] = ~Output[j][10] + 1;
-		Output[j][11] = (Input[11] >> ButterflyReverse[j]) & 1;
-		Output[j][11] = ~Output[j][11] + 1;
+		Output[j][0] = (Input[0] >> ButterflyReverse[j]) & ONE;
+		Output[j][0] = ~Output[j][0] + ONE;
+		Output[j][1] = (Input[1] >> ButterflyReverse[j]) & ONE;
+		Output[j][1] = ~Output[j][1] + ONE;
+		Output[j][2] = (Input[2] >> ButterflyReverse[j]) & ONE;
+		Output[j][2] = ~Output[j][2] + ONE;
+		Output[j][3] = (Input[3] >> ButterflyReverse[j]) & ONE;
+		Output[j][3] = ~Output[j][3] + ONE;
+		Output[j][4] = (Input[4] >> ButterflyReverse[j]) & ONE;
+		Output[j][4] = ~Output[j][4] + ONE;
+		Output[j][5] = (Input[5] >> ButterflyReverse[j]) & ONE;
+		Output[j][5] = ~Output[j][5] + ONE;
+		Output[j][6] = (Input[6] >> ButterflyReverse[j]) & ONE;
+		Output[j][6] = ~Output[j][6] + ONE;
+		Output[j][7] = (Input[7] >> ButterflyReverse[j]) & ONE;
+		Output[j][7] = ~Output[j][7] + ONE;
+		Output[j][8] = (Input[8] >> ButterflyReverse[j]) & ONE;
+		Output[j][8] = ~Output[j][8] + ONE;
+		Output[j][9] = (Input[9] >> ButterflyReverse[j]) & ONE;
+		Output[j][9] = ~Output[j][9] + ONE;
+		Output[j][10] = (Input[10] >> ButterflyReverse[j]) & ONE;
+		Output[j][10] = ~Output[j][10] + ONE;
+		Output[j][11] = (Input[11] >> ButterflyReverse[j]) & ONE;
+		Output[j][11] = ~Output[j][11] + ONE;
 	}
 
 	constsPos = 0;
-	std::array<ulong, M> tmp;
+	std::array<V, M> tmp;
 
 	// butterflies
 	for (i = 0; i <= 5; i++)
@@ -1469,7 +1927,8 @@ void FFTM12T62::AdditiveFFT::Butterflies(std::array<std::array<ulong, M>, 64> &O
 	}
 }
 
-void FFTM12T62::AdditiveFFT::RadixConversions(std::array<ulong, M> &Output)
+template <typename V>
+void FFTM12T62::AdditiveFFT::RadixConversions(std::array<V, M> &Output)
 {
 	size_t i;
 	size_t j;
@@ -1521,8 +1980,8 @@ void FFTM12T62::AdditiveFFT::RadixConversions(std::array<ulong, M> &Output)
 			k = 5;
 			while (k-- > i)
 			{
-				Output[j] ^= (Output[j] & RadixMask[k][0]) >> ((size_t)1 << k);
-				Output[j] ^= (Output[j] & RadixMask[k][1]) >> ((size_t)1 << k);
+				Output[j] ^= (Output[j] & static_cast<V>(RadixMask[k][0])) >> ((size_t)1 << k);
+				Output[j] ^= (Output[j] & static_cast<V>(RadixMask[k][1])) >> ((size_t)1 << k);
 			}
 		}
 
@@ -1530,20 +1989,23 @@ void FFTM12T62::AdditiveFFT::RadixConversions(std::array<ulong, M> &Output)
 	}
 }
 
-void FFTM12T62::TransposedFFT::Transform(std::array<std::array<ulong, M>, 2> &Output, std::array<std::array<ulong, M>, 64> &Input)
+template <typename V>
+void FFTM12T62::TransposedFFT::Transform(std::array<std::array<V, M>, 2> &Output, std::array<std::array<V, M>, 64> &Input)
 {
 	Butterflies(Output, Input);
 	RadixConversions(Output);
 }
 
-void FFTM12T62::TransposedFFT::Butterflies(std::array<std::array<ulong, M>, 2> &Output, std::array<std::array<ulong, M>, 64> &Input)
+template <typename V>
+void FFTM12T62::TransposedFFT::Butterflies(std::array<std::array<V, M>, 2> &Output, std::array<std::array<V, M>, 64> &Input)
 {
+	const V ONE = static_cast<V>(1);
 	size_t i;
 	size_t j;
 	size_t k;
 	size_t s;
 	ulong constsPos = 63;
-	std::array<ulong, M> tmp;
+	std::array<V, M> tmp;
 
 	// butterflies
 	i = 6;
@@ -1576,7 +2038,7 @@ void FFTM12T62::TransposedFFT::Butterflies(std::array<std::array<ulong, M>, 2> &
 		7, 39, 23, 55, 15, 47, 31, 63
 	};
 
-	std::array<ulong, 64> buf;
+	std::array<V, 64> buf;
 	for (i = 0; i < M; i++)
 	{
 		for (j = 0; j < 64; j++) 
@@ -1593,7 +2055,7 @@ void FFTM12T62::TransposedFFT::Butterflies(std::array<std::array<ulong, M>, 2> &
 	}
 
 	// broadcast
-	std::array<std::array<ulong, M>, 6> pre;
+	std::array<std::array<V, M>, 6> pre;
 	McElieceUtils::Copy(Input[32], pre[0]);
 	McElieceUtils::Add(Input[33], Input[32]);
 	McElieceUtils::Copy(Input[33], pre[1]);
@@ -1728,8 +2190,8 @@ void FFTM12T62::TransposedFFT::Butterflies(std::array<std::array<ulong, M>, 2> &
 
 	for (j = 0; j < M; j++)
 	{
-		tmp[j] = (beta[0] >> j) & 1;
-		tmp[j] = ~tmp[j] + 1;
+		tmp[j] = static_cast<V>((beta[0] >> j) & 1);
+		tmp[j] = ~tmp[j] + ONE;
 	}
 
 	McElieceUtils::Multiply(Output[1], pre[0], tmp);
@@ -1738,8 +2200,8 @@ void FFTM12T62::TransposedFFT::Butterflies(std::array<std::array<ulong, M>, 2> &
 	{
 		for (j = 0; j < M; j++)
 		{
-			tmp[j] = (beta[i] >> j) & 1;
-			tmp[j] = ~tmp[j] + 1;
+			tmp[j] = static_cast<V>((beta[i] >> j) & 1);
+			tmp[j] = ~tmp[j] + ONE;
 		}
 
 		McElieceUtils::Multiply(tmp, pre[i], tmp);
@@ -1747,7 +2209,8 @@ void FFTM12T62::TransposedFFT::Butterflies(std::array<std::array<ulong, M>, 2> &
 	}
 }
 
-void FFTM12T62::TransposedFFT::RadixConversions(std::array<std::array<ulong, M>, 2> &Output)
+template <typename V>
+void FFTM12T62::TransposedFFT::RadixConversions(std::array<std::array<V, M>, 2> &Output)
 {
 	size_t i;
 	size_t j;
@@ -1840,17 +2303,17 @@ void FFTM12T62::TransposedFFT::RadixConversions(std::array<std::array<ulong, M>,
 		{
 			for (k = j; k <= 4; k++)
 			{
-				Output[0][i] ^= (Output[0][i] & RadixTrMask[k][0]) << ((size_t)1 << k);
-				Output[0][i] ^= (Output[0][i] & RadixTrMask[k][1]) << ((size_t)1 << k);
-				Output[1][i] ^= (Output[1][i] & RadixTrMask[k][0]) << ((size_t)1 << k);
-				Output[1][i] ^= (Output[1][i] & RadixTrMask[k][1]) << ((size_t)1 << k);
+				Output[0][i] ^= (Output[0][i] & static_cast<V>(RadixTrMask[k][0])) << ((size_t)1 << k);
+				Output[0][i] ^= (Output[0][i] & static_cast<V>(RadixTrMask[k][1])) << ((size_t)1 << k);
+				Output[1][i] ^= (Output[1][i] & static_cast<V>(RadixTrMask[k][0])) << ((size_t)1 << k);
+				Output[1][i] ^= (Output[1][i] & static_cast<V>(RadixTrMask[k][1])) << ((size_t)1 << k);
 			}
 		}
 
 		for (i = 0; i < M; i++)
 		{
-			Output[1][i] ^= (Output[0][i] & RadixTrMask[5][0]) >> 32;
-			Output[1][i] ^= (Output[1][i] & RadixTrMask[5][1]) << 32;
+			Output[1][i] ^= (Output[0][i] & static_cast<V>(RadixTrMask[5][0])) >> 32;
+			Output[1][i] ^= (Output[1][i] & static_cast<V>(RadixTrMask[5][1])) << 32;
 		}
 	}
 }
@@ -20,6 +20,7 @@
 #define _CEX_FFTM12T62_H
 
 #include "CexDomain.h"
+#include "ByteView.h"
 #include "IPrng.h"
 
 NAMESPACE_MCELIECE
@@ -53,6 +54,9 @@ private:
 	static const size_t IRR_SIZE = (M * 8);
 	static const size_t CND_SIZE = ((PKN_ROWS - 8) * 8);
 	static const size_t GEN_MAXR = 10000;
+	static const size_t PKN_ALIGN = 64;
+	static const size_t PKN_ARENA = (PKN_ROWS * 64) + (PKN_ALIGN / sizeof(ulong));
+	static const size_t DEC_LANES = 4;
 
 public:
 
@@ -60,11 +64,15 @@ public:
 	static const size_t PRIKEY_SIZE = CND_SIZE + IRR_SIZE;
 	static const size_t PUBKEY_SIZE = (PKN_ROWS * ((64 - M) * 8)) + (PKN_ROWS * (8 - ((PKN_ROWS & 63) >> 3)));
 
-	static bool Decrypt(std::vector<byte> &E, const std::vector<byte> &PrivateKey, const std::vector<byte> &S);
+	static bool Decrypt(std::vector<byte> &E, const IO::ByteView &PrivateKey, const std::vector<byte> &S);
 
-	static void Encrypt(std::vector<byte> &S, std::vector<byte> &E, const std::vector<byte> &PublicKey, std::unique_ptr<IPrng> &Random);
+	static std::vector<bool> Decrypt(std::vector<std::vector<byte>> &E, const IO::ByteView &PrivateKey, const std::vector<std::vector<byte>> &S, bool Parallel);
 
-	static bool Generate(std::vector<byte> &PublicKey, std::vector<byte> &PrivateKey, std::unique_ptr<IPrng> &Random);
+	static void Encrypt(std::vector<byte> &S, std::vector<byte> &E, const IO::ByteView &PublicKey, std::unique_ptr<IPrng> &Random, bool Parallel);
+
+	static void Encrypt(std::vector<std::vector<byte>> &S, std::vector<std::vector<byte>> &E, const IO::ByteView &PublicKey, std::unique_ptr<IPrng> &Random, bool Parallel);
+
+	static bool Generate(std::vector<byte> &PublicKey, std::vector<byte> &PrivateKey, std::unique_ptr<IPrng> &Random, bool Parallel);
 
 private:
 
@@ -72,27 +80,43 @@ private:
 
 	static void BerlekampMassey(std::array<ulong, M> &Output, std::array<std::array<ulong, M>, 2> &Input);
 
+	static bool Decode(std::vector<byte> &E, const std::array<ulong, CND_SIZE / 8> &Condition, const std::array<std::array<ulong, M>, 64> &Inverse, const std::vector<byte> &S);
+
+#if defined(__AVX2__)
+	static void DecodeLanes(std::vector<std::vector<byte>> &E, std::vector<byte> &Valid, const std::array<ulong, CND_SIZE / 8> &Condition, const std::array<std::array<ulong, M>, 64> &Inverse, const std::vector<std::vector<byte>> &S, size_t Offset);
+#endif
+
 	static void PreProcess(std::vector<ulong> &Received, const std::vector<byte> &S);
 
-	static void Scaling(std::array<std::array<ulong, M>, 64> &Output, std::array<std::array<ulong, M>, 64> &Inverse, const std::vector<byte> &PrivateKey, std::vector<ulong> &Received);
+	template <typename V, typename Array>
+	static void Scaling(std::array<std::array<V, M>, 64> &Output, const std::array<std::array<ulong, M>, 64> &Inverse, const Array &Received);
 
-	static void ScalingInverse(std::array<std::array<ulong, M>, 64> &Output, std::array<std::array<ulong, M>, 64> &Inverse, std::array<ulong, 64> &Received);
+	static void ScalingInverses(std::array<std::array<ulong, M>, 64> &Output, const IO::ByteView &PrivateKey);
 
-	static void SyndromeAdjust(std::array<std::array<ulong, M>, 2> &Output);
+	template <typename V>
+	static void SyndromeAdjust(std::array<std::array<V, M>, 2> &Output);
 
 	//~~~Encrypt~~~//
 
 	static void GenE(std::vector<byte> &E, std::unique_ptr<IPrng> &Random);
 
-	static void Syndrome(std::vector<byte> &S, const std::vector<byte> &PublicKey, const std::vector<byte> &E);
+	static byte RowParity(const IO::ByteView &PublicKey, size_t Row, const std::vector<byte> &E);
+
+	static void Syndrome(std::vector<byte> &S, const IO::ByteView &PublicKey, const std::vector<byte> &E, bool Parallel);
+
+	static void Syndrome(std::vector<std::vector<byte>> &S, const IO::ByteView &PublicKey, const std::vector<std::vector<byte>> &E, bool Parallel);
 
 	//~~~KeyGen~~~//
 
 	static int IrrGen(std::array<ushort, T + 1> &Output, std::vector<ushort> &F);
 
-	static void SkGen(std::vector<byte> &PrivateKey, std::unique_ptr<Prng::IPrng> &Random);
+	static int PkGen(std::vector<byte> &PublicKey, const std::vector<byte> &PrivateKey, std::vector<ulong> &Arena);
+
+	static void RowAccumulate(ulong* Matrix, size_t Row, const std::array<ulong, PKN_ROWS> &Masks);
+
+	static void RowEliminate(ulong* Matrix, size_t Row, const std::array<ulong, PKN_ROWS> &Masks);
 
-	static int PkGen(std::vector<byte> &PublicKey, const std::vector<byte> &PrivateKey);
+	static int SkGen(std::vector<byte> &PrivateKey, std::vector<ushort> &F, const std::vector<ulong> &Condition);
 
 	//~~~Utils~~~//
 
@@ -108,26 +132,32 @@ private:
 	{
 	public:
 
-		static void Transform(std::array<std::array<ulong, M>, 64> &Output, std::array<ulong, M> &Input);
+		template <typename V>
+		static void Transform(std::array<std::array<V, M>, 64> &Output, std::array<V, M> &Input);
 
 	private:
 
-		static void Butterflies(std::array<std::array<ulong, M>, 64> &Output, std::array<ulong, M> &Input);
+		template <typename V>
+		static void Butterflies(std::array<std::array<V, M>, 64> &Output, std::array<V, M> &Input);
 
-		static void RadixConversions(std::array<ulong, M> &Output);
+		template <typename V>
+		static void RadixConversions(std::array<V, M> &Output);
 	};
 
 	class TransposedFFT
 	{
 	public:
 
-		static void Transform(std::array<std::array<ulong, M>, 2> &Output, std::array<std::array<ulong, M>, 64> &Input);
+		template <typename V>
+		static void Transform(std::array<std::array<V, M>, 2> &Output, std::array<std::array<V, M>, 64> &Input);
 
 	private:
 
-		static void Butterflies(std::array<std::array<ulong, M>, 2> &Output, std::array<std::array<ulong, M>, 64> &Input);
+		template <typename V>
+		static void Butterflies(std::array<std::array<V, M>, 2> &Output, std::array<std::array<V, M>, 64> &Input);
 
-		static void RadixConversions(std::array<std::array<ulong, M>, 2> &Output);
+		template <typename V>
+		static void RadixConversions(std::array<std::array<V, M>, 2> &Output);
 	};
 };
 
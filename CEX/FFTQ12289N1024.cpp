@@ -1,6 +1,9 @@
 #include "FFTQ12289N1024.h"
 #include "BCG.h"
+#include "CpuDetect.h"
+#include "IntUtils.h"
 #include "MemUtils.h"
+#include "ParallelUtils.h"
 #include "PolyMath.h"
 
 #if defined(__AVX512__)
@@ -167,29 +170,170 @@ void FFTQ12289N1024::Decrypt(std::vector<byte> &Secret, const std::vector<ushort
 
 	DecodeB(bp, c, Received);
 	PolyPointwise(v, PriKey, bp);
-	Utility::PolyMath::BitReverse(v);
 	InvNTT(v);
 	Reconcile(Secret, v, c);
 }
 
-void FFTQ12289N1024::Encrypt(std::vector<byte> &Secret, std::vector<byte> &Send, const std::vector<byte> &Received, std::unique_ptr<Prng::IPrng> &Rng, bool Parallel)
+void FFTQ12289N1024::Encrypt(std::vector<std::vector<byte>> &Secret, std::vector<std::vector<byte>> &Send, const std::vector<byte> &Received, const std::vector<ushort> &A, std::unique_ptr<Prng::IPrng> &Rng)
 {
-	std::array<ushort, N> a;
-	std::array<ushort, N> bp;
-	std::array<ushort, N> c;
-	std::array<ushort, N> ep;
-	std::array<ushort, N> epp;
+	CexAssert(A.size() == N, "The expanded polynomial is the wrong size");
+	CexAssert(Secret.size() == Send.size(), "The secret and message batches are not the same size");
+
+	const size_t CNT = Send.size();
 	std::array<ushort, N> pka;
-	std::array<ushort, N> sp;
-	std::array<ushort, N> tbp;
-	std::array<ushort, N> v;
+	std::vector<byte> seed(SEED_BYTES);
+	std::vector<std::vector<uint>> noise(3 * CNT, std::vector<uint>(N));
+	std::vector<std::vector<byte>> rnd(CNT, std::vector<byte>(SEED_BYTES));
+
+	if (CNT == 0)
+	{
+		return;
+	}
+
+	// the recipients key is decoded once for the batch
+	DecodeA(pka, seed, Received);
 
+	// the generator is not shared between threads, so the random for the whole batch is drawn first
+	for (size_t i = 0; i < CNT; ++i)
+	{
+		Rng->Fill(noise[3 * i], 0, N);
+		Rng->Fill(noise[(3 * i) + 1], 0, N);
+		Rng->Fill(noise[(3 * i) + 2], 0, N);
+		Rng->GetBytes(rnd[i]);
+	}
+
+	// each thread processes whole messages; a message is too small to divide between threads
+	const size_t THDCNT = (Utility::ParallelUtils::ProcessorCount() < CNT) ? Utility::ParallelUtils::ProcessorCount() : CNT;
+
+	Utility::ParallelUtils::ParallelFor(0, THDCNT, [&Secret, &Send, &pka, &A, &noise, &rnd, CNT, THDCNT](size_t i)
+	{
+		for (size_t j = i; j < CNT; j += THDCNT)
+		{
+			Encrypt(Secret[j], Send[j], pka, A, noise[3 * j], noise[(3 * j) + 1], noise[(3 * j) + 2], rnd[j], false);
+		}
+	});
+}
+
+void FFTQ12289N1024::Encrypt(std::vector<byte> &Secret, std::vector<byte> &Send, const std::vector<byte> &Received, const std::vector<ushort> &A, std::unique_ptr<Prng::IPrng> &Rng, bool Parallel)
+{
+	CexAssert(A.size() == N, "The expanded polynomial is the wrong size");
+
+	std::array<ushort, N> pka;
 	std::vector<byte> seed(SEED_BYTES);
 	DecodeA(pka, seed, Received);
+
+	std::vector<uint> buf1(N);
+	Rng->Fill(buf1, 0, N);
+	std::vector<uint> buf2(N);
+	Rng->Fill(buf2, 0, N);
+	std::vector<uint> buf3(N);
+	Rng->Fill(buf3, 0, N);
+	Rng->GetBytes(seed);
+
+	Encrypt(Secret, Send, pka, A, buf1, buf2, buf3, seed, Parallel);
+}
+
+void FFTQ12289N1024::Expand(std::vector<ushort> &A, const std::vector<byte> &PubKey)
+{
+	CexAssert(PubKey.size() >= SENDA_BYTES, "The public key is too small");
+
+	std::vector<byte> seed(SEED_BYTES);
+	Utility::MemUtils::Copy(PubKey, POLY_BYTES, seed, 0, SEED_BYTES);
+	A.resize(N);
+	PolyUniform(A, seed);
+}
+
+void FFTQ12289N1024::Generate(std::vector<std::vector<byte>> &PubKey, std::vector<std::vector<ushort>> &PriKey, std::vector<std::vector<ushort>> &A, std::unique_ptr<Prng::IPrng> &Rng)
+{
+	CexAssert(PubKey.size() == PriKey.size() && PubKey.size() == A.size(), "The key batches are not the same size");
+
+	const size_t CNT = PubKey.size();
+	std::vector<std::vector<uint>> noise(2 * CNT, std::vector<uint>(N));
+	std::vector<std::vector<byte>> seed(CNT, std::vector<byte>(SEED_BYTES));
+
+	if (CNT == 0)
+	{
+		return;
+	}
+
+	// the generator is not shared between threads, so the random for the whole batch is drawn first
+	for (size_t i = 0; i < CNT; ++i)
+	{
+		Rng->Fill(noise[2 * i], 0, N);
+		Rng->Fill(noise[(2 * i) + 1], 0, N);
+		Rng->GetBytes(seed[i]);
+	}
+
+	// each thread generates whole key-pairs
+	const size_t THDCNT = (Utility::ParallelUtils::ProcessorCount() < CNT) ? Utility::ParallelUtils::ProcessorCount() : CNT;
+
+	Utility::ParallelUtils::ParallelFor(0, THDCNT, [&PubKey, &PriKey, &A, &noise, &seed, CNT, THDCNT](size_t i)
+	{
+		for (size_t j = i; j < CNT; j += THDCNT)
+		{
+			Generate(PubKey[j], PriKey[j], A[j], noise[2 * j], noise[(2 * j) + 1], seed[j], false);
+		}
+	});
+}
+
+void FFTQ12289N1024::Generate(std::vector<byte> &PubKey, std::vector<ushort> &PriKey, std::vector<ushort> &A, std::unique_ptr<Prng::IPrng> &Rng, bool Parallel)
+{
 	std::vector<uint> buf1(N);
 	Rng->Fill(buf1, 0, N);
 	std::vector<uint> buf2(N);
 	Rng->Fill(buf2, 0, N);
+	std::vector<byte> seed(SEED_BYTES);
+	Rng->GetBytes(seed);
+
+	Generate(PubKey, PriKey, A, buf1, buf2, seed, Parallel);
+}
+
+//~~~Private Functions~~~//
+
+void FFTQ12289N1024::DecodeA(std::array<ushort, N> &PubKey, std::vector<byte> &Seed, const std::vector<byte> &R)
+{
+	FromBytes(PubKey, R);
+	Utility::MemUtils::Copy(R, POLY_BYTES, Seed, 0, SEED_BYTES);
+}
+
+void FFTQ12289N1024::DecodeB(std::array<ushort, N> &B, std::array<ushort, N> &C, const std::vector<byte> &R)
+{
+	FromBytes(B, R);
+
+	for (size_t i = 0; i < N / 4; i++)
+	{
+		C[4 * i + 0] = static_cast<ushort>(R[POLY_BYTES + i] & 0x03);
+		C[4 * i + 1] = static_cast<ushort>((R[POLY_BYTES + i] >> 2) & 0x03);
+		C[4 * i + 2] = static_cast<ushort>((R[POLY_BYTES + i] >> 4) & 0x03);
+		C[4 * i + 3] = static_cast<ushort>((R[POLY_BYTES + i] >> 6));
+	}
+}
+
+void FFTQ12289N1024::EncodeA(std::vector<byte> &R, const std::array<ushort, N> &PubKey, const std::vector<byte> &Seed)
+{
+	ToBytes(R, PubKey);
+	Utility::MemUtils::Copy(Seed, 0, R, POLY_BYTES, SEED_BYTES);
+}
+
+void FFTQ12289N1024::EncodeB(std::vector<byte> &R, const std::array<ushort, N> &B, const std::array<ushort, N> &C)
+{
+	ToBytes(R, B);
+
+	for (size_t i = 0; i < N / 4; i++)
+	{
+		R[POLY_BYTES + i] = C[4 * i] | (C[4 * i + 1] << 2) | (C[4 * i + 2] << 4) | (C[4 * i + 3] << 6);
+	}
+}
+
+void FFTQ12289N1024::Encrypt(std::vector<byte> &Secret, std::vector<byte> &Send, const std::array<ushort, N> &PubKey, const std::vector<ushort> &A, std::vector<uint> &Noise1, std::vector<uint> &Noise2, std::vector<uint> &Noise3, std::vector<byte> &Random, bool Parallel)
+{
+	std::array<ushort, N> bp;
+	std::array<ushort, N> c;
+	std::array<ushort, N> ep;
+	std::array<ushort, N> epp;
+	std::array<ushort, N> sp;
+	std::array<ushort, N> tbp;
+	std::array<ushort, N> v;
 
 #if defined(_OPENMP)
 	if (Parallel)
@@ -198,16 +342,12 @@ void FFTQ12289N1024::Encrypt(std::vector<byte> &Secret, std::vector<byte> &Send,
 		{
 #			pragma omp single nowait
 			{
-				PolyUniform(a, seed, Parallel);
-			}
-#			pragma omp single nowait
-			{
-				PolyGetNoise(sp, buf1);
+				PolyGetNoise(sp, Noise1);
 				FwdNTT(sp);
 			}
 #			pragma omp single nowait
 			{
-				PolyGetNoise(ep, buf2);
+				PolyGetNoise(ep, Noise2);
 				FwdNTT(ep);
 			}
 		}
@@ -215,44 +355,44 @@ void FFTQ12289N1024::Encrypt(std::vector<byte> &Secret, std::vector<byte> &Send,
 	else
 #endif
 	{
-		PolyUniform(a, seed, Parallel);
-
-		PolyGetNoise(sp, buf1);
+		PolyGetNoise(sp, Noise1);
 		FwdNTT(sp);
 
-		PolyGetNoise(ep, buf2);
+		PolyGetNoise(ep, Noise2);
 		FwdNTT(ep);
 	}
 
-	PolyPointwise(bp, a, sp);
+	PolyPointwise(bp, A, sp);
 	PolyAdd(tbp, bp, ep);
 
-	PolyPointwise(v, pka, sp);
-	Utility::PolyMath::BitReverse(v);
+	PolyPointwise(v, PubKey, sp);
 	InvNTT(v);
-	Rng->Fill(buf1, 0, N);;
-	PolyGetNoise(epp, buf1);
+	PolyGetNoise(epp, Noise3);
 	PolyAdd(v, v, epp);
 
-	Rng->GetBytes(seed);
-	RecHelper(c, v, seed);
+	RecHelper(c, v, Random);
 	EncodeB(Send, tbp, c);
 	Reconcile(Secret, v, c);
 }
 
-void FFTQ12289N1024::Generate(std::vector<byte> &PubKey, std::vector<ushort> &PriKey, std::unique_ptr<Prng::IPrng> &Rng, bool Parallel)
+void FFTQ12289N1024::FromBytes(std::array<ushort, N> &R, const std::vector<byte> &A)
+{
+	for (size_t i = 0; i < N / 4; ++i)
+	{
+		R[4 * i + 0] = A[7 * i + 0] | (((ushort)A[7 * i + 1] & 0x3f) << 8);
+		R[4 * i + 1] = (A[7 * i + 1] >> 6) | (((ushort)A[7 * i + 2]) << 2) | (((ushort)A[7 * i + 3] & 0x0f) << 10);
+		R[4 * i + 2] = (A[7 * i + 3] >> 4) | (((ushort)A[7 * i + 4]) << 4) | (((ushort)A[7 * i + 5] & 0x03) << 12);
+		R[4 * i + 3] = (A[7 * i + 5] >> 2) | (((ushort)A[7 * i + 6]) << 6);
+	}
+}
+
+void FFTQ12289N1024::Generate(std::vector<byte> &PubKey, std::vector<ushort> &PriKey, std::vector<ushort> &A, std::vector<uint> &Noise1, std::vector<uint> &Noise2, std::vector<byte> &Seed, bool Parallel)
 {
-	std::array<ushort, N> a;
 	std::array<ushort, N> e;
 	std::array<ushort, N> pk;
 	std::array<ushort, N> r;
 
-	std::vector<uint> buf1(N);
-	Rng->Fill(buf1, 0, N);
-	std::vector<uint> buf2(N);
-	Rng->Fill(buf2, 0, N);
-	std::vector<byte> seed(SEED_BYTES);
-	Rng->GetBytes(seed);
+	A.resize(N);
 
 #if defined(_OPENMP)
 	if (Parallel)
@@ -261,16 +401,16 @@ void FFTQ12289N1024::Generate(std::vector<byte> &PubKey, std::vector<ushort> &Pr
 		{
 #			pragma omp single nowait
 			{
-				PolyUniform(a, seed, Parallel);
+				PolyUniform(A, Seed);
 			}
 #			pragma omp single nowait
 			{
-				PolyGetNoise(PriKey, buf1);
+				PolyGetNoise(PriKey, Noise1);
 				FwdNTT(PriKey);
 			}
 #			pragma omp single nowait
 			{
-				PolyGetNoise(e, buf2);
+				PolyGetNoise(e, Noise2);
 				FwdNTT(e);
 			}
 		}
@@ -278,88 +418,57 @@ void FFTQ12289N1024::Generate(std::vector<byte> &PubKey, std::vector<ushort> &Pr
 	else
 #endif
 	{
-		PolyUniform(a, seed, Parallel);
+		PolyUniform(A, Seed);
 
-		PolyGetNoise(PriKey, buf1);
+		PolyGetNoise(PriKey, Noise1);
 		FwdNTT(PriKey);
 
-		PolyGetNoise(e, buf2);
+		PolyGetNoise(e, Noise2);
 		FwdNTT(e);
 	}
 
-	PolyPointwise(r, PriKey, a);
+	PolyPointwise(r, PriKey, A);
 	PolyAdd(pk, e, r);
-	EncodeA(PubKey, pk, seed);
+	EncodeA(PubKey, pk, Seed);
 }
 
-//~~~Private Functions~~~//
-
-void FFTQ12289N1024::DecodeA(std::array<ushort, N> &PubKey, std::vector<byte> &Seed, const std::vector<byte> &R)
+void FFTQ12289N1024::PolyUniform(std::vector<ushort> &A, const std::vector<byte> &Seed)
 {
-	FromBytes(PubKey, R);
-	Utility::MemUtils::Copy(R, POLY_BYTES, Seed, 0, SEED_BYTES);
-}
+#if defined(__AVX__)
 
-void FFTQ12289N1024::DecodeB(std::array<ushort, N> &B, std::array<ushort, N> &C, const std::vector<byte> &R)
-{
-	FromBytes(B, R);
+	// aes-ni is not implied by avx; without it, fall through to the BCG generator
+	Common::CpuDetect detect;
 
-	for (size_t i = 0; i < N / 4; i++)
+	if (detect.AESNI())
 	{
-		C[4 * i + 0] = static_cast<ushort>(R[POLY_BYTES + i] & 0x03);
-		C[4 * i + 1] = static_cast<ushort>((R[POLY_BYTES + i] >> 2) & 0x03);
-		C[4 * i + 2] = static_cast<ushort>((R[POLY_BYTES + i] >> 4) & 0x03);
-		C[4 * i + 3] = static_cast<ushort>((R[POLY_BYTES + i] >> 6));
-	}
-}
+		// the BCG key-stream; aes-128 in counter mode, keyed with the upper half of the seed, the lower half is the big-endian counter.
+		// the key schedule, counter and key-stream block are held in local arrays, and the samples are taken a vector at a time
+		std::array<__m128i, 11> rndKey;
+		std::array<byte, UNIFORM_SIZE> buf;
+		ulong ctrHigh = Utility::IntUtils::BeBytesTo64(Seed, 0);
+		ulong ctrLow = Utility::IntUtils::BeBytesTo64(Seed, 8);
+		size_t ctr = 0;
 
-void FFTQ12289N1024::EncodeA(std::vector<byte> &R, const std::array<ushort, N> &PubKey, const std::vector<byte> &Seed)
-{
-	ToBytes(R, PubKey);
-	Utility::MemUtils::Copy(Seed, 0, R, POLY_BYTES, SEED_BYTES);
-}
+		Utility::PolyMath::AesExpand(Seed, rndKey);
 
-void FFTQ12289N1024::EncodeB(std::vector<byte> &R, const std::array<ushort, N> &B, const std::array<ushort, N> &C)
-{
-	ToBytes(R, B);
+		while (ctr < N)
+		{
+			Utility::PolyMath::AesCtr(rndKey, ctrHigh, ctrLow, buf);
+			ctr = RejectUniform(A, ctr, buf);
+		}
 
-	for (size_t i = 0; i < N / 4; i++)
-	{
-		R[POLY_BYTES + i] = C[4 * i] | (C[4 * i + 1] << 2) | (C[4 * i + 2] << 4) | (C[4 * i + 3] << 6);
-	}
-}
+		Utility::MemUtils::Clear(rndKey, 0, rndKey.size() * sizeof(__m128i));
+		Utility::MemUtils::Clear(buf, 0, buf.size());
 
-void FFTQ12289N1024::FromBytes(std::array<ushort, N> &R, const std::vector<byte> &A)
-{
-	for (size_t i = 0; i < N / 4; ++i)
-	{
-		R[4 * i + 0] = A[7 * i + 0] | (((ushort)A[7 * i + 1] & 0x3f) << 8);
-		R[4 * i + 1] = (A[7 * i + 1] >> 6) | (((ushort)A[7 * i + 2]) << 2) | (((ushort)A[7 * i + 3] & 0x0f) << 10);
-		R[4 * i + 2] = (A[7 * i + 3] >> 4) | (((ushort)A[7 * i + 4]) << 4) | (((ushort)A[7 * i + 5] & 0x03) << 12);
-		R[4 * i + 3] = (A[7 * i + 5] >> 2) | (((ushort)A[7 * i + 6]) << 6);
+		return;
 	}
-}
 
-void FFTQ12289N1024::PolyUniform(std::array<ushort, N> &A, const std::vector<byte> &Seed, bool Parallel)
-{
-	Drbg::BCG eng(Enumeration::BlockCiphers::Rijndael);
-	size_t bufLen = 2 * N * sizeof(ushort);
-
-	if (Parallel)
-	{
-		if (bufLen >= eng.ParallelProfile().ParallelMinimumSize())
-		{
-			bufLen -= (bufLen % eng.ParallelProfile().ParallelMinimumSize());
-			eng.ParallelProfile().ParallelBlockSize() = bufLen;
-		}
-	}
-	else
-	{
-		eng.ParallelProfile().IsParallel() = false;
-	}
+#endif
 
+	Drbg::BCG eng(Enumeration::BlockCiphers::Rijndael);
+	eng.ParallelProfile().IsParallel() = false;
 	eng.Initialize(Seed);
-	std::vector<byte> buf(bufLen);
+	std::vector<byte> buf(2 * N * sizeof(ushort));
 	eng.Generate(buf, 0, buf.size());
 
 	size_t ctr = 0;
@@ -410,6 +519,100 @@ void FFTQ12289N1024::Reconcile(std::vector<byte> &Key, const std::array<ushort,
 #endif
 }
 
+#if defined(__AVX__)
+
+#	if !defined(__AVX512__)
+
+const byte* FFTQ12289N1024::RejectIndex()
+{
+	// for each 8 bit mask of accepted lanes, the shuffle that packs those 16 bit lanes to the front of a register
+	static const std::array<byte, 256 * 16> SHUFFLE = []()
+	{
+		std::array<byte, 256 * 16> tbl;
+
+		for (size_t i = 0; i < 256; ++i)
+		{
+			size_t k = 0;
+
+			for (size_t j = 0; j < 8; ++j)
+			{
+				if ((i >> j) & 1)
+				{
+					tbl[(i * 16) + k++] = static_cast<byte>(2 * j);
+					tbl[(i * 16) + k++] = static_cast<byte>((2 * j) + 1);
+				}
+			}
+
+			while (k != 16)
+				tbl[(i * 16) + k++] = 0x80;
+		}
+
+		return tbl;
+	}();
+
+	return SHUFFLE.data();
+}
+
+#	endif
+
+size_t FFTQ12289N1024::RejectUniform(std::vector<ushort> &A, size_t Count, const std::array<byte, UNIFORM_SIZE> &Stream)
+{
+	size_t pos = 0;
+
+#	if defined(__AVX512__)
+
+	const __m512i MASK = _mm512_set1_epi32(0x3FFF);
+	const __m512i VQ = _mm512_set1_epi32(Q);
+
+	// compare 16 candidates, compress the accepted lanes and store them as 16 bit integers
+	while (Count + 16 <= N && pos != Stream.size())
+	{
+		__m512i x = _mm512_and_si512(_mm512_cvtepu16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(Stream.data() + pos))), MASK);
+		const __mmask16 ACC = _mm512_cmplt_epu32_mask(x, VQ);
+		x = _mm512_maskz_compress_epi32(ACC, x);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(A.data() + Count), _mm512_cvtepi32_epi16(x));
+		Count += BitCount(ACC);
+		pos += 32;
+	}
+
+#	else
+
+	const byte* SHUFFLE = RejectIndex();
+	const __m128i MASK = _mm_set1_epi16(0x3FFF);
+	const __m128i VQ = _mm_set1_epi16(Q);
+
+	// compare 8 candidates, and pack the accepted lanes with a shuffle indexed by the comparison mask
+	while (Count + 8 <= N && pos != Stream.size())
+	{
+		__m128i x = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Stream.data() + pos)), MASK);
+		// the candidates are 14 bits, so the signed comparison is exact
+		const uint ACC = static_cast<uint>(_mm_movemask_epi8(_mm_packs_epi16(_mm_cmplt_epi16(x, VQ), _mm_setzero_si128())));
+		x = _mm_shuffle_epi8(x, _mm_loadu_si128(reinterpret_cast<const __m128i*>(SHUFFLE + (ACC * 16))));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(A.data() + Count), x);
+		Count += BitCount(ACC);
+		pos += 16;
+	}
+
+#	endif
+
+	// the last coefficients are sampled singly, so a vector store never writes past the polynomial
+	while (Count < N && pos != Stream.size())
+	{
+		const ushort VAL = (Stream[pos] | ((ushort)Stream[pos + 1] << 8)) & 0x3fff;
+
+		if (VAL < Q)
+		{
+			A[Count++] = VAL;
+		}
+
+		pos += 2;
+	}
+
+	return Count;
+}
+
+#endif
+
 void FFTQ12289N1024::ToBytes(std::vector<byte> &R, const std::array<ushort, N> &Poly)
 {
 	short c;
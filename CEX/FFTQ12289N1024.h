@@ -21,6 +21,11 @@
 
 #include "CexDomain.h"
 #include "IPrng.h"
+#include "PolyMath.h"
+#if defined(__AVX__)
+#	include <wmmintrin.h>
+#	include "Intrinsics.h"
+#endif
 
 NAMESPACE_RINGLWE
 
@@ -85,13 +90,17 @@ public:
 	//~~~Public Functions~~~//
 
 	static void Decrypt(std::vector<byte> &Secret, const std::vector<ushort> &PriKey, const std::vector<byte> &Received);
-	static void Encrypt(std::vector<byte> &Secret, std::vector<byte> &Send, const std::vector<byte> &Received, std::unique_ptr<Prng::IPrng> &Rng, bool Parallel);
-	static void Generate(std::vector<byte> &PubKey, std::vector<ushort> &PriKey, std::unique_ptr<Prng::IPrng> &Rng, bool Parallel);
+	static void Encrypt(std::vector<std::vector<byte>> &Secret, std::vector<std::vector<byte>> &Send, const std::vector<byte> &Received, const std::vector<ushort> &A, std::unique_ptr<Prng::IPrng> &Rng);
+	static void Encrypt(std::vector<byte> &Secret, std::vector<byte> &Send, const std::vector<byte> &Received, const std::vector<ushort> &A, std::unique_ptr<Prng::IPrng> &Rng, bool Parallel);
+	static void Expand(std::vector<ushort> &A, const std::vector<byte> &PubKey);
+	static void Generate(std::vector<std::vector<byte>> &PubKey, std::vector<std::vector<ushort>> &PriKey, std::vector<std::vector<ushort>> &A, std::unique_ptr<Prng::IPrng> &Rng);
+	static void Generate(std::vector<byte> &PubKey, std::vector<ushort> &PriKey, std::vector<ushort> &A, std::unique_ptr<Prng::IPrng> &Rng, bool Parallel);
 
 private:
 
 	static const uint QINV = 12287;
 	static const uint RLOG = 18;
+	static const size_t UNIFORM_SIZE = 128;
 	static const ushort OmegasMontgomery[512];
 	static const ushort OmegasInvMontgomery[512];
 	static const ushort PsisBitrevMontgomery[1024];
@@ -108,6 +117,15 @@ private:
 		return A;
 	}
 
+	inline static size_t BitCount(uint X)
+	{
+		X = X - ((X >> 1) & 0x5555);
+		X = (X & 0x3333) + ((X >> 2) & 0x3333);
+		X = (X + (X >> 4)) & 0x0F0F;
+
+		return (X + (X >> 8)) & 0x1F;
+	}
+
 	inline static ushort MontgomeryReduce(uint A)
 	{
 		uint u = (A * QINV);
@@ -135,6 +153,33 @@ private:
 
 	//~~~Templates~~~//
 
+	template <typename Vector, typename ArrayR, typename ArrayA, typename ArrayB>
+	inline static void Add(ArrayR &R, const ArrayA &A, const ArrayB &B)
+	{
+		const size_t VCTSZE = Vector::size() / sizeof(uint);
+		const Vector MASK16(0xFFFF);
+		Vector a, b;
+
+		for (size_t i = 0; i < R.size(); i += VCTSZE)
+		{
+			a.LoadUS(A, i);
+			b.LoadUS(B, i);
+			// the scalar sum is truncated to 16 bits before the reduction
+			a = (a + b) & MASK16;
+			BarrettReduceV(a).StoreUS(R, i);
+		}
+	}
+
+	template <typename Vector>
+	inline static Vector BarrettReduceV(Vector &A)
+	{
+		// the constant multiplications are shifts and adds; 5 = 2^2 + 1, and Q = 2^13 + 2^12 + 1
+		Vector u = ((A << 2) + A) >> 16;
+		u = (u << 13) + (u << 12) + u;
+
+		return A - u;
+	}
+
 	template <typename Vector>
 	inline static Vector CalcK(Vector &V0, Vector &V1, Vector &X, int Q)
 	{
@@ -190,6 +235,16 @@ private:
 	template <typename Array>
 	inline static void FwdNTT(Array &A)
 	{
+#if defined(__AVX512__)
+		PolyMul(A, PsisBitrevMontgomery);
+		NTT<Numeric::UInt512, Array>(A, false);
+#elif defined(__AVX2__)
+		PolyMul(A, PsisBitrevMontgomery);
+		NTT<Numeric::UInt256, Array>(A, false);
+#elif defined(__AVX__)
+		PolyMul(A, PsisBitrevMontgomery);
+		NTT<Numeric::UInt128, Array>(A, false);
+#else
 		for (size_t i = 0; i < A.size(); ++i)
 		{
 			A[i] = MontgomeryReduce((A[i] * PsisBitrevMontgomery[i]));
@@ -219,11 +274,25 @@ private:
 				}
 			}
 		}
+#endif
 	}
 
 	template <typename Array>
 	inline static void InvNTT(Array &R)
 	{
+		// the input is in bit reversed order
+#if defined(__AVX512__)
+		NTT<Numeric::UInt512, Array>(R, true);
+		PolyMul(R, PsisInvMontgomery);
+#elif defined(__AVX2__)
+		NTT<Numeric::UInt256, Array>(R, true);
+		PolyMul(R, PsisInvMontgomery);
+#elif defined(__AVX__)
+		NTT<Numeric::UInt128, Array>(R, true);
+		PolyMul(R, PsisInvMontgomery);
+#else
+		Utility::PolyMath::BitReverse(R);
+
 		size_t dist, i, j, jt, k;
 
 		for (i = 0; i < 10; i += 2)
@@ -253,6 +322,7 @@ private:
 		{
 			R[i] = MontgomeryReduce((R[i] * PsisInvMontgomery[i]));
 		}
+#endif
 	}
 
 	template <typename Vector, typename ArrayA, typename ArrayB>
@@ -404,6 +474,32 @@ private:
 #endif
 	}
 
+	template <typename Vector>
+	inline static std::vector<uint> LaneOmegas(const ushort* Omegas)
+	{
+		// The omegas of the layers processed on the transposed polynomial, where lane i of a register is row r + i.
+		// The omegas of a layer with distance Dist start at N - (N / Dist), and are ordered by block, then by row.
+		const size_t VCTSZE = Vector::size() / sizeof(uint);
+		const size_t ROWCNT = N / VCTSZE;
+		std::vector<uint> tmpL(N);
+
+		for (size_t dist = 1; dist < VCTSZE; dist <<= 1)
+		{
+			const size_t BLKCNT = VCTSZE / (2 * dist);
+			const size_t OFFSET = N - (N / dist);
+
+			for (size_t b = 0; b < BLKCNT; ++b)
+			{
+				for (size_t r = 0; r < ROWCNT; ++r)
+				{
+					tmpL[OFFSET + (b * ROWCNT) + r] = Omegas[(r * BLKCNT) + b];
+				}
+			}
+		}
+
+		return tmpL;
+	}
+
 	template <typename Vector>
 	inline static Vector LdDecode(Vector &X0, Vector &X1, Vector &X2, Vector &X3, const int Q)
 	{
@@ -420,13 +516,292 @@ private:
 		return tmpT;
 	}
 
+	template <typename Vector>
+	inline static Vector MontgomeryReduceV(Vector &A)
+	{
+		// QINV = 2^13 + 2^12 - 1, and Q = 2^13 + 2^12 + 1; the products are identical modulo 2^32
+		Vector u = ((A << 13) + (A << 12)) - A;
+		u &= Vector((1 << RLOG) - 1);
+		u = (u << 13) + (u << 12) + u;
+
+		return (A + u) >> 18;
+	}
+
+	template <typename Vector, typename ArrayA, typename ArrayB>
+	inline static void Multiply(ArrayA &Poly, const ArrayB &Factors)
+	{
+		const size_t VCTSZE = Vector::size() / sizeof(uint);
+		Vector a, f;
+
+		for (size_t i = 0; i < Poly.size(); i += VCTSZE)
+		{
+			a.LoadUS(Poly, i);
+			f.LoadUS(Factors, i);
+			a *= f;
+			MontgomeryReduceV(a).StoreUS(Poly, i);
+		}
+	}
+
+	template <typename Vector, typename Array>
+	inline static void NTT(Array &A, bool Inverse)
+	{
+		// Layers with a distance smaller than the vector width pair coefficients within a single register.
+		// Those layers are processed on a transposed copy of the polynomial, where a lane holds a row of VCTSZE coefficients,
+		// so that every butterfly operates on whole registers; the remaining layers run on a copy in natural order.
+		// Each even and odd layer pair is merged into a single pass over four registers, and the copies hold 32bit 
+		// coefficients, so that a register is only narrowed to 16 bits once, when the result is written to A.
+		const size_t VCTSZE = Vector::size() / sizeof(uint);
+		const size_t ROWCNT = N / VCTSZE;
+		// the lane ordered omegas are created once for each register width
+		static const std::vector<uint> FWDLANES = LaneOmegas<Vector>(OmegasMontgomery);
+		static const std::vector<uint> INVLANES = LaneOmegas<Vector>(OmegasInvMontgomery);
+		const ushort* omegas = Inverse ? OmegasInvMontgomery : OmegasMontgomery;
+		const std::vector<uint> &lanes = Inverse ? INVLANES : FWDLANES;
+		const ushort* order = Utility::PolyMath::BitReverseIndex();
+		std::array<uint, N> tmpT;
+		std::array<uint, N> tmpU;
+		Vector a;
+		size_t dist = 1;
+		bool split;
+
+		// the input of the inverse transform is in bit reversed order; the reversal is folded into the transposition
+		for (size_t c = 0, k = 0; c < VCTSZE; ++c)
+		{
+			for (size_t r = 0; r < ROWCNT; ++r, ++k)
+			{
+				tmpT[k] = Inverse ? A[order[(r * VCTSZE) + c]] : A[(r * VCTSZE) + c];
+			}
+		}
+
+		for (; 2 * dist < VCTSZE; dist <<= 2)
+		{
+			NTTMergeT<Vector>(tmpT, lanes, dist);
+		}
+
+		// the even layer is within a register, the odd layer is not
+		split = (dist < VCTSZE);
+
+		if (split)
+		{
+			NTTLayerT<Vector>(tmpT, lanes, dist, false);
+		}
+
+		for (size_t r = 0, k = 0; r < ROWCNT; ++r)
+		{
+			for (size_t c = 0; c < VCTSZE; ++c, ++k)
+			{
+				tmpU[k] = tmpT[(c * ROWCNT) + r];
+			}
+		}
+
+		if (split)
+		{
+			NTTLayer<Vector>(tmpU, omegas, 2 * dist, true);
+			dist <<= 2;
+		}
+
+		for (; dist < N; dist <<= 2)
+		{
+			NTTMerge<Vector>(tmpU, omegas, dist);
+		}
+
+		for (size_t i = 0; i < N; i += VCTSZE)
+		{
+			a.Load(tmpU, i);
+			a.StoreUS(A, i);
+		}
+	}
+
+	template <typename Vector>
+	inline static void NTTEvenDistV(Vector &A, Vector &B, const Vector &Omega)
+	{
+		Vector tmpW = Omega * ((A + Vector(3 * Q)) - B);
+		A = (A + B) & Vector(0xFFFF);
+		B = MontgomeryReduceV(tmpW);
+	}
+
+	template <typename Vector>
+	inline static void NTTLayer(std::array<uint, N> &A, const ushort* Omegas, size_t Dist, bool Odd)
+	{
+		const size_t VCTSZE = Vector::size() / sizeof(uint);
+		Vector a0, a1;
+
+		for (size_t i = 0, k = 0; i < N / (2 * Dist); ++i)
+		{
+			const Vector W0(Omegas[i]);
+
+			for (size_t j = 0; j < Dist; j += VCTSZE)
+			{
+				k = (i * 2 * Dist) + j;
+				a0.Load(A, k);
+				a1.Load(A, k + Dist);
+
+				if (Odd)
+				{
+					NTTOddDistV(a0, a1, W0);
+				}
+				else
+				{
+					NTTEvenDistV(a0, a1, W0);
+				}
+
+				a0.Store(A, k);
+				a1.Store(A, k + Dist);
+			}
+		}
+	}
+
+	template <typename Vector>
+	inline static void NTTLayerT(std::array<uint, N> &T, const std::vector<uint> &Lanes, size_t Dist, bool Odd)
+	{
+		// T holds the transposed polynomial; coefficient (r * VCTSZE) + c is stored at (c * ROWCNT) + r
+		const size_t VCTSZE = Vector::size() / sizeof(uint);
+		const size_t ROWCNT = N / VCTSZE;
+		const size_t OFFSET = N - (N / Dist);
+		Vector a0, a1, w0;
+
+		for (size_t r = 0; r < ROWCNT; r += VCTSZE)
+		{
+			for (size_t c = 0, b = 0; c < VCTSZE; c += 2 * Dist, ++b)
+			{
+				// every lane is a different row, and a different omega
+				w0.Load(Lanes, OFFSET + (b * ROWCNT) + r);
+
+				for (size_t j = c; j < c + Dist; ++j)
+				{
+					a0.Load(T, (j * ROWCNT) + r);
+					a1.Load(T, ((j + Dist) * ROWCNT) + r);
+
+					if (Odd)
+					{
+						NTTOddDistV(a0, a1, w0);
+					}
+					else
+					{
+						NTTEvenDistV(a0, a1, w0);
+					}
+
+					a0.Store(T, (j * ROWCNT) + r);
+					a1.Store(T, ((j + Dist) * ROWCNT) + r);
+				}
+			}
+		}
+	}
+
+	template <typename Vector>
+	inline static void NTTMerge(std::array<uint, N> &A, const ushort* Omegas, size_t Dist)
+	{
+		// an even layer at Dist and the odd layer at 2 * Dist, over groups of four registers
+		const size_t VCTSZE = Vector::size() / sizeof(uint);
+		Vector a0, a1, a2, a3;
+
+		for (size_t i = 0, k = 0; i < N / (4 * Dist); ++i)
+		{
+			const Vector W0(Omegas[2 * i]);
+			const Vector W1(Omegas[(2 * i) + 1]);
+			const Vector W2(Omegas[i]);
+
+			for (size_t j = 0; j < Dist; j += VCTSZE)
+			{
+				k = (i * 4 * Dist) + j;
+				a0.Load(A, k);
+				a1.Load(A, k + Dist);
+				a2.Load(A, k + (2 * Dist));
+				a3.Load(A, k + (3 * Dist));
+
+				NTTEvenDistV(a0, a1, W0);
+				NTTEvenDistV(a2, a3, W1);
+				NTTOddDistV(a0, a2, W2);
+				NTTOddDistV(a1, a3, W2);
+
+				a0.Store(A, k);
+				a1.Store(A, k + Dist);
+				a2.Store(A, k + (2 * Dist));
+				a3.Store(A, k + (3 * Dist));
+			}
+		}
+	}
+
+	template <typename Vector>
+	inline static void NTTMergeT(std::array<uint, N> &T, const std::vector<uint> &Lanes, size_t Dist)
+	{
+		const size_t VCTSZE = Vector::size() / sizeof(uint);
+		const size_t ROWCNT = N / VCTSZE;
+		const size_t EVNOFF = N - (N / Dist);
+		const size_t ODDOFF = N - (N / (2 * Dist));
+		Vector a0, a1, a2, a3, w0, w1, w2;
+
+		for (size_t r = 0; r < ROWCNT; r += VCTSZE)
+		{
+			for (size_t c = 0, g = 0; c < VCTSZE; c += 4 * Dist, ++g)
+			{
+				w0.Load(Lanes, EVNOFF + (2 * g * ROWCNT) + r);
+				w1.Load(Lanes, EVNOFF + (((2 * g) + 1) * ROWCNT) + r);
+				w2.Load(Lanes, ODDOFF + (g * ROWCNT) + r);
+
+				for (size_t j = c; j < c + Dist; ++j)
+				{
+					a0.Load(T, (j * ROWCNT) + r);
+					a1.Load(T, ((j + Dist) * ROWCNT) + r);
+					a2.Load(T, ((j + (2 * Dist)) * ROWCNT) + r);
+					a3.Load(T, ((j + (3 * Dist)) * ROWCNT) + r);
+
+					NTTEvenDistV(a0, a1, w0);
+					NTTEvenDistV(a2, a3, w1);
+					NTTOddDistV(a0, a2, w2);
+					NTTOddDistV(a1, a3, w2);
+
+					a0.Store(T, (j * ROWCNT) + r);
+					a1.Store(T, ((j + Dist) * ROWCNT) + r);
+					a2.Store(T, ((j + (2 * Dist)) * ROWCNT) + r);
+					a3.Store(T, ((j + (3 * Dist)) * ROWCNT) + r);
+				}
+			}
+		}
+	}
+
+	template <typename Vector>
+	inline static void NTTOddDistV(Vector &A, Vector &B, const Vector &Omega)
+	{
+		Vector tmpW = Omega * ((A + Vector(3 * Q)) - B);
+		Vector tmpB = (A + B) & Vector(0xFFFF);
+		A = BarrettReduceV(tmpB);
+		B = MontgomeryReduceV(tmpW);
+	}
+
+	template <typename Vector, typename ArrayR, typename ArrayA, typename ArrayB>
+	inline static void Pointwise(ArrayR &R, const ArrayA &A, const ArrayB &B)
+	{
+		const size_t VCTSZE = Vector::size() / sizeof(uint);
+		const Vector FACTOR(3186);
+		Vector a, t;
+
+		for (size_t i = 0; i < N; i += VCTSZE)
+		{
+			t.LoadUS(B, i);
+			t *= FACTOR;
+			t = MontgomeryReduceV(t);
+			a.LoadUS(A, i);
+			a *= t;
+			MontgomeryReduceV(a).StoreUS(R, i);
+		}
+	}
+
 	template <typename ArrayR, typename ArrayA, typename ArrayB>
 	inline static void PolyAdd(ArrayR &R, const ArrayA &A, const ArrayB &B)
 	{
+#if defined(__AVX512__)
+		Add<Numeric::UInt512, ArrayR, ArrayA, ArrayB>(R, A, B);
+#elif defined(__AVX2__)
+		Add<Numeric::UInt256, ArrayR, ArrayA, ArrayB>(R, A, B);
+#elif defined(__AVX__)
+		Add<Numeric::UInt128, ArrayR, ArrayA, ArrayB>(R, A, B);
+#else
 		for (size_t i = 0; i < R.size(); ++i)
 		{
 			R[i] = BarrettReduce(A[i] + B[i]);
 		}
+#endif
 	}
 
 	template <typename ArrayA, typename ArrayB>
@@ -446,15 +821,30 @@ private:
 	template <typename ArrayA, typename ArrayB>
 	inline static void PolyMul(ArrayA &Poly, const ArrayB &Factors)
 	{
+#if defined(__AVX512__)
+		Multiply<Numeric::UInt512, ArrayA, ArrayB>(Poly, Factors);
+#elif defined(__AVX2__)
+		Multiply<Numeric::UInt256, ArrayA, ArrayB>(Poly, Factors);
+#elif defined(__AVX__)
+		Multiply<Numeric::UInt128, ArrayA, ArrayB>(Poly, Factors);
+#else
 		for (size_t i = 0; i < Poly.size(); ++i)
 		{
 			Poly[i] = MontgomeryReduce((Poly[i] * Factors[i]));
 		}
+#endif
 	}
 
 	template <typename ArrayA, typename ArrayB, typename ArrayC>
 	inline static void PolyPointwise(ArrayA &R, const ArrayB &A, const ArrayC &B)
 	{
+#if defined(__AVX512__)
+		Pointwise<Numeric::UInt512, ArrayA, ArrayB, ArrayC>(R, A, B);
+#elif defined(__AVX2__)
+		Pointwise<Numeric::UInt256, ArrayA, ArrayB, ArrayC>(R, A, B);
+#elif defined(__AVX__)
+		Pointwise<Numeric::UInt128, ArrayA, ArrayB, ArrayC>(R, A, B);
+#else
 		ushort t;
 
 		for (size_t i = 0; i < N; i++)
@@ -464,6 +854,7 @@ private:
 			// R[i] is back in normal domain
 			R[i] = MontgomeryReduce(A[i] * t);
 		}
+#endif
 	}
 
 	template <typename Vector, typename ArrayA, typename ArrayB>
@@ -531,10 +922,18 @@ private:
 	static void DecodeB(std::array<ushort, N> &B, std::array<ushort, N> &C, const std::vector<byte> &R);
 	static void EncodeA(std::vector<byte> &R, const std::array<ushort, N> &PubKey, const std::vector<byte> &Seed);
 	static void EncodeB(std::vector<byte> &R, const std::array<ushort, N> &B, const std::array<ushort, N> &C);
+	static void Encrypt(std::vector<byte> &Secret, std::vector<byte> &Send, const std::array<ushort, N> &PubKey, const std::vector<ushort> &A, std::vector<uint> &Noise1, std::vector<uint> &Noise2, std::vector<uint> &Noise3, std::vector<byte> &Random, bool Parallel);
 	static void FromBytes(std::array<ushort, N> &R, const std::vector<byte> &A);
-	static void PolyUniform(std::array<ushort, N> &A, const std::vector<byte> &Seed, bool Parallel);
+	static void Generate(std::vector<byte> &PubKey, std::vector<ushort> &PriKey, std::vector<ushort> &A, std::vector<uint> &Noise1, std::vector<uint> &Noise2, std::vector<byte> &Seed, bool Parallel);
+	static void PolyUniform(std::vector<ushort> &A, const std::vector<byte> &Seed);
 	static void RecHelper(std::array<ushort, N> &C, const std::array<ushort, N> &V, std::vector<byte> &Random);
 	static void Reconcile(std::vector<byte> &Key, const std::array<ushort, N> &V, const std::array<ushort, N> &C);
+#if defined(__AVX__)
+	static size_t RejectUniform(std::vector<ushort> &A, size_t Count, const std::array<byte, UNIFORM_SIZE> &Stream);
+#	if !defined(__AVX512__)
+	static const byte* RejectIndex();
+#	endif
+#endif
 	static void ToBytes(std::vector<byte> &R, const std::array<ushort, N> &Poly);
 };
 
@@ -1,380 +1,532 @@
 #include "FFTQ40961N1024.h"
 #include "BCG.h"
-#include <future>
+#include "CpuDetect.h"
+#include "IntUtils.h"
 #include "MemUtils.h"
-#include "PFMQ40961N1024.h"
-#include "PolyMath.h"
-
-#if defined(__AVX512__)
-#	include "UInt512.h"
-#elif defined(__AVX2__)
-#	include "UInt256.h"
-#elif defined(__AVX__)
-#	include "UInt128.h"
-#endif
+#include "ParallelUtils.h"
 
 NAMESPACE_RINGLWE
 
-// *** NOTE: This a non-functioning prototype and not to be used! *** //
-
 //~~~Constant Tables~~~//
 
 const std::string FFTQ40961N1024::Name = "Q40961N1024";
 
-const std::vector<ushort> FFTQ40961N1024::OmegasMontgomery = {}; // TODO: ?
-
-const std::vector<ushort> FFTQ40961N1024::OmegasInvMontgomery = {}; // TODO: ?
-
-const std::vector<ushort> FFTQ40961N1024::PsisBitrevMontgomery = {}; // TODO: ?
-
-const std::vector<ushort> FFTQ40961N1024::PsisInvMontgomery = {}; // TODO: ?
+// psi = 20237, a primitive 2048th root of unity; Zetas[k] = psi^brv(k) * 2^16 mod Q, ZetasInv[k] = psi^-brv(k) * 2^16 mod Q
+const ushort FFTQ40961N1024::Zetas[1024] =
+{
+	24575, 1311, 6659, 37676, 13688, 7709, 9006, 3929, 1076, 39975, 7052, 17749, 11045, 38225, 5693, 40693,
+	34099, 654, 39690, 32761, 7297, 16687, 18740, 25768, 27063, 10756, 15047, 25726, 28568, 21787, 13338, 38484,
+	25771, 24883, 5818, 15073, 22158, 252, 35586, 36674, 15986, 39712, 19651, 1255, 8549, 35335, 30600, 36218,
+	2358, 3321, 27179, 18111, 21083, 15779, 19252, 15858, 11724, 39963, 11209, 6250, 14669, 18002, 37667, 26316,
+	16061, 24340, 19838, 16996, 22300, 17024, 28294, 10770, 33162, 15750, 12231, 39270, 35937, 20440, 19150, 7272,
+	36413, 19547, 24706, 21976, 36151, 19178, 39891, 6310, 27416, 23604, 15381, 8061, 39767, 5510, 23238, 16469,
+	32517, 16874, 18815, 10396, 24177, 30455, 14405, 29512, 25972, 39393, 24342, 13021, 22965, 19993, 40875, 19265,
+	36280, 10761, 30382, 20277, 27058, 19973, 20496, 100, 14456, 33805, 7644, 24211, 31140, 23846, 20297, 14672,
+	19004, 14258, 23899, 2235, 35950, 4668, 21367, 8362, 40603, 37330, 5115, 33000, 31576, 14767, 28484, 29173,
+	31976, 14705, 2174, 31203, 23839, 30917, 38685, 1172, 665, 2969, 12581, 8495, 4504, 36986, 15053, 31050,
+	26981, 6263, 38873, 31454, 33741, 37984, 3844, 24800, 21481, 27596, 11506, 24022, 22052, 15424, 36414, 34088,
+	10179, 20746, 15549, 34250, 1741, 1983, 19633, 26244, 15590, 16016, 8833, 27918, 37527, 38626, 6730, 5101,
+	11330, 4388, 22788, 26779, 26537, 21897, 23020, 528, 40282, 39223, 35445, 34443, 33344, 40708, 2308, 13569,
+	32272, 17936, 40050, 24513, 31141, 38387, 11015, 11605, 6410, 21535, 18713, 1810, 9229, 10653, 26834, 39669,
+	21082, 1238, 28534, 18925, 35734, 17809, 19190, 15458, 35822, 27626, 21594, 32289, 12992, 4540, 38401, 8589,
+	34981, 5023, 4205, 31093, 39572, 37285, 30944, 119, 7372, 1315, 18927, 548, 12480, 14450, 39309, 22375,
+	11631, 39363, 14254, 4754, 32025, 30877, 38888, 3803, 22184, 9669, 40020, 38854, 29154, 22925, 21899, 2545,
+	22674, 7545, 38511, 10620, 15226, 7061, 28679, 38359, 30188, 25632, 9185, 26225, 765, 23434, 26484, 29483,
+	21671, 5038, 9249, 14746, 35042, 31843, 11457, 7850, 28849, 11708, 26600, 36838, 27791, 28666, 16316, 4844,
+	31713, 40756, 26641, 18604, 20949, 33413, 34210, 17226, 34169, 35460, 4365, 22876, 22862, 37827, 13857, 7478,
+	21259, 35413, 24060, 8559, 37056, 30302, 36686, 16023, 19192, 3579, 40206, 40054, 25089, 20483, 28148, 17756,
+	26071, 4356, 6566, 37076, 36201, 8930, 26362, 16804, 19041, 19782, 8153, 11639, 6142, 15842, 7668, 4546,
+	2544, 4521, 21089, 21103, 27332, 30990, 16810, 19923, 9522, 11222, 10634, 1219, 10719, 8374, 511, 16510,
+	14954, 25126, 13801, 12402, 30694, 10398, 23008, 30841, 19841, 19658, 37455, 15699, 2629, 11676, 10378, 6174,
+	34731, 15302, 30889, 19584, 7389, 2746, 24977, 30331, 11653, 31577, 14855, 19202, 7659, 37521, 17458, 21461,
+	8140, 27411, 17565, 20830, 36961, 620, 17334, 20661, 14624, 19033, 4786, 487, 27535, 33621, 16770, 11737,
+	22102, 5176, 22885, 3621, 34327, 39122, 12405, 29822, 5248, 825, 31654, 2057, 37577, 28378, 34162, 15595,
+	26679, 38669, 15728, 15585, 36808, 28702, 3845, 39341, 19771, 25813, 31819, 25584, 28025, 31497, 15261, 24464,
+	312, 31082, 12247, 26160, 34266, 12302, 5153, 12104, 35946, 28426, 17534, 20630, 17158, 1027, 36773, 11299,
+	27338, 36314, 2079, 1521, 10720, 22915, 32190, 13443, 6684, 32552, 15027, 21633, 40897, 11479, 20594, 32444,
+	12858, 22174, 12398, 9957, 21056, 32782, 24100, 16745, 36727, 38750, 18389, 1041, 12346, 32084, 13306, 23743,
+	31722, 7781, 25025, 31962, 25876, 36131, 14272, 20726, 7636, 30766, 26139, 10080, 6815, 12256, 27915, 29466,
+	16774, 28940, 37454, 1158, 25774, 27545, 18933, 5872, 24721, 35286, 3200, 40465, 34449, 10840, 26909, 24297,
+	32457, 4595, 2281, 30572, 4984, 12335, 24442, 33486, 25361, 2418, 2065, 2752, 7062, 40276, 29077, 9215,
+	12275, 23698, 16952, 36695, 11379, 20560, 18541, 40340, 39665, 37885, 27899, 1615, 27810, 18218, 3802, 28493,
+	40242, 31037, 38076, 34240, 6895, 28628, 22653, 29872, 12476, 38208, 35476, 34643, 12186, 40301, 23830, 22931,
+	922, 12555, 2845, 39496, 17763, 32678, 32820, 39970, 35331, 15209, 32385, 22629, 35475, 20102, 6529, 31552,
+	1491, 12262, 5356, 14735, 24327, 40672, 14779, 20033, 847, 27927, 2658, 23755, 4012, 10028, 35126, 24457,
+	8064, 28242, 26660, 8156, 31765, 18629, 35509, 22964, 24773, 13159, 12068, 3864, 40160, 26544, 20941, 39968,
+	13396, 21681, 15924, 39312, 6098, 31414, 6466, 16611, 2610, 22124, 22892, 23486, 36156, 9961, 34442, 31936,
+	1119, 9862, 17536, 8751, 11829, 10250, 19663, 11903, 5251, 3487, 3808, 33817, 11912, 29284, 27516, 3108,
+	37395, 3420, 3124, 335, 32146, 29015, 21713, 1345, 22397, 34827, 29082, 40959, 9223, 5329, 604, 17110,
+	4367, 10997, 16896, 658, 37708, 8082, 6089, 23428, 32865, 38939, 24598, 8066, 37190, 12668, 21728, 14655,
+	40515, 27513, 2711, 16169, 6157, 29152, 32282, 40463, 13208, 32360, 40578, 1493, 16959, 15599, 40646, 7217,
+	26493, 37469, 21818, 12593, 30559, 13491, 6287, 35276, 21973, 13593, 32394, 30615, 31975, 164, 11456, 34270,
+	6280, 15411, 37504, 31871, 15432, 12354, 793, 20972, 36644, 19716, 10536, 9836, 26074, 7018, 19681, 27875,
+	27619, 26235, 15341, 40836, 23464, 25855, 37750, 4389, 2036, 31634, 25830, 22621, 31406, 457, 8945, 18070,
+	22495, 26210, 20588, 27120, 31014, 34925, 1960, 32465, 7202, 27966, 40349, 30406, 33195, 4071, 33613, 19981,
+	14641, 20464, 10836, 30270, 4983, 38755, 33724, 36553, 5048, 856, 3848, 1042, 28215, 8939, 13004, 15188,
+	8616, 26518, 23121, 35534, 19920, 21489, 514, 19172, 22202, 25641, 36788, 24609, 39008, 28361, 22984, 9545,
+	27561, 2077, 21204, 13917, 28122, 8339, 16049, 13692, 80, 16372, 35699, 406, 11937, 24160, 271, 8355,
+	39994, 29437, 5235, 16597, 39524, 35654, 25909, 24452, 15412, 8261, 22589, 390, 3799, 25831, 5103, 22352,
+	5000, 40186, 39774, 25375, 29245, 35404, 37418, 10175, 37263, 9175, 40479, 36530, 14498, 30112, 27410, 18280,
+	21147, 4300, 39619, 24375, 12152, 37439, 11730, 4326, 12590, 16481, 1353, 12693, 19980, 33768, 17048, 39957,
+	35912, 25564, 5434, 2025, 21301, 31720, 2865, 2628, 16170, 11830, 32125, 10381, 31908, 8981, 18935, 34954,
+	4230, 25969, 18739, 11227, 21874, 7669, 9209, 6560, 22595, 5714, 34491, 7147, 35695, 24164, 12539, 12188,
+	1448, 1414, 35833, 23733, 23543, 27686, 809, 7862, 9284, 32149, 7856, 34828, 39720, 18420, 8921, 37735,
+	24999, 22545, 3347, 7059, 31897, 12874, 39115, 27730, 2663, 14538, 22478, 24779, 33312, 25967, 12605, 29791,
+	25015, 9435, 18679, 39909, 17900, 17706, 30977, 29401, 32864, 24398, 33880, 11133, 4784, 12366, 37597, 32471,
+	36943, 25609, 20566, 34906, 7711, 15394, 26326, 25821, 39640, 2048, 14183, 37329, 36880, 10668, 31878, 23322,
+	5950, 9318, 28489, 19956, 12273, 35577, 35516, 1868, 12803, 678, 31376, 14798, 49, 16172, 36714, 13561,
+	19840, 5117, 5776, 18766, 11184, 11374, 26247, 23990, 10886, 20022, 6935, 36814, 15584, 10692, 23564, 5359,
+	23074, 7483, 12201, 12650, 33950, 4978, 30034, 39173, 6954, 26366, 7508, 12763, 24863, 11097, 36869, 14561,
+	17322, 10013, 30082, 40804, 7188, 29197, 6453, 32383, 24840, 4342, 4589, 3180, 40429, 5817, 22704, 34165
+};
+
+const ushort FFTQ40961N1024::ZetasInv[1024] =
+{
+	24575, 39650, 3285, 34302, 37032, 31955, 33252, 27273, 268, 35268, 2736, 29916, 23212, 33909, 986, 39885,
+	2477, 27623, 19174, 12393, 15235, 25914, 30205, 13898, 15193, 22221, 24274, 33664, 8200, 1271, 40307, 6862,
+	14645, 3294, 22959, 26292, 34711, 29752, 998, 29237, 25103, 21709, 25182, 19878, 22850, 13782, 37640, 38603,
+	4743, 10361, 5626, 32412, 39706, 21310, 1249, 24975, 4287, 5375, 40709, 18803, 25888, 35143, 16078, 15190,
+	26289, 20664, 17115, 9821, 16750, 33317, 7156, 26505, 40861, 20465, 20988, 13903, 20684, 10579, 30200, 4681,
+	21696, 86, 20968, 17996, 27940, 16619, 1568, 14989, 11449, 26556, 10506, 16784, 30565, 22146, 24087, 8444,
+	24492, 17723, 35451, 1194, 32900, 25580, 17357, 13545, 34651, 1070, 21783, 4810, 18985, 16255, 21414, 4548,
+	33689, 21811, 20521, 5024, 1691, 28730, 25211, 7799, 30191, 12667, 23937, 18661, 23965, 21123, 16621, 24900,
+	18586, 1652, 26511, 28481, 40413, 22034, 39646, 33589, 40842, 10017, 3676, 1389, 9868, 36756, 35938, 5980,
+	32372, 2560, 36421, 27969, 8672, 19367, 13335, 5139, 25503, 21771, 23152, 5227, 22036, 12427, 39723, 19879,
+	1292, 14127, 30308, 31732, 39151, 22248, 19426, 34551, 29356, 29946, 2574, 9820, 16448, 911, 23025, 8689,
+	27392, 38653, 253, 7617, 6518, 5516, 1738, 679, 40433, 17941, 19064, 14424, 14182, 18173, 36573, 29631,
+	35860, 34231, 2335, 3434, 13043, 32128, 24945, 25371, 14717, 21328, 38978, 39220, 6711, 25412, 20215, 30782,
+	6873, 4547, 25537, 18909, 16939, 29455, 13365, 19480, 16161, 37117, 2977, 7220, 9507, 2088, 34698, 13980,
+	9911, 25908, 3975, 36457, 32466, 28380, 37992, 40296, 39789, 2276, 10044, 17122, 9758, 38787, 26256, 8985,
+	11788, 12477, 26194, 9385, 7961, 35846, 3631, 358, 32599, 19594, 36293, 5011, 38726, 17062, 26703, 21957,
+	11495, 13046, 28705, 34146, 30881, 14822, 10195, 33325, 20235, 26689, 4830, 15085, 8999, 15936, 33180, 9239,
+	17218, 27655, 8877, 28615, 39920, 22572, 2211, 4234, 24216, 16861, 8179, 19905, 31004, 28563, 18787, 28103,
+	8517, 20367, 29482, 64, 19328, 25934, 8409, 34277, 27518, 8771, 18046, 30241, 39440, 38882, 4647, 13623,
+	29662, 4188, 39934, 23803, 20331, 23427, 12535, 5015, 28857, 35808, 28659, 6695, 14801, 28714, 9879, 40649,
+	16497, 25700, 9464, 12936, 15377, 9142, 15148, 21190, 1620, 37116, 12259, 4153, 25376, 25233, 2292, 14282,
+	25366, 6799, 12583, 3384, 38904, 9307, 40136, 35713, 11139, 28556, 1839, 6634, 37340, 18076, 35785, 18859,
+	29224, 24191, 7340, 13426, 40474, 36175, 21928, 26337, 20300, 23627, 40341, 4000, 20131, 23396, 13550, 32821,
+	19500, 23503, 3440, 33302, 21759, 26106, 9384, 29308, 10630, 15984, 38215, 33572, 21377, 10072, 25659, 6230,
+	34787, 30583, 29285, 38332, 25262, 3506, 21303, 21120, 10120, 17953, 30563, 10267, 28559, 27160, 15835, 26007,
+	24451, 40450, 32587, 30242, 39742, 30327, 29739, 31439, 21038, 24151, 9971, 13629, 19858, 19872, 36440, 38417,
+	36415, 33293, 25119, 34819, 29322, 32808, 21179, 21920, 24157, 14599, 32031, 4760, 3885, 34395, 36605, 14890,
+	23205, 12813, 20478, 15872, 907, 755, 37382, 21769, 24938, 4275, 10659, 3905, 32402, 16901, 5548, 19702,
+	33483, 27104, 3134, 18099, 18085, 36596, 5501, 6792, 23735, 6751, 7548, 20012, 22357, 14320, 205, 9248,
+	36117, 24645, 12295, 13170, 4123, 14361, 29253, 12112, 33111, 29504, 9118, 5919, 26215, 31712, 35923, 19290,
+	11478, 14477, 17527, 40196, 14736, 31776, 15329, 10773, 2602, 12282, 33900, 25735, 30341, 2450, 33416, 18287,
+	38416, 19062, 18036, 11807, 2107, 941, 31292, 18777, 37158, 2073, 10084, 8936, 36207, 26707, 1598, 29330,
+	6796, 18257, 35144, 532, 37781, 36372, 36619, 16121, 8578, 34508, 11764, 33773, 157, 10879, 30948, 23639,
+	26400, 4092, 29864, 16098, 28198, 33453, 14595, 34007, 1788, 10927, 35983, 7011, 28311, 28760, 33478, 17887,
+	35602, 17397, 30269, 25377, 4147, 34026, 20939, 30075, 16971, 14714, 29587, 29777, 22195, 35185, 35844, 21121,
+	27400, 4247, 24789, 40912, 26163, 9585, 40283, 28158, 39093, 5445, 5384, 28688, 21005, 12472, 31643, 35011,
+	17639, 9083, 30293, 4081, 3632, 26778, 38913, 1321, 15140, 14635, 25567, 33250, 6055, 20395, 15352, 4018,
+	8490, 3364, 28595, 36177, 29828, 7081, 16563, 8097, 11560, 9984, 23255, 23061, 1052, 22282, 31526, 15946,
+	11170, 28356, 14994, 7649, 16182, 18483, 26423, 38298, 13231, 1846, 28087, 9064, 33902, 37614, 18416, 15962,
+	3226, 32040, 22541, 1241, 6133, 33105, 8812, 31677, 33099, 40152, 13275, 17418, 17228, 5128, 39547, 39513,
+	28773, 28422, 16797, 5266, 33814, 6470, 35247, 18366, 34401, 31752, 33292, 19087, 29734, 22222, 14992, 36731,
+	6007, 22026, 31980, 9053, 30580, 8836, 29131, 24791, 38333, 38096, 9241, 19660, 38936, 35527, 15397, 5049,
+	1004, 23913, 7193, 20981, 28268, 39608, 24480, 28371, 36635, 29231, 3522, 28809, 16586, 1342, 36661, 19814,
+	22681, 13551, 10849, 26463, 4431, 482, 31786, 3698, 30786, 3543, 5557, 11716, 15586, 1187, 775, 35961,
+	18609, 35858, 15130, 37162, 40571, 18372, 32700, 25549, 16509, 15052, 5307, 1437, 24364, 35726, 11524, 967,
+	32606, 40690, 16801, 29024, 40555, 5262, 24589, 40881, 27269, 24912, 32622, 12839, 27044, 19757, 38884, 13400,
+	31416, 17977, 12600, 1953, 16352, 4173, 15320, 18759, 21789, 40447, 19472, 21041, 5427, 17840, 14443, 32345,
+	25773, 27957, 32022, 12746, 39919, 37113, 40105, 35913, 4408, 7237, 2206, 35978, 10691, 30125, 20497, 26320,
+	20980, 7348, 36890, 7766, 10555, 612, 12995, 33759, 8496, 39001, 6036, 9947, 13841, 20373, 14751, 18466,
+	22891, 32016, 40504, 9555, 18340, 15131, 9327, 38925, 36572, 3211, 15106, 17497, 125, 25620, 14726, 13342,
+	13086, 21280, 33943, 14887, 31125, 30425, 21245, 4317, 19989, 40168, 28607, 25529, 9090, 3457, 25550, 34681,
+	6691, 29505, 40797, 8986, 10346, 8567, 27368, 18988, 5685, 34674, 27470, 10402, 28368, 19143, 3492, 14468,
+	33744, 315, 25362, 24002, 39468, 383, 8601, 27753, 498, 8679, 11809, 34804, 24792, 38250, 13448, 446,
+	26306, 19233, 28293, 3771, 32895, 16363, 2022, 8096, 17533, 34872, 32879, 3253, 40303, 24065, 29964, 36594,
+	23851, 40357, 35632, 31738, 2, 11879, 6134, 18564, 39616, 19248, 11946, 8815, 40626, 37837, 37541, 3566,
+	37853, 13445, 11677, 29049, 7144, 37153, 37474, 35710, 29058, 21298, 30711, 29132, 32210, 23425, 31099, 39842,
+	9025, 6519, 31000, 4805, 17475, 18069, 18837, 38351, 24350, 34495, 9547, 34863, 1649, 25037, 19280, 27565,
+	993, 20020, 14417, 801, 37097, 28893, 27802, 16188, 17997, 5452, 22332, 9196, 32805, 14301, 12719, 32897,
+	16504, 5835, 30933, 36949, 17206, 38303, 13034, 40114, 20928, 26182, 289, 16634, 26226, 35605, 28699, 39470,
+	9409, 34432, 20859, 5486, 18332, 8576, 25752, 5630, 991, 8141, 8283, 23198, 1465, 38116, 28406, 40039,
+	18030, 17131, 660, 28775, 6318, 5485, 2753, 28485, 11089, 18308, 12333, 34066, 6721, 2885, 9924, 719,
+	12468, 37159, 22743, 13151, 39346, 13062, 3076, 1296, 621, 22420, 20401, 29582, 4266, 24009, 17263, 28686,
+	31746, 11884, 685, 33899, 38209, 38896, 38543, 15600, 7475, 16519, 28626, 35977, 10389, 38680, 36366, 8504,
+	16664, 14052, 30121, 6512, 496, 37761, 5675, 16240, 35089, 22028, 13416, 15187, 39803, 3507, 12021, 24187
+};
 
 //~~~Public Functions~~~//
 
-void FFTQ40961N1024::DecodeA(std::vector<ushort> &Pk, std::vector<byte> &Seed, const std::vector<byte> &R)
+void FFTQ40961N1024::Decrypt(std::vector<byte> &Secret, const std::vector<ushort> &PriKey, const std::vector<byte> &Received)
 {
-	FromBytes(Pk, R);
-	Utility::MemUtils::Copy(R, POLY_BYTES, Seed, 0, SEED_BYTES);
+	CexAssert(PriKey.size() == N, "The private key is the wrong size");
+	CexAssert(Received.size() >= SENDB_BYTES, "The received message is too small");
+
+	std::array<ushort, N> bp;
+	std::array<ushort, N> v;
+	std::array<ushort, N> w;
+
+	FromBytes(bp, Received);
+	Decompress(v, Received, POLY_BYTES);
+	PolyPointwise(w, PriKey, bp);
+	InvNTT(w);
+	PolySub(v, v, w);
+	MessageDecode(Secret, v);
 }
 
-void FFTQ40961N1024::DecodeB(std::vector<ushort> &B, std::vector<ushort> &C, const std::vector<byte> &R)
+void FFTQ40961N1024::Encrypt(std::vector<std::vector<byte>> &Secret, std::vector<std::vector<byte>> &Send, const std::vector<byte> &Received, const std::vector<ushort> &A, std::unique_ptr<Prng::IPrng> &Rng)
 {
-	FromBytes(B, R);
+	CexAssert(A.size() == N, "The expanded polynomial is the wrong size");
+	CexAssert(Secret.size() == Send.size(), "The secret and message batches are not the same size");
 
-	for (size_t i = 0; i < N / 4; i++)
+	const size_t CNT = Send.size();
+	std::array<ushort, N> pka;
+	std::vector<std::vector<uint>> noise(3 * CNT, std::vector<uint>(N));
+	std::vector<std::vector<byte>> rnd(CNT, std::vector<byte>(SEED_BYTES));
+
+	if (CNT == 0)
 	{
-		C[4 * i + 0] = R[POLY_BYTES + i] & 0x03;
-		C[4 * i + 1] = (R[POLY_BYTES + i] >> 2) & 0x03;
-		C[4 * i + 2] = (R[POLY_BYTES + i] >> 4) & 0x03;
-		C[4 * i + 3] = (R[POLY_BYTES + i] >> 6);
+		return;
 	}
-}
 
-void FFTQ40961N1024::EncodeA(std::vector<byte> &R, const std::vector<ushort> &Pk, const std::vector<byte> &Seed)
-{
-	ToBytes(R, Pk);
-	Utility::MemUtils::Copy(Seed, 0, R, POLY_BYTES, SEED_BYTES);
+	// the recipients key is decoded once for the batch
+	FromBytes(pka, Received);
+
+	// the generator is not shared between threads, so the random for the whole batch is drawn first
+	for (size_t i = 0; i < CNT; ++i)
+	{
+		Rng->Fill(noise[3 * i], 0, N);
+		Rng->Fill(noise[(3 * i) + 1], 0, N);
+		Rng->Fill(noise[(3 * i) + 2], 0, N);
+		Rng->GetBytes(rnd[i]);
+	}
+
+	// each thread processes whole messages; a message is too small to divide between threads
+	const size_t THDCNT = (Utility::ParallelUtils::ProcessorCount() < CNT) ? Utility::ParallelUtils::ProcessorCount() : CNT;
+
+	Utility::ParallelUtils::ParallelFor(0, THDCNT, [&Secret, &Send, &pka, &A, &noise, &rnd, CNT, THDCNT](size_t i)
+	{
+		for (size_t j = i; j < CNT; j += THDCNT)
+		{
+			Encrypt(Secret[j], Send[j], pka, A, noise[3 * j], noise[(3 * j) + 1], noise[(3 * j) + 2], rnd[j], false);
+		}
+	});
 }
 
-void FFTQ40961N1024::EncodeB(std::vector<byte> &R, const std::vector<ushort> &B, const std::vector<ushort> &C)
+void FFTQ40961N1024::Encrypt(std::vector<byte> &Secret, std::vector<byte> &Send, const std::vector<byte> &Received, const std::vector<ushort> &A, std::unique_ptr<Prng::IPrng> &Rng, bool Parallel)
 {
-	ToBytes(R, B);
+	CexAssert(A.size() == N, "The expanded polynomial is the wrong size");
 
-	for (size_t i = 0; i < N / 4; i++)
-		R[POLY_BYTES + i] = C[4 * i] | (C[4 * i + 1] << 2) | (C[4 * i + 2] << 4) | (C[4 * i + 3] << 6);
+	std::array<ushort, N> pka;
+	FromBytes(pka, Received);
+
+	std::vector<uint> buf1(N);
+	Rng->Fill(buf1, 0, N);
+	std::vector<uint> buf2(N);
+	Rng->Fill(buf2, 0, N);
+	std::vector<uint> buf3(N);
+	Rng->Fill(buf3, 0, N);
+	std::vector<byte> seed(SEED_BYTES);
+	Rng->GetBytes(seed);
+
+	Encrypt(Secret, Send, pka, A, buf1, buf2, buf3, seed, Parallel);
 }
 
-void FFTQ40961N1024::GenA(std::vector<ushort> &A, const std::vector<byte> &Seed, bool Parallel)
+void FFTQ40961N1024::Expand(std::vector<ushort> &A, const std::vector<byte> &PubKey)
 {
-	PolyUniform(A, Seed, Parallel);
+	CexAssert(PubKey.size() >= SENDA_BYTES, "The public key is too small");
+
+	std::vector<byte> seed(SEED_BYTES);
+	Utility::MemUtils::Copy(PubKey, POLY_BYTES, seed, 0, SEED_BYTES);
+	A.resize(N);
+	PolyUniform(A, seed);
 }
 
-void FFTQ40961N1024::KeyGen(std::vector<byte> &Send, std::vector<ushort> &Sk, Prng::IPrng* Rng, bool Parallel)
+void FFTQ40961N1024::Generate(std::vector<std::vector<byte>> &PubKey, std::vector<std::vector<ushort>> &PriKey, std::vector<std::vector<ushort>> &A, std::unique_ptr<Prng::IPrng> &Rng)
 {
-	std::vector<ushort> a(N);
-	std::vector<ushort> e(N);
-	std::vector<ushort> r(N);
-	std::vector<ushort> pk(N);
-	std::vector<byte> seed(SEED_BYTES);
-	std::vector<byte> buf1(4 * N);
-	std::vector<byte> buf2(4 * N);
+	CexAssert(PubKey.size() == PriKey.size() && PubKey.size() == A.size(), "The key batches are not the same size");
 
-	Rng->GetBytes(buf1);
-	Rng->GetBytes(buf2);
-	Rng->GetBytes(seed);
+	const size_t CNT = PubKey.size();
+	std::vector<std::vector<uint>> noise(2 * CNT, std::vector<uint>(N));
+	std::vector<std::vector<byte>> seed(CNT, std::vector<byte>(SEED_BYTES));
 
-	if (Parallel)
+	if (CNT == 0)
 	{
-		auto fut1 = std::async(std::launch::async, [&a, &seed, Parallel]()
-		{
-			GenA(a, seed, Parallel);
-		});
-		auto fut2 = std::async(std::launch::async, [&Sk, &buf1]()
-		{
-			PolyGetNoise(Sk, buf1);
-			PolyNTT(Sk);
-		});
-		auto fut3 = std::async(std::launch::async, [&e, &buf2]()
-		{
-			PolyGetNoise(e, buf2);
-			PolyNTT(e);
-		});
-
-		fut1.get();
-		fut2.get();
-		fut3.get();
+		return;
 	}
-	else
+
+	// the generator is not shared between threads, so the random for the whole batch is drawn first
+	for (size_t i = 0; i < CNT; ++i)
 	{
-		GenA(a, seed, Parallel);
+		Rng->Fill(noise[2 * i], 0, N);
+		Rng->Fill(noise[(2 * i) + 1], 0, N);
+		Rng->GetBytes(seed[i]);
+	}
 
-		PolyGetNoise(Sk, buf1);
-		PolyNTT(Sk);
+	// each thread generates whole key-pairs
+	const size_t THDCNT = (Utility::ParallelUtils::ProcessorCount() < CNT) ? Utility::ParallelUtils::ProcessorCount() : CNT;
 
-		PolyGetNoise(e, buf2);
-		PolyNTT(e);
-	}
+	Utility::ParallelUtils::ParallelFor(0, THDCNT, [&PubKey, &PriKey, &A, &noise, &seed, CNT, THDCNT](size_t i)
+	{
+		for (size_t j = i; j < CNT; j += THDCNT)
+		{
+			Generate(PubKey[j], PriKey[j], A[j], noise[2 * j], noise[(2 * j) + 1], seed[j], false);
+		}
+	});
+}
 
-	PolyPointwise(r, Sk, a);
-	PolyAdd(pk, e, r);
-	EncodeA(Send, pk, seed);
+void FFTQ40961N1024::Generate(std::vector<byte> &PubKey, std::vector<ushort> &PriKey, std::vector<ushort> &A, std::unique_ptr<Prng::IPrng> &Rng, bool Parallel)
+{
+	std::vector<uint> buf1(N);
+	Rng->Fill(buf1, 0, N);
+	std::vector<uint> buf2(N);
+	Rng->Fill(buf2, 0, N);
+	std::vector<byte> seed(SEED_BYTES);
+	Rng->GetBytes(seed);
+
+	Generate(PubKey, PriKey, A, buf1, buf2, seed, Parallel);
 }
 
-void FFTQ40961N1024::SharedA(std::vector<byte> &SharedKey, const std::vector<ushort> &Sk, const std::vector<byte> &Received, Digest::IDigest* Digest)
+
+//~~~Private Functions~~~//
+
+void FFTQ40961N1024::Compress(std::vector<byte> &R, size_t Offset, const std::array<ushort, N> &Poly)
 {
-	std::vector<ushort> v(N);
-	std::vector<ushort> bp(N);
-	std::vector<ushort> c(N);
+	// round each coefficient to the nearest multiple of Q / 8, and pack eight to three bytes
+	std::array<uint, 8> t;
 
-	DecodeB(bp, c, Received);
-	PolyPointwise(v, Sk, bp);
-	InvNTT(v);
-	Rec(SharedKey, v, c);
+	for (size_t i = 0; i < N / 8; ++i)
+	{
+		for (size_t j = 0; j < 8; ++j)
+		{
+			t[j] = ((((uint)Poly[(8 * i) + j] << CPRS_BITS) + (Q / 2)) / Q) & ((1 << CPRS_BITS) - 1);
+		}
 
-	Digest->Update(SharedKey, 0, SharedKey.size());
-	Digest->Finalize(SharedKey, 0);
+		R[Offset + (3 * i)] = static_cast<byte>(t[0] | (t[1] << 3) | (t[2] << 6));
+		R[Offset + (3 * i) + 1] = static_cast<byte>((t[2] >> 2) | (t[3] << 1) | (t[4] << 4) | (t[5] << 7));
+		R[Offset + (3 * i) + 2] = static_cast<byte>((t[5] >> 1) | (t[6] << 2) | (t[7] << 5));
+	}
 }
 
-void FFTQ40961N1024::SharedB(std::vector<byte> &SharedKey, std::vector<byte> &Send, const std::vector<byte> &Received, Prng::IPrng *Rng, Digest::IDigest* Digest, bool Parallel)
+void FFTQ40961N1024::Decompress(std::array<ushort, N> &Poly, const std::vector<byte> &R, size_t Offset)
 {
-	std::vector<ushort> sp(N);
-	std::vector<ushort> ep(N);
-	std::vector<ushort> v(N);
-	std::vector<ushort> a(N);
-	std::vector<ushort> pka(N);
-	std::vector<ushort> c(N);
-	std::vector<ushort> epp(N);
-	std::vector<ushort> bp(N);
-	std::vector<ushort> tbp(N);
-	std::vector<byte> seed(SEED_BYTES);
-	std::vector<byte> buf1(4 * N);
-	std::vector<byte> buf2(4 * N);
+	for (size_t i = 0; i < N / 8; ++i)
+	{
+		const uint X = R[Offset + (3 * i)] | ((uint)R[Offset + (3 * i) + 1] << 8) | ((uint)R[Offset + (3 * i) + 2] << 16);
 
-	DecodeA(pka, seed, Received);
-	Rng->GetBytes(buf1);
-	Rng->GetBytes(buf2);
+		for (size_t j = 0; j < 8; ++j)
+		{
+			Poly[(8 * i) + j] = static_cast<ushort>(((((X >> (CPRS_BITS * j)) & 0x07) * Q) + (1 << (CPRS_BITS - 1))) >> CPRS_BITS);
+		}
+	}
+}
 
+void FFTQ40961N1024::Encrypt(std::vector<byte> &Secret, std::vector<byte> &Send, const std::array<ushort, N> &PubKey, const std::vector<ushort> &A, std::vector<uint> &Noise1, std::vector<uint> &Noise2, std::vector<uint> &Noise3, std::vector<byte> &Random, bool Parallel)
+{
+	std::array<ushort, N> bp;
+	std::array<ushort, N> ep;
+	std::array<ushort, N> epp;
+	std::array<ushort, N> m;
+	std::array<ushort, N> sp;
+	std::array<ushort, N> v;
+
+#if defined(_OPENMP)
 	if (Parallel)
 	{
-		auto fut1 = std::async(std::launch::async, [&a, &seed, Parallel]()
-		{
-			GenA(a, seed, Parallel);
-		});
-		auto fut2 = std::async(std::launch::async, [&sp, &buf1]()
+#		pragma omp parallel
 		{
-			PolyGetNoise(sp, buf1);
-			PolyNTT(sp);
-		});
-		auto fut3 = std::async(std::launch::async, [&ep, &buf2]()
-		{
-			PolyGetNoise(ep, buf2);
-			PolyNTT(ep);
-		});
-
-		fut1.get();
-		fut2.get();
-		fut3.get();
+#			pragma omp single nowait
+			{
+				PolyGetNoise(sp, Noise1);
+				FwdNTT(sp);
+			}
+#			pragma omp single nowait
+			{
+				PolyGetNoise(ep, Noise2);
+				FwdNTT(ep);
+			}
+		}
 	}
 	else
+#endif
 	{
-		GenA(a, seed, Parallel);
+		PolyGetNoise(sp, Noise1);
+		FwdNTT(sp);
 
-		PolyGetNoise(sp, buf1);
-		PolyNTT(sp);
-
-		PolyGetNoise(ep, buf2);
-		PolyNTT(ep);
+		PolyGetNoise(ep, Noise2);
+		FwdNTT(ep);
 	}
 
-	PolyPointwise(bp, a, sp);
-	PolyAdd(tbp, bp, ep);
+	// u = a * s' + e', sent in the NTT domain
+	PolyPointwise(bp, A, sp);
+	PolyAdd(bp, bp, ep);
 
-	PolyPointwise(v, pka, sp);
+	// v = b * s' + e'' + encode(m)
+	PolyPointwise(v, PubKey, sp);
 	InvNTT(v);
-	Rng->GetBytes(buf1);
-	PolyGetNoise(epp, buf1);
+	PolyGetNoise(epp, Noise3);
 	PolyAdd(v, v, epp);
+	MessageEncode(m, Random);
+	PolyAdd(v, v, m);
 
-	Rng->GetBytes(seed);
-	HelpRec(c, v, seed);
-	EncodeB(Send, tbp, c);
-	Rec(SharedKey, v, c);
+	ToBytes(Send, bp);
+	Compress(Send, POLY_BYTES, v);
 
-	Digest->Update(SharedKey, 0, SharedKey.size());
-	Digest->Finalize(SharedKey, 0);
+	// the random message is the shared secret
+	Secret.resize(SEED_BYTES);
+	Utility::MemUtils::Copy(Random, 0, Secret, 0, SEED_BYTES);
 }
 
-//~~~Private Functions~~~//
-
-ushort FFTQ40961N1024::BarrettReduce(ushort A)
+void FFTQ40961N1024::FromBytes(std::array<ushort, N> &Poly, const std::vector<byte> &R)
 {
-	uint u = ((uint)A * 5) >> 16;
-	u *= Q;
-	A -= u;
-
-	return A;
-}
-
-void FFTQ40961N1024::FromBytes(std::vector<ushort> &R, const std::vector<byte> &A)
-{
-	for (size_t i = 0; i < R.size() / 4; ++i)
+	// 16 bit coefficients; a value outside the field is reduced
+	for (size_t i = 0; i < N; ++i)
 	{
-		R[4 * i + 0] = A[7 * i + 0] | (((ushort)A[7 * i + 1] & 0x3f) << 8);
-		R[4 * i + 1] = (A[7 * i + 1] >> 6) | (((ushort)A[7 * i + 2]) << 2) | (((ushort)A[7 * i + 3] & 0x0f) << 10);
-		R[4 * i + 2] = (A[7 * i + 3] >> 4) | (((ushort)A[7 * i + 4]) << 4) | (((ushort)A[7 * i + 5] & 0x03) << 12);
-		R[4 * i + 3] = (A[7 * i + 5] >> 2) | (((ushort)A[7 * i + 6]) << 6);
+		Poly[i] = CSub(R[2 * i] | ((uint)R[(2 * i) + 1] << 8));
 	}
 }
 
-void FFTQ40961N1024::FwdNTT(std::vector<ushort> &A, const std::vector<ushort> &Omega)
+void FFTQ40961N1024::Generate(std::vector<byte> &PubKey, std::vector<ushort> &PriKey, std::vector<ushort> &A, std::vector<uint> &Noise1, std::vector<uint> &Noise2, std::vector<byte> &Seed, bool Parallel)
 {
-	// TODO?: this could be vectorized, but would require some unrolling..
-	int i, start, j, jTwiddle, distance;
-	ushort temp, W;
+	std::array<ushort, N> e;
+	std::array<ushort, N> pk;
 
-	// GS_bo_to_no; omegas need to be in Montgomery domain
-	for (i = 0; i < 10; i += 2)
-	{
-		// Even level
-		distance = (1 << i);
+	A.resize(N);
+	PriKey.resize(N);
 
-		for (start = 0; start < distance; start++)
+#if defined(_OPENMP)
+	if (Parallel)
+	{
+#		pragma omp parallel
 		{
-			jTwiddle = 0;
-			for (j = start; j < N - 1; j += 2 * distance)
+#			pragma omp single nowait
 			{
-				W = Omega[jTwiddle++];
-				temp = A[j];
-				A[j] = (temp + A[j + distance]); // Omit reduction (be lazy)
-				A[j + distance] = MontgomeryReduce(W * (((uint)temp + (3 * Q)) - A[j + distance]));
+				PolyUniform(A, Seed);
 			}
-		}
-
-		// Odd level
-		distance <<= 1;
-		for (start = 0; start < distance; start++)
-		{
-			jTwiddle = 0;
-			for (j = start; j < N - 1; j += 2 * distance)
+#			pragma omp single nowait
+			{
+				PolyGetNoise(PriKey, Noise1);
+				FwdNTT(PriKey);
+			}
+#			pragma omp single nowait
 			{
-				W = Omega[jTwiddle++];
-				temp = A[j];
-				A[j] = BarrettReduce((temp + A[j + distance]));
-				A[j + distance] = MontgomeryReduce(W * (((uint)temp + (3 * Q)) - A[j + distance]));
+				PolyGetNoise(e, Noise2);
+				FwdNTT(e);
 			}
 		}
 	}
-	}
-
-void FFTQ40961N1024::HelpRec(std::vector<ushort> &C, const std::vector<ushort> &V, std::vector<byte> &Random)
-{
-#if defined(__AVX512__)
-	PFMQ40961N1024::HelpRec<Numeric::UInt512>(C, V, Random, Q);
-#elif defined(__AVX2__)
-	PFMQ40961N1024::HelpRec<Numeric::UInt256>(C, V, Random, Q);
-#elif defined(__AVX__)
-	PFMQ40961N1024::HelpRec<Numeric::UInt128>(C, V, Random, Q);
-#else
-	PFMQ40961N1024::HelpRec<int>(C, V, Random, Q);
+	else
 #endif
-}
+	{
+		PolyUniform(A, Seed);
 
-void FFTQ40961N1024::InvNTT(std::vector<ushort> &R)
-{
-	Utility::PolyMath::BitReverse(R);
-	FwdNTT(R, OmegasInvMontgomery);
-	PolyMul(R, PsisInvMontgomery);
-}
+		PolyGetNoise(PriKey, Noise1);
+		FwdNTT(PriKey);
 
-ushort FFTQ40961N1024::MontgomeryReduce(uint A)
-{
-	uint u = (A * QINV);
-	u &= ((1 << RLOG) - 1);
-	u *= Q;
-	A = A + u;
+		PolyGetNoise(e, Noise2);
+		FwdNTT(e);
+	}
 
-	return A >> 18;
-}
+	// b = a * s + e, in the NTT domain
+	PolyPointwise(pk, PriKey, A);
+	PolyAdd(pk, pk, e);
 
-void FFTQ40961N1024::PolyAdd(std::vector<ushort> &R, const std::vector<ushort> &A, const std::vector<ushort> &B)
-{
-	for (size_t i = 0; i < R.size(); ++i)
-		R[i] = BarrettReduce(A[i] + B[i]);
+	ToBytes(PubKey, pk);
+	Utility::MemUtils::Copy(Seed, 0, PubKey, POLY_BYTES, SEED_BYTES);
 }
 
-void FFTQ40961N1024::PolyGetNoise(std::vector<ushort> &R, std::vector<byte> &Random)
+void FFTQ40961N1024::MessageDecode(std::vector<byte> &Message, const std::array<ushort, N> &Poly)
 {
-#if defined(__AVX512__)
-	PFMQ40961N1024::GetNoise<Numeric::UInt512>(R, Random, Q);
-#elif defined(__AVX2__)
-	PFMQ40961N1024::GetNoise<Numeric::UInt256>(R, Random, Q);
-#elif defined(__AVX__)
-	PFMQ40961N1024::GetNoise<Numeric::UInt128>(R, Random, Q);
-#else
-	PFMQ40961N1024::GetNoise<uint>(R, Random, Q);
-#endif
-}
+	// each bit is carried by four coefficients; the bit is set when their combined distance from Q / 2 is less than Q
+	Message.resize(SEED_BYTES);
+	Utility::MemUtils::Clear(Message, 0, Message.size());
 
-void FFTQ40961N1024::PolyMul(std::vector<ushort> &Poly, const std::vector<ushort> &Factors)
-{
-	for (size_t i = 0; i < Poly.size(); ++i)
-		Poly[i] = MontgomeryReduce((Poly[i] * Factors[i]));
-}
+	for (size_t i = 0; i < N / 4; ++i)
+	{
+		int t = 0;
 
-void FFTQ40961N1024::PolyNTT(std::vector<ushort> &R)
-{
-	PolyMul(R, PsisBitrevMontgomery);
-	FwdNTT(R, OmegasMontgomery);
+		for (size_t j = 0; j < 4; ++j)
+		{
+			const int D = static_cast<int>(Poly[i + (j * (N / 4))]) - (Q / 2);
+			const int M = D >> 31;
+			t += (D ^ M) - M;
+		}
+
+		const uint BIT = static_cast<uint>(t - Q) >> 31;
+		Message[i >> 3] |= static_cast<byte>(BIT << (i & 7));
+	}
 }
 
-void FFTQ40961N1024::PolyPointwise(std::vector<ushort> &R, const std::vector<ushort> &A, const std::vector<ushort> &B)
+void FFTQ40961N1024::MessageEncode(std::array<ushort, N> &Poly, const std::vector<byte> &Message)
 {
-	ushort t;
-
-	for (size_t i = 0; i < N; i++)
+	for (size_t i = 0; i < N / 4; ++i)
 	{
-		// t is now in Montgomery domain
-		t = MontgomeryReduce(3186 * B[i]); // TODO: ?
-		// R[i] is back in normal domain
-		R[i] = MontgomeryReduce(A[i] * t);
+		const ushort MASK = static_cast<ushort>(0 - (uint)((Message[i >> 3] >> (i & 7)) & 1));
+
+		for (size_t j = 0; j < 4; ++j)
+		{
+			Poly[i + (j * (N / 4))] = MASK & (Q / 2);
+		}
 	}
 }
 
-void FFTQ40961N1024::PolyUniform(std::vector<ushort> &A, const std::vector<byte> &Seed, bool Parallel)
+void FFTQ40961N1024::PolyUniform(std::vector<ushort> &A, const std::vector<byte> &Seed)
 {
-	size_t ctr = 0;
-	size_t pos = 0;
-	ushort val;
-	size_t bufLen = 2 * N * sizeof(ushort);
+	// the public polynomial is sampled in the NTT domain, from the BCG key-stream (aes-128 in counter mode) keyed with the seed
+#if defined(__AVX__)
 
-	// AES128/CTR-BE generator
-	Drbg::BCG eng(Enumeration::BlockCiphers::Rijndael);
+	// avx does not imply aes-ni, the BCG generator is used when it is absent
+	Common::CpuDetect detect;
 
-	if (Parallel)
+	if (detect.AESNI())
 	{
-		if (bufLen >= eng.ParallelProfile().ParallelMinimumSize())
+		// the key-stream is generated with aes-ni in local arrays, the output is identical to the BCG generator
+		std::array<__m128i, 11> rndKey;
+		std::array<byte, UNIFORM_SIZE> buf;
+		ulong ctrHigh = Utility::IntUtils::BeBytesTo64(Seed, 0);
+		ulong ctrLow = Utility::IntUtils::BeBytesTo64(Seed, 8);
+		size_t ctr = 0;
+		ushort val;
+
+		Utility::PolyMath::AesExpand(Seed, rndKey);
+
+		while (ctr < N)
 		{
-			bufLen -= (bufLen % eng.ParallelProfile().ParallelMinimumSize());
-			eng.ParallelProfile().ParallelBlockSize() = bufLen;
+			Utility::PolyMath::AesCtr(rndKey, ctrHigh, ctrLow, buf);
+
+			for (size_t pos = 0; pos < UNIFORM_SIZE && ctr < N; pos += 2)
+			{
+				val = buf[pos] | ((ushort)buf[pos + 1] << 8);
+
+				if (val < Q)
+				{
+					A[ctr++] = val;
+				}
+			}
 		}
+
+		Utility::MemUtils::Clear(rndKey, 0, rndKey.size() * sizeof(__m128i));
+		Utility::MemUtils::Clear(buf, 0, buf.size());
+
+		return;
 	}
-	else
-	{
-		eng.ParallelProfile().IsParallel() = false;
-	}
 
+#endif
+
+	Drbg::BCG eng(Enumeration::BlockCiphers::Rijndael);
+	eng.ParallelProfile().IsParallel() = false;
 	eng.Initialize(Seed);
-	std::vector<byte> buf(bufLen);
+	std::vector<byte> buf(2 * N * sizeof(ushort));
 	eng.Generate(buf, 0, buf.size());
 
+	size_t ctr = 0;
+	size_t pos = 0;
+	ushort val;
+
 	while (ctr < N)
 	{
-		// 0x3fff/16393 - Specialized for q = 12889
-		val = (buf[pos] | ((ushort)buf[pos + 1] << 8)) & 0x3fff; // TODO: ?
+		val = buf[pos] | ((ushort)buf[pos + 1] << 8);
+
 		if (val < Q)
+		{
 			A[ctr++] = val;
+		}
 
 		pos += 2;
+
 		if (pos >= buf.size())
 		{
 			eng.Generate(buf, 0, buf.size());
@@ -383,57 +535,12 @@ void FFTQ40961N1024::PolyUniform(std::vector<ushort> &A, const std::vector<byte>
 	}
 }
 
-void FFTQ40961N1024::Rec(std::vector<byte> &Key, const std::vector<ushort> &V, const std::vector<ushort> &C)
-{
-#if defined(__AVX512__)
-	PFMQ40961N1024::Rec<Numeric::UInt512>(Key, V, C, Q);
-#elif defined(__AVX2__)
-	PFMQ40961N1024::Rec<Numeric::UInt256>(Key, V, C, Q);
-#elif defined(__AVX__)
-	PFMQ40961N1024::Rec<Numeric::UInt128>(Key, V, C, Q);
-#else
-	PFMQ40961N1024::Rec<int>(Key, V, C, Q);
-#endif
-}
-
-void FFTQ40961N1024::ToBytes(std::vector<byte> &R, const std::vector<ushort> &Poly)
+void FFTQ40961N1024::ToBytes(std::vector<byte> &R, const std::array<ushort, N> &Poly)
 {
-	ushort t0, t1, t2, t3, m;
-	short c;
-
-	for (size_t i = 0; i < Poly.size() / 4; i++)
+	for (size_t i = 0; i < N; ++i)
 	{
-		// make sure that coefficients have only 14 bits
-		t0 = BarrettReduce(Poly[4 * i + 0]);
-		t1 = BarrettReduce(Poly[4 * i + 1]);
-		t2 = BarrettReduce(Poly[4 * i + 2]);
-		t3 = BarrettReduce(Poly[4 * i + 3]);
-
-		// make sure that coefficients are in [0,q]
-		m = t0 - Q;
-		c = m;
-		c >>= 15;
-		t0 = m ^ ((t0 ^ m) & c);
-		m = t1 - Q;
-		c = m;
-		c >>= 15;
-		t1 = m ^ ((t1 ^ m) & c);
-		m = t2 - Q;
-		c = m;
-		c >>= 15;
-		t2 = m ^ ((t2 ^ m) & c);
-		m = t3 - Q;
-		c = m;
-		c >>= 15;
-		t3 = m ^ ((t3 ^ m) & c);
-
-		R[7 * i + 0] = t0 & 0xff;
-		R[7 * i + 1] = (t0 >> 8) | (t1 << 6);
-		R[7 * i + 2] = (t1 >> 2);
-		R[7 * i + 3] = (t1 >> 10) | (t2 << 4);
-		R[7 * i + 4] = (t2 >> 4);
-		R[7 * i + 5] = (t2 >> 12) | (t3 << 2);
-		R[7 * i + 6] = (t3 >> 6);
+		R[2 * i] = static_cast<byte>(Poly[i]);
+		R[(2 * i) + 1] = static_cast<byte>(Poly[i] >> 8);
 	}
 }
 
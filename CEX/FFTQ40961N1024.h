@@ -1,26 +1,52 @@
-#ifndef _CEX_FFTQ40961N1024_H
-#define _CEX_FFTQ40961N1024_H
+// The GPL version 3 License (GPLv3)
+//
+// Copyright (c) 2017 vtdev.com
+// This file is part of the CEX Cryptographic library.
+//
+// This program is free software : you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef CEX_FFTQ40961N1024_H
+#define CEX_FFTQ40961N1024_H
 
 #include "CexDomain.h"
-#include "IDigest.h"
 #include "IPrng.h"
+#include "PolyMath.h"
 
 NAMESPACE_RINGLWE
 
-// *** NOTE: This a non-functioning prototype and not to be used! *** //
-// A mathematician with some time on his hands? Good student project?
-// I haven't got around to working this one out yet, so the constant tables 
-// are zeroed in the cpp file, and the reconcilliation methods in 
-// PFMQ40961N1024 need to be updated. 
-// There's a TODO on each item that I see needs updating..
+/**
+* \internal
+*/
 
 /// <summary>
 /// The RingLWE FFT using a modulus of 40961 with 1024 coefficients
+/// <para>The 32 byte secret is encrypted rather than reconciled, each bit is added to four coefficients and decoded by their combined distance from Q / 2;
+/// the public polynomial and the first cipher-text polynomial are sent in the NTT domain as 16 bit coefficients,
+/// and the second cipher-text polynomial is compressed to 3 bits per coefficient.
+/// The NTT is negacyclic over all ten levels, with Montgomery multiplication (R = 2^16) in 32 bit vector lanes.</para>
 /// </summary>
 class FFTQ40961N1024
 {
 public:
 
+	FFTQ40961N1024() = delete;
+	FFTQ40961N1024(const FFTQ40961N1024&) = delete;
+	FFTQ40961N1024& operator=(const FFTQ40961N1024&) = delete;
+	FFTQ40961N1024& operator=(FFTQ40961N1024&&) = delete;
+
+	//~~~Public Properties ~~~//
+
 	/// <summary>
 	/// The number of coefficients
 	/// </summary>
@@ -34,12 +60,12 @@ public:
 	/// <summary>
 	/// The byte size of A's public key polynomial
 	/// </summary>
-	static const size_t POLY_BYTES = 0; // TODO: ?
+	static const size_t POLY_BYTES = 2048;
 
 	/// <summary>
 	/// The byte size of B's encrypted seed array
 	/// </summary>
-	static const size_t RECD_BYTES = 0; // TODO: ?
+	static const size_t RECD_BYTES = 384;
 
 	/// <summary>
 	/// The byte size of the secret seed array
@@ -61,45 +87,447 @@ public:
 	/// </summary>
 	static const std::string Name;
 
-	/**
-	* \internal
-	*/
+	//~~~Public Functions~~~//
 
-	static void DecodeA(std::vector<ushort> &Pk, std::vector<byte> &Seed, const std::vector<byte> &R);
-	static void DecodeB(std::vector<ushort> &B, std::vector<ushort> &C, const std::vector<byte> &R);
-	static void EncodeA(std::vector<byte> &R, const std::vector<ushort> &Pk, const std::vector<byte> &Seed);
-	static void EncodeB(std::vector<byte> &R, const std::vector<ushort> &B, const std::vector<ushort> &C);
-	static void GenA(std::vector<ushort> &A, const std::vector<byte> &Seed, bool Parallel);
-	static void KeyGen(std::vector<byte> &Send, std::vector<ushort> &Sk, Prng::IPrng* Rng, bool Parallel);
-	static void SharedA(std::vector<byte> &SharedKey, const std::vector<ushort> &Sk, const std::vector<byte> &Received, Digest::IDigest* Digest);
-	static void SharedB(std::vector<byte> &SharedKey, std::vector<byte> &Send, const std::vector<byte> &Received, Prng::IPrng *Rng, Digest::IDigest* Digest, bool Parallel);
+	static void Decrypt(std::vector<byte> &Secret, const std::vector<ushort> &PriKey, const std::vector<byte> &Received);
+	static void Encrypt(std::vector<std::vector<byte>> &Secret, std::vector<std::vector<byte>> &Send, const std::vector<byte> &Received, const std::vector<ushort> &A, std::unique_ptr<Prng::IPrng> &Rng);
+	static void Encrypt(std::vector<byte> &Secret, std::vector<byte> &Send, const std::vector<byte> &Received, const std::vector<ushort> &A, std::unique_ptr<Prng::IPrng> &Rng, bool Parallel);
+	static void Expand(std::vector<ushort> &A, const std::vector<byte> &PubKey);
+	static void Generate(std::vector<std::vector<byte>> &PubKey, std::vector<std::vector<ushort>> &PriKey, std::vector<std::vector<ushort>> &A, std::unique_ptr<Prng::IPrng> &Rng);
+	static void Generate(std::vector<byte> &PubKey, std::vector<ushort> &PriKey, std::vector<ushort> &A, std::unique_ptr<Prng::IPrng> &Rng, bool Parallel);
 
 private:
 
-	static const uint QINV = 0;  // TODO: ?
-	static const uint RLOG = 0;  // TODO: ?
-	static const std::vector<ushort> BitrevTable;
-	static const std::vector<ushort> OmegasMontgomery;
-	static const std::vector<ushort> OmegasInvMontgomery;
-	static const std::vector<ushort> PsisBitrevMontgomery;
-	static const std::vector<ushort> PsisInvMontgomery;
-
-	static ushort BarrettReduce(ushort A);
-	static void BitReverse(std::vector<ushort> &Poly);
-	static void FromBytes(std::vector<ushort> &R, const std::vector<byte> &A);
-	static void FwdNTT(std::vector<ushort> &A, const std::vector<ushort> &Omega);
-	static void HelpRec(std::vector<ushort> &C, const std::vector<ushort> &V, std::vector<byte> &Random);
-	static void InvNTT(std::vector<ushort> &R);
-	static ushort MontgomeryReduce(uint A);
-	static void PolyAdd(std::vector<ushort> &R, const std::vector<ushort> &A, const std::vector<ushort> &B);
-	static void PolyGetNoise(std::vector<ushort> &R, std::vector<byte> &Random);
-	static void PolyMul(std::vector<ushort> &Poly, const std::vector<ushort> &Factors);
-	static void PolyNTT(std::vector<ushort> &R);
-	static void PolyPointwise(std::vector<ushort> &R, const std::vector<ushort> &A, const std::vector<ushort> &B);
-	static void PolyUniform(std::vector<ushort> &A, const std::vector<byte> &Seed, bool Parallel);
-	static void Rec(std::vector<byte> &Key, const std::vector<ushort> &V, const std::vector<ushort> &C);
-	static void ToBytes(std::vector<byte> &R, const std::vector<ushort> &Poly);
+	static const uint CPRS_BITS = 3;
+	static const uint MONT_R2 = 1641;
+	static const uint NINV_MONT = 64;
+	static const uint QINV = 40959;
+	static const size_t UNIFORM_SIZE = 128;
+	static const ushort Zetas[N];
+	static const ushort ZetasInv[N];
+
+	//~~~Inlined~~~//
+
+	inline static ushort CSub(uint A)
+	{
+		// A < 2Q; subtract Q, and add it back if the difference is negative
+		A -= Q;
+		A += (0 - (A >> 31)) & Q;
+
+		return static_cast<ushort>(A);
+	}
+
+	inline static ushort MontgomeryReduce(uint A)
+	{
+		// A < 2^16 * Q; the low halves of A and U * Q sum to either 0 or 2^16, so the carry is set when the low half of A is not zero
+		uint u = (A * QINV) & 0xFFFF;
+
+		return CSub((A >> 16) + ((u * Q) >> 16) + (((A & 0xFFFF) + 0xFFFF) >> 16));
+	}
+
+	//~~~Templates~~~//
+
+	template <typename Vector>
+	inline static Vector CSubV(const Vector &A)
+	{
+		Vector tmpA = A - Vector(Q);
+
+		return tmpA + (Vector::ShiftRA(tmpA, 31) & Vector(Q));
+	}
+
+	template <typename Vector>
+	inline static Vector MontgomeryMulV(const Vector &A, const Vector &B)
+	{
+		Vector tmpT = A * B;
+		Vector tmpU = (tmpT * Vector(QINV)) & Vector(0xFFFF);
+		Vector tmpC = ((tmpT & Vector(0xFFFF)) + Vector(0xFFFF)) >> 16;
+
+		return CSubV((tmpT >> 16) + ((tmpU * Vector(Q)) >> 16) + tmpC);
+	}
+
+	template <typename Vector>
+	inline static std::vector<uint> LaneZetas(const ushort* Zetas)
+	{
+		// The zetas of the layers processed on the transposed polynomial, where lane i of a register is row r + i.
+		// The zetas of a layer with distance Dist start at N - (N / Dist), and are ordered by block, then by row.
+		const size_t VCTSZE = Vector::size() / sizeof(uint);
+		const size_t ROWCNT = N / VCTSZE;
+		std::vector<uint> tmpL(N);
+
+		for (size_t dist = 1; dist < VCTSZE; dist <<= 1)
+		{
+			const size_t BLKCNT = VCTSZE / (2 * dist);
+			const size_t OFFSET = N - (N / dist);
+
+			for (size_t b = 0; b < BLKCNT; ++b)
+			{
+				for (size_t r = 0; r < ROWCNT; ++r)
+				{
+					tmpL[OFFSET + (b * ROWCNT) + r] = Zetas[(N / (2 * dist)) + (r * BLKCNT) + b];
+				}
+			}
+		}
+
+		return tmpL;
+	}
+
+	template <typename Vector>
+	inline static void Butterfly(Vector &A0, Vector &A1, const Vector &Zeta, bool Inverse)
+	{
+		if (!Inverse)
+		{
+			// Cooley-Tukey
+			Vector tmpT = MontgomeryMulV(A1, Zeta);
+			A1 = CSubV(A0 + Vector(Q) - tmpT);
+			A0 = CSubV(A0 + tmpT);
+		}
+		else
+		{
+			// Gentleman-Sande
+			Vector tmpT = A0;
+			A0 = CSubV(tmpT + A1);
+			A1 = MontgomeryMulV(CSubV(tmpT + Vector(Q) - A1), Zeta);
+		}
+	}
+
+	template <typename Vector>
+	inline static void NTTLayer(std::array<uint, N> &A, const ushort* Zetas, size_t Dist, bool Inverse)
+	{
+		const size_t VCTSZE = Vector::size() / sizeof(uint);
+		Vector a0, a1;
+
+		for (size_t b = 0; b < N / (2 * Dist); ++b)
+		{
+			const Vector W0(static_cast<uint>(Zetas[(N / (2 * Dist)) + b]));
+
+			for (size_t j = b * 2 * Dist; j < (b * 2 * Dist) + Dist; j += VCTSZE)
+			{
+				a0.Load(A, j);
+				a1.Load(A, j + Dist);
+				Butterfly(a0, a1, W0, Inverse);
+				a0.Store(A, j);
+				a1.Store(A, j + Dist);
+			}
+		}
+	}
+
+	template <typename Vector>
+	inline static void NTTLayerT(std::array<uint, N> &T, const std::vector<uint> &Lanes, size_t Dist, bool Inverse)
+	{
+		// T holds the transposed polynomial; coefficient (r * VCTSZE) + c is stored at (c * ROWCNT) + r
+		const size_t VCTSZE = Vector::size() / sizeof(uint);
+		const size_t ROWCNT = N / VCTSZE;
+		const size_t OFFSET = N - (N / Dist);
+		Vector a0, a1, w0;
+
+		for (size_t r = 0; r < ROWCNT; r += VCTSZE)
+		{
+			for (size_t c = 0, b = 0; c < VCTSZE; c += 2 * Dist, ++b)
+			{
+				// every lane is a different row, and a different zeta
+				w0.Load(Lanes, OFFSET + (b * ROWCNT) + r);
+
+				for (size_t j = c; j < c + Dist; ++j)
+				{
+					a0.Load(T, (j * ROWCNT) + r);
+					a1.Load(T, ((j + Dist) * ROWCNT) + r);
+					Butterfly(a0, a1, w0, Inverse);
+					a0.Store(T, (j * ROWCNT) + r);
+					a1.Store(T, ((j + Dist) * ROWCNT) + r);
+				}
+			}
+		}
+	}
+
+	template <typename Vector, typename Array>
+	inline static void NTT(Array &A, bool Inverse)
+	{
+		// Layers with a distance of at least the vector width run on a 32 bit copy of the polynomial in natural order.
+		// Layers with a smaller distance pair coefficients within a register, so they are processed on a transposed copy,
+		// where a register holds the same column of VCTSZE rows and every butterfly operates on whole registers.
+		// The forward transform runs the wide layers first, the inverse runs the narrow layers first.
+		const size_t VCTSZE = Vector::size() / sizeof(uint);
+		const size_t ROWCNT = N / VCTSZE;
+		// the lane ordered zetas are created once for each register width
+		static const std::vector<uint> FWDLANES = LaneZetas<Vector>(Zetas);
+		static const std::vector<uint> INVLANES = LaneZetas<Vector>(ZetasInv);
+		std::array<uint, N> tmpA;
+		std::array<uint, N> tmpT;
+		Vector a;
+
+		for (size_t i = 0; i < N; i += VCTSZE)
+		{
+			a.LoadUS(A, i);
+			a.Store(tmpA, i);
+		}
+
+		if (!Inverse)
+		{
+			for (size_t dist = N / 2; dist >= VCTSZE; dist >>= 1)
+			{
+				NTTLayer<Vector>(tmpA, Zetas, dist, false);
+			}
+		}
+
+		for (size_t c = 0, k = 0; c < VCTSZE; ++c)
+		{
+			for (size_t r = 0; r < ROWCNT; ++r, ++k)
+			{
+				tmpT[k] = tmpA[(r * VCTSZE) + c];
+			}
+		}
+
+		if (!Inverse)
+		{
+			for (size_t dist = VCTSZE / 2; dist != 0; dist >>= 1)
+			{
+				NTTLayerT<Vector>(tmpT, FWDLANES, dist, false);
+			}
+		}
+		else
+		{
+			for (size_t dist = 1; dist < VCTSZE; dist <<= 1)
+			{
+				NTTLayerT<Vector>(tmpT, INVLANES, dist, true);
+			}
+		}
+
+		for (size_t r = 0, k = 0; r < ROWCNT; ++r)
+		{
+			for (size_t c = 0; c < VCTSZE; ++c, ++k)
+			{
+				tmpA[k] = tmpT[(c * ROWCNT) + r];
+			}
+		}
+
+		if (Inverse)
+		{
+			const Vector NINV(NINV_MONT);
+
+			for (size_t dist = VCTSZE; dist < N; dist <<= 1)
+			{
+				NTTLayer<Vector>(tmpA, ZetasInv, dist, true);
+			}
+
+			for (size_t i = 0; i < N; i += VCTSZE)
+			{
+				a.Load(tmpA, i);
+				a = MontgomeryMulV(a, NINV);
+				a.StoreUS(A, i);
+			}
+		}
+		else
+		{
+			for (size_t i = 0; i < N; i += VCTSZE)
+			{
+				a.Load(tmpA, i);
+				a.StoreUS(A, i);
+			}
+		}
+	}
+
+	template <typename Array>
+	inline static void FwdNTT(Array &A)
+	{
+		// the output is in bit reversed order
+#if defined(__AVX512__)
+		NTT<Numeric::UInt512, Array>(A, false);
+#elif defined(__AVX2__)
+		NTT<Numeric::UInt256, Array>(A, false);
+#elif defined(__AVX__)
+		NTT<Numeric::UInt128, Array>(A, false);
+#else
+		size_t k = 1;
+
+		for (size_t dist = N / 2; dist != 0; dist >>= 1)
+		{
+			for (size_t i = 0; i < N; i += 2 * dist, ++k)
+			{
+				for (size_t j = i; j < i + dist; ++j)
+				{
+					ushort tmpT = MontgomeryReduce(static_cast<uint>(A[j + dist]) * Zetas[k]);
+					A[j + dist] = CSub(A[j] + Q - tmpT);
+					A[j] = CSub(A[j] + tmpT);
+				}
+			}
+		}
+#endif
+	}
+
+	template <typename Array>
+	inline static void InvNTT(Array &A)
+	{
+		// the input is in bit reversed order
+#if defined(__AVX512__)
+		NTT<Numeric::UInt512, Array>(A, true);
+#elif defined(__AVX2__)
+		NTT<Numeric::UInt256, Array>(A, true);
+#elif defined(__AVX__)
+		NTT<Numeric::UInt128, Array>(A, true);
+#else
+		for (size_t dist = 1; dist < N; dist <<= 1)
+		{
+			for (size_t i = 0, k = N / (2 * dist); i < N; i += 2 * dist, ++k)
+			{
+				for (size_t j = i; j < i + dist; ++j)
+				{
+					ushort tmpT = A[j];
+					A[j] = CSub(tmpT + A[j + dist]);
+					A[j + dist] = MontgomeryReduce(static_cast<uint>(CSub(tmpT + Q - A[j + dist])) * ZetasInv[k]);
+				}
+			}
+		}
+
+		for (size_t i = 0; i < N; ++i)
+		{
+			A[i] = MontgomeryReduce(static_cast<uint>(A[i]) * NINV_MONT);
+		}
+#endif
+	}
+
+	template <typename Vector, typename ArrayR, typename ArrayA, typename ArrayB>
+	inline static void AddV(ArrayR &R, const ArrayA &A, const ArrayB &B, bool Subtract)
+	{
+		const size_t VCTSZE = Vector::size() / sizeof(uint);
+		Vector a, b;
+
+		for (size_t i = 0; i < N; i += VCTSZE)
+		{
+			a.LoadUS(A, i);
+			b.LoadUS(B, i);
+			a = Subtract ? CSubV(a + Vector(Q) - b) : CSubV(a + b);
+			a.StoreUS(R, i);
+		}
+	}
+
+	template <typename Vector, typename ArrayA, typename ArrayB>
+	inline static void GetNoise(ArrayA &R, const ArrayB &Random)
+	{
+		// the centered binomial distribution with k = 16; the difference of the bit counts of the two halves of a random 32 bit word
+		const size_t VCTSZE = Vector::size() / sizeof(uint);
+		const Vector AIBMASK(0x01010101);
+		const Vector BITMASK(0xFF);
+		Vector tmpA, tmpB, tmpR;
+
+		for (size_t i = 0; i < N; i += VCTSZE)
+		{
+			tmpR.Load(Random, i);
+			Vector d(0);
+
+			for (int j = 0; j < 8; ++j)
+			{
+				d += (tmpR >> j) & AIBMASK;
+			}
+
+			tmpA = ((d >> 8) & BITMASK) + (d & BITMASK);
+			tmpB = (d >> 24) + ((d >> 16) & BITMASK);
+			CSubV(tmpA + Vector(Q) - tmpB).StoreUS(R, i);
+		}
+	}
+
+	template <typename Vector, typename ArrayR, typename ArrayA, typename ArrayB>
+	inline static void PointwiseV(ArrayR &R, const ArrayA &A, const ArrayB &B)
+	{
+		// B is moved to the Montgomery domain, so that the product of the two is in the normal domain
+		const size_t VCTSZE = Vector::size() / sizeof(uint);
+		const Vector R2(MONT_R2);
+		Vector a, b;
+
+		for (size_t i = 0; i < N; i += VCTSZE)
+		{
+			a.LoadUS(A, i);
+			b.LoadUS(B, i);
+			MontgomeryMulV(a, MontgomeryMulV(b, R2)).StoreUS(R, i);
+		}
+	}
+
+	template <typename ArrayR, typename ArrayA, typename ArrayB>
+	inline static void PolyAdd(ArrayR &R, const ArrayA &A, const ArrayB &B)
+	{
+#if defined(__AVX512__)
+		AddV<Numeric::UInt512, ArrayR, ArrayA, ArrayB>(R, A, B, false);
+#elif defined(__AVX2__)
+		AddV<Numeric::UInt256, ArrayR, ArrayA, ArrayB>(R, A, B, false);
+#elif defined(__AVX__)
+		AddV<Numeric::UInt128, ArrayR, ArrayA, ArrayB>(R, A, B, false);
+#else
+		for (size_t i = 0; i < N; ++i)
+		{
+			R[i] = CSub(A[i] + B[i]);
+		}
+#endif
+	}
+
+	template <typename ArrayA, typename ArrayB>
+	inline static void PolyGetNoise(ArrayA &R, const ArrayB &Random)
+	{
+#if defined(__AVX512__)
+		GetNoise<Numeric::UInt512, ArrayA, ArrayB>(R, Random);
+#elif defined(__AVX2__)
+		GetNoise<Numeric::UInt256, ArrayA, ArrayB>(R, Random);
+#elif defined(__AVX__)
+		GetNoise<Numeric::UInt128, ArrayA, ArrayB>(R, Random);
+#else
+		for (size_t i = 0; i < N; ++i)
+		{
+			uint d = 0;
+
+			for (int j = 0; j < 8; ++j)
+			{
+				d += (Random[i] >> j) & 0x01010101;
+			}
+
+			R[i] = CSub(((d >> 8) & 0xFF) + (d & 0xFF) + Q - ((d >> 24) + ((d >> 16) & 0xFF)));
+		}
+#endif
+	}
+
+	template <typename ArrayA, typename ArrayB, typename ArrayC>
+	inline static void PolyPointwise(ArrayA &R, const ArrayB &A, const ArrayC &B)
+	{
+#if defined(__AVX512__)
+		PointwiseV<Numeric::UInt512, ArrayA, ArrayB, ArrayC>(R, A, B);
+#elif defined(__AVX2__)
+		PointwiseV<Numeric::UInt256, ArrayA, ArrayB, ArrayC>(R, A, B);
+#elif defined(__AVX__)
+		PointwiseV<Numeric::UInt128, ArrayA, ArrayB, ArrayC>(R, A, B);
+#else
+		for (size_t i = 0; i < N; ++i)
+		{
+			R[i] = MontgomeryReduce(static_cast<uint>(A[i]) * MontgomeryReduce(static_cast<uint>(B[i]) * MONT_R2));
+		}
+#endif
+	}
+
+	template <typename ArrayR, typename ArrayA, typename ArrayB>
+	inline static void PolySub(ArrayR &R, const ArrayA &A, const ArrayB &B)
+	{
+#if defined(__AVX512__)
+		AddV<Numeric::UInt512, ArrayR, ArrayA, ArrayB>(R, A, B, true);
+#elif defined(__AVX2__)
+		AddV<Numeric::UInt256, ArrayR, ArrayA, ArrayB>(R, A, B, true);
+#elif defined(__AVX__)
+		AddV<Numeric::UInt128, ArrayR, ArrayA, ArrayB>(R, A, B, true);
+#else
+		for (size_t i = 0; i < N; ++i)
+		{
+			R[i] = CSub(A[i] + Q - B[i]);
+		}
+#endif
+	}
+
+	//~~~Static~~~//
+
+	static void Compress(std::vector<byte> &R, size_t Offset, const std::array<ushort, N> &Poly);
+	static void Decompress(std::array<ushort, N> &Poly, const std::vector<byte> &R, size_t Offset);
+	static void Encrypt(std::vector<byte> &Secret, std::vector<byte> &Send, const std::array<ushort, N> &PubKey, const std::vector<ushort> &A, std::vector<uint> &Noise1, std::vector<uint> &Noise2, std::vector<uint> &Noise3, std::vector<byte> &Random, bool Parallel);
+	static void FromBytes(std::array<ushort, N> &Poly, const std::vector<byte> &R);
+	static void Generate(std::vector<byte> &PubKey, std::vector<ushort> &PriKey, std::vector<ushort> &A, std::vector<uint> &Noise1, std::vector<uint> &Noise2, std::vector<byte> &Seed, bool Parallel);
+	static void MessageDecode(std::vector<byte> &Message, const std::array<ushort, N> &Poly);
+	static void MessageEncode(std::array<ushort, N> &Poly, const std::vector<byte> &Message);
+	static void PolyUniform(std::vector<ushort> &A, const std::vector<byte> &Seed);
+	static void ToBytes(std::vector<byte> &R, const std::array<ushort, N> &Poly);
 };
 
 NAMESPACE_RINGLWEEND
-#endif
\ No newline at end of file
+#endif
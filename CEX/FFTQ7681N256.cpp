@@ -0,0 +1,411 @@
+#include "FFTQ7681N256.h"
+#include "BCG.h"
+#include "CpuDetect.h"
+#include "IntUtils.h"
+#include "MemUtils.h"
+#include "ParallelUtils.h"
+
+NAMESPACE_RINGLWE
+
+//~~~Constant Tables~~~//
+
+const std::string FFTQ7681N256::Name = "Q7681N256";
+
+// psi = 7146, a primitive 512th root of unity; Zetas[k] = psi^brv(k) * 2^16 mod Q, ZetasInv[k] = psi^-brv(k) * 2^16 mod Q
+const ushort FFTQ7681N256::Zetas[256] =
+{
+	4088, 3904, 4056, 3182, 5487, 5225, 1100, 3696, 1414, 5980, 2876, 5362, 5186, 834, 5431, 121,
+	7064, 1921, 2830, 3364, 6385, 1483, 1525, 5124, 3706, 2006, 6082, 5688, 5444, 5695, 2816, 2088,
+	4877, 103, 2043, 6250, 6360, 1399, 7167, 4725, 7132, 1535, 3153, 5371, 5146, 3772, 5241, 2555,
+	7285, 4507, 5800, 4126, 438, 7002, 5921, 6376, 810, 5794, 7, 638, 3992, 1738, 3600, 4415,
+	2665, 5882, 6898, 1056, 5548, 4201, 3310, 6513, 2579, 6822, 2649, 5521, 1919, 1532, 7195, 7277,
+	727, 1521, 1533, 1464, 6295, 4253, 4938, 6760, 3750, 4919, 6291, 6083, 2835, 4917, 3865, 2233,
+	5109, 1497, 3145, 1350, 1681, 2883, 2224, 4093, 373, 2175, 3692, 730, 5290, 7021, 5925, 4546,
+	3417, 7487, 2789, 2919, 4949, 5568, 2385, 3405, 6627, 5983, 6515, 3456, 2, 6766, 3850, 5255,
+	2005, 592, 3763, 2812, 6278, 509, 2937, 4338, 3929, 3677, 5221, 4024, 6012, 6989, 5514, 4394,
+	7493, 1519, 6788, 5295, 2070, 5419, 5992, 777, 6669, 2130, 2874, 6277, 6240, 2532, 6597, 4346,
+	2345, 6343, 5378, 5166, 83, 4273, 6155, 6855, 1837, 642, 2965, 6890, 4369, 2083, 7311, 293,
+	4473, 589, 124, 4718, 3781, 2258, 4518, 6885, 4467, 3334, 3936, 4315, 7279, 7252, 1931, 3723,
+	2891, 2340, 4131, 3434, 4367, 2998, 3461, 2719, 2815, 6386, 3770, 3450, 2589, 2247, 6537, 1072,
+	2786, 451, 1712, 222, 4134, 5902, 434, 1151, 6172, 2918, 6274, 2339, 4113, 3988, 6095, 3581,
+	1121, 5610, 7245, 7445, 7023, 1476, 715, 7011, 151, 3887, 6478, 1181, 4139, 7455, 2378, 2767,
+	7664, 3937, 5680, 5259, 2230, 1348, 6752, 6403, 3177, 2072, 1649, 2161, 6611, 5622, 6439, 7502
+};
+
+const ushort FFTQ7681N256::ZetasInv[256] =
+{
+	4088, 3777, 4499, 3625, 3985, 6581, 2456, 2194, 7560, 2250, 6847, 2495, 2319, 4805, 1701, 6267,
+	5593, 4865, 1986, 2237, 1993, 1599, 5675, 3975, 2557, 6156, 6198, 1296, 4317, 4851, 5760, 617,
+	3266, 4081, 5943, 3689, 7043, 7674, 1887, 6871, 1305, 1760, 679, 7243, 3555, 1881, 3174, 396,
+	5126, 2440, 3909, 2535, 2310, 4528, 6146, 549, 2956, 514, 6282, 1321, 1431, 5638, 7578, 2804,
+	2426, 3831, 915, 7679, 4225, 1166, 1698, 1054, 4276, 5296, 2113, 2732, 4762, 4892, 194, 4264,
+	3135, 1756, 660, 2391, 6951, 3989, 5506, 7308, 3588, 5457, 4798, 6000, 6331, 4536, 6184, 2572,
+	5448, 3816, 2764, 4846, 1598, 1390, 2762, 3931, 921, 2743, 3428, 1386, 6217, 6148, 6160, 6954,
+	404, 486, 6149, 5762, 2160, 5032, 859, 5102, 1168, 4371, 3480, 2133, 6625, 783, 1799, 5016,
+	179, 1242, 2059, 1070, 5520, 6032, 5609, 4504, 1278, 929, 6333, 5451, 2422, 2001, 3744, 17,
+	4914, 5303, 226, 3542, 6500, 1203, 3794, 7530, 670, 6966, 6205, 658, 236, 436, 2071, 6560,
+	4100, 1586, 3693, 3568, 5342, 1407, 4763, 1509, 6530, 7247, 1779, 3547, 7459, 5969, 7230, 4895,
+	6609, 1144, 5434, 5092, 4231, 3911, 1295, 4866, 4962, 4220, 4683, 3314, 4247, 3550, 5341, 4790,
+	3958, 5750, 429, 402, 3366, 3745, 4347, 3214, 796, 3163, 5423, 3900, 2963, 7557, 7092, 3208,
+	7388, 370, 5598, 3312, 791, 4716, 7039, 5844, 826, 1526, 3408, 7598, 2515, 2303, 1338, 5336,
+	3335, 1084, 5149, 1441, 1404, 4807, 5551, 1012, 6904, 1689, 2262, 5611, 2386, 893, 6162, 188,
+	3287, 2167, 692, 1669, 3657, 2460, 4004, 3752, 3343, 4744, 7172, 1403, 4869, 3918, 7089, 5676
+};
+
+//~~~Public Functions~~~//
+
+void FFTQ7681N256::Decrypt(std::vector<byte> &Secret, const std::vector<ushort> &PriKey, const std::vector<byte> &Received)
+{
+	CexAssert(PriKey.size() == N, "The private key is the wrong size");
+	CexAssert(Received.size() >= SENDB_BYTES, "The received message is too small");
+
+	std::array<ushort, N> bp;
+	std::array<ushort, N> v;
+	std::array<ushort, N> w;
+
+	FromBytes(bp, Received);
+	Decompress(v, Received, POLY_BYTES);
+	PolyPointwise(w, PriKey, bp);
+	InvNTT(w);
+	PolySub(v, v, w);
+	MessageDecode(Secret, v);
+}
+
+void FFTQ7681N256::Encrypt(std::vector<std::vector<byte>> &Secret, std::vector<std::vector<byte>> &Send, const std::vector<byte> &Received, const std::vector<ushort> &A, std::unique_ptr<Prng::IPrng> &Rng)
+{
+	CexAssert(A.size() == N, "The expanded polynomial is the wrong size");
+	CexAssert(Secret.size() == Send.size(), "The secret and message batches are not the same size");
+
+	const size_t CNT = Send.size();
+	std::array<ushort, N> pka;
+	std::vector<std::vector<uint>> noise(3 * CNT, std::vector<uint>(N));
+	std::vector<std::vector<byte>> rnd(CNT, std::vector<byte>(SEED_BYTES));
+
+	if (CNT == 0)
+	{
+		return;
+	}
+
+	// the recipients key is decoded once for the batch
+	FromBytes(pka, Received);
+
+	// the generator is not shared between threads, so the random for the whole batch is drawn first
+	for (size_t i = 0; i < CNT; ++i)
+	{
+		Rng->Fill(noise[3 * i], 0, N);
+		Rng->Fill(noise[(3 * i) + 1], 0, N);
+		Rng->Fill(noise[(3 * i) + 2], 0, N);
+		Rng->GetBytes(rnd[i]);
+	}
+
+	// each thread processes whole messages; a message is too small to divide between threads
+	const size_t THDCNT = (Utility::ParallelUtils::ProcessorCount() < CNT) ? Utility::ParallelUtils::ProcessorCount() : CNT;
+
+	Utility::ParallelUtils::ParallelFor(0, THDCNT, [&Secret, &Send, &pka, &A, &noise, &rnd, CNT, THDCNT](size_t i)
+	{
+		for (size_t j = i; j < CNT; j += THDCNT)
+		{
+			Encrypt(Secret[j], Send[j], pka, A, noise[3 * j], noise[(3 * j) + 1], noise[(3 * j) + 2], rnd[j]);
+		}
+	});
+}
+
+void FFTQ7681N256::Encrypt(std::vector<byte> &Secret, std::vector<byte> &Send, const std::vector<byte> &Received, const std::vector<ushort> &A, std::unique_ptr<Prng::IPrng> &Rng, bool Parallel)
+{
+	CexAssert(A.size() == N, "The expanded polynomial is the wrong size");
+
+	// the ring is too small to divide between threads, so the parallel flag is not used
+	std::array<ushort, N> pka;
+	FromBytes(pka, Received);
+
+	std::vector<uint> buf1(N);
+	Rng->Fill(buf1, 0, N);
+	std::vector<uint> buf2(N);
+	Rng->Fill(buf2, 0, N);
+	std::vector<uint> buf3(N);
+	Rng->Fill(buf3, 0, N);
+	std::vector<byte> seed(SEED_BYTES);
+	Rng->GetBytes(seed);
+
+	Encrypt(Secret, Send, pka, A, buf1, buf2, buf3, seed);
+}
+
+void FFTQ7681N256::Expand(std::vector<ushort> &A, const std::vector<byte> &PubKey)
+{
+	CexAssert(PubKey.size() >= SENDA_BYTES, "The public key is too small");
+
+	std::vector<byte> seed(SEED_BYTES);
+	Utility::MemUtils::Copy(PubKey, POLY_BYTES, seed, 0, SEED_BYTES);
+	A.resize(N);
+	PolyUniform(A, seed);
+}
+
+void FFTQ7681N256::Generate(std::vector<std::vector<byte>> &PubKey, std::vector<std::vector<ushort>> &PriKey, std::vector<std::vector<ushort>> &A, std::unique_ptr<Prng::IPrng> &Rng)
+{
+	CexAssert(PubKey.size() == PriKey.size() && PubKey.size() == A.size(), "The key batches are not the same size");
+
+	const size_t CNT = PubKey.size();
+	std::vector<std::vector<uint>> noise(2 * CNT, std::vector<uint>(N));
+	std::vector<std::vector<byte>> seed(CNT, std::vector<byte>(SEED_BYTES));
+
+	if (CNT == 0)
+	{
+		return;
+	}
+
+	// the generator is not shared between threads, so the random for the whole batch is drawn first
+	for (size_t i = 0; i < CNT; ++i)
+	{
+		Rng->Fill(noise[2 * i], 0, N);
+		Rng->Fill(noise[(2 * i) + 1], 0, N);
+		Rng->GetBytes(seed[i]);
+	}
+
+	// each thread generates whole key-pairs
+	const size_t THDCNT = (Utility::ParallelUtils::ProcessorCount() < CNT) ? Utility::ParallelUtils::ProcessorCount() : CNT;
+
+	Utility::ParallelUtils::ParallelFor(0, THDCNT, [&PubKey, &PriKey, &A, &noise, &seed, CNT, THDCNT](size_t i)
+	{
+		for (size_t j = i; j < CNT; j += THDCNT)
+		{
+			Generate(PubKey[j], PriKey[j], A[j], noise[2 * j], noise[(2 * j) + 1], seed[j]);
+		}
+	});
+}
+
+void FFTQ7681N256::Generate(std::vector<byte> &PubKey, std::vector<ushort> &PriKey, std::vector<ushort> &A, std::unique_ptr<Prng::IPrng> &Rng, bool Parallel)
+{
+	// the ring is too small to divide between threads, so the parallel flag is not used
+	std::vector<uint> buf1(N);
+	Rng->Fill(buf1, 0, N);
+	std::vector<uint> buf2(N);
+	Rng->Fill(buf2, 0, N);
+	std::vector<byte> seed(SEED_BYTES);
+	Rng->GetBytes(seed);
+
+	Generate(PubKey, PriKey, A, buf1, buf2, seed);
+}
+
+//~~~Private Functions~~~//
+
+void FFTQ7681N256::Compress(std::vector<byte> &R, size_t Offset, const std::array<ushort, N> &Poly)
+{
+	// round each coefficient to the nearest multiple of Q / 16, and pack two to a byte
+	for (size_t i = 0; i < N; i += 2)
+	{
+		const uint C0 = ((((uint)Poly[i] << CPRS_BITS) + (Q / 2)) / Q) & ((1 << CPRS_BITS) - 1);
+		const uint C1 = ((((uint)Poly[i + 1] << CPRS_BITS) + (Q / 2)) / Q) & ((1 << CPRS_BITS) - 1);
+		R[Offset + (i / 2)] = static_cast<byte>(C0 | (C1 << 4));
+	}
+}
+
+void FFTQ7681N256::Decompress(std::array<ushort, N> &Poly, const std::vector<byte> &R, size_t Offset)
+{
+	for (size_t i = 0; i < N; i += 2)
+	{
+		Poly[i] = static_cast<ushort>((((uint)(R[Offset + (i / 2)] & 0x0F) * Q) + (1 << (CPRS_BITS - 1))) >> CPRS_BITS);
+		Poly[i + 1] = static_cast<ushort>((((uint)(R[Offset + (i / 2)] >> 4) * Q) + (1 << (CPRS_BITS - 1))) >> CPRS_BITS);
+	}
+}
+
+void FFTQ7681N256::Encrypt(std::vector<byte> &Secret, std::vector<byte> &Send, const std::array<ushort, N> &PubKey, const std::vector<ushort> &A, std::vector<uint> &Noise1, std::vector<uint> &Noise2, std::vector<uint> &Noise3, std::vector<byte> &Random)
+{
+	std::array<ushort, N> bp;
+	std::array<ushort, N> ep;
+	std::array<ushort, N> epp;
+	std::array<ushort, N> m;
+	std::array<ushort, N> sp;
+	std::array<ushort, N> v;
+
+	PolyGetNoise(sp, Noise1);
+	FwdNTT(sp);
+	PolyGetNoise(ep, Noise2);
+	FwdNTT(ep);
+
+	// u = a * s' + e', sent in the NTT domain
+	PolyPointwise(bp, A, sp);
+	PolyAdd(bp, bp, ep);
+
+	// v = b * s' + e'' + encode(m)
+	PolyPointwise(v, PubKey, sp);
+	InvNTT(v);
+	PolyGetNoise(epp, Noise3);
+	PolyAdd(v, v, epp);
+	MessageEncode(m, Random);
+	PolyAdd(v, v, m);
+
+	ToBytes(Send, bp);
+	Compress(Send, POLY_BYTES, v);
+
+	// the random message is the shared secret
+	Secret.resize(SEED_BYTES);
+	Utility::MemUtils::Copy(Random, 0, Secret, 0, SEED_BYTES);
+}
+
+void FFTQ7681N256::FromBytes(std::array<ushort, N> &Poly, const std::vector<byte> &R)
+{
+	// 13 bit coefficients, eight to thirteen bytes; a value outside the field is reduced
+	for (size_t i = 0; i < N / 8; ++i)
+	{
+		ulong x = Utility::IntUtils::LeBytesTo64(R, 13 * i);
+		const ulong Y = Utility::IntUtils::LeBytesTo32(R, (13 * i) + 8) | ((ulong)R[(13 * i) + 12] << 32);
+
+		for (size_t j = 0; j < 4; ++j, x >>= POLY_BITS)
+		{
+			Poly[(8 * i) + j] = CSub(static_cast<uint>(x & 0x1FFF));
+		}
+
+		// the fifth coefficient spans the two words
+		x |= (Y << 12);
+		Poly[(8 * i) + 4] = CSub(static_cast<uint>(x & 0x1FFF));
+		x = Y >> 1;
+
+		for (size_t j = 5; j < 8; ++j, x >>= POLY_BITS)
+		{
+			Poly[(8 * i) + j] = CSub(static_cast<uint>(x & 0x1FFF));
+		}
+	}
+}
+
+void FFTQ7681N256::Generate(std::vector<byte> &PubKey, std::vector<ushort> &PriKey, std::vector<ushort> &A, std::vector<uint> &Noise1, std::vector<uint> &Noise2, std::vector<byte> &Seed)
+{
+	std::array<ushort, N> e;
+	std::array<ushort, N> pk;
+
+	A.resize(N);
+	PriKey.resize(N);
+	PolyUniform(A, Seed);
+
+	PolyGetNoise(PriKey, Noise1);
+	FwdNTT(PriKey);
+	PolyGetNoise(e, Noise2);
+	FwdNTT(e);
+
+	// b = a * s + e, in the NTT domain
+	PolyPointwise(pk, PriKey, A);
+	PolyAdd(pk, pk, e);
+
+	ToBytes(PubKey, pk);
+	Utility::MemUtils::Copy(Seed, 0, PubKey, POLY_BYTES, SEED_BYTES);
+}
+
+void FFTQ7681N256::MessageDecode(std::vector<byte> &Message, const std::array<ushort, N> &Poly)
+{
+	// a coefficient nearer to Q / 2 than to zero is a one bit
+	Message.resize(SEED_BYTES);
+	Utility::MemUtils::Clear(Message, 0, Message.size());
+
+	for (size_t i = 0; i < N; ++i)
+	{
+		const uint BIT = ((((uint)Poly[i] << 1) + (Q / 2)) / Q) & 1;
+		Message[i >> 3] |= static_cast<byte>(BIT << (i & 7));
+	}
+}
+
+void FFTQ7681N256::MessageEncode(std::array<ushort, N> &Poly, const std::vector<byte> &Message)
+{
+	for (size_t i = 0; i < N; ++i)
+	{
+		const uint MASK = 0 - (uint)((Message[i >> 3] >> (i & 7)) & 1);
+		Poly[i] = static_cast<ushort>(MASK & ((Q + 1) / 2));
+	}
+}
+
+void FFTQ7681N256::PolyUniform(std::vector<ushort> &A, const std::vector<byte> &Seed)
+{
+	// the public polynomial is sampled in the NTT domain, from the BCG key-stream (aes-128 in counter mode) keyed with the seed
+#if defined(__AVX__)
+
+	// a processor with avx may lack aes-ni; the BCG generator is the fallback
+	Common::CpuDetect detect;
+
+	if (detect.AESNI())
+	{
+		// the key-stream is generated with aes-ni in local arrays, the output is identical to the BCG generator
+		std::array<__m128i, 11> rndKey;
+		std::array<byte, UNIFORM_SIZE> buf;
+		ulong ctrHigh = Utility::IntUtils::BeBytesTo64(Seed, 0);
+		ulong ctrLow = Utility::IntUtils::BeBytesTo64(Seed, 8);
+		size_t ctr = 0;
+		ushort val;
+
+		Utility::PolyMath::AesExpand(Seed, rndKey);
+
+		while (ctr < N)
+		{
+			Utility::PolyMath::AesCtr(rndKey, ctrHigh, ctrLow, buf);
+
+			for (size_t pos = 0; pos < UNIFORM_SIZE && ctr < N; pos += 2)
+			{
+				val = (buf[pos] | ((ushort)buf[pos + 1] << 8)) & 0x1FFF;
+
+				if (val < Q)
+				{
+					A[ctr++] = val;
+				}
+			}
+		}
+
+		Utility::MemUtils::Clear(rndKey, 0, rndKey.size() * sizeof(__m128i));
+		Utility::MemUtils::Clear(buf, 0, buf.size());
+
+		return;
+	}
+
+#endif
+
+	Drbg::BCG eng(Enumeration::BlockCiphers::Rijndael);
+	eng.ParallelProfile().IsParallel() = false;
+	eng.Initialize(Seed);
+	std::vector<byte> buf(2 * N * sizeof(ushort));
+	eng.Generate(buf, 0, buf.size());
+
+	size_t ctr = 0;
+	size_t pos = 0;
+	ushort val;
+
+	while (ctr < N)
+	{
+		val = (buf[pos] | ((ushort)buf[pos + 1] << 8)) & 0x1FFF;
+
+		if (val < Q)
+		{
+			A[ctr++] = val;
+		}
+
+		pos += 2;
+
+		if (pos >= buf.size())
+		{
+			eng.Generate(buf, 0, buf.size());
+			pos = 0;
+		}
+	}
+}
+
+void FFTQ7681N256::ToBytes(std::vector<byte> &R, const std::array<ushort, N> &Poly)
+{
+	for (size_t i = 0; i < N / 8; ++i)
+	{
+		ulong x = 0;
+
+		for (size_t j = 0; j < 5; ++j)
+		{
+			x |= (ulong)Poly[(8 * i) + j] << (POLY_BITS * j);
+		}
+
+		// the first 64 bits, then the remaining 40 bits of the fifth to eighth coefficients
+		Utility::IntUtils::Le64ToBytes(x, R, 13 * i);
+		x = (ulong)Poly[(8 * i) + 4] >> 12;
+
+		for (size_t j = 5; j < 8; ++j)
+		{
+			x |= (ulong)Poly[(8 * i) + j] << ((POLY_BITS * (j - 5)) + 1);
+		}
+
+		Utility::IntUtils::Le32ToBytes(static_cast<uint>(x), R, (13 * i) + 8);
+		R[(13 * i) + 12] = static_cast<byte>(x >> 32);
+	}
+}
+
+NAMESPACE_RINGLWEEND
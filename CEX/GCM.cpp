@@ -1,22 +1,18 @@
 #include "GCM.h"
-#include "IntUtils.h"
-#include "MemUtils.h"
-#include "SymmetricKey.h"
+#include "BlockCipherFromName.h"
 
 NAMESPACE_MODE
 
-const std::string GCM::CLASS_NAME("GCM");
-
 //~~~Properties~~~//
 
 bool &GCM::AutoIncrement()
 {
-	return m_autoIncrement;
+	return m_gcmMode->AutoIncrement();
 }
 
 const size_t GCM::BlockSize()
 {
-	return BLOCK_SIZE;
+	return m_gcmMode->BlockSize();
 }
 
 const BlockCiphers GCM::CipherType()
@@ -26,7 +22,7 @@ const BlockCiphers GCM::CipherType()
 
 IBlockCipher* GCM::Engine()
 {
-	return m_cipherMode.Engine();
+	return m_gcmMode->Engine();
 }
 
 const CipherModes GCM::Enumeral()
@@ -36,116 +32,83 @@ const CipherModes GCM::Enumeral()
 
 const bool GCM::IsEncryption()
 {
-	return m_isEncryption;
+	return m_gcmMode->IsEncryption();
 }
 
 const bool GCM::IsInitialized()
 {
-	return m_isInitialized;
+	return m_gcmMode->IsInitialized();
 }
 
 const bool GCM::IsParallel()
 {
-	return m_parallelProfile.IsParallel();
+	return m_gcmMode->IsParallel();
 }
 
 const std::vector<SymmetricKeySize> &GCM::LegalKeySizes()
 {
-	return m_legalKeySizes;
+	return m_gcmMode->LegalKeySizes();
 }
 
 const size_t GCM::MaxTagSize()
 {
-	return BLOCK_SIZE;
+	return m_gcmMode->MaxTagSize();
 }
 
 const size_t GCM::MinTagSize()
 {
-	return MIN_TAGSIZE;
+	return m_gcmMode->MinTagSize();
 }
 
 const std::string GCM::Name()
 {
-	return CLASS_NAME + "-" + m_cipherMode.Engine()->Name();
+	return m_gcmMode->Name();
 }
 
 const size_t GCM::ParallelBlockSize()
 {
-	return m_parallelProfile.ParallelBlockSize();
+	return m_gcmMode->ParallelBlockSize();
 }
 
 ParallelOptions &GCM::ParallelProfile()
 {
-	return m_cipherMode.ParallelProfile();
+	return m_gcmMode->ParallelProfile();
 }
 
 bool &GCM::PreserveAD()
 {
-	return m_aadPreserve;
+	return m_gcmMode->PreserveAD();
 }
 
 const std::vector<byte> GCM::Tag()
 {
-	if (!m_isFinalized)
-		throw CryptoCipherModeException("GCM:Tag", "The cipher mode has not been finalized!");
-
-	return m_msgTag;
+	return m_gcmMode->Tag();
 }
 
 //~~~Constructor~~~//
 
 GCM::GCM(BlockCiphers CipherType)
 	:
-	m_aadData(0),
-	m_aadLoaded(false),
-	m_aadPreserve(false),
-	m_aadSize(0),
-	m_autoIncrement(false),
-	m_checkSum(BLOCK_SIZE),
-	m_cipherMode(CipherType),
 	m_cipherType(CipherType),
-	m_destroyEngine(true),
-	m_gcmHash(0),
-	m_gcmNonce(0),
-	m_gcmVector(0),
-	m_isDestroyed(false),
-	m_isEncryption(false),
-	m_isFinalized(false),
-	m_isInitialized(false),
-	m_legalKeySizes(0),
-	m_msgSize(0),
-	m_msgTag(BLOCK_SIZE),
-	m_parallelProfile(BLOCK_SIZE, m_cipherMode.ParallelProfile().IsParallel(), m_cipherMode.ParallelProfile().ParallelBlockSize(),
-		m_cipherMode.ParallelProfile().ParallelMaxDegree(), true, m_cipherMode.Engine()->StateCacheSize(), true)
-{
-	Scope();
+	m_gcmMode(new GCMT<IBlockCipher>(Helper::BlockCipherFromName::GetInstance(CipherType), true)),
+	m_isDestroyed(false)
+{
 }
 
 GCM::GCM(IBlockCipher* Cipher)
 	:
-	m_aadData(0),
-	m_aadLoaded(false),
-	m_aadPreserve(false),
-	m_aadSize(0),
-	m_autoIncrement(false),
-	m_checkSum(BLOCK_SIZE),
-	m_cipherMode(Cipher != 0 ? Cipher : throw CryptoCipherModeException("GCM:CTor", "The Cipher can not be null!")),
-	m_cipherType(Cipher->Enumeral()),
-	m_destroyEngine(false),
-	m_gcmHash(0),
-	m_gcmNonce(0),
-	m_gcmVector(0),
-	m_isDestroyed(false),
-	m_isEncryption(false),
-	m_isFinalized(false),
-	m_isInitialized(false),
-	m_legalKeySizes(0),
-	m_msgSize(0),
-	m_msgTag(BLOCK_SIZE),
-	m_parallelProfile(BLOCK_SIZE, m_cipherMode.ParallelProfile().IsParallel(), m_cipherMode.ParallelProfile().ParallelBlockSize(),
-		m_cipherMode.ParallelProfile().ParallelMaxDegree(), true, m_cipherMode.Engine()->StateCacheSize(), true)
-{
-	Scope();
+	m_cipherType(Cipher != 0 ? Cipher->Enumeral() : throw CryptoCipherModeException("GCM:CTor", "The Cipher can not be null!")),
+	m_gcmMode(new GCMT<IBlockCipher>(Cipher, false)),
+	m_isDestroyed(false)
+{
+}
+
+GCM::GCM(GCMT<IBlockCipher>* Mode, BlockCiphers CipherType)
+	:
+	m_cipherType(CipherType),
+	m_gcmMode(Mode),
+	m_isDestroyed(false)
+{
 }
 
 GCM::~GCM()
@@ -155,14 +118,22 @@ GCM::~GCM()
 
 //~~~Public Functions~~~//
 
+GCM* GCM::Clone()
+{
+	if (!m_gcmMode->IsInitialized())
+		throw CryptoCipherModeException("GCM:Clone", "The cipher mode has not been initialized!");
+
+	return new GCM(m_gcmMode->Clone(), m_cipherType);
+}
+
 void GCM::DecryptBlock(const std::vector<byte> &Input, std::vector<byte> &Output)
 {
-	Decrypt128(Input, 0, Output, 0);
+	m_gcmMode->DecryptBlock(Input, Output);
 }
 
 void GCM::DecryptBlock(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
 {
-	Decrypt128(Input, InOffset, Output, OutOffset);
+	m_gcmMode->DecryptBlock(Input, InOffset, Output, OutOffset);
 }
 
 void GCM::Destroy()
@@ -170,262 +141,59 @@ void GCM::Destroy()
 	if (!m_isDestroyed)
 	{
 		m_isDestroyed = true;
-		m_aadLoaded = false;
-		m_aadPreserve = false;
-		m_aadSize = 0;
-		m_autoIncrement = false;
 		m_cipherType = BlockCiphers::None;
-		m_isEncryption = false;
-		m_isFinalized = false;
-		m_isInitialized = false;
-		m_msgSize = 0;
-		m_parallelProfile.Reset();
-
-		if (m_gcmHash)
-			m_gcmHash->Reset();
-
-		Utility::IntUtils::ClearVector(m_aadData);
-		Utility::IntUtils::ClearVector(m_gcmNonce);
-		Utility::IntUtils::ClearVector(m_gcmVector);
-		Utility::IntUtils::ClearVector(m_legalKeySizes);
-		Utility::IntUtils::ClearVector(m_msgTag);
-		Utility::IntUtils::ClearVector(m_checkSum);
-
-		if (m_destroyEngine)
-		{
-			m_destroyEngine = false;
-			if (m_cipherMode.IsInitialized())
-				m_cipherMode.Destroy();
-
-		}
+		m_gcmMode->Destroy();
 	}
 }
 
 void GCM::EncryptBlock(const std::vector<byte> &Input, std::vector<byte> &Output)
 {
-	Encrypt128(Input, 0, Output, 0);
+	m_gcmMode->EncryptBlock(Input, Output);
 }
 
 void GCM::EncryptBlock(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
 {
-	Encrypt128(Input, InOffset, Output, OutOffset);
+	m_gcmMode->EncryptBlock(Input, InOffset, Output, OutOffset);
 }
 
 void GCM::Finalize(std::vector<byte> &Output, const size_t Offset, const size_t Length)
 {
-	if (!m_isInitialized)
-		throw CryptoCipherModeException("GCM:Finalize", "The cipher mode has not been initialized!");
-	if (Length < MIN_TAGSIZE || Length > BLOCK_SIZE)
-		throw CryptoCipherModeException("GCM:Finalize", "The length must be minimum of 12 and maximum of MAC code size!");
-
-	CalculateMac();
-	Utility::MemUtils::Copy(m_msgTag, 0, Output, Offset, Length);
+	m_gcmMode->Finalize(Output, Offset, Length);
 }
 
 void GCM::Initialize(bool Encryption, ISymmetricKey &KeyParams)
 {
-	Scope();
-
-	if (KeyParams.Nonce().size() < 8)
-		throw CryptoSymmetricCipherException("GCM:Initialize", "Requires a nonce of minimum 10 bytes in length!");
-	if (IsParallel() && ParallelBlockSize() < m_parallelProfile.ParallelMinimumSize() || ParallelBlockSize() > m_parallelProfile.ParallelMaximumSize())
-		throw CryptoSymmetricCipherException("GCM:Initialize", "The parallel block size is out of bounds!");
-	if (IsParallel() && ParallelBlockSize() % m_parallelProfile.ParallelMinimumSize() != 0)
-		throw CryptoSymmetricCipherException("GCM:Initialize", "The parallel block size must be evenly aligned to the ParallelMinimumSize!");
-
-	if (KeyParams.Key().size() == 0)
-	{
-		if (KeyParams.Nonce() == m_gcmNonce)
-			throw CryptoSymmetricCipherException("GCM:Initialize", "The nonce can not be zeroised or repeating!");
-		if (!m_cipherMode.IsInitialized())
-			throw CryptoSymmetricCipherException("GCM:Initialize", "First initialization requires a key and nonce!");
-	}
-	else
-	{
-		if (!SymmetricKeySize::Contains(LegalKeySizes(), KeyParams.Key().size()))
-			throw CryptoSymmetricCipherException("GCM:Initialize", "Invalid key size! Key must be one of the LegalKeySizes() in length.");
-
-		// key the cipher and generate the hash key
-		m_cipherMode.Engine()->Initialize(true, KeyParams);
-		std::vector<byte> tmpH(BLOCK_SIZE);
-		const std::vector<byte> ZEROES(BLOCK_SIZE);
-		m_cipherMode.Engine()->Transform(ZEROES, 0, tmpH, 0);
-
-		std::vector<ulong> gKey = 
-		{
-			Utility::IntUtils::BeBytesTo64(tmpH, 0),
-			Utility::IntUtils::BeBytesTo64(tmpH, 8)
-		};
-
-		m_gcmHash = new Mac::GHASH(gKey);
-		m_gcmKey = KeyParams.Key();
-	}
-
-	m_isEncryption = Encryption;
-	m_gcmNonce = KeyParams.Nonce();
-	m_gcmVector = m_gcmNonce;
-
-	if (m_gcmVector.size() == 12)
-	{
-		m_gcmVector.resize(16);
-		m_gcmVector[15] = 1;
-	}
-	else
-	{
-		std::vector<byte> tmpN(BLOCK_SIZE);
-		m_gcmHash->ProcessSegment(m_gcmVector, 0, tmpN, m_gcmVector.size());
-		m_gcmHash->FinalizeBlock(tmpN, 0, m_gcmVector.size());
-		m_gcmVector = tmpN;
-	}
-
-	m_cipherMode.Initialize(true, Key::Symmetric::SymmetricKey(m_gcmKey, m_gcmVector));
-	std::vector<byte> tmpN(BLOCK_SIZE);
-	m_cipherMode.Transform(tmpN, 0, m_gcmVector, 0, BLOCK_SIZE);
-
-	if (m_isFinalized)
-	{
-		Utility::MemUtils::Clear(m_msgTag, 0, m_msgTag.size());
-		m_isFinalized = false;
-	}
-
-	m_isInitialized = true;
-}
-
-void GCM::ParallelMaxDegree(size_t Degree)
-{
-	if (Degree == 0)
-		throw CryptoCipherModeException("GCM:ParallelMaxDegree", "Parallel degree can not be zero!");
-	if (Degree % 2 != 0)
-		throw CryptoCipherModeException("GCM:ParallelMaxDegree", "Parallel degree must be an even number!");
-	if (Degree > m_parallelProfile.ProcessorCount())
-		throw CryptoCipherModeException("GCM:ParallelMaxDegree", "Parallel degree can not exceed processor count!");
-
-	m_parallelProfile.SetMaxDegree(Degree);
+	m_gcmMode->Initialize(Encryption, KeyParams);
 }
 
-void GCM::SetAssociatedData(const std::vector<byte> &Input, const size_t Offset, const size_t Length)
+bool GCM::OpenBatch(std::vector<AeadPacket> &Packets, const std::vector<byte> &Associated, const std::vector<byte> &Input, std::vector<byte> &Output, const std::vector<byte> &Tags, const size_t TagLength)
 {
-	if (!m_isInitialized)
-		throw CryptoSymmetricCipherException("GCM:SetAssociatedData", "The cipher has not been initialized!");
-	if (m_aadLoaded)
-		throw CryptoSymmetricCipherException("GCM:SetAssociatedData", "The associated data has already been set!");
-
-	m_aadData.resize(Length);
-	Utility::MemUtils::Copy(Input, Offset, m_aadData, 0, Length);
-	m_gcmHash->ProcessSegment(Input, Offset, m_checkSum, Length);
-	m_aadSize = Length;
-	m_aadLoaded = true;
+	return m_gcmMode->OpenBatch(Packets, Associated, Input, Output, Tags, TagLength);
 }
 
-void GCM::Transform(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset, const size_t Length)
+void GCM::ParallelMaxDegree(size_t Degree)
 {
-	CexAssert(m_isInitialized, "The cipher mode has not been initialized!");
-	CexAssert(Utility::IntUtils::Min(Input.size() - InOffset, Output.size() - OutOffset) >= Length, "The data arrays are smaller than the the block-size!");
-
-	if (m_isEncryption)
-	{
-		m_cipherMode.Transform(Input, InOffset, Output, OutOffset, Length);
-		m_gcmHash->Update(Output, OutOffset, m_checkSum, Length);
-	}
-	else
-	{
-		m_gcmHash->Update(Input, InOffset, m_checkSum, Length);
-		m_cipherMode.Transform(Input, InOffset, Output, OutOffset, Length);
-	}
-
-	m_msgSize += Length;
+	m_gcmMode->ParallelMaxDegree(Degree);
 }
 
-bool GCM::Verify(const std::vector<byte> &Input, const size_t Offset, const size_t Length)
+void GCM::SealBatch(const std::vector<AeadPacket> &Packets, const std::vector<byte> &Associated, const std::vector<byte> &Input, std::vector<byte> &Output, std::vector<byte> &Tags, const size_t TagLength)
 {
-	if (m_isEncryption)
-		throw CryptoCipherModeException("GCM:Verify", "The cipher mode has not been initialized for decryption!");
-	if (!m_isInitialized && !m_isFinalized)
-		throw CryptoCipherModeException("GCM:Verify", "The cipher mode has not been initialized!");
-	if (Length < MIN_TAGSIZE || Length > BLOCK_SIZE)
-		throw CryptoCipherModeException("GCM:Verify", "The length must be minimum of 12 and maximum of MAC code size!");
-
-	if (!m_isFinalized)
-		CalculateMac();
-
-	return Utility::IntUtils::Compare(m_msgTag, 0, Input, Offset, Length);
+	m_gcmMode->SealBatch(Packets, Associated, Input, Output, Tags, TagLength);
 }
 
-//~~~Private Functions~~~//
-
-void GCM::CalculateMac()
-{
-	m_gcmHash->FinalizeBlock(m_checkSum, m_aadSize, m_msgSize);
-	Utility::MemUtils::XorBlock(m_gcmVector, 0, m_checkSum, 0, BLOCK_SIZE);
-	Utility::MemUtils::COPY128(m_checkSum, 0, m_msgTag, 0);
-	Reset();
-
-	if (m_autoIncrement)
-	{
-		std::vector<byte> tmpN = m_gcmNonce;
-		Utility::IntUtils::BeIncrement8(tmpN);
-		std::vector<byte> zero(0);
-		Initialize(m_isEncryption, Key::Symmetric::SymmetricKey(zero, tmpN));
-
-		if (m_aadPreserve)
-			m_gcmHash->ProcessSegment(m_aadData, 0, m_checkSum, m_aadData.size());
-	}
-
-	m_isFinalized = true;
-}
-
-void GCM::Decrypt128(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
-{
-	CexAssert(m_isInitialized, "The cipher mode has not been initialized!");
-	CexAssert(Utility::IntUtils::Min(Input.size() - InOffset, Output.size() - OutOffset) >= BLOCK_SIZE, "The data arrays are smaller than the the block-size!");
-
-	m_gcmHash->Update(Input, InOffset, m_checkSum, BLOCK_SIZE);
-	m_cipherMode.EncryptBlock(Input, InOffset, Output, OutOffset);
-	m_msgSize += BLOCK_SIZE;
-}
-
-void GCM::Encrypt128(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
+void GCM::SetAssociatedData(const std::vector<byte> &Input, const size_t Offset, const size_t Length)
 {
-	CexAssert(m_isInitialized, "The cipher mode has not been initialized!");
-	CexAssert(Utility::IntUtils::Min(Input.size() - InOffset, Output.size() - OutOffset) >= BLOCK_SIZE, "The data arrays are smaller than the the block-size!");
-
-	m_cipherMode.EncryptBlock(Input, InOffset, Output, OutOffset);
-	m_gcmHash->Update(Input, InOffset, m_checkSum, BLOCK_SIZE);
-	m_msgSize += BLOCK_SIZE;
+	m_gcmMode->SetAssociatedData(Input, Offset, Length);
 }
 
-void GCM::Reset()
+void GCM::Transform(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset, const size_t Length)
 {
-	if (!m_aadPreserve)
-	{
-		if (m_aadSize != 0)
-			Utility::MemUtils::Clear(m_aadData, 0, m_aadData.size());
-
-		m_aadLoaded = false;
-		m_aadSize = 0;
-	}
-
-	m_gcmHash->Reset();
-	m_isInitialized = false;
-	Utility::MemUtils::Clear(m_gcmVector, 0, m_gcmVector.size());
-	Utility::MemUtils::Clear(m_checkSum, 0, m_checkSum.size());
-	m_msgSize = 0;
+	m_gcmMode->Transform(Input, InOffset, Output, OutOffset, Length);
 }
 
-void GCM::Scope()
+bool GCM::Verify(const std::vector<byte> &Input, const size_t Offset, const size_t Length)
 {
-	std::vector<SymmetricKeySize> keySizes = m_cipherMode.LegalKeySizes();
-	m_legalKeySizes.resize(keySizes.size());
-
-	for (size_t i = 0; i < m_legalKeySizes.size(); i++)
-	{	
-		m_legalKeySizes[i] = SymmetricKeySize(keySizes[i].KeySize(), keySizes[i].NonceSize(), keySizes[i].NonceSize());
-	}
-
-	if (!m_cipherMode.ParallelProfile().IsDefault())
-	{
-		m_cipherMode.ParallelProfile().Calculate(m_parallelProfile.IsParallel(), m_cipherMode.ParallelProfile().ParallelBlockSize(), m_cipherMode.ParallelProfile().ParallelMaxDegree());
-	}
+	return m_gcmMode->Verify(Input, Offset, Length);
 }
 
-NAMESPACE_MODEEND
\ No newline at end of file
+NAMESPACE_MODEEND
@@ -32,9 +32,7 @@
 #ifndef CEX_GCM_H
 #define CEX_GCM_H
 
-#include "IAeadMode.h"
-#include "CTR.h"
-#include "GHASH.h"
+#include "GCMT.h"
 
 NAMESPACE_MODE
 
@@ -119,6 +117,9 @@ NAMESPACE_MODE
 /// <item><description>ParallelBlockSize() is calculated automatically based on the processor(s) L1 data cache size, this property can be user defined, and must be evenly divisible by ParallelMinimumSize().</description></item>
 /// <item><description>The ParallelBlockSize() can be changed through the ParallelProfile() property</description></item>
 /// <item><description>Parallel block calculation ex. <c>ParallelBlockSize = N - (N % .ParallelMinimumSize);</c></description></item>
+/// <item><description>Many small messages can be processed under one key with the SealBatch and OpenBatch functions; the counters of consecutive packets are staggered into one wide SIMD transform, and the packets are hashed as interleaved lanes; with carry-less multiply GHASH steps four packets together, eight blocks per reduction.</description></item>
+/// <item><description>A single message under a fresh key can be processed without constructing the mode with AeadOneShot::GcmSeal and GcmOpen, which keep the AES-NI key schedule and hash state on the stack.</description></item>
+/// <item><description>The mode is implemented by the GCMT&lt;TCipher&gt; template in GCMT.h; this class wraps GCMT&lt;IBlockCipher&gt;. When the cipher type is known at compile time, GCMT with a final cipher class, ex. GCMT&lt;AHX&gt;, produces the same output without the virtual calls in the key-stream loops.</description></item>
 /// </list>
 /// 
 /// <description>Guiding Publications:</description>
@@ -132,32 +133,9 @@ class GCM final : public IAeadMode
 {
 private:
 
-	static const size_t BLOCK_SIZE = 16;
-	static const std::string CLASS_NAME;
-	static const size_t MAX_PRLALLOC = 100000000;
-	static const size_t MIN_TAGSIZE = 12;
-
-	std::vector<byte> m_aadData;
-	bool m_aadLoaded;
-	bool m_aadPreserve;
-	size_t m_aadSize;
-	bool m_autoIncrement;
-	std::vector<byte> m_checkSum;
-	CTR m_cipherMode;
 	BlockCiphers m_cipherType;
-	bool m_destroyEngine;
-	Mac::GHASH* m_gcmHash;
-	std::vector<byte> m_gcmKey;
-	std::vector<byte> m_gcmNonce;
-	std::vector<byte> m_gcmVector;
+	std::unique_ptr<GCMT<IBlockCipher>> m_gcmMode;
 	bool m_isDestroyed;
-	bool m_isEncryption;
-	bool m_isFinalized;
-	bool m_isInitialized;
-	std::vector<SymmetricKeySize> m_legalKeySizes;
-	size_t m_msgSize;
-	std::vector<byte> m_msgTag;
-	ParallelOptions m_parallelProfile;
 
 public:
 
@@ -288,6 +266,19 @@ public:
 
 	//~~~Public Functions~~~//
 
+	/// <summary>
+	/// Create an initialized copy of this cipher mode.
+	/// <para>The block cipher is copied with its Clone() function and the GHASH key and its precomputed powers are copied, so neither the key schedule nor the hash key is derived again; the copy owns its cipher instance.
+	/// The nonce, counter position, message and associated data state, and the parallel profile are copied.
+	/// The copy can be given a new nonce by calling Initialize with a key that contains only the nonce.
+	/// The caller is responsible for destroying the returned mode.</para>
+	/// </summary>
+	///
+	/// <returns>A new, initialized GCM instance</returns>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the cipher mode has not been initialized</exception>
+	GCM* Clone() override;
+
 	/// <summary>
 	/// Decrypt a single block of bytes.
 	/// <para>Decrypts one block of bytes beginning at a zero index.
@@ -366,6 +357,25 @@ public:
 	/// <exception cref="CryptoCipherModeException">Thrown if a null or invalid Key/Nonce is used</exception>
 	void Initialize(bool Encryption, ISymmetricKey &KeyParams) override;
 
+	/// <summary>
+	/// Decrypt and authenticate a batch of packets under the current key.
+	/// <para>Each packet is processed with its own nonce and associated data, the key schedule and GHASH key are shared by the batch.
+	/// The tag of every packet is verified; the output of a packet that fails authentication is zeroed, and its Authentic flag is set to false.
+	/// The batch functions do not change the state of the streaming interface; Initialize(bool, ISymmetricKey) must have been called with a key before this method can be used.</para>
+	/// </summary>
+	///
+	/// <param name="Packets">The packet descriptors; the Authentic member of each packet is set by this function</param>
+	/// <param name="Associated">The array containing the associated data of each packet</param>
+	/// <param name="Input">The array containing the cipher-text of each packet</param>
+	/// <param name="Output">The array receiving the plain-text of each packet</param>
+	/// <param name="Tags">The array containing the expected tag of each packet</param>
+	/// <param name="TagLength">The byte length of each tag; must be no less than the MinTagSize() size and no greater than the MaxTagSize()</param>
+	///
+	/// <returns>Returns true if every packet in the batch was authenticated</returns>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the cipher has not been keyed, or the tag length is invalid</exception>
+	bool OpenBatch(std::vector<AeadPacket> &Packets, const std::vector<byte> &Associated, const std::vector<byte> &Input, std::vector<byte> &Output, const std::vector<byte> &Tags, const size_t TagLength);
+
 	/// <summary>
 	/// Set the maximum number of threads allocated when using multi-threaded processing.
 	/// <para>When set to zero, thread count is set automatically. If set to 1, sets IsParallel() to false and runs in sequential mode. 
@@ -377,6 +387,23 @@ public:
 	/// <exception cref="Exception::CryptoCipherModeException">Thrown if an invalid degree setting is used</exception>
 	void ParallelMaxDegree(size_t Degree) override;
 
+	/// <summary>
+	/// Encrypt and authenticate a batch of packets under the current key.
+	/// <para>Each packet is processed with its own nonce and associated data, the key schedule and GHASH key are shared by the batch.
+	/// The counter blocks of consecutive packets are generated together through the ciphers wide transform, and the packets are hashed as interleaved GHASH lanes, four packets at a time with eight blocks per reduction.
+	/// The batch functions do not change the state of the streaming interface; Initialize(bool, ISymmetricKey) must have been called with a key before this method can be used.</para>
+	/// </summary>
+	///
+	/// <param name="Packets">The packet descriptors</param>
+	/// <param name="Associated">The array containing the associated data of each packet</param>
+	/// <param name="Input">The array containing the plain-text of each packet</param>
+	/// <param name="Output">The array receiving the cipher-text of each packet</param>
+	/// <param name="Tags">The array receiving the tag of each packet</param>
+	/// <param name="TagLength">The byte length of each tag; must be no less than the MinTagSize() size and no greater than the MaxTagSize()</param>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the cipher has not been keyed, or the tag length is invalid</exception>
+	void SealBatch(const std::vector<AeadPacket> &Packets, const std::vector<byte> &Associated, const std::vector<byte> &Input, std::vector<byte> &Output, std::vector<byte> &Tags, const size_t TagLength);
+
 	/// <summary>
 	/// Add additional data to the authentication generator.  
 	/// <para>Must be called after Initialize(bool, ISymmetricKey), and before any processing of plaintext or ciphertext input. 
@@ -425,11 +452,7 @@ public:
 
 private:
 
-	void CalculateMac();
-	void Decrypt128(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset);
-	void Encrypt128(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset);
-	void Reset();
-	void Scope();
+	GCM(GCMT<IBlockCipher>* Mode, BlockCiphers CipherType);
 };
 
 NAMESPACE_MODEEND
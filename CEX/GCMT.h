@@ -0,0 +1,999 @@
+// The GPL version 3 License (GPLv3)
+//
+// Copyright (c) 2017 vtdev.com
+// This file is part of the CEX Cryptographic library.
+//
+// This program is free software : you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+//
+// Implementation Details:
+// A cipher specialized template of the Galois/Counter authenticated mode (GCM); the GCM class is this template instantiated with the IBlockCipher interface.
+
+#ifndef CEX_GCMT_H
+#define CEX_GCMT_H
+
+#include "IAeadMode.h"
+#include "AeadPacket.h"
+#include "CTRT.h"
+#include "GHASH.h"
+#include "SymmetricKey.h"
+
+NAMESPACE_MODE
+
+/// <summary>
+/// A Galois/Counter Authenticated Block Cipher Mode template, specialized at compile time for a block cipher type
+/// </summary>
+///
+/// <example>
+/// <description>Encrypting and authenticating a packet with a specialized AES-NI GCM:</description>
+/// <code>
+/// GCMT&lt;AHX&gt; cipher;
+/// // initialize for encryption
+/// cipher.Initialize(true, SymmetricKey(Key, Nonce));
+/// // encrypt the packet
+/// cipher.Transform(Input, 0, Output, 0, Input.size());
+/// // append the mac code to the output
+/// cipher.Finalize(Output, Input.size(), 16);
+/// </code>
+/// </example>
+///
+/// <remarks>
+/// <para>GCMT is the single implementation of the GCM mode; the GCM class wraps GCMT&lt;IBlockCipher&gt;, so the two produce identical output.
+/// The counter mode is a CTRT member specialized for the same cipher type; with a final cipher class the key-stream loops call the cipher directly rather than through the vtable, and the SIMD width is fixed at compile time.
+/// A nonce-only re-initialization, either by calling Initialize with an empty key or through AutoIncrement(), resets the counter without expanding the cipher key again.
+/// The class implements IAeadMode, and can be used anywhere the interface is accepted.</para>
+///
+/// <list type="bullet">
+/// <item><description>The template parameter is a block cipher class, ex. GCMT&lt;AHX&gt;; the constructor arguments are forwarded to the ciphers constructor, or a cipher instance is passed to the GCMT(TCipher*, bool) constructor.</description></item>
+/// <item><description>Many small messages can be processed under one key with the SealBatch and OpenBatch functions.</description></item>
+/// <item><description>Clone() copies the keyed cipher and the GHASH key into a new instance.</description></item>
+/// <item><description>A nonce of 12 bytes is recommended, other nonce lengths are compressed with GHASH.</description></item>
+/// <item><description>The MAC code length is between 12 and 16 bytes.</description></item>
+/// </list>
+/// </remarks>
+template <typename TCipher>
+class GCMT final : public IAeadMode
+{
+private:
+
+	static const size_t BATCH_WINDOW = 64 * 1024;
+	static const size_t BLOCK_SIZE = 16;
+	static const size_t MIN_TAGSIZE = 12;
+
+	std::vector<byte> m_aadData;
+	bool m_aadLoaded;
+	bool m_aadPreserve;
+	size_t m_aadSize;
+	bool m_autoIncrement;
+	std::vector<byte> m_checkSum;
+	CTRT<TCipher> m_cipherMode;
+	Mac::GHASH* m_gcmHash;
+	std::vector<byte> m_gcmNonce;
+	std::vector<byte> m_gcmVector;
+	bool m_isDestroyed;
+	bool m_isEncryption;
+	bool m_isFinalized;
+	bool m_isInitialized;
+	std::vector<SymmetricKeySize> m_legalKeySizes;
+	size_t m_msgSize;
+	std::vector<byte> m_msgTag;
+
+public:
+
+	GCMT(const GCMT&) = delete;
+	GCMT& operator=(const GCMT&) = delete;
+	GCMT& operator=(GCMT&&) = delete;
+
+	//~~~Properties~~~//
+
+	/// <summary>
+	/// Get/Set: Enable auto-incrementing of the input nonce, each time the Finalize method is called.
+	/// <para>Treats the Nonce value loaded during Initialize as a monotonic counter;
+	/// incrementing the value by 1 and re-calculating the working set each time the cipher is finalized.
+	/// If set to false, requires a re-key after each finalizer cycle.<para>
+	/// </summary>
+	bool &AutoIncrement() override
+	{
+		return m_autoIncrement;
+	}
+
+	/// <summary>
+	/// Get: Block size of internal cipher in bytes
+	/// </summary>
+	const size_t BlockSize() override
+	{
+		return BLOCK_SIZE;
+	}
+
+	/// <summary>
+	/// Get: The block ciphers formal type name
+	/// </summary>
+	const BlockCiphers CipherType() override
+	{
+		return m_cipherMode.CipherType();
+	}
+
+	/// <summary>
+	/// Get: The underlying Block Cipher instance
+	/// </summary>
+	IBlockCipher* Engine() override
+	{
+		return m_cipherMode.Engine();
+	}
+
+	/// <summary>
+	/// Get: The Cipher Modes enumeration type name
+	/// </summary>
+	const CipherModes Enumeral() override
+	{
+		return CipherModes::GCM;
+	}
+
+	/// <summary>
+	/// Get: True if initialized for encryption, False for decryption
+	/// </summary>
+	const bool IsEncryption() override
+	{
+		return m_isEncryption;
+	}
+
+	/// <summary>
+	/// Get: The Block Cipher is ready to transform data
+	/// </summary>
+	const bool IsInitialized() override
+	{
+		return m_isInitialized;
+	}
+
+	/// <summary>
+	/// Get: Processor parallelization availability.
+	/// <para>Indicates whether parallel processing is available with this mode.
+	/// If parallel capable, input/output data arrays passed to the transform must be ParallelBlockSize in bytes to trigger parallelization.</para>
+	/// </summary>
+	const bool IsParallel() override
+	{
+		return m_cipherMode.IsParallel();
+	}
+
+	/// <summary>
+	/// Get: Array of allowed cipher input key byte-sizes
+	/// </summary>
+	const std::vector<SymmetricKeySize> &LegalKeySizes() override
+	{
+		return m_legalKeySizes;
+	}
+
+	/// <summary>
+	/// Get: The maximum legal tag length in bytes
+	/// </summary>
+	const size_t MaxTagSize() override
+	{
+		return BLOCK_SIZE;
+	}
+
+	/// <summary>
+	/// Get: The minimum legal tag length in bytes
+	/// </summary>
+	const size_t MinTagSize() override
+	{
+		return MIN_TAGSIZE;
+	}
+
+	/// <summary>
+	/// Get: The cipher mode name
+	/// </summary>
+	const std::string Name() override
+	{
+		return std::string("GCM-") + m_cipherMode.Engine()->Name();
+	}
+
+	/// <summary>
+	/// Get: Parallel block size; the byte-size of the input/output data arrays passed to a transform that trigger parallel processing.
+	/// <para>This value can be changed through the ParallelProfile class.<para>
+	/// </summary>
+	const size_t ParallelBlockSize() override
+	{
+		return m_cipherMode.ParallelBlockSize();
+	}
+
+	/// <summary>
+	/// Get/Set: Parallel and SIMD capability flags and sizes
+	/// <para>Changes to these values must be made before the <see cref="Initialize(SymmetricKey)"/> function is called.</para>
+	/// </summary>
+	ParallelOptions &ParallelProfile() override
+	{
+		return m_cipherMode.ParallelProfile();
+	}
+
+	/// <summary>
+	/// Get/Set: Persist a one-time associated data for the entire session.
+	/// <para>Allows the use of a single SetAssociatedData() call to apply the MAC data to all segments.
+	/// Finalize and Verify can be called multiple times, applying the initial associated data to each finalize cycle.<para>
+	/// </summary>
+	bool &PreserveAD() override
+	{
+		return m_aadPreserve;
+	}
+
+	/// <summary>
+	/// Get: Returns the full finalized MAC code value array
+	/// </summary>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the cipher has not been finalized</exception>
+	const std::vector<byte> Tag() override
+	{
+		if (!m_isFinalized)
+			throw CryptoCipherModeException("GCMT:Tag", "The cipher mode has not been finalized!");
+
+		return m_msgTag;
+	}
+
+	//~~~Constructor~~~//
+
+	/// <summary>
+	/// Initialize the Cipher Mode, constructing the block cipher member
+	/// </summary>
+	///
+	/// <param name="CipherArgs">The block cipher constructor arguments, ex. the HKDF digest type and the number of rounds; can be empty</param>
+	template <typename... TArgs>
+	explicit GCMT(TArgs&&... CipherArgs)
+		:
+		m_aadData(0),
+		m_aadLoaded(false),
+		m_aadPreserve(false),
+		m_aadSize(0),
+		m_autoIncrement(false),
+		m_checkSum(BLOCK_SIZE),
+		m_cipherMode(std::forward<TArgs>(CipherArgs)...),
+		m_gcmHash(0),
+		m_gcmNonce(0),
+		m_gcmVector(0),
+		m_isDestroyed(false),
+		m_isEncryption(false),
+		m_isFinalized(false),
+		m_isInitialized(false),
+		m_legalKeySizes(0),
+		m_msgSize(0),
+		m_msgTag(BLOCK_SIZE)
+	{
+		Scope();
+	}
+
+	/// <summary>
+	/// Initialize the Cipher Mode using a block cipher instance
+	/// </summary>
+	///
+	/// <param name="Cipher">An uninitialized Block Cipher instance; can not be null</param>
+	/// <param name="DestroyEngine">Delete the cipher when the mode is destroyed</param>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if a null block cipher is used</exception>
+	GCMT(TCipher* Cipher, bool DestroyEngine)
+		:
+		m_aadData(0),
+		m_aadLoaded(false),
+		m_aadPreserve(false),
+		m_aadSize(0),
+		m_autoIncrement(false),
+		m_checkSum(BLOCK_SIZE),
+		m_cipherMode(Cipher, DestroyEngine),
+		m_gcmHash(0),
+		m_gcmNonce(0),
+		m_gcmVector(0),
+		m_isDestroyed(false),
+		m_isEncryption(false),
+		m_isFinalized(false),
+		m_isInitialized(false),
+		m_legalKeySizes(0),
+		m_msgSize(0),
+		m_msgTag(BLOCK_SIZE)
+	{
+		Scope();
+	}
+
+	/// <summary>
+	/// Finalize objects
+	/// </summary>
+	~GCMT() override
+	{
+		Destroy();
+	}
+
+	//~~~Public Functions~~~//
+
+	/// <summary>
+	/// Create an initialized copy of this cipher mode.
+	/// <para>The block cipher is copied with its Clone() function and the GHASH key and its precomputed powers are copied, so neither the key schedule nor the hash key is derived again; the copy owns its cipher instance.
+	/// The nonce, counter position, message and associated data state, and the parallel profile are copied.
+	/// The copy can be given a new nonce by calling Initialize with a key that contains only the nonce.
+	/// The caller is responsible for destroying the returned mode.</para>
+	/// </summary>
+	///
+	/// <returns>A new, initialized GCMT instance</returns>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the cipher mode has not been initialized</exception>
+	GCMT* Clone() override
+	{
+		if (!m_isInitialized)
+			throw CryptoCipherModeException("GCMT:Clone", "The cipher mode has not been initialized!");
+
+		GCMT* mode = new GCMT(static_cast<TCipher*>(m_cipherMode.Engine()->Clone()), true);
+		mode->m_aadData = m_aadData;
+		mode->m_aadLoaded = m_aadLoaded;
+		mode->m_aadPreserve = m_aadPreserve;
+		mode->m_aadSize = m_aadSize;
+		mode->m_autoIncrement = m_autoIncrement;
+		mode->m_checkSum = m_checkSum;
+		// the counter continues from the current position of this instance
+		std::vector<byte> zero(0);
+		Key::Symmetric::SymmetricKey ctrKey(zero, m_cipherMode.Nonce());
+		mode->m_cipherMode.Initialize(true, ctrKey);
+		mode->m_cipherMode.ParallelProfile() = m_cipherMode.ParallelProfile();
+		mode->m_gcmHash = new Mac::GHASH(*m_gcmHash);
+		mode->m_gcmNonce = m_gcmNonce;
+		mode->m_gcmVector = m_gcmVector;
+		mode->m_isEncryption = m_isEncryption;
+		mode->m_isFinalized = m_isFinalized;
+		mode->m_isInitialized = true;
+		mode->m_msgSize = m_msgSize;
+		mode->m_msgTag = m_msgTag;
+
+		return mode;
+	}
+
+	/// <summary>
+	/// Decrypt a single block of bytes.
+	/// <para>Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	///
+	/// <param name="Input">The input array of encrypted bytes</param>
+	/// <param name="Output">The output array of decrypted bytes</param>
+	void DecryptBlock(const std::vector<byte> &Input, std::vector<byte> &Output) override
+	{
+		Decrypt128(Input, 0, Output, 0);
+	}
+
+	/// <summary>
+	/// Decrypt a block of bytes with offset parameters.
+	/// <para>Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	///
+	/// <param name="Input">The input array of encrypted bytes</param>
+	/// <param name="InOffset">Starting offset within the input array</param>
+	/// <param name="Output">The output array of decrypted bytes</param>
+	/// <param name="OutOffset">Starting offset within the output array</param>
+	void DecryptBlock(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset) override
+	{
+		Decrypt128(Input, InOffset, Output, OutOffset);
+	}
+
+	/// <summary>
+	/// Release all resources associated with the object; optional, called by the finalizer
+	/// </summary>
+	void Destroy() override
+	{
+		if (!m_isDestroyed)
+		{
+			m_isDestroyed = true;
+			m_aadLoaded = false;
+			m_aadPreserve = false;
+			m_aadSize = 0;
+			m_autoIncrement = false;
+			m_isEncryption = false;
+			m_isFinalized = false;
+			m_isInitialized = false;
+			m_msgSize = 0;
+
+			if (m_gcmHash != 0)
+			{
+				m_gcmHash->Reset(true);
+				delete m_gcmHash;
+				m_gcmHash = 0;
+			}
+
+			Utility::IntUtils::ClearVector(m_aadData);
+			Utility::IntUtils::ClearVector(m_gcmNonce);
+			Utility::IntUtils::ClearVector(m_gcmVector);
+			Utility::IntUtils::ClearVector(m_legalKeySizes);
+			Utility::IntUtils::ClearVector(m_msgTag);
+			Utility::IntUtils::ClearVector(m_checkSum);
+			m_cipherMode.Destroy();
+		}
+	}
+
+	/// <summary>
+	/// Encrypt a single block of bytes.
+	/// <para>Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	///
+	/// <param name="Input">The input array of plain text bytes</param>
+	/// <param name="Output">The output array of encrypted bytes</param>
+	void EncryptBlock(const std::vector<byte> &Input, std::vector<byte> &Output) override
+	{
+		Encrypt128(Input, 0, Output, 0);
+	}
+
+	/// <summary>
+	/// Encrypt a block of bytes using offset parameters.
+	/// <para>Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	///
+	/// <param name="Input">The input array of plain text bytes</param>
+	/// <param name="InOffset">Starting offset within the input array</param>
+	/// <param name="Output">The output array of encrypted bytes</param>
+	/// <param name="OutOffset">Starting offset within the output array</param>
+	void EncryptBlock(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset) override
+	{
+		Encrypt128(Input, InOffset, Output, OutOffset);
+	}
+
+	/// <summary>
+	/// Calculate the MAC code (Tag) and copy it to the Output array.
+	/// <para>The output array must be of sufficient length to receive the MAC code.
+	/// This function finalizes the Encryption/Decryption cycle, all data must be processed before this function is called.
+	/// Initialize(bool, ISymmetricKey) must be called before the cipher can be re-used.</para>
+	/// </summary>
+	///
+	/// <param name="Output">The output array that receives the authentication code</param>
+	/// <param name="Offset">The starting offset within the output array</param>
+	/// <param name="Length">The number of MAC code bytes to write to the output array; must be between 12 and 16</param>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the cipher is not initialized, or output array is too small</exception>
+	void Finalize(std::vector<byte> &Output, const size_t Offset, const size_t Length) override
+	{
+		if (!m_isInitialized)
+			throw CryptoCipherModeException("GCMT:Finalize", "The cipher mode has not been initialized!");
+		if (Length < MIN_TAGSIZE || Length > BLOCK_SIZE)
+			throw CryptoCipherModeException("GCMT:Finalize", "The length must be minimum of 12 and maximum of MAC code size!");
+
+		CalculateMac();
+		Utility::MemUtils::Copy(m_msgTag, 0, Output, Offset, Length);
+	}
+
+	/// <summary>
+	/// Initialize the Cipher instance
+	/// </summary>
+	///
+	/// <param name="Encryption">True if cipher is used for encryption, False to decrypt</param>
+	/// <param name="KeyParams">SymmetricKey containing the encryption Key and Nonce.
+	/// <para>Adding a new nonce with an empty key re-initializes the mode without expanding the cipher key again.</para></param>
+	///
+	/// <exception cref="Exception::CryptoSymmetricCipherException">Thrown if a null or invalid key is used</exception>
+	void Initialize(bool Encryption, ISymmetricKey &KeyParams) override
+	{
+		if (KeyParams.Nonce().size() < 8)
+			throw CryptoSymmetricCipherException("GCMT:Initialize", "Requires a nonce of minimum 10 bytes in length!");
+
+		if (KeyParams.Key().size() == 0)
+		{
+			if (KeyParams.Nonce() == m_gcmNonce)
+				throw CryptoSymmetricCipherException("GCMT:Initialize", "The nonce can not be zeroised or repeating!");
+			if (m_gcmHash == 0)
+				throw CryptoSymmetricCipherException("GCMT:Initialize", "First initialization requires a key and nonce!");
+		}
+		else
+		{
+			if (!SymmetricKeySize::Contains(LegalKeySizes(), KeyParams.Key().size()))
+				throw CryptoSymmetricCipherException("GCMT:Initialize", "Invalid key size! Key must be one of the LegalKeySizes() in length.");
+
+			// key the cipher and generate the hash key
+			TCipher* cipher = static_cast<TCipher*>(m_cipherMode.Engine());
+			cipher->Initialize(true, KeyParams);
+			std::vector<byte> tmpH(BLOCK_SIZE);
+			const std::vector<byte> ZEROES(BLOCK_SIZE);
+			cipher->Transform(ZEROES, 0, tmpH, 0);
+
+			std::vector<ulong> gKey =
+			{
+				Utility::IntUtils::BeBytesTo64(tmpH, 0),
+				Utility::IntUtils::BeBytesTo64(tmpH, 8)
+			};
+
+			if (m_gcmHash != 0)
+			{
+				m_gcmHash->Reset(true);
+				delete m_gcmHash;
+			}
+
+			m_gcmHash = new Mac::GHASH(gKey);
+			Utility::MemUtils::Clear(tmpH, 0, tmpH.size());
+		}
+
+		m_isEncryption = Encryption;
+		m_gcmNonce = KeyParams.Nonce();
+		m_gcmVector = m_gcmNonce;
+
+		if (m_gcmVector.size() == 12)
+		{
+			m_gcmVector.resize(16);
+			m_gcmVector[15] = 1;
+		}
+		else
+		{
+			std::vector<byte> tmpN(BLOCK_SIZE);
+			m_gcmHash->ProcessSegment(m_gcmVector, 0, tmpN, m_gcmVector.size());
+			m_gcmHash->FinalizeBlock(tmpN, 0, m_gcmVector.size());
+			m_gcmVector = tmpN;
+		}
+
+		// the cipher is already keyed; set the counter only
+		std::vector<byte> zero(0);
+		Key::Symmetric::SymmetricKey ctrKey(zero, m_gcmVector);
+		m_cipherMode.Initialize(true, ctrKey);
+		std::vector<byte> tmpN(BLOCK_SIZE);
+		m_cipherMode.Transform(tmpN, 0, m_gcmVector, 0, BLOCK_SIZE);
+
+		if (m_isFinalized)
+		{
+			Utility::MemUtils::Clear(m_msgTag, 0, m_msgTag.size());
+			m_isFinalized = false;
+		}
+
+		m_isInitialized = true;
+	}
+
+	/// <summary>
+	/// Decrypt and authenticate a batch of packets under the current key.
+	/// <para>Each packet is processed with its own nonce and associated data, the key schedule and GHASH key are shared by the batch.
+	/// The tag of every packet is verified; the output of a packet that fails authentication is zeroed, and its Authentic flag is set to false.
+	/// The batch functions do not change the state of the streaming interface; Initialize(bool, ISymmetricKey) must have been called with a key before this method can be used.</para>
+	/// </summary>
+	///
+	/// <param name="Packets">The packet descriptors; the Authentic member of each packet is set by this function</param>
+	/// <param name="Associated">The array containing the associated data of each packet</param>
+	/// <param name="Input">The array containing the cipher-text of each packet</param>
+	/// <param name="Output">The array receiving the plain-text of each packet</param>
+	/// <param name="Tags">The array containing the expected tag of each packet</param>
+	/// <param name="TagLength">The byte length of each tag; must be no less than the MinTagSize() size and no greater than the MaxTagSize()</param>
+	///
+	/// <returns>Returns true if every packet in the batch was authenticated</returns>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the cipher has not been keyed, or the tag length is invalid</exception>
+	bool OpenBatch(std::vector<AeadPacket> &Packets, const std::vector<byte> &Associated, const std::vector<byte> &Input, std::vector<byte> &Output, const std::vector<byte> &Tags, const size_t TagLength)
+	{
+		if (m_gcmHash == 0)
+			throw CryptoCipherModeException("GCMT:OpenBatch", "The cipher mode has not been keyed!");
+		if (TagLength < MIN_TAGSIZE || TagLength > BLOCK_SIZE)
+			throw CryptoCipherModeException("GCMT:OpenBatch", "The length must be minimum of 12 and maximum of MAC code size!");
+
+		if (Packets.size() == 0)
+			return true;
+
+		std::vector<byte> tmpCodes(Packets.size() * BLOCK_SIZE);
+		bool isAuth = true;
+
+		BatchProcess(Packets, Associated, Input, Output, tmpCodes, false);
+
+		for (size_t i = 0; i < Packets.size(); ++i)
+		{
+			Packets[i].Authentic = Utility::IntUtils::Compare(tmpCodes, i * BLOCK_SIZE, Tags, Packets[i].TagOffset, TagLength);
+
+			if (!Packets[i].Authentic)
+			{
+				// never release unauthenticated plain-text
+				Utility::MemUtils::Clear(Output, Packets[i].OutOffset, Packets[i].Length);
+				isAuth = false;
+			}
+		}
+
+		Utility::MemUtils::Clear(tmpCodes, 0, tmpCodes.size());
+
+		return isAuth;
+	}
+
+	/// <summary>
+	/// Set the maximum number of threads allocated when using multi-threaded processing.
+	/// <para>When set to zero, thread count is set automatically. If set to 1, sets IsParallel() to false and runs in sequential mode.
+	/// Thread count must be an even number, and not exceed the number of processor cores.</para>
+	/// </summary>
+	///
+	/// <param name="Degree">The desired number of threads</param>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if an invalid degree setting is used</exception>
+	void ParallelMaxDegree(size_t Degree) override
+	{
+		if (Degree == 0)
+			throw CryptoCipherModeException("GCMT:ParallelMaxDegree", "Parallel degree can not be zero!");
+		if (Degree % 2 != 0)
+			throw CryptoCipherModeException("GCMT:ParallelMaxDegree", "Parallel degree must be an even number!");
+		if (Degree > m_cipherMode.ParallelProfile().ProcessorCount())
+			throw CryptoCipherModeException("GCMT:ParallelMaxDegree", "Parallel degree can not exceed processor count!");
+
+		m_cipherMode.ParallelProfile().SetMaxDegree(Degree);
+	}
+
+	/// <summary>
+	/// Encrypt and authenticate a batch of packets under the current key.
+	/// <para>Each packet is processed with its own nonce and associated data, the key schedule and GHASH key are shared by the batch.
+	/// The counter blocks of consecutive packets are generated together through the ciphers wide transform, and the packets are hashed as interleaved GHASH lanes, four packets at a time with eight blocks per reduction.
+	/// The batch functions do not change the state of the streaming interface; Initialize(bool, ISymmetricKey) must have been called with a key before this method can be used.</para>
+	/// </summary>
+	///
+	/// <param name="Packets">The packet descriptors</param>
+	/// <param name="Associated">The array containing the associated data of each packet</param>
+	/// <param name="Input">The array containing the plain-text of each packet</param>
+	/// <param name="Output">The array receiving the cipher-text of each packet</param>
+	/// <param name="Tags">The array receiving the tag of each packet</param>
+	/// <param name="TagLength">The byte length of each tag; must be no less than the MinTagSize() size and no greater than the MaxTagSize()</param>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the cipher has not been keyed, or the tag length is invalid</exception>
+	void SealBatch(const std::vector<AeadPacket> &Packets, const std::vector<byte> &Associated, const std::vector<byte> &Input, std::vector<byte> &Output, std::vector<byte> &Tags, const size_t TagLength)
+	{
+		if (m_gcmHash == 0)
+			throw CryptoCipherModeException("GCMT:SealBatch", "The cipher mode has not been keyed!");
+		if (TagLength < MIN_TAGSIZE || TagLength > BLOCK_SIZE)
+			throw CryptoCipherModeException("GCMT:SealBatch", "The length must be minimum of 12 and maximum of MAC code size!");
+
+		if (Packets.size() == 0)
+			return;
+
+		std::vector<byte> tmpCodes(Packets.size() * BLOCK_SIZE);
+
+		BatchProcess(Packets, Associated, Input, Output, tmpCodes, true);
+
+		for (size_t i = 0; i < Packets.size(); ++i)
+			Utility::MemUtils::Copy(tmpCodes, i * BLOCK_SIZE, Tags, Packets[i].TagOffset, TagLength);
+
+		Utility::MemUtils::Clear(tmpCodes, 0, tmpCodes.size());
+	}
+
+	/// <summary>
+	/// Add additional data to the message authentication code generator.
+	/// <para>Must be called after Initialize(bool, ISymmetricKey), and before any processing of plaintext or ciphertext input.
+	/// This function can only be called once per each initialization/finalization cycle.</para>
+	/// </summary>
+	///
+	/// <param name="Input">The input array of bytes to process</param>
+	/// <param name="Offset">Starting offset within the input array</param>
+	/// <param name="Length">The number of bytes to process</param>
+	///
+	/// <exception cref="Exception::CryptoSymmetricCipherException">Thrown if state has been processed</exception>
+	void SetAssociatedData(const std::vector<byte> &Input, const size_t Offset, const size_t Length) override
+	{
+		if (!m_isInitialized)
+			throw CryptoSymmetricCipherException("GCMT:SetAssociatedData", "The cipher has not been initialized!");
+		if (m_aadLoaded)
+			throw CryptoSymmetricCipherException("GCMT:SetAssociatedData", "The associated data has already been set!");
+
+		m_aadData.resize(Length);
+		Utility::MemUtils::Copy(Input, Offset, m_aadData, 0, Length);
+		m_gcmHash->ProcessSegment(Input, Offset, m_checkSum, Length);
+		m_aadSize = Length;
+		m_aadLoaded = true;
+	}
+
+	/// <summary>
+	/// Transform a length of bytes with offset parameters.
+	/// <para>This method processes a specified length of bytes, utilizing offsets incremented by the caller.
+	/// If IsParallel() is set to true, and the length is at least ParallelBlockSize(), the transform is run in parallel processing mode.
+	/// Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	///
+	/// <param name="Input">The input array of bytes to transform</param>
+	/// <param name="InOffset">Starting offset within the input array</param>
+	/// <param name="Output">The output array of transformed bytes</param>
+	/// <param name="OutOffset">Starting offset within the output array</param>
+	/// <param name="Length">The number of bytes to process</param>
+	void Transform(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset, const size_t Length) override
+	{
+		CexAssert(m_isInitialized, "The cipher mode has not been initialized!");
+		CexAssert(Utility::IntUtils::Min(Input.size() - InOffset, Output.size() - OutOffset) >= Length, "The data arrays are smaller than the the block-size!");
+
+		if (m_isEncryption)
+		{
+			m_cipherMode.Transform(Input, InOffset, Output, OutOffset, Length);
+			m_gcmHash->Update(Output, OutOffset, m_checkSum, Length);
+		}
+		else
+		{
+			m_gcmHash->Update(Input, InOffset, m_checkSum, Length);
+			m_cipherMode.Transform(Input, InOffset, Output, OutOffset, Length);
+		}
+
+		m_msgSize += Length;
+	}
+
+	/// <summary>
+	/// Generate the internal MAC code and compare it with the tag contained in the Input array.
+	/// <para>This function finalizes the Decryption cycle and generates the MAC tag.
+	/// The cipher must be set for Decryption and the cipher-text bytes fully processed before calling this function.
+	/// Verify can be called in place of a Finalize(Output, Offset, Length) call, or after finalization.
+	/// Initialize(bool, ISymmetricKey) must be called before the cipher can be re-used.</para>
+	/// </summary>
+	///
+	/// <param name="Input">The Input array containing the expected authentication code</param>
+	/// <param name="Offset">The starting offset within the input array</param>
+	/// <param name="Length">The number of bytes to compare; must be between 12 and 16</param>
+	///
+	/// <returns>Returns false if the MAC code does not match</returns>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the cipher is not initialized for decryption</exception>
+	bool Verify(const std::vector<byte> &Input, const size_t Offset, const size_t Length) override
+	{
+		if (m_isEncryption)
+			throw CryptoCipherModeException("GCMT:Verify", "The cipher mode has not been initialized for decryption!");
+		if (!m_isInitialized && !m_isFinalized)
+			throw CryptoCipherModeException("GCMT:Verify", "The cipher mode has not been initialized!");
+		if (Length < MIN_TAGSIZE || Length > BLOCK_SIZE)
+			throw CryptoCipherModeException("GCMT:Verify", "The length must be minimum of 12 and maximum of MAC code size!");
+
+		if (!m_isFinalized)
+			CalculateMac();
+
+		return Utility::IntUtils::Compare(m_msgTag, 0, Input, Offset, Length);
+	}
+
+private:
+
+	void BatchCounter(const std::vector<byte> &Nonce, std::vector<byte> &Output)
+	{
+		Utility::MemUtils::Clear(Output, 0, BLOCK_SIZE);
+
+		if (Nonce.size() == 12)
+		{
+			Utility::MemUtils::Copy(Nonce, 0, Output, 0, Nonce.size());
+			Output[15] = 1;
+		}
+		else
+		{
+			// J0 = GHASH(N || 0 || [len(N)]64)
+			std::vector<byte> lenBlk(BLOCK_SIZE);
+			m_gcmHash->ProcessSegment(Nonce, 0, Output, Nonce.size());
+			Utility::IntUtils::Be64ToBytes(static_cast<ulong>(Nonce.size()) * 8, lenBlk, 8);
+			m_gcmHash->ProcessBlock(lenBlk, 0, Output);
+		}
+	}
+
+	void BatchGenerate(std::vector<byte> &Output, const size_t Length)
+	{
+		TCipher* cipher = static_cast<TCipher*>(m_cipherMode.Engine());
+		size_t blkCtr = 0;
+
+	#if defined(__AVX512__)
+		const size_t AVX512BLK = 16 * BLOCK_SIZE;
+		const size_t PBKALN = Length - (Length % AVX512BLK);
+
+		// the counters are already staggered, transform 16 blocks with avx512
+		while (blkCtr != PBKALN)
+		{
+			cipher->Transform2048(Output, blkCtr, Output, blkCtr);
+			blkCtr += AVX512BLK;
+		}
+	#elif defined(__AVX2__)
+		const size_t AVX2BLK = 8 * BLOCK_SIZE;
+		const size_t PBKALN = Length - (Length % AVX2BLK);
+
+		// 8 blocks with avx2
+		while (blkCtr != PBKALN)
+		{
+			cipher->Transform1024(Output, blkCtr, Output, blkCtr);
+			blkCtr += AVX2BLK;
+		}
+	#elif defined(__AVX__)
+		const size_t AVXBLK = 4 * BLOCK_SIZE;
+		const size_t PBKALN = Length - (Length % AVXBLK);
+
+		// 4 blocks with sse
+		while (blkCtr != PBKALN)
+		{
+			cipher->Transform512(Output, blkCtr, Output, blkCtr);
+			blkCtr += AVXBLK;
+		}
+	#endif
+
+		while (blkCtr != Length)
+		{
+			cipher->EncryptBlock(Output, blkCtr, Output, blkCtr);
+			blkCtr += BLOCK_SIZE;
+		}
+	}
+
+	void BatchProcess(const std::vector<AeadPacket> &Packets, const std::vector<byte> &Associated, const std::vector<byte> &Input, std::vector<byte> &Output, std::vector<byte> &Codes, bool Encryption)
+	{
+		// the cipher-text is authenticated; it is the output when encrypting, and the input when decrypting
+		const std::vector<byte> &cprText = Encryption ? Output : Input;
+		std::vector<byte> hashBlk(0);
+		std::vector<size_t> hashLen(0);
+		std::vector<size_t> hashOffset(0);
+		std::vector<byte> hashState(0);
+		std::vector<byte> kstBlk(0);
+		std::vector<size_t> kstOffset(0);
+		std::vector<byte> tmpCtr(BLOCK_SIZE);
+		size_t grpEnd = 0;
+		size_t grpStart = 0;
+
+		while (grpStart != Packets.size())
+		{
+			// group consecutive packets up to the batch window; a packet larger than the window is processed alone
+			size_t grpLen = 0;
+			grpEnd = grpStart;
+
+			do
+			{
+				grpLen += BLOCK_SIZE + (((Packets[grpEnd].Length + BLOCK_SIZE - 1) / BLOCK_SIZE) * BLOCK_SIZE);
+				++grpEnd;
+			}
+			while (grpEnd != Packets.size() && grpLen + BLOCK_SIZE + Packets[grpEnd].Length <= BATCH_WINDOW);
+
+			kstBlk.resize(grpLen);
+			kstOffset.resize(grpEnd - grpStart);
+			size_t ctrOffset = 0;
+
+			// stagger the counters of every packet in the group: J0, J0+1 .. J0+n
+			for (size_t i = grpStart; i != grpEnd; ++i)
+			{
+				if (Packets[i].Nonce.size() < 8)
+					throw CryptoCipherModeException("GCMT:BatchProcess", "Requires a nonce of minimum 8 bytes in length!");
+
+				const size_t BLKCNT = (Packets[i].Length + BLOCK_SIZE - 1) / BLOCK_SIZE;
+				kstOffset[i - grpStart] = ctrOffset;
+				BatchCounter(Packets[i].Nonce, tmpCtr);
+
+				Utility::CounterUtils::BeGenerate128(tmpCtr, kstBlk, ctrOffset, BLKCNT + 1);
+				ctrOffset += (BLKCNT + 1) * BLOCK_SIZE;
+			}
+
+			// encrypt the counters of the whole group in-place with the wide transforms
+			BatchGenerate(kstBlk, grpLen);
+
+			if (Encryption)
+			{
+				for (size_t i = grpStart; i != grpEnd; ++i)
+				{
+					if (Packets[i].Length != 0)
+					{
+						Utility::MemUtils::XorBlock(Input, Packets[i].InOffset, kstBlk, kstOffset[i - grpStart] + BLOCK_SIZE, Packets[i].Length);
+						Utility::MemUtils::Copy(kstBlk, kstOffset[i - grpStart] + BLOCK_SIZE, Output, Packets[i].OutOffset, Packets[i].Length);
+					}
+				}
+			}
+
+			// lay out the hash input of each packet: A || 0* || C || 0* || [len(A)]64 || [len(C)]64
+			size_t hashPos = 0;
+			hashLen.resize(grpEnd - grpStart);
+			hashOffset.resize(grpEnd - grpStart);
+
+			for (size_t i = grpStart; i != grpEnd; ++i)
+				hashPos += (((Packets[i].AdLength + BLOCK_SIZE - 1) / BLOCK_SIZE) + ((Packets[i].Length + BLOCK_SIZE - 1) / BLOCK_SIZE) + 1) * BLOCK_SIZE;
+
+			hashBlk.resize(hashPos);
+			Utility::MemUtils::Clear(hashBlk, 0, hashBlk.size());
+			hashPos = 0;
+
+			for (size_t i = grpStart; i != grpEnd; ++i)
+			{
+				const AeadPacket &PKT = Packets[i];
+
+				hashOffset[i - grpStart] = hashPos;
+
+				if (PKT.AdLength != 0)
+					Utility::MemUtils::Copy(Associated, PKT.AdOffset, hashBlk, hashPos, PKT.AdLength);
+
+				hashPos += ((PKT.AdLength + BLOCK_SIZE - 1) / BLOCK_SIZE) * BLOCK_SIZE;
+
+				if (PKT.Length != 0)
+					Utility::MemUtils::Copy(cprText, Encryption ? PKT.OutOffset : PKT.InOffset, hashBlk, hashPos, PKT.Length);
+
+				hashPos += ((PKT.Length + BLOCK_SIZE - 1) / BLOCK_SIZE) * BLOCK_SIZE;
+				Utility::IntUtils::Be64ToBytes(static_cast<ulong>(PKT.AdLength) * 8, hashBlk, hashPos);
+				Utility::IntUtils::Be64ToBytes(static_cast<ulong>(PKT.Length) * 8, hashBlk, hashPos + 8);
+				hashPos += BLOCK_SIZE;
+				hashLen[i - grpStart] = hashPos - hashOffset[i - grpStart];
+			}
+
+			// the packets are hashed as independent lanes; GHASH steps four packets together, eight blocks per reduction with the precomputed powers of H
+			hashState.resize(hashLen.size() * BLOCK_SIZE);
+			Utility::MemUtils::Clear(hashState, 0, hashState.size());
+			m_gcmHash->ProcessLanes(hashBlk, hashOffset, hashLen, hashState);
+
+			// mask each hash with E(J0)
+			for (size_t i = grpStart; i != grpEnd; ++i)
+			{
+				Utility::MemUtils::XOR128(kstBlk, kstOffset[i - grpStart], hashState, (i - grpStart) * BLOCK_SIZE);
+				Utility::MemUtils::COPY128(hashState, (i - grpStart) * BLOCK_SIZE, Codes, i * BLOCK_SIZE);
+			}
+
+			if (!Encryption)
+			{
+				for (size_t i = grpStart; i != grpEnd; ++i)
+				{
+					if (Packets[i].Length != 0)
+					{
+						Utility::MemUtils::XorBlock(Input, Packets[i].InOffset, kstBlk, kstOffset[i - grpStart] + BLOCK_SIZE, Packets[i].Length);
+						Utility::MemUtils::Copy(kstBlk, kstOffset[i - grpStart] + BLOCK_SIZE, Output, Packets[i].OutOffset, Packets[i].Length);
+					}
+				}
+			}
+
+			grpStart = grpEnd;
+		}
+
+		Utility::MemUtils::Clear(hashBlk, 0, hashBlk.size());
+		Utility::MemUtils::Clear(hashState, 0, hashState.size());
+		Utility::MemUtils::Clear(kstBlk, 0, kstBlk.size());
+	}
+
+	void CalculateMac()
+	{
+		m_gcmHash->FinalizeBlock(m_checkSum, m_aadSize, m_msgSize);
+		Utility::MemUtils::XorBlock(m_gcmVector, 0, m_checkSum, 0, BLOCK_SIZE);
+		Utility::MemUtils::COPY128(m_checkSum, 0, m_msgTag, 0);
+		Reset();
+
+		if (m_autoIncrement)
+		{
+			std::vector<byte> tmpN = m_gcmNonce;
+			Utility::IntUtils::BeIncrement8(tmpN);
+			std::vector<byte> zero(0);
+			Key::Symmetric::SymmetricKey nonceKey(zero, tmpN);
+			Initialize(m_isEncryption, nonceKey);
+
+			if (m_aadPreserve)
+				m_gcmHash->ProcessSegment(m_aadData, 0, m_checkSum, m_aadData.size());
+		}
+
+		m_isFinalized = true;
+	}
+
+	void Decrypt128(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
+	{
+		CexAssert(m_isInitialized, "The cipher mode has not been initialized!");
+		CexAssert(Utility::IntUtils::Min(Input.size() - InOffset, Output.size() - OutOffset) >= BLOCK_SIZE, "The data arrays are smaller than the the block-size!");
+
+		m_gcmHash->Update(Input, InOffset, m_checkSum, BLOCK_SIZE);
+		m_cipherMode.EncryptBlock(Input, InOffset, Output, OutOffset);
+		m_msgSize += BLOCK_SIZE;
+	}
+
+	void Encrypt128(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
+	{
+		CexAssert(m_isInitialized, "The cipher mode has not been initialized!");
+		CexAssert(Utility::IntUtils::Min(Input.size() - InOffset, Output.size() - OutOffset) >= BLOCK_SIZE, "The data arrays are smaller than the the block-size!");
+
+		m_cipherMode.EncryptBlock(Input, InOffset, Output, OutOffset);
+		m_gcmHash->Update(Output, OutOffset, m_checkSum, BLOCK_SIZE);
+		m_msgSize += BLOCK_SIZE;
+	}
+
+	void Reset()
+	{
+		if (!m_aadPreserve)
+		{
+			if (m_aadSize != 0)
+				Utility::MemUtils::Clear(m_aadData, 0, m_aadData.size());
+
+			m_aadLoaded = false;
+			m_aadSize = 0;
+		}
+
+		m_gcmHash->Reset();
+		m_isInitialized = false;
+		Utility::MemUtils::Clear(m_gcmVector, 0, m_gcmVector.size());
+		Utility::MemUtils::Clear(m_checkSum, 0, m_checkSum.size());
+		m_msgSize = 0;
+	}
+
+	void Scope()
+	{
+		std::vector<SymmetricKeySize> keySizes = m_cipherMode.LegalKeySizes();
+		m_legalKeySizes.resize(keySizes.size());
+
+		for (size_t i = 0; i < m_legalKeySizes.size(); i++)
+		{
+			m_legalKeySizes[i] = SymmetricKeySize(keySizes[i].KeySize(), keySizes[i].NonceSize(), keySizes[i].NonceSize());
+		}
+	}
+};
+
+NAMESPACE_MODEEND
+#endif
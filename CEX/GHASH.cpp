@@ -2,7 +2,7 @@
 #include "CpuDetect.h"
 #include "IntUtils.h"
 #include "MemUtils.h"
-#if defined(__AVX2__)
+#if defined(__AVX__)
 #	include "Intrinsics.h"
 #	include <wmmintrin.h>
 #endif
@@ -19,11 +19,16 @@ bool GHASH::HasSimd128()
 GHASH::GHASH(std::vector<ulong> &Key)
 	:
 	m_ghashKey(Key),
+	m_ghashPowers(0),
 	m_hasCMul(false),
+	m_hasVCMul(false),
 	m_msgBuffer(BLOCK_SIZE),
 	m_msgOffset(0)
 {
 	Detect();
+
+	if (m_hasCMul)
+		ComputePowers();
 }
 
 GHASH::~GHASH()
@@ -54,8 +59,11 @@ void GHASH::Reset(bool Erase)
 	{
 		if (m_ghashKey.size() != 0)
 			Utility::MemUtils::Clear(m_ghashKey, 0, m_ghashKey.size() * sizeof(ulong));
+		if (m_ghashPowers.size() != 0)
+			Utility::MemUtils::Clear(m_ghashPowers, 0, m_ghashPowers.size());
 
 		m_hasCMul = false;
+		m_hasVCMul = false;
 	}
 
 	if (m_msgBuffer.size() != 0)
@@ -70,8 +78,76 @@ void GHASH::ProcessBlock(const std::vector<byte> &Input, size_t InOffset, std::v
 	GcmMultiply(Output);
 }
 
+void GHASH::ProcessLanes(const std::vector<byte> &Input, const std::vector<size_t> &Offsets, const std::vector<size_t> &Lengths, std::vector<byte> &Output)
+{
+	CexAssert(Offsets.size() == Lengths.size(), "The offset and length arrays must be the same size!");
+	CexAssert(Output.size() >= Lengths.size() * BLOCK_SIZE, "The output array is too small!");
+
+	if (m_hasCMul)
+	{
+		std::vector<size_t> blkCtr(Lengths.size());
+		std::vector<size_t> inOffset(Offsets);
+
+		for (size_t i = 0; i < Lengths.size(); ++i)
+			blkCtr[i] = Lengths[i] / BLOCK_SIZE;
+
+		// step four lanes together, the products of each lane are independent so their latencies overlap
+		for (size_t i = 0; i < Lengths.size(); i += 4)
+		{
+			const size_t LNECNT = Utility::IntUtils::Min(Lengths.size() - i, static_cast<size_t>(4));
+			size_t maxBlk = 0;
+
+			for (size_t j = i; j < i + LNECNT; ++j)
+				maxBlk = Utility::IntUtils::Max(maxBlk, blkCtr[j]);
+
+			while (maxBlk != 0)
+			{
+				MultiplyW8(Input, inOffset, blkCtr, Output, i, LNECNT);
+				maxBlk -= Utility::IntUtils::Min(maxBlk, static_cast<size_t>(8));
+			}
+		}
+	}
+	else
+	{
+		std::vector<byte> tmpX(BLOCK_SIZE);
+
+		for (size_t i = 0; i < Lengths.size(); ++i)
+		{
+			Utility::MemUtils::COPY128(Output, i * BLOCK_SIZE, tmpX, 0);
+			ProcessSegment(Input, Offsets[i], tmpX, Lengths[i]);
+			Utility::MemUtils::COPY128(tmpX, 0, Output, i * BLOCK_SIZE);
+		}
+
+		Utility::MemUtils::Clear(tmpX, 0, tmpX.size());
+	}
+}
+
 void GHASH::ProcessSegment(const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t Length)
 {
+	if (m_hasVCMul)
+	{
+		// aggregate four blocks per reduction
+		while (Length >= 4 * BLOCK_SIZE)
+		{
+			MultiplyW4(Input, InOffset, Output);
+			InOffset += 4 * BLOCK_SIZE;
+			Length -= 4 * BLOCK_SIZE;
+		}
+	}
+
+	if (m_hasCMul && Length >= 8 * BLOCK_SIZE)
+	{
+		// eight blocks per reduction, the whole blocks are consumed as a single lane
+		std::vector<size_t> blkCtr(1, Length / BLOCK_SIZE);
+		std::vector<size_t> inOffset(1, InOffset);
+
+		while (blkCtr[0] != 0)
+			MultiplyW8(Input, inOffset, blkCtr, Output, 0, 1);
+
+		InOffset = inOffset[0];
+		Length %= BLOCK_SIZE;
+	}
+
 	while (Length)
 	{
 		const size_t DIFF = Utility::IntUtils::Min(Length, BLOCK_SIZE);
@@ -102,6 +178,30 @@ void GHASH::Update(const std::vector<byte> &Input, size_t InOffset, std::vector<
 		Length -= RMD;
 		InOffset += RMD;
 
+		if (m_hasVCMul)
+		{
+			while (Length > 4 * BLOCK_SIZE)
+			{
+				MultiplyW4(Input, InOffset, Output);
+				Length -= 4 * BLOCK_SIZE;
+				InOffset += 4 * BLOCK_SIZE;
+			}
+		}
+
+		if (m_hasCMul && Length > 8 * BLOCK_SIZE)
+		{
+			// the last block is always buffered, it may be the partial final block
+			std::vector<size_t> blkCtr(1, (Length - 1) / BLOCK_SIZE);
+			std::vector<size_t> inOffset(1, InOffset);
+
+			Length -= blkCtr[0] * BLOCK_SIZE;
+
+			while (blkCtr[0] != 0)
+				MultiplyW8(Input, inOffset, blkCtr, Output, 0, 1);
+
+			InOffset = inOffset[0];
+		}
+
 		while (Length > BLOCK_SIZE)
 		{
 			ProcessBlock(Input, InOffset, Output);
@@ -117,10 +217,32 @@ void GHASH::Update(const std::vector<byte> &Input, size_t InOffset, std::vector<
 	}
 }
 
+void GHASH::ComputePowers()
+{
+	// H^8 .. H^1 in byte reflected order; a run of n blocks uses the last n powers
+	std::vector<byte> tmpH(BLOCK_SIZE);
+	Utility::IntUtils::Be64ToBytes(m_ghashKey[0], tmpH, 0);
+	Utility::IntUtils::Be64ToBytes(m_ghashKey[1], tmpH, 8);
+	m_ghashPowers.resize(8 * BLOCK_SIZE);
+
+	for (size_t i = 0; i < 8; ++i)
+	{
+		for (size_t j = 0; j < BLOCK_SIZE; ++j)
+			m_ghashPowers[((7 - i) * BLOCK_SIZE) + j] = tmpH[BLOCK_SIZE - 1 - j];
+
+		Multiply(m_ghashKey, tmpH);
+	}
+
+	Utility::MemUtils::Clear(tmpH, 0, tmpH.size());
+}
+
 void GHASH::Detect()
 {
 	Common::CpuDetect detect;
 	m_hasCMul = detect.CMUL() && detect.SSSE3();
+#if defined(CEX_HAS_VPCLMULQDQ)
+	m_hasVCMul = m_hasCMul && detect.VPCLMULQDQ() && detect.AVX512F();
+#endif
 }
 
 void GHASH::GcmMultiply(std::vector<byte> &X)
@@ -177,7 +299,7 @@ void GHASH::Multiply(const std::vector<ulong> &H, std::vector<byte> &X)
 
 void GHASH::MultiplyW(const std::vector<ulong> &H, std::vector<byte> &X)
 {
-#if defined(__AVX2__)
+#if defined(__AVX__)
 
 	const __m128i MASK = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
 	__m128i A = _mm_loadu_si128(reinterpret_cast<const __m128i*>(X.data()));
@@ -231,4 +353,184 @@ void GHASH::MultiplyW(const std::vector<ulong> &H, std::vector<byte> &X)
 #endif
 }
 
+void GHASH::MultiplyW4(const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &X)
+{
+#if defined(CEX_HAS_VPCLMULQDQ)
+
+	// ((X ^ I0) * H^4) ^ (I1 * H^3) ^ (I2 * H^2) ^ (I3 * H), the four products share one reduction
+	const __m128i MASK = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+	__m512i A = _mm512_loadu_si512(reinterpret_cast<const void*>(&Input[InOffset]));
+	__m512i B = _mm512_loadu_si512(reinterpret_cast<const void*>(&m_ghashPowers[4 * BLOCK_SIZE]));
+	__m512i W0, W1, W2, W3;
+	__m128i T0, T1, T2, T3, T4, T5;
+
+	A = _mm512_xor_si512(A, _mm512_inserti32x4(_mm512_setzero_si512(), _mm_loadu_si128(reinterpret_cast<const __m128i*>(X.data())), 0));
+	A = _mm512_shuffle_epi8(A, _mm512_broadcast_i32x4(MASK));
+	W0 = _mm512_clmulepi64_epi128(A, B, 0x00);
+	W1 = _mm512_clmulepi64_epi128(A, B, 0x01);
+	W2 = _mm512_clmulepi64_epi128(A, B, 0x10);
+	W3 = _mm512_clmulepi64_epi128(A, B, 0x11);
+	W1 = _mm512_xor_si512(W1, W2);
+	W2 = _mm512_bslli_epi128(W1, 8);
+	W1 = _mm512_bsrli_epi128(W1, 8);
+	W0 = _mm512_xor_si512(W0, W2);
+	W3 = _mm512_xor_si512(W3, W1);
+
+	// fold the four unreduced products, the reduction is linear
+	T0 = _mm_xor_si128(_mm_xor_si128(_mm512_castsi512_si128(W0), _mm512_extracti32x4_epi32(W0, 1)), _mm_xor_si128(_mm512_extracti32x4_epi32(W0, 2), _mm512_extracti32x4_epi32(W0, 3)));
+	T3 = _mm_xor_si128(_mm_xor_si128(_mm512_castsi512_si128(W3), _mm512_extracti32x4_epi32(W3, 1)), _mm_xor_si128(_mm512_extracti32x4_epi32(W3, 2), _mm512_extracti32x4_epi32(W3, 3)));
+
+	T4 = _mm_srli_epi32(T0, 31);
+	T0 = _mm_slli_epi32(T0, 1);
+	T5 = _mm_srli_epi32(T3, 31);
+	T3 = _mm_slli_epi32(T3, 1);
+	T2 = _mm_srli_si128(T4, 12);
+	T5 = _mm_slli_si128(T5, 4);
+	T4 = _mm_slli_si128(T4, 4);
+	T0 = _mm_or_si128(T0, T4);
+	T3 = _mm_or_si128(T3, T5);
+	T3 = _mm_or_si128(T3, T2);
+	T4 = _mm_slli_epi32(T0, 31);
+	T5 = _mm_slli_epi32(T0, 30);
+	T2 = _mm_slli_epi32(T0, 25);
+	T4 = _mm_xor_si128(T4, T5);
+	T4 = _mm_xor_si128(T4, T2);
+	T5 = _mm_srli_si128(T4, 4);
+	T3 = _mm_xor_si128(T3, T5);
+	T4 = _mm_slli_si128(T4, 12);
+	T0 = _mm_xor_si128(T0, T4);
+	T3 = _mm_xor_si128(T3, T0);
+	T4 = _mm_srli_epi32(T0, 1);
+	T1 = _mm_srli_epi32(T0, 2);
+	T2 = _mm_srli_epi32(T0, 7);
+	T3 = _mm_xor_si128(T3, T1);
+	T3 = _mm_xor_si128(T3, T2);
+	T3 = _mm_xor_si128(T3, T4);
+	T3 = _mm_shuffle_epi8(T3, MASK);
+
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(X.data()), T3);
+
+#else
+
+	for (size_t i = 0; i < 4; ++i)
+	{
+		Utility::MemUtils::XOR128(Input, InOffset + (i * BLOCK_SIZE), X, 0);
+		GcmMultiply(X);
+	}
+
+#endif
+}
+
+void GHASH::MultiplyW8(const std::vector<byte> &Input, std::vector<size_t> &Offsets, std::vector<size_t> &Blocks, std::vector<byte> &Output, size_t Lane, size_t Lanes)
+{
+#if defined(__AVX__)
+
+	// each lane: ((X ^ I0) * H^n) ^ (I1 * H^n-1) .. ^ (In-1 * H), n <= 8, the n products share one reduction
+	const __m128i MASK = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+	size_t blkCnt[4];
+	__m128i Z0[4];
+	__m128i Z1[4];
+	__m128i Z3[4];
+	__m128i A, B, T0, T1, T2, T3, T4, T5;
+
+	for (size_t i = 0; i < Lanes; ++i)
+	{
+		const size_t LNE = Lane + i;
+		const size_t BLKCNT = Utility::IntUtils::Min(Blocks[LNE], static_cast<size_t>(8));
+		const size_t PWROFF = (8 - BLKCNT) * BLOCK_SIZE;
+
+		blkCnt[i] = BLKCNT;
+		Z0[i] = _mm_setzero_si128();
+		Z1[i] = _mm_setzero_si128();
+		Z3[i] = _mm_setzero_si128();
+
+		for (size_t j = 0; j < BLKCNT; ++j)
+		{
+			A = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Input[Offsets[LNE] + (j * BLOCK_SIZE)]));
+
+			if (j == 0)
+				A = _mm_xor_si128(A, _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Output[LNE * BLOCK_SIZE])));
+
+			A = _mm_shuffle_epi8(A, MASK);
+			B = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&m_ghashPowers[PWROFF + (j * BLOCK_SIZE)]));
+			Z0[i] = _mm_xor_si128(Z0[i], _mm_clmulepi64_si128(A, B, 0x00));
+			Z1[i] = _mm_xor_si128(Z1[i], _mm_clmulepi64_si128(A, B, 0x01));
+			Z1[i] = _mm_xor_si128(Z1[i], _mm_clmulepi64_si128(A, B, 0x10));
+			Z3[i] = _mm_xor_si128(Z3[i], _mm_clmulepi64_si128(A, B, 0x11));
+		}
+
+		Offsets[LNE] += BLKCNT * BLOCK_SIZE;
+		Blocks[LNE] -= BLKCNT;
+	}
+
+	for (size_t i = 0; i < Lanes; ++i)
+	{
+		// an exhausted lane keeps its state
+		if (blkCnt[i] == 0)
+			continue;
+
+		T0 = Z0[i];
+		T1 = Z1[i];
+		T3 = Z3[i];
+		T2 = _mm_slli_si128(T1, 8);
+		T1 = _mm_srli_si128(T1, 8);
+		T0 = _mm_xor_si128(T0, T2);
+		T3 = _mm_xor_si128(T3, T1);
+		T4 = _mm_srli_epi32(T0, 31);
+		T0 = _mm_slli_epi32(T0, 1);
+		T5 = _mm_srli_epi32(T3, 31);
+		T3 = _mm_slli_epi32(T3, 1);
+		T2 = _mm_srli_si128(T4, 12);
+		T5 = _mm_slli_si128(T5, 4);
+		T4 = _mm_slli_si128(T4, 4);
+		T0 = _mm_or_si128(T0, T4);
+		T3 = _mm_or_si128(T3, T5);
+		T3 = _mm_or_si128(T3, T2);
+		T4 = _mm_slli_epi32(T0, 31);
+		T5 = _mm_slli_epi32(T0, 30);
+		T2 = _mm_slli_epi32(T0, 25);
+		T4 = _mm_xor_si128(T4, T5);
+		T4 = _mm_xor_si128(T4, T2);
+		T5 = _mm_srli_si128(T4, 4);
+		T3 = _mm_xor_si128(T3, T5);
+		T4 = _mm_slli_si128(T4, 12);
+		T0 = _mm_xor_si128(T0, T4);
+		T3 = _mm_xor_si128(T3, T0);
+		T4 = _mm_srli_epi32(T0, 1);
+		T1 = _mm_srli_epi32(T0, 2);
+		T2 = _mm_srli_epi32(T0, 7);
+		T3 = _mm_xor_si128(T3, T1);
+		T3 = _mm_xor_si128(T3, T2);
+		T3 = _mm_xor_si128(T3, T4);
+		T3 = _mm_shuffle_epi8(T3, MASK);
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&Output[(Lane + i) * BLOCK_SIZE]), T3);
+	}
+
+#else
+
+	std::vector<byte> tmpX(BLOCK_SIZE);
+
+	for (size_t i = Lane; i < Lane + Lanes; ++i)
+	{
+		const size_t BLKCNT = Utility::IntUtils::Min(Blocks[i], static_cast<size_t>(8));
+
+		Utility::MemUtils::COPY128(Output, i * BLOCK_SIZE, tmpX, 0);
+
+		for (size_t j = 0; j < BLKCNT; ++j)
+		{
+			Utility::MemUtils::XOR128(Input, Offsets[i] + (j * BLOCK_SIZE), tmpX, 0);
+			GcmMultiply(tmpX);
+		}
+
+		Utility::MemUtils::COPY128(tmpX, 0, Output, i * BLOCK_SIZE);
+		Offsets[i] += BLKCNT * BLOCK_SIZE;
+		Blocks[i] -= BLKCNT;
+	}
+
+	Utility::MemUtils::Clear(tmpX, 0, tmpX.size());
+
+#endif
+}
+
 NAMESPACE_MACEND
@@ -19,7 +19,9 @@ private:
 	static const std::string CLASS_NAME;
 
 	std::vector<ulong> m_ghashKey;
+	std::vector<byte> m_ghashPowers;
 	bool m_hasCMul;
+	bool m_hasVCMul;
 	std::vector<byte> m_msgBuffer;
 	size_t m_msgOffset;
 
@@ -67,6 +69,18 @@ public:
 	/// <param name="Output">The output array</param>
 	void ProcessBlock(const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output);
 
+	/// <summary>
+	/// Process a set of independent segments, each segment is hashed into its own state.
+	/// <para>The segment lengths must be multiples of the block size; the state of segment i is the 16 byte block at Output[i * 16].
+	/// With carry-less multiply, four segments are stepped together and each takes up to eight blocks per reduction.</para>
+	/// </summary>
+	///
+	/// <param name="Input">The source array</param>
+	/// <param name="Offsets">The offset of each segment within the source array</param>
+	/// <param name="Lengths">The byte length of each segment</param>
+	/// <param name="Output">The array of hash states</param>
+	void ProcessLanes(const std::vector<byte> &Input, const std::vector<size_t> &Offsets, const std::vector<size_t> &Lengths, std::vector<byte> &Output);
+
 	/// <summary>
 	/// Process one segment of data
 	/// </summary>
@@ -89,10 +103,13 @@ public:
 
 private:
 
+	void ComputePowers();
 	void Detect();
 	void GcmMultiply(std::vector<byte> &X);
 	void Multiply(const std::vector<ulong> &H, std::vector<byte> &X);
 	void MultiplyW(const std::vector<ulong> &H, std::vector<byte> &X);
+	void MultiplyW4(const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &X);
+	void MultiplyW8(const std::vector<byte> &Input, std::vector<size_t> &Offsets, std::vector<size_t> &Blocks, std::vector<byte> &Output, size_t Lane, size_t Lanes);
 };
 
 NAMESPACE_MACEND
@@ -129,6 +129,17 @@ public:
 
 	//~~~Public Functions~~~//
 
+	/// <summary>
+	/// Create an initialized copy of this cipher.
+	/// <para>The expanded key schedule and settings are copied, the key is not expanded again.
+	/// The caller is responsible for destroying the returned cipher.</para>
+	/// </summary>
+	///
+	/// <returns>A new cipher instance, ready to transform data</returns>
+	///
+	/// <exception cref="Exception::CryptoSymmetricCipherException">Thrown if the cipher has not been initialized</exception>
+	virtual IBlockCipher* Clone() = 0;
+
 	/// <summary>
 	/// Decrypt a single block of bytes.
 	/// <para><see cref="Initialize(bool, ISymmetricKey)"/> must be called with the Encryption flag set to <c>false</c> before this method can be used.
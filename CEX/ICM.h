@@ -27,7 +27,7 @@
 #ifndef CEX_ICM_H
 #define CEX_ICM_H
 
-#include "ICipherMode.h"
+#include "ICMT.h"
 
 NAMESPACE_MODE
 
@@ -95,6 +95,9 @@ NAMESPACE_MODE
 /// <item><description>ParallelBlockSize() is calculated automatically based on the processor(s) L1 data cache size, this property can be user defined, and must be evenly divisible by ParallelMinimumSize().</description></item>
 /// <item><description>The ParallelBlockSize() can be changed through the ParallelProfile() property</description></item>
 /// <item><description>Parallel block calculation ex. <c>ParallelBlockSize = N - (N % .ParallelMinimumSize);</c></description></item>
+/// <item><description>The key-stream is randomly accessible; Seek(ulong) moves the counter to a block aligned position, and the positional Transform(ulong, ...) processes data starting at any byte offset within the stream.</description></item>
+/// <item><description>Counter blocks are encrypted in a small cache resident buffer and xored with the input as the output is written, so the output array is written once.</description></item>
+/// <item><description>The mode is implemented by the ICMT&lt;TCipher&gt; template in ICMT.h; this class wraps ICMT&lt;IBlockCipher&gt;. When the cipher type is known at compile time, ICMT with a final cipher class, ex. ICMT&lt;AHX&gt;, produces the same output without the virtual calls in the key-stream loops.</description></item>
 /// </list>
 /// 
 /// <description>Guiding Publications:</description>
@@ -108,18 +111,9 @@ class ICM final : public ICipherMode
 {
 private:
 
-	static const size_t BLOCK_SIZE = 16;
-	static const std::string CLASS_NAME;
-
-	IBlockCipher* m_blockCipher;
 	BlockCiphers m_cipherType;
-	std::vector<ulong> m_ctrVector;
-	bool m_destroyEngine;
+	std::unique_ptr<ICMT<IBlockCipher>> m_icmMode;
 	bool m_isDestroyed;
-	bool m_isEncryption;
-	bool m_isInitialized;
-	bool m_isLoaded;
-	ParallelOptions m_parallelProfile;
 
 public:
 
@@ -214,6 +208,17 @@ public:
 
 	//~~~Public Functions~~~//
 
+	/// <summary>
+	/// Create an initialized copy of this cipher mode.
+	/// <para>The block cipher is copied with its Clone() function, so the key is not expanded again, and the copy owns its cipher instance.
+	/// The nonce and counter position, direction, and parallel profile are copied. The caller is responsible for destroying the returned mode.</para>
+	/// </summary>
+	///
+	/// <returns>A new, initialized ICM instance</returns>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the cipher mode has not been initialized</exception>
+	ICM* Clone() override;
+
 	/// <summary>
 	/// Decrypt a single block of bytes.
 	/// <para>Decrypts one block of bytes beginning at a zero index.
@@ -286,6 +291,33 @@ public:
 	/// <exception cref="Exception::CryptoCipherModeException">Thrown if an invalid degree setting is used</exception>
 	void ParallelMaxDegree(size_t Degree) override;
 
+	/// <summary>
+	/// Set the key-stream position.
+	/// <para>The counter is calculated directly from the initial nonce, the next transform call begins at the Position byte of the key-stream.
+	/// The position must be a multiple of the block size, use the positional Transform(ulong, ...) function to access an unaligned offset.
+	/// Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	///
+	/// <param name="Position">The block aligned byte offset within the key-stream</param>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the position is not block aligned</exception>
+	void Seek(ulong Position);
+
+	/// <summary>
+	/// Transform a length of bytes beginning at a key-stream position.
+	/// <para>Random access transform; the counter is set to the block containing Position, and a partial leading block is aligned to the offset.
+	/// Processing continues with the standard Transform, the counter is left positioned after the last processed block.
+	/// Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	///
+	/// <param name="Position">The byte offset within the key-stream corresponding to the first input byte</param>
+	/// <param name="Input">The input array of bytes to transform</param>
+	/// <param name="InOffset">Starting offset within the input array</param>
+	/// <param name="Output">The output array of transformed bytes</param>
+	/// <param name="OutOffset">Starting offset within the output array</param>
+	/// <param name="Length">The number of bytes to transform</param>
+	void Transform(ulong Position, const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset, const size_t Length);
+
 	/// <summary>
 	/// Transform a length of bytes with offset parameters. 
 	/// <para>This method processes a specified length of bytes, utilizing offsets incremented by the caller.
@@ -303,12 +335,7 @@ public:
 
 private:
 
-	void Convert(const std::vector<ulong> &Input, std::vector<byte> &Output, size_t OutOffset);
-	void Encrypt128(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset);
-	void Generate(std::vector<byte> &Output, const size_t OutOffset, const size_t Length, std::vector<ulong> &Counter);
-	void Scope();
-	void ProcessParallel(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset, const size_t Length);
-	void ProcessSequential(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset, const size_t Length);
+	ICM(ICMT<IBlockCipher>* Mode, BlockCiphers CipherType);
 };
 
 NAMESPACE_MODEEND
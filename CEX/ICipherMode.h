@@ -125,6 +125,17 @@ public:
 
 	//~~~Public Functions~~~//
 
+	/// <summary>
+	/// Create an initialized copy of this cipher mode.
+	/// <para>The block ciphers key schedule, the mode state, and the parallel profile are copied; the key is not expanded again.
+	/// The copy owns its cipher instance, and the caller is responsible for destroying the returned mode.</para>
+	/// </summary>
+	///
+	/// <returns>A new cipher mode instance, ready to transform data</returns>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the cipher mode has not been initialized</exception>
+	virtual ICipherMode* Clone() = 0;
+
 	/// <summary>
 	/// Decrypt a single block of bytes.
 	/// <para>Decrypts one block of bytes beginning at a zero index.
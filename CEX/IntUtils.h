@@ -663,26 +663,27 @@ public:
 	/// <param name="Output">The modified output byte array</param>
 	/// <param name="Length">The number to increase by</param>
 	template<typename Array>
-	inline static void BeIncrease8(const Array &Input, Array &Output, const size_t Length)
+	inline static void BeIncrease8(const Array &Input, Array &Output, const ulong Length)
 	{
 		CexAssert(sizeof(Output[0]) == sizeof(byte), "Input and Output must be an array of 8bit integers");
 		CexAssert(!std::numeric_limits<decltype(Output[0])>::is_signed, "Input and Output must be an unsigned integer array");
 
 		const int CTRSZE = (int)Output.size() - 1;
-		uint ctrLen = (uint)Length;
-		std::array<byte, sizeof(uint)> ctrInc;
+		ulong ctrLen = Length;
+		std::array<byte, sizeof(ulong)> ctrInc;
 
 		memcpy(&ctrInc[0], &ctrLen, ctrInc.size());
 		memcpy(&Output[0], &Input[0], Input.size());
-		byte carry = 0;
+		uint carry = 0;
 
 		for (int i = CTRSZE; i >= 0; --i)
 		{
 			byte odst = Output[i];
 			byte osrc = CTRSZE - i < (int)ctrInc.size() ? (byte)ctrInc[CTRSZE - i] : (byte)0;
-			byte ndst = (byte)(odst + osrc + carry);
-			carry = ndst < odst ? 1 : 0;
-			Output[i] = ndst;
+			// the sum is widened, so a carry out of an 0xFF offset byte is not lost
+			uint sum = (uint)odst + (uint)osrc + carry;
+			Output[i] = (byte)sum;
+			carry = sum >> 8;
 		}
 	}
 
@@ -0,0 +1,148 @@
+#include "KeyScheduleCache.h"
+#include "CSP.h"
+#include "IntUtils.h"
+#include "MemUtils.h"
+#include "SymmetricKey.h"
+
+NAMESPACE_BLOCK
+
+const std::string KeyScheduleCache::CLASS_NAME("KeyScheduleCache");
+
+//~~~Properties~~~//
+
+const size_t KeyScheduleCache::Capacity()
+{
+	return m_cacheCapacity;
+}
+
+const size_t KeyScheduleCache::Count()
+{
+	std::lock_guard<std::mutex> lock(m_syncLock);
+
+	return m_cacheList.size();
+}
+
+const std::string KeyScheduleCache::Name()
+{
+	return CLASS_NAME;
+}
+
+//~~~Constructor~~~//
+
+KeyScheduleCache::KeyScheduleCache(size_t Capacity)
+	:
+	m_cacheList(),
+	m_cacheIndex(),
+	m_cacheCapacity(Capacity),
+	m_isDestroyed(false),
+	m_syncLock(),
+	m_tagGenerator(Digests::SHA256)
+{
+	if (Capacity == 0)
+		throw CryptoSymmetricCipherException("KeyScheduleCache:CTor", "The cache capacity can not be zero!");
+
+	// the tag key is random and never leaves the class, so tags can not be precomputed from a guessed key
+	Provider::CSP rnd;
+	Key::Symmetric::SymmetricKey kp(rnd.GetBytes(TAG_SIZE));
+	m_tagGenerator.Initialize(kp);
+}
+
+KeyScheduleCache::~KeyScheduleCache()
+{
+	if (!m_isDestroyed)
+	{
+		m_isDestroyed = true;
+		Clear();
+		m_tagGenerator.Destroy();
+	}
+}
+
+//~~~Public Functions~~~//
+
+void KeyScheduleCache::Add(BlockCiphers CipherType, Digests KdfEngineType, size_t Rounds, const std::vector<byte> &Key, const std::vector<byte> &Info, const std::vector<byte> &Schedule)
+{
+	std::lock_guard<std::mutex> lock(m_syncLock);
+	std::vector<byte> tag(TAG_SIZE);
+
+	ComputeTag(CipherType, KdfEngineType, Rounds, Key, Info, Schedule.size(), tag);
+
+	std::map<std::vector<byte>, std::list<CacheEntry>::iterator>::iterator idx = m_cacheIndex.find(tag);
+
+	if (idx != m_cacheIndex.end())
+	{
+		// already cached by another instance; mark it as the most recent
+		m_cacheList.splice(m_cacheList.begin(), m_cacheList, idx->second);
+		return;
+	}
+
+	if (m_cacheList.size() == m_cacheCapacity)
+		Evict();
+
+	// construct in place so no temporary copy of the schedule is left in memory
+	m_cacheList.push_front(CacheEntry());
+	m_cacheList.front().Schedule = Schedule;
+	m_cacheList.front().Tag = tag;
+	m_cacheIndex[tag] = m_cacheList.begin();
+}
+
+void KeyScheduleCache::Clear()
+{
+	std::lock_guard<std::mutex> lock(m_syncLock);
+
+	for (std::list<CacheEntry>::iterator it = m_cacheList.begin(); it != m_cacheList.end(); ++it)
+		Utility::IntUtils::ClearVector(it->Schedule);
+
+	m_cacheList.clear();
+	m_cacheIndex.clear();
+}
+
+bool KeyScheduleCache::Find(BlockCiphers CipherType, Digests KdfEngineType, size_t Rounds, const std::vector<byte> &Key, const std::vector<byte> &Info, std::vector<byte> &Schedule)
+{
+	std::lock_guard<std::mutex> lock(m_syncLock);
+	std::vector<byte> tag(TAG_SIZE);
+
+	ComputeTag(CipherType, KdfEngineType, Rounds, Key, Info, Schedule.size(), tag);
+
+	std::map<std::vector<byte>, std::list<CacheEntry>::iterator>::iterator idx = m_cacheIndex.find(tag);
+
+	if (idx == m_cacheIndex.end())
+		return false;
+
+	Utility::MemUtils::Copy(idx->second->Schedule, 0, Schedule, 0, Schedule.size());
+	m_cacheList.splice(m_cacheList.begin(), m_cacheList, idx->second);
+
+	return true;
+}
+
+//~~~Private Functions~~~//
+
+void KeyScheduleCache::ComputeTag(BlockCiphers CipherType, Digests KdfEngineType, size_t Rounds, const std::vector<byte> &Key, const std::vector<byte> &Info, size_t Length, std::vector<byte> &Tag)
+{
+	// fixed size header; the key and info lengths make the encoding unambiguous
+	std::vector<byte> hdr(18);
+	hdr[0] = static_cast<byte>(CipherType);
+	hdr[1] = static_cast<byte>(KdfEngineType);
+	Utility::IntUtils::Le32ToBytes(static_cast<uint>(Rounds), hdr, 2);
+	Utility::IntUtils::Le32ToBytes(static_cast<uint>(Length), hdr, 6);
+	Utility::IntUtils::Le32ToBytes(static_cast<uint>(Key.size()), hdr, 10);
+	Utility::IntUtils::Le32ToBytes(static_cast<uint>(Info.size()), hdr, 14);
+
+	m_tagGenerator.Update(hdr, 0, hdr.size());
+	m_tagGenerator.Update(Key, 0, Key.size());
+
+	if (Info.size() != 0)
+		m_tagGenerator.Update(Info, 0, Info.size());
+
+	m_tagGenerator.Finalize(Tag, 0);
+}
+
+void KeyScheduleCache::Evict()
+{
+	std::list<CacheEntry>::iterator lru = std::prev(m_cacheList.end());
+
+	Utility::IntUtils::ClearVector(lru->Schedule);
+	m_cacheIndex.erase(lru->Tag);
+	m_cacheList.erase(lru);
+}
+
+NAMESPACE_BLOCKEND
@@ -0,0 +1,170 @@
+// The GPL version 3 License (GPLv3)
+//
+// Copyright (c) 2017 vtdev.com
+// This file is part of the CEX Cryptographic library.
+//
+// This program is free software : you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef CEX_KEYSCHEDULECACHE_H
+#define CEX_KEYSCHEDULECACHE_H
+
+#include "CexDomain.h"
+#include "BlockCiphers.h"
+#include "CryptoSymmetricCipherException.h"
+#include "Digests.h"
+#include "HMAC.h"
+#include <list>
+#include <map>
+#include <mutex>
+
+NAMESPACE_BLOCK
+
+using Enumeration::BlockCiphers;
+using Exception::CryptoSymmetricCipherException;
+using Enumeration::Digests;
+using Mac::HMAC;
+
+/// <summary>
+/// A bounded least-recently-used cache of HKDF expanded key schedules, shared by the HX extended block ciphers
+/// </summary>
+///
+/// <example>
+/// <description>Share a schedule cache between cipher instances:</description>
+/// <code>
+/// KeyScheduleCache cache(128);
+/// RHX cipher(Digests::SHA512, 22);
+/// cipher.KeyCache() = &amp;cache;
+/// // the first initialization runs HKDF and stores the schedule
+/// cipher.Initialize(true, KeyParams);
+/// // a later instance or session using the same key and info copies the cached schedule
+/// cipher.Rekey(KeyParams);
+/// </code>
+/// </example>
+///
+/// <remarks>
+/// <para>When an HX cipher (RHX, SHX, THX, or AHX) is constructed with a key derivation digest, every call to Initialize expands the cipher key into the round-key schedule with HKDF.
+/// With a cache assigned through the ciphers KeyCache() property, the HKDF output is stored after the first expansion, and subsequent expansions of the same key are a copy.</para>
+///
+/// <list type="bullet">
+/// <item><description>Entries are indexed by an HMAC(SHA256) tag of the cipher type, digest, rounds, schedule length, key, and info, keyed with a random secret drawn from the system provider when the cache is created; the raw key is never stored.</description></item>
+/// <item><description>The cache holds at most Capacity() schedules; when full, the least recently used schedule is evicted.</description></item>
+/// <item><description>Evicted schedules are erased from memory, and all schedules are erased by Clear() and the destructor.</description></item>
+/// <item><description>All functions are synchronized, a single cache can be shared by cipher instances running on different threads.</description></item>
+/// <item><description>The cache is not owned by the ciphers that use it, and must outlive them.</description></item>
+/// </list>
+/// </remarks>
+class KeyScheduleCache
+{
+private:
+
+	static const std::string CLASS_NAME;
+	static const size_t DEF_CAPACITY = 64;
+	static const size_t TAG_SIZE = 32;
+
+	struct CacheEntry
+	{
+		std::vector<byte> Schedule;
+		std::vector<byte> Tag;
+	};
+
+	std::list<CacheEntry> m_cacheList;
+	std::map<std::vector<byte>, std::list<CacheEntry>::iterator> m_cacheIndex;
+	size_t m_cacheCapacity;
+	bool m_isDestroyed;
+	std::mutex m_syncLock;
+	HMAC m_tagGenerator;
+
+public:
+
+	KeyScheduleCache(const KeyScheduleCache&) = delete;
+	KeyScheduleCache& operator=(const KeyScheduleCache&) = delete;
+	KeyScheduleCache& operator=(KeyScheduleCache&&) = delete;
+
+	//~~~Properties~~~//
+
+	/// <summary>
+	/// Get: The maximum number of schedules held by the cache
+	/// </summary>
+	const size_t Capacity();
+
+	/// <summary>
+	/// Get: The number of schedules currently held by the cache
+	/// </summary>
+	const size_t Count();
+
+	/// <summary>
+	/// Get: The class name
+	/// </summary>
+	const std::string Name();
+
+	//~~~Constructor~~~//
+
+	/// <summary>
+	/// Initialize the cache
+	/// </summary>
+	///
+	/// <param name="Capacity">The maximum number of key schedules held by the cache</param>
+	///
+	/// <exception cref="Exception::CryptoSymmetricCipherException">Thrown if the capacity is zero</exception>
+	explicit KeyScheduleCache(size_t Capacity = DEF_CAPACITY);
+
+	/// <summary>
+	/// Finalize objects
+	/// </summary>
+	~KeyScheduleCache();
+
+	//~~~Public Functions~~~//
+
+	/// <summary>
+	/// Add an expanded key schedule to the cache.
+	/// <para>If the cache is full, the least recently used schedule is erased and replaced.</para>
+	/// </summary>
+	///
+	/// <param name="CipherType">The block cipher type</param>
+	/// <param name="KdfEngineType">The key expansion digest type</param>
+	/// <param name="Rounds">The number of transformation rounds</param>
+	/// <param name="Key">The cipher input key</param>
+	/// <param name="Info">The key expansion info string; can be empty</param>
+	/// <param name="Schedule">The expanded key schedule</param>
+	void Add(BlockCiphers CipherType, Digests KdfEngineType, size_t Rounds, const std::vector<byte> &Key, const std::vector<byte> &Info, const std::vector<byte> &Schedule);
+
+	/// <summary>
+	/// Erase and remove all of the cached schedules
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// Find a cached schedule and copy it to the output array.
+	/// <para>The size of the Schedule array is part of the lookup, it must be sized to the expected schedule length.
+	/// A successful lookup marks the schedule as the most recently used.</para>
+	/// </summary>
+	///
+	/// <param name="CipherType">The block cipher type</param>
+	/// <param name="KdfEngineType">The key expansion digest type</param>
+	/// <param name="Rounds">The number of transformation rounds</param>
+	/// <param name="Key">The cipher input key</param>
+	/// <param name="Info">The key expansion info string; can be empty</param>
+	/// <param name="Schedule">The array receiving the key schedule</param>
+	///
+	/// <returns>Returns true if the schedule was found</returns>
+	bool Find(BlockCiphers CipherType, Digests KdfEngineType, size_t Rounds, const std::vector<byte> &Key, const std::vector<byte> &Info, std::vector<byte> &Schedule);
+
+private:
+
+	void ComputeTag(BlockCiphers CipherType, Digests KdfEngineType, size_t Rounds, const std::vector<byte> &Key, const std::vector<byte> &Info, size_t Length, std::vector<byte> &Tag);
+	void Evict();
+};
+
+NAMESPACE_BLOCKEND
+#endif
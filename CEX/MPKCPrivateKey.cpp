@@ -1,4 +1,5 @@
 #include "MPKCPrivateKey.h"
+#include "AsymmetricKeyImage.h"
 #include "IntUtils.h"
 
 NAMESPACE_ASYMMETRICKEY
@@ -22,18 +23,34 @@ MPKCPrivateKey::MPKCPrivateKey(MPKCParams Params, std::vector<byte> &S)
 	:
 	m_isDestroyed(false),
 	m_mpkcParameters(Params),
-	m_sCoeffs(S)
+	m_sCoeffs(S),
+	m_sView()
 {
+	m_sView = IO::ByteView(m_sCoeffs);
 }
 
 MPKCPrivateKey::MPKCPrivateKey(const std::vector<byte> &KeyStream)
 	:
-	m_isDestroyed(false)
+	m_isDestroyed(false),
+	m_sView()
 {
 	m_mpkcParameters = static_cast<MPKCParams>(KeyStream[0]);
 	uint sLen = Utility::IntUtils::LeBytesTo32(KeyStream, 1);
 	m_sCoeffs.resize(sLen);
 	Utility::MemUtils::Copy(KeyStream, 5, m_sCoeffs, 0, sLen);
+	m_sView = IO::ByteView(m_sCoeffs);
+}
+
+MPKCPrivateKey::MPKCPrivateKey(const IO::ByteView &Image)
+	:
+	m_isDestroyed(false),
+	m_mpkcParameters(MPKCParams::None),
+	m_sCoeffs(0),
+	m_sView()
+{
+	byte params;
+	m_sView = AsymmetricKeyImage::Open(Image, AsymmetricEngines::McEliece, AsymmetricKeyImage::KeyClass::PrivateKey, params);
+	m_mpkcParameters = static_cast<MPKCParams>(params);
 }
 
 MPKCPrivateKey::~MPKCPrivateKey()
@@ -49,6 +66,7 @@ void MPKCPrivateKey::Destroy()
 	{
 		m_isDestroyed = true;
 		m_mpkcParameters = MPKCParams::None;
+		m_sView = IO::ByteView();
 
 		if (m_sCoeffs.size() > 0)
 			Utility::IntUtils::ClearVector(m_sCoeffs);
@@ -57,13 +75,18 @@ void MPKCPrivateKey::Destroy()
 
 std::vector<byte> MPKCPrivateKey::ToBytes()
 {
-	uint sLen = static_cast<uint>(m_sCoeffs.size());
+	uint sLen = static_cast<uint>(m_sView.size());
 	std::vector<byte> s(sLen + 5);
 	s[0] = static_cast<byte>(m_mpkcParameters);
 	Utility::IntUtils::Le32ToBytes(sLen, s, 1);
-	Utility::MemUtils::Copy(s, 5, m_sCoeffs, 0, sLen);
+	Utility::MemUtils::Copy(m_sView, 0, s, 5, sLen);
 
 	return s;
 }
 
-NAMESPACE_ASYMMETRICKEYEND
\ No newline at end of file
+std::vector<byte> MPKCPrivateKey::ToImage()
+{
+	return AsymmetricKeyImage::Create(AsymmetricEngines::McEliece, static_cast<byte>(m_mpkcParameters), AsymmetricKeyImage::KeyClass::PrivateKey, m_sView);
+}
+
+NAMESPACE_ASYMMETRICKEYEND
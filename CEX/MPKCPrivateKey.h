@@ -2,6 +2,7 @@
 #define CEX_MPKCPRIVATEKEY_H
 
 #include "CexDomain.h"
+#include "ByteView.h"
 #include "IAsymmetricKey.h"
 #include "MPKCParams.h"
 
@@ -19,6 +20,7 @@ private:
 	bool m_isDestroyed;
 	MPKCParams m_mpkcParameters;
 	std::vector<byte> m_sCoeffs;
+	IO::ByteView m_sView;
 
 public:
 
@@ -41,8 +43,9 @@ public:
 
 	/// <summary>
 	/// Get: The private key polynomial
+	/// <para>For a key loaded from a mapped image, the view references the image memory.</para>
 	/// </summary>
-	const std::vector<byte> &S() { return m_sCoeffs; }
+	const IO::ByteView S() { return m_sView; }
 
 	//~~~Constructor~~~//
 
@@ -61,6 +64,17 @@ public:
 	/// <param name="KeyStream">The serialized private key</param>
 	explicit MPKCPrivateKey(const std::vector<byte> &KeyStream);
 
+	/// <summary>
+	/// Initialize this class with a key image, using the key in place
+	/// <para>The key is not copied; the image, typically the view of a MemoryMappedFile, must remain valid for the lifetime of this key.
+	/// Destroy() cannot erase a mapped key; protect the image file as the key itself.</para>
+	/// </summary>
+	/// 
+	/// <param name="Image">The key image created by ToImage()</param>
+	///
+	/// <exception cref="Exception::CryptoAsymmetricException">Thrown if the image does not contain a McEliece private key</exception>
+	explicit MPKCPrivateKey(const IO::ByteView &Image);
+
 	/// <summary>
 	/// Finalize objects
 	/// </summary>
@@ -77,6 +91,11 @@ public:
 	/// Serialize a private key to a byte array
 	/// </summary>
 	std::vector<byte> ToBytes() override;
+
+	/// <summary>
+	/// Serialize the private key to an aligned key image that can be memory mapped and used in place
+	/// </summary>
+	std::vector<byte> ToImage();
 };
 
 NAMESPACE_ASYMMETRICKEYEND
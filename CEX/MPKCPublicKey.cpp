@@ -1,4 +1,5 @@
 #include "MPKCPublicKey.h"
+#include "AsymmetricKeyImage.h"
 #include "IntUtils.h"
 
 NAMESPACE_ASYMMETRICKEY
@@ -15,9 +16,9 @@ const MPKCParams MPKCPublicKey::Parameters()
 	return m_mpkcParameters;
 }
 
-const std::vector<byte> &MPKCPublicKey::P()
+const IO::ByteView MPKCPublicKey::P()
 {
-	return m_pubMat;
+	return m_pubView;
 }
 
 //~~~Constructor~~~//
@@ -26,20 +27,36 @@ MPKCPublicKey::MPKCPublicKey(MPKCParams Params, const std::vector<byte> &P)
 	:
 	m_mpkcParameters(Params),
 	m_isDestroyed(false),
-	m_pubMat(P)
+	m_pubMat(P),
+	m_pubView()
 {
+	m_pubView = IO::ByteView(m_pubMat);
 }
 
 MPKCPublicKey::MPKCPublicKey(const std::vector<byte> &KeyStream)
 	:
 	m_isDestroyed(false),
 	m_mpkcParameters(MPKCParams::None),
-	m_pubMat(0)
+	m_pubMat(0),
+	m_pubView()
 {
 	m_mpkcParameters = static_cast<MPKCParams>(KeyStream[0]);
 	uint pLen = Utility::IntUtils::LeBytesTo32(KeyStream, 1);
 	m_pubMat.resize(pLen);
 	Utility::MemUtils::Copy(KeyStream, 5, m_pubMat, 0, pLen);
+	m_pubView = IO::ByteView(m_pubMat);
+}
+
+MPKCPublicKey::MPKCPublicKey(const IO::ByteView &Image)
+	:
+	m_isDestroyed(false),
+	m_mpkcParameters(MPKCParams::None),
+	m_pubMat(0),
+	m_pubView()
+{
+	byte params;
+	m_pubView = AsymmetricKeyImage::Open(Image, AsymmetricEngines::McEliece, AsymmetricKeyImage::KeyClass::PublicKey, params);
+	m_mpkcParameters = static_cast<MPKCParams>(params);
 }
 
 MPKCPublicKey::~MPKCPublicKey()
@@ -55,6 +72,7 @@ void MPKCPublicKey::Destroy()
 	{
 		m_isDestroyed = true;
 		m_mpkcParameters = MPKCParams::None;
+		m_pubView = IO::ByteView();
 
 		if (m_pubMat.size() > 0)
 			Utility::IntUtils::ClearVector(m_pubMat);
@@ -63,13 +81,18 @@ void MPKCPublicKey::Destroy()
 
 std::vector<byte> MPKCPublicKey::ToBytes()
 {
-	uint pLen = static_cast<uint>(m_pubMat.size());
+	uint pLen = static_cast<uint>(m_pubView.size());
 	std::vector<byte> p(pLen + 5);
 	p[0] = static_cast<byte>(m_mpkcParameters);
 	Utility::IntUtils::Le32ToBytes(pLen, p, 1);
-	Utility::MemUtils::Copy(m_pubMat, 0, p, 5, pLen);
+	Utility::MemUtils::Copy(m_pubView, 0, p, 5, pLen);
 
 	return p;
 }
 
-NAMESPACE_ASYMMETRICKEYEND
\ No newline at end of file
+std::vector<byte> MPKCPublicKey::ToImage()
+{
+	return AsymmetricKeyImage::Create(AsymmetricEngines::McEliece, static_cast<byte>(m_mpkcParameters), AsymmetricKeyImage::KeyClass::PublicKey, m_pubView);
+}
+
+NAMESPACE_ASYMMETRICKEYEND
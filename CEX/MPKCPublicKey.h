@@ -2,6 +2,7 @@
 #define CEX_MPKCPUUBLICKEY_H
 
 #include "CexDomain.h"
+#include "ByteView.h"
 #include "IAsymmetricKey.h"
 #include "MPKCParams.h"
 
@@ -18,6 +19,7 @@ private:
 
 	bool m_isDestroyed;
 	std::vector<byte> m_pubMat;
+	IO::ByteView m_pubView;
 	MPKCParams m_mpkcParameters;
 
 public:
@@ -41,8 +43,9 @@ public:
 
 	/// <summary>
 	/// Get: The public keys polynomial
+	/// <para>For a key loaded from a mapped image, the view references the image memory.</para>
 	/// </summary>
-	const std::vector<byte> &P();
+	const IO::ByteView P();
 
 	//~~~Constructor~~~//
 
@@ -61,6 +64,16 @@ public:
 	/// <param name="KeyStream">The serialized public key</param>
 	explicit MPKCPublicKey(const std::vector<byte> &KeyStream);
 
+	/// <summary>
+	/// Initialize this class with a key image, using the key in place
+	/// <para>The key is not copied; the image, typically the view of a MemoryMappedFile, must remain valid for the lifetime of this key.</para>
+	/// </summary>
+	/// 
+	/// <param name="Image">The key image created by ToImage()</param>
+	///
+	/// <exception cref="Exception::CryptoAsymmetricException">Thrown if the image does not contain a McEliece public key</exception>
+	explicit MPKCPublicKey(const IO::ByteView &Image);
+
 	/// <summary>
 	/// Finalize objects
 	/// </summary>
@@ -77,6 +90,11 @@ public:
 	/// Serialize a public key to a byte array
 	/// </summary>
 	std::vector<byte> ToBytes() override;
+
+	/// <summary>
+	/// Serialize the public key to an aligned key image that can be memory mapped and used in place
+	/// </summary>
+	std::vector<byte> ToImage();
 };
 
 NAMESPACE_ASYMMETRICKEYEND
@@ -1,4 +1,5 @@
 #include "McEliece.h"
+#include "AeadStream.h"
 #include "FFTM12T62.h"
 #include "GCM.h"
 #include "IntUtils.h"
@@ -51,13 +52,14 @@ std::vector<byte> &McEliece::Tag()
 
 //~~~Constructor~~~//
 
-McEliece::McEliece(MPKCParams Parameters, Prngs PrngType, BlockCiphers CipherType)
+McEliece::McEliece(MPKCParams Parameters, Prngs PrngType, BlockCiphers CipherType, bool Parallel)
 	:
 	m_cprMode(new Symmetric::Block::Mode::GCM(CipherType)),
 	m_destroyEngine(true),
 	m_isDestroyed(false),
 	m_isEncryption(false),
 	m_isInitialized(false),
+	m_isParallel(Parallel),
 	m_keyTag(0),
 	m_mpkcParameters(Parameters),
 	m_msgDigest(static_cast<byte>(CipherType) > static_cast<byte>(BlockCiphers::Twofish) ? (IDigest*)new Digest::Keccak1024() : (IDigest*)new Digest::Keccak512()),
@@ -74,13 +76,14 @@ McEliece::McEliece(MPKCParams Parameters, Prngs PrngType, BlockCiphers CipherTyp
 	Scope();
 }
 
-McEliece::McEliece(MPKCParams Parameters, IPrng* Prng, IBlockCipher* Cipher)
+McEliece::McEliece(MPKCParams Parameters, IPrng* Prng, IBlockCipher* Cipher, bool Parallel)
 	:
 	m_cprMode(new Symmetric::Block::Mode::GCM(Cipher)),
 	m_destroyEngine(false),
 	m_isDestroyed(false),
 	m_isEncryption(false),
 	m_isInitialized(false),
+	m_isParallel(Parallel),
 	m_keyTag(0),
 	m_mpkcParameters(Parameters),
 	m_msgDigest(static_cast<byte>(Cipher->Enumeral()) > static_cast<byte>(BlockCiphers::Twofish) ? (IDigest*)new Digest::Keccak1024() : (IDigest*)new Digest::Keccak512()),
@@ -128,6 +131,86 @@ std::vector<byte> McEliece::Decrypt(const std::vector<byte> &CipherText)
 	return msg;
 }
 
+std::vector<std::vector<byte>> McEliece::Decrypt(const std::vector<std::vector<byte>> &CipherTexts, std::vector<bool> &Valid)
+{
+	CexAssert(m_isInitialized, "The cipher has not been initialized");
+
+	if (m_mpkcParameters == MPKCParams::M12T62)
+	{
+		Key::Symmetric::SymmetricKeySize keySizes = MPKCKeySize();
+		const size_t MINLEN = FFTM12T62::SECRET_SIZE + keySizes.InfoSize();
+		std::vector<std::vector<byte>> msg(CipherTexts.size());
+		std::vector<std::vector<byte>> e(CipherTexts.size(), std::vector<byte>((ulong)1 << (m_paramSet.GF - 3)));
+		std::vector<std::vector<byte>> syn(CipherTexts.size(), std::vector<byte>(FFTM12T62::SECRET_SIZE));
+
+		// a truncated cipher-text is decoded from a zero syndrome and reported as invalid, it does not fail the batch
+		for (size_t i = 0; i < CipherTexts.size(); ++i)
+		{
+			if (CipherTexts[i].size() >= MINLEN)
+			{
+				Utility::MemUtils::Copy(CipherTexts[i], 0, syn[i], 0, syn[i].size());
+				msg[i].resize(CipherTexts[i].size() - MINLEN);
+			}
+		}
+
+		// the ciphertexts are decoded together, sharing the key-dependent scaling across the batch
+		Valid = FFTM12T62::Decrypt(e, m_privateKey->S(), syn, m_isParallel);
+
+		// the mode and digest are members of this instance, so the messages are authenticated in order
+		for (size_t i = 0; i < CipherTexts.size(); ++i)
+		{
+			if (CipherTexts[i].size() < MINLEN)
+			{
+				Valid[i] = false;
+			}
+			else
+			{
+				Valid[i] = MPKCOpen(CipherTexts[i], msg[i], e[i], keySizes) && Valid[i];
+			}
+
+			if (!Valid[i])
+			{
+				// never release unauthenticated plain-text
+				Utility::MemUtils::Clear(msg[i], 0, msg[i].size());
+				msg[i].clear();
+			}
+		}
+
+		return msg;
+	}
+	else
+	{
+		throw CryptoAsymmetricException("McEliece:Decrypt", "The parameter type is invalid!");
+	}
+}
+
+void McEliece::Decrypt(IByteStream* Input, IByteStream* Output)
+{
+	CexAssert(m_isInitialized, "The cipher has not been initialized");
+
+	std::vector<byte> e((ulong)1 << (m_paramSet.GF - 3));
+
+	if (m_mpkcParameters == MPKCParams::M12T62)
+	{
+		std::vector<byte> syn(FFTM12T62::SECRET_SIZE);
+
+		if (Input->Length() - Input->Position() < syn.size() || Input->Read(syn, 0, syn.size()) != syn.size())
+		{
+			throw CryptoAuthenticationFailure("McEliece:Decrypt", "The input stream is too short!");
+		}
+		if (!FFTM12T62::Decrypt(e, m_privateKey->S(), syn))
+		{
+			throw CryptoAuthenticationFailure("McEliece:Decrypt", "Decryption authentication failure!");
+		}
+	}
+	else
+	{
+		throw CryptoAsymmetricException("McEliece:Decrypt", "The parameter type is invalid!");
+	}
+
+	MPKCStream(Input, Output, e, false);
+}
+
 void McEliece::Destroy()
 {
 	if (!m_isDestroyed)
@@ -135,6 +218,7 @@ void McEliece::Destroy()
 		m_isDestroyed = true;
 		m_isEncryption = false;
 		m_isInitialized = false;
+		m_isParallel = false;
 		m_paramSet.Reset();
 		m_mpkcParameters = MPKCParams::None;
 		Utility::IntUtils::ClearVector(m_keyTag);
@@ -183,6 +267,59 @@ std::vector<byte> McEliece::Encrypt(const std::vector<byte> &Message)
 	return cpt;
 }
 
+std::vector<std::vector<byte>> McEliece::Encrypt(const std::vector<std::vector<byte>> &Messages)
+{
+	CexAssert(m_isInitialized, "The cipher has not been initialized");
+
+	if (m_mpkcParameters == MPKCParams::M12T62)
+	{
+		Key::Symmetric::SymmetricKeySize keySizes = MPKCKeySize();
+		std::vector<std::vector<byte>> cpt(Messages.size());
+		std::vector<std::vector<byte>> e(Messages.size(), std::vector<byte>((ulong)1 << (m_paramSet.GF - 3)));
+
+		for (size_t i = 0; i < Messages.size(); ++i)
+		{
+			cpt[i].resize(FFTM12T62::SECRET_SIZE + Messages[i].size() + keySizes.InfoSize());
+		}
+
+		// the syndromes for the batch are computed in a single pass over the public key
+		FFTM12T62::Encrypt(cpt, e, m_publicKey->P(), m_rndGenerator, m_isParallel);
+
+		// the mode and digest are members of this instance, so the messages are encrypted in order
+		for (size_t i = 0; i < Messages.size(); ++i)
+		{
+			MPKCSeal(Messages[i], cpt[i], e[i], keySizes);
+		}
+
+		return cpt;
+	}
+	else
+	{
+		throw CryptoAsymmetricException("McEliece:Encrypt", "The parameter type is invalid!");
+	}
+}
+
+void McEliece::Encrypt(IByteStream* Input, IByteStream* Output)
+{
+	CexAssert(m_isInitialized, "The cipher has not been initialized");
+
+	std::vector<byte> e((ulong)1 << (m_paramSet.GF - 3));
+
+	// the error vector is encapsulated once for the whole stream
+	if (m_mpkcParameters == MPKCParams::M12T62)
+	{
+		std::vector<byte> syn(FFTM12T62::SECRET_SIZE);
+		FFTM12T62::Encrypt(syn, e, m_publicKey->P(), m_rndGenerator, m_isParallel);
+		Output->Write(syn, 0, syn.size());
+	}
+	else
+	{
+		throw CryptoAsymmetricException("McEliece:Encrypt", "The parameter type is invalid!");
+	}
+
+	MPKCStream(Input, Output, e, true);
+}
+
 IAsymmetricKeyPair* McEliece::Generate()
 {
 	CexAssert(m_mpkcParameters != MPKCParams::None, "The parameter setting is invalid");
@@ -192,7 +329,7 @@ IAsymmetricKeyPair* McEliece::Generate()
 
 	if (m_mpkcParameters == MPKCParams::M12T62)
 	{
-		if (!FFTM12T62::Generate(pkA, skA, m_rndGenerator))
+		if (!FFTM12T62::Generate(pkA, skA, m_rndGenerator, m_isParallel))
 		{
 			throw CryptoAsymmetricException("McEliece:Generate", "Key generation max retries failure!");
 		}
@@ -219,15 +356,28 @@ void McEliece::Initialize(bool Encryption, IAsymmetricKeyPair* KeyPair)
 		throw CryptoAsymmetricException("McEliece:Initialize", "Encryption requires a valid public key!");
 	}
 
+	// a key loaded from a mapped image is read in place, so a truncated image must be rejected here
+	if (Encryption == true && ((MPKCPublicKey*)KeyPair->PublicKey())->P().size() != m_paramSet.PublicKeySize)
+	{
+		throw CryptoAsymmetricException("McEliece:Initialize", "The public key size is invalid!");
+	}
+	if (Encryption == false && ((MPKCPrivateKey*)KeyPair->PrivateKey())->S().size() != m_paramSet.PrivateKeySize)
+	{
+		throw CryptoAsymmetricException("McEliece:Initialize", "The private key size is invalid!");
+	}
+
 	m_keyTag = KeyPair->Tag();
 
+	// the keys belong to the caller; release a previous key rather than deleting it on re-initialization
 	if (Encryption)
 	{
-		m_publicKey = std::unique_ptr<MPKCPublicKey>((MPKCPublicKey*)KeyPair->PublicKey());
+		m_publicKey.release();
+		m_publicKey.reset((MPKCPublicKey*)KeyPair->PublicKey());
 	}
 	else
 	{
-		m_privateKey = std::unique_ptr<MPKCPrivateKey>((MPKCPrivateKey*)KeyPair->PrivateKey());
+		m_privateKey.release();
+		m_privateKey.reset((MPKCPrivateKey*)KeyPair->PrivateKey());
 	}
 
 	m_isEncryption = Encryption;
@@ -238,17 +388,7 @@ void McEliece::Initialize(bool Encryption, IAsymmetricKeyPair* KeyPair)
 
 bool McEliece::MPKCDecrypt(const std::vector<byte> &CipherText, std::vector<byte> &Message)
 {
-	Key::Symmetric::SymmetricKeySize keySizes;
-
-	if (static_cast<byte>(m_cprMode->Engine()->Enumeral()) > static_cast<byte>(BlockCiphers::Twofish))
-	{
-		keySizes = m_cprMode->LegalKeySizes()[1];
-	}
-	else
-	{
-		keySizes = m_cprMode->LegalKeySizes()[2];
-	}
-
+	Key::Symmetric::SymmetricKeySize keySizes = MPKCKeySize();
 	std::vector<byte> e((ulong)1 << (m_paramSet.GF - 3));
 
 	// decrypt with McEliece, more fft configurations to be added
@@ -265,32 +405,29 @@ bool McEliece::MPKCDecrypt(const std::vector<byte> &CipherText, std::vector<byte
 		throw CryptoAsymmetricException("McEliece:Decrypt", "The parameter type is invalid!");
 	}
 
-	// get the intermediate (GCM) key
-	std::vector<byte> rnd(m_msgDigest->DigestSize());
-	m_msgDigest->Compute(e, rnd);
-
-	// HX ciphers get keccak1024 and 512 bits of key, standard 256 bit key
-	std::vector<byte> key(keySizes.KeySize());
-	std::memcpy(&key[0], &rnd[0], key.size());
-	std::vector<byte> nonce(keySizes.NonceSize());
-	std::memcpy(&nonce[0], &rnd[key.size()], keySizes.NonceSize());
-	std::vector<byte> tag(keySizes.InfoSize());
-	std::memcpy(&tag[0], &rnd[key.size() + keySizes.NonceSize()], keySizes.InfoSize());
+	return MPKCOpen(CipherText, Message, e, keySizes);
+}
 
-	// decrypt the message and authenticate
-	Key::Symmetric::SymmetricKey kp(key, nonce, tag);
-	m_cprMode->Initialize(false, kp);
-	m_cprMode->Transform(CipherText, CipherText.size() - (Message.size() + keySizes.InfoSize()), Message, 0, Message.size());
+void McEliece::MPKCEncrypt(const std::vector<byte> &Message, std::vector<byte> &CipherText)
+{
+	Key::Symmetric::SymmetricKeySize keySizes = MPKCKeySize();
+	std::vector<byte> e((ulong)1 << (m_paramSet.GF - 3));
 
-	if (!m_cprMode->Verify(CipherText, CipherText.size() - keySizes.InfoSize(), keySizes.InfoSize()))
+	// encrypt with McEliece
+	if (m_mpkcParameters == MPKCParams::M12T62)
 	{
-		return false;
+		CipherText.resize(FFTM12T62::SECRET_SIZE + Message.size() + keySizes.InfoSize());
+		FFTM12T62::Encrypt(CipherText, e, m_publicKey->P(), m_rndGenerator, m_isParallel);
+	}
+	else
+	{
+		throw CryptoAsymmetricException("McEliece:Encrypt", "The parameter type is invalid!");
 	}
 
-	return true;
+	MPKCSeal(Message, CipherText, e, keySizes);
 }
 
-void McEliece::MPKCEncrypt(const std::vector<byte> &Message, std::vector<byte> &CipherText)
+Key::Symmetric::SymmetricKeySize McEliece::MPKCKeySize()
 {
 	Key::Symmetric::SymmetricKeySize keySizes;
 
@@ -305,24 +442,65 @@ void McEliece::MPKCEncrypt(const std::vector<byte> &Message, std::vector<byte> &
 		keySizes = m_cprMode->LegalKeySizes()[1];
 	}
 
-	std::vector<byte> e((ulong)1 << (m_paramSet.GF - 3));
+	return keySizes;
+}
 
-	// encrypt with McEliece
-	if (m_mpkcParameters == MPKCParams::M12T62)
-	{
-		CipherText.resize(FFTM12T62::SECRET_SIZE + Message.size() + keySizes.InfoSize());
-		FFTM12T62::Encrypt(CipherText, e, m_publicKey->P(), m_rndGenerator);
-	}
-	else
+bool McEliece::MPKCOpen(const std::vector<byte> &CipherText, std::vector<byte> &Message, const std::vector<byte> &E, Key::Symmetric::SymmetricKeySize &KeySizes)
+{
+	// get the intermediate (GCM) key
+	std::vector<byte> rnd(m_msgDigest->DigestSize());
+	m_msgDigest->Compute(E, rnd);
+
+	// HX ciphers get keccak1024 and 512 bits of key, standard 256 bit key
+	std::vector<byte> key(KeySizes.KeySize());
+	std::memcpy(&key[0], &rnd[0], key.size());
+	std::vector<byte> nonce(KeySizes.NonceSize());
+	std::memcpy(&nonce[0], &rnd[key.size()], KeySizes.NonceSize());
+	std::vector<byte> tag(KeySizes.InfoSize());
+	std::memcpy(&tag[0], &rnd[key.size() + KeySizes.NonceSize()], KeySizes.InfoSize());
+
+	// decrypt the message and authenticate
+	Key::Symmetric::SymmetricKey kp(key, nonce, tag);
+	m_cprMode->Initialize(false, kp);
+	m_cprMode->Transform(CipherText, CipherText.size() - (Message.size() + KeySizes.InfoSize()), Message, 0, Message.size());
+
+	if (!m_cprMode->Verify(CipherText, CipherText.size() - KeySizes.InfoSize(), KeySizes.InfoSize()))
 	{
-		throw CryptoAsymmetricException("McEliece:Encrypt", "The parameter type is invalid!");
+		return false;
 	}
 
+	return true;
+}
+
+void McEliece::MPKCSeal(const std::vector<byte> &Message, std::vector<byte> &CipherText, const std::vector<byte> &E, Key::Symmetric::SymmetricKeySize &KeySizes)
+{
 	// hash e
 	std::vector<byte> rnd(m_msgDigest->DigestSize());
-	m_msgDigest->Compute(e, rnd);
+	m_msgDigest->Compute(E, rnd);
 
 	// create the intermediate key from the output hash
+	std::vector<byte> key(KeySizes.KeySize());
+	std::memcpy(&key[0], &rnd[0], key.size());
+	std::vector<byte> nonce(KeySizes.NonceSize());
+	std::memcpy(&nonce[0], &rnd[key.size()], KeySizes.NonceSize());
+	std::vector<byte> tag(KeySizes.InfoSize());
+	std::memcpy(&tag[0], &rnd[key.size() + KeySizes.NonceSize()], KeySizes.InfoSize());
+
+	// encrypt the message, add it to the ciphertext with the auth-code
+	Key::Symmetric::SymmetricKey kp(key, nonce, tag);
+	m_cprMode->Initialize(true, kp);
+	m_cprMode->Transform(Message, 0, CipherText, CipherText.size() - (Message.size() + KeySizes.InfoSize()), Message.size());
+	m_cprMode->Finalize(CipherText, CipherText.size() - KeySizes.InfoSize(), KeySizes.InfoSize());
+}
+
+void McEliece::MPKCStream(IByteStream* Input, IByteStream* Output, const std::vector<byte> &E, bool Encryption)
+{
+	Key::Symmetric::SymmetricKeySize keySizes = MPKCKeySize();
+
+	// hash e
+	std::vector<byte> rnd(m_msgDigest->DigestSize());
+	m_msgDigest->Compute(E, rnd);
+
 	std::vector<byte> key(keySizes.KeySize());
 	std::memcpy(&key[0], &rnd[0], key.size());
 	std::vector<byte> nonce(keySizes.NonceSize());
@@ -330,11 +508,22 @@ void McEliece::MPKCEncrypt(const std::vector<byte> &Message, std::vector<byte> &
 	std::vector<byte> tag(keySizes.InfoSize());
 	std::memcpy(&tag[0], &rnd[key.size() + keySizes.NonceSize()], keySizes.InfoSize());
 
-	// encrypt the message, add it to the ciphertext with the auth-code
+	// key the mode once, the stream copies it to each core and derives a nonce for every chunk
 	Key::Symmetric::SymmetricKey kp(key, nonce, tag);
-	m_cprMode->Initialize(true, kp);
-	m_cprMode->Transform(Message, 0, CipherText, CipherText.size() - (Message.size() + keySizes.InfoSize()), Message.size());
-	m_cprMode->Finalize(CipherText, CipherText.size() - keySizes.InfoSize(), keySizes.InfoSize());
+	m_cprMode->Initialize(Encryption, kp);
+	Processing::AeadStream cstm(static_cast<Symmetric::Block::Mode::GCM*>(m_cprMode.get()), nonce, keySizes.InfoSize());
+
+	if (Encryption)
+	{
+		cstm.Seal(Input, Output);
+	}
+	else
+	{
+		cstm.Open(Input, Output);
+	}
+
+	Utility::MemUtils::Clear(key, 0, key.size());
+	Utility::MemUtils::Clear(rnd, 0, rnd.size());
 }
 
 void McEliece::Scope()
@@ -24,12 +24,14 @@
 #include "BlockCiphers.h"
 #include "IAeadMode.h"
 #include "IBlockCipher.h"
+#include "IByteStream.h"
 #include "IDigest.h"
 #include "MPKCKeyPair.h"
 #include "MPKCParams.h"
 #include "MPKCParamSet.h"
 #include "MPKCPrivateKey.h"
 #include "MPKCPublicKey.h"
+#include "SymmetricKeySize.h"
 
 NAMESPACE_MCELIECE
 
@@ -37,6 +39,7 @@ using Enumeration::BlockCiphers;
 using Cipher::Symmetric::Block::Mode::IAeadMode;
 using Cipher::Symmetric::Block::IBlockCipher;
 using Digest::IDigest;
+using IO::IByteStream;
 using Key::Asymmetric::MPKCKeyPair;
 using Enumeration::MPKCParams;
 using Key::Asymmetric::MPKCPrivateKey;
@@ -96,6 +99,8 @@ using Key::Asymmetric::MPKCPublicKey;
 /// <item><description>The primary pseudo-random function (message digest) can be set through the constructor (default is SHA2-256)</description></item>
 /// <item><description>The default prng used to generate the public key and private keys (default is BCR), is an AES256/CTR-BE construction</description></item>
 /// <item><description>The internal seed authentication engine is fixed as a GCM mode, which can use any of the implemented block ciphers, standard or extended</description></item>
+/// <item><description>Large messages can be encrypted as streams; one error vector is encapsulated per stream, and the payload is encrypted in parallel GCM chunks with bounded memory</description></item>
+/// <item><description>By default, key generation runs speculative attempts on every core, and the syndrome and batch decoding work is divided between the cores; constructing with Parallel set to false keeps each operation on the calling thread, for applications that run many instances concurrently</description></item>
 /// </list>
 /// 
 /// <description>Guiding Publications:</description>//
@@ -118,6 +123,7 @@ private:
 	bool m_isDestroyed;
 	bool m_isEncryption;
 	bool m_isInitialized;
+	bool m_isParallel;
 	MPKCParamSet m_paramSet;
 	std::vector<byte> m_keyTag;
 	MPKCParams m_mpkcParameters;
@@ -180,8 +186,8 @@ public:
 	/// <param name="Parameters">The parameter set enumeration name</param>
 	/// <param name="PrngType">The seed prng function type; the default is the BCR generator</param>
 	/// <param name="CipherType">The authentication block ciphers type; the default is AES256</param>
-	/// <param name="Parallel">The cipher is multi-threaded</param>
-	explicit McEliece(MPKCParams Parameters, Prngs PrngType = Prngs::BCR, BlockCiphers CipherType = BlockCiphers::Rijndael);
+	/// <param name="Parallel">The key generation, syndrome, and batch decoding computations are spread across the processor cores; the default is true</param>
+	explicit McEliece(MPKCParams Parameters, Prngs PrngType = Prngs::BCR, BlockCiphers CipherType = BlockCiphers::Rijndael, bool Parallel = true);
 
 	/// <summary>
 	/// Instantiate this class using external Prng and Digest instances
@@ -190,8 +196,8 @@ public:
 	/// <param name="Parameters">The parameter set enumeration name</param>
 	/// <param name="Prng">A pointer to the seed Prng function</param>
 	/// <param name="Cipher">A pointer to the authentication block cipher</param>
-	/// <param name="Parallel">The cipher is multi-threaded</param>
-	McEliece(MPKCParams Parameters, IPrng* Prng, IBlockCipher* Cipher);
+	/// <param name="Parallel">The key generation, syndrome, and batch decoding computations are spread across the processor cores; the default is true</param>
+	McEliece(MPKCParams Parameters, IPrng* Prng, IBlockCipher* Cipher, bool Parallel = true);
 
 	/// <summary>
 	/// Finalize objects
@@ -211,6 +217,32 @@ public:
 	/// <exception cref="Exception::CryptoAuthenticationFailure">Thrown if the message has failed authentication</exception>
 	std::vector<byte> Decrypt(const std::vector<byte> &CipherText) override;
 
+	/// <summary>
+	/// Decrypt a batch of cipher-texts and return the shared secrets
+	/// <para>The cipher-texts are decoded together; with AVX2 four cipher-texts share each pass through the field arithmetic,
+	/// and the key-dependent scaling values are computed once for the batch.
+	/// Each cipher-text is identical in format to the output of Encrypt(Message).
+	/// The status of each cipher-text is returned in the Valid array; an invalid cipher-text does not fail the batch, and its message is returned empty.</para>
+	/// </summary>
+	/// 
+	/// <param name="CipherTexts">The array of cipher-texts to decrypt</param>
+	/// <param name="Valid">Receives the authentication status of each cipher-text, parallel to the returned messages</param>
+	/// 
+	/// <returns>The decrypted messages, in the order of the input array</returns>
+	std::vector<std::vector<byte>> Decrypt(const std::vector<std::vector<byte>> &CipherTexts, std::vector<bool> &Valid);
+
+	/// <summary>
+	/// Decrypt and authenticate a stream encrypted with Encrypt(IByteStream*, IByteStream*)
+	/// <para>The syndrome is read from the input stream and decoded to recover the error vector, then the chunks that follow it are opened in windows,
+	/// the chunks of a window divided between the processor cores. The plain-text of a window is written only after every chunk in it has been authenticated.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">The encrypted input stream, read from its position to its end</param>
+	/// <param name="Output">The stream receiving the plain-text</param>
+	///
+	/// <exception cref="Exception::CryptoAuthenticationFailure">Thrown if the stream has failed authentication, or has been truncated</exception>
+	void Decrypt(IByteStream* Input, IByteStream* Output);
+
 	/// <summary>
 	/// Release all resources associated with the object; optional, called by the finalizer
 	/// </summary>
@@ -225,6 +257,28 @@ public:
 	/// <returns>The encrypted message</returns>
 	std::vector<byte> Encrypt(const std::vector<byte> &Message) override;
 
+	/// <summary>
+	/// Encrypt a batch of messages to the public key
+	/// <para>The error vectors for the batch are drawn first, then the syndromes are computed together,
+	/// each core streaming its slice of the public key once for every message rather than once per message.
+	/// The output for each message is identical in format to Encrypt(Message).</para>
+	/// </summary>
+	/// 
+	/// <param name="Messages">The array of messages to encrypt</param>
+	/// 
+	/// <returns>The encrypted messages, in the order of the input array</returns>
+	std::vector<std::vector<byte>> Encrypt(const std::vector<std::vector<byte>> &Messages);
+
+	/// <summary>
+	/// Encrypt a stream of any length to the public key
+	/// <para>A single error vector is encapsulated and its syndrome written to the output stream, followed by the input encrypted with the derived key as a sequence of authenticated chunks.
+	/// The input is processed in windows of chunks divided between the processor cores, so memory use is bounded by the window size rather than the length of the stream; see <see cref="Processing::AeadStream"/> for the chunk format.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">The plain-text input stream, read from its position to its end</param>
+	/// <param name="Output">The stream receiving the encrypted message</param>
+	void Encrypt(IByteStream* Input, IByteStream* Output);
+
 	/// <summary>
 	/// Generate a public/private key-pair
 	/// </summary>
@@ -244,6 +298,10 @@ private:
 
 	bool MPKCDecrypt(const std::vector<byte> &CipherText, std::vector<byte> &Message);
 	void MPKCEncrypt(const std::vector<byte> &Message, std::vector<byte> &CipherText);
+	Key::Symmetric::SymmetricKeySize MPKCKeySize();
+	bool MPKCOpen(const std::vector<byte> &CipherText, std::vector<byte> &Message, const std::vector<byte> &E, Key::Symmetric::SymmetricKeySize &KeySizes);
+	void MPKCSeal(const std::vector<byte> &Message, std::vector<byte> &CipherText, const std::vector<byte> &E, Key::Symmetric::SymmetricKeySize &KeySizes);
+	void MPKCStream(IByteStream* Input, IByteStream* Output, const std::vector<byte> &E, bool Encryption);
 	void Scope();
 };
 
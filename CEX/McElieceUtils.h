@@ -277,217 +277,226 @@ public:
 	template<typename ArrayA, typename ArrayB>
 	static void Multiply(ArrayA &Output, ArrayA &A, const ArrayB &B)
 	{
-		ulong t1 = A[11] & B[11];
-		ulong t2 = A[11] & B[9];
-		ulong t3 = A[11] & B[10];
-		ulong t4 = A[9] & B[11];
-		ulong t5 = A[10] & B[11];
-		ulong t6 = A[10] & B[10];
-		ulong t7 = A[10] & B[9];
-		ulong t8 = A[9] & B[10];
-		ulong t9 = A[9] & B[9];
-		ulong t10 = t8 ^ t7;
-		ulong t11 = t6 ^ t4;
-		ulong t12 = t11 ^ t2;
-		ulong t13 = t5 ^ t3;
-		ulong t14 = A[8] & B[8];
-		ulong t15 = A[8] & B[6];
-		ulong t16 = A[8] & B[7];
-		ulong t17 = A[6] & B[8];
-		ulong t18 = A[7] & B[8];
-		ulong t19 = A[7] & B[7];
-		ulong t20 = A[7] & B[6];
-		ulong t21 = A[6] & B[7];
-		ulong t22 = A[6] & B[6];
-		ulong t23 = t21 ^ t20;
-		ulong t24 = t19 ^ t17;
-		ulong t25 = t24 ^ t15;
-		ulong t26 = t18 ^ t16;
-		ulong t27 = A[5] & B[5];
-		ulong t28 = A[5] & B[3];
-		ulong t29 = A[5] & B[4];
-		ulong t30 = A[3] & B[5];
-		ulong t31 = A[4] & B[5];
-		ulong t32 = A[4] & B[4];
-		ulong t33 = A[4] & B[3];
-		ulong t34 = A[3] & B[4];
-		ulong t35 = A[3] & B[3];
-		ulong t36 = t34 ^ t33;
-		ulong t37 = t32 ^ t30;
-		ulong t38 = t37 ^ t28;
-		ulong t39 = t31 ^ t29;
-		ulong t40 = A[2] & B[2];
-		ulong t41 = A[2] & B[0];
-		ulong t42 = A[2] & B[1];
-		ulong t43 = A[0] & B[2];
-		ulong t44 = A[1] & B[2];
-		ulong t45 = A[1] & B[1];
-		ulong t46 = A[1] & B[0];
-		ulong t47 = A[0] & B[1];
-		ulong t48 = A[0] & B[0];
-		ulong t49 = t47 ^ t46;
-		ulong t50 = t45 ^ t43;
-		ulong t51 = t50 ^ t41;
-		ulong t52 = t44 ^ t42;
-		ulong t53 = t52 ^ t35;
-		ulong t54 = t40 ^ t36;
-		ulong t55 = t39 ^ t22;
-		ulong t56 = t27 ^ t23;
-		ulong t57 = t26 ^ t9;
-		ulong t58 = t14 ^ t10;
-		ulong t59 = B[6] ^ B[9];
-		ulong t60 = B[7] ^ B[10];
-		ulong t61 = B[8] ^ B[11];
-		ulong t62 = A[6] ^ A[9];
-		ulong t63 = A[7] ^ A[10];
-		ulong t64 = A[8] ^ A[11];
-		ulong t65 = t64 & t61;
-		ulong t66 = t64 & t59;
-		ulong t67 = t64 & t60;
-		ulong t68 = t62 & t61;
-		ulong t69 = t63 & t61;
-		ulong t70 = t63 & t60;
-		ulong t71 = t63 & t59;
-		ulong t72 = t62 & t60;
-		ulong t73 = t62 & t59;
-		ulong t74 = t72 ^ t71;
-		ulong t75 = t70 ^ t68;
-		ulong t76 = t75 ^ t66;
-		ulong t77 = t69 ^ t67;
-		ulong t78 = B[0] ^ B[3];
-		ulong t79 = B[1] ^ B[4];
-		ulong t80 = B[2] ^ B[5];
-		ulong t81 = A[0] ^ A[3];
-		ulong t82 = A[1] ^ A[4];
-		ulong t83 = A[2] ^ A[5];
-		ulong t84 = t83 & t80;
-		ulong t85 = t83 & t78;
-		ulong t86 = t83 & t79;
-		ulong t87 = t81 & t80;
-		ulong t88 = t82 & t80;
-		ulong t89 = t82 & t79;
-		ulong t90 = t82 & t78;
-		ulong t91 = t81 & t79;
-		ulong t92 = t81 & t78;
-		ulong t93 = t91 ^ t90;
-		ulong t94 = t89 ^ t87;
-		ulong t95 = t94 ^ t85;
-		ulong t96 = t88 ^ t86;
-		ulong t97 = t53 ^ t48;
-		ulong t98 = t54 ^ t49;
-		ulong t99 = t38 ^ t51;
-		ulong t100 = t55 ^ t53;
-		ulong t101 = t56 ^ t54;
-		ulong t102 = t25 ^ t38;
-		ulong t103 = t57 ^ t55;
-		ulong t104 = t58 ^ t56;
-		ulong t105 = t12 ^ t25;
-		ulong t106 = t13 ^ t57;
-		ulong t107 = t1 ^ t58;
-		ulong t108 = t97 ^ t92;
-		ulong t109 = t98 ^ t93;
-		ulong t110 = t99 ^ t95;
-		ulong t111 = t100 ^ t96;
-		ulong t112 = t101 ^ t84;
-		ulong t113 = t103 ^ t73;
-		ulong t114 = t104 ^ t74;
-		ulong t115 = t105 ^ t76;
-		ulong t116 = t106 ^ t77;
-		ulong t117 = t107 ^ t65;
-		ulong t118 = B[3] ^ B[9];
-		ulong t119 = B[4] ^ B[10];
-		ulong t120 = B[5] ^ B[11];
-		ulong t121 = B[0] ^ B[6];
-		ulong t122 = B[1] ^ B[7];
-		ulong t123 = B[2] ^ B[8];
-		ulong t124 = A[3] ^ A[9];
-		ulong t125 = A[4] ^ A[10];
-		ulong t126 = A[5] ^ A[11];
-		ulong t127 = A[0] ^ A[6];
-		ulong t128 = A[1] ^ A[7];
-		ulong t129 = A[2] ^ A[8];
-		ulong t130 = t129 & t123;
-		ulong t131 = t129 & t121;
-		ulong t132 = t129 & t122;
-		ulong t133 = t127 & t123;
-		ulong t134 = t128 & t123;
-		ulong t135 = t128 & t122;
-		ulong t136 = t128 & t121;
-		ulong t137 = t127 & t122;
-		ulong t138 = t127 & t121;
-		ulong t139 = t137 ^ t136;
-		ulong t140 = t135 ^ t133;
-		ulong t141 = t140 ^ t131;
-		ulong t142 = t134 ^ t132;
-		ulong t143 = t126 & t120;
-		ulong t144 = t126 & t118;
-		ulong t145 = t126 & t119;
-		ulong t146 = t124 & t120;
-		ulong t147 = t125 & t120;
-		ulong t148 = t125 & t119;
-		ulong t149 = t125 & t118;
-		ulong t150 = t124 & t119;
-		ulong t151 = t124 & t118;
-		ulong t152 = t150 ^ t149;
-		ulong t153 = t148 ^ t146;
-		ulong t154 = t153 ^ t144;
-		ulong t155 = t147 ^ t145;
-		ulong t156 = t121 ^ t118;
-		ulong t157 = t122 ^ t119;
-		ulong t158 = t123 ^ t120;
-		ulong t159 = t127 ^ t124;
-		ulong t160 = t128 ^ t125;
-		ulong t161 = t129 ^ t126;
-		ulong t162 = t161 & t158;
-		ulong t163 = t161 & t156;
-		ulong t164 = t161 & t157;
-		ulong t165 = t159 & t158;
-		ulong t166 = t160 & t158;
-		ulong t167 = t160 & t157;
-		ulong t168 = t160 & t156;
-		ulong t169 = t159 & t157;
-		ulong t170 = t159 & t156;
-		ulong t171 = t169 ^ t168;
-		ulong t172 = t167 ^ t165;
-		ulong t173 = t172 ^ t163;
-		ulong t174 = t166 ^ t164;
-		ulong t175 = t142 ^ t151;
-		ulong t176 = t130 ^ t152;
-		ulong t177 = t170 ^ t175;
-		ulong t178 = t171 ^ t176;
-		ulong t179 = t173 ^ t154;
-		ulong t180 = t174 ^ t155;
-		ulong t181 = t162 ^ t143;
-		ulong t182 = t177 ^ t138;
-		ulong t183 = t178 ^ t139;
-		ulong t184 = t179 ^ t141;
-		ulong t185 = t180 ^ t175;
-		ulong t186 = t181 ^ t176;
-		ulong t187 = t111 ^ t48;
-		ulong t188 = t112 ^ t49;
-		ulong t189 = t102 ^ t51;
-		ulong t190 = t113 ^ t108;
-		ulong t191 = t114 ^ t109;
-		ulong t192 = t115 ^ t110;
-		ulong t193 = t116 ^ t111;
-		ulong t194 = t117 ^ t112;
-		ulong t195 = t12 ^ t102;
-		ulong t196 = t13 ^ t113;
-		ulong t197 = t1 ^ t114;
-		ulong t198 = t187 ^ t138;
-		ulong t199 = t188 ^ t139;
-		ulong t200 = t189 ^ t141;
-		ulong t201 = t190 ^ t182;
-		ulong t202 = t191 ^ t183;
-		ulong t203 = t192 ^ t184;
-		ulong t204 = t193 ^ t185;
-		ulong t205 = t194 ^ t186;
-		ulong t206 = t195 ^ t154;
-		ulong t207 = t196 ^ t155;
-		ulong t208 = t197 ^ t143;
-
-		const size_t OUTSZE = Output.size();
-		std::vector<ulong> sum(2 * OUTSZE - 1);
+		// the element type is either a 64 lane ulong or a wider simd integer; a constant operand is broadcast to it
+		typedef typename ArrayA::value_type V;
+		std::array<V, 12> bVec;
+
+		for (size_t i = 0; i < bVec.size(); i++)
+		{
+			bVec[i] = static_cast<V>(B[i]);
+		}
+
+		V t1 = A[11] & bVec[11];
+		V t2 = A[11] & bVec[9];
+		V t3 = A[11] & bVec[10];
+		V t4 = A[9] & bVec[11];
+		V t5 = A[10] & bVec[11];
+		V t6 = A[10] & bVec[10];
+		V t7 = A[10] & bVec[9];
+		V t8 = A[9] & bVec[10];
+		V t9 = A[9] & bVec[9];
+		V t10 = t8 ^ t7;
+		V t11 = t6 ^ t4;
+		V t12 = t11 ^ t2;
+		V t13 = t5 ^ t3;
+		V t14 = A[8] & bVec[8];
+		V t15 = A[8] & bVec[6];
+		V t16 = A[8] & bVec[7];
+		V t17 = A[6] & bVec[8];
+		V t18 = A[7] & bVec[8];
+		V t19 = A[7] & bVec[7];
+		V t20 = A[7] & bVec[6];
+		V t21 = A[6] & bVec[7];
+		V t22 = A[6] & bVec[6];
+		V t23 = t21 ^ t20;
+		V t24 = t19 ^ t17;
+		V t25 = t24 ^ t15;
+		V t26 = t18 ^ t16;
+		V t27 = A[5] & bVec[5];
+		V t28 = A[5] & bVec[3];
+		V t29 = A[5] & bVec[4];
+		V t30 = A[3] & bVec[5];
+		V t31 = A[4] & bVec[5];
+		V t32 = A[4] & bVec[4];
+		V t33 = A[4] & bVec[3];
+		V t34 = A[3] & bVec[4];
+		V t35 = A[3] & bVec[3];
+		V t36 = t34 ^ t33;
+		V t37 = t32 ^ t30;
+		V t38 = t37 ^ t28;
+		V t39 = t31 ^ t29;
+		V t40 = A[2] & bVec[2];
+		V t41 = A[2] & bVec[0];
+		V t42 = A[2] & bVec[1];
+		V t43 = A[0] & bVec[2];
+		V t44 = A[1] & bVec[2];
+		V t45 = A[1] & bVec[1];
+		V t46 = A[1] & bVec[0];
+		V t47 = A[0] & bVec[1];
+		V t48 = A[0] & bVec[0];
+		V t49 = t47 ^ t46;
+		V t50 = t45 ^ t43;
+		V t51 = t50 ^ t41;
+		V t52 = t44 ^ t42;
+		V t53 = t52 ^ t35;
+		V t54 = t40 ^ t36;
+		V t55 = t39 ^ t22;
+		V t56 = t27 ^ t23;
+		V t57 = t26 ^ t9;
+		V t58 = t14 ^ t10;
+		V t59 = bVec[6] ^ bVec[9];
+		V t60 = bVec[7] ^ bVec[10];
+		V t61 = bVec[8] ^ bVec[11];
+		V t62 = A[6] ^ A[9];
+		V t63 = A[7] ^ A[10];
+		V t64 = A[8] ^ A[11];
+		V t65 = t64 & t61;
+		V t66 = t64 & t59;
+		V t67 = t64 & t60;
+		V t68 = t62 & t61;
+		V t69 = t63 & t61;
+		V t70 = t63 & t60;
+		V t71 = t63 & t59;
+		V t72 = t62 & t60;
+		V t73 = t62 & t59;
+		V t74 = t72 ^ t71;
+		V t75 = t70 ^ t68;
+		V t76 = t75 ^ t66;
+		V t77 = t69 ^ t67;
+		V t78 = bVec[0] ^ bVec[3];
+		V t79 = bVec[1] ^ bVec[4];
+		V t80 = bVec[2] ^ bVec[5];
+		V t81 = A[0] ^ A[3];
+		V t82 = A[1] ^ A[4];
+		V t83 = A[2] ^ A[5];
+		V t84 = t83 & t80;
+		V t85 = t83 & t78;
+		V t86 = t83 & t79;
+		V t87 = t81 & t80;
+		V t88 = t82 & t80;
+		V t89 = t82 & t79;
+		V t90 = t82 & t78;
+		V t91 = t81 & t79;
+		V t92 = t81 & t78;
+		V t93 = t91 ^ t90;
+		V t94 = t89 ^ t87;
+		V t95 = t94 ^ t85;
+		V t96 = t88 ^ t86;
+		V t97 = t53 ^ t48;
+		V t98 = t54 ^ t49;
+		V t99 = t38 ^ t51;
+		V t100 = t55 ^ t53;
+		V t101 = t56 ^ t54;
+		V t102 = t25 ^ t38;
+		V t103 = t57 ^ t55;
+		V t104 = t58 ^ t56;
+		V t105 = t12 ^ t25;
+		V t106 = t13 ^ t57;
+		V t107 = t1 ^ t58;
+		V t108 = t97 ^ t92;
+		V t109 = t98 ^ t93;
+		V t110 = t99 ^ t95;
+		V t111 = t100 ^ t96;
+		V t112 = t101 ^ t84;
+		V t113 = t103 ^ t73;
+		V t114 = t104 ^ t74;
+		V t115 = t105 ^ t76;
+		V t116 = t106 ^ t77;
+		V t117 = t107 ^ t65;
+		V t118 = bVec[3] ^ bVec[9];
+		V t119 = bVec[4] ^ bVec[10];
+		V t120 = bVec[5] ^ bVec[11];
+		V t121 = bVec[0] ^ bVec[6];
+		V t122 = bVec[1] ^ bVec[7];
+		V t123 = bVec[2] ^ bVec[8];
+		V t124 = A[3] ^ A[9];
+		V t125 = A[4] ^ A[10];
+		V t126 = A[5] ^ A[11];
+		V t127 = A[0] ^ A[6];
+		V t128 = A[1] ^ A[7];
+		V t129 = A[2] ^ A[8];
+		V t130 = t129 & t123;
+		V t131 = t129 & t121;
+		V t132 = t129 & t122;
+		V t133 = t127 & t123;
+		V t134 = t128 & t123;
+		V t135 = t128 & t122;
+		V t136 = t128 & t121;
+		V t137 = t127 & t122;
+		V t138 = t127 & t121;
+		V t139 = t137 ^ t136;
+		V t140 = t135 ^ t133;
+		V t141 = t140 ^ t131;
+		V t142 = t134 ^ t132;
+		V t143 = t126 & t120;
+		V t144 = t126 & t118;
+		V t145 = t126 & t119;
+		V t146 = t124 & t120;
+		V t147 = t125 & t120;
+		V t148 = t125 & t119;
+		V t149 = t125 & t118;
+		V t150 = t124 & t119;
+		V t151 = t124 & t118;
+		V t152 = t150 ^ t149;
+		V t153 = t148 ^ t146;
+		V t154 = t153 ^ t144;
+		V t155 = t147 ^ t145;
+		V t156 = t121 ^ t118;
+		V t157 = t122 ^ t119;
+		V t158 = t123 ^ t120;
+		V t159 = t127 ^ t124;
+		V t160 = t128 ^ t125;
+		V t161 = t129 ^ t126;
+		V t162 = t161 & t158;
+		V t163 = t161 & t156;
+		V t164 = t161 & t157;
+		V t165 = t159 & t158;
+		V t166 = t160 & t158;
+		V t167 = t160 & t157;
+		V t168 = t160 & t156;
+		V t169 = t159 & t157;
+		V t170 = t159 & t156;
+		V t171 = t169 ^ t168;
+		V t172 = t167 ^ t165;
+		V t173 = t172 ^ t163;
+		V t174 = t166 ^ t164;
+		V t175 = t142 ^ t151;
+		V t176 = t130 ^ t152;
+		V t177 = t170 ^ t175;
+		V t178 = t171 ^ t176;
+		V t179 = t173 ^ t154;
+		V t180 = t174 ^ t155;
+		V t181 = t162 ^ t143;
+		V t182 = t177 ^ t138;
+		V t183 = t178 ^ t139;
+		V t184 = t179 ^ t141;
+		V t185 = t180 ^ t175;
+		V t186 = t181 ^ t176;
+		V t187 = t111 ^ t48;
+		V t188 = t112 ^ t49;
+		V t189 = t102 ^ t51;
+		V t190 = t113 ^ t108;
+		V t191 = t114 ^ t109;
+		V t192 = t115 ^ t110;
+		V t193 = t116 ^ t111;
+		V t194 = t117 ^ t112;
+		V t195 = t12 ^ t102;
+		V t196 = t13 ^ t113;
+		V t197 = t1 ^ t114;
+		V t198 = t187 ^ t138;
+		V t199 = t188 ^ t139;
+		V t200 = t189 ^ t141;
+		V t201 = t190 ^ t182;
+		V t202 = t191 ^ t183;
+		V t203 = t192 ^ t184;
+		V t204 = t193 ^ t185;
+		V t205 = t194 ^ t186;
+		V t206 = t195 ^ t154;
+		V t207 = t196 ^ t155;
+		V t208 = t197 ^ t143;
+
+		const size_t OUTSZE = 12;
+		std::array<V, (2 * OUTSZE) - 1> sum;
 		sum[0] = t48;
 		sum[1] = t49;
 		sum[2] = t51;
@@ -518,13 +527,16 @@ public:
 			sum[i - OUTSZE] ^= sum[i];
 		}
 
-		std::memcpy(&Output[0], &sum[0], OUTSZE * sizeof(ulong));
+		for (size_t i = 0; i < OUTSZE; i++)
+		{
+			Output[i] = sum[i];
+		}
 	}
 
 	template<typename Array>
-	inline static ulong Or(const Array &Input, const size_t Degree)
+	inline static typename Array::value_type Or(const Array &Input, const size_t Degree)
 	{
-		ulong ret = Input[0];
+		typename Array::value_type ret = Input[0];
 
 		for (size_t i = 1; i < Degree; i++)
 		{
@@ -539,17 +551,17 @@ public:
 	{
 		ushort ret = 0;
 		size_t i = Degree;
-		std::vector<ulong> tmp(Degree);
-		std::memcpy(&tmp[0], &Product[0], Degree * sizeof(ulong));
+		ulong tmp;
 
 		while (i--)
 		{
-			tmp[i] ^= (tmp[i] >> 32);
-			tmp[i] ^= (tmp[i] >> 16);
-			tmp[i] ^= (tmp[i] >> 8);
-			tmp[i] ^= (tmp[i] >> 4);
+			tmp = Product[i];
+			tmp ^= (tmp >> 32);
+			tmp ^= (tmp >> 16);
+			tmp ^= (tmp >> 8);
+			tmp ^= (tmp >> 4);
 			ret <<= 1;
-			ret |= (0x6996 >> (tmp[i] & 0xF)) & 1;
+			ret |= (0x6996 >> (tmp & 0xF)) & 1;
 		};
 
 		return ret;
@@ -558,8 +570,10 @@ public:
 	template<typename Array>
 	inline static void TransposeCompact64x64(Array &Output)
 	{
+		// the rows are 64 bit words, or wider simd integers holding one 64x64 matrix per 64 bit lane
+		typedef typename std::remove_reference<decltype(Output[0])>::type V;
 		int i, j, s, p, idx0, idx1;
-		ulong x, y;
+		V x, y;
 
 		const std::array<std::array<ulong, 2>, 6> mask =
 		{
@@ -583,8 +597,8 @@ public:
 				{
 					idx0 = p * 2 * s + i;
 					idx1 = p * 2 * s + i + s;
-					x = (Output[idx0] & mask[j][0]) | ((Output[idx1] & mask[j][0]) << s);
-					y = ((Output[idx0] & mask[j][1]) >> s) | (Output[idx1] & mask[j][1]);
+					x = (Output[idx0] & static_cast<V>(mask[j][0])) | ((Output[idx1] & static_cast<V>(mask[j][0])) << s);
+					y = ((Output[idx0] & static_cast<V>(mask[j][1])) >> s) | (Output[idx1] & static_cast<V>(mask[j][1]));
 					Output[idx0] = x;
 					Output[idx1] = y;
 				}
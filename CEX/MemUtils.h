@@ -634,6 +634,68 @@ public:
 		}
 	}
 
+	/// <summary>
+	/// Block XOR two source arrays and write the result to a third array in a single pass.
+	/// <para>The Length is the number of *bytes* (8 bit integers) to XOR.
+	/// Used to combine a cache resident key-stream with the input without first copying either to the output;
+	/// the output may be the same array as either source when the offsets are equal.</para>
+	/// </summary>
+	///
+	/// <param name="InputA">The first source integer array</param>
+	/// <param name="AOffset">The offset within the first source array</param>
+	/// <param name="InputB">The second source integer array</param>
+	/// <param name="BOffset">The offset within the second source array</param>
+	/// <param name="Output">The destination integer array</param>
+	/// <param name="OutOffset">The offset within the destination array</param>
+	/// <param name="Length">The number of bytes to process</param>
+	template <typename Array>
+	inline static void XorBlock(const Array &InputA, size_t AOffset, const Array &InputB, size_t BOffset, Array &Output, size_t OutOffset, size_t Length)
+	{
+		const size_t ELMSZE = sizeof(InputA[0]);
+
+		CexAssert((InputA.size() - AOffset) * ELMSZE >= Length, "Length is larger than input capacity");
+		CexAssert((InputB.size() - BOffset) * ELMSZE >= Length, "Length is larger than input capacity");
+		CexAssert((Output.size() - OutOffset) * ELMSZE >= Length, "Length is larger than output capacity");
+		CexAssert(ELMSZE <= Length, "Integer type is larger than length");
+
+		const size_t ELMCNT = Length / ELMSZE;
+		size_t prcCtr = 0;
+
+#if defined(__AVX512__)
+		const size_t ALN512 = ELMCNT - (ELMCNT % (64 / ELMSZE));
+
+		while (prcCtr != ALN512)
+		{
+			_mm512_storeu_si512(reinterpret_cast<__m512i*>(&Output[OutOffset + prcCtr]), _mm512_xor_si512(_mm512_loadu_si512(reinterpret_cast<const __m512i*>(&InputA[AOffset + prcCtr])), _mm512_loadu_si512(reinterpret_cast<const __m512i*>(&InputB[BOffset + prcCtr]))));
+			prcCtr += 64 / ELMSZE;
+		}
+#elif defined(__AVX2__)
+		const size_t ALN256 = ELMCNT - (ELMCNT % (32 / ELMSZE));
+
+		while (prcCtr != ALN256)
+		{
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(&Output[OutOffset + prcCtr]), _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&InputA[AOffset + prcCtr])), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&InputB[BOffset + prcCtr]))));
+			prcCtr += 32 / ELMSZE;
+		}
+#endif
+
+#if defined(__AVX__)
+		const size_t ALN128 = ELMCNT - (ELMCNT % (16 / ELMSZE));
+
+		while (prcCtr != ALN128)
+		{
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(&Output[OutOffset + prcCtr]), _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&InputA[AOffset + prcCtr])), _mm_loadu_si128(reinterpret_cast<const __m128i*>(&InputB[BOffset + prcCtr]))));
+			prcCtr += 16 / ELMSZE;
+		}
+#endif
+
+		while (prcCtr != ELMCNT)
+		{
+			Output[OutOffset + prcCtr] = InputA[AOffset + prcCtr] ^ InputB[BOffset + prcCtr];
+			++prcCtr;
+		}
+	}
+
 	/// <summary>
 	/// Block XOR 128 bits
 	/// </summary>
@@ -0,0 +1,152 @@
+#include "MemoryMappedFile.h"
+
+#if defined(CEX_OS_WINDOWS)
+#	include <windows.h>
+#else
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+NAMESPACE_IO
+
+const std::string MemoryMappedFile::CLASS_NAME("MemoryMappedFile");
+
+//~~~Properties~~~//
+
+const byte* MemoryMappedFile::Data()
+{
+	return m_mapData;
+}
+
+std::string MemoryMappedFile::FileName()
+{
+	return m_fileName;
+}
+
+const ulong MemoryMappedFile::Length()
+{
+	return m_mapSize;
+}
+
+const std::string MemoryMappedFile::Name()
+{
+	return CLASS_NAME;
+}
+
+//~~~Constructor~~~//
+
+MemoryMappedFile::MemoryMappedFile(const std::string &FileName)
+	:
+	m_fileName(FileName),
+	m_isDestroyed(false),
+	m_mapData(nullptr),
+	m_mapHandle(nullptr),
+	m_mapSize(0)
+{
+#if defined(CEX_OS_WINDOWS)
+
+	HANDLE hFile = CreateFileA(m_fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+	if (hFile == INVALID_HANDLE_VALUE)
+	{
+		throw CryptoProcessingException("MemoryMappedFile:CTor", "The file does not exist!");
+	}
+
+	LARGE_INTEGER fileSize;
+
+	if (!GetFileSizeEx(hFile, &fileSize) || fileSize.QuadPart == 0)
+	{
+		CloseHandle(hFile);
+		throw CryptoProcessingException("MemoryMappedFile:CTor", "The file is empty!");
+	}
+
+	// the mapping object holds its own reference to the file
+	HANDLE hMap = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(hFile);
+
+	if (hMap == NULL)
+	{
+		throw CryptoProcessingException("MemoryMappedFile:CTor", "The file could not be mapped!");
+	}
+
+	void* ptr = MapViewOfFile(hMap, FILE_MAP_READ, 0, 0, 0);
+
+	if (ptr == NULL)
+	{
+		CloseHandle(hMap);
+		throw CryptoProcessingException("MemoryMappedFile:CTor", "The file could not be mapped!");
+	}
+
+	m_mapHandle = hMap;
+	m_mapData = static_cast<const byte*>(ptr);
+	m_mapSize = static_cast<ulong>(fileSize.QuadPart);
+
+#else
+
+	int fd = open(m_fileName.c_str(), O_RDONLY);
+
+	if (fd < 0)
+	{
+		throw CryptoProcessingException("MemoryMappedFile:CTor", "The file does not exist!");
+	}
+
+	struct stat st;
+
+	if (fstat(fd, &st) != 0 || st.st_size == 0)
+	{
+		close(fd);
+		throw CryptoProcessingException("MemoryMappedFile:CTor", "The file is empty!");
+	}
+
+	// a shared read-only mapping is backed by the page cache; the descriptor is not needed once the mapping exists
+	void* ptr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+
+	if (ptr == MAP_FAILED)
+	{
+		throw CryptoProcessingException("MemoryMappedFile:CTor", "The file could not be mapped!");
+	}
+
+	m_mapData = static_cast<const byte*>(ptr);
+	m_mapSize = static_cast<ulong>(st.st_size);
+
+#endif
+}
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+	Destroy();
+}
+
+//~~~Public Functions~~~//
+
+void MemoryMappedFile::Destroy()
+{
+	if (!m_isDestroyed)
+	{
+		m_isDestroyed = true;
+
+		if (m_mapData != nullptr)
+		{
+#if defined(CEX_OS_WINDOWS)
+			UnmapViewOfFile(m_mapData);
+			CloseHandle(m_mapHandle);
+#else
+			munmap(const_cast<byte*>(m_mapData), static_cast<size_t>(m_mapSize));
+#endif
+		}
+
+		m_mapData = nullptr;
+		m_mapHandle = nullptr;
+		m_mapSize = 0;
+	}
+}
+
+ByteView MemoryMappedFile::View()
+{
+	return ByteView(m_mapData, static_cast<size_t>(m_mapSize));
+}
+
+NAMESPACE_IOEND
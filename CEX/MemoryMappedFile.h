@@ -0,0 +1,117 @@
+// The GPL version 3 License (GPLv3)
+//
+// Copyright (c) 2017 vtdev.com
+// This file is part of the CEX Cryptographic library.
+//
+// This program is free software : you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef CEX_MEMORYMAPPEDFILE_H
+#define CEX_MEMORYMAPPEDFILE_H
+
+#include "CexDomain.h"
+#include "ByteView.h"
+#include "CryptoProcessingException.h"
+
+NAMESPACE_IO
+
+using Exception::CryptoProcessingException;
+
+/// <summary>
+/// A read-only memory mapped file.
+/// <para>The file is mapped into the address space and read in place; pages are loaded on first access and are shared with the
+/// operating system file cache, so any number of mappings of the same file cost one copy of the file in memory.
+/// The mapping begins on a page boundary. It is released when the object is destroyed, and any ByteView taken from it must not outlive it.</para>
+/// </summary>
+///
+/// <example>
+/// <description>Map a key image:</description>
+/// <code>
+/// MemoryMappedFile map("recipient.key");
+/// MPKCPublicKey pk(map.View());
+/// </code>
+/// </example>
+class MemoryMappedFile
+{
+private:
+
+	static const std::string CLASS_NAME;
+
+	std::string m_fileName;
+	bool m_isDestroyed;
+	const byte* m_mapData;
+	void* m_mapHandle;
+	ulong m_mapSize;
+
+public:
+
+	MemoryMappedFile() = delete;
+	MemoryMappedFile(const MemoryMappedFile&) = delete;
+	MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+	MemoryMappedFile& operator=(MemoryMappedFile&&) = delete;
+
+	//~~~Properties~~~//
+
+	/// <summary>
+	/// Get: A pointer to the first byte of the mapped file
+	/// </summary>
+	const byte* Data();
+
+	/// <summary>
+	/// Get: The file name and path
+	/// </summary>
+	std::string FileName();
+
+	/// <summary>
+	/// Get: The length of the mapped file in bytes
+	/// </summary>
+	const ulong Length();
+
+	/// <summary>
+	/// Get: The class name
+	/// </summary>
+	const std::string Name();
+
+	//~~~Constructor~~~//
+
+	/// <summary>
+	/// Map a file for reading
+	/// </summary>
+	///
+	/// <param name="FileName">The full path and name of the file</param>
+	///
+	/// <exception cref="Exception::CryptoProcessingException">Thrown if the file does not exist, is empty, or could not be mapped</exception>
+	explicit MemoryMappedFile(const std::string &FileName);
+
+	/// <summary>
+	/// Finalize objects
+	/// </summary>
+	~MemoryMappedFile();
+
+	//~~~Public Functions~~~//
+
+	/// <summary>
+	/// Unmap the file and release all resources associated with the object; optional, called by the finalizer
+	/// </summary>
+	void Destroy();
+
+	/// <summary>
+	/// Get a read-only view of the whole mapping
+	/// </summary>
+	///
+	/// <returns>A view of the mapped bytes</returns>
+	ByteView View();
+};
+
+NAMESPACE_IOEND
+#endif
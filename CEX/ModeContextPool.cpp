@@ -0,0 +1,168 @@
+#include "ModeContextPool.h"
+
+NAMESPACE_MODE
+
+const std::string ModeContextPool::CLASS_NAME("ModeContextPool");
+
+//~~~Properties~~~//
+
+const size_t ModeContextPool::Capacity()
+{
+	return m_poolCapacity;
+}
+
+const size_t ModeContextPool::Count()
+{
+	std::lock_guard<std::mutex> lock(m_syncLock);
+
+	return m_poolIndex.size();
+}
+
+const std::string ModeContextPool::Name()
+{
+	return CLASS_NAME;
+}
+
+//~~~Constructor~~~//
+
+ModeContextPool::ModeContextPool(size_t Capacity)
+	:
+	m_poolCapacity(Capacity),
+	m_poolIndex(),
+	m_isDestroyed(false),
+	m_syncLock()
+{
+	if (Capacity == 0)
+		throw CryptoCipherModeException("ModeContextPool:CTor", "The pool capacity can not be zero!");
+}
+
+ModeContextPool::~ModeContextPool()
+{
+	if (!m_isDestroyed)
+	{
+		m_isDestroyed = true;
+		Clear();
+	}
+}
+
+//~~~Public Functions~~~//
+
+ICipherMode* ModeContextPool::Acquire(const std::vector<byte> &KeyId)
+{
+	std::lock_guard<std::mutex> lock(m_syncLock);
+
+	std::map<std::vector<byte>, PoolEntry>::iterator idx = m_poolIndex.find(KeyId);
+
+	if (idx == m_poolIndex.end())
+		throw CryptoCipherModeException("ModeContextPool:Acquire", "The key id is not in the pool!");
+
+	ICipherMode* ctx;
+
+	if (idx->second.Idle.size() != 0)
+	{
+		ctx = idx->second.Idle.back();
+		idx->second.Idle.pop_back();
+	}
+	else
+	{
+		// copies the key schedule of the prototype; the key is not expanded again
+		ctx = idx->second.Prototype->Clone();
+	}
+
+	idx->second.Leased.insert(ctx);
+
+	return ctx;
+}
+
+void ModeContextPool::Add(const std::vector<byte> &KeyId, ICipherMode* Context)
+{
+	if (KeyId.size() == 0)
+		throw CryptoCipherModeException("ModeContextPool:Add", "The key id can not be empty!");
+	if (Context == 0)
+		throw CryptoCipherModeException("ModeContextPool:Add", "The context can not be null!");
+	if (!Context->IsInitialized())
+		throw CryptoCipherModeException("ModeContextPool:Add", "The context must be initialized!");
+
+	std::lock_guard<std::mutex> lock(m_syncLock);
+
+	std::map<std::vector<byte>, PoolEntry>::iterator idx = m_poolIndex.find(KeyId);
+
+	if (idx != m_poolIndex.end())
+	{
+		// key rotation; leased contexts of the old key are no longer tracked, and are destroyed on release
+		Erase(idx->second);
+		m_poolIndex.erase(idx);
+	}
+
+	PoolEntry &entry = m_poolIndex[KeyId];
+	entry.Prototype = Context;
+}
+
+void ModeContextPool::Clear()
+{
+	std::lock_guard<std::mutex> lock(m_syncLock);
+
+	for (std::map<std::vector<byte>, PoolEntry>::iterator it = m_poolIndex.begin(); it != m_poolIndex.end(); ++it)
+		Erase(it->second);
+
+	m_poolIndex.clear();
+}
+
+bool ModeContextPool::Contains(const std::vector<byte> &KeyId)
+{
+	std::lock_guard<std::mutex> lock(m_syncLock);
+
+	return m_poolIndex.find(KeyId) != m_poolIndex.end();
+}
+
+void ModeContextPool::Release(const std::vector<byte> &KeyId, ICipherMode* Context)
+{
+	if (Context == 0)
+		return;
+
+	std::lock_guard<std::mutex> lock(m_syncLock);
+
+	std::map<std::vector<byte>, PoolEntry>::iterator idx = m_poolIndex.find(KeyId);
+
+	if (idx != m_poolIndex.end() && idx->second.Leased.erase(Context) != 0)
+	{
+		if (idx->second.Idle.size() < m_poolCapacity)
+		{
+			idx->second.Idle.push_back(Context);
+			return;
+		}
+	}
+
+	// the key was removed or replaced, or the idle list is full
+	delete Context;
+}
+
+void ModeContextPool::Remove(const std::vector<byte> &KeyId)
+{
+	std::lock_guard<std::mutex> lock(m_syncLock);
+
+	std::map<std::vector<byte>, PoolEntry>::iterator idx = m_poolIndex.find(KeyId);
+
+	if (idx != m_poolIndex.end())
+	{
+		Erase(idx->second);
+		m_poolIndex.erase(idx);
+	}
+}
+
+//~~~Private Functions~~~//
+
+void ModeContextPool::Erase(PoolEntry &Entry)
+{
+	for (size_t i = 0; i < Entry.Idle.size(); ++i)
+		delete Entry.Idle[i];
+
+	if (Entry.Prototype != 0)
+		delete Entry.Prototype;
+
+	Entry.Idle.clear();
+	Entry.Leased.clear();
+	Entry.Prototype = 0;
+}
+
+NAMESPACE_MODEEND
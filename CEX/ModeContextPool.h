@@ -0,0 +1,191 @@
+// The GPL version 3 License (GPLv3)
+//
+// Copyright (c) 2017 vtdev.com
+// This file is part of the CEX Cryptographic library.
+//
+// This program is free software : you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef CEX_MODECONTEXTPOOL_H
+#define CEX_MODECONTEXTPOOL_H
+
+#include "CexDomain.h"
+#include "CryptoCipherModeException.h"
+#include "ICipherMode.h"
+#include <map>
+#include <mutex>
+#include <set>
+
+NAMESPACE_MODE
+
+using Exception::CryptoCipherModeException;
+
+/// <summary>
+/// A thread-safe pool of keyed cipher mode contexts, indexed by a key identifier
+/// </summary>
+///
+/// <example>
+/// <description>Share one keyed GCM context between worker threads:</description>
+/// <code>
+/// ModeContextPool pool;
+/// GCM* cipher = new GCM(BlockCiphers::AHX);
+/// cipher->Initialize(true, SymmetricKey(Key, Nonce));
+/// // the pool takes ownership of the keyed prototype
+/// pool.Add(KeyId, cipher);
+///
+/// // on a worker thread; an idle context, or a clone of the prototype
+/// ICipherMode* ctx = pool.Acquire(KeyId);
+/// // set the message nonce without expanding the key again
+/// ctx->Initialize(true, SymmetricKey(std::vector&lt;byte&gt;(0), MsgNonce));
+/// ctx->Transform(Input, 0, Output, 0, Input.size());
+/// pool.Release(KeyId, ctx);
+/// </code>
+/// </example>
+///
+/// <remarks>
+/// <para>Each key identifier is mapped to an initialized prototype context and a list of idle contexts.
+/// Acquire() returns an idle context, or creates one with the prototypes Clone() function, which copies the expanded key schedule (and the GHASH key powers in GCM) instead of keying a new cipher.
+/// A process that uses one key on many threads expands the key once, rather than once per thread.</para>
+///
+/// <list type="bullet">
+/// <item><description>The key identifier is chosen by the caller, ex. a session or key serial number; it is not the key, and the pool never sees the key material.</description></item>
+/// <item><description>Contexts are returned with Release(); at most Capacity() idle contexts are kept for each key, a context released to a full list is destroyed.</description></item>
+/// <item><description>A context keeps the state of its last use; re-initialize it with a nonce only key (GCM, OCB, EAX, CTR) before processing a new message.</description></item>
+/// <item><description>Adding a prototype with an existing key identifier replaces the key; contexts leased under the previous key are destroyed when they are released, rather than returned to the pool.</description></item>
+/// <item><description>The pool owns the prototypes and the idle contexts, and destroys them with Remove(), Clear(), and the destructor; the pool must outlive the contexts it has leased.</description></item>
+/// <item><description>All functions are synchronized, a single pool can be shared by all of the threads in a process.</description></item>
+/// <item><description>The template modes (CTRT and GCMT) implement Clone(), and can be used as a prototype.</description></item>
+/// </list>
+/// </remarks>
+class ModeContextPool
+{
+private:
+
+	static const std::string CLASS_NAME;
+	static const size_t DEF_CAPACITY = 64;
+
+	struct PoolEntry
+	{
+		std::vector<ICipherMode*> Idle;
+		std::set<ICipherMode*> Leased;
+		ICipherMode* Prototype;
+	};
+
+	size_t m_poolCapacity;
+	std::map<std::vector<byte>, PoolEntry> m_poolIndex;
+	bool m_isDestroyed;
+	std::mutex m_syncLock;
+
+public:
+
+	ModeContextPool(const ModeContextPool&) = delete;
+	ModeContextPool& operator=(const ModeContextPool&) = delete;
+	ModeContextPool& operator=(ModeContextPool&&) = delete;
+
+	//~~~Properties~~~//
+
+	/// <summary>
+	/// Get: The maximum number of idle contexts kept for each key
+	/// </summary>
+	const size_t Capacity();
+
+	/// <summary>
+	/// Get: The number of keys held by the pool
+	/// </summary>
+	const size_t Count();
+
+	/// <summary>
+	/// Get: The class name
+	/// </summary>
+	const std::string Name();
+
+	//~~~Constructor~~~//
+
+	/// <summary>
+	/// Initialize the pool
+	/// </summary>
+	///
+	/// <param name="Capacity">The maximum number of idle contexts kept for each key</param>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the capacity is zero</exception>
+	explicit ModeContextPool(size_t Capacity = DEF_CAPACITY);
+
+	/// <summary>
+	/// Finalize objects
+	/// </summary>
+	~ModeContextPool();
+
+	//~~~Public Functions~~~//
+
+	/// <summary>
+	/// Lease a keyed context.
+	/// <para>Returns an idle context if one is available, otherwise a clone of the keys prototype.
+	/// The context must be returned with Release().</para>
+	/// </summary>
+	///
+	/// <param name="KeyId">The key identifier</param>
+	///
+	/// <returns>An initialized cipher mode instance</returns>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the key identifier is not in the pool</exception>
+	ICipherMode* Acquire(const std::vector<byte> &KeyId);
+
+	/// <summary>
+	/// Add a keyed prototype context to the pool.
+	/// <para>The pool takes ownership of the context. If the key identifier exists, the previous prototype and its idle contexts are destroyed.</para>
+	/// </summary>
+	///
+	/// <param name="KeyId">The key identifier</param>
+	/// <param name="Context">An initialized cipher mode instance</param>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the key identifier is empty, or the context is null or not initialized</exception>
+	void Add(const std::vector<byte> &KeyId, ICipherMode* Context);
+
+	/// <summary>
+	/// Destroy all of the prototypes and idle contexts, and remove all keys
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// Test if a key identifier is in the pool
+	/// </summary>
+	///
+	/// <param name="KeyId">The key identifier</param>
+	///
+	/// <returns>Returns true if the key is in the pool</returns>
+	bool Contains(const std::vector<byte> &KeyId);
+
+	/// <summary>
+	/// Return a leased context to the pool.
+	/// <para>The context is destroyed if its key has been removed or replaced, or the keys idle list is full.</para>
+	/// </summary>
+	///
+	/// <param name="KeyId">The key identifier the context was acquired with</param>
+	/// <param name="Context">The context returned by Acquire()</param>
+	void Release(const std::vector<byte> &KeyId, ICipherMode* Context);
+
+	/// <summary>
+	/// Remove a key, destroying its prototype and idle contexts.
+	/// <para>Contexts leased under the key are destroyed when they are released.</para>
+	/// </summary>
+	///
+	/// <param name="KeyId">The key identifier</param>
+	void Remove(const std::vector<byte> &KeyId);
+
+private:
+
+	static void Erase(PoolEntry &Entry);
+};
+
+NAMESPACE_MODEEND
+#endif
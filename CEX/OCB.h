@@ -32,8 +32,7 @@
 #ifndef CEX_OCB_H
 #define CEX_OCB_H
 
-#include "IAeadMode.h"
-#include "ISymmetricKey.h"
+#include "OCBT.h"
 
 NAMESPACE_MODE
 
@@ -110,6 +109,9 @@ NAMESPACE_MODE
 /// <item><description>ParallelBlockSize() is calculated automatically based on the processor(s) L1 data cache size, this property can be user defined, and must be evenly divisible by ParallelMinimumSize().</description></item>
 /// <item><description>The ParallelBlockSize() can be changed through the ParallelProfile() property</description></item>
 /// <item><description>Parallel block calculation ex. <c>ParallelBlockSize = N - (N % .ParallelMinimumSize);</c></description></item>
+/// <item><description>AeadOneShot::OcbSeal and OcbOpen process a single message with a 16 byte tag, without constructing the mode or allocating from the heap.</description></item>
+/// <item><description>Many small messages can be processed under one key with the SealBatch and OpenBatch functions; the blocks of consecutive packets are masked with their offsets and encrypted together through the ciphers wide transform.</description></item>
+/// <item><description>The mode is implemented by the OCBT&lt;TCipher&gt; template in OCBT.h; this class wraps OCBT&lt;IBlockCipher&gt;. When the cipher type is known at compile time, OCBT with a final cipher class, ex. OCBT&lt;AHX&gt;, produces the same output without the virtual calls in the offset masked block loops.</description></item>
 /// </list>
 /// 
 /// <description>Guiding Publications:</description>
@@ -123,40 +125,10 @@ NAMESPACE_MODE
 class OCB final : public IAeadMode
 {
 private:
-	static const size_t BLOCK_SIZE = 16;
-	static const std::string CLASS_NAME;
-	static const size_t PREFETCH_HASH = 16 * 32;
-	static const size_t MAX_NONCESIZE = 15;
-	static const size_t MAX_TAGSIZE = 16;
-	static const size_t MIN_NONCESIZE = 12;
-	static const size_t MIN_TAGSIZE = 12;
-
-	std::vector<byte> m_aadData;
-	bool m_aadLoaded;
-	bool m_aadPreserve;
-	bool m_autoIncrement;
-	IBlockCipher* m_blockCipher;
-	std::vector<byte> m_checkSum;
+
 	BlockCiphers m_cipherType;
-	bool m_destroyEngine;
-	IBlockCipher* m_hashCipher;
-	std::vector<std::vector<byte>> m_hashList;
 	bool m_isDestroyed;
-	bool m_isFinalized;
-	bool m_isInitialized;
-	ulong m_mainBlockCount;
-	bool m_isEncryption;
-	std::vector<SymmetricKeySize> m_legalKeySizes;
-	std::vector<byte> m_listAsterisk;
-	std::vector<byte> m_listDollar;
-	std::vector<byte> m_mainOffset;
-	std::vector<byte> m_mainOffset0;
-	std::vector<byte> m_mainStretch;
-	std::vector<byte> m_msgTag;
-	std::vector<byte> m_ocbNonce;
-	std::vector<byte> m_ocbVector;
-	ParallelOptions m_parallelProfile;
-	std::vector<byte> m_topInput;
+	std::unique_ptr<OCBT<IBlockCipher>> m_ocbMode;
 
 public:
 
@@ -286,6 +258,19 @@ public:
 
 	//~~~Public Functions~~~//
 
+	/// <summary>
+	/// Create an initialized copy of this cipher mode.
+	/// <para>Both block cipher instances are copied with their Clone() functions, so the key is not expanded again; the copy owns its cipher instances.
+	/// The offsets, checksum, message and associated data state, and the parallel profile are copied.
+	/// The copy can be given a new nonce by calling Initialize with a key that contains only the nonce.
+	/// The caller is responsible for destroying the returned mode.</para>
+	/// </summary>
+	///
+	/// <returns>A new, initialized OCB instance</returns>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the cipher mode has not been initialized</exception>
+	OCB* Clone() override;
+
 	/// <summary>
 	/// Decrypt a single block of bytes.
 	/// <para>Decrypts one block of bytes beginning at a zero index.
@@ -364,6 +349,25 @@ public:
 	/// <exception cref="CryptoCipherModeException">Thrown if a null or invalid Key/Nonce is used</exception>
 	void Initialize(bool Encryption, ISymmetricKey &KeyParams) override;
 
+	/// <summary>
+	/// Decrypt and authenticate a batch of packets under the current key.
+	/// <para>Each packet is processed with its own nonce and associated data, the key schedules and L values are shared by the batch.
+	/// The tag of every packet is verified; the output of a packet that fails authentication is zeroed, and its Authentic flag is set to false.
+	/// The batch functions do not change the state of the streaming interface; Initialize(bool, ISymmetricKey) must have been called with a key, and for decryption, before this method can be used.</para>
+	/// </summary>
+	///
+	/// <param name="Packets">The packet descriptors; the Authentic member of each packet is set by this function</param>
+	/// <param name="Associated">The array containing the associated data of each packet</param>
+	/// <param name="Input">The array containing the cipher-text of each packet</param>
+	/// <param name="Output">The array receiving the plain-text of each packet</param>
+	/// <param name="Tags">The array containing the expected tag of each packet</param>
+	/// <param name="TagLength">The byte length of each tag; must be no less than the MinTagSize() size and no greater than the MaxTagSize()</param>
+	///
+	/// <returns>Returns true if every packet in the batch was authenticated</returns>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the cipher has not been keyed for decryption, the tag length is invalid, or a packet nonce is an invalid size</exception>
+	bool OpenBatch(std::vector<AeadPacket> &Packets, const std::vector<byte> &Associated, const std::vector<byte> &Input, std::vector<byte> &Output, const std::vector<byte> &Tags, const size_t TagLength);
+
 	/// <summary>
 	/// Set the maximum number of threads allocated when using multi-threaded processing.
 	/// <para>When set to zero, thread count is set automatically. If set to 1, sets IsParallel() to false and runs in sequential mode. 
@@ -375,6 +379,23 @@ public:
 	/// <exception cref="Exception::CryptoCipherModeException">Thrown if an invalid degree setting is used</exception>
 	void ParallelMaxDegree(size_t Degree) override;
 
+	/// <summary>
+	/// Encrypt and authenticate a batch of packets under the current key.
+	/// <para>Each packet is processed with its own nonce and associated data, the key schedules and L values are shared by the batch.
+	/// The offset masked blocks of consecutive packets are encrypted together through the ciphers wide transform, and the associated data, final pad, and tag blocks of the group are each processed in one wide pass.
+	/// The batch functions do not change the state of the streaming interface; Initialize(bool, ISymmetricKey) must have been called with a key, and for encryption, before this method can be used.</para>
+	/// </summary>
+	///
+	/// <param name="Packets">The packet descriptors</param>
+	/// <param name="Associated">The array containing the associated data of each packet</param>
+	/// <param name="Input">The array containing the plain-text of each packet</param>
+	/// <param name="Output">The array receiving the cipher-text of each packet</param>
+	/// <param name="Tags">The array receiving the tag of each packet</param>
+	/// <param name="TagLength">The byte length of each tag; must be no less than the MinTagSize() size and no greater than the MaxTagSize()</param>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the cipher has not been keyed for encryption, the tag length is invalid, or a packet nonce is an invalid size</exception>
+	void SealBatch(const std::vector<AeadPacket> &Packets, const std::vector<byte> &Associated, const std::vector<byte> &Input, std::vector<byte> &Output, std::vector<byte> &Tags, const size_t TagLength);
+
 	/// <summary>
 	/// Add additional data to the authentication generator.  
 	/// <para>Must be called after Initialize(bool, ISymmetricKey), and before any processing of plaintext or ciphertext input. 
@@ -423,20 +444,7 @@ public:
 
 private:
 
-	void CalculateMac();
-	void Decrypt128(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset);
-	void DoubleBlock(const std::vector<byte> &Input, std::vector<byte> &Output);
-	void Encrypt128(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset);
-	void ExtendBlock(std::vector<byte> &Output, size_t Position);
-	void GenerateOffsets(const std::vector<byte> &Nonce);
-	void GetLSub(size_t N, std::vector<byte> &LSub);
-	uint Ntz(ulong X);
-	void ParallelDecrypt(const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset, size_t Length);
-	void ParallelEncrypt(const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset, size_t Length);
-	void ProcessPartial(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset, size_t Length);
-	void ProcessSegment(const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset, size_t Length);
-	void Reset();
-	void Scope();
+	OCB(OCBT<IBlockCipher>* Mode, BlockCiphers CipherType);
 };
 
 NAMESPACE_MODEEND
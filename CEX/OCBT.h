@@ -0,0 +1,1415 @@
+// The GPL version 3 License (GPLv3)
+// 
+// Copyright (c) 2017 vtdev.com
+// This file is part of the CEX Cryptographic library.
+// 
+// This program is free software : you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// This algorithm (OCB) was designed and patented by Phillip Rogaway.
+// This implementation of OCB is free for open source projects (GPL), 
+// otherwise, it's use may be subject to additional licensing restrictions.
+// The list of free OCB licenses are available on the OCB website:
+// http://web.cs.ucdavis.edu/~rogaway/ocb/license.htm
+//
+//
+// Implementation Details:
+// A cipher specialized template of the Offset CodeBook authenticated mode (OCB); the OCB class is this template instantiated with the IBlockCipher interface.
+
+#ifndef CEX_OCBT_H
+#define CEX_OCBT_H
+
+#include "IAeadMode.h"
+#include "AeadPacket.h"
+#include "IntUtils.h"
+#include "MemUtils.h"
+#include "ParallelUtils.h"
+#include "SymmetricKey.h"
+
+NAMESPACE_MODE
+
+/// <summary>
+/// An Offset CodeBook Authenticated Block Cipher Mode template, specialized at compile time for a block cipher type
+/// </summary>
+///
+/// <example>
+/// <description>Encrypting and authenticating a packet with a specialized AES-NI OCB:</description>
+/// <code>
+/// OCBT&lt;AHX&gt; cipher;
+/// // initialize for encryption
+/// cipher.Initialize(true, SymmetricKey(Key, Nonce));
+/// // encrypt the packet
+/// cipher.Transform(Input, 0, Output, 0, Input.size());
+/// // append the mac code to the output
+/// cipher.Finalize(Output, Input.size(), 16);
+/// </code>
+/// </example>
+///
+/// <remarks>
+/// <para>OCBT is the single implementation of the OCB mode; the OCB class wraps OCBT&lt;IBlockCipher&gt;, so the two produce identical output.
+/// The message cipher and the hash cipher are held as pointers to the template type; when the type is a final cipher class such as AHX, the offset masked block loops and the batch transforms call the cipher without the vtable, and inline its rounds if the cipher defines them in its header.
+/// The SIMD width of the wide transform (4, 8, or 16 blocks) is a compile time constant.
+/// The class implements IAeadMode, and can be used anywhere the interface is accepted.</para>
+///
+/// <list type="bullet">
+/// <item><description>The template parameter is a block cipher class, ex. OCBT&lt;AHX&gt;; the constructor arguments are forwarded to the constructors of both ciphers, or the cipher instances are passed to the OCBT(TCipher*, TCipher*, bool) constructor.</description></item>
+/// <item><description>The hash cipher is always owned and deleted by the mode; the message cipher is deleted only if the mode created it, or DestroyEngine is true.</description></item>
+/// <item><description>Many small messages can be processed under one key with the SealBatch and OpenBatch functions.</description></item>
+/// <item><description>Clone() copies both keyed ciphers and the offset state into a new instance.</description></item>
+/// <item><description>The nonce is between 12 and 15 bytes, the MAC code length is between 12 and 16 bytes.</description></item>
+/// </list>
+/// </remarks>
+template <typename TCipher>
+class OCBT final : public IAeadMode
+{
+private:
+
+	static const size_t BATCH_WINDOW = 64 * 1024;
+	static const size_t BLOCK_SIZE = 16;
+	static const size_t PREFETCH_HASH = 16 * 32;
+	static const size_t MAX_NONCESIZE = 15;
+	static const size_t MAX_TAGSIZE = 16;
+	static const size_t MIN_NONCESIZE = 12;
+	static const size_t MIN_TAGSIZE = 12;
+
+	// number of blocks processed by the widest cipher transform
+#if defined(__AVX512__)
+	static constexpr size_t SIMD_BLOCKS = 16;
+#elif defined(__AVX2__)
+	static constexpr size_t SIMD_BLOCKS = 8;
+#elif defined(__AVX__)
+	static constexpr size_t SIMD_BLOCKS = 4;
+#else
+	static constexpr size_t SIMD_BLOCKS = 1;
+#endif
+	static constexpr size_t SIMD_SIZE = SIMD_BLOCKS * BLOCK_SIZE;
+
+	std::vector<byte> m_aadData;
+	bool m_aadLoaded;
+	bool m_aadPreserve;
+	bool m_autoIncrement;
+	TCipher* m_blockCipher;
+	std::vector<byte> m_checkSum;
+	bool m_destroyEngine;
+	TCipher* m_hashCipher;
+	std::vector<std::vector<byte>> m_hashList;
+	bool m_isDestroyed;
+	bool m_isFinalized;
+	bool m_isInitialized;
+	ulong m_mainBlockCount;
+	bool m_isEncryption;
+	std::vector<SymmetricKeySize> m_legalKeySizes;
+	std::vector<byte> m_listAsterisk;
+	std::vector<byte> m_listDollar;
+	std::vector<byte> m_mainOffset;
+	std::vector<byte> m_mainOffset0;
+	std::vector<byte> m_mainStretch;
+	std::vector<byte> m_msgTag;
+	std::vector<byte> m_ocbNonce;
+	std::vector<byte> m_ocbVector;
+	ParallelOptions m_parallelProfile;
+	std::vector<byte> m_topInput;
+
+public:
+
+	OCBT(const OCBT&) = delete;
+	OCBT& operator=(const OCBT&) = delete;
+	OCBT& operator=(OCBT&&) = delete;
+
+	//~~~Properties~~~//
+
+	/// <summary>
+	/// Get/Set: Enable auto-incrementing of the input nonce, each time the Finalize method is called.
+	/// <para>Treats the Nonce value loaded during Initialize as a monotonic counter; 
+	/// incrementing the value by 1 and re-calculating the working set each time the cipher is finalized. 
+	/// If set to false, requires a re-key after each finalizer cycle.<para>
+	/// </summary>
+	bool &AutoIncrement() override
+	{
+		return m_autoIncrement;
+	}
+
+	/// <summary>
+	/// Get: Block size of internal cipher in bytes
+	/// </summary>
+	const size_t BlockSize() override
+	{
+		return BLOCK_SIZE;
+	}
+
+	/// <summary>
+	/// Get: The block ciphers formal type name
+	/// </summary>
+	const BlockCiphers CipherType() override
+	{
+		return m_blockCipher->Enumeral();
+	}
+
+	/// <summary>
+	/// Get: The underlying Block Cipher instance
+	/// </summary>
+	IBlockCipher* Engine() override
+	{
+		return m_blockCipher;
+	}
+
+	/// <summary>
+	/// Get: The Cipher Modes enumeration type name
+	/// </summary>
+	const CipherModes Enumeral() override
+	{
+		return CipherModes::OCB;
+	}
+
+	/// <summary>
+	/// Get: True if initialized for encryption, False for decryption
+	/// </summary>
+	const bool IsEncryption() override
+	{
+		return m_isEncryption;
+	}
+
+	/// <summary>
+	/// Get: The Block Cipher is ready to transform data
+	/// </summary>
+	const bool IsInitialized() override
+	{
+		return m_isInitialized;
+	}
+
+	/// <summary>
+	/// Get: Processor parallelization availability.
+	/// <para>Indicates whether parallel processing is available with this mode.
+	/// If parallel capable, input/output data arrays passed to the transform must be ParallelBlockSize in bytes to trigger parallelization.</para>
+	/// </summary>
+	const bool IsParallel() override
+	{
+		return m_parallelProfile.IsParallel();
+	}
+
+	/// <summary>
+	/// Get: Array of allowed cipher input key byte-sizes
+	/// </summary>
+	const  std::vector<SymmetricKeySize> &LegalKeySizes() override
+	{
+		return m_legalKeySizes;
+	}
+
+	/// <summary>
+	/// Get: The maximum legal tag length in bytes
+	/// </summary>
+	const size_t MaxTagSize() override
+	{
+		return MAX_TAGSIZE;
+	}
+
+	/// <summary>
+	/// Get: The minimum legal tag length in bytes
+	/// </summary>
+	const size_t MinTagSize() override
+	{
+		return MIN_TAGSIZE;
+	}
+
+	/// <summary>
+	/// Get: The cipher mode name
+	/// </summary>
+	const std::string Name() override
+	{
+		return std::string("OCB-") + m_blockCipher->Name();
+	}
+
+	/// <summary>
+	/// Get: Parallel block size; the byte-size of the input/output data arrays passed to a transform that trigger parallel processing.
+	/// <para>This value can be changed through the ParallelProfile class.<para>
+	/// </summary>
+	const size_t ParallelBlockSize() override
+	{
+		return m_parallelProfile.ParallelBlockSize();
+	}
+
+	/// <summary>
+	/// Get/Set: Parallel and SIMD capability flags and sizes 
+	/// <para>The maximum number of threads allocated when using multi-threaded processing can be set with the ParallelMaxDegree() property.
+	/// The ParallelBlockSize() property is auto-calculated, but can be changed; the value must be evenly divisible by ParallelMinimumSize().
+	/// Changes to these values must be made before the <see cref="Initialize(SymmetricKey)"/> function is called.</para>
+	/// </summary>
+	ParallelOptions &ParallelProfile() override
+	{
+		return m_parallelProfile;
+	}
+
+	/// <summary>
+	/// Get/Set: Persist a one-time associated data for the entire session.
+	/// <para>Allows the use of a single SetAssociatedData() call to apply the MAC data to all segments.
+	/// Finalize and Verify can be called multiple times, applying the initial associated data to each finalize cycle.<para>
+	/// </summary>
+	bool &PreserveAD() override
+	{
+		return m_aadPreserve;
+	}
+
+	/// <summary>
+	/// Get: Returns the full finalized MAC code value array
+	/// </summary>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the cipher has not been finalized</exception>
+	const std::vector<byte> Tag() override
+	{
+		if (!m_isFinalized)
+			throw CryptoCipherModeException("OCBT:Tag", "The cipher mode has not been finalized!");
+
+		return m_msgTag;
+	}
+
+	//~~~Constructor~~~//
+
+	/// <summary>
+	/// Initialize the Cipher Mode, constructing the block cipher and the hash cipher; both ciphers are owned by the mode
+	/// </summary>
+	///
+	/// <param name="CipherArgs">The block cipher constructor arguments, ex. the HKDF digest type and the number of rounds; can be empty</param>
+	template <typename... TArgs>
+	explicit OCBT(TArgs&&... CipherArgs)
+		:
+		m_aadData(BLOCK_SIZE),
+		m_aadLoaded(false),
+		m_aadPreserve(false),
+		m_autoIncrement(false),
+		m_blockCipher(new TCipher(CipherArgs...)),
+		m_checkSum(BLOCK_SIZE),
+		m_destroyEngine(true),
+		m_hashCipher(new TCipher(CipherArgs...)),
+		m_hashList(0),
+		m_isDestroyed(false),
+		m_isEncryption(false),
+		m_isFinalized(false),
+		m_isInitialized(false),
+		m_legalKeySizes(0),
+		m_listAsterisk(BLOCK_SIZE),
+		m_listDollar(BLOCK_SIZE),
+		m_mainBlockCount(0),
+		m_mainOffset(BLOCK_SIZE),
+		m_mainOffset0(BLOCK_SIZE),
+		m_mainStretch(BLOCK_SIZE + (BLOCK_SIZE / 2)),
+		m_msgTag(BLOCK_SIZE),
+		m_parallelProfile(BLOCK_SIZE, true, m_blockCipher->StateCacheSize() + PREFETCH_HASH, true),
+		m_topInput(0)
+	{
+		Scope();
+	}
+
+	/// <summary>
+	/// Initialize the Cipher Mode using block cipher instances
+	/// </summary>
+	///
+	/// <param name="Cipher">The uninitialized block cipher instance; can not be null</param>
+	/// <param name="HashCipher">An uninitialized instance of the same cipher type, used to derive the offsets and the tag; it is always deleted by the mode, and can not be null</param>
+	/// <param name="DestroyEngine">Delete the block cipher when the mode is destroyed</param>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if a null block cipher is used, or the cipher block-size is not 128 bits</exception>
+	OCBT(TCipher* Cipher, TCipher* HashCipher, bool DestroyEngine)
+		:
+		m_aadData(BLOCK_SIZE),
+		m_aadLoaded(false),
+		m_aadPreserve(false),
+		m_autoIncrement(false),
+		m_blockCipher(Cipher != 0 ? Cipher : throw CryptoCipherModeException("OCBT:CTor", "The Cipher can not be null!")),
+		m_checkSum(BLOCK_SIZE),
+		m_destroyEngine(DestroyEngine),
+		m_hashCipher(HashCipher != 0 ? HashCipher : throw CryptoCipherModeException("OCBT:CTor", "The hash Cipher can not be null!")),
+		m_hashList(0),
+		m_isDestroyed(false),
+		m_isEncryption(false),
+		m_isFinalized(false),
+		m_isInitialized(false),
+		m_legalKeySizes(0),
+		m_listAsterisk(BLOCK_SIZE),
+		m_listDollar(BLOCK_SIZE),
+		m_mainBlockCount(0),
+		m_mainOffset(BLOCK_SIZE),
+		m_mainOffset0(BLOCK_SIZE),
+		m_mainStretch(BLOCK_SIZE + (BLOCK_SIZE / 2)),
+		m_msgTag(BLOCK_SIZE),
+		m_parallelProfile(BLOCK_SIZE, true, m_blockCipher->StateCacheSize() + PREFETCH_HASH, true),
+		m_topInput(0)
+	{
+		if (m_blockCipher->BlockSize() != BLOCK_SIZE)
+			throw CryptoCipherModeException("OCBT:CTor", "The Cipher block-size must be 128 bit!");
+
+		Scope();
+	}
+
+	/// <summary>
+	/// Finalize objects
+	/// </summary>
+	~OCBT() override
+	{
+		Destroy();
+	}
+
+	//~~~Public Functions~~~//
+
+	/// <summary>
+	/// Create an initialized copy of this cipher mode.
+	/// <para>Both block cipher instances are copied with their Clone() functions, so the key is not expanded again; the copy owns its cipher instances.
+	/// The offsets, checksum, message and associated data state, and the parallel profile are copied.
+	/// The copy can be given a new nonce by calling Initialize with a key that contains only the nonce.
+	/// The caller is responsible for destroying the returned mode.</para>
+	/// </summary>
+	///
+	/// <returns>A new, initialized OCBT instance</returns>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the cipher mode has not been initialized</exception>
+	OCBT* Clone() override
+	{
+		if (!m_isInitialized)
+			throw CryptoCipherModeException("OCBT:Clone", "The cipher mode has not been initialized!");
+
+		OCBT* mode = new OCBT(static_cast<TCipher*>(m_blockCipher->Clone()), static_cast<TCipher*>(m_hashCipher->Clone()), true);
+		mode->m_aadData = m_aadData;
+		mode->m_aadLoaded = m_aadLoaded;
+		mode->m_aadPreserve = m_aadPreserve;
+		mode->m_autoIncrement = m_autoIncrement;
+		mode->m_checkSum = m_checkSum;
+		mode->m_hashList = m_hashList;
+		mode->m_isEncryption = m_isEncryption;
+		mode->m_isFinalized = m_isFinalized;
+		mode->m_isInitialized = true;
+		mode->m_listAsterisk = m_listAsterisk;
+		mode->m_listDollar = m_listDollar;
+		mode->m_mainBlockCount = m_mainBlockCount;
+		mode->m_mainOffset = m_mainOffset;
+		mode->m_mainOffset0 = m_mainOffset0;
+		mode->m_mainStretch = m_mainStretch;
+		mode->m_msgTag = m_msgTag;
+		mode->m_ocbNonce = m_ocbNonce;
+		mode->m_ocbVector = m_ocbVector;
+		mode->m_parallelProfile = m_parallelProfile;
+		mode->m_topInput = m_topInput;
+
+		return mode;
+	}
+
+	/// <summary>
+	/// Decrypt a single block of bytes.
+	/// <para>Decrypts one block of bytes beginning at a zero index.
+	/// Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">The input array of encrypted bytes</param>
+	/// <param name="Output">The output array of decrypted bytes</param>
+	void DecryptBlock(const std::vector<byte> &Input, std::vector<byte> &Output) override
+	{
+		Decrypt128(Input, 0, Output, 0);
+	}
+
+	/// <summary>
+	/// Decrypt a block of bytes with offset parameters.
+	/// <para>Decrypts one block of bytes using the designated offsets.
+	/// Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">The input array of encrypted bytes</param>
+	/// <param name="InOffset">Starting offset within the input array</param>
+	/// <param name="Output">The output array of decrypted bytes</param>
+	/// <param name="OutOffset">Starting offset within the output array</param>
+	void DecryptBlock(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset) override
+	{
+		Decrypt128(Input, InOffset, Output, OutOffset);
+	}
+
+	/// <summary>
+	/// Release all resources associated with the object; optional, called by the finalizer
+	/// </summary>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if state could not be destroyed</exception>
+	void Destroy() override
+	{
+		if (!m_isDestroyed)
+		{
+			m_isDestroyed = true;
+			m_aadLoaded = false;
+			m_aadPreserve = false;
+			m_isFinalized = false;
+			m_isEncryption = false;
+			m_isInitialized = false;
+			m_mainBlockCount = 0;
+			m_parallelProfile.Reset();
+
+			Utility::IntUtils::ClearVector(m_aadData);
+			Utility::IntUtils::ClearVector(m_checkSum);
+			Utility::IntUtils::ClearVector(m_hashList);
+			Utility::IntUtils::ClearVector(m_legalKeySizes);
+			Utility::IntUtils::ClearVector(m_listAsterisk);
+			Utility::IntUtils::ClearVector(m_listDollar);
+			Utility::IntUtils::ClearVector(m_mainOffset);
+			Utility::IntUtils::ClearVector(m_mainOffset0);
+			Utility::IntUtils::ClearVector(m_mainStretch);
+			Utility::IntUtils::ClearVector(m_msgTag);
+			Utility::IntUtils::ClearVector(m_ocbNonce);
+			Utility::IntUtils::ClearVector(m_ocbVector);
+			Utility::IntUtils::ClearVector(m_topInput);
+
+			if (m_destroyEngine)
+			{
+				m_destroyEngine = false;
+
+				if (m_blockCipher != 0)
+					delete m_blockCipher;
+			}
+
+			// the hash cipher is always created by the mode
+			if (m_hashCipher != 0)
+			{
+				delete m_hashCipher;
+				m_hashCipher = 0;
+			}
+		}
+	}
+
+	/// <summary>
+	/// Encrypt a single block of bytes. 
+	/// <para>Encrypts one block of bytes beginning at a zero index.
+	/// Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">The input array of plain text bytes</param>
+	/// <param name="Output">The output array of encrypted bytes</param>
+	void EncryptBlock(const std::vector<byte> &Input, std::vector<byte> &Output) override
+	{
+		Encrypt128(Input, 0, Output, 0);
+	}
+
+	/// <summary>
+	/// Encrypt a block of bytes using offset parameters. 
+	/// <para>Encrypts one block of bytes using the designated offsets.
+	/// Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">The input array of plain text bytes</param>
+	/// <param name="InOffset">Starting offset within the input array</param>
+	/// <param name="Output">The output array of encrypted bytes</param>
+	/// <param name="OutOffset">Starting offset within the output array</param>
+	void EncryptBlock(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset) override
+	{
+		Encrypt128(Input, InOffset, Output, OutOffset);
+	}
+
+	/// <summary>
+	/// Calculate the MAC code (Tag) and copy it to the Output array.   
+	/// <para>The output array must be of sufficient length to receive the MAC code.
+	/// This function finalizes the Encryption/Decryption cycle, all data must be processed before this function is called.
+	/// Initialize(bool, ISymmetricKey) must be called before the cipher can be re-used.</para>
+	/// </summary>
+	/// 
+	/// <param name="Output">The output array that receives the authentication code</param>
+	/// <param name="Offset">Starting offset within the output array</param>
+	/// <param name="Length">The number of MAC code bytes to write to the output array.
+	/// <para>Must be no greater then the MAC functions output size, and no less than the minimum Tag size of 12 bytes.</para></param>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the cipher is not initialized, or output array is too small</exception>
+	void Finalize(std::vector<byte> &Output, const size_t Offset, const size_t Length) override
+	{
+		if (Length > BLOCK_SIZE || Length < MIN_TAGSIZE)
+			throw CryptoCipherModeException("OCBT:Finalize", "The output length must be between 12 and 16 bytes!");
+
+		CalculateMac();
+		Utility::MemUtils::Copy(m_msgTag, 0, Output, Offset, Length);
+	}
+
+	/// <summary>
+	/// Initialize the Cipher instance.
+	/// <para>The legal symmetric key and nonce sizes are contained in the LegalKeySizes() property.
+	/// The Info parameter of the SymmetricKey can be used as the initial associated data.</para>
+	/// </summary>
+	/// 
+	/// <param name="Encryption">True if cipher is used for encryption, false to decrypt</param>
+	/// <param name="KeyParams">SymmetricKey containing the encryption Key and Nonce</param>
+	/// 
+	/// <exception cref="CryptoCipherModeException">Thrown if a null or invalid Key/Nonce is used</exception>
+	void Initialize(bool Encryption, ISymmetricKey &KeyParams) override
+	{
+		Scope();
+
+		if (KeyParams.Key().size() == 0)
+		{
+			if (KeyParams.Nonce() == m_ocbVector)
+				throw CryptoSymmetricCipherException("OCBT:Initialize", "The nonce can not be zeroised or reused!");
+			if (!m_blockCipher->IsInitialized())
+				throw CryptoSymmetricCipherException("OCBT:Initialize", "First initialization requires a key and nonce!");
+		}
+		else
+		{
+			if (!SymmetricKeySize::Contains(LegalKeySizes(), KeyParams.Key().size()))
+				throw CryptoSymmetricCipherException("OCBT:Initialize", "Invalid key size! Key must be one of the LegalKeySizes() in length.");
+
+			m_hashCipher->Initialize(true, KeyParams);
+			m_blockCipher->Initialize(Encryption, KeyParams);
+		}
+
+		if (KeyParams.Nonce().size() > MAX_NONCESIZE || KeyParams.Nonce().size() < MIN_NONCESIZE)
+			throw CryptoSymmetricCipherException("OCBT:Initialize", "Requires a nonce of at least 12, and no longer than 15 bytes!");
+		if (m_parallelProfile.IsParallel() && m_parallelProfile.ParallelBlockSize() < m_parallelProfile.ParallelMinimumSize() || m_parallelProfile.ParallelBlockSize() > m_parallelProfile.ParallelMaximumSize())
+			throw CryptoSymmetricCipherException("OCBT:Initialize", "The parallel block size is out of bounds!");
+		if (m_parallelProfile.IsParallel() && m_parallelProfile.ParallelBlockSize() % m_parallelProfile.ParallelMinimumSize() != 0)
+			throw CryptoSymmetricCipherException("OCBT:Initialize", "The parallel block size must be evenly aligned to the ParallelMinimumSize!");
+
+		m_isEncryption = Encryption;
+		m_ocbNonce = KeyParams.Nonce();
+		m_ocbVector = m_ocbNonce;
+		m_hashCipher->Transform(m_listAsterisk, 0, m_listAsterisk, 0);
+		DoubleBlock(m_listAsterisk, m_listDollar);
+		std::vector<byte> hash(BLOCK_SIZE);
+		DoubleBlock(m_listDollar, hash);
+		m_hashList.push_back(hash);
+		GenerateOffsets(m_ocbVector, m_topInput, m_mainStretch, m_mainOffset0);
+		Utility::MemUtils::COPY128(m_mainOffset0, 0, m_mainOffset, 0);
+
+		if (m_isFinalized)
+		{
+			Utility::MemUtils::Clear(m_msgTag, 0, m_msgTag.size());
+			m_isFinalized = false;
+		}
+
+		m_isInitialized = true;
+	}
+
+	/// <summary>
+	/// Decrypt and authenticate a batch of packets under the current key.
+	/// <para>Each packet is processed with its own nonce and associated data, the key schedules and L values are shared by the batch.
+	/// The tag of every packet is verified; the output of a packet that fails authentication is zeroed, and its Authentic flag is set to false.
+	/// The batch functions do not change the state of the streaming interface; Initialize(bool, ISymmetricKey) must have been called with a key, and for decryption, before this method can be used.</para>
+	/// </summary>
+	///
+	/// <param name="Packets">The packet descriptors; the Authentic member of each packet is set by this function</param>
+	/// <param name="Associated">The array containing the associated data of each packet</param>
+	/// <param name="Input">The array containing the cipher-text of each packet</param>
+	/// <param name="Output">The array receiving the plain-text of each packet</param>
+	/// <param name="Tags">The array containing the expected tag of each packet</param>
+	/// <param name="TagLength">The byte length of each tag; must be no less than the MinTagSize() size and no greater than the MaxTagSize()</param>
+	///
+	/// <returns>Returns true if every packet in the batch was authenticated</returns>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the cipher has not been keyed for decryption, the tag length is invalid, or a packet nonce is an invalid size</exception>
+	bool OpenBatch(std::vector<AeadPacket> &Packets, const std::vector<byte> &Associated, const std::vector<byte> &Input, std::vector<byte> &Output, const std::vector<byte> &Tags, const size_t TagLength)
+	{
+		if (!m_blockCipher->IsInitialized() || !m_hashCipher->IsInitialized())
+			throw CryptoCipherModeException("OCBT:OpenBatch", "The cipher mode has not been keyed!");
+		if (m_blockCipher->IsEncryption())
+			throw CryptoCipherModeException("OCBT:OpenBatch", "The cipher mode has not been initialized for decryption!");
+		if (TagLength < MIN_TAGSIZE || TagLength > MAX_TAGSIZE)
+			throw CryptoCipherModeException("OCBT:OpenBatch", "The length must be minimum of 12 and maximum of MAC code size!");
+
+		if (Packets.size() == 0)
+			return true;
+
+		std::vector<byte> tmpCodes(Packets.size() * BLOCK_SIZE);
+		bool isAuth = true;
+
+		BatchProcess(Packets, Associated, Input, Output, tmpCodes, false);
+
+		for (size_t i = 0; i < Packets.size(); ++i)
+		{
+			Packets[i].Authentic = Utility::IntUtils::Compare(tmpCodes, i * BLOCK_SIZE, Tags, Packets[i].TagOffset, TagLength);
+
+			if (!Packets[i].Authentic)
+			{
+				// never release unauthenticated plain-text
+				Utility::MemUtils::Clear(Output, Packets[i].OutOffset, Packets[i].Length);
+				isAuth = false;
+			}
+		}
+
+		Utility::MemUtils::Clear(tmpCodes, 0, tmpCodes.size());
+
+		return isAuth;
+	}
+
+	/// <summary>
+	/// Set the maximum number of threads allocated when using multi-threaded processing.
+	/// <para>When set to zero, thread count is set automatically. If set to 1, sets IsParallel() to false and runs in sequential mode. 
+	/// Thread count must be an even number, and not exceed the number of processor cores.</para>
+	/// </summary>
+	///
+	/// <param name="Degree">The desired number of threads</param>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if an invalid degree setting is used</exception>
+	void ParallelMaxDegree(size_t Degree) override
+	{
+		if (Degree == 0)
+			throw CryptoCipherModeException("OCBT:ParallelMaxDegree", "Parallel degree can not be zero!");
+		if (Degree % 2 != 0)
+			throw CryptoCipherModeException("OCBT:ParallelMaxDegree", "Parallel degree must be an even number!");
+		if (Degree > m_parallelProfile.ProcessorCount())
+			throw CryptoCipherModeException("OCBT:ParallelMaxDegree", "Parallel degree can not exceed processor count!");
+
+		m_parallelProfile.SetMaxDegree(Degree);
+	}
+
+	/// <summary>
+	/// Encrypt and authenticate a batch of packets under the current key.
+	/// <para>Each packet is processed with its own nonce and associated data, the key schedules and L values are shared by the batch.
+	/// The offset masked blocks of consecutive packets are encrypted together through the ciphers wide transform, and the associated data, final pad, and tag blocks of the group are each processed in one wide pass.
+	/// The batch functions do not change the state of the streaming interface; Initialize(bool, ISymmetricKey) must have been called with a key, and for encryption, before this method can be used.</para>
+	/// </summary>
+	///
+	/// <param name="Packets">The packet descriptors</param>
+	/// <param name="Associated">The array containing the associated data of each packet</param>
+	/// <param name="Input">The array containing the plain-text of each packet</param>
+	/// <param name="Output">The array receiving the cipher-text of each packet</param>
+	/// <param name="Tags">The array receiving the tag of each packet</param>
+	/// <param name="TagLength">The byte length of each tag; must be no less than the MinTagSize() size and no greater than the MaxTagSize()</param>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the cipher has not been keyed for encryption, the tag length is invalid, or a packet nonce is an invalid size</exception>
+	void SealBatch(const std::vector<AeadPacket> &Packets, const std::vector<byte> &Associated, const std::vector<byte> &Input, std::vector<byte> &Output, std::vector<byte> &Tags, const size_t TagLength)
+	{
+		if (!m_blockCipher->IsInitialized() || !m_hashCipher->IsInitialized())
+			throw CryptoCipherModeException("OCBT:SealBatch", "The cipher mode has not been keyed!");
+		if (!m_blockCipher->IsEncryption())
+			throw CryptoCipherModeException("OCBT:SealBatch", "The cipher mode has not been initialized for encryption!");
+		if (TagLength < MIN_TAGSIZE || TagLength > MAX_TAGSIZE)
+			throw CryptoCipherModeException("OCBT:SealBatch", "The length must be minimum of 12 and maximum of MAC code size!");
+
+		if (Packets.size() == 0)
+			return;
+
+		std::vector<byte> tmpCodes(Packets.size() * BLOCK_SIZE);
+
+		BatchProcess(Packets, Associated, Input, Output, tmpCodes, true);
+
+		for (size_t i = 0; i < Packets.size(); ++i)
+			Utility::MemUtils::Copy(tmpCodes, i * BLOCK_SIZE, Tags, Packets[i].TagOffset, TagLength);
+
+		Utility::MemUtils::Clear(tmpCodes, 0, tmpCodes.size());
+	}
+
+	/// <summary>
+	/// Add additional data to the authentication generator.  
+	/// <para>Must be called after Initialize(bool, ISymmetricKey), and before any processing of plaintext or ciphertext input. 
+	/// This function can only be called once per each initialization/finalization cycle.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">The input array of bytes to process</param>
+	/// <param name="Offset">Starting offset within the input array</param>
+	/// <param name="Length">The number of bytes to process</param>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if state has been processed</exception>
+	void SetAssociatedData(const std::vector<byte> &Input, const size_t Offset, const size_t Length) override
+	{
+		if (!m_isInitialized)
+			throw CryptoSymmetricCipherException("OCBT:SetAssociatedData", "The cipher has not been initialized!");
+		if (m_aadLoaded)
+			throw CryptoSymmetricCipherException("OCBT:SetAssociatedData", "The associated data can not be added after processing has begun!");
+
+		size_t blkCnt = 0;
+		size_t blkLen = Length;
+		size_t blkOff = Offset;
+		std::vector<byte> offsetHash(BLOCK_SIZE);
+
+		while (blkLen >= BLOCK_SIZE)
+		{
+			std::vector<byte> offset(BLOCK_SIZE);
+			GetLSub(Ntz(++blkCnt), offset);
+			std::vector<byte> tmp(BLOCK_SIZE);
+			Utility::MemUtils::COPY128(Input, blkOff, tmp, 0);
+			Utility::MemUtils::XorBlock(offset, 0, offsetHash, 0, BLOCK_SIZE);
+			Utility::MemUtils::XorBlock(offsetHash, 0, tmp, 0, BLOCK_SIZE);
+			m_hashCipher->Transform(tmp, 0, tmp, 0);
+			Utility::MemUtils::XorBlock(tmp, 0, m_aadData, 0, BLOCK_SIZE);
+			blkOff += BLOCK_SIZE;
+			blkLen -= BLOCK_SIZE;
+		}
+
+		if (blkLen != 0)
+		{
+			std::vector<byte> tmp(BLOCK_SIZE);
+			Utility::MemUtils::Copy(Input, blkOff, tmp, 0, blkLen);
+			ExtendBlock(tmp, blkLen);
+			Utility::MemUtils::XorBlock(m_listAsterisk, 0, offsetHash, 0, BLOCK_SIZE);
+			Utility::MemUtils::XorBlock(offsetHash, 0, tmp, 0, BLOCK_SIZE);
+			m_hashCipher->Transform(tmp, 0, tmp, 0);
+			Utility::MemUtils::XorBlock(tmp, 0, m_aadData, 0, BLOCK_SIZE);
+		}
+
+		m_aadLoaded = true;
+	}
+
+	/// <summary>
+	/// Transform a length of bytes with offset parameters. 
+	/// <para>This method processes a specified length of bytes, utilizing offsets incremented by the caller.
+	/// If IsParallel() is set to true, and the length is at least ParallelBlockSize(), the transform is run in parallel processing mode.
+	/// To disable parallel processing, set the ParallelOptions().IsParallel() property to false.
+	/// Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">The input array of bytes to transform</param>
+	/// <param name="InOffset">Starting offset within the input array</param>
+	/// <param name="Output">The output array of transformed bytes</param>
+	/// <param name="OutOffset">Starting offset within the output array</param>
+	/// <param name="Length">The number of bytes to transform</param>
+	void Transform(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset, const size_t Length) override
+	{
+		CexAssert(m_isInitialized, "The cipher mode has not been initialized!");
+		CexAssert(Utility::IntUtils::Min(Input.size() - InOffset, Output.size() - OutOffset) >= Length, "The data arrays are smaller than the the block-size!");
+
+		if (m_parallelProfile.IsParallel() && Length >= m_parallelProfile.ParallelBlockSize())
+		{
+			if (m_isEncryption)
+				ParallelEncrypt(Input, InOffset, Output, OutOffset, Length);
+			else
+				ParallelDecrypt(Input, InOffset, Output, OutOffset, Length);
+		}
+		else
+		{
+			const size_t BLKCNT = Length / BLOCK_SIZE;
+			if (m_isEncryption)
+			{
+				for (size_t i = 0; i < BLKCNT; ++i)
+					EncryptBlock(Input, InOffset + i * BLOCK_SIZE, Output, OutOffset + i * BLOCK_SIZE);
+			}
+			else
+			{
+				for (size_t i = 0; i < BLKCNT; ++i)
+					DecryptBlock(Input, InOffset + (i * BLOCK_SIZE), Output, OutOffset + (i * BLOCK_SIZE));
+			}
+
+			if (Length % BLOCK_SIZE != 0)
+			{
+				const size_t BLKOFF = (BLKCNT * BLOCK_SIZE);
+				ProcessPartial(Input, InOffset + BLKOFF, Output, OutOffset + BLKOFF, Length - BLKOFF);
+			}
+		}
+	}
+
+	/// <summary>
+	/// Generate the internal MAC code and compare it with the tag contained in the Input array.   
+	/// <para>This function finalizes the Decryption cycle and generates the MAC tag.
+	/// The cipher must be set for Decryption and the cipher-text bytes fully processed before calling this function.
+	/// Verify can be called in place of a Finalize(Output, Offset, Length) call, or after finalization.
+	/// Initialize(bool, ISymmetricKey) must be called before the cipher can be re-used.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">The input array containing the expected authentication code</param>
+	/// <param name="Offset">Starting offset within the input array</param>
+	/// <param name="Length">The number of bytes to compare.
+	/// <para>Must be no greater then the MAC functions output size, and no less than the MinTagSize() size.</para></param>
+	/// 
+	/// <returns>Returns false if the MAC code does not match</returns>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the cipher is not initialized for decryption</exception>
+	bool Verify(const std::vector<byte> &Input, const size_t Offset, const size_t Length) override
+	{
+		if (m_isEncryption)
+			throw CryptoCipherModeException("OCBT:Verify", "The cipher mode has not been initialized for decryption!");
+		if (!m_isInitialized && !m_isFinalized)
+			throw CryptoCipherModeException("OCBT:Verify", "The cipher mode has not been initialized!");
+		if (Length < MIN_TAGSIZE || Length > BLOCK_SIZE)
+			throw CryptoCipherModeException("OCBT:Verify", "The length must be minimum of 12 and maximum of MAC code size!");
+
+		if (!m_isFinalized)
+			CalculateMac();
+
+		return Utility::IntUtils::Compare(m_msgTag, 0, Input, Offset, Length);
+	}
+
+private:
+
+	void BatchProcess(const std::vector<AeadPacket> &Packets, const std::vector<byte> &Associated, const std::vector<byte> &Input, std::vector<byte> &Output, std::vector<byte> &Codes, bool Encryption)
+	{
+		std::vector<byte> adOffset(BLOCK_SIZE);
+		std::vector<byte> adSum(0);
+		std::vector<byte> chkSum(0);
+		std::vector<byte> hashBlk(0);
+		std::vector<size_t> hashPos(0);
+		std::vector<byte> lAsterisk(BLOCK_SIZE);
+		std::vector<byte> lDollar(BLOCK_SIZE);
+		std::vector<std::vector<byte>> lList(1, std::vector<byte>(BLOCK_SIZE));
+		std::vector<byte> mainBlk(0);
+		std::vector<byte> mainChain(0);
+		std::vector<byte> mainOffset(BLOCK_SIZE);
+		std::vector<size_t> mainPos(0);
+		std::vector<byte> stretch(BLOCK_SIZE + (BLOCK_SIZE / 2));
+		std::vector<byte> tagBlk(0);
+		std::vector<byte> tmpBlk(BLOCK_SIZE);
+		std::vector<byte> topInput(0);
+		size_t grpEnd = 0;
+		size_t grpStart = 0;
+		size_t maxBlk = 0;
+
+		// the key dependent values are derived locally, the state of the streaming interface is not changed
+		m_hashCipher->Transform(lAsterisk, 0, lAsterisk, 0);
+		DoubleBlock(lAsterisk, lDollar);
+		DoubleBlock(lDollar, lList[0]);
+
+		for (size_t i = 0; i < Packets.size(); ++i)
+		{
+			if (Packets[i].Nonce.size() > MAX_NONCESIZE || Packets[i].Nonce.size() < MIN_NONCESIZE)
+				throw CryptoCipherModeException("OCBT:BatchProcess", "Requires a nonce of at least 12, and no longer than 15 bytes!");
+
+			maxBlk = Utility::IntUtils::Max(maxBlk, Utility::IntUtils::Max(Packets[i].AdLength, Packets[i].Length) / BLOCK_SIZE);
+		}
+
+		// block i uses L[ntz(i)], so the list covers the longest packet
+		while ((static_cast<size_t>(1) << lList.size()) <= maxBlk)
+		{
+			lList.push_back(std::vector<byte>(BLOCK_SIZE));
+			DoubleBlock(lList[lList.size() - 2], lList[lList.size() - 1]);
+		}
+
+		while (grpStart != Packets.size())
+		{
+			// group consecutive packets up to the batch window; a packet larger than the window is processed alone
+			size_t grpLen = 0;
+			size_t hashLen = 0;
+			size_t mainLen = 0;
+			grpEnd = grpStart;
+
+			do
+			{
+				grpLen += BLOCK_SIZE + Packets[grpEnd].AdLength + Packets[grpEnd].Length;
+				++grpEnd;
+			}
+			while (grpEnd != Packets.size() && grpLen + BLOCK_SIZE + Packets[grpEnd].AdLength + Packets[grpEnd].Length <= BATCH_WINDOW);
+
+			const size_t PKTCNT = grpEnd - grpStart;
+
+			for (size_t i = grpStart; i != grpEnd; ++i)
+			{
+				mainLen += Packets[i].Length - (Packets[i].Length % BLOCK_SIZE);
+				hashLen += (((Packets[i].AdLength + BLOCK_SIZE - 1) / BLOCK_SIZE) + ((Packets[i].Length % BLOCK_SIZE != 0) ? 1 : 0)) * BLOCK_SIZE;
+			}
+
+			adSum.resize(PKTCNT * BLOCK_SIZE);
+			chkSum.resize(PKTCNT * BLOCK_SIZE);
+			hashBlk.resize(hashLen);
+			hashPos.resize(PKTCNT);
+			mainBlk.resize(mainLen);
+			mainChain.resize(mainLen);
+			mainPos.resize(PKTCNT);
+			tagBlk.resize(PKTCNT * BLOCK_SIZE);
+			Utility::MemUtils::Clear(adSum, 0, adSum.size());
+			Utility::MemUtils::Clear(chkSum, 0, chkSum.size());
+			Utility::MemUtils::Clear(hashBlk, 0, hashBlk.size());
+
+			size_t hashCtr = 0;
+			size_t mainCtr = 0;
+
+			// mask every block of the group with its offset: the message blocks for the cipher, the associated data and final pad blocks for the hash cipher
+			for (size_t i = grpStart; i != grpEnd; ++i)
+			{
+				const AeadPacket &PKT = Packets[i];
+				const size_t ADBLKS = PKT.AdLength / BLOCK_SIZE;
+				const size_t BLKCNT = PKT.Length / BLOCK_SIZE;
+				const size_t PKTIDX = (i - grpStart) * BLOCK_SIZE;
+
+				// consecutive nonces share the stretch, the cipher is applied once every 64 nonces
+				GenerateOffsets(PKT.Nonce, topInput, stretch, mainOffset);
+				mainPos[i - grpStart] = mainCtr;
+
+				for (size_t j = 0; j < BLKCNT; ++j)
+				{
+					Utility::MemUtils::XOR128(lList[Ntz(j + 1)], 0, mainOffset, 0);
+					Utility::MemUtils::COPY128(mainOffset, 0, mainChain, mainCtr);
+					Utility::MemUtils::COPY128(Input, PKT.InOffset + (j * BLOCK_SIZE), mainBlk, mainCtr);
+
+					if (Encryption)
+						Utility::MemUtils::XOR128(mainBlk, mainCtr, chkSum, PKTIDX);
+
+					Utility::MemUtils::XOR128(mainOffset, 0, mainBlk, mainCtr);
+					mainCtr += BLOCK_SIZE;
+				}
+
+				hashPos[i - grpStart] = hashCtr;
+				Utility::MemUtils::Clear(adOffset, 0, BLOCK_SIZE);
+
+				for (size_t j = 0; j < ADBLKS; ++j)
+				{
+					Utility::MemUtils::XOR128(lList[Ntz(j + 1)], 0, adOffset, 0);
+					Utility::MemUtils::COPY128(Associated, PKT.AdOffset + (j * BLOCK_SIZE), hashBlk, hashCtr);
+					Utility::MemUtils::XOR128(adOffset, 0, hashBlk, hashCtr);
+					hashCtr += BLOCK_SIZE;
+				}
+
+				if (PKT.AdLength % BLOCK_SIZE != 0)
+				{
+					const size_t ADRMD = PKT.AdLength % BLOCK_SIZE;
+
+					Utility::MemUtils::XOR128(lAsterisk, 0, adOffset, 0);
+					Utility::MemUtils::Copy(Associated, PKT.AdOffset + (ADBLKS * BLOCK_SIZE), hashBlk, hashCtr, ADRMD);
+					hashBlk[hashCtr + ADRMD] = 0x80;
+					Utility::MemUtils::XOR128(adOffset, 0, hashBlk, hashCtr);
+					hashCtr += BLOCK_SIZE;
+				}
+
+				if (PKT.Length % BLOCK_SIZE != 0)
+				{
+					// the pad of a partial final block is E(Offset_m ^ L*)
+					Utility::MemUtils::XOR128(lAsterisk, 0, mainOffset, 0);
+					Utility::MemUtils::COPY128(mainOffset, 0, hashBlk, hashCtr);
+					hashCtr += BLOCK_SIZE;
+				}
+
+				// the final offset is held in the tag block until the checksum is complete
+				Utility::MemUtils::COPY128(mainOffset, 0, tagBlk, PKTIDX);
+			}
+
+			// the blocks of every packet in the group pass through the wide transforms together
+			BatchTransform(m_blockCipher, mainBlk, mainLen);
+			BatchTransform(m_hashCipher, hashBlk, hashLen);
+
+			for (size_t i = grpStart; i != grpEnd; ++i)
+			{
+				const AeadPacket &PKT = Packets[i];
+				const size_t ADCNT = (PKT.AdLength + BLOCK_SIZE - 1) / BLOCK_SIZE;
+				const size_t BLKCNT = PKT.Length / BLOCK_SIZE;
+				const size_t PKTIDX = (i - grpStart) * BLOCK_SIZE;
+				size_t blkPos = mainPos[i - grpStart];
+				size_t padPos = hashPos[i - grpStart];
+
+				for (size_t j = 0; j < BLKCNT; ++j)
+				{
+					Utility::MemUtils::XOR128(mainChain, blkPos, mainBlk, blkPos);
+
+					if (!Encryption)
+						Utility::MemUtils::XOR128(mainBlk, blkPos, chkSum, PKTIDX);
+
+					Utility::MemUtils::COPY128(mainBlk, blkPos, Output, PKT.OutOffset + (j * BLOCK_SIZE));
+					blkPos += BLOCK_SIZE;
+				}
+
+				for (size_t j = 0; j < ADCNT; ++j)
+				{
+					Utility::MemUtils::XOR128(hashBlk, padPos, adSum, PKTIDX);
+					padPos += BLOCK_SIZE;
+				}
+
+				if (PKT.Length % BLOCK_SIZE != 0)
+				{
+					const size_t MSGRMD = PKT.Length % BLOCK_SIZE;
+					const size_t MSGOFF = BLKCNT * BLOCK_SIZE;
+
+					// the checksum takes the padded plain-text of the final block
+					Utility::MemUtils::Clear(tmpBlk, 0, BLOCK_SIZE);
+					Utility::MemUtils::Copy(Input, PKT.InOffset + MSGOFF, tmpBlk, 0, MSGRMD);
+
+					if (Encryption)
+					{
+						tmpBlk[MSGRMD] = 0x80;
+						Utility::MemUtils::XOR128(tmpBlk, 0, chkSum, PKTIDX);
+						Utility::MemUtils::XorBlock(hashBlk, padPos, tmpBlk, 0, MSGRMD);
+						Utility::MemUtils::Copy(tmpBlk, 0, Output, PKT.OutOffset + MSGOFF, MSGRMD);
+					}
+					else
+					{
+						Utility::MemUtils::XorBlock(hashBlk, padPos, tmpBlk, 0, MSGRMD);
+						Utility::MemUtils::Copy(tmpBlk, 0, Output, PKT.OutOffset + MSGOFF, MSGRMD);
+						tmpBlk[MSGRMD] = 0x80;
+						Utility::MemUtils::XOR128(tmpBlk, 0, chkSum, PKTIDX);
+					}
+				}
+
+				// Tag = E(Checksum ^ Offset ^ L$) ^ HASH(A)
+				Utility::MemUtils::XOR128(chkSum, PKTIDX, tagBlk, PKTIDX);
+				Utility::MemUtils::XOR128(lDollar, 0, tagBlk, PKTIDX);
+			}
+
+			BatchTransform(m_hashCipher, tagBlk, tagBlk.size());
+
+			for (size_t i = grpStart; i != grpEnd; ++i)
+			{
+				Utility::MemUtils::XOR128(adSum, (i - grpStart) * BLOCK_SIZE, tagBlk, (i - grpStart) * BLOCK_SIZE);
+				Utility::MemUtils::COPY128(tagBlk, (i - grpStart) * BLOCK_SIZE, Codes, i * BLOCK_SIZE);
+			}
+
+			grpStart = grpEnd;
+		}
+
+		Utility::MemUtils::Clear(adSum, 0, adSum.size());
+		Utility::MemUtils::Clear(chkSum, 0, chkSum.size());
+		Utility::MemUtils::Clear(hashBlk, 0, hashBlk.size());
+		Utility::MemUtils::Clear(mainBlk, 0, mainBlk.size());
+		Utility::MemUtils::Clear(mainChain, 0, mainChain.size());
+		Utility::MemUtils::Clear(tagBlk, 0, tagBlk.size());
+		Utility::MemUtils::Clear(tmpBlk, 0, tmpBlk.size());
+	}
+
+	void BatchTransform(TCipher* Cipher, std::vector<byte> &Data, const size_t Length)
+	{
+		const size_t PBKALN = Length - (Length % SIMD_SIZE);
+		size_t blkCtr = 0;
+
+		while (blkCtr != PBKALN)
+		{
+			TransformW(Cipher, Data, blkCtr, Data, blkCtr);
+			blkCtr += SIMD_SIZE;
+		}
+
+		while (blkCtr != Length)
+		{
+			Cipher->Transform(Data, blkCtr, Data, blkCtr);
+			blkCtr += BLOCK_SIZE;
+		}
+	}
+
+	void CalculateMac()
+	{
+		Utility::MemUtils::XOR128(m_mainOffset, 0, m_checkSum, 0);
+		Utility::MemUtils::XOR128(m_listDollar, 0, m_checkSum, 0);
+		m_hashCipher->Transform(m_checkSum, 0, m_checkSum, 0);
+		Utility::MemUtils::XOR128(m_aadData, 0, m_checkSum, 0);
+		Utility::MemUtils::COPY128(m_checkSum, 0, m_msgTag, 0);
+		Reset();
+
+		if (m_autoIncrement)
+		{
+			Utility::IntUtils::BeIncrement8(m_ocbNonce);
+			std::vector<byte> zero(0);
+			Key::Symmetric::SymmetricKey nonceKey(zero, m_ocbNonce);
+			Initialize(m_isEncryption, nonceKey);
+		}
+
+		m_isFinalized = true;
+	}
+
+	void Decrypt128(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
+	{
+		CexAssert(m_isInitialized, "The cipher mode has not been initialized!");
+		CexAssert(Utility::IntUtils::Min(Input.size() - InOffset, Output.size() - OutOffset) >= BLOCK_SIZE, "The data arrays are smaller than the the block-size!");
+
+		Utility::MemUtils::COPY128(Input, InOffset, Output, OutOffset);
+		std::vector<byte> hash(BLOCK_SIZE);
+		GetLSub(Ntz(++m_mainBlockCount), hash);
+		Utility::MemUtils::XorBlock(hash, 0, m_mainOffset, 0, BLOCK_SIZE);
+		Utility::MemUtils::XorBlock(m_mainOffset, 0, Output, OutOffset, BLOCK_SIZE);
+		m_blockCipher->Transform(Output, OutOffset, Output, OutOffset);
+		Utility::MemUtils::XorBlock(m_mainOffset, 0, Output, OutOffset, BLOCK_SIZE);
+		Utility::MemUtils::XorBlock(Output, OutOffset, m_checkSum, 0, BLOCK_SIZE);
+	}
+
+	void DoubleBlock(const std::vector<byte> &Input, std::vector<byte> &Output)
+	{
+		uint carry = Utility::IntUtils::ShiftLeft(Input, Output);
+		uint x = (1 - carry) << 3;
+		byte n = (x == 0) ? 0x87 : (byte)((ulong)0x87 >> x);
+
+		Output[MAX_NONCESIZE] ^= n;
+	}
+
+	void Encrypt128(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
+	{
+		CexAssert(m_isInitialized, "The cipher mode has not been initialized!");
+		CexAssert(Utility::IntUtils::Min(Input.size() - InOffset, Output.size() - OutOffset) >= BLOCK_SIZE, "The data arrays are smaller than the the block-size!");
+
+		Utility::MemUtils::COPY128(Input, InOffset, Output, OutOffset);
+		Utility::MemUtils::XorBlock(Output, OutOffset, m_checkSum, 0, BLOCK_SIZE);
+		std::vector<byte> hash(BLOCK_SIZE);
+		GetLSub(Ntz(++m_mainBlockCount), hash);
+		Utility::MemUtils::XorBlock(hash, 0, m_mainOffset, 0, BLOCK_SIZE);
+		Utility::MemUtils::XorBlock(m_mainOffset, 0, Output, OutOffset, BLOCK_SIZE);
+		m_blockCipher->Transform(Output, OutOffset, Output, OutOffset);
+		Utility::MemUtils::XorBlock(m_mainOffset, 0, Output, OutOffset, BLOCK_SIZE);
+	}
+
+	void ExtendBlock(std::vector<byte> &Output, size_t Position)
+	{
+		Output[Position] = (byte)0x80;
+		++Position;
+		if (Position < BLOCK_SIZE)
+			Utility::MemUtils::Clear(Output, Position, Output.size() - Position);
+	}
+
+	void GenerateOffsets(const std::vector<byte> &Nonce, std::vector<byte> &TopInput, std::vector<byte> &Stretch, std::vector<byte> &Offset)
+	{
+		std::vector<byte> tmpNonce(BLOCK_SIZE);
+		Utility::MemUtils::Copy(Nonce, 0, tmpNonce, BLOCK_SIZE - Nonce.size(), Nonce.size());
+		tmpNonce[0] = (byte)(BLOCK_SIZE << 4);
+		tmpNonce[MAX_NONCESIZE - Nonce.size()] |= 1;
+		uint bottom = tmpNonce[MAX_NONCESIZE] & 0x3F;
+		tmpNonce[MAX_NONCESIZE] &= 0xC0;
+
+		// when used with incrementing nonces, the cipher is only applied once every 64 inits
+		if (tmpNonce != TopInput)
+		{
+			std::vector<byte> kTop(BLOCK_SIZE);
+			TopInput = tmpNonce;
+			m_hashCipher->Transform(TopInput, 0, kTop, 0);
+			Utility::MemUtils::COPY128(kTop, 0, Stretch, 0);
+
+			for (size_t i = 0; i < 8; ++i)
+				Stretch[BLOCK_SIZE + i] = (byte)(kTop[i] ^ kTop[i + 1]);
+		}
+
+		const size_t BTMSZE = bottom % 8;
+		size_t btmLen = bottom / 8;
+
+		if (BTMSZE == 0)
+		{
+			Utility::MemUtils::COPY128(Stretch, btmLen, Offset, 0);
+		}
+		else
+		{
+			for (size_t i = 0; i < BLOCK_SIZE; ++i)
+			{
+				ulong b1 = Stretch[btmLen];
+				ulong b2 = Stretch[++btmLen];
+
+				Offset[i] = (byte)((b1 << BTMSZE) | (b2 >> (8 - BTMSZE)));
+			}
+		}
+	}
+
+	void GetLSub(size_t N, std::vector<byte> &LSub)
+	{
+		size_t hashCtr = m_hashList.size();
+		while (N >= hashCtr)
+		{
+			DoubleBlock(m_hashList[m_hashList.size() - 1], LSub);
+			m_hashList.push_back(LSub);
+			++hashCtr;
+		}
+
+		Utility::MemUtils::COPY128(m_hashList[N], 0, LSub, 0);
+	}
+
+	uint Ntz(ulong X)
+	{
+		uint zCnt = 0;
+
+		while (!(X & 1)) 
+		{
+			X >>= 1;
+			++zCnt;
+		}
+
+		return zCnt;
+	}
+
+	void ParallelDecrypt(const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset, size_t Length)
+	{
+		const size_t BLKCNT = Length / BLOCK_SIZE;
+		const size_t ALNLEN = Length - (Length % BLOCK_SIZE);
+		const size_t OUTOFF = OutOffset;
+
+		// copy data into working output
+		Utility::MemUtils::Copy(Input, InOffset, Output, OutOffset, ALNLEN);
+		// create the offset chain
+		std::vector<byte> offsetChain(ALNLEN);
+		std::vector<byte> hash(BLOCK_SIZE);
+
+		// TODO: parallelize this with smaller chains?
+		for (size_t i = 0; i < BLKCNT; ++i)
+		{
+			GetLSub(Ntz(++m_mainBlockCount), hash);
+			Utility::MemUtils::XorBlock(hash, 0, m_mainOffset, 0, BLOCK_SIZE);
+			Utility::MemUtils::COPY128(m_mainOffset, 0, offsetChain, i * BLOCK_SIZE);
+		}
+
+		// parallel offsets
+		const size_t PRLSZE = m_parallelProfile.ParallelBlockSize();
+		const size_t CNKSZE = PRLSZE / m_parallelProfile.ParallelMaxDegree();
+		size_t chainPos = 0;
+
+		while (Length >= PRLSZE)
+		{
+			Utility::ParallelUtils::ParallelFor(0, m_parallelProfile.ParallelMaxDegree(), [this, &Output, OutOffset, &offsetChain, chainPos, CNKSZE](size_t i)
+			{
+				this->ProcessSegment(offsetChain, chainPos + (i * CNKSZE), Output, OutOffset + (i * CNKSZE), CNKSZE);
+			});
+
+			Length -= PRLSZE;
+			OutOffset += PRLSZE;
+			chainPos += PRLSZE;
+		}
+
+		if (Length != 0)
+		{
+			while (Length >= BLOCK_SIZE)
+			{
+				Utility::MemUtils::XorBlock(offsetChain, chainPos, Output, OutOffset, BLOCK_SIZE);
+				m_blockCipher->Transform(Output, OutOffset, Output, OutOffset);
+				Utility::MemUtils::XorBlock(offsetChain, chainPos, Output, OutOffset, BLOCK_SIZE);
+
+				Length -= BLOCK_SIZE;
+				OutOffset += BLOCK_SIZE;
+				chainPos += BLOCK_SIZE;
+			}
+
+			if (Length != 0)
+				ProcessPartial(Input, InOffset + ALNLEN, Output, OutOffset, Length);
+		}
+
+		// update the checksum
+		for (size_t i = 0; i < BLKCNT; ++i)
+			Utility::MemUtils::XorBlock(Output, OUTOFF + (i * BLOCK_SIZE), m_checkSum, 0, BLOCK_SIZE);
+	}
+
+	void ParallelEncrypt(const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset, size_t Length)
+	{
+		const size_t BLKCNT = Length / BLOCK_SIZE;
+		const size_t ALNLEN = Length - (Length % BLOCK_SIZE);
+
+		// copy data into working output
+		Utility::MemUtils::Copy(Input, InOffset, Output, OutOffset, ALNLEN);
+
+		// pre-fold the checksum
+		for (size_t i = 0; i < BLKCNT; ++i)
+			Utility::MemUtils::XOR128(Output, OutOffset + (i * BLOCK_SIZE), m_checkSum, 0);
+
+		// create the offset chain
+		std::vector<byte> offsetChain(ALNLEN);
+		std::vector<byte> hash(BLOCK_SIZE);
+
+		// TODO: parallelize this with smaller chains?
+		for (size_t i = 0; i < BLKCNT; ++i)
+		{
+			GetLSub(Ntz(++m_mainBlockCount), hash);
+			Utility::MemUtils::XOR128(hash, 0, m_mainOffset, 0);
+			Utility::MemUtils::COPY128(m_mainOffset, 0, offsetChain, i * BLOCK_SIZE);
+		}
+
+		// parallel offsets
+		const size_t PRLSZE = m_parallelProfile.ParallelBlockSize();
+		const size_t CNKSZE = PRLSZE / m_parallelProfile.ParallelMaxDegree();
+		size_t chainPos = 0;
+
+		while (Length >= PRLSZE)
+		{
+			Utility::ParallelUtils::ParallelFor(0, m_parallelProfile.ParallelMaxDegree(), [this, &Output, OutOffset, &offsetChain, chainPos, CNKSZE](size_t i)
+			{
+				this->ProcessSegment(offsetChain, chainPos + (i * CNKSZE), Output, OutOffset + (i * CNKSZE), CNKSZE);
+			});
+
+			Length -= PRLSZE;
+			OutOffset += PRLSZE;
+			chainPos += PRLSZE;
+		}
+
+		if (Length != 0)
+		{
+			while (Length >= BLOCK_SIZE)
+			{
+				Utility::MemUtils::XOR128(offsetChain, chainPos, Output, OutOffset);
+				m_blockCipher->Transform(Output, OutOffset, Output, OutOffset);
+				Utility::MemUtils::XOR128(offsetChain, chainPos, Output, OutOffset);
+
+				Length -= BLOCK_SIZE;
+				OutOffset += BLOCK_SIZE;
+				chainPos += BLOCK_SIZE;
+			}
+
+			if (Length != 0)
+				ProcessPartial(Input, InOffset + ALNLEN, Output, OutOffset, Length);
+		}
+	}
+
+	void ProcessPartial(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset, size_t Length)
+	{
+		if (m_isEncryption)
+		{
+			Utility::MemUtils::Copy(Input, InOffset, Output, OutOffset, Length);
+			ExtendBlock(Output, OutOffset + Length);
+
+			Utility::MemUtils::XorBlock(Output, OutOffset, m_checkSum, 0, Length + 1);
+			Utility::MemUtils::XOR128(m_listAsterisk, 0, m_mainOffset, 0);
+
+			std::vector<byte> pad(BLOCK_SIZE);
+			m_hashCipher->Transform(m_mainOffset, 0, pad, 0);
+			Utility::MemUtils::XOR128(pad, 0, Output, OutOffset);
+		}
+		else
+		{
+			Utility::MemUtils::Copy(Input, InOffset, Output, OutOffset, Length);
+			Utility::MemUtils::XOR128(m_listAsterisk, 0, m_mainOffset, 0);
+
+			std::vector<byte> pad(BLOCK_SIZE);
+			m_hashCipher->Transform(m_mainOffset, 0, pad, 0);
+			Utility::MemUtils::XorBlock(pad, 0, Output, OutOffset, Length);
+
+			std::vector<byte> tmp(BLOCK_SIZE);
+			Utility::MemUtils::Copy(Output, OutOffset, tmp, 0, Length);
+			ExtendBlock(tmp, Length);
+			Utility::MemUtils::XOR128(tmp, 0, m_checkSum, 0);
+		}
+	}
+
+	void ProcessSegment(const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset, size_t Length)
+	{
+		if (Length >= SIMD_SIZE)
+		{
+			const size_t PBKALN = Length - (Length % SIMD_SIZE);
+			const size_t SUBBLK = PBKALN / SIMD_SIZE;
+
+			Utility::MemUtils::XorBlock(Input, InOffset, Output, OutOffset, PBKALN);
+			for (size_t i = 0; i < SUBBLK; ++i)
+				TransformW(m_blockCipher, Output, OutOffset + (i * SIMD_SIZE), Output, OutOffset + (i * SIMD_SIZE));
+			Utility::MemUtils::XorBlock(Input, InOffset, Output, OutOffset, PBKALN);
+		}
+	}
+
+	void Reset()
+	{
+		if (!m_aadPreserve)
+		{
+			m_aadLoaded = false;
+			Utility::MemUtils::Clear(m_aadData, 0, m_aadData.size());
+		}
+
+		m_mainBlockCount = 0;
+		Utility::MemUtils::Clear(m_checkSum, 0, m_checkSum.size());
+		Utility::MemUtils::Clear(m_listAsterisk, 0, m_listAsterisk.size());
+		Utility::MemUtils::Clear(m_listDollar, 0, m_listDollar.size());
+		Utility::MemUtils::Clear(m_mainOffset, 0, m_mainOffset.size());
+		Utility::MemUtils::Clear(m_mainOffset0, 0, m_mainOffset0.size());
+		Utility::MemUtils::Clear(m_mainStretch, 0, m_mainStretch.size());
+		Utility::MemUtils::Clear(m_ocbVector, 0, m_ocbVector.size());
+		Utility::MemUtils::Clear(m_topInput, 0, m_topInput.size());
+		m_hashList.clear();
+		m_isInitialized = false;
+	}
+
+	void Scope()
+	{
+		std::vector<SymmetricKeySize> keySizes = m_blockCipher->LegalKeySizes();
+		m_legalKeySizes.resize(keySizes.size());
+
+		for (size_t i = 0; i < m_legalKeySizes.size(); ++i)
+		{
+			m_legalKeySizes[i] = SymmetricKeySize(keySizes[i].KeySize(), MAX_NONCESIZE, keySizes[i].NonceSize());
+		}
+
+		m_hashList.clear();
+		m_hashList.reserve(PREFETCH_HASH);
+
+		if (!m_parallelProfile.IsDefault())
+		{
+			m_parallelProfile.Calculate();
+		}
+	}
+
+	void TransformW(TCipher* Cipher, const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
+	{
+#if defined(__AVX512__)
+		Cipher->Transform2048(Input, InOffset, Output, OutOffset);
+#elif defined(__AVX2__)
+		Cipher->Transform1024(Input, InOffset, Output, OutOffset);
+#elif defined(__AVX__)
+		Cipher->Transform512(Input, InOffset, Output, OutOffset);
+#else
+		Cipher->Transform(Input, InOffset, Output, OutOffset);
+#endif
+	}
+};
+
+NAMESPACE_MODEEND
+#endif
@@ -2,6 +2,8 @@
 #include "BlockCipherFromName.h"
 #include "IntUtils.h"
 #include "MemUtils.h"
+#include <system_error>
+#include <thread>
 
 NAMESPACE_MODE
 
@@ -44,6 +46,11 @@ const bool OFB::IsParallel()
 	return m_parallelProfile.IsParallel(); 
 }
 
+const size_t OFB::KeyStreamReady()
+{
+	return m_ksWritten.load(std::memory_order_acquire) - m_ksRead;
+}
+
 const std::vector<SymmetricKeySize> &OFB::LegalKeySizes() 
 { 
 	return m_blockCipher->LegalKeySizes();
@@ -80,6 +87,11 @@ OFB::OFB(BlockCiphers CipherType, size_t RegisterSize)
 	m_isDestroyed(false),
 	m_isEncryption(false),
 	m_isInitialized(false),
+	m_ksActive(false),
+	m_ksQueue(0),
+	m_ksRead(0),
+	m_ksStop(false),
+	m_ksWritten(0),
 	m_ofbBuffer(m_blockCipher->BlockSize()),
 	m_ofbVector(m_blockCipher->BlockSize()),
 	m_parallelProfile(m_blockCipher->BlockSize(), false, m_blockCipher->StateCacheSize(), true)
@@ -99,6 +111,11 @@ OFB::OFB(IBlockCipher* Cipher, size_t RegisterSize)
 	m_isDestroyed(false),
 	m_isEncryption(false),
 	m_isInitialized(false),
+	m_ksActive(false),
+	m_ksQueue(0),
+	m_ksRead(0),
+	m_ksStop(false),
+	m_ksWritten(0),
 	m_ofbBuffer(m_blockCipher->BlockSize()),
 	m_ofbVector(m_blockCipher->BlockSize()),
 	m_parallelProfile(m_blockCipher->BlockSize(), false, m_blockCipher->StateCacheSize(), true)
@@ -116,14 +133,40 @@ OFB::~OFB()
 
 //~~~Public Functions~~~//
 
+OFB* OFB::Clone()
+{
+	if (!m_isInitialized)
+		throw CryptoCipherModeException("OFB:Clone", "The cipher mode has not been initialized!");
+
+	// the worker owns the feedback register while it runs
+	if (m_ksWorker.valid())
+		m_ksWorker.get();
+
+	OFB* mode = new OFB(m_blockCipher->Clone(), m_blockSize);
+	mode->m_destroyEngine = true;
+	mode->m_isEncryption = m_isEncryption;
+	mode->m_isInitialized = true;
+	mode->m_isParallel = m_isParallel;
+	mode->m_ksQueue = m_ksQueue;
+	mode->m_ksRead = m_ksRead;
+	mode->m_ksWritten.store(m_ksWritten.load(std::memory_order_acquire), std::memory_order_relaxed);
+	mode->m_ofbBuffer = m_ofbBuffer;
+	mode->m_ofbVector = m_ofbVector;
+	mode->m_parallelProfile = m_parallelProfile;
+
+	return mode;
+}
+
 void OFB::DecryptBlock(const std::vector<byte> &Input, std::vector<byte> &Output)
 {
-	Encrypt128(Input, 0, Output, 0);
+	if (ProcessQueue(Input, 0, Output, 0, m_blockSize) == 0)
+		Encrypt128(Input, 0, Output, 0);
 }
 
 void OFB::DecryptBlock(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
 {
-	Encrypt128(Input, InOffset, Output, OutOffset);
+	if (ProcessQueue(Input, InOffset, Output, OutOffset, m_blockSize) == 0)
+		Encrypt128(Input, InOffset, Output, OutOffset);
 }
 
 void OFB::Destroy()
@@ -137,6 +180,7 @@ void OFB::Destroy()
 		m_isInitialized = false;
 		m_isParallel = false;
 		m_parallelProfile.Reset();
+		StopPrecompute();
 
 		if (m_destroyEngine)
 		{
@@ -146,6 +190,7 @@ void OFB::Destroy()
 				delete m_blockCipher;
 		}
 
+		Utility::IntUtils::ClearVector(m_ksQueue);
 		Utility::IntUtils::ClearVector(m_ofbVector);
 		Utility::IntUtils::ClearVector(m_ofbBuffer);
 	}
@@ -153,12 +198,14 @@ void OFB::Destroy()
 
 void OFB::EncryptBlock(const std::vector<byte> &Input, std::vector<byte> &Output)
 {
-	Encrypt128(Input, 0, Output, 0);
+	if (ProcessQueue(Input, 0, Output, 0, m_blockSize) == 0)
+		Encrypt128(Input, 0, Output, 0);
 }
 
 void OFB::EncryptBlock(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
 {
-	Encrypt128(Input, InOffset, Output, OutOffset);
+	if (ProcessQueue(Input, InOffset, Output, OutOffset, m_blockSize) == 0)
+		Encrypt128(Input, InOffset, Output, OutOffset);
 }
 
 void OFB::Initialize(bool Encryption, ISymmetricKey &KeyParams)
@@ -170,6 +217,9 @@ void OFB::Initialize(bool Encryption, ISymmetricKey &KeyParams)
 	if (!SymmetricKeySize::Contains(LegalKeySizes(), KeyParams.Key().size()))
 		throw CryptoSymmetricCipherException("ICM:Initialize", "Invalid key size! Key must be one of the LegalKeySizes() members in length.");
 
+	// the queued key-stream belongs to the previous key and nonce
+	StopPrecompute();
+
 	std::vector<byte> tmpIv = KeyParams.Nonce();
 	m_blockCipher->Initialize(true, KeyParams);
 
@@ -201,10 +251,69 @@ void OFB::Transform(const std::vector<byte> &Input, const size_t InOffset, std::
 	if (Length % BLKSZE != 0)
 		throw CryptoCipherModeException("OFB:Transform", "Invalid length, must be evenly divisible by the ciphers block size!");
 
-	const size_t BLKCNT = Length / BLKSZE;
+	// consume the precomputed key-stream first, then continue from the feedback register
+	const size_t PRCLEN = ProcessQueue(Input, InOffset, Output, OutOffset, Length);
+	const size_t BLKCNT = (Length - PRCLEN) / BLKSZE;
 
 	for (size_t i = 0; i < BLKCNT; ++i)
-		EncryptBlock(Input, (i * BLKSZE) + InOffset, Output, (i * BLKSZE) + OutOffset);
+		Encrypt128(Input, (i * BLKSZE) + InOffset + PRCLEN, Output, (i * BLKSZE) + OutOffset + PRCLEN);
+}
+
+size_t OFB::Precompute(size_t Length, bool Background)
+{
+	if (!m_isInitialized)
+		throw CryptoCipherModeException("OFB:Precompute", "The cipher mode has not been initialized!");
+	if (m_blockSize != m_blockCipher->BlockSize())
+		throw CryptoCipherModeException("OFB:Precompute", "Precomputation requires a register size equal to the cipher block size!");
+
+	// one producer at a time; the feedback register is owned by the worker while it runs
+	if (m_ksWorker.valid())
+		m_ksWorker.get();
+
+	if (m_ksQueue.size() == 0)
+		m_ksQueue.resize(MAX_PRECOMPUTE);
+
+	const size_t FREELEN = m_ksQueue.size() - (m_ksWritten.load(std::memory_order_acquire) - m_ksRead);
+	size_t genLen = Utility::IntUtils::Min(Length, FREELEN);
+	genLen -= genLen % m_blockSize;
+
+	if (genLen != 0)
+	{
+		if (Background)
+		{
+			m_ksActive.store(true, std::memory_order_release);
+
+			try
+			{
+				m_ksWorker = std::async(std::launch::async, [this, genLen]()
+				{
+					// the flag is cleared on every exit, or a reader would wait on it forever; an exception is kept by the future
+					try
+					{
+						Generate(genLen);
+					}
+					catch (...)
+					{
+						m_ksActive.store(false, std::memory_order_release);
+						throw;
+					}
+
+					m_ksActive.store(false, std::memory_order_release);
+				});
+			}
+			catch (std::system_error const &)
+			{
+				m_ksActive.store(false, std::memory_order_release);
+				throw CryptoCipherModeException("OFB:Precompute", "The key-stream worker thread could not be started!");
+			}
+		}
+		else
+		{
+			Generate(genLen);
+		}
+	}
+
+	return genLen;
 }
 
 void OFB::Encrypt128(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
@@ -226,4 +335,76 @@ void OFB::Encrypt128(const std::vector<byte> &Input, const size_t InOffset, std:
 	Utility::MemUtils::Copy(m_ofbBuffer, 0, m_ofbVector, m_ofbVector.size() - m_blockSize, m_blockSize);
 }
 
+void OFB::Generate(size_t Length)
+{
+	const size_t BLKSZE = m_blockCipher->BlockSize();
+	size_t ksWrt = m_ksWritten.load(std::memory_order_relaxed);
+	size_t ksPos = ksWrt % m_ksQueue.size();
+
+	for (size_t i = 0; i < Length && !m_ksStop.load(std::memory_order_relaxed); i += BLKSZE)
+	{
+		// the output block is both the key-stream and the next register
+		m_blockCipher->Transform(m_ofbVector, 0, m_ksQueue, ksPos);
+		Utility::MemUtils::Copy(m_ksQueue, ksPos, m_ofbVector, 0, BLKSZE);
+		ksWrt += BLKSZE;
+		ksPos = (ksPos + BLKSZE == m_ksQueue.size()) ? 0 : ksPos + BLKSZE;
+		// publish each block, so a transform can start before the run is complete
+		m_ksWritten.store(ksWrt, std::memory_order_release);
+	}
+}
+
+size_t OFB::ProcessQueue(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset, const size_t Length)
+{
+	size_t prcLen = 0;
+
+	while (prcLen != Length)
+	{
+		size_t avlLen = m_ksWritten.load(std::memory_order_acquire) - m_ksRead;
+
+		if (avlLen == 0)
+		{
+			if (m_ksActive.load(std::memory_order_acquire))
+			{
+				// the worker is still generating; wait for the next block
+				std::this_thread::yield();
+				continue;
+			}
+
+			// the worker may have published its last blocks before it finished
+			avlLen = m_ksWritten.load(std::memory_order_acquire) - m_ksRead;
+
+			if (avlLen == 0)
+				break;
+		}
+
+		const size_t QUEPOS = m_ksRead % m_ksQueue.size();
+		const size_t CPYLEN = Utility::IntUtils::Min(Utility::IntUtils::Min(avlLen, Length - prcLen), m_ksQueue.size() - QUEPOS);
+
+		Utility::MemUtils::XorBlock(Input, InOffset + prcLen, m_ksQueue, QUEPOS, Output, OutOffset + prcLen, CPYLEN);
+		// key-stream is used once; erase it from the queue
+		Utility::MemUtils::Clear(m_ksQueue, QUEPOS, CPYLEN);
+		m_ksRead += CPYLEN;
+		prcLen += CPYLEN;
+	}
+
+	return prcLen;
+}
+
+void OFB::StopPrecompute()
+{
+	if (m_ksWorker.valid())
+	{
+		m_ksStop.store(true, std::memory_order_relaxed);
+		m_ksWorker.get();
+		m_ksStop.store(false, std::memory_order_relaxed);
+	}
+
+	if (m_ksQueue.size() != 0)
+		Utility::MemUtils::Clear(m_ksQueue, 0, m_ksQueue.size());
+
+	m_ksActive.store(false, std::memory_order_relaxed);
+	m_ksRead = 0;
+	m_ksWritten.store(0, std::memory_order_relaxed);
+}
+
 NAMESPACE_MODEEND
\ No newline at end of file
@@ -28,6 +28,8 @@
 #define CEX_OFB_H
 
 #include "ICipherMode.h"
+#include <atomic>
+#include <future>
 
 NAMESPACE_MODE
 
@@ -76,6 +78,8 @@ NAMESPACE_MODE
 /// <item><description>The DecryptBlock and EncryptBlock functions can only be accessed through the class instance.</description></item>
 /// <item><description>The transformation methods can not be called until the Initialize(bool, ISymmetricKey) function has been called.</description></item>
 /// <item><description>Due to block chain depenencies in OFB mode, neither the encryption or decryption functions can be processed in parallel.</description></item>
+/// <item><description>The key-stream does not depend on the message, so it can be generated ahead of the data with Precompute(size_t, bool); a following transform consumes the queued key-stream with a single xor, before continuing with the cipher.</description></item>
+/// <item><description>Precomputation can run on the calling thread during idle time, or on a background worker that the transform functions consume from as blocks become ready; up to 256 KB can be queued, and precomputation requires a register size equal to the cipher block size.</description></item>
 /// </list>
 /// 
 /// <description>Guiding Publications:</description>
@@ -90,6 +94,7 @@ class OFB final : public ICipherMode
 private:
 	static const size_t BLOCK_SIZE = 16;
 	static const std::string CLASS_NAME;
+	static const size_t MAX_PRECOMPUTE = 256 * 1024;
 
 	IBlockCipher* m_blockCipher;
 	size_t m_blockSize;
@@ -99,6 +104,12 @@ private:
 	bool m_isEncryption;
 	bool m_isInitialized;
 	bool m_isParallel;
+	std::atomic<bool> m_ksActive;
+	std::vector<byte> m_ksQueue;
+	size_t m_ksRead;
+	std::atomic<bool> m_ksStop;
+	std::future<void> m_ksWorker;
+	std::atomic<size_t> m_ksWritten;
 	std::vector<byte> m_ofbBuffer;
 	std::vector<byte> m_ofbVector;
 	ParallelOptions m_parallelProfile;
@@ -148,6 +159,11 @@ public:
 	/// </summary>
 	const bool IsParallel() override;
 
+	/// <summary>
+	/// Get: The number of precomputed key-stream bytes ready to be consumed by a transform
+	/// </summary>
+	const size_t KeyStreamReady();
+
 	/// <summary>
 	/// Get: Array of allowed cipher input key byte-sizes
 	/// </summary>
@@ -198,6 +214,17 @@ public:
 
 	//~~~Public Functions~~~//
 
+	/// <summary>
+	/// Create an initialized copy of this cipher mode.
+	/// <para>The block cipher is copied with its Clone() function, so the key is not expanded again, and the copy owns its cipher instance.
+	/// The feedback register, any queued key-stream, the direction, and the parallel profile are copied; a running background precomputation is completed first, and is not continued by the copy. The caller is responsible for destroying the returned mode.</para>
+	/// </summary>
+	///
+	/// <returns>A new, initialized OFB instance</returns>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the cipher mode has not been initialized</exception>
+	OFB* Clone() override;
+
 	/// <summary>
 	/// Decrypt a single block of bytes.
 	/// <para>Decrypts one block of bytes beginning at a zero index.
@@ -269,6 +296,22 @@ public:
 	/// <exception cref="Exception::CryptoCipherModeException">Thrown if an invalid degree setting is used</exception>
 	void ParallelMaxDegree(size_t Degree) override;
 
+	/// <summary>
+	/// Generate key-stream ahead of the message, and queue it for the next transform calls.
+	/// <para>A background precomputation runs on a worker thread, and the transform functions consume the key-stream as it is written, so the call returns immediately.
+	/// Otherwise the key-stream is generated on the calling thread, ex. during a gap in traffic.
+	/// If a background precomputation is still running, this call waits for it to complete.
+	/// Initialize(bool, ISymmetricKey) must be called before this method can be used, and re-initializing the cipher discards the queue.</para>
+	/// </summary>
+	///
+	/// <param name="Length">The number of key-stream bytes to generate; rounded down to the block size, and limited to the free space in the 256 KB queue</param>
+	/// <param name="Background">Generate the key-stream on a worker thread</param>
+	///
+	/// <returns>The number of key-stream bytes added to the queue</returns>
+	///
+	/// <exception cref="Exception::CryptoCipherModeException">Thrown if the cipher is not initialized, or the register size is smaller than the block size</exception>
+	size_t Precompute(size_t Length, bool Background = false);
+
 	/// <summary>
 	/// Transform a length of bytes with offset parameters. 
 	/// <para>This method processes a specified length of bytes, utilizing offsets incremented by the caller.
@@ -285,6 +328,9 @@ public:
 	private:
 
 	void Encrypt128(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset);
+	void Generate(size_t Length);
+	size_t ProcessQueue(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset, const size_t Length);
+	void StopPrecompute();
 };
 
 NAMESPACE_MODEEND
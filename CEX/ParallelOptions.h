@@ -35,9 +35,9 @@ private:
 	};
 
 	// 16kb min
-	const size_t DEF_DATACACHE = 16384;
+	static const size_t DEF_DATACACHE = 16384;
 	// 32mb, not enforced
-	const size_t MAX_PRLALLOC = DEF_DATACACHE * 2000;
+	static const size_t MAX_PRLALLOC = DEF_DATACACHE * 2000;
 
 	bool m_autoInit;
 	size_t m_blockSize;
@@ -28,6 +28,9 @@
 #elif defined(__AVX__)
 #	include "UInt128.h"
 #endif
+#if defined(__AVX__)
+#	include <wmmintrin.h>
+#endif
 
 NAMESPACE_UTILITY
 
@@ -42,6 +45,67 @@ class PolyMath
 {
 public:
 
+#if defined(__AVX__)
+
+	/// <summary>
+	/// Fill the output with the next blocks of the AES-128 counter mode key-stream;
+	/// the counter is a 128 bit big-endian integer, identical to the BCG generator stream
+	/// </summary>
+	template <size_t Length>
+	inline static void AesCtr(const std::array<__m128i, 11> &Round, ulong &CtrHigh, ulong &CtrLow, std::array<byte, Length> &Output)
+	{
+		const __m128i BSWAP = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+		const size_t BLKCNT = Length / 16;
+		std::array<__m128i, BLKCNT> blk;
+
+		for (size_t i = 0; i < BLKCNT; ++i)
+		{
+			blk[i] = _mm_xor_si128(_mm_shuffle_epi8(_mm_set_epi64x(static_cast<long long>(CtrHigh), static_cast<long long>(CtrLow)), BSWAP), Round[0]);
+			++CtrLow;
+			CtrHigh += (CtrLow == 0);
+		}
+
+		// the blocks are encrypted together to fill the aesenc pipeline
+		for (size_t r = 1; r < 10; ++r)
+		{
+			for (size_t i = 0; i < BLKCNT; ++i)
+				blk[i] = _mm_aesenc_si128(blk[i], Round[r]);
+		}
+
+		for (size_t i = 0; i < BLKCNT; ++i)
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(Output.data() + (i * 16)), _mm_aesenclast_si128(blk[i], Round[10]));
+	}
+
+	/// <summary>
+	/// Expand the AES-128 round keys; the key is the upper half of the 32 byte seed, the lower half is the initial counter
+	/// </summary>
+	inline static void AesExpand(const std::vector<byte> &Seed, std::array<__m128i, 11> &Round)
+	{
+		Round[0] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Seed.data() + 16));
+		Round[1] = AesExpandRot(Round[0], _mm_aeskeygenassist_si128(Round[0], 0x01));
+		Round[2] = AesExpandRot(Round[1], _mm_aeskeygenassist_si128(Round[1], 0x02));
+		Round[3] = AesExpandRot(Round[2], _mm_aeskeygenassist_si128(Round[2], 0x04));
+		Round[4] = AesExpandRot(Round[3], _mm_aeskeygenassist_si128(Round[3], 0x08));
+		Round[5] = AesExpandRot(Round[4], _mm_aeskeygenassist_si128(Round[4], 0x10));
+		Round[6] = AesExpandRot(Round[5], _mm_aeskeygenassist_si128(Round[5], 0x20));
+		Round[7] = AesExpandRot(Round[6], _mm_aeskeygenassist_si128(Round[6], 0x40));
+		Round[8] = AesExpandRot(Round[7], _mm_aeskeygenassist_si128(Round[7], 0x80));
+		Round[9] = AesExpandRot(Round[8], _mm_aeskeygenassist_si128(Round[8], 0x1B));
+		Round[10] = AesExpandRot(Round[9], _mm_aeskeygenassist_si128(Round[9], 0x36));
+	}
+
+	inline static __m128i AesExpandRot(__m128i K, __m128i KR)
+	{
+		KR = _mm_shuffle_epi32(KR, 0xFF);
+		K = _mm_xor_si128(K, _mm_slli_si128(K, 4));
+		K = _mm_xor_si128(K, _mm_slli_si128(K, 4));
+		K = _mm_xor_si128(K, _mm_slli_si128(K, 4));
+
+		return _mm_xor_si128(K, KR);
+	}
+
+#endif
+
 	template <class T>
 	inline static T Abs(T &V)
 	{
@@ -104,9 +168,27 @@ public:
 	template <typename Array>
 	inline static void BitReverse(Array &P)
 	{
+		const ushort* BitrevTable = BitReverseIndex();
 		uint r;
 		ushort tmp;
 
+		for (size_t i = 0; i < P.size(); ++i)
+		{
+			r = BitrevTable[i];
+			if (i < r)
+			{
+				tmp = P[i];
+				P[i] = P[r];
+				P[r] = tmp;
+			}
+		}
+	}
+
+	/// <summary>
+	/// The bit reversed order of 1024 coefficients; index i holds the position reversed in 10 bits
+	/// </summary>
+	inline static const ushort* BitReverseIndex()
+	{
 		static const ushort BitrevTable[1024] =
 		{
 			0, 512, 256, 768, 128, 640, 384, 896, 64, 576, 320, 832, 192, 704, 448, 960, 32, 544, 288, 800, 160, 672, 416, 928, 96, 608, 352, 864, 224, 736, 480, 992,
@@ -143,16 +225,7 @@ public:
 			31, 543, 287, 799, 159, 671, 415, 927, 95, 607, 351, 863, 223, 735, 479, 991, 63, 575, 319, 831, 191, 703, 447, 959, 127, 639, 383, 895, 255, 767, 511, 1023
 		};
 
-		for (size_t i = 0; i < P.size(); ++i)
-		{
-			r = BitrevTable[i];
-			if (i < r)
-			{
-				tmp = P[i];
-				P[i] = P[r];
-				P[r] = tmp;
-			}
-		}
+		return BitrevTable;
 	}
 
 	template <typename Array, class T>
@@ -4,6 +4,12 @@
 #include "HKDF.h"
 #include "IntUtils.h"
 #include "MemUtils.h"
+#if defined(__AVX__)
+#	include "UInt128.h"
+#endif
+#if defined(__AVX2__)
+#	include "UInt256.h"
+#endif
 
 NAMESPACE_BLOCK
 
@@ -48,6 +54,11 @@ const Digests RHX::KdfEngine()
 	return m_kdfEngineType;
 }
 
+KeyScheduleCache* &RHX::KeyCache()
+{
+	return m_keyCache;
+}
+
 const std::vector<SymmetricKeySize> &RHX::LegalKeySizes() 
 { 
 	return m_legalKeySizes;
@@ -91,9 +102,11 @@ RHX::RHX(Digests KdfEngineType, size_t Rounds)
 	m_isDestroyed(false),
 	m_isEncryption(false),
 	m_isInitialized(false),
+	m_keyCache(0),
 	m_legalKeySizes(0),
 	m_legalRounds(0),
-	m_rndCount(Rounds)
+	m_rndCount(Rounds),
+	m_sliceKey(0)
 {
 	if (m_kdfEngine != 0 && Rounds < MIN_ROUNDS || Rounds > MAX_ROUNDS || Rounds % 2 > 0)
 		throw CryptoSymmetricCipherException("RHX:CTor", "Invalid rounds size! Sizes supported are even numbers between 10 and 38.");
@@ -114,9 +127,11 @@ RHX::RHX(IDigest *KdfEngine, size_t Rounds)
 	m_isDestroyed(false),
 	m_isEncryption(false),
 	m_isInitialized(false),
+	m_keyCache(0),
 	m_legalKeySizes(0),
 	m_legalRounds(0),
-	m_rndCount(Rounds)
+	m_rndCount(Rounds),
+	m_sliceKey(0)
 {
 	if (m_kdfEngine != 0 && Rounds < MIN_ROUNDS || Rounds > MAX_ROUNDS || Rounds % 2 > 0)
 		throw CryptoSymmetricCipherException("RHX:CTor", "Invalid rounds size! Sizes supported are even numbers between 10 and 38.");
@@ -131,6 +146,25 @@ RHX::~RHX()
 
 //~~~Public Functions~~~//
 
+RHX* RHX::Clone()
+{
+	if (!m_isInitialized)
+		throw CryptoSymmetricCipherException("RHX:Clone", "The cipher has not been initialized!");
+
+	// the copy owns a digest of the same type, and takes the expanded schedule as is
+	RHX* cpr = new RHX(m_kdfEngineType, m_rndCount);
+	cpr->m_cprKeySize = m_cprKeySize;
+	cpr->m_expKey = m_expKey;
+	cpr->m_kdfInfo = m_kdfInfo;
+	cpr->m_isEncryption = m_isEncryption;
+	cpr->m_keyCache = m_keyCache;
+	cpr->m_rndCount = m_rndCount;
+	cpr->m_sliceKey = m_sliceKey;
+	cpr->m_isInitialized = true;
+
+	return cpr;
+}
+
 void RHX::DecryptBlock(const std::vector<byte> &Input, std::vector<byte> &Output)
 {
 	Decrypt128(Input, 0, Output, 0);
@@ -158,6 +192,7 @@ void RHX::Destroy()
 		Utility::IntUtils::ClearVector(m_kdfInfo);
 		Utility::IntUtils::ClearVector(m_legalKeySizes);
 		Utility::IntUtils::ClearVector(m_legalRounds);
+		Utility::IntUtils::ClearVector(m_sliceKey);
 
 		if (m_kdfEngine != 0 && m_destroyEngine)
 			delete m_kdfEngine;
@@ -191,7 +226,8 @@ void RHX::Initialize(bool Encryption, ISymmetricKey &KeyParams)
 	// expand the key
 	ExpandKey(Encryption, KeyParams.Key());
 
-#if defined(CEX_PREFETCH_RHX_TABLES)
+#if defined(CEX_PREFETCH_RHX_TABLES) && !defined(__AVX__)
+	// the SIMD transforms are table-free
 	Prefetch();
 #endif
 
@@ -199,6 +235,22 @@ void RHX::Initialize(bool Encryption, ISymmetricKey &KeyParams)
 	m_isInitialized = true;
 }
 
+void RHX::Rekey(ISymmetricKey &KeyParams)
+{
+	if (!m_isInitialized)
+		throw CryptoSymmetricCipherException("RHX:Rekey", "The cipher has not been initialized!");
+	if (KeyParams.Key().size() * 8 != m_cprKeySize)
+		throw CryptoSymmetricCipherException("RHX:Rekey", "Invalid key size! The new key must be the same length as the current key.");
+	if (m_kdfEngineType != Enumeration::Digests::None && KeyParams.Info().size() > m_kdfInfoMax)
+		throw CryptoSymmetricCipherException("RHX:Rekey", "Invalid info size! Info parameter must be no longer than DistributionCodeMax size.");
+
+	if (KeyParams.Info().size() > 0)
+		m_kdfInfo = KeyParams.Info();
+
+	// the schedule is the same size, so the working key is overwritten in place
+	ExpandKey(m_isEncryption, KeyParams.Key());
+}
+
 void RHX::Transform(const std::vector<byte> &Input, std::vector<byte> &Output)
 {
 	if (m_isEncryption)
@@ -241,6 +293,33 @@ void RHX::Transform2048(const std::vector<byte> &Input, const size_t InOffset, s
 
 //~~~Key Schedule~~~//
 
+void RHX::BitsliceKey(bool Encryption)
+{
+	const size_t RNDCNT = m_expKey.size() / 4;
+
+	m_sliceKey.resize(RNDCNT * BITSLICE_KEY);
+
+	for (size_t i = 0; i < RNDCNT; ++i)
+	{
+		// the S-Box affine constant is folded into the round keys adjacent to a substitution
+		const byte AFFCNS = (Encryption ? (i != 0) : (i != RNDCNT - 1)) ? 0x63 : 0x00;
+		const size_t KEYOFF = i * BITSLICE_KEY;
+
+		for (size_t j = 0; j < BLOCK_SIZE; ++j)
+		{
+			const byte KEYBYT = static_cast<byte>(m_expKey[(i * 4) + (j / 4)] >> (24 - (8 * (j % 4)))) ^ AFFCNS;
+
+			// bit k of the key byte expands to a 0x00 or 0xFF byte in plane k, duplicated across both 128bit lanes
+			for (size_t k = 0; k < 8; ++k)
+			{
+				const byte PLNBYT = static_cast<byte>(0 - ((KEYBYT >> k) & 1));
+				m_sliceKey[KEYOFF + (k * 32) + j] = PLNBYT;
+				m_sliceKey[KEYOFF + (k * 32) + BLOCK_SIZE + j] = PLNBYT;
+			}
+		}
+	}
+}
+
 void RHX::ExpandKey(bool Encryption, const std::vector<byte> &Key)
 {
 	if (m_kdfEngineType != Digests::None)
@@ -278,6 +357,11 @@ void RHX::ExpandKey(bool Encryption, const std::vector<byte> &Key)
 				IT3[SBox[(byte)m_expKey[i]]];
 		}
 	}
+
+#if defined(__AVX__)
+	// bit-plane round keys for the wide transforms
+	BitsliceKey(Encryption);
+#endif
 }
 
 void RHX::SecureExpand(const std::vector<byte> &Key)
@@ -288,32 +372,41 @@ void RHX::SecureExpand(const std::vector<byte> &Key)
 	size_t keySize = (blkWords * (m_rndCount + 1));
 	size_t keyBytes = keySize * 4;
 
-	Kdf::HKDF gen(m_kdfEngine);
+	std::vector<byte> rawKey(keyBytes, 0);
 
-	// change 1.2: use extract only on an oversized key
-	if (Key.size() > m_kdfEngine->BlockSize())
+	// copy a cached schedule, or run the HKDF expansion and add the schedule to the cache
+	if (m_keyCache == 0 || !m_keyCache->Find(Enumeral(), m_kdfEngineType, m_rndCount, Key, m_kdfInfo, rawKey))
 	{
-		// seperate salt and key
-		m_kdfKeySize = m_kdfEngine->BlockSize();
-		std::vector<byte> kdfKey(m_kdfKeySize, 0);
-		Utility::MemUtils::Copy(Key, 0, kdfKey, 0, m_kdfKeySize);
-		size_t saltSize = Key.size() - m_kdfKeySize;
-		std::vector<byte> kdfSalt(saltSize, 0);
-		Utility::MemUtils::Copy(Key, m_kdfKeySize, kdfSalt, 0, saltSize);
-		// info can be null
-		gen.Initialize(kdfKey, kdfSalt, m_kdfInfo);
-	}
-	else
-	{
-		if (m_kdfInfo.size() != 0)
-			gen.Info() = m_kdfInfo;
+		Kdf::HKDF gen(m_kdfEngine);
 
-		gen.Initialize(Key);
+		// change 1.2: use extract only on an oversized key
+		if (Key.size() > m_kdfEngine->BlockSize())
+		{
+			// seperate salt and key
+			m_kdfKeySize = m_kdfEngine->BlockSize();
+			std::vector<byte> kdfKey(m_kdfKeySize, 0);
+			Utility::MemUtils::Copy(Key, 0, kdfKey, 0, m_kdfKeySize);
+			size_t saltSize = Key.size() - m_kdfKeySize;
+			std::vector<byte> kdfSalt(saltSize, 0);
+			Utility::MemUtils::Copy(Key, m_kdfKeySize, kdfSalt, 0, saltSize);
+			// info can be null
+			gen.Initialize(kdfKey, kdfSalt, m_kdfInfo);
+		}
+		else
+		{
+			if (m_kdfInfo.size() != 0)
+				gen.Info() = m_kdfInfo;
+
+			gen.Initialize(Key);
+		}
+
+		// expand the round keys
+		gen.Generate(rawKey);
+
+		if (m_keyCache != 0)
+			m_keyCache->Add(Enumeral(), m_kdfEngineType, m_rndCount, Key, m_kdfInfo, rawKey);
 	}
 
-	std::vector<byte> rawKey(keyBytes, 0);
-	// expand the round keys
-	gen.Generate(rawKey);
 	// initialize working key
 	m_expKey.resize(keySize, 0);
 
@@ -483,6 +576,9 @@ void RHX::ExpandSubBlock(std::vector<uint> &Key, size_t KeyIndex, size_t KeyOffs
 
 void RHX::Decrypt128(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
 {
+#if defined(__AVX__)
+	RHXDecryptV(Input, InOffset, Output, OutOffset, m_expKey);
+#else
 	const size_t LRD = m_expKey.size() - 5;
 	size_t keyCtr = 0;
 
@@ -532,6 +628,7 @@ void RHX::Decrypt128(const std::vector<byte> &Input, const size_t InOffset, std:
 	Output[OutOffset + 13] = (byte)(ISBox[(byte)(Y2 >> 16)] ^ (byte)(m_expKey[keyCtr] >> 16));
 	Output[OutOffset + 14] = (byte)(ISBox[(byte)(Y1 >> 8)] ^ (byte)(m_expKey[keyCtr] >> 8));
 	Output[OutOffset + 15] = (byte)(ISBox[(byte)Y0] ^ (byte)m_expKey[keyCtr]);
+#endif
 }
 
 void RHX::Decrypt512(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
@@ -544,18 +641,32 @@ void RHX::Decrypt512(const std::vector<byte> &Input, const size_t InOffset, std:
 
 void RHX::Decrypt1024(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
 {
+#if defined(__AVX__)
+	RHXDecryptW<Numeric::UInt128>(Input, InOffset, Output, OutOffset, m_sliceKey);
+#else
 	Decrypt512(Input, InOffset, Output, OutOffset);
 	Decrypt512(Input, InOffset + 64, Output, OutOffset + 64);
+#endif
 }
 
 void RHX::Decrypt2048(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
 {
+#if defined(__AVX2__)
+	RHXDecryptW<Numeric::UInt256>(Input, InOffset, Output, OutOffset, m_sliceKey);
+#elif defined(__AVX__)
+	RHXDecryptW<Numeric::UInt128>(Input, InOffset, Output, OutOffset, m_sliceKey);
+	RHXDecryptW<Numeric::UInt128>(Input, InOffset + 128, Output, OutOffset + 128, m_sliceKey);
+#else
 	Decrypt1024(Input, InOffset, Output, OutOffset);
 	Decrypt1024(Input, InOffset + 128, Output, OutOffset + 128);
+#endif
 }
 
 void RHX::Encrypt128(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
 {
+#if defined(__AVX__)
+	RHXEncryptV(Input, InOffset, Output, OutOffset, m_expKey);
+#else
 	const size_t LRD = m_expKey.size() - 5;
 	size_t keyCtr = 0;
 
@@ -603,6 +714,7 @@ void RHX::Encrypt128(const std::vector<byte> &Input, const size_t InOffset, std:
 	Output[OutOffset + 13] = (byte)(SBox[(byte)(Y0 >> 16)] ^ (byte)(m_expKey[keyCtr] >> 16));
 	Output[OutOffset + 14] = (byte)(SBox[(byte)(Y1 >> 8)] ^ (byte)(m_expKey[keyCtr] >> 8));
 	Output[OutOffset + 15] = (byte)(SBox[(byte)Y2] ^ (byte)m_expKey[keyCtr]);
+#endif
 }
 
 void RHX::Encrypt512(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
@@ -615,14 +727,25 @@ void RHX::Encrypt512(const std::vector<byte> &Input, const size_t InOffset, std:
 
 void RHX::Encrypt1024(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
 {
+#if defined(__AVX__)
+	RHXEncryptW<Numeric::UInt128>(Input, InOffset, Output, OutOffset, m_sliceKey);
+#else
 	Encrypt512(Input, InOffset, Output, OutOffset);
 	Encrypt512(Input, InOffset + 64, Output, OutOffset + 64);
+#endif
 }
 
 void RHX::Encrypt2048(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
 {
+#if defined(__AVX2__)
+	RHXEncryptW<Numeric::UInt256>(Input, InOffset, Output, OutOffset, m_sliceKey);
+#elif defined(__AVX__)
+	RHXEncryptW<Numeric::UInt128>(Input, InOffset, Output, OutOffset, m_sliceKey);
+	RHXEncryptW<Numeric::UInt128>(Input, InOffset + 128, Output, OutOffset + 128, m_sliceKey);
+#else
 	Encrypt1024(Input, InOffset, Output, OutOffset);
 	Encrypt1024(Input, InOffset + 128, Output, OutOffset + 128);
+#endif
 }
 
 //~~~Private Functions~~~//
@@ -665,13 +788,6 @@ void RHX::Prefetch()
 	// timing defence: pre-load tables into cache
 	if (m_isEncryption)
 	{
-#if defined(__AVX__)
-		PREFETCHT0(SBox[0], 256 * sizeof(byte));
-		PREFETCHT0(&T0[0], 256 * sizeof(uint));
-		PREFETCHT0(&T1[0], 256 * sizeof(uint));
-		PREFETCHT0(&T2[0], 256 * sizeof(uint));
-		PREFETCHT0(&T3[0], 256 * sizeof(uint));
-#else
 		volatile uint dummy;
 		for (size_t i = 0; i < 256; ++i)
 			dummy ^= SBox[i];
@@ -683,17 +799,9 @@ void RHX::Prefetch()
 			dummy ^= T2[i];
 		for (size_t i = 0; i < 256; ++i)
 			dummy ^= T3[i];
-#endif
 	}
 	else
 	{
-#if defined(__AVX__)
-		PREFETCHT0(&ISBox[0], 256 * sizeof(byte));
-		PREFETCHT0(&IT0[0], 256 * sizeof(uint));
-		PREFETCHT0(&IT1[0], 256 * sizeof(uint));
-		PREFETCHT0(&IT2[0], 256 * sizeof(uint));
-		PREFETCHT0(&IT3[0], 256 * sizeof(uint));
-#else
 		volatile uint dummy;
 		for (size_t i = 0; i < 256; ++i)
 			dummy ^= SBox[i];
@@ -705,7 +813,6 @@ void RHX::Prefetch()
 			dummy ^= IT2[i];
 		for (size_t i = 0; i < 256; ++i)
 			dummy ^= IT3[i];
-#endif
 	}
 }
 CEX_OPTIMIZE_RESUME
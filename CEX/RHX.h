@@ -35,6 +35,7 @@
 #define CEX_RHX_H
 
 #include "IBlockCipher.h"
+#include "KeyScheduleCache.h"
 
 NAMESPACE_BLOCK
 
@@ -94,6 +95,7 @@ NAMESPACE_BLOCK
 /// <item><description>The internal block size is 16 bytes wide.</description></item>
 /// <item><description>Diffusion rounds assignments are 10 to 38, the default is 22 (128-256 bit key), a 512 bit key is automatically assigned 22 rounds.</description></item>
 /// <item><description>Valid rounds assignments can be found in the <see cref="LegalRounds"/> property.</description></item>
+/// <item><description>When compiled with AVX, the lookup tables are replaced by constant-time SIMD transforms; single blocks use an SSSE3 vector-permute S-Box, the Transform1024 and Transform2048 functions process 8 or 16 blocks with a bitsliced cipher using the UInt128 or UInt256 (AVX2) types.</description></item>
 /// </list>
 /// 
 /// <description>Guiding Publications:</description>
@@ -135,9 +137,11 @@ private:
 	Digests m_kdfEngineType;
 	size_t m_kdfInfoMax;
 	size_t m_kdfKeySize;
+	KeyScheduleCache* m_keyCache;
 	std::vector<SymmetricKeySize> m_legalKeySizes;
 	std::vector<size_t> m_legalRounds;
 	size_t m_rndCount;
+	std::vector<byte> m_sliceKey;
 
 public:
 
@@ -191,6 +195,13 @@ public:
 	/// </summary>
 	const Digests KdfEngine() override;
 
+	/// <summary>
+	/// Get/Set: An optional cache of HKDF expanded key schedules, shared between cipher instances.
+	/// <para>When set, and the cipher uses a KdfEngine, the key expansion copies a cached schedule instead of running HKDF.
+	/// The cache is not owned by the cipher, and must outlive it.</para>
+	/// </summary>
+	KeyScheduleCache* &KeyCache();
+
 	/// <summary>
 	/// Get: Available Encryption Key Sizes in bytes
 	/// </summary>
@@ -254,6 +265,18 @@ public:
 
 	//~~~Public Functions~~~//
 
+	/// <summary>
+	/// Create an initialized copy of this cipher.
+	/// <para>The expanded key schedule, direction, rounds and distribution code are copied, so the copy does not run the key expansion or HKDF again.
+	/// A KdfEngine instance passed to the constructor is not shared; the copy creates its own digest of the same type.
+	/// The KeyCache() pointer is copied. The caller is responsible for destroying the returned cipher.</para>
+	/// </summary>
+	///
+	/// <returns>A new, initialized RHX instance</returns>
+	///
+	/// <exception cref="Exception::CryptoSymmetricCipherException">Thrown if the cipher has not been initialized</exception>
+	RHX* Clone() override;
+
 	/// <summary>
 	/// Decrypt a single block of bytes.
 	/// <para><see cref="Initialize(bool, ISymmetricKey)"/> must be called with the Encryption flag set to <c>false</c> before this method can be used.
@@ -313,6 +336,17 @@ public:
 	/// <exception cref="CryptoSymmetricCipherException">Thrown if a null or invalid key is used</exception>
 	void Initialize(bool Encryption, ISymmetricKey &KeyParams) override;
 
+	/// <summary>
+	/// Replace the cipher key, retaining the direction and the allocated cipher state.
+	/// <para>The cipher must be initialized, and the new key must be the same length as the current key.
+	/// With a KeyCache() assigned, rekeying to a previously used key and info skips the HKDF expansion.</para>
+	/// </summary>
+	///
+	/// <param name="KeyParams">Cipher key container; the key must be the same size as the current key</param>
+	///
+	/// <exception cref="Exception::CryptoSymmetricCipherException">Thrown if the cipher is not initialized, or the key or info size is invalid</exception>
+	void Rekey(ISymmetricKey &KeyParams);
+
 	/// <summary>
 	/// Transform a block of bytes.
 	/// <para><see cref="Initialize(bool, ISymmetricKey)"/> must be called before this method can be used.
@@ -373,6 +407,7 @@ public:
 
 private:
 
+	void BitsliceKey(bool Encryption);
 	void Decrypt128(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset);
 	void Decrypt512(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset);
 	void Decrypt1024(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset);
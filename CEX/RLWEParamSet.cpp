@@ -70,7 +70,7 @@ void RLWEParamSet::Load(uint Coefficients, int Modulus, uint SeedByteSize, uint
 	N = Coefficients;
 	Q = Modulus;
 	ForwardMessageSize = ForwardByteSize;
-	ParamName = ParamName;
+	ParamName = ParamSet;
 	ReturnMessageSize = ReturnByteSize;
 	SeedSize = SeedByteSize;
 }
@@ -18,10 +18,19 @@ enum class RLWEParams : byte
 	/// A modulus of 12289 with 1024 coefficients
 	/// </summary>
 	Q12289N1024 = 1,
-	/*/// <summary>
-	/// A modulus of ????? with ???? coefficients
+	/// <summary>
+	/// A modulus of 40961 with 1024 coefficients; the secret is encrypted, with 16 bit coefficients and a 3 bit compressed cipher-text
+	/// </summary>
+	Q40961N1024 = 2,
+#if defined(CEX_RLWE_TESTSETS)
+	/// <summary>
+	/// A modulus of 7681 with 256 coefficients; the smallest keys and cipher-texts, and the fastest transform.
+	/// <para>LOW SECURITY: a single ring of 256 coefficients with a k = 16 binomial noise has an estimated core-SVP hardness well under 100 bits,
+	/// far below the 128 bit level of the 1024 coefficient sets, and a decryption failure rate of about 2^-46.
+	/// This set is for testing only, and is available only when CEX_RLWE_TESTSETS is defined in CexConfig.h.</para>
 	/// </summary>
-	Q?????N???? = 2*/
+	Q7681N256 = 3
+#endif
 };
 
 NAMESPACE_ENUMERATIONEND
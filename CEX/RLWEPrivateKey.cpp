@@ -1,4 +1,5 @@
 #include "RLWEPrivateKey.h"
+#include "AsymmetricKeyImage.h"
 #include "IntUtils.h"
 
 NAMESPACE_ASYMMETRICKEY
@@ -44,6 +45,21 @@ RLWEPrivateKey::RLWEPrivateKey(const std::vector<byte> &KeyStream)
 		m_rCoeffs[i] = Utility::IntUtils::LeBytesTo16(KeyStream, 5 + (i * sizeof(ushort)));
 }
 
+RLWEPrivateKey::RLWEPrivateKey(const IO::ByteView &Image)
+	:
+	m_isDestroyed(false),
+	m_rlweParameters(RLWEParams::None),
+	m_rCoeffs(0)
+{
+	byte params;
+	IO::ByteView key = AsymmetricKeyImage::Open(Image, AsymmetricEngines::RingLWE, AsymmetricKeyImage::KeyClass::PrivateKey, params);
+	m_rlweParameters = static_cast<RLWEParams>(params);
+	m_rCoeffs.resize(key.size() / sizeof(ushort));
+
+	for (size_t i = 0; i < m_rCoeffs.size(); ++i)
+		m_rCoeffs[i] = Utility::IntUtils::LeBytesTo16(key, i * sizeof(ushort));
+}
+
 RLWEPrivateKey::~RLWEPrivateKey()
 {
 	Destroy();
@@ -76,4 +92,17 @@ std::vector<byte> RLWEPrivateKey::ToBytes()
 	return r;
 }
 
+std::vector<byte> RLWEPrivateKey::ToImage()
+{
+	std::vector<byte> r(m_rCoeffs.size() * sizeof(ushort));
+
+	for (size_t i = 0; i < m_rCoeffs.size(); ++i)
+		Utility::IntUtils::Le16ToBytes(m_rCoeffs[i], r, i * sizeof(ushort));
+
+	std::vector<byte> image = AsymmetricKeyImage::Create(AsymmetricEngines::RingLWE, static_cast<byte>(m_rlweParameters), AsymmetricKeyImage::KeyClass::PrivateKey, r);
+	Utility::IntUtils::ClearVector(r);
+
+	return image;
+}
+
 NAMESPACE_ASYMMETRICKEYEND
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define CEX_RLWEPRIVATEKEY_H
 
 #include "CexDomain.h"
+#include "ByteView.h"
 #include "IAsymmetricKey.h"
 #include "RLWEParams.h"
 
@@ -61,6 +62,16 @@ public:
 	/// <param name="KeyStream">The serialized private key</param>
 	explicit RLWEPrivateKey(const std::vector<byte> &KeyStream);
 
+	/// <summary>
+	/// Initialize this class with a key image
+	/// <para>The RingLWE key is small and is decoded into the key container, so the image need not outlive this key.</para>
+	/// </summary>
+	/// 
+	/// <param name="Image">The key image created by ToImage()</param>
+	///
+	/// <exception cref="Exception::CryptoAsymmetricException">Thrown if the image does not contain a RingLWE private key</exception>
+	explicit RLWEPrivateKey(const IO::ByteView &Image);
+
 	/// <summary>
 	/// Finalize objects
 	/// </summary>
@@ -77,6 +88,11 @@ public:
 	/// Serialize a private key to a byte array
 	/// </summary>
 	std::vector<byte> ToBytes() override;
+
+	/// <summary>
+	/// Serialize the private key to an aligned key image, in the same format as the McEliece key images
+	/// </summary>
+	std::vector<byte> ToImage();
 };
 
 NAMESPACE_ASYMMETRICKEYEND
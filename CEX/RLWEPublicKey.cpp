@@ -1,10 +1,16 @@
 #include "RLWEPublicKey.h"
+#include "AsymmetricKeyImage.h"
 #include "IntUtils.h"
 
 NAMESPACE_ASYMMETRICKEY
 
 //~~~Properties~~~//
 
+std::vector<ushort> &RLWEPublicKey::A()
+{
+	return m_aCoeffs;
+}
+
 const AsymmetricEngines RLWEPublicKey::CipherType()
 {
 	return Enumeration::AsymmetricEngines::RingLWE;
@@ -24,6 +30,7 @@ const std::vector<byte> &RLWEPublicKey::P()
 
 RLWEPublicKey::RLWEPublicKey(RLWEParams Parameters, std::vector<byte> &P)
 	:
+	m_aCoeffs(0),
 	m_isDestroyed(false),
 	m_rlweParameters(Parameters),
 	m_pCoeffs(P)
@@ -32,6 +39,7 @@ RLWEPublicKey::RLWEPublicKey(RLWEParams Parameters, std::vector<byte> &P)
 
 RLWEPublicKey::RLWEPublicKey(const std::vector<byte> &KeyStream)
 	:
+	m_aCoeffs(0),
 	m_isDestroyed(false),
 	m_rlweParameters(RLWEParams::None),
 	m_pCoeffs(0)
@@ -42,6 +50,19 @@ RLWEPublicKey::RLWEPublicKey(const std::vector<byte> &KeyStream)
 	Utility::MemUtils::Copy(KeyStream, 5, m_pCoeffs, 0, pLen);
 }
 
+RLWEPublicKey::RLWEPublicKey(const IO::ByteView &Image)
+	:
+	m_aCoeffs(0),
+	m_isDestroyed(false),
+	m_rlweParameters(RLWEParams::None),
+	m_pCoeffs(0)
+{
+	byte params;
+	IO::ByteView key = AsymmetricKeyImage::Open(Image, AsymmetricEngines::RingLWE, AsymmetricKeyImage::KeyClass::PublicKey, params);
+	m_rlweParameters = static_cast<RLWEParams>(params);
+	m_pCoeffs = key.ToVector();
+}
+
 RLWEPublicKey::~RLWEPublicKey()
 {
 	Destroy();
@@ -58,6 +79,8 @@ void RLWEPublicKey::Destroy()
 
 		if (m_pCoeffs.size() > 0)
 			Utility::IntUtils::ClearVector(m_pCoeffs);
+		if (m_aCoeffs.size() > 0)
+			Utility::IntUtils::ClearVector(m_aCoeffs);
 	}
 }
 
@@ -72,4 +95,9 @@ std::vector<byte> RLWEPublicKey::ToBytes()
 	return p;
 }
 
+std::vector<byte> RLWEPublicKey::ToImage()
+{
+	return AsymmetricKeyImage::Create(AsymmetricEngines::RingLWE, static_cast<byte>(m_rlweParameters), AsymmetricKeyImage::KeyClass::PublicKey, m_pCoeffs);
+}
+
 NAMESPACE_ASYMMETRICKEYEND
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define CEX_RLWEPUUBLICKEY_H
 
 #include "CexDomain.h"
+#include "ByteView.h"
 #include "IAsymmetricKey.h"
 #include "RLWEParams.h"
 
@@ -16,6 +17,7 @@ class RLWEPublicKey final : public IAsymmetricKey
 {
 private:
 
+	std::vector<ushort> m_aCoeffs;
 	bool m_isDestroyed;
 	std::vector<byte> m_pCoeffs;
 	RLWEParams m_rlweParameters;
@@ -29,6 +31,14 @@ public:
 
 	//~~~Properties~~~//
 
+	/// <summary>
+	/// Get/Set: The public polynomial a, expanded from the seed in P and in the NTT domain.
+	/// <para>The expansion is cached with the key so repeated encryptions to the same key do not repeat it.
+	/// It is empty until the key is generated or used to initialize RingLWE for encryption, and is not serialized.
+	/// Initialize a cipher instance with the key before it is shared between threads.</para>
+	/// </summary>
+	std::vector<ushort> &A();
+
 	/// <summary>
 	/// Get: The public keys cipher type name
 	/// </summary>
@@ -61,6 +71,16 @@ public:
 	/// <param name="KeyStream">The serialized public key</param>
 	explicit RLWEPublicKey(const std::vector<byte> &KeyStream);
 
+	/// <summary>
+	/// Initialize this class with a key image
+	/// <para>The RingLWE key is small and is decoded into the key container, so the image need not outlive this key.</para>
+	/// </summary>
+	/// 
+	/// <param name="Image">The key image created by ToImage()</param>
+	///
+	/// <exception cref="Exception::CryptoAsymmetricException">Thrown if the image does not contain a RingLWE public key</exception>
+	explicit RLWEPublicKey(const IO::ByteView &Image);
+
 	/// <summary>
 	/// Finalize objects
 	/// </summary>
@@ -77,6 +97,11 @@ public:
 	/// Serialize a public key to a byte array
 	/// </summary>
 	std::vector<byte> ToBytes() override;
+
+	/// <summary>
+	/// Serialize the public key to an aligned key image, in the same format as the McEliece key images
+	/// </summary>
+	std::vector<byte> ToImage();
 };
 
 NAMESPACE_ASYMMETRICKEYEND
@@ -20,6 +20,9 @@
 #define CEX_RIJNDAEL_H
 
 #include "CexDomain.h"
+#if defined(__AVX__)
+#	include "Intrinsics.h"
+#endif
 
 NAMESPACE_BLOCK
 
@@ -365,6 +368,568 @@ static const uint IT3[] =
 	0xA8017139, 0x0CB3DE08, 0xB4E49CD8, 0x56C19064, 0xCB84617B, 0x32B670D5, 0x6C5C7448, 0xB85742D0,
 };
 
-NAMESPACE_BLOCKEND
+//~~~Constant-Time SIMD Rijndael~~~//
+
+// The SIMD paths replace the lookup tables with constant-time arithmetic in the tower field GF((2^4)^2);
+// the AES field element is mapped with a linear isomorphism to a pair of GF(16) elements (a1, a0), with y^2 + y + 8 as the field polynomial,
+// and the inverse is computed as (a1 * d^-1, (a0 + a1) * d^-1), where d = 8 * a1^2 + a1 * a0 + a0^2.
+
+// the bitsliced round key size; 8 bit-planes of 16 bytes, duplicated to fill a 256bit register
+static const size_t BITSLICE_KEY = 256;
+
+#if defined(__AVX__)
+
+static const byte ShiftRowsMask[] =
+{
+	0x00, 0x05, 0x0A, 0x0F, 0x04, 0x09, 0x0E, 0x03, 0x08, 0x0D, 0x02, 0x07, 0x0C, 0x01, 0x06, 0x0B,
+	0x00, 0x05, 0x0A, 0x0F, 0x04, 0x09, 0x0E, 0x03, 0x08, 0x0D, 0x02, 0x07, 0x0C, 0x01, 0x06, 0x0B
+};
+
+static const byte InvShiftRowsMask[] =
+{
+	0x00, 0x0D, 0x0A, 0x07, 0x04, 0x01, 0x0E, 0x0B, 0x08, 0x05, 0x02, 0x0F, 0x0C, 0x09, 0x06, 0x03,
+	0x00, 0x0D, 0x0A, 0x07, 0x04, 0x01, 0x0E, 0x0B, 0x08, 0x05, 0x02, 0x0F, 0x0C, 0x09, 0x06, 0x03
+};
+
+static const byte RotateOneMask[] =
+{
+	0x01, 0x02, 0x03, 0x00, 0x05, 0x06, 0x07, 0x04, 0x09, 0x0A, 0x0B, 0x08, 0x0D, 0x0E, 0x0F, 0x0C,
+	0x01, 0x02, 0x03, 0x00, 0x05, 0x06, 0x07, 0x04, 0x09, 0x0A, 0x0B, 0x08, 0x0D, 0x0E, 0x0F, 0x0C
+};
+
+static const byte RotateTwoMask[] =
+{
+	0x02, 0x03, 0x00, 0x01, 0x06, 0x07, 0x04, 0x05, 0x0A, 0x0B, 0x08, 0x09, 0x0E, 0x0F, 0x0C, 0x0D,
+	0x02, 0x03, 0x00, 0x01, 0x06, 0x07, 0x04, 0x05, 0x0A, 0x0B, 0x08, 0x09, 0x0E, 0x0F, 0x0C, 0x0D
+};
+
+//~~~Vector Permute (single block)~~~//
+
+// multiply two GF(16) nibble vectors with log/exp lookups; a zero operand has the log 0xC0, which zeroes the exp lookup
+inline __m128i VpermExp(const __m128i &LogA, const __m128i &LogB)
+{
+	const __m128i EXP = _mm_setr_epi8(0x01, 0x02, 0x04, 0x08, 0x03, 0x06, 0x0C, 0x0B, 0x05, 0x0A, 0x07, 0x0E, 0x0F, 0x0D, 0x09, 0x01);
+	const __m128i MOD = _mm_set1_epi8(0x0F);
+	const __m128i MAX = _mm_set1_epi8(0x0E);
+	__m128i sum = _mm_add_epi8(LogA, LogB);
+
+	// reduce the exponent mod 15
+	sum = _mm_sub_epi8(sum, _mm_and_si128(_mm_cmpgt_epi8(sum, MAX), MOD));
+
+	return _mm_shuffle_epi8(EXP, sum);
+}
+
+// invert the tower field element (A1, A0), held as low nibbles of two registers
+inline void VpermInvert(const __m128i &A0, const __m128i &A1, __m128i &O0, __m128i &O1)
+{
+	const __m128i LOG = _mm_setr_epi8((char)0xC0, 0x00, 0x01, 0x04, 0x02, 0x08, 0x05, 0x0A, 0x03, 0x0E, 0x09, 0x07, 0x06, 0x0D, 0x0B, 0x0C);
+	const __m128i NLOG = _mm_setr_epi8((char)0xC0, 0x00, 0x0E, 0x0B, 0x0D, 0x07, 0x0A, 0x05, 0x0C, 0x01, 0x06, 0x08, 0x09, 0x02, 0x04, 0x03);
+	const __m128i SQR = _mm_setr_epi8(0x00, 0x01, 0x04, 0x05, 0x03, 0x02, 0x07, 0x06, 0x0C, 0x0D, 0x08, 0x09, 0x0F, 0x0E, 0x0B, 0x0A);
+	const __m128i LSQR = _mm_setr_epi8(0x00, 0x08, 0x06, 0x0E, 0x0B, 0x03, 0x0D, 0x05, 0x0A, 0x02, 0x0C, 0x04, 0x01, 0x09, 0x07, 0x0F);
+
+	__m128i la1 = _mm_shuffle_epi8(LOG, A1);
+	// d = 8 * a1^2 + a1 * a0 + a0^2
+	__m128i d = _mm_xor_si128(_mm_xor_si128(_mm_shuffle_epi8(LSQR, A1), _mm_shuffle_epi8(SQR, A0)), VpermExp(la1, _mm_shuffle_epi8(LOG, A0)));
+	// log of d^-1
+	__m128i ld = _mm_shuffle_epi8(NLOG, d);
+
+	O1 = VpermExp(la1, ld);
+	O0 = VpermExp(_mm_shuffle_epi8(LOG, _mm_xor_si128(A0, A1)), ld);
+}
+
+inline __m128i VpermSubBytes(const __m128i &State)
+{
+	const __m128i LMASK = _mm_set1_epi8(0x0F);
+	const __m128i IA0L = _mm_setr_epi8(0x00, 0x01, 0x00, 0x01, 0x06, 0x07, 0x06, 0x07, 0x0C, 0x0D, 0x0C, 0x0D, 0x0A, 0x0B, 0x0A, 0x0B);
+	const __m128i IA0H = _mm_setr_epi8(0x00, 0x0C, 0x05, 0x09, 0x04, 0x08, 0x01, 0x0D, 0x05, 0x09, 0x00, 0x0C, 0x01, 0x0D, 0x04, 0x08);
+	const __m128i IA1L = _mm_setr_epi8(0x00, 0x00, 0x02, 0x02, 0x04, 0x04, 0x06, 0x06, 0x04, 0x04, 0x06, 0x06, 0x00, 0x00, 0x02, 0x02);
+	const __m128i IA1H = _mm_setr_epi8(0x00, 0x03, 0x0D, 0x0E, 0x03, 0x00, 0x0E, 0x0D, 0x0E, 0x0D, 0x03, 0x00, 0x0D, 0x0E, 0x00, 0x03);
+	const __m128i OUTL = _mm_setr_epi8(0x63, 0x7C, (char)0xD1, (char)0xCE, (char)0xC8, (char)0xD7, 0x7A, 0x65, 0x55, 0x4A, (char)0xE7, (char)0xF8, (char)0xFE, (char)0xE1, 0x4C, 0x53);
+	const __m128i OUTH = _mm_setr_epi8(0x00, 0x52, 0x3E, 0x6C, 0x65, 0x37, 0x5B, 0x09, 0x60, 0x32, 0x5E, 0x0C, 0x05, 0x57, 0x3B, 0x69);
+
+	__m128i lo = _mm_and_si128(State, LMASK);
+	__m128i hi = _mm_and_si128(_mm_srli_epi16(State, 4), LMASK);
+	__m128i a0 = _mm_xor_si128(_mm_shuffle_epi8(IA0L, lo), _mm_shuffle_epi8(IA0H, hi));
+	__m128i a1 = _mm_xor_si128(_mm_shuffle_epi8(IA1L, lo), _mm_shuffle_epi8(IA1H, hi));
+
+	VpermInvert(a0, a1, lo, hi);
+
+	// map back to the AES field and apply the affine transform; the 0x63 constant is folded into the low table
+	return _mm_xor_si128(_mm_shuffle_epi8(OUTL, lo), _mm_shuffle_epi8(OUTH, hi));
+}
+
+inline __m128i VpermInvSubBytes(const __m128i &State)
+{
+	const __m128i LMASK = _mm_set1_epi8(0x0F);
+	const __m128i IA0L = _mm_setr_epi8(0x07, 0x0F, 0x08, 0x00, 0x0F, 0x07, 0x00, 0x08, 0x0F, 0x07, 0x00, 0x08, 0x07, 0x0F, 0x08, 0x00);
+	const __m128i IA0H = _mm_setr_epi8(0x00, 0x06, 0x09, 0x0F, 0x09, 0x0F, 0x00, 0x06, 0x02, 0x04, 0x0B, 0x0D, 0x0B, 0x0D, 0x02, 0x04);
+	const __m128i IA1L = _mm_setr_epi8(0x04, 0x01, 0x0D, 0x08, 0x0D, 0x08, 0x04, 0x01, 0x06, 0x03, 0x0F, 0x0A, 0x0F, 0x0A, 0x06, 0x03);
+	const __m128i IA1H = _mm_setr_epi8(0x00, 0x07, 0x07, 0x00, 0x0F, 0x08, 0x08, 0x0F, 0x09, 0x0E, 0x0E, 0x09, 0x06, 0x01, 0x01, 0x06);
+	const __m128i OUTL = _mm_setr_epi8(0x00, 0x01, 0x5C, 0x5D, (char)0xE0, (char)0xE1, (char)0xBC, (char)0xBD, 0x50, 0x51, 0x0C, 0x0D, (char)0xB0, (char)0xB1, (char)0xEC, (char)0xED);
+	const __m128i OUTH = _mm_setr_epi8(0x00, (char)0xA2, 0x02, (char)0xA0, (char)0xB8, 0x1A, (char)0xBA, 0x18, (char)0xDB, 0x79, (char)0xD9, 0x7B, 0x63, (char)0xC1, 0x61, (char)0xC3);
+
+	// the inverse affine transform and its 0x05 constant are folded into the input tables
+	__m128i lo = _mm_and_si128(State, LMASK);
+	__m128i hi = _mm_and_si128(_mm_srli_epi16(State, 4), LMASK);
+	__m128i a0 = _mm_xor_si128(_mm_shuffle_epi8(IA0L, lo), _mm_shuffle_epi8(IA0H, hi));
+	__m128i a1 = _mm_xor_si128(_mm_shuffle_epi8(IA1L, lo), _mm_shuffle_epi8(IA1H, hi));
+
+	VpermInvert(a0, a1, lo, hi);
+
+	return _mm_xor_si128(_mm_shuffle_epi8(OUTL, lo), _mm_shuffle_epi8(OUTH, hi));
+}
+
+inline __m128i VpermMixColumns(const __m128i &State)
+{
+	const __m128i RT1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(RotateOneMask));
+	const __m128i RT2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(RotateTwoMask));
+	const __m128i POLY = _mm_set1_epi8(0x1B);
+	__m128i r1 = _mm_shuffle_epi8(State, RT1);
+	__m128i t = _mm_xor_si128(State, r1);
+	// xtime(a ^ rot1(a)) ^ rot1(a) ^ rot2(a ^ rot1(a))
+	__m128i x = _mm_xor_si128(_mm_add_epi8(t, t), _mm_and_si128(_mm_cmplt_epi8(t, _mm_setzero_si128()), POLY));
+
+	return _mm_xor_si128(_mm_xor_si128(x, r1), _mm_shuffle_epi8(t, RT2));
+}
+
+inline __m128i VpermInvMixColumns(const __m128i &State)
+{
+	const __m128i RT2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(RotateTwoMask));
+	const __m128i POLY = _mm_set1_epi8(0x1B);
+	__m128i t = _mm_xor_si128(State, _mm_shuffle_epi8(State, RT2));
+
+	// InvMixColumns(a) = MixColumns(a ^ x^2 * (a ^ rot2(a)))
+	t = _mm_xor_si128(_mm_add_epi8(t, t), _mm_and_si128(_mm_cmplt_epi8(t, _mm_setzero_si128()), POLY));
+	t = _mm_xor_si128(_mm_add_epi8(t, t), _mm_and_si128(_mm_cmplt_epi8(t, _mm_setzero_si128()), POLY));
+
+	return VpermMixColumns(_mm_xor_si128(State, t));
+}
+
+// load a round key from the big endian expanded key
+inline __m128i VpermRoundKey(const std::vector<uint> &Key, size_t Round)
+{
+	const __m128i SWAP = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+
+	return _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&Key[Round * 4])), SWAP);
+}
+
+inline void RHXDecryptV(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset, const std::vector<uint> &Key)
+{
+	const __m128i ISR = _mm_loadu_si128(reinterpret_cast<const __m128i*>(InvShiftRowsMask));
+	const size_t RNDCNT = (Key.size() / 4) - 1;
+	__m128i state = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&Input[InOffset])), VpermRoundKey(Key, 0));
+
+	for (size_t i = 1; i < RNDCNT; ++i)
+	{
+		state = VpermInvSubBytes(_mm_shuffle_epi8(state, ISR));
+		state = _mm_xor_si128(VpermInvMixColumns(state), VpermRoundKey(Key, i));
+	}
+
+	state = VpermInvSubBytes(_mm_shuffle_epi8(state, ISR));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(&Output[OutOffset]), _mm_xor_si128(state, VpermRoundKey(Key, RNDCNT)));
+}
+
+inline void RHXEncryptV(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset, const std::vector<uint> &Key)
+{
+	const __m128i SR = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ShiftRowsMask));
+	const size_t RNDCNT = (Key.size() / 4) - 1;
+	__m128i state = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&Input[InOffset])), VpermRoundKey(Key, 0));
+
+	for (size_t i = 1; i < RNDCNT; ++i)
+	{
+		state = VpermSubBytes(_mm_shuffle_epi8(state, SR));
+		state = _mm_xor_si128(VpermMixColumns(state), VpermRoundKey(Key, i));
+	}
+
+	state = VpermSubBytes(_mm_shuffle_epi8(state, SR));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(&Output[OutOffset]), _mm_xor_si128(state, VpermRoundKey(Key, RNDCNT)));
+}
+
+//~~~Bitsliced (8 blocks per 128bit lane)~~~//
+
+// plane j holds bit j of every state byte; within a byte of a plane, bit b belongs to register b of the input
+
+template<typename T>
+inline void BitsliceSwap(T &A, T &B, const int Shift, const T &Mask)
+{
+	T tmp = ((A >> Shift) ^ B) & Mask;
+	B ^= tmp;
+	A ^= (tmp << Shift);
+}
+
+template<typename T>
+inline void BitsliceTranspose(T* X)
+{
+	// an 8x8 bit matrix transpose at every byte position; the transform is its own inverse
+	const T M1(0x55555555U);
+	const T M2(0x33333333U);
+	const T M4(0x0F0F0F0FU);
+
+	BitsliceSwap(X[0], X[1], 1, M1);
+	BitsliceSwap(X[2], X[3], 1, M1);
+	BitsliceSwap(X[4], X[5], 1, M1);
+	BitsliceSwap(X[6], X[7], 1, M1);
+	BitsliceSwap(X[0], X[2], 2, M2);
+	BitsliceSwap(X[1], X[3], 2, M2);
+	BitsliceSwap(X[4], X[6], 2, M2);
+	BitsliceSwap(X[5], X[7], 2, M2);
+	BitsliceSwap(X[0], X[4], 4, M4);
+	BitsliceSwap(X[1], X[5], 4, M4);
+	BitsliceSwap(X[2], X[6], 4, M4);
+	BitsliceSwap(X[3], X[7], 4, M4);
+}
+
+template<typename T>
+inline void BitsliceAddKey(T* X, const std::vector<byte> &Key, size_t Round)
+{
+	const size_t KEYOFF = Round * BITSLICE_KEY;
+
+	for (size_t i = 0; i < 8; ++i)
+		X[i] ^= T(Key, KEYOFF + (i * 32));
+}
+
+template<typename T>
+inline void BitsliceShuffle(T* X, const T &Mask)
+{
+	for (size_t i = 0; i < 8; ++i)
+		X[i] = T::Shuffle8(X[i], Mask);
+}
+
+// GF(16) multiplication mod z^4 + z + 1
+template<typename T>
+inline void BitsliceMultiply(const T* A, const T* B, T* R)
+{
+	T c4 = (A[1] & B[3]) ^ (A[2] & B[2]) ^ (A[3] & B[1]);
+	T c5 = (A[2] & B[3]) ^ (A[3] & B[2]);
+	T c6 = A[3] & B[3];
+
+	R[0] = (A[0] & B[0]) ^ c4;
+	R[1] = (A[0] & B[1]) ^ (A[1] & B[0]) ^ c4 ^ c5;
+	R[2] = (A[0] & B[2]) ^ (A[1] & B[1]) ^ (A[2] & B[0]) ^ c5 ^ c6;
+	R[3] = (A[0] & B[3]) ^ (A[1] & B[2]) ^ (A[2] & B[1]) ^ (A[3] & B[0]) ^ c6;
+}
+
+// invert the tower field element; T[0..3] is a0 and T[4..7] is a1
+template<typename T>
+inline void BitsliceInvert(T* X)
+{
+	T d[4];
+	T p[4];
+	T s[4];
+
+	// d = 8 * a1^2 + a1 * a0 + a0^2
+	BitsliceMultiply(X + 4, X, p);
+	d[0] = X[6] ^ X[0] ^ X[2] ^ p[0];
+	d[1] = X[5] ^ X[6] ^ X[7] ^ X[2] ^ p[1];
+	d[2] = X[5] ^ X[1] ^ X[3] ^ p[2];
+	d[3] = X[4] ^ X[6] ^ X[7] ^ X[3] ^ p[3];
+
+	// GF(16) inverse of d
+	T d01 = d[0] & d[1];
+	T d02 = d[0] & d[2];
+	T d03 = d[0] & d[3];
+	T d12 = d[1] & d[2];
+	T d13 = d[1] & d[3];
+	T d23 = d[2] & d[3];
+	T d123 = d12 & d[3];
+
+	p[0] = d[0] ^ d[1] ^ d[2] ^ d[3] ^ d02 ^ d12 ^ (d01 & d[2]) ^ d123;
+	p[1] = d[3] ^ d01 ^ d02 ^ d12 ^ d13 ^ (d01 & d[3]);
+	p[2] = d[2] ^ d[3] ^ d01 ^ d02 ^ d03 ^ (d02 & d[3]);
+	p[3] = d[1] ^ d[2] ^ d[3] ^ d03 ^ d13 ^ d23 ^ d123;
+
+	// (a1 * d^-1, (a0 + a1) * d^-1)
+	s[0] = X[0] ^ X[4];
+	s[1] = X[1] ^ X[5];
+	s[2] = X[2] ^ X[6];
+	s[3] = X[3] ^ X[7];
+	BitsliceMultiply(X + 4, p, d);
+	BitsliceMultiply(s, p, X);
+	X[4] = d[0];
+	X[5] = d[1];
+	X[6] = d[2];
+	X[7] = d[3];
+}
+
+// the S-Box without the 0x63 constant, which is folded into the round keys
+template<typename T>
+inline void BitsliceSubBytes(T* X)
+{
+	T t[8];
+
+	t[0] = X[0] ^ X[5] ^ X[7];
+	t[1] = X[2];
+	t[2] = X[2] ^ X[3] ^ X[4] ^ X[5] ^ X[6] ^ X[7];
+	t[3] = X[3] ^ X[4];
+	t[4] = X[4] ^ X[5] ^ X[6];
+	t[5] = X[1] ^ X[4] ^ X[6] ^ X[7];
+	t[6] = X[2] ^ X[3] ^ X[5] ^ X[7];
+	t[7] = X[5] ^ X[7];
+
+	BitsliceInvert(t);
+
+	X[0] = t[0] ^ t[2] ^ t[6];
+	X[1] = t[0] ^ t[1] ^ t[2] ^ t[3] ^ t[4] ^ t[5];
+	X[2] = t[0] ^ t[3] ^ t[5] ^ t[6];
+	X[3] = t[0] ^ t[2] ^ t[5];
+	X[4] = t[0] ^ t[1] ^ t[3] ^ t[4] ^ t[5];
+	X[5] = t[1] ^ t[2] ^ t[3] ^ t[5] ^ t[6] ^ t[7];
+	X[6] = t[4] ^ t[6] ^ t[7];
+	X[7] = t[1] ^ t[2];
+}
+
+// the inverse S-Box without the 0x63 input constant, which is folded into the round keys
+template<typename T>
+inline void BitsliceInvSubBytes(T* X)
+{
+	T t[8];
+
+	t[0] = X[1] ^ X[5] ^ X[6];
+	t[1] = X[1] ^ X[4] ^ X[7];
+	t[2] = X[1] ^ X[4];
+	t[3] = X[0] ^ X[1] ^ X[2] ^ X[3] ^ X[5] ^ X[6];
+	t[4] = X[0] ^ X[1] ^ X[2] ^ X[4] ^ X[5] ^ X[6] ^ X[7];
+	t[5] = X[3] ^ X[4] ^ X[5] ^ X[6];
+	t[6] = X[0] ^ X[4] ^ X[5] ^ X[6];
+	t[7] = X[1] ^ X[2] ^ X[6] ^ X[7];
+
+	BitsliceInvert(t);
+
+	X[0] = t[0] ^ t[7];
+	X[1] = t[4] ^ t[5] ^ t[7];
+	X[2] = t[1];
+	X[3] = t[1] ^ t[6] ^ t[7];
+	X[4] = t[1] ^ t[3] ^ t[6] ^ t[7];
+	X[5] = t[2] ^ t[4] ^ t[6];
+	X[6] = t[1] ^ t[2] ^ t[3] ^ t[7];
+	X[7] = t[2] ^ t[4] ^ t[6] ^ t[7];
+}
+
+template<typename T>
+inline void BitsliceMixColumns(T* X, const T &Rot1, const T &Rot2)
+{
+	T r[8];
+	T t[8];
+
+	// xtime(a ^ rot1(a)) ^ rot1(a) ^ rot2(a ^ rot1(a))
+	for (size_t i = 0; i < 8; ++i)
+	{
+		r[i] = T::Shuffle8(X[i], Rot1);
+		t[i] = X[i] ^ r[i];
+		X[i] = r[i] ^ T::Shuffle8(t[i], Rot2);
+	}
+
+	X[0] ^= t[7];
+	X[1] ^= t[0] ^ t[7];
+	X[2] ^= t[1];
+	X[3] ^= t[2] ^ t[7];
+	X[4] ^= t[3] ^ t[7];
+	X[5] ^= t[4];
+	X[6] ^= t[5];
+	X[7] ^= t[6];
+}
+
+template<typename T>
+inline void BitsliceInvMixColumns(T* X, const T &Rot1, const T &Rot2)
+{
+	T t[8];
+
+	// InvMixColumns(a) = MixColumns(a ^ x^2 * (a ^ rot2(a)))
+	for (size_t i = 0; i < 8; ++i)
+		t[i] = X[i] ^ T::Shuffle8(X[i], Rot2);
+
+	X[0] ^= t[6];
+	X[1] ^= t[6] ^ t[7];
+	X[2] ^= t[0] ^ t[7];
+	X[3] ^= t[1] ^ t[6];
+	X[4] ^= t[2] ^ t[6] ^ t[7];
+	X[5] ^= t[3] ^ t[7];
+	X[6] ^= t[4];
+	X[7] ^= t[5];
+
+	BitsliceMixColumns(X, Rot1, Rot2);
+}
+
+template<typename T>
+void RHXDecryptW(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset, const std::vector<byte> &Key)
+{
+	const size_t RNDCNT = (Key.size() / BITSLICE_KEY) - 1;
+	const T ISR(InvShiftRowsMask, 0);
+	const T RT1(RotateOneMask, 0);
+	const T RT2(RotateTwoMask, 0);
+	T X[8];
+
+	for (size_t i = 0; i < 8; ++i)
+		X[i].Load(Input, InOffset + (i * T::size()));
+
+	BitsliceTranspose(X);
+	BitsliceAddKey(X, Key, 0);
+
+	// the final round is folded into the loop, keeping a single instance of the S-Box circuit
+	for (size_t i = 1; i <= RNDCNT; ++i)
+	{
+		BitsliceShuffle(X, ISR);
+		BitsliceInvSubBytes(X);
+
+		if (i != RNDCNT)
+		{
+			BitsliceInvMixColumns(X, RT1, RT2);
+		}
+
+		BitsliceAddKey(X, Key, i);
+	}
+
+	BitsliceTranspose(X);
+
+	for (size_t i = 0; i < 8; ++i)
+		X[i].Store(Output, OutOffset + (i * T::size()));
+}
+
+template<typename T>
+void RHXEncryptW(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset, const std::vector<byte> &Key)
+{
+	const size_t RNDCNT = (Key.size() / BITSLICE_KEY) - 1;
+	const T SR(ShiftRowsMask, 0);
+	const T RT1(RotateOneMask, 0);
+	const T RT2(RotateTwoMask, 0);
+	T X[8];
+
+	for (size_t i = 0; i < 8; ++i)
+		X[i].Load(Input, InOffset + (i * T::size()));
+
+	BitsliceTranspose(X);
+	BitsliceAddKey(X, Key, 0);
+
+	// the final round is folded into the loop, keeping a single instance of the S-Box circuit
+	for (size_t i = 1; i <= RNDCNT; ++i)
+	{
+		BitsliceShuffle(X, SR);
+		BitsliceSubBytes(X);
+
+		if (i != RNDCNT)
+		{
+			BitsliceMixColumns(X, RT1, RT2);
+		}
+
+		BitsliceAddKey(X, Key, i);
+	}
+
+	BitsliceTranspose(X);
+
+	for (size_t i = 0; i < 8; ++i)
+		X[i].Store(Output, OutOffset + (i * T::size()));
+}
+
+//~~~AES-NI (AHX)~~~//
+
+// the round functions of the AES-NI cipher over its expanded key; the block count is a compile time constant,
+// so the blocks are held in independent registers and each round instruction is issued across all of them
+
+template<size_t BLOCKS>
+inline void AHXDecryptW(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset, const std::vector<__m128i> &Key)
+{
+	const size_t LRD = Key.size() - 2;
+	size_t keyCtr = 0;
+	__m128i X[BLOCKS];
+
+	for (size_t i = 0; i < BLOCKS; ++i)
+		X[i] = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&Input[InOffset + (i * 16)])), Key[keyCtr]);
+
+	while (keyCtr != LRD)
+	{
+		++keyCtr;
+
+		for (size_t i = 0; i < BLOCKS; ++i)
+			X[i] = _mm_aesdec_si128(X[i], Key[keyCtr]);
+	}
+
+	++keyCtr;
+
+	for (size_t i = 0; i < BLOCKS; ++i)
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&Output[OutOffset + (i * 16)]), _mm_aesdeclast_si128(X[i], Key[keyCtr]));
+}
+
+template<size_t BLOCKS>
+inline void AHXEncryptW(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset, const std::vector<__m128i> &Key)
+{
+	const size_t LRD = Key.size() - 2;
+	size_t keyCtr = 0;
+	__m128i X[BLOCKS];
+
+	for (size_t i = 0; i < BLOCKS; ++i)
+		X[i] = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&Input[InOffset + (i * 16)])), Key[keyCtr]);
+
+	while (keyCtr != LRD)
+	{
+		++keyCtr;
+
+		for (size_t i = 0; i < BLOCKS; ++i)
+			X[i] = _mm_aesenc_si128(X[i], Key[keyCtr]);
+	}
+
+	++keyCtr;
+
+	for (size_t i = 0; i < BLOCKS; ++i)
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&Output[OutOffset + (i * 16)]), _mm_aesenclast_si128(X[i], Key[keyCtr]));
+}
+
+#if defined(CEX_HAS_VAES)
+
+// four blocks per 512bit register, the round key is broadcast to each 128bit lane
+
+template<size_t REGISTERS>
+inline void AHXDecryptVaes(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset, const std::vector<__m128i> &Key)
+{
+	const size_t LRD = Key.size() - 2;
+	size_t keyCtr = 0;
+	__m512i K = _mm512_broadcast_i32x4(Key[keyCtr]);
+	__m512i X[REGISTERS];
+
+	for (size_t i = 0; i < REGISTERS; ++i)
+		X[i] = _mm512_xor_si512(_mm512_loadu_si512(reinterpret_cast<const void*>(&Input[InOffset + (i * 64)])), K);
+
+	while (keyCtr != LRD)
+	{
+		K = _mm512_broadcast_i32x4(Key[++keyCtr]);
+
+		for (size_t i = 0; i < REGISTERS; ++i)
+			X[i] = _mm512_aesdec_epi128(X[i], K);
+	}
+
+	K = _mm512_broadcast_i32x4(Key[++keyCtr]);
+
+	for (size_t i = 0; i < REGISTERS; ++i)
+		_mm512_storeu_si512(reinterpret_cast<void*>(&Output[OutOffset + (i * 64)]), _mm512_aesdeclast_epi128(X[i], K));
+}
+
+template<size_t REGISTERS>
+inline void AHXEncryptVaes(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset, const std::vector<__m128i> &Key)
+{
+	const size_t LRD = Key.size() - 2;
+	size_t keyCtr = 0;
+	__m512i K = _mm512_broadcast_i32x4(Key[keyCtr]);
+	__m512i X[REGISTERS];
+
+	for (size_t i = 0; i < REGISTERS; ++i)
+		X[i] = _mm512_xor_si512(_mm512_loadu_si512(reinterpret_cast<const void*>(&Input[InOffset + (i * 64)])), K);
+
+	while (keyCtr != LRD)
+	{
+		K = _mm512_broadcast_i32x4(Key[++keyCtr]);
+
+		for (size_t i = 0; i < REGISTERS; ++i)
+			X[i] = _mm512_aesenc_epi128(X[i], K);
+	}
+
+	K = _mm512_broadcast_i32x4(Key[++keyCtr]);
+
+	for (size_t i = 0; i < REGISTERS; ++i)
+		_mm512_storeu_si512(reinterpret_cast<void*>(&Output[OutOffset + (i * 64)]), _mm512_aesenclast_epi128(X[i], K));
+}
+
 #endif
 
+#endif
+
+NAMESPACE_BLOCKEND
+#endif
@@ -1,5 +1,10 @@
 #include "RingLWE.h"
+#include "AeadStream.h"
 #include "FFTQ12289N1024.h"
+#include "FFTQ40961N1024.h"
+#if defined(CEX_RLWE_TESTSETS)
+#	include "FFTQ7681N256.h"
+#endif
 #include "GCM.h"
 #include "IntUtils.h"
 #include "Keccak512.h"
@@ -119,28 +124,74 @@ RingLWE::~RingLWE()
 std::vector<byte> RingLWE::Decrypt(const std::vector<byte> &CipherText)
 {
 	CexAssert(m_isInitialized, "The cipher has not been initialized");
+	CexAssert(CipherText.size() >= m_paramSet.ReturnMessageSize, "The input message is too small");
 
+	std::vector<byte> secret(m_paramSet.SeedSize);
+
+	// process message from B and return shared secret used to key GCM
 	if (m_rlweParameters == RLWEParams::Q12289N1024)
 	{
-		CexAssert(CipherText.size() >= FFTQ12289N1024::SENDB_BYTES, "The input message is too small");
-
-		std::vector<byte> secret(FFTQ12289N1024::SEED_BYTES);
-		// process message from B and return shared secret used to key GCM
 		FFTQ12289N1024::Decrypt(secret, m_privateKey->R(), CipherText);
-		// added authentication step
-		std::vector<byte> msg(0);
+	}
+	else if (m_rlweParameters == RLWEParams::Q40961N1024)
+	{
+		FFTQ40961N1024::Decrypt(secret, m_privateKey->R(), CipherText);
+	}
+#if defined(CEX_RLWE_TESTSETS)
+	else if (m_rlweParameters == RLWEParams::Q7681N256)
+	{
+		FFTQ7681N256::Decrypt(secret, m_privateKey->R(), CipherText);
+	}
+#endif
+	else
+	{
+		throw CryptoAsymmetricException("RingLWE:Decrypt", "The parameter type is invalid!");
+	}
 
-		if (!RLWEDecrypt(CipherText, msg, secret))
-		{
-			throw CryptoAuthenticationFailure("RingLWE:Decrypt", "Decryption authentication failure!");
-		}
+	// added authentication step
+	std::vector<byte> msg(0);
+
+	if (!RLWEDecrypt(CipherText, msg, secret))
+	{
+		throw CryptoAuthenticationFailure("RingLWE:Decrypt", "Decryption authentication failure!");
+	}
+
+	return msg;
+}
+
+void RingLWE::Decrypt(IByteStream* Input, IByteStream* Output)
+{
+	CexAssert(m_isInitialized, "The cipher has not been initialized");
+
+	std::vector<byte> reply(m_paramSet.ReturnMessageSize);
+	std::vector<byte> secret(m_paramSet.SeedSize);
+
+	if (Input->Length() - Input->Position() < reply.size() || Input->Read(reply, 0, reply.size()) != reply.size())
+	{
+		throw CryptoAuthenticationFailure("RingLWE:Decrypt", "The input stream is too short!");
+	}
 
-		return msg;
+	// process the reply from B and recover the shared secret used to key the stream
+	if (m_rlweParameters == RLWEParams::Q12289N1024)
+	{
+		FFTQ12289N1024::Decrypt(secret, m_privateKey->R(), reply);
+	}
+	else if (m_rlweParameters == RLWEParams::Q40961N1024)
+	{
+		FFTQ40961N1024::Decrypt(secret, m_privateKey->R(), reply);
 	}
+#if defined(CEX_RLWE_TESTSETS)
+	else if (m_rlweParameters == RLWEParams::Q7681N256)
+	{
+		FFTQ7681N256::Decrypt(secret, m_privateKey->R(), reply);
+	}
+#endif
 	else
 	{
 		throw CryptoAsymmetricException("RingLWE:Decrypt", "The parameter type is invalid!");
 	}
+
+	RLWEStream(Input, Output, secret, false);
 }
 
 void RingLWE::Destroy()
@@ -192,45 +243,179 @@ void RingLWE::Destroy()
 std::vector<byte> RingLWE::Encrypt(const std::vector<byte> &Message)
 {
 	CexAssert(m_isInitialized, "The cipher has not been initialized");
+	CexAssert(m_publicKey->P().size() >= m_paramSet.ForwardMessageSize, "The input message is too small");
 
+	std::vector<byte> reply(m_paramSet.ReturnMessageSize);
+	std::vector<byte> secret(m_paramSet.SeedSize);
+
+	// generate B reply and copy shared secret to input
 	if (m_rlweParameters == RLWEParams::Q12289N1024)
 	{
-		CexAssert(m_publicKey->P().size() >= FFTQ12289N1024::SENDA_BYTES, "The input message is too small");
+		FFTQ12289N1024::Encrypt(secret, reply, m_publicKey->P(), m_publicKey->A(), m_rndGenerator, m_isParallel);
+	}
+	else if (m_rlweParameters == RLWEParams::Q40961N1024)
+	{
+		FFTQ40961N1024::Encrypt(secret, reply, m_publicKey->P(), m_publicKey->A(), m_rndGenerator, m_isParallel);
+	}
+#if defined(CEX_RLWE_TESTSETS)
+	else if (m_rlweParameters == RLWEParams::Q7681N256)
+	{
+		FFTQ7681N256::Encrypt(secret, reply, m_publicKey->P(), m_publicKey->A(), m_rndGenerator, m_isParallel);
+	}
+#endif
+	else
+	{
+		throw CryptoAsymmetricException("RingLWE:Encrypt", "The parameter type is invalid!");
+	}
+
+	// use the shared secret to key GCM and encrypt the message
+	RLWEEncrypt(Message, reply, secret);
+
+	return reply;
+}
+
+std::vector<std::vector<byte>> RingLWE::Encrypt(const std::vector<std::vector<byte>> &Messages)
+{
+	CexAssert(m_isInitialized, "The cipher has not been initialized");
+	CexAssert(m_publicKey->P().size() >= m_paramSet.ForwardMessageSize, "The input message is too small");
 
-		std::vector<byte> reply(FFTQ12289N1024::SENDB_BYTES);
-		std::vector<byte> secret(FFTQ12289N1024::SEED_BYTES);
-		// generate B reply and copy shared secret to input
-		FFTQ12289N1024::Encrypt(secret, reply, m_publicKey->P(), m_rndGenerator, m_isParallel);
-		// use the shared secret to key GCM and encrypt the message
-		RLWEEncrypt(Message, reply, secret);
+	std::vector<std::vector<byte>> reply(Messages.size(), std::vector<byte>(m_paramSet.ReturnMessageSize));
+	std::vector<std::vector<byte>> secret(Messages.size(), std::vector<byte>(m_paramSet.SeedSize));
 
-		return reply;
+	// generate the B replies and shared secrets for the batch
+	if (m_rlweParameters == RLWEParams::Q12289N1024)
+	{
+		FFTQ12289N1024::Encrypt(secret, reply, m_publicKey->P(), m_publicKey->A(), m_rndGenerator);
+	}
+	else if (m_rlweParameters == RLWEParams::Q40961N1024)
+	{
+		FFTQ40961N1024::Encrypt(secret, reply, m_publicKey->P(), m_publicKey->A(), m_rndGenerator);
+	}
+#if defined(CEX_RLWE_TESTSETS)
+	else if (m_rlweParameters == RLWEParams::Q7681N256)
+	{
+		FFTQ7681N256::Encrypt(secret, reply, m_publicKey->P(), m_publicKey->A(), m_rndGenerator);
+	}
+#endif
+	else
+	{
+		throw CryptoAsymmetricException("RingLWE:Encrypt", "The parameter type is invalid!");
+	}
+
+	// the mode and digest are members of this instance, so the messages are encrypted in order
+	for (size_t i = 0; i < Messages.size(); ++i)
+	{
+		RLWEEncrypt(Messages[i], reply[i], secret[i]);
+	}
+
+	return reply;
+}
+
+void RingLWE::Encrypt(IByteStream* Input, IByteStream* Output)
+{
+	CexAssert(m_isInitialized, "The cipher has not been initialized");
+	CexAssert(m_publicKey->P().size() >= m_paramSet.ForwardMessageSize, "The input message is too small");
+
+	std::vector<byte> reply(m_paramSet.ReturnMessageSize);
+	std::vector<byte> secret(m_paramSet.SeedSize);
+
+	// the secret is encapsulated once for the whole stream
+	if (m_rlweParameters == RLWEParams::Q12289N1024)
+	{
+		FFTQ12289N1024::Encrypt(secret, reply, m_publicKey->P(), m_publicKey->A(), m_rndGenerator, m_isParallel);
+	}
+	else if (m_rlweParameters == RLWEParams::Q40961N1024)
+	{
+		FFTQ40961N1024::Encrypt(secret, reply, m_publicKey->P(), m_publicKey->A(), m_rndGenerator, m_isParallel);
+	}
+#if defined(CEX_RLWE_TESTSETS)
+	else if (m_rlweParameters == RLWEParams::Q7681N256)
+	{
+		FFTQ7681N256::Encrypt(secret, reply, m_publicKey->P(), m_publicKey->A(), m_rndGenerator, m_isParallel);
 	}
+#endif
 	else
 	{
 		throw CryptoAsymmetricException("RingLWE:Encrypt", "The parameter type is invalid!");
 	}
+
+	Output->Write(reply, 0, reply.size());
+	RLWEStream(Input, Output, secret, true);
 }
 
 IAsymmetricKeyPair* RingLWE::Generate()
 {
 	CexAssert(m_rlweParameters != RLWEParams::None, "The parameter setting is invalid");
 
+	std::vector<byte> pkA(m_paramSet.ForwardMessageSize);
+	std::vector<ushort> skA(m_paramSet.N);
+	std::vector<ushort> plA(m_paramSet.N);
+
 	if (m_rlweParameters == RLWEParams::Q12289N1024)
 	{
-		std::vector<byte> pkA(FFTQ12289N1024::SENDA_BYTES);
-		std::vector<ushort> skA(FFTQ12289N1024::N);
-		FFTQ12289N1024::Generate(pkA, skA, m_rndGenerator, m_isParallel);
+		FFTQ12289N1024::Generate(pkA, skA, plA, m_rndGenerator, m_isParallel);
+	}
+	else if (m_rlweParameters == RLWEParams::Q40961N1024)
+	{
+		FFTQ40961N1024::Generate(pkA, skA, plA, m_rndGenerator, m_isParallel);
+	}
+#if defined(CEX_RLWE_TESTSETS)
+	else if (m_rlweParameters == RLWEParams::Q7681N256)
+	{
+		FFTQ7681N256::Generate(pkA, skA, plA, m_rndGenerator, m_isParallel);
+	}
+#endif
+	else
+	{
+		throw CryptoAsymmetricException("RingLWE:Generate", "The parameter type is invalid!");
+	}
+
+	Key::Asymmetric::RLWEPublicKey* pk = new Key::Asymmetric::RLWEPublicKey(m_rlweParameters, pkA);
+	// the new key carries the expanded polynomial, so the first encryption does not expand it again
+	pk->A().swap(plA);
+	Key::Asymmetric::RLWEPrivateKey* sk = new Key::Asymmetric::RLWEPrivateKey(m_rlweParameters, skA);
 
-		Key::Asymmetric::RLWEPublicKey* pk = new Key::Asymmetric::RLWEPublicKey(m_rlweParameters, pkA);
-		Key::Asymmetric::RLWEPrivateKey* sk = new Key::Asymmetric::RLWEPrivateKey(m_rlweParameters, skA);
+	return new Key::Asymmetric::RLWEKeyPair(sk, pk, m_keyTag);
+}
 
-		return new Key::Asymmetric::RLWEKeyPair(sk, pk, m_keyTag);
+std::vector<IAsymmetricKeyPair*> RingLWE::Generate(size_t Count)
+{
+	CexAssert(m_rlweParameters != RLWEParams::None, "The parameter setting is invalid");
+
+	std::vector<std::vector<byte>> pkA(Count, std::vector<byte>(m_paramSet.ForwardMessageSize));
+	std::vector<std::vector<ushort>> skA(Count, std::vector<ushort>(m_paramSet.N));
+	std::vector<std::vector<ushort>> plA(Count);
+
+	if (m_rlweParameters == RLWEParams::Q12289N1024)
+	{
+		FFTQ12289N1024::Generate(pkA, skA, plA, m_rndGenerator);
 	}
+	else if (m_rlweParameters == RLWEParams::Q40961N1024)
+	{
+		FFTQ40961N1024::Generate(pkA, skA, plA, m_rndGenerator);
+	}
+#if defined(CEX_RLWE_TESTSETS)
+	else if (m_rlweParameters == RLWEParams::Q7681N256)
+	{
+		FFTQ7681N256::Generate(pkA, skA, plA, m_rndGenerator);
+	}
+#endif
 	else
 	{
 		throw CryptoAsymmetricException("RingLWE:Generate", "The parameter type is invalid!");
 	}
+
+	std::vector<IAsymmetricKeyPair*> kps(Count);
+
+	for (size_t i = 0; i < Count; ++i)
+	{
+		Key::Asymmetric::RLWEPublicKey* pk = new Key::Asymmetric::RLWEPublicKey(m_rlweParameters, pkA[i]);
+		pk->A().swap(plA[i]);
+		Key::Asymmetric::RLWEPrivateKey* sk = new Key::Asymmetric::RLWEPrivateKey(m_rlweParameters, skA[i]);
+		kps[i] = new Key::Asymmetric::RLWEKeyPair(sk, pk, m_keyTag);
+	}
+
+	return kps;
 }
 
 void RingLWE::Initialize(bool Encryption, IAsymmetricKeyPair* KeyPair)
@@ -244,15 +429,47 @@ void RingLWE::Initialize(bool Encryption, IAsymmetricKeyPair* KeyPair)
 		throw CryptoAsymmetricException("RingLWE:Initialize", "Encryption requires a valid public key!");
 	}
 
+	// the parameter sets have different key sizes, a key from another set can not be used
+	if (Encryption == true && (((RLWEPublicKey*)KeyPair->PublicKey())->Parameters() != m_rlweParameters || ((RLWEPublicKey*)KeyPair->PublicKey())->P().size() < m_paramSet.ForwardMessageSize))
+	{
+		throw CryptoAsymmetricException("RingLWE:Initialize", "The public key does not belong to this parameter set!");
+	}
+	if (Encryption == false && (((RLWEPrivateKey*)KeyPair->PrivateKey())->Parameters() != m_rlweParameters || ((RLWEPrivateKey*)KeyPair->PrivateKey())->R().size() != m_paramSet.N))
+	{
+		throw CryptoAsymmetricException("RingLWE:Initialize", "The private key does not belong to this parameter set!");
+	}
+
 	m_keyTag = KeyPair->Tag();
 
+	// the keys belong to the caller; release a previous key rather than deleting it on re-initialization
 	if (Encryption)
 	{
-		m_publicKey = std::unique_ptr<RLWEPublicKey>((RLWEPublicKey*)KeyPair->PublicKey());
+		m_publicKey.release();
+		m_publicKey.reset((RLWEPublicKey*)KeyPair->PublicKey());
+
+		// expand the public polynomial once, it is cached with the key and reused by every encryption
+		if (m_publicKey->A().size() != m_paramSet.N)
+		{
+			if (m_rlweParameters == RLWEParams::Q12289N1024)
+			{
+				FFTQ12289N1024::Expand(m_publicKey->A(), m_publicKey->P());
+			}
+			else if (m_rlweParameters == RLWEParams::Q40961N1024)
+			{
+				FFTQ40961N1024::Expand(m_publicKey->A(), m_publicKey->P());
+			}
+#if defined(CEX_RLWE_TESTSETS)
+			else if (m_rlweParameters == RLWEParams::Q7681N256)
+			{
+				FFTQ7681N256::Expand(m_publicKey->A(), m_publicKey->P());
+			}
+#endif
+		}
 	}
 	else
 	{
-		m_privateKey = std::unique_ptr<RLWEPrivateKey>((RLWEPrivateKey*)KeyPair->PrivateKey());
+		m_privateKey.release();
+		m_privateKey.reset((RLWEPrivateKey*)KeyPair->PrivateKey());
 	}
 
 	m_isEncryption = Encryption;
@@ -280,7 +497,7 @@ bool RingLWE::RLWEDecrypt(const std::vector<byte> &CipherText, std::vector<byte>
 	m_msgDigest->Finalize(Secret, 0);
 
 	// HX ciphers get keccak1024 and 512 bits of key, standard 256 bit key
-	Message.resize(CipherText.size() - (FFTQ12289N1024::SENDB_BYTES + keySizes.InfoSize()));
+	Message.resize(CipherText.size() - (m_paramSet.ReturnMessageSize + keySizes.InfoSize()));
 	std::vector<byte> key(keySizes.KeySize());
 	std::memcpy(&key[0], &Secret[0], key.size());
 	std::vector<byte> nonce(keySizes.NonceSize());
@@ -330,19 +547,72 @@ void RingLWE::RLWEEncrypt(const std::vector<byte> &Message, std::vector<byte> &C
 	std::memcpy(&tag[0], &Secret[key.size() + keySizes.NonceSize()], keySizes.InfoSize());
 
 	// encrypt the message, add it to the ciphertext with the auth-code
-	CipherText.resize(FFTQ12289N1024::SENDB_BYTES + Message.size() + keySizes.InfoSize());
+	CipherText.resize(m_paramSet.ReturnMessageSize + Message.size() + keySizes.InfoSize());
 	Key::Symmetric::SymmetricKey kp(key, nonce, tag);
 	m_cprMode->Initialize(true, kp);
 	m_cprMode->Transform(Message, 0, CipherText, CipherText.size() - (Message.size() + keySizes.InfoSize()), Message.size());
 	m_cprMode->Finalize(CipherText, CipherText.size() - keySizes.InfoSize(), keySizes.InfoSize());
 }
 
+void RingLWE::RLWEStream(IByteStream* Input, IByteStream* Output, std::vector<byte> &Secret, bool Encryption)
+{
+	Key::Symmetric::SymmetricKeySize keySizes;
+
+	if (static_cast<byte>(m_cprMode->Engine()->Enumeral()) < static_cast<byte>(BlockCiphers::AHX))
+	{
+		keySizes = m_cprMode->LegalKeySizes()[2];
+	}
+	else
+	{
+		keySizes = m_cprMode->LegalKeySizes()[1];
+	}
+
+	// hash the ringlwe secret to create intermediate key
+	m_msgDigest->Update(Secret, 0, Secret.size());
+	Secret.resize(m_msgDigest->DigestSize());
+	m_msgDigest->Finalize(Secret, 0);
+
+	std::vector<byte> key(keySizes.KeySize());
+	std::memcpy(&key[0], &Secret[0], key.size());
+	std::vector<byte> nonce(keySizes.NonceSize());
+	std::memcpy(&nonce[0], &Secret[key.size()], keySizes.NonceSize());
+	std::vector<byte> tag(keySizes.InfoSize());
+	std::memcpy(&tag[0], &Secret[key.size() + keySizes.NonceSize()], keySizes.InfoSize());
+
+	// key the mode once, the stream copies it to each core and derives a nonce for every chunk
+	Key::Symmetric::SymmetricKey kp(key, nonce, tag);
+	m_cprMode->Initialize(Encryption, kp);
+	Processing::AeadStream cstm(static_cast<Symmetric::Block::Mode::GCM*>(m_cprMode.get()), nonce, keySizes.InfoSize());
+
+	if (Encryption)
+	{
+		cstm.Seal(Input, Output);
+	}
+	else
+	{
+		cstm.Open(Input, Output);
+	}
+
+	Utility::MemUtils::Clear(key, 0, key.size());
+	Utility::MemUtils::Clear(Secret, 0, Secret.size());
+}
+
 void RingLWE::Scope()
 {
 	if (m_rlweParameters == RLWEParams::Q12289N1024)
 	{
 		m_paramSet.Load(FFTQ12289N1024::N, FFTQ12289N1024::Q, FFTQ12289N1024::SEED_BYTES, FFTQ12289N1024::SENDA_BYTES, FFTQ12289N1024::SENDB_BYTES, RLWEParams::Q12289N1024);
 	}
+	else if (m_rlweParameters == RLWEParams::Q40961N1024)
+	{
+		m_paramSet.Load(FFTQ40961N1024::N, FFTQ40961N1024::Q, FFTQ40961N1024::SEED_BYTES, FFTQ40961N1024::SENDA_BYTES, FFTQ40961N1024::SENDB_BYTES, RLWEParams::Q40961N1024);
+	}
+#if defined(CEX_RLWE_TESTSETS)
+	else if (m_rlweParameters == RLWEParams::Q7681N256)
+	{
+		m_paramSet.Load(FFTQ7681N256::N, FFTQ7681N256::Q, FFTQ7681N256::SEED_BYTES, FFTQ7681N256::SENDA_BYTES, FFTQ7681N256::SENDB_BYTES, RLWEParams::Q7681N256);
+	}
+#endif
 	else
 	{
 		throw CryptoAsymmetricException("RingLWE:Scope", "The parameter set is not recognized!");
@@ -24,6 +24,7 @@
 #include "IAeadMode.h"
 #include "IAsymmetricCipher.h"
 #include "IBlockCipher.h"
+#include "IByteStream.h"
 #include "RLWEKeyPair.h"
 #include "RLWEParams.h"
 #include "RLWEParamSet.h"
@@ -40,6 +41,7 @@ using Key::Asymmetric::RLWEPrivateKey;
 using Key::Asymmetric::RLWEPublicKey;
 using Key::Asymmetric::RLWEPublicKey;
 using Enumeration::BlockCiphers;
+using IO::IByteStream;
 
 /// <summary>
 /// An implementation of the Ring Learning With Errors asymmetric cipher (RingLWE)
@@ -68,6 +70,10 @@ using Enumeration::BlockCiphers;
 /// RingLWE cpr(Enumeration::RLWEParams::Q12289N1024);
 /// cpr.Initialize(false, kp);
 /// std:vector&lt;byte&gt; dec = cpr.Decrypt(enc);
+/// // the keys belong to the caller, and are deleted after the cipher is finished with them
+/// delete kp->PrivateKey();
+/// delete kp->PublicKey();
+/// delete kp;
 /// </code>
 /// </example>
 /// 
@@ -82,7 +88,13 @@ using Enumeration::BlockCiphers;
 /// Unlike other schemes the shared seed is not input into the Encrypt() function, but generated by the reconcilliation methods.</para>
 /// 
 /// <list type="bullet">
-/// <item><description>The Q12289/N1024 parameter set is the default cipher configuration; as of (1.0.0.3), this is currently the only parameter set, but a modular construction is used anticipating future expansion</description></item>
+/// <item><description>The Q12289/N1024 parameter set is the default cipher configuration, and uses the NewHope reconciliation</description></item>
+/// <item><description>The Q40961/N1024 and Q7681/N256 parameter sets encrypt the shared seed directly, (NewHope-Simple style), with a compressed cipher-text; Q7681/N256 has the smallest keys and is the fastest, but is a low-security set (an estimated core-SVP hardness well under 100 bits, and a decryption failure rate of about 2^-46), and is only available to test builds that define CEX_RLWE_TESTSETS</description></item>
+/// <item><description>A key can only be used with the parameter set that created it; Initialize throws if the key belongs to a different set</description></item>
+/// <item><description>The cipher does not take ownership of the keys; the key pair and its public and private keys belong to the caller, and must outlive their use by the cipher.
+/// Re-initializing the cipher, or calling Destroy, releases the previous key without deleting it. The key pair does not delete its keys either,
+/// so the caller deletes the PrivateKey(), the PublicKey(), and then the key pair itself</description></item>
+/// <item><description>Large messages can be encrypted as streams; one secret is encapsulated per stream, and the payload is encrypted in parallel GCM chunks with bounded memory</description></item>
 /// <item><description>The primary Prng is set through the constructor, as either an prng type-name (default BCR-AES256), which instantiates the function internally, or a pointer to a perisitant external instance of a Prng</description></item>
 /// <item><description>The message digest used to condition the seed bytes can also be set through the constructor (default is SHA2-256)</description></item>
 /// <item><description>The secondary prng used to generate the public key (BCR), is an AES128/CTR-BE construction, (changed from Shake128 in the new hope version)</description></item>
@@ -96,9 +108,6 @@ using Enumeration::BlockCiphers;
 /// </remarks>
 class RingLWE final : public IAsymmetricCipher
 {
-	// TODO: (I could use some help with this..)
-	// Add at least one other parameter set (>= 200 bits of security). I can provide a template..
-
 private:
 
 	static const std::string CLASS_NAME;
@@ -201,6 +210,18 @@ public:
 	/// <returns>The decrypted message</returns>
 	std::vector<byte> Decrypt(const std::vector<byte> &CipherText) override;
 
+	/// <summary>
+	/// Decrypt and authenticate a stream encrypted with Encrypt(IByteStream*, IByteStream*)
+	/// <para>The reply is read from the input stream and decrypted to recover the shared secret, then the chunks that follow it are opened in windows,
+	/// the chunks of a window divided between the processor cores. The plain-text of a window is written only after every chunk in it has been authenticated.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">The encrypted input stream, read from its position to its end</param>
+	/// <param name="Output">The stream receiving the plain-text</param>
+	///
+	/// <exception cref="Exception::CryptoAuthenticationFailure">Thrown if the stream has failed authentication, or has been truncated</exception>
+	void Decrypt(IByteStream* Input, IByteStream* Output);
+
 	/// <summary>
 	/// Release all resources associated with the object; optional, called by the finalizer
 	/// </summary>
@@ -215,6 +236,28 @@ public:
 	/// <returns>The encrypted message</returns>
 	std::vector<byte> Encrypt(const std::vector<byte> &Message) override;
 
+	/// <summary>
+	/// Encrypt a batch of messages to the public key
+	/// <para>The random for the batch is drawn first, then the messages are divided between the processor cores,
+	/// each core encrypting whole messages sequentially without the per-message threading used by Encrypt(Message).
+	/// The output for each message is identical in format to Encrypt(Message).</para>
+	/// </summary>
+	/// 
+	/// <param name="Messages">The array of messages to encrypt</param>
+	/// 
+	/// <returns>The encrypted messages, in the order of the input array</returns>
+	std::vector<std::vector<byte>> Encrypt(const std::vector<std::vector<byte>> &Messages);
+
+	/// <summary>
+	/// Encrypt a stream of any length to the public key
+	/// <para>A single shared secret is encapsulated and its reply written to the output stream, followed by the input encrypted with the derived key as a sequence of authenticated chunks.
+	/// The input is processed in windows of chunks divided between the processor cores, so memory use is bounded by the window size rather than the length of the stream; see <see cref="Processing::AeadStream"/> for the chunk format.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">The plain-text input stream, read from its position to its end</param>
+	/// <param name="Output">The stream receiving the encrypted message</param>
+	void Encrypt(IByteStream* Input, IByteStream* Output);
+
 	/// <summary>
 	/// Generate a public/private key-pair
 	/// </summary>
@@ -222,8 +265,21 @@ public:
 	/// <returns>A public/private key pair</returns>
 	IAsymmetricKeyPair* Generate() override;
 
+	/// <summary>
+	/// Generate a batch of public/private key-pairs
+	/// <para>The random for the batch is drawn first, then the key-pairs are divided between the processor cores.
+	/// Each public key carries its expanded public polynomial, so the first encryption to a new key does not expand it.</para>
+	/// </summary>
+	/// 
+	/// <param name="Count">The number of key-pairs to generate</param>
+	/// 
+	/// <returns>An array of public/private key pairs</returns>
+	std::vector<IAsymmetricKeyPair*> Generate(size_t Count);
+
 	/// <summary>
 	/// Initialize the cipher for encryption or decryption
+	/// <para>The keys are not copied, and remain owned by the caller; they must not be deleted while the cipher is using them.
+	/// A key set by a previous call is released, but not deleted.</para>
 	/// </summary>
 	/// 
 	/// <param name="Encryption">Initialize the cipher for encryption or decryption</param>
@@ -234,6 +290,7 @@ private:
 
 	bool RLWEDecrypt(const std::vector<byte> &CipherText, std::vector<byte> &Message, std::vector<byte> &Secret);
 	void RLWEEncrypt(const std::vector<byte> &Message, std::vector<byte> &CipherText, std::vector<byte> &Secret);
+	void RLWEStream(IByteStream* Input, IByteStream* Output, std::vector<byte> &Secret, bool Encryption);
 	void Scope();
 };
 
@@ -4,13 +4,6 @@
 #include "HKDF.h"
 #include "IntUtils.h"
 #include "MemUtils.h"
-#if defined(__AVX512__)
-#	include "UInt512.h"
-#elif defined(__AVX2__)
-#	include "UInt256.h"
-#elif defined(__AVX__)
-#	include "UInt128.h"
-#endif
 
 NAMESPACE_BLOCK
 
@@ -55,6 +48,11 @@ const Digests SHX::KdfEngine()
 	return m_kdfEngineType;
 }
 
+KeyScheduleCache* &SHX::KeyCache()
+{
+	return m_keyCache;
+}
+
 const std::vector<SymmetricKeySize> &SHX::LegalKeySizes()
 {
 	return m_legalKeySizes;
@@ -97,6 +95,7 @@ SHX::SHX(Digests KdfEngineType, size_t Rounds)
 	m_kdfKeySize(0),
 	m_isEncryption(false),
 	m_isInitialized(false),
+	m_keyCache(0),
 	m_legalKeySizes(0),
 	m_legalRounds(0),
 	m_rndCount(Rounds)
@@ -119,6 +118,7 @@ SHX::SHX(IDigest *KdfEngine, size_t Rounds)
 	m_kdfKeySize(0),
 	m_isEncryption(false),
 	m_isInitialized(false),
+	m_keyCache(0),
 	m_legalKeySizes(0),
 	m_legalRounds(0),
 	m_rndCount(Rounds)
@@ -136,6 +136,24 @@ SHX::~SHX()
 
 //~~~Public Functions~~~//
 
+SHX* SHX::Clone()
+{
+	if (!m_isInitialized)
+		throw CryptoSymmetricCipherException("SHX:Clone", "The cipher has not been initialized!");
+
+	// the copy owns a digest of the same type, and takes the expanded schedule as is
+	SHX* cpr = new SHX(m_kdfEngineType, m_rndCount);
+	cpr->m_cprKeySize = m_cprKeySize;
+	cpr->m_expKey = m_expKey;
+	cpr->m_kdfInfo = m_kdfInfo;
+	cpr->m_isEncryption = m_isEncryption;
+	cpr->m_keyCache = m_keyCache;
+	cpr->m_rndCount = m_rndCount;
+	cpr->m_isInitialized = true;
+
+	return cpr;
+}
+
 void SHX::DecryptBlock(const std::vector<byte> &Input, std::vector<byte> &Output)
 {
 	Decrypt128(Input, 0, Output, 0);
@@ -199,6 +217,22 @@ void SHX::Initialize(bool Encryption, ISymmetricKey &KeyParams)
 	m_isInitialized = true;
 }
 
+void SHX::Rekey(ISymmetricKey &KeyParams)
+{
+	if (!m_isInitialized)
+		throw CryptoSymmetricCipherException("SHX:Rekey", "The cipher has not been initialized!");
+	if (KeyParams.Key().size() * 8 != m_cprKeySize)
+		throw CryptoSymmetricCipherException("SHX:Rekey", "Invalid key size! The new key must be the same length as the current key.");
+	if (m_kdfEngineType != Enumeration::Digests::None && KeyParams.Info().size() > m_kdfInfoMax)
+		throw CryptoSymmetricCipherException("SHX:Rekey", "Invalid info size! Info parameter must be no longer than DistributionCodeMax size.");
+
+	if (KeyParams.Info().size() > 0)
+		m_kdfInfo = KeyParams.Info();
+
+	// the schedule is the same size, so the working key is overwritten in place
+	ExpandKey(KeyParams.Key());
+}
+
 void SHX::Transform(const std::vector<byte> &Input, std::vector<byte> &Output)
 {
 	if (m_isEncryption)
@@ -261,32 +295,41 @@ void SHX::SecureExpand(const std::vector<byte> &Key)
 	size_t keySize = 4 * (m_rndCount + 1);
 	size_t keyBytes = keySize * 4;
 
-	Kdf::HKDF gen(m_kdfEngine);
+	std::vector<byte> rawKey(keyBytes, 0);
 
-	// change 1.2: use extract only on an oversized key
-	if (Key.size() > m_kdfEngine->BlockSize())
-	{
-		// seperate salt and key
-		m_kdfKeySize = m_kdfEngine->BlockSize();
-		std::vector<byte> kdfKey(m_kdfKeySize, 0);
-		Utility::MemUtils::Copy(Key, 0, kdfKey, 0, m_kdfKeySize);
-		size_t saltSize = Key.size() - m_kdfKeySize;
-		std::vector<byte> kdfSalt(saltSize, 0);
-		Utility::MemUtils::Copy(Key, m_kdfKeySize, kdfSalt, 0, saltSize);
-		// info can be null
-		gen.Initialize(kdfKey, kdfSalt, m_kdfInfo);
-	}
-	else
+	// copy a cached schedule, or run the HKDF expansion and add the schedule to the cache
+	if (m_keyCache == 0 || !m_keyCache->Find(Enumeral(), m_kdfEngineType, m_rndCount, Key, m_kdfInfo, rawKey))
 	{
-		if (m_kdfInfo.size() != 0)
-			gen.Info() = m_kdfInfo;
+		Kdf::HKDF gen(m_kdfEngine);
 
-		gen.Initialize(Key);
+		// change 1.2: use extract only on an oversized key
+		if (Key.size() > m_kdfEngine->BlockSize())
+		{
+			// seperate salt and key
+			m_kdfKeySize = m_kdfEngine->BlockSize();
+			std::vector<byte> kdfKey(m_kdfKeySize, 0);
+			Utility::MemUtils::Copy(Key, 0, kdfKey, 0, m_kdfKeySize);
+			size_t saltSize = Key.size() - m_kdfKeySize;
+			std::vector<byte> kdfSalt(saltSize, 0);
+			Utility::MemUtils::Copy(Key, m_kdfKeySize, kdfSalt, 0, saltSize);
+			// info can be null
+			gen.Initialize(kdfKey, kdfSalt, m_kdfInfo);
+		}
+		else
+		{
+			if (m_kdfInfo.size() != 0)
+				gen.Info() = m_kdfInfo;
+
+			gen.Initialize(Key);
+		}
+
+		// expand the round keys
+		gen.Generate(rawKey);
+
+		if (m_keyCache != 0)
+			m_keyCache->Add(Enumeral(), m_kdfEngineType, m_rndCount, Key, m_kdfInfo, rawKey);
 	}
 
-	std::vector<byte> rawKey(keyBytes, 0);
-	// expand the round keys
-	gen.Generate(rawKey);
 	// initialize working key
 	m_expKey.resize(keySize, 0);
 
@@ -460,7 +503,7 @@ void SHX::Decrypt128(const std::vector<byte> &Input, const size_t InOffset, std:
 
 void SHX::Decrypt512(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
 {
-#if !defined(__AVX512__) && !defined(__AVX2__) && defined(__AVX__)
+#if defined(__AVX__)
 	SHXDecryptW<Numeric::UInt128>(Input, InOffset, Output, OutOffset, m_expKey);
 #else
 	Decrypt128(Input, InOffset, Output, OutOffset);
@@ -472,9 +515,9 @@ void SHX::Decrypt512(const std::vector<byte> &Input, const size_t InOffset, std:
 
 void SHX::Decrypt1024(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
 {
-#if !defined(__AVX512__) && defined(__AVX2__)
+#if defined(__AVX2__)
 	SHXDecryptW<Numeric::UInt256>(Input, InOffset, Output, OutOffset, m_expKey);
-#elif !defined(__AVX512__) && !defined(__AVX2__) && defined(__AVX__)
+#elif defined(__AVX__)
 	SHXDecryptW<Numeric::UInt128>(Input, InOffset, Output, OutOffset, m_expKey);
 	SHXDecryptW<Numeric::UInt128>(Input, InOffset + 64, Output, OutOffset + 64, m_expKey);
 #else
@@ -493,10 +536,10 @@ void SHX::Decrypt2048(const std::vector<byte> &Input, const size_t InOffset, std
 {
 #if defined(__AVX512__)
 	SHXDecryptW<Numeric::UInt512>(Input, InOffset, Output, OutOffset, m_expKey);
-#elif !defined(__AVX512__) && defined(__AVX2__)
+#elif defined(__AVX2__)
 	SHXDecryptW<Numeric::UInt256>(Input, InOffset, Output, OutOffset, m_expKey);
 	SHXDecryptW<Numeric::UInt256>(Input, InOffset + 128, Output, OutOffset + 128, m_expKey);
-#elif !defined(__AVX512__) && !defined(__AVX2__) && defined(__AVX__)
+#elif defined(__AVX__)
 	SHXDecryptW<Numeric::UInt128>(Input, InOffset, Output, OutOffset, m_expKey);
 	SHXDecryptW<Numeric::UInt128>(Input, InOffset + 64, Output, OutOffset + 64, m_expKey);
 	SHXDecryptW<Numeric::UInt128>(Input, InOffset + 128, Output, OutOffset + 128, m_expKey);
@@ -605,7 +648,7 @@ void SHX::Encrypt128(const std::vector<byte> &Input, const size_t InOffset, std:
 
 void SHX::Encrypt512(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
 {
-#if !defined(__AVX512__) && !defined(__AVX2__) && defined(__AVX__)
+#if defined(__AVX__)
 	SHXEncryptW<Numeric::UInt128>(Input, InOffset, Output, OutOffset, m_expKey);
 #else
 	Encrypt128(Input, InOffset, Output, OutOffset);
@@ -617,9 +660,9 @@ void SHX::Encrypt512(const std::vector<byte> &Input, const size_t InOffset, std:
 
 void SHX::Encrypt1024(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
 {
-#if !defined(__AVX512__) && defined(__AVX2__)
+#if defined(__AVX2__)
 	SHXEncryptW<Numeric::UInt256>(Input, InOffset, Output, OutOffset, m_expKey);
-#elif !defined(__AVX512__) && !defined(__AVX2__) && defined(__AVX__)
+#elif defined(__AVX__)
 	SHXEncryptW<Numeric::UInt128>(Input, InOffset, Output, OutOffset, m_expKey);
 	SHXEncryptW<Numeric::UInt128>(Input, InOffset + 64, Output, OutOffset + 64, m_expKey);
 #else
@@ -638,10 +681,10 @@ void SHX::Encrypt2048(const std::vector<byte> &Input, const size_t InOffset, std
 {
 #if defined(__AVX512__)
 	SHXEncryptW<Numeric::UInt512>(Input, InOffset, Output, OutOffset, m_expKey);
-#elif !defined(__AVX512__) && defined(__AVX2__)
+#elif defined(__AVX2__)
 	SHXEncryptW<Numeric::UInt256>(Input, InOffset, Output, OutOffset, m_expKey);
 	SHXEncryptW<Numeric::UInt256>(Input, InOffset + 128, Output, OutOffset + 128, m_expKey);
-#elif !defined(__AVX512__) && !defined(__AVX2__) && defined(__AVX__)
+#elif defined(__AVX__)
 	SHXEncryptW<Numeric::UInt128>(Input, InOffset, Output, OutOffset, m_expKey);
 	SHXEncryptW<Numeric::UInt128>(Input, InOffset + 64, Output, OutOffset + 64, m_expKey);
 	SHXEncryptW<Numeric::UInt128>(Input, InOffset + 128, Output, OutOffset + 128, m_expKey);
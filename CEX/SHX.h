@@ -39,6 +39,7 @@
 #define CEX_SHX_H
 
 #include "IBlockCipher.h"
+#include "KeyScheduleCache.h"
 
 NAMESPACE_BLOCK
 
@@ -99,6 +100,7 @@ NAMESPACE_BLOCK
 /// <item><description>The recommended size for maximum security is 2* the digests block size; this calls HKDF Extract using full blocks of key and salt.</description></item>
 /// <item><description>Valid key sizes can be determined at run time using the <see cref="LegalKeySizes"/> property.</description></item>
 /// <item><description>The internal block size is 16 bytes wide.</description></item>
+/// <item><description>When compiled with AVX, the Transform512, Transform1024 and Transform2048 functions process 4, 8 or 16 blocks with a bitsliced cipher using the UInt128, UInt256 (AVX2) or UInt512 (AVX-512) types; the AVX-512 S-Boxes use the vpternlogd three-input logic instruction.</description></item>
 /// <item><description>Diffusion rounds assignments are 32, 40, 48, 56, and 64 rounds, default is 32 (128-256 bit key), a 512 bit key is automatically assigned 40 rounds.</description></item>
 /// <item><description>Valid rounds assignments can be found in the LegalRounds property.</description></item>
 /// </list>
@@ -140,6 +142,7 @@ private:
 	bool m_isDestroyed;
 	bool m_isEncryption;
 	bool m_isInitialized;
+	KeyScheduleCache* m_keyCache;
 	std::vector<SymmetricKeySize> m_legalKeySizes;
 	std::vector<size_t> m_legalRounds;
 	size_t m_rndCount;
@@ -196,6 +199,13 @@ public:
 	/// </summary>
 	const Digests KdfEngine() override;
 
+	/// <summary>
+	/// Get/Set: An optional cache of HKDF expanded key schedules, shared between cipher instances.
+	/// <para>When set, and the cipher uses a KdfEngine, the key expansion copies a cached schedule instead of running HKDF.
+	/// The cache is not owned by the cipher, and must outlive it.</para>
+	/// </summary>
+	KeyScheduleCache* &KeyCache();
+
 	/// <summary>
 	/// Get: Available Encryption Key Sizes in bytes
 	/// </summary>
@@ -254,6 +264,18 @@ public:
 
 	//~~~Public Functions~~~//
 
+	/// <summary>
+	/// Create an initialized copy of this cipher.
+	/// <para>The expanded key schedule, direction, rounds and distribution code are copied, so the copy does not run the key expansion or HKDF again.
+	/// A KdfEngine instance passed to the constructor is not shared; the copy creates its own digest of the same type.
+	/// The KeyCache() pointer is copied. The caller is responsible for destroying the returned cipher.</para>
+	/// </summary>
+	///
+	/// <returns>A new, initialized SHX instance</returns>
+	///
+	/// <exception cref="Exception::CryptoSymmetricCipherException">Thrown if the cipher has not been initialized</exception>
+	SHX* Clone() override;
+
 	/// <summary>
 	/// Decrypt a single block of bytes.
 	/// <para><see cref="Initialize(bool, ISymmetricKey)"/> must be called with the Encryption flag set to <c>false</c> before this method can be used.
@@ -313,6 +335,17 @@ public:
 	/// <exception cref="Exception::CryptoSymmetricCipherException">Thrown if a null or invalid key is used</exception>
 	void Initialize(bool Encryption, ISymmetricKey &KeyParams) override;
 
+	/// <summary>
+	/// Replace the cipher key, retaining the direction and the allocated cipher state.
+	/// <para>The cipher must be initialized, and the new key must be the same length as the current key.
+	/// With a KeyCache() assigned, rekeying to a previously used key and info skips the HKDF expansion.</para>
+	/// </summary>
+	///
+	/// <param name="KeyParams">Cipher key container; the key must be the same size as the current key</param>
+	///
+	/// <exception cref="Exception::CryptoSymmetricCipherException">Thrown if the cipher is not initialized, or the key or info size is invalid</exception>
+	void Rekey(ISymmetricKey &KeyParams);
+
 	/// <summary>
 	/// Transform a block of bytes.
 	/// <para><see cref="Initialize(bool, ISymmetricKey)"/> must be called before this method can be used.
@@ -110,7 +110,23 @@ public:
 	}
 
 	template<class T>
-	static void SalsaTransformW(std::vector<byte> &Output, size_t OutOffset, std::vector<uint> &Counter, std::vector<uint> &State, size_t Rounds)
+	static void XorStore(const T &X, const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset, bool NonTemporal)
+	{
+		T Y = X ^ T(Input, InOffset);
+
+		if (NonTemporal)
+		{
+			Y.StoreNT(Output, OutOffset);
+		}
+		else
+		{
+			Y.Store(Output, OutOffset);
+		}
+	}
+
+	// the key-stream is xored with the input as it is stored; non-temporal stores require an aligned output, the caller issues the store fence
+	template<class T>
+	static void SalsaTransformW(const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset, std::vector<uint> &Counter, std::vector<uint> &State, size_t Rounds, bool NonTemporal)
 	{
 #if defined(__AVX__)
 
@@ -124,13 +140,8 @@ public:
 		T X6(State[++ctr]);
 		T X7(State[++ctr]);
 		T X8(Counter, 0);
-#if defined(__AVX512__)
-		T X9(Counter, 16);
-#elif defined(__AVX2__)
-		T X9(Counter, 8);
-#else
-		T X9(Counter, 4);
-#endif
+		// the counter array holds the low word of each lane followed by the high words
+		T X9(Counter, T::size() / sizeof(uint));
 		T X10(State[++ctr]);
 		T X11(State[++ctr]);
 		T X12(State[++ctr]);
@@ -186,13 +197,7 @@ public:
 		X6 += T(State[++ctr]);
 		X7 += T(State[++ctr]);
 		X8 += T(Counter, 0);
-#if defined(__AVX512__)
-		X9 += T(Counter, 16);
-#elif defined(__AVX2__)
-		X9 += T(Counter, 8);
-#else
-		X9 += T(Counter, 4);
-#endif
+		X9 += T(Counter, T::size() / sizeof(uint));
 		X10 += T(State[++ctr]);
 		X11 += T(State[++ctr]);
 		X12 += T(State[++ctr]);
@@ -200,7 +205,26 @@ public:
 		X14 += T(State[++ctr]);
 		X15 += T(State[++ctr]);
 
-		T::Store16(Output, OutOffset, X0, X1, X2, X3, X4, X5, X6, X7, X8, X9, X10, X11, X12, X13, X14, X15);
+		T::Transpose16(X0, X1, X2, X3, X4, X5, X6, X7, X8, X9, X10, X11, X12, X13, X14, X15);
+
+		const size_t REGSZE = T::size();
+
+		XorStore(X0, Input, InOffset, Output, OutOffset, NonTemporal);
+		XorStore(X1, Input, InOffset + REGSZE, Output, OutOffset + REGSZE, NonTemporal);
+		XorStore(X2, Input, InOffset + (2 * REGSZE), Output, OutOffset + (2 * REGSZE), NonTemporal);
+		XorStore(X3, Input, InOffset + (3 * REGSZE), Output, OutOffset + (3 * REGSZE), NonTemporal);
+		XorStore(X4, Input, InOffset + (4 * REGSZE), Output, OutOffset + (4 * REGSZE), NonTemporal);
+		XorStore(X5, Input, InOffset + (5 * REGSZE), Output, OutOffset + (5 * REGSZE), NonTemporal);
+		XorStore(X6, Input, InOffset + (6 * REGSZE), Output, OutOffset + (6 * REGSZE), NonTemporal);
+		XorStore(X7, Input, InOffset + (7 * REGSZE), Output, OutOffset + (7 * REGSZE), NonTemporal);
+		XorStore(X8, Input, InOffset + (8 * REGSZE), Output, OutOffset + (8 * REGSZE), NonTemporal);
+		XorStore(X9, Input, InOffset + (9 * REGSZE), Output, OutOffset + (9 * REGSZE), NonTemporal);
+		XorStore(X10, Input, InOffset + (10 * REGSZE), Output, OutOffset + (10 * REGSZE), NonTemporal);
+		XorStore(X11, Input, InOffset + (11 * REGSZE), Output, OutOffset + (11 * REGSZE), NonTemporal);
+		XorStore(X12, Input, InOffset + (12 * REGSZE), Output, OutOffset + (12 * REGSZE), NonTemporal);
+		XorStore(X13, Input, InOffset + (13 * REGSZE), Output, OutOffset + (13 * REGSZE), NonTemporal);
+		XorStore(X14, Input, InOffset + (14 * REGSZE), Output, OutOffset + (14 * REGSZE), NonTemporal);
+		XorStore(X15, Input, InOffset + (15 * REGSZE), Output, OutOffset + (15 * REGSZE), NonTemporal);
 #endif
 	}
 };
@@ -1,7 +1,9 @@
 #include "Salsa20.h"
 #include "Salsa.h"
 #include "MemUtils.h"
-#if defined(__AVX2__)
+#if defined(__AVX512__)
+#	include "UInt512.h"
+#elif defined(__AVX2__)
 #	include "UInt256.h"
 #elif defined(__AVX__)
 #	include "UInt128.h"
@@ -164,6 +166,19 @@ void Salsa20::Reset()
 	m_ctrVector[1] = 0;
 }
 
+void Salsa20::Seek(ulong Position)
+{
+	CexAssert(m_isInitialized, "The cipher has not been initialized!");
+
+	if (Position % BLOCK_SIZE != 0)
+		throw CryptoSymmetricCipherException("Salsa20:Seek", "The position must be aligned to the block size!");
+
+	// the 64bit block counter starts at zero
+	const ulong BLKCTR = Position / BLOCK_SIZE;
+	m_ctrVector[0] = static_cast<uint>(BLKCTR);
+	m_ctrVector[1] = static_cast<uint>(BLKCTR >> 32);
+}
+
 void Salsa20::TransformBlock(const std::vector<byte> &Input, std::vector<byte> &Output)
 {
 	Process(Input, 0, Output, 0, BLOCK_SIZE);
@@ -179,6 +194,32 @@ void Salsa20::Transform(const std::vector<byte> &Input, const size_t InOffset, s
 	Process(Input, InOffset, Output, OutOffset, Length);
 }
 
+void Salsa20::Transform(ulong Position, const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset, const size_t Length)
+{
+	CexAssert(m_isInitialized, "The cipher has not been initialized!");
+	CexAssert(IntUtils::Min(Input.size() - InOffset, Output.size() - OutOffset) >= Length, "The data arrays are smaller than the length!");
+
+	const size_t BLKOFF = static_cast<size_t>(Position % BLOCK_SIZE);
+	size_t prcLen = 0;
+
+	Seek(Position - BLKOFF);
+
+	if (BLKOFF != 0)
+	{
+		// unaligned position; xor the tail of the leading key-stream block
+		std::vector<byte> tmpBlk(BLOCK_SIZE);
+		Salsa::SalsaTransform512(tmpBlk, 0, m_ctrVector, m_wrkState, m_rndCount);
+		IntUtils::LeIncrementW(m_ctrVector);
+		prcLen = IntUtils::Min(BLOCK_SIZE - BLKOFF, Length);
+
+		for (size_t i = 0; i < prcLen; ++i)
+			Output[OutOffset + i] = Input[InOffset + i] ^ tmpBlk[BLKOFF + i];
+	}
+
+	if (prcLen != Length)
+		Process(Input, InOffset + prcLen, Output, OutOffset + prcLen, Length - prcLen);
+}
+
 //~~~Private Functions~~~//
 
 void Salsa20::Expand(const std::vector<byte> &Key, const std::vector<byte> &Iv)
@@ -219,17 +260,47 @@ void Salsa20::Expand(const std::vector<byte> &Key, const std::vector<byte> &Iv)
 	}
 }
 
-void Salsa20::Generate(std::vector<byte> &Output, const size_t OutOffset, std::vector<uint> &Counter, const size_t Length)
+void Salsa20::Generate(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset, std::vector<uint> &Counter, const size_t Length, bool NonTemporal)
 {
 	size_t ctr = 0;
 
-#if defined(__AVX2__)
+#if defined(__AVX512__)
+	const size_t AVX512BLK = 16 * BLOCK_SIZE;
+
+	if (Length >= AVX512BLK)
+	{
+		size_t paln = Length - (Length % AVX512BLK);
+		std::vector<uint> ctrBlk(32);
+		const bool NTSTORE = NonTemporal && (reinterpret_cast<size_t>(&Output[OutOffset]) % sizeof(__m512i) == 0);
+
+		// process 16 blocks with avx512
+		while (ctr != paln)
+		{
+			for (size_t i = 0; i < 16; ++i)
+			{
+				ctrBlk[i] = Counter[0];
+				ctrBlk[i + 16] = Counter[1];
+				IntUtils::LeIncrementW(Counter);
+			}
+
+			Salsa::SalsaTransformW<Numeric::UInt512>(Input, InOffset + ctr, Output, OutOffset + ctr, ctrBlk, m_wrkState, m_rndCount, NTSTORE);
+			ctr += AVX512BLK;
+		}
+
+		if (NTSTORE)
+		{
+			_mm_sfence();
+		}
+	}
+#elif defined(__AVX2__)
 	const size_t AVX2BLK = 8 * BLOCK_SIZE;
 
 	if (Length >= AVX2BLK)
 	{
 		size_t paln = Length - (Length % AVX2BLK);
 		std::vector<uint> ctrBlk(16);
+		// streaming stores require a register aligned output
+		const bool NTSTORE = NonTemporal && (reinterpret_cast<size_t>(&Output[OutOffset]) % sizeof(__m256i) == 0);
 
 		// process 8 blocks (uses avx if available)
 		while (ctr != paln)
@@ -258,9 +329,14 @@ void Salsa20::Generate(std::vector<byte> &Output, const size_t OutOffset, std::v
 			Utility::MemUtils::Copy(Counter, 0, ctrBlk, 7, 4);
 			Utility::MemUtils::Copy(Counter, 1, ctrBlk, 15, 4);
 			IntUtils::LeIncrementW(Counter);
-			Salsa::SalsaTransformW<Numeric::UInt256>(Output, OutOffset + ctr, ctrBlk, m_wrkState, m_rndCount);
+			Salsa::SalsaTransformW<Numeric::UInt256>(Input, InOffset + ctr, Output, OutOffset + ctr, ctrBlk, m_wrkState, m_rndCount, NTSTORE);
 			ctr += AVX2BLK;
 		}
+
+		if (NTSTORE)
+		{
+			_mm_sfence();
+		}
 	}
 #elif defined(__AVX__)
 	const size_t AVXBLK = 4 * BLOCK_SIZE;
@@ -269,6 +345,7 @@ void Salsa20::Generate(std::vector<byte> &Output, const size_t OutOffset, std::v
 	{
 		size_t paln = Length - (Length % AVXBLK);
 		std::vector<uint> ctrBlk(8);
+		const bool NTSTORE = NonTemporal && (reinterpret_cast<size_t>(&Output[OutOffset]) % sizeof(__m128i) == 0);
 
 		// process 4 blocks (uses sse intrinsics if available)
 		while (ctr != paln)
@@ -285,27 +362,43 @@ void Salsa20::Generate(std::vector<byte> &Output, const size_t OutOffset, std::v
 			Utility::MemUtils::Copy(Counter, 0, ctrBlk, 3, 4);
 			Utility::MemUtils::Copy(Counter, 1, ctrBlk, 7, 4);
 			IntUtils::LeIncrementW(Counter);
-			Salsa::SalsaTransformW<Numeric::UInt128>(Output, OutOffset + ctr, ctrBlk, m_wrkState, m_rndCount);
+			Salsa::SalsaTransformW<Numeric::UInt128>(Input, InOffset + ctr, Output, OutOffset + ctr, ctrBlk, m_wrkState, m_rndCount, NTSTORE);
 			ctr += AVXBLK;
 		}
-	}
-#endif
 
-	const size_t ALNSZE = Length - (Length % BLOCK_SIZE);
-	while (ctr != ALNSZE)
-	{
-		Salsa::SalsaTransform512(Output, OutOffset + ctr, Counter, m_wrkState, m_rndCount);
-		IntUtils::LeIncrementW(Counter);
-		ctr += BLOCK_SIZE;
+		if (NTSTORE)
+		{
+			_mm_sfence();
+		}
 	}
+#endif
 
 	if (ctr != Length)
 	{
+		// the key-stream block is xored in a temporary so that the input and output arrays can be the same
 		std::vector<byte> outputBlock(BLOCK_SIZE, 0);
-		Salsa::SalsaTransform512(outputBlock, 0, Counter, m_wrkState, m_rndCount);
-		const size_t FNLSZE = Length % BLOCK_SIZE;
-		Utility::MemUtils::Copy(outputBlock, 0, Output, OutOffset + (Length - FNLSZE), FNLSZE);
-		IntUtils::LeIncrementW(Counter);
+		const size_t ALNSZE = Length - (Length % BLOCK_SIZE);
+
+		while (ctr != ALNSZE)
+		{
+			Salsa::SalsaTransform512(outputBlock, 0, Counter, m_wrkState, m_rndCount);
+			Utility::MemUtils::XorBlock(Input, InOffset + ctr, outputBlock, 0, BLOCK_SIZE);
+			Utility::MemUtils::Copy(outputBlock, 0, Output, OutOffset + ctr, BLOCK_SIZE);
+			IntUtils::LeIncrementW(Counter);
+			ctr += BLOCK_SIZE;
+		}
+
+		if (ctr != Length)
+		{
+			Salsa::SalsaTransform512(outputBlock, 0, Counter, m_wrkState, m_rndCount);
+
+			for (size_t i = 0; i < Length - ALNSZE; ++i)
+			{
+				Output[OutOffset + ctr + i] = Input[InOffset + ctr + i] ^ outputBlock[i];
+			}
+
+			IntUtils::LeIncrementW(Counter);
+		}
 	}
 }
 
@@ -315,20 +408,8 @@ void Salsa20::Process(const std::vector<byte> &Input, const size_t InOffset, std
 
 	if (!m_parallelProfile.IsParallel() || PRCSZE < m_parallelProfile.ParallelMinimumSize())
 	{
-		// generate random
-		Generate(Output, OutOffset, m_ctrVector, PRCSZE);
-		// output is input xor random
-		const size_t ALNSZE = PRCSZE - (PRCSZE % BLOCK_SIZE);
-
-		if (ALNSZE != 0)
-			Utility::MemUtils::XorBlock(Input, InOffset, Output, OutOffset, ALNSZE);
-
-		// get the remaining bytes
-		if (ALNSZE != PRCSZE)
-		{
-			for (size_t i = ALNSZE; i < PRCSZE; ++i)
-				Output[i + OutOffset] ^= Input[i + InOffset];
-		}
+		// generate the key-stream and xor it with the input in a single pass
+		Generate(Input, InOffset, Output, OutOffset, m_ctrVector, PRCSZE, PRCSZE >= NTSTORE_SIZE);
 	}
 	else
 	{
@@ -336,18 +417,17 @@ void Salsa20::Process(const std::vector<byte> &Input, const size_t InOffset, std
 		const size_t CNKSZE = (PRCSZE / BLOCK_SIZE / m_parallelProfile.ParallelMaxDegree()) * BLOCK_SIZE;
 		const size_t RNDSZE = CNKSZE * m_parallelProfile.ParallelMaxDegree();
 		const size_t CTRLEN = (CNKSZE / BLOCK_SIZE);
+		const bool NTSTORE = PRCSZE >= NTSTORE_SIZE;
 		std::vector<uint> tmpCtr(m_ctrVector.size());
 
-		Utility::ParallelUtils::ParallelFor(0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset, &Output, OutOffset, &tmpCtr, CNKSZE, CTRLEN](size_t i)
+		Utility::ParallelUtils::ParallelFor(0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset, &Output, OutOffset, &tmpCtr, CNKSZE, CTRLEN, NTSTORE](size_t i)
 		{
 			// thread level counter
 			std::vector<uint> thdCtr(m_ctrVector.size());
 			// offset counter by chunk size / block size
 			IntUtils::LeIncreaseW(m_ctrVector, thdCtr, CTRLEN * i);
-			// create random at offset position
-			this->Generate(Output, OutOffset + (i * CNKSZE), thdCtr, CNKSZE);
-			// xor with input at offset
-			Utility::MemUtils::XorBlock(Input, InOffset + (i * CNKSZE), Output, OutOffset + (i * CNKSZE), CNKSZE);
+			// create the key-stream at offset position and xor with input
+			this->Generate(Input, InOffset + (i * CNKSZE), Output, OutOffset + (i * CNKSZE), thdCtr, CNKSZE, NTSTORE);
 			// store last counter
 			if (i == m_parallelProfile.ParallelMaxDegree() - 1)
 				Utility::MemUtils::Copy(thdCtr, 0, tmpCtr, 0, CTR_SIZE);
@@ -360,10 +440,7 @@ void Salsa20::Process(const std::vector<byte> &Input, const size_t InOffset, std
 		if (RNDSZE < PRCSZE)
 		{
 			const size_t FNLSZE = PRCSZE % RNDSZE;
-			Generate(Output, RNDSZE, m_ctrVector, FNLSZE);
-
-			for (size_t i = 0; i < FNLSZE; ++i)
-				Output[i + OutOffset + RNDSZE] ^= (byte)(Input[i + InOffset + RNDSZE]);
+			Generate(Input, InOffset + RNDSZE, Output, OutOffset + RNDSZE, m_ctrVector, FNLSZE, false);
 		}
 	}
 }
@@ -76,7 +76,7 @@ NAMESPACE_STREAM
 /// <item><description>Valid Key sizes are 128, 256 (16 and 32 bytes).</description></item>
 /// <item><description>Block size is 64 bytes wide.</description></item>
 /// <item><description>Valid rounds are 8 through 80 in increments of 2, the default is 20 rounds.</description></item>
-/// <item><description>Encryption can both be pipelined (SSE3-128 or AVX2-256), and multi-threaded.</description></item>
+/// <item><description>Encryption can both be pipelined (SSE3-128, AVX2-256, or AVX512-512), and multi-threaded.</description></item>
 /// <item><description>The Transform functions are virtual, and can be accessed from an ICipherMode instance.</description></item>
 /// <item><description>The transformation methods can not be called until the Initialize(SymmetricKey) function has been called.</description></item>
 /// <item><description>If the system supports Parallel processing, IsParallel() is set to true; passing an input block of ParallelBlockSize() to the transform.</description></item>
@@ -84,6 +84,8 @@ NAMESPACE_STREAM
 /// <item><description>ParallelBlockSize() is calculated automatically based on processor(s) cache size but can be user defined, but must be evenly divisible by ParallelMinimumSize().</description></item>
 /// <item><description>The ParallelBlockSize() can be changed through the ParallelProfile() property</description></item>
 /// <item><description>Parallel block calculation ex. <c>ParallelBlockSize = N - (N % .ParallelMinimumSize);</c></description></item>
+/// <item><description>The key-stream is randomly accessible; Seek(ulong) sets the counter to a block aligned position, and the positional Transform(ulong, ...) processes data starting at any byte offset within the stream.</description></item>
+/// <item><description>The key-stream is xored with the input as the wide transform stores each block, so the output is written in a single pass; outputs of 4MB or more are written with non-temporal stores when the output is register aligned.</description></item>
 /// </list>
 /// 
 /// <description>Guiding Publications:</description>
@@ -103,6 +105,8 @@ private:
 	static const size_t CTR_SIZE = 8;
 	static const size_t MAX_ROUNDS = 80;
 	static const size_t MIN_ROUNDS = 8;
+	// outputs of this size or larger are written with non-temporal stores
+	static const size_t NTSTORE_SIZE = 1024 * 1024 * 4;
 	static const size_t STATE_PRECACHED = 2048;
 	static const std::string SIGMA_INFO;
 	static const std::string TAU_INFO;
@@ -239,6 +243,18 @@ public:
 	/// <exception cref="Exception::CryptoCipherModeException">Thrown if an invalid degree setting is used</exception>
 	void ParallelMaxDegree(size_t Degree) override;
 
+	/// <summary>
+	/// Set the key-stream position.
+	/// <para>The counter is calculated directly from the position, the next transform call begins at the Position byte of the key-stream.
+	/// The position must be a multiple of the block size, use the positional Transform(ulong, ...) function to access an unaligned offset.
+	/// Initialize(ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	///
+	/// <param name="Position">The block aligned byte offset within the key-stream</param>
+	///
+	/// <exception cref="Exception::CryptoSymmetricCipherException">Thrown if the position is not block aligned</exception>
+	void Seek(ulong Position);
+
 	/// <summary>
 	/// Encrypt/Decrypt one block of bytes
 	/// </summary>
@@ -269,10 +285,25 @@ public:
 	/// <param name="Length">Number of bytes to process</param>
 	void Transform(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset, const size_t Length) override;
 
+	/// <summary>
+	/// Transform a length of bytes beginning at a key-stream position.
+	/// <para>Random access transform; the counter is set to the block containing Position, and a partial leading block is aligned to the offset.
+	/// Processing continues with the standard Transform, the counter is left positioned after the last processed block.
+	/// Initialize(ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	///
+	/// <param name="Position">The byte offset within the key-stream corresponding to the first input byte</param>
+	/// <param name="Input">The input array of bytes to transform</param>
+	/// <param name="InOffset">Starting offset within the input array</param>
+	/// <param name="Output">The output array of transformed bytes</param>
+	/// <param name="OutOffset">Starting offset within the output array</param>
+	/// <param name="Length">Number of bytes to process</param>
+	void Transform(ulong Position, const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset, const size_t Length);
+
 private:
 
 	void Expand(const std::vector<byte> &Key, const std::vector<byte> &Iv);
-	void Generate(std::vector<byte> &Output, const size_t OutOffset, std::vector<uint> &Counter, const size_t Length);
+	void Generate(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset, std::vector<uint> &Counter, const size_t Length, bool NonTemporal);
 	void Process(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset, const size_t Length);
 	void Reset();
 	void Scope();
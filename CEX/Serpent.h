@@ -20,6 +20,16 @@
 #define CEX_SERPENT_H
 
 #include "CexDomain.h"
+#include "IntUtils.h"
+#if defined(__AVX__)
+#	include "UInt128.h"
+#endif
+#if defined(__AVX2__)
+#	include "UInt256.h"
+#endif
+#if defined(__AVX512__)
+#	include "UInt512.h"
+#endif
 
 NAMESPACE_BLOCK
 
@@ -27,202 +37,6 @@ NAMESPACE_BLOCK
 * \internal
 */
 
-template<typename T>
-void SHXDecryptW(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset, std::vector<uint> &Key)
-{
-#if defined(__AVX__)
-
-	const size_t FNLRND = 4;
-	const size_t INPOFF = T::size();
-	size_t keyCtr = Key.size();
-
-	// input round
-	T R0(Input, InOffset);
-	T R1(Input, InOffset + INPOFF);
-	T R2(Input, InOffset + (INPOFF * 2));
-	T R3(Input, InOffset + (INPOFF * 3));
-	T::Transpose(R0, R1, R2, R3);
-
-	R3 ^= T(Key[--keyCtr]);
-	R2 ^= T(Key[--keyCtr]);
-	R1 ^= T(Key[--keyCtr]);
-	R0 ^= T(Key[--keyCtr]);
-
-	// process 8 round blocks
-	do
-	{
-		Ib7(R0, R1, R2, R3);
-		R3 ^= T(Key[--keyCtr]);
-		R2 ^= T(Key[--keyCtr]);
-		R1 ^= T(Key[--keyCtr]);
-		R0 ^= T(Key[--keyCtr]);
-		InverseTransformW(R0, R1, R2, R3);
-
-		Ib6(R0, R1, R2, R3);
-		R3 ^= T(Key[--keyCtr]);
-		R2 ^= T(Key[--keyCtr]);
-		R1 ^= T(Key[--keyCtr]);
-		R0 ^= T(Key[--keyCtr]);
-		InverseTransformW(R0, R1, R2, R3);
-
-		Ib5(R0, R1, R2, R3);
-		R3 ^= T(Key[--keyCtr]);
-		R2 ^= T(Key[--keyCtr]);
-		R1 ^= T(Key[--keyCtr]);
-		R0 ^= T(Key[--keyCtr]);
-		InverseTransformW(R0, R1, R2, R3);
-
-		Ib4(R0, R1, R2, R3);
-		R3 ^= T(Key[--keyCtr]);
-		R2 ^= T(Key[--keyCtr]);
-		R1 ^= T(Key[--keyCtr]);
-		R0 ^= T(Key[--keyCtr]);
-		InverseTransformW(R0, R1, R2, R3);
-
-		Ib3(R0, R1, R2, R3);
-		R3 ^= T(Key[--keyCtr]);
-		R2 ^= T(Key[--keyCtr]);
-		R1 ^= T(Key[--keyCtr]);
-		R0 ^= T(Key[--keyCtr]);
-		InverseTransformW(R0, R1, R2, R3);
-
-		Ib2(R0, R1, R2, R3);
-		R3 ^= T(Key[--keyCtr]);
-		R2 ^= T(Key[--keyCtr]);
-		R1 ^= T(Key[--keyCtr]);
-		R0 ^= T(Key[--keyCtr]);
-		InverseTransformW(R0, R1, R2, R3);
-
-		Ib1(R0, R1, R2, R3);
-		R3 ^= T(Key[--keyCtr]);
-		R2 ^= T(Key[--keyCtr]);
-		R1 ^= T(Key[--keyCtr]);
-		R0 ^= T(Key[--keyCtr]);
-		InverseTransformW(R0, R1, R2, R3);
-
-		Ib0(R0, R1, R2, R3);
-
-		// skip on last block
-		if (keyCtr != FNLRND)
-		{
-			R3 ^= T(Key[--keyCtr]);
-			R2 ^= T(Key[--keyCtr]);
-			R1 ^= T(Key[--keyCtr]);
-			R0 ^= T(Key[--keyCtr]);
-			InverseTransformW(R0, R1, R2, R3);
-		}
-	} while (keyCtr != FNLRND);
-
-	// last round
-	R3 ^= T(Key[--keyCtr]);
-	R2 ^= T(Key[--keyCtr]);
-	R1 ^= T(Key[--keyCtr]);
-	R0 ^= T(Key[--keyCtr]);
-
-	T::Transpose(R0, R1, R2, R3);
-	R0.Store(Output, OutOffset);
-	R1.Store(Output, OutOffset + INPOFF);
-	R2.Store(Output, OutOffset + (INPOFF * 2));
-	R3.Store(Output, OutOffset + (INPOFF * 3));
-
-#endif
-}
-
-template<typename T>
-void SHXEncryptW(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset, std::vector<uint> &Key)
-{
-#if defined(__AVX__)
-
-	const size_t FNLRND = Key.size() - 5;
-	const size_t INPOFF = T::size();
-	int keyCtr = -1;
-
-	// input round
-	T R0(Input, InOffset);
-	T R1(Input, InOffset + INPOFF);
-	T R2(Input, InOffset + (INPOFF * 2));
-	T R3(Input, InOffset + (INPOFF * 3));
-	T::Transpose(R0, R1, R2, R3);
-
-	// process 8 round blocks
-	do
-	{
-		R0 ^= T(Key[++keyCtr]);
-		R1 ^= T(Key[++keyCtr]);
-		R2 ^= T(Key[++keyCtr]);
-		R3 ^= T(Key[++keyCtr]);
-		Sb0(R0, R1, R2, R3);
-		LinearTransformW(R0, R1, R2, R3);
-
-		R0 ^= T(Key[++keyCtr]);
-		R1 ^= T(Key[++keyCtr]);
-		R2 ^= T(Key[++keyCtr]);
-		R3 ^= T(Key[++keyCtr]);
-		Sb1(R0, R1, R2, R3);
-		LinearTransformW(R0, R1, R2, R3);
-
-		R0 ^= T(Key[++keyCtr]);
-		R1 ^= T(Key[++keyCtr]);
-		R2 ^= T(Key[++keyCtr]);
-		R3 ^= T(Key[++keyCtr]);
-		Sb2(R0, R1, R2, R3);
-		LinearTransformW(R0, R1, R2, R3);
-
-		R0 ^= T(Key[++keyCtr]);
-		R1 ^= T(Key[++keyCtr]);
-		R2 ^= T(Key[++keyCtr]);
-		R3 ^= T(Key[++keyCtr]);
-		Sb3(R0, R1, R2, R3);
-		LinearTransformW(R0, R1, R2, R3);
-
-		R0 ^= T(Key[++keyCtr]);
-		R1 ^= T(Key[++keyCtr]);
-		R2 ^= T(Key[++keyCtr]);
-		R3 ^= T(Key[++keyCtr]);
-		Sb4(R0, R1, R2, R3);
-		LinearTransformW(R0, R1, R2, R3);
-
-		R0 ^= T(Key[++keyCtr]);
-		R1 ^= T(Key[++keyCtr]);
-		R2 ^= T(Key[++keyCtr]);
-		R3 ^= T(Key[++keyCtr]);
-		Sb5(R0, R1, R2, R3);
-		LinearTransformW(R0, R1, R2, R3);
-
-		R0 ^= T(Key[++keyCtr]);
-		R1 ^= T(Key[++keyCtr]);
-		R2 ^= T(Key[++keyCtr]);
-		R3 ^= T(Key[++keyCtr]);
-		Sb6(R0, R1, R2, R3);
-		LinearTransformW(R0, R1, R2, R3);
-
-		R0 ^= T(Key[++keyCtr]);
-		R1 ^= T(Key[++keyCtr]);
-		R2 ^= T(Key[++keyCtr]);
-		R3 ^= T(Key[++keyCtr]);
-		Sb7(R0, R1, R2, R3);
-
-		// skip on last block
-		if (keyCtr != FNLRND)
-			LinearTransformW(R0, R1, R2, R3);
-	} 
-	while (keyCtr != FNLRND);
-
-	// last round
-	R0 ^= T(Key[++keyCtr]);
-	R1 ^= T(Key[++keyCtr]);
-	R2 ^= T(Key[++keyCtr]);
-	R3 ^= T(Key[++keyCtr]);
-
-	T::Transpose(R0, R1, R2, R3);
-	R0.Store(Output, OutOffset);
-	R1.Store(Output, OutOffset + INPOFF);
-	R2.Store(Output, OutOffset + (INPOFF * 2));
-	R3.Store(Output, OutOffset + (INPOFF * 3));
-
-#endif
-}
-
 template<typename T>
 void LinearTransform(T &R0, T &R1, T &R2, T &R3)
 {
@@ -714,5 +528,517 @@ static void Ib7(T &R0, T &R1, T &R2, T &R3)
 	R3 = B4;
 }
 
+#if defined(__AVX512__)
+
+//~~~Serpent AVX-512 S-Boxes~~~//
+
+// the 16 block S-Boxes evaluate each output bit-slice with the vpternlogd three-input logic instruction;
+// the truth tables are derived from the boolean networks above, sharing the intermediate terms between outputs,
+// which reduces each S-Box from 14-19 logical operations to 8-11 instructions
+
+inline void Sb0(Numeric::UInt512 &R0, Numeric::UInt512 &R1, Numeric::UInt512 &R2, Numeric::UInt512 &R3)
+{
+	const __m512i X0 = R0.zmm;
+	const __m512i X1 = R1.zmm;
+	const __m512i X2 = R2.zmm;
+	const __m512i X3 = R3.zmm;
+	const __m512i T0 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x66);
+	const __m512i T1 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x1A);
+	const __m512i T2 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x28);
+	const __m512i T3 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x13);
+	const __m512i T4 = _mm512_ternarylogic_epi32(X0, X2, X3, 0x61);
+	const __m512i T5 = _mm512_ternarylogic_epi32(X1, X2, X3, 0x7A);
+
+	R0.zmm = _mm512_ternarylogic_epi32(T2, T1, X3, 0xC9);
+	R1.zmm = _mm512_ternarylogic_epi32(T4, T3, X0, 0x74);
+	R2.zmm = _mm512_ternarylogic_epi32(T5, T1, X0, 0xD2);
+	R3.zmm = _mm512_ternarylogic_epi32(T0, X3, X0, 0x1E);
+}
+
+inline void Sb1(Numeric::UInt512 &R0, Numeric::UInt512 &R1, Numeric::UInt512 &R2, Numeric::UInt512 &R3)
+{
+	const __m512i X0 = R0.zmm;
+	const __m512i X1 = R1.zmm;
+	const __m512i X2 = R2.zmm;
+	const __m512i X3 = R3.zmm;
+	const __m512i T0 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x0C);
+	const __m512i T1 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x39);
+	const __m512i T2 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x4B);
+	const __m512i T3 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x1A);
+	const __m512i T4 = _mm512_ternarylogic_epi32(X0, X1, X3, 0x18);
+	const __m512i T5 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x18);
+	const __m512i T6 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x6C);
+
+	R0.zmm = _mm512_ternarylogic_epi32(T2, T1, X3, 0xD8);
+	R1.zmm = _mm512_ternarylogic_epi32(T4, T3, X3, 0xA9);
+	R2.zmm = _mm512_ternarylogic_epi32(T0, X3, X2, 0x69);
+	R3.zmm = _mm512_ternarylogic_epi32(T6, T5, X3, 0x2D);
+}
+
+inline void Sb2(Numeric::UInt512 &R0, Numeric::UInt512 &R1, Numeric::UInt512 &R2, Numeric::UInt512 &R3)
+{
+	const __m512i X0 = R0.zmm;
+	const __m512i X1 = R1.zmm;
+	const __m512i X2 = R2.zmm;
+	const __m512i X3 = R3.zmm;
+	const __m512i T0 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x0A);
+	const __m512i T1 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x16);
+	const __m512i T2 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x3A);
+	const __m512i T3 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x5B);
+	const __m512i T4 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x06);
+	const __m512i T5 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x4B);
+
+	R0.zmm = _mm512_ternarylogic_epi32(T0, X3, X1, 0x96);
+	R1.zmm = _mm512_ternarylogic_epi32(T3, T2, X3, 0x4B);
+	R2.zmm = _mm512_ternarylogic_epi32(T5, T4, X3, 0x2D);
+	R3.zmm = _mm512_ternarylogic_epi32(T1, X3, X1, 0x87);
+}
+
+inline void Sb3(Numeric::UInt512 &R0, Numeric::UInt512 &R1, Numeric::UInt512 &R2, Numeric::UInt512 &R3)
+{
+	const __m512i X0 = R0.zmm;
+	const __m512i X1 = R1.zmm;
+	const __m512i X2 = R2.zmm;
+	const __m512i X3 = R3.zmm;
+	const __m512i T0 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x39);
+	const __m512i T1 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x4B);
+	const __m512i T2 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x3A);
+	const __m512i T3 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x59);
+	const __m512i T4 = _mm512_ternarylogic_epi32(X0, X1, X3, 0x6D);
+	const __m512i T5 = _mm512_ternarylogic_epi32(X1, X2, X3, 0x34);
+
+	R0.zmm = _mm512_ternarylogic_epi32(T1, T0, X3, 0x8D);
+	R1.zmm = _mm512_ternarylogic_epi32(T3, T2, X3, 0x4B);
+	R2.zmm = _mm512_ternarylogic_epi32(T4, T2, X2, 0x87);
+	R3.zmm = _mm512_ternarylogic_epi32(T5, T4, X3, 0x53);
+}
+
+inline void Sb4(Numeric::UInt512 &R0, Numeric::UInt512 &R1, Numeric::UInt512 &R2, Numeric::UInt512 &R3)
+{
+	const __m512i X0 = R0.zmm;
+	const __m512i X1 = R1.zmm;
+	const __m512i X2 = R2.zmm;
+	const __m512i X3 = R3.zmm;
+	const __m512i T0 = _mm512_ternarylogic_epi32(X0, X1, X3, 0x24);
+	const __m512i T1 = _mm512_ternarylogic_epi32(X0, X1, X3, 0x58);
+	const __m512i T2 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x17);
+	const __m512i T3 = _mm512_ternarylogic_epi32(X0, X1, X3, 0x6D);
+	const __m512i T4 = _mm512_ternarylogic_epi32(X0, X2, X3, 0x34);
+
+	R0.zmm = _mm512_ternarylogic_epi32(T0, X3, X2, 0x69);
+	R1.zmm = _mm512_ternarylogic_epi32(T3, T2, X2, 0x35);
+	R2.zmm = _mm512_ternarylogic_epi32(T4, T0, X1, 0x56);
+	R3.zmm = _mm512_ternarylogic_epi32(T1, X2, X1, 0x1E);
+}
+
+inline void Sb5(Numeric::UInt512 &R0, Numeric::UInt512 &R1, Numeric::UInt512 &R2, Numeric::UInt512 &R3)
+{
+	const __m512i X0 = R0.zmm;
+	const __m512i X1 = R1.zmm;
+	const __m512i X2 = R2.zmm;
+	const __m512i X3 = R3.zmm;
+	const __m512i T0 = _mm512_ternarylogic_epi32(X0, X1, X3, 0x24);
+	const __m512i T1 = _mm512_ternarylogic_epi32(X0, X1, X3, 0x38);
+	const __m512i T2 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x2C);
+	const __m512i T3 = _mm512_ternarylogic_epi32(X1, X2, X3, 0x18);
+	const __m512i T4 = _mm512_ternarylogic_epi32(X0, X2, X3, 0x76);
+
+	R0.zmm = _mm512_ternarylogic_epi32(T0, X3, X2, 0x69);
+	R1.zmm = _mm512_ternarylogic_epi32(T1, X3, X2, 0xE1);
+	R2.zmm = _mm512_ternarylogic_epi32(T3, T2, X3, 0xA9);
+	R3.zmm = _mm512_ternarylogic_epi32(T4, T2, X1, 0xE1);
+}
+
+inline void Sb6(Numeric::UInt512 &R0, Numeric::UInt512 &R1, Numeric::UInt512 &R2, Numeric::UInt512 &R3)
+{
+	const __m512i X0 = R0.zmm;
+	const __m512i X1 = R1.zmm;
+	const __m512i X2 = R2.zmm;
+	const __m512i X3 = R3.zmm;
+	const __m512i T0 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x66);
+	const __m512i T1 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x36);
+	const __m512i T2 = _mm512_ternarylogic_epi32(X0, X2, X3, 0x24);
+	const __m512i T3 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x2E);
+	const __m512i T4 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x43);
+	const __m512i T5 = _mm512_ternarylogic_epi32(X1, X2, X3, 0x62);
+
+	R0.zmm = _mm512_ternarylogic_epi32(T2, T1, X3, 0xA9);
+	R1.zmm = _mm512_ternarylogic_epi32(T0, X3, X0, 0x87);
+	R2.zmm = _mm512_ternarylogic_epi32(T4, T3, X3, 0xB4);
+	R3.zmm = _mm512_ternarylogic_epi32(T5, T3, X0, 0x34);
+}
+
+inline void Sb7(Numeric::UInt512 &R0, Numeric::UInt512 &R1, Numeric::UInt512 &R2, Numeric::UInt512 &R3)
+{
+	const __m512i X0 = R0.zmm;
+	const __m512i X1 = R1.zmm;
+	const __m512i X2 = R2.zmm;
+	const __m512i X3 = R3.zmm;
+	const __m512i T0 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x46);
+	const __m512i T1 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x2B);
+	const __m512i T2 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x41);
+	const __m512i T3 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x1E);
+	const __m512i T4 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x6F);
+	const __m512i T5 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x16);
+	const __m512i T6 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x62);
+
+	R0.zmm = _mm512_ternarylogic_epi32(T2, T1, X3, 0xC9);
+	R1.zmm = _mm512_ternarylogic_epi32(T4, T3, X3, 0x63);
+	R2.zmm = _mm512_ternarylogic_epi32(T6, T5, X3, 0x4E);
+	R3.zmm = _mm512_ternarylogic_epi32(T0, X3, X0, 0xD2);
+}
+
+inline void Ib0(Numeric::UInt512 &R0, Numeric::UInt512 &R1, Numeric::UInt512 &R2, Numeric::UInt512 &R3)
+{
+	const __m512i X0 = R0.zmm;
+	const __m512i X1 = R1.zmm;
+	const __m512i X2 = R2.zmm;
+	const __m512i X3 = R3.zmm;
+	const __m512i T0 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x03);
+	const __m512i T1 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x1C);
+	const __m512i T2 = _mm512_ternarylogic_epi32(X1, X2, X3, 0x2B);
+	const __m512i T3 = _mm512_ternarylogic_epi32(X0, X2, X3, 0x7C);
+	const __m512i T4 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x38);
+	const __m512i T5 = _mm512_ternarylogic_epi32(X0, X2, X3, 0x18);
+
+	R0.zmm = _mm512_ternarylogic_epi32(T2, T1, X3, 0x74);
+	R1.zmm = _mm512_ternarylogic_epi32(T3, T2, X1, 0xD2);
+	R2.zmm = _mm512_ternarylogic_epi32(T0, X3, X2, 0x96);
+	R3.zmm = _mm512_ternarylogic_epi32(T5, T4, X3, 0xA9);
+}
+
+inline void Ib1(Numeric::UInt512 &R0, Numeric::UInt512 &R1, Numeric::UInt512 &R2, Numeric::UInt512 &R3)
+{
+	const __m512i X0 = R0.zmm;
+	const __m512i X1 = R1.zmm;
+	const __m512i X2 = R2.zmm;
+	const __m512i X3 = R3.zmm;
+	const __m512i T0 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x5A);
+	const __m512i T1 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x0B);
+	const __m512i T2 = _mm512_ternarylogic_epi32(X1, X2, X3, 0x67);
+	const __m512i T3 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x0D);
+	const __m512i T4 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x14);
+	const __m512i T5 = _mm512_ternarylogic_epi32(X0, X2, X3, 0x1A);
+
+	R0.zmm = _mm512_ternarylogic_epi32(T2, T1, X1, 0x65);
+	R1.zmm = _mm512_ternarylogic_epi32(T4, T3, X3, 0xC9);
+	R2.zmm = _mm512_ternarylogic_epi32(T5, T1, X1, 0x2D);
+	R3.zmm = _mm512_ternarylogic_epi32(T0, X3, X1, 0xB4);
+}
+
+inline void Ib2(Numeric::UInt512 &R0, Numeric::UInt512 &R1, Numeric::UInt512 &R2, Numeric::UInt512 &R3)
+{
+	const __m512i X0 = R0.zmm;
+	const __m512i X1 = R1.zmm;
+	const __m512i X2 = R2.zmm;
+	const __m512i X3 = R3.zmm;
+	const __m512i T0 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x1E);
+	const __m512i T1 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x3A);
+	const __m512i T2 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x59);
+	const __m512i T3 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x39);
+	const __m512i T4 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x5C);
+	const __m512i T5 = _mm512_ternarylogic_epi32(X0, X2, X3, 0x29);
+
+	R0.zmm = _mm512_ternarylogic_epi32(T0, X3, X1, 0x78);
+	R1.zmm = _mm512_ternarylogic_epi32(T2, T1, X3, 0x87);
+	R2.zmm = _mm512_ternarylogic_epi32(T4, T3, X3, 0x36);
+	R3.zmm = _mm512_ternarylogic_epi32(T5, T1, X1, 0xB4);
+}
+
+inline void Ib3(Numeric::UInt512 &R0, Numeric::UInt512 &R1, Numeric::UInt512 &R2, Numeric::UInt512 &R3)
+{
+	const __m512i X0 = R0.zmm;
+	const __m512i X1 = R1.zmm;
+	const __m512i X2 = R2.zmm;
+	const __m512i X3 = R3.zmm;
+	const __m512i T0 = _mm512_ternarylogic_epi32(X1, X2, X3, 0x2C);
+	const __m512i T1 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x18);
+	const __m512i T2 = _mm512_ternarylogic_epi32(X0, X1, X3, 0x19);
+	const __m512i T3 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x09);
+	const __m512i T4 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x17);
+	const __m512i T5 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x21);
+	const __m512i T6 = _mm512_ternarylogic_epi32(X1, X2, X3, 0x49);
+
+	R0.zmm = _mm512_ternarylogic_epi32(T0, X3, X0, 0x1E);
+	R1.zmm = _mm512_ternarylogic_epi32(T2, T1, X2, 0xA9);
+	R2.zmm = _mm512_ternarylogic_epi32(T4, T3, X3, 0x2D);
+	R3.zmm = _mm512_ternarylogic_epi32(T6, T5, X0, 0xA9);
+}
+
+inline void Ib4(Numeric::UInt512 &R0, Numeric::UInt512 &R1, Numeric::UInt512 &R2, Numeric::UInt512 &R3)
+{
+	const __m512i X0 = R0.zmm;
+	const __m512i X1 = R1.zmm;
+	const __m512i X2 = R2.zmm;
+	const __m512i X3 = R3.zmm;
+	const __m512i T0 = _mm512_ternarylogic_epi32(X0, X2, X3, 0x76);
+	const __m512i T1 = _mm512_ternarylogic_epi32(X0, X1, X3, 0x2C);
+	const __m512i T2 = _mm512_ternarylogic_epi32(X0, X2, X3, 0x61);
+	const __m512i T3 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x7A);
+
+	R0.zmm = _mm512_ternarylogic_epi32(T2, T1, X1, 0x1E);
+	R1.zmm = _mm512_ternarylogic_epi32(T0, X1, X0, 0xD2);
+	R2.zmm = _mm512_ternarylogic_epi32(T3, T1, X3, 0xE1);
+	R3.zmm = _mm512_ternarylogic_epi32(T1, X3, X2, 0xD2);
+}
+
+inline void Ib5(Numeric::UInt512 &R0, Numeric::UInt512 &R1, Numeric::UInt512 &R2, Numeric::UInt512 &R3)
+{
+	const __m512i X0 = R0.zmm;
+	const __m512i X1 = R1.zmm;
+	const __m512i X2 = R2.zmm;
+	const __m512i X3 = R3.zmm;
+	const __m512i T0 = _mm512_ternarylogic_epi32(X0, X1, X3, 0x16);
+	const __m512i T1 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x26);
+	const __m512i T2 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x01);
+	const __m512i T3 = _mm512_ternarylogic_epi32(X0, X1, X3, 0x4A);
+	const __m512i T4 = _mm512_ternarylogic_epi32(X0, X2, X3, 0x43);
+
+	R0.zmm = _mm512_ternarylogic_epi32(T0, X2, X1, 0xD2);
+	R1.zmm = _mm512_ternarylogic_epi32(T3, T2, X2, 0x61);
+	R2.zmm = _mm512_ternarylogic_epi32(T4, T0, X1, 0x2D);
+	R3.zmm = _mm512_ternarylogic_epi32(T1, X3, X0, 0x87);
+}
+
+inline void Ib6(Numeric::UInt512 &R0, Numeric::UInt512 &R1, Numeric::UInt512 &R2, Numeric::UInt512 &R3)
+{
+	const __m512i X0 = R0.zmm;
+	const __m512i X1 = R1.zmm;
+	const __m512i X2 = R2.zmm;
+	const __m512i X3 = R3.zmm;
+	const __m512i T0 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x0A);
+	const __m512i T1 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x2F);
+	const __m512i T2 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x48);
+	const __m512i T3 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x2E);
+	const __m512i T4 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x4B);
+	const __m512i T5 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x12);
+	const __m512i T6 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x43);
+
+	R0.zmm = _mm512_ternarylogic_epi32(T2, T1, X3, 0x36);
+	R1.zmm = _mm512_ternarylogic_epi32(T0, X3, X1, 0x69);
+	R2.zmm = _mm512_ternarylogic_epi32(T4, T3, X3, 0x78);
+	R3.zmm = _mm512_ternarylogic_epi32(T6, T5, X3, 0x1E);
+}
+
+inline void Ib7(Numeric::UInt512 &R0, Numeric::UInt512 &R1, Numeric::UInt512 &R2, Numeric::UInt512 &R3)
+{
+	const __m512i X0 = R0.zmm;
+	const __m512i X1 = R1.zmm;
+	const __m512i X2 = R2.zmm;
+	const __m512i X3 = R3.zmm;
+	const __m512i T0 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x2E);
+	const __m512i T1 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x4B);
+	const __m512i T2 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x14);
+	const __m512i T3 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x2D);
+	const __m512i T4 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x35);
+	const __m512i T5 = _mm512_ternarylogic_epi32(X0, X1, X2, 0x59);
+	const __m512i T6 = _mm512_ternarylogic_epi32(X0, X1, X3, 0x68);
+
+	R0.zmm = _mm512_ternarylogic_epi32(T1, T0, X3, 0x78);
+	R1.zmm = _mm512_ternarylogic_epi32(T3, T2, X3, 0xD2);
+	R2.zmm = _mm512_ternarylogic_epi32(T5, T4, X3, 0xB4);
+	R3.zmm = _mm512_ternarylogic_epi32(T6, T0, X2, 0x78);
+}
+
+#endif
+
+//~~~Serpent Wide Transforms~~~//
+
+template<typename T>
+void SHXDecryptW(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset, std::vector<uint> &Key)
+{
+#if defined(__AVX__)
+
+	const size_t FNLRND = 4;
+	const size_t INPOFF = T::size();
+	size_t keyCtr = Key.size();
+
+	// input round
+	T R0(Input, InOffset);
+	T R1(Input, InOffset + INPOFF);
+	T R2(Input, InOffset + (INPOFF * 2));
+	T R3(Input, InOffset + (INPOFF * 3));
+	T::Transpose(R0, R1, R2, R3);
+
+	R3 ^= T(Key[--keyCtr]);
+	R2 ^= T(Key[--keyCtr]);
+	R1 ^= T(Key[--keyCtr]);
+	R0 ^= T(Key[--keyCtr]);
+
+	// process 8 round blocks
+	do
+	{
+		Ib7(R0, R1, R2, R3);
+		R3 ^= T(Key[--keyCtr]);
+		R2 ^= T(Key[--keyCtr]);
+		R1 ^= T(Key[--keyCtr]);
+		R0 ^= T(Key[--keyCtr]);
+		InverseTransformW(R0, R1, R2, R3);
+
+		Ib6(R0, R1, R2, R3);
+		R3 ^= T(Key[--keyCtr]);
+		R2 ^= T(Key[--keyCtr]);
+		R1 ^= T(Key[--keyCtr]);
+		R0 ^= T(Key[--keyCtr]);
+		InverseTransformW(R0, R1, R2, R3);
+
+		Ib5(R0, R1, R2, R3);
+		R3 ^= T(Key[--keyCtr]);
+		R2 ^= T(Key[--keyCtr]);
+		R1 ^= T(Key[--keyCtr]);
+		R0 ^= T(Key[--keyCtr]);
+		InverseTransformW(R0, R1, R2, R3);
+
+		Ib4(R0, R1, R2, R3);
+		R3 ^= T(Key[--keyCtr]);
+		R2 ^= T(Key[--keyCtr]);
+		R1 ^= T(Key[--keyCtr]);
+		R0 ^= T(Key[--keyCtr]);
+		InverseTransformW(R0, R1, R2, R3);
+
+		Ib3(R0, R1, R2, R3);
+		R3 ^= T(Key[--keyCtr]);
+		R2 ^= T(Key[--keyCtr]);
+		R1 ^= T(Key[--keyCtr]);
+		R0 ^= T(Key[--keyCtr]);
+		InverseTransformW(R0, R1, R2, R3);
+
+		Ib2(R0, R1, R2, R3);
+		R3 ^= T(Key[--keyCtr]);
+		R2 ^= T(Key[--keyCtr]);
+		R1 ^= T(Key[--keyCtr]);
+		R0 ^= T(Key[--keyCtr]);
+		InverseTransformW(R0, R1, R2, R3);
+
+		Ib1(R0, R1, R2, R3);
+		R3 ^= T(Key[--keyCtr]);
+		R2 ^= T(Key[--keyCtr]);
+		R1 ^= T(Key[--keyCtr]);
+		R0 ^= T(Key[--keyCtr]);
+		InverseTransformW(R0, R1, R2, R3);
+
+		Ib0(R0, R1, R2, R3);
+
+		// skip on last block
+		if (keyCtr != FNLRND)
+		{
+			R3 ^= T(Key[--keyCtr]);
+			R2 ^= T(Key[--keyCtr]);
+			R1 ^= T(Key[--keyCtr]);
+			R0 ^= T(Key[--keyCtr]);
+			InverseTransformW(R0, R1, R2, R3);
+		}
+	} while (keyCtr != FNLRND);
+
+	// last round
+	R3 ^= T(Key[--keyCtr]);
+	R2 ^= T(Key[--keyCtr]);
+	R1 ^= T(Key[--keyCtr]);
+	R0 ^= T(Key[--keyCtr]);
+
+	T::Transpose(R0, R1, R2, R3);
+	R0.Store(Output, OutOffset);
+	R1.Store(Output, OutOffset + INPOFF);
+	R2.Store(Output, OutOffset + (INPOFF * 2));
+	R3.Store(Output, OutOffset + (INPOFF * 3));
+
+#endif
+}
+
+template<typename T>
+void SHXEncryptW(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset, std::vector<uint> &Key)
+{
+#if defined(__AVX__)
+
+	const size_t FNLRND = Key.size() - 5;
+	const size_t INPOFF = T::size();
+	int keyCtr = -1;
+
+	// input round
+	T R0(Input, InOffset);
+	T R1(Input, InOffset + INPOFF);
+	T R2(Input, InOffset + (INPOFF * 2));
+	T R3(Input, InOffset + (INPOFF * 3));
+	T::Transpose(R0, R1, R2, R3);
+
+	// process 8 round blocks
+	do
+	{
+		R0 ^= T(Key[++keyCtr]);
+		R1 ^= T(Key[++keyCtr]);
+		R2 ^= T(Key[++keyCtr]);
+		R3 ^= T(Key[++keyCtr]);
+		Sb0(R0, R1, R2, R3);
+		LinearTransformW(R0, R1, R2, R3);
+
+		R0 ^= T(Key[++keyCtr]);
+		R1 ^= T(Key[++keyCtr]);
+		R2 ^= T(Key[++keyCtr]);
+		R3 ^= T(Key[++keyCtr]);
+		Sb1(R0, R1, R2, R3);
+		LinearTransformW(R0, R1, R2, R3);
+
+		R0 ^= T(Key[++keyCtr]);
+		R1 ^= T(Key[++keyCtr]);
+		R2 ^= T(Key[++keyCtr]);
+		R3 ^= T(Key[++keyCtr]);
+		Sb2(R0, R1, R2, R3);
+		LinearTransformW(R0, R1, R2, R3);
+
+		R0 ^= T(Key[++keyCtr]);
+		R1 ^= T(Key[++keyCtr]);
+		R2 ^= T(Key[++keyCtr]);
+		R3 ^= T(Key[++keyCtr]);
+		Sb3(R0, R1, R2, R3);
+		LinearTransformW(R0, R1, R2, R3);
+
+		R0 ^= T(Key[++keyCtr]);
+		R1 ^= T(Key[++keyCtr]);
+		R2 ^= T(Key[++keyCtr]);
+		R3 ^= T(Key[++keyCtr]);
+		Sb4(R0, R1, R2, R3);
+		LinearTransformW(R0, R1, R2, R3);
+
+		R0 ^= T(Key[++keyCtr]);
+		R1 ^= T(Key[++keyCtr]);
+		R2 ^= T(Key[++keyCtr]);
+		R3 ^= T(Key[++keyCtr]);
+		Sb5(R0, R1, R2, R3);
+		LinearTransformW(R0, R1, R2, R3);
+
+		R0 ^= T(Key[++keyCtr]);
+		R1 ^= T(Key[++keyCtr]);
+		R2 ^= T(Key[++keyCtr]);
+		R3 ^= T(Key[++keyCtr]);
+		Sb6(R0, R1, R2, R3);
+		LinearTransformW(R0, R1, R2, R3);
+
+		R0 ^= T(Key[++keyCtr]);
+		R1 ^= T(Key[++keyCtr]);
+		R2 ^= T(Key[++keyCtr]);
+		R3 ^= T(Key[++keyCtr]);
+		Sb7(R0, R1, R2, R3);
+
+		// skip on last block
+		if (keyCtr != FNLRND)
+			LinearTransformW(R0, R1, R2, R3);
+	} 
+	while (keyCtr != FNLRND);
+
+	// last round
+	R0 ^= T(Key[++keyCtr]);
+	R1 ^= T(Key[++keyCtr]);
+	R2 ^= T(Key[++keyCtr]);
+	R3 ^= T(Key[++keyCtr]);
+
+	T::Transpose(R0, R1, R2, R3);
+	R0.Store(Output, OutOffset);
+	R1.Store(Output, OutOffset + INPOFF);
+	R2.Store(Output, OutOffset + (INPOFF * 2));
+	R3.Store(Output, OutOffset + (INPOFF * 3));
+
+#endif
+}
+
 NAMESPACE_BLOCKEND
 #endif
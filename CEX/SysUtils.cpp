@@ -91,7 +91,7 @@ std::vector<ulong> SysUtils::DriveSpace(const std::string &Drive)
 	return retSizes;
 
 #else
-	return 0;
+	return std::vector<ulong>(0);
 #endif
 }
 
@@ -100,7 +100,7 @@ ulong SysUtils::GetRdtscFrequency()
 	if (HasRdtsc())
 	{
 		uint64_t first = __rdtsc();
-		Sleep(10);
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
 		uint64_t second = __rdtsc();
 
 		return (second - first) * 100;
@@ -368,40 +368,40 @@ ulong SysUtils::TimeCurrentNS()
 ulong SysUtils::TimeStamp(bool HasRdtsc)
 {
 	// http://nadeausoftware.com/articles/2012/04/c_c_tip_how_measure_elapsed_real_time_benchmarking
+#if defined(CEX_ARCH_X86_X64)
+	if (HasRdtsc)
+	{
+		// the time-stamp counter is read directly on every x86 platform
+		return static_cast<ulong>(__rdtsc());
+	}
+#endif
+
 #if defined(CEX_OS_WINDOWS)
 	try
 	{
-		if (HasRdtsc)
+		int64_t ctr1 = 0;
+		int64_t freq = 0;
+		if (QueryPerformanceCounter((LARGE_INTEGER *)&ctr1) != 0)
 		{
-			// use tsc if available
-			return __rdtsc();
+			QueryPerformanceFrequency((LARGE_INTEGER *)&freq);
+			// return microseconds to milliseconds
+			return (uint64_t)(ctr1 * 1000.0 / freq);
 		}
 		else
 		{
-			int64_t ctr1 = 0;
-			int64_t freq = 0;
-			if (QueryPerformanceCounter((LARGE_INTEGER *)&ctr1) != 0)
-			{
-				QueryPerformanceFrequency((LARGE_INTEGER *)&freq);
-				// return microseconds to milliseconds
-				return (uint64_t)(ctr1 * 1000.0 / freq);
-			}
-			else
-			{
-				FILETIME ft;
-				LARGE_INTEGER li;
+			FILETIME ft;
+			LARGE_INTEGER li;
 
-				// Get the amount of 100 nano seconds intervals elapsed since January 1, 1601 (UTC) and copy it to a LARGE_INTEGER structure
-				GetSystemTimeAsFileTime(&ft);
-				li.LowPart = ft.dwLowDateTime;
-				li.HighPart = ft.dwHighDateTime;
+			// Get the amount of 100 nano seconds intervals elapsed since January 1, 1601 (UTC) and copy it to a LARGE_INTEGER structure
+			GetSystemTimeAsFileTime(&ft);
+			li.LowPart = ft.dwLowDateTime;
+			li.HighPart = ft.dwHighDateTime;
 
-				uint64_t ret = li.QuadPart;
-				ret -= 116444736000000000LL; // Convert from file time to UNIX epoch time.
-				ret /= 10000; // From 100 nano seconds (10^-7) to 1 millisecond (10^-3) intervals
+			uint64_t ret = li.QuadPart;
+			ret -= 116444736000000000LL; // Convert from file time to UNIX epoch time.
+			ret /= 10000; // From 100 nano seconds (10^-7) to 1 millisecond (10^-3) intervals
 
-				return ret;
-			}
+			return ret;
 		}
 	}
 	catch (...) 
@@ -475,7 +475,7 @@ ulong SysUtils::TimeStamp(bool HasRdtsc)
 		{
 			if (id != (clockid_t)-1 && clock_gettime(id, &ts) != -1)
 			{
-				return static_cast<ulong>(ts.tv_sec + ts.tv_nsec);
+				return (static_cast<ulong>(ts.tv_sec) * 1000000000ULL) + static_cast<ulong>(ts.tv_nsec);
 			}
 		}
 		catch (...)
@@ -496,7 +496,7 @@ ulong SysUtils::TimeStamp(bool HasRdtsc)
 		struct timeval tm;
 		gettimeofday(&tm, NULL);
 
-		return static_cast<ulong>(tm.tv_sec + tm.tv_usec);
+		return (static_cast<ulong>(tm.tv_sec) * 1000000ULL) + static_cast<ulong>(tm.tv_usec);
 	}
 	catch (...)
 	{
@@ -23,6 +23,7 @@
 #include "ArrayUtils.h"
 #include "CpuDetect.h"
 #include <chrono>
+#include <thread>
 
 #if defined(CEX_OS_WINDOWS)
 #	include <Windows.h>
@@ -37,7 +38,8 @@
 #elif defined(CEX_OS_ANDROID)
 
 #elif defined(CEX_OS_LINUX)
-
+#	include <time.h>
+#	include <unistd.h>
 #elif defined(CEX_OS_UNIX)
 #	include <time.h>
 #	include <unistd.h>
@@ -46,13 +48,18 @@
 #	include <mach/mach_time.h>
 #	include <time.h>
 #endif
+#if defined(CEX_ARCH_X86_X64) && !defined(CEX_COMPILER_MSC)
+#	include <x86intrin.h>
+#endif
 #if defined(CEX_OS_POSIX)
 #	include <limits.h>
 #	include <stdio.h>
 #	include <stdlib.h>
 #	include <sys/resource.h>
 #	include <sys/statvfs.h>
-#	include <sys/sysctl.h>
+#	if defined(CEX_OS_APPLE) || defined(__FreeBSD__) || defined(__NetBSD__) || defined(__OpenBSD__)
+#		include <sys/sysctl.h>
+#	endif
 #	include <sys/sysinfo.h>
 #	include <sys/time.h>
 #	include <sys/types.h>
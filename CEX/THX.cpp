@@ -4,15 +4,6 @@
 #include "HKDF.h"
 #include "IntUtils.h"
 #include "MemUtils.h"
-#if defined(CEX_COMPILER_MSC)
-#	if defined(__AVX512__)
-#		include "UInt512.h"
-#	elif defined(__AVX2__)
-#		include "UInt256.h"
-#	elif defined(__AVX__)
-#		include "UInt128.h"
-#	endif
-#endif
 
 NAMESPACE_BLOCK
 
@@ -57,6 +48,11 @@ const Digests THX::KdfEngine()
 	return m_kdfEngineType;
 }
 
+KeyScheduleCache* &THX::KeyCache()
+{
+	return m_keyCache;
+}
+
 const std::vector<SymmetricKeySize> &THX::LegalKeySizes()
 {
 	return m_legalKeySizes;
@@ -100,6 +96,7 @@ THX::THX(Digests KdfEngineType, uint Rounds)
 	m_kdfInfo(DEF_DSTINFO.begin(), DEF_DSTINFO.end()),
 	m_kdfInfoMax(0),
 	m_kdfKeySize(0),
+	m_keyCache(0),
 	m_legalKeySizes(0),
 	m_legalRounds(0),
 	m_rndCount(Rounds),
@@ -124,6 +121,7 @@ THX::THX(IDigest *KdfEngine, size_t Rounds)
 	m_kdfInfo(DEF_DSTINFO.begin(), DEF_DSTINFO.end()),
 	m_kdfInfoMax(0),
 	m_kdfKeySize(0),
+	m_keyCache(0),
 	m_legalKeySizes(0),
 	m_legalRounds(0),
 	m_rndCount(Rounds),
@@ -142,6 +140,25 @@ THX::~THX()
 
 //~~~Public Functions~~~//
 
+THX* THX::Clone()
+{
+	if (!m_isInitialized)
+		throw CryptoSymmetricCipherException("THX:Clone", "The cipher has not been initialized!");
+
+	// the copy owns a digest of the same type, and takes the expanded schedule as is
+	THX* cpr = new THX(m_kdfEngineType, static_cast<uint>(m_rndCount));
+	cpr->m_cprKeySize = m_cprKeySize;
+	cpr->m_expKey = m_expKey;
+	cpr->m_kdfInfo = m_kdfInfo;
+	cpr->m_isEncryption = m_isEncryption;
+	cpr->m_keyCache = m_keyCache;
+	cpr->m_rndCount = m_rndCount;
+	cpr->m_sBox = m_sBox;
+	cpr->m_isInitialized = true;
+
+	return cpr;
+}
+
 void THX::DecryptBlock(const std::vector<byte> &Input, std::vector<byte> &Output)
 {
 	Decrypt128(Input, 0, Output, 0);
@@ -211,6 +228,22 @@ void THX::Initialize(bool Encryption, ISymmetricKey &KeyParams)
 	m_isInitialized = true;
 }
 
+void THX::Rekey(ISymmetricKey &KeyParams)
+{
+	if (!m_isInitialized)
+		throw CryptoSymmetricCipherException("THX:Rekey", "The cipher has not been initialized!");
+	if (KeyParams.Key().size() * 8 != m_cprKeySize)
+		throw CryptoSymmetricCipherException("THX:Rekey", "Invalid key size! The new key must be the same length as the current key.");
+	if (m_kdfEngineType != Enumeration::Digests::None && KeyParams.Info().size() > m_kdfInfoMax)
+		throw CryptoSymmetricCipherException("THX:Rekey", "Invalid info size! Info parameter must be no longer than DistributionCodeMax size.");
+
+	if (KeyParams.Info().size() > 0)
+		m_kdfInfo = KeyParams.Info();
+
+	// the schedule is the same size, so the working key is overwritten in place
+	ExpandKey(KeyParams.Key());
+}
+
 void THX::Transform(const std::vector<byte> &Input, std::vector<byte> &Output)
 {
 	if (m_isEncryption)
@@ -282,33 +315,41 @@ void THX::SecureExpand(const std::vector<byte> &Key)
 	std::vector<uint> eKm(k64Cnt, 0);
 	std::vector<uint> oKm(k64Cnt, 0);
 	std::vector<uint> wK(keySize, 0);
+	std::vector<byte> rawKey(keyBytes, 0);
 
-	Kdf::HKDF gen(m_kdfEngine);
-
-	// change 1.2: use extract only on an oversized key
-	if (Key.size() > m_kdfEngine->BlockSize())
+	// copy a cached schedule, or run the HKDF expansion and add the schedule to the cache
+	if (m_keyCache == 0 || !m_keyCache->Find(Enumeral(), m_kdfEngineType, m_rndCount, Key, m_kdfInfo, rawKey))
 	{
-		// seperate salt and key
-		m_kdfKeySize = m_kdfEngine->BlockSize();
-		std::vector<byte> kdfKey(m_kdfKeySize, 0);
-		Utility::MemUtils::Copy(Key, 0, kdfKey, 0, m_kdfKeySize);
-		size_t saltSize = Key.size() - m_kdfKeySize;
-		std::vector<byte> kdfSalt(saltSize, 0);
-		Utility::MemUtils::Copy(Key, m_kdfKeySize, kdfSalt, 0, saltSize);
-		// info can be null
-		gen.Initialize(kdfKey, kdfSalt, m_kdfInfo);
-	}
-	else
-	{
-		if (m_kdfInfo.size() != 0)
-			gen.Info() = m_kdfInfo;
+		Kdf::HKDF gen(m_kdfEngine);
+
+		// change 1.2: use extract only on an oversized key
+		if (Key.size() > m_kdfEngine->BlockSize())
+		{
+			// seperate salt and key
+			m_kdfKeySize = m_kdfEngine->BlockSize();
+			std::vector<byte> kdfKey(m_kdfKeySize, 0);
+			Utility::MemUtils::Copy(Key, 0, kdfKey, 0, m_kdfKeySize);
+			size_t saltSize = Key.size() - m_kdfKeySize;
+			std::vector<byte> kdfSalt(saltSize, 0);
+			Utility::MemUtils::Copy(Key, m_kdfKeySize, kdfSalt, 0, saltSize);
+			// info can be null
+			gen.Initialize(kdfKey, kdfSalt, m_kdfInfo);
+		}
+		else
+		{
+			if (m_kdfInfo.size() != 0)
+				gen.Info() = m_kdfInfo;
+
+			gen.Initialize(Key);
+		}
 
-		gen.Initialize(Key);
+		// expand the round keys
+		gen.Generate(rawKey);
+
+		if (m_keyCache != 0)
+			m_keyCache->Add(Enumeral(), m_kdfEngineType, m_rndCount, Key, m_kdfInfo, rawKey);
 	}
 
-	std::vector<byte> rawKey(keyBytes, 0);
-	// expand the round keys
-	gen.Generate(rawKey);
 	// initialize working key
 	m_expKey.resize(keySize, 0);
 	// copy bytes to working key
@@ -438,7 +479,7 @@ void THX::Decrypt128(const std::vector<byte> &Input, const size_t InOffset, std:
 
 void THX::Decrypt512(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
 {
-#if !defined(__AVX512__) && !defined(__AVX2__) && defined(__AVX__) && defined(CEX_COMPILER_MSC)
+#if defined(__AVX__)
 	THXDecryptW<Numeric::UInt128>(Input, InOffset, Output, OutOffset, m_expKey, m_sBox);
 #else
 	Decrypt128(Input, InOffset, Output, OutOffset);
@@ -450,9 +491,9 @@ void THX::Decrypt512(const std::vector<byte> &Input, const size_t InOffset, std:
 
 void THX::Decrypt1024(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
 {
-#if !defined(__AVX512__) && defined(__AVX2__) && defined(CEX_COMPILER_MSC)
+#if defined(__AVX2__)
 	THXDecryptW<Numeric::UInt256>(Input, InOffset, Output, OutOffset, m_expKey, m_sBox);
-#elif !defined(__AVX512__) && !defined(__AVX2__) && defined(__AVX__) && defined(CEX_COMPILER_MSC)
+#elif defined(__AVX__)
 	THXDecryptW<Numeric::UInt128>(Input, InOffset, Output, OutOffset, m_expKey, m_sBox);
 	THXDecryptW<Numeric::UInt128>(Input, InOffset + 64, Output, OutOffset + 64, m_expKey, m_sBox);
 #else
@@ -469,12 +510,12 @@ void THX::Decrypt1024(const std::vector<byte> &Input, const size_t InOffset, std
 
 void THX::Decrypt2048(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
 {
-#if defined(__AVX512__) && defined(CEX_COMPILER_MSC)
+#if defined(__AVX512__)
 	THXDecryptW<Numeric::UInt512>(Input, InOffset, Output, OutOffset, m_expKey, m_sBox);
-#elif !defined(__AVX512__) && defined(__AVX2__) && defined(CEX_COMPILER_MSC)
+#elif defined(__AVX2__)
 	THXDecryptW<Numeric::UInt256>(Input, InOffset, Output, OutOffset, m_expKey, m_sBox);
 	THXDecryptW<Numeric::UInt256>(Input, InOffset + 128, Output, OutOffset + 128, m_expKey, m_sBox);
-#elif !defined(__AVX512__) && !defined(__AVX2__) && defined(__AVX__) && defined(CEX_COMPILER_MSC)
+#elif defined(__AVX__)
 	THXDecryptW<Numeric::UInt128>(Input, InOffset, Output, OutOffset, m_expKey, m_sBox);
 	THXDecryptW<Numeric::UInt128>(Input, InOffset + 64, Output, OutOffset + 64, m_expKey, m_sBox);
 	THXDecryptW<Numeric::UInt128>(Input, InOffset + 128, Output, OutOffset + 128, m_expKey, m_sBox);
@@ -542,7 +583,7 @@ void THX::Encrypt128(const std::vector<byte> &Input, const size_t InOffset, std:
 
 void THX::Encrypt512(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
 {
-#if !defined(__AVX512__) && !defined(__AVX2__) && defined(__AVX__) && defined(CEX_COMPILER_MSC)
+#if defined(__AVX__)
 	THXEncryptW<Numeric::UInt128>(Input, InOffset, Output, OutOffset, m_expKey, m_sBox);
 #else
 	Encrypt128(Input, InOffset, Output, OutOffset);
@@ -554,9 +595,9 @@ void THX::Encrypt512(const std::vector<byte> &Input, const size_t InOffset, std:
 
 void THX::Encrypt1024(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
 {
-#if !defined(__AVX512__) && defined(__AVX2__) && defined(CEX_COMPILER_MSC)
+#if defined(__AVX2__)
 	THXEncryptW<Numeric::UInt256>(Input, InOffset, Output, OutOffset, m_expKey, m_sBox);
-#elif !defined(__AVX512__) && !defined(__AVX2__) && defined(__AVX__) && defined(CEX_COMPILER_MSC)
+#elif defined(__AVX__)
 	THXEncryptW<Numeric::UInt128>(Input, InOffset, Output, OutOffset, m_expKey, m_sBox);
 	THXEncryptW<Numeric::UInt128>(Input, InOffset + 64, Output, OutOffset + 64, m_expKey, m_sBox);
 #else
@@ -573,12 +614,12 @@ void THX::Encrypt1024(const std::vector<byte> &Input, const size_t InOffset, std
 
 void THX::Encrypt2048(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset)
 {
-#if defined(__AVX512__) && defined(CEX_COMPILER_MSC)
+#if defined(__AVX512__)
 	THXEncryptW<Numeric::UInt512>(Input, InOffset, Output, OutOffset, m_expKey, m_sBox);
-#elif !defined(__AVX512__) && defined(__AVX2__) && defined(CEX_COMPILER_MSC)
+#elif defined(__AVX2__)
 	THXEncryptW<Numeric::UInt256>(Input, InOffset, Output, OutOffset, m_expKey, m_sBox);
 	THXEncryptW<Numeric::UInt256>(Input, InOffset + 128, Output, OutOffset + 128, m_expKey, m_sBox);
-#elif !defined(__AVX512__) && !defined(__AVX2__) && defined(__AVX__) && defined(CEX_COMPILER_MSC)
+#elif defined(__AVX__)
 	THXEncryptW<Numeric::UInt128>(Input, InOffset, Output, OutOffset, m_expKey, m_sBox);
 	THXEncryptW<Numeric::UInt128>(Input, InOffset + 64, Output, OutOffset + 64, m_expKey, m_sBox);
 	THXEncryptW<Numeric::UInt128>(Input, InOffset + 128, Output, OutOffset + 128, m_expKey, m_sBox);
@@ -787,15 +828,6 @@ CEX_OPTIMIZE_IGNORE
 void THX::Prefetch()
 {
 	// timing defence: pre-load tables into cache
-#if defined(__AVX__)
-	PREFETCHT0(&m_sBox[0], m_sBox.size() * sizeof(uint));
-	PREFETCHT0(&M0[0], 256 * sizeof(uint));
-	PREFETCHT0(&M1[0], 256 * sizeof(uint));
-	PREFETCHT0(&M2[0], 256 * sizeof(uint));
-	PREFETCHT0(&M3[0], 256 * sizeof(uint));
-	PREFETCHT0(&Q0[0], 256 * sizeof(uint));
-	PREFETCHT0(&Q1[0], 256 * sizeof(uint));
-#else
 	volatile uint dummy;
 	for (size_t i = 0; i < m_sBox.size(); ++i)
 		dummy ^= m_sBox[i];
@@ -811,9 +843,6 @@ void THX::Prefetch()
 		dummy ^= Q0[i];
 	for (size_t i = 0; i < 256; ++i)
 		dummy ^= Q1[i];
-
-#endif
-
 }
 CEX_OPTIMIZE_RESUME
 
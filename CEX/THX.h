@@ -35,6 +35,7 @@
 #define CEX_THX_H
 
 #include "IBlockCipher.h"
+#include "KeyScheduleCache.h"
 
 NAMESPACE_BLOCK
 
@@ -95,6 +96,7 @@ NAMESPACE_BLOCK
 /// <item><description>The recommended size for maximum security is 2* the digests block size; this calls HKDF Extract using full blocks of key and salt.</description></item>
 /// <item><description>Valid key sizes can be determined at run time using the <see cref="LegalKeySizes"/> property.</description></item>
 /// <item><description>The internal block size is 16 bytes wide.</description></item>
+/// <item><description>When compiled with AVX, the Transform512, Transform1024 and Transform2048 functions process 4, 8 or 16 blocks in parallel using the UInt128, UInt256 (AVX2) or UInt512 (AVX-512) types; the key-dependent S-Box lookups use the AVX2 and AVX-512 gather instructions.</description></item>
 /// <item><description>Diffusion rounds assignments are 16, 18, 20, 22, 24, 26, 28, 30 and 32, default is 16 (128-256 bit key), a 512 bit key is automatically assigned 20 rounds.</description></item>
 /// <item><description>Valid rounds assignments can be found in the <see cref="LegalRounds"/> property.</description></item>
 /// </list>
@@ -143,6 +145,7 @@ private:
 	size_t m_kdfInfoMax;
 	size_t m_kdfKeySize;
 	size_t m_cprKeySize;
+	KeyScheduleCache* m_keyCache;
 	std::vector<SymmetricKeySize> m_legalKeySizes;
 	std::vector<size_t> m_legalRounds;
 	size_t m_rndCount;
@@ -200,6 +203,13 @@ public:
 	/// </summary>
 	const Digests KdfEngine() override;
 
+	/// <summary>
+	/// Get/Set: An optional cache of HKDF expanded key schedules, shared between cipher instances.
+	/// <para>When set, and the cipher uses a KdfEngine, the key expansion copies a cached schedule instead of running HKDF.
+	/// The cache is not owned by the cipher, and must outlive it.</para>
+	/// </summary>
+	KeyScheduleCache* &KeyCache();
+
 	/// <summary>
 	/// Get: Available Encryption Key Sizes in bytes
 	/// </summary>
@@ -258,6 +268,18 @@ public:
 
 	//~~~Public Functions~~~//
 
+	/// <summary>
+	/// Create an initialized copy of this cipher.
+	/// <para>The expanded key schedule, direction, rounds and distribution code are copied, so the copy does not run the key expansion or HKDF again.
+	/// A KdfEngine instance passed to the constructor is not shared; the copy creates its own digest of the same type.
+	/// The KeyCache() pointer is copied. The caller is responsible for destroying the returned cipher.</para>
+	/// </summary>
+	///
+	/// <returns>A new, initialized THX instance</returns>
+	///
+	/// <exception cref="Exception::CryptoSymmetricCipherException">Thrown if the cipher has not been initialized</exception>
+	THX* Clone() override;
+
 	/// <summary>
 	/// Decrypt a single block of bytes.
 	/// <para><see cref="Initialize(bool, ISymmetricKey)"/> must be called with the Encryption flag set to <c>false</c> before this method can be used.
@@ -317,6 +339,17 @@ public:
 	/// <exception cref="Exception::CryptoSymmetricCipherException">Thrown if a null or invalid key is used</exception>
 	void Initialize(bool Encryption, ISymmetricKey &KeyParams) override;
 
+	/// <summary>
+	/// Replace the cipher key, retaining the direction and the allocated cipher state.
+	/// <para>The cipher must be initialized, and the new key must be the same length as the current key.
+	/// With a KeyCache() assigned, rekeying to a previously used key and info skips the HKDF expansion.</para>
+	/// </summary>
+	///
+	/// <param name="KeyParams">Cipher key container; the key must be the same size as the current key</param>
+	///
+	/// <exception cref="Exception::CryptoSymmetricCipherException">Thrown if the cipher is not initialized, or the key or info size is invalid</exception>
+	void Rekey(ISymmetricKey &KeyParams);
+
 	/// <summary>
 	/// Transform a block of bytes.
 	/// <para><see cref="Initialize(bool, ISymmetricKey)"/> must be called before this method can be used.
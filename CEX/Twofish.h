@@ -20,6 +20,15 @@
 #define CEX_TWOFISH_H
 
 #include "CexDomain.h"
+#if defined(__AVX__)
+#	include "UInt128.h"
+#endif
+#if defined(__AVX2__)
+#	include "UInt256.h"
+#endif
+#if defined(__AVX512__)
+#	include "UInt512.h"
+#endif
 
 NAMESPACE_BLOCK
 
@@ -27,6 +36,97 @@ NAMESPACE_BLOCK
 * \internal
 */
 
+//~~~Twofish Lookup Functions~~~//
+
+template<typename T, typename U>
+T Fe0(const T X, const std::vector<U> &Sbox)
+{
+	return Sbox[2 * (byte)X] ^ Sbox[2 * (byte)(X >> 8) + 0x001] ^ Sbox[2 * (byte)(X >> 16) + 0x200] ^ Sbox[2 * (byte)(X >> 24) + 0x201];
+}
+
+template<typename T, typename U>
+T Fe3(const T X, const std::vector<U> &Sbox)
+{
+	return Sbox[2 * (byte)X + 0x001] ^ Sbox[2 * (byte)(X >> 8) + 0x200] ^ Sbox[2 * (byte)(X >> 16) + 0x201] ^ Sbox[2 * (byte)(X >> 24)];
+}
+
+// the wide lookups gather the four key-dependent s-box words of every 32bit lane; each byte of X indexes
+// the interleaved table as 2 * b + offset, so the index is the byte shifted into bits 1-8, and the offset is applied to the base address.
+// Fe3 is Fe0 of the lane rotated left by 8 bits.
+
+#if defined(__AVX512__)
+inline Numeric::UInt512 Fe0W(const Numeric::UInt512 &X, const std::vector<uint> &Sbox)
+{
+	const __m512i IDXMSK = _mm512_set1_epi32(0x1FE);
+	__m512i Y;
+
+	Y = _mm512_i32gather_epi32(_mm512_and_si512(_mm512_slli_epi32(X.zmm, 1), IDXMSK), &Sbox[0], 4);
+	Y = _mm512_xor_si512(Y, _mm512_i32gather_epi32(_mm512_and_si512(_mm512_srli_epi32(X.zmm, 7), IDXMSK), &Sbox[0x001], 4));
+	Y = _mm512_xor_si512(Y, _mm512_i32gather_epi32(_mm512_and_si512(_mm512_srli_epi32(X.zmm, 15), IDXMSK), &Sbox[0x200], 4));
+	Y = _mm512_xor_si512(Y, _mm512_i32gather_epi32(_mm512_and_si512(_mm512_srli_epi32(X.zmm, 23), IDXMSK), &Sbox[0x201], 4));
+
+	return Numeric::UInt512(Y);
+}
+
+inline Numeric::UInt512 Fe3W(const Numeric::UInt512 &X, const std::vector<uint> &Sbox)
+{
+	return Fe0W(Numeric::UInt512(_mm512_rol_epi32(X.zmm, 8)), Sbox);
+}
+#endif
+
+#if defined(__AVX2__)
+inline Numeric::UInt256 Fe0W(const Numeric::UInt256 &X, const std::vector<uint> &Sbox)
+{
+	const __m256i IDXMSK = _mm256_set1_epi32(0x1FE);
+	const int* SBXPTR = reinterpret_cast<const int*>(&Sbox[0]);
+	__m256i Y;
+
+	Y = _mm256_i32gather_epi32(SBXPTR, _mm256_and_si256(_mm256_slli_epi32(X.ymm, 1), IDXMSK), 4);
+	Y = _mm256_xor_si256(Y, _mm256_i32gather_epi32(SBXPTR + 0x001, _mm256_and_si256(_mm256_srli_epi32(X.ymm, 7), IDXMSK), 4));
+	Y = _mm256_xor_si256(Y, _mm256_i32gather_epi32(SBXPTR + 0x200, _mm256_and_si256(_mm256_srli_epi32(X.ymm, 15), IDXMSK), 4));
+	Y = _mm256_xor_si256(Y, _mm256_i32gather_epi32(SBXPTR + 0x201, _mm256_and_si256(_mm256_srli_epi32(X.ymm, 23), IDXMSK), 4));
+
+	return Numeric::UInt256(Y);
+}
+
+inline Numeric::UInt256 Fe3W(const Numeric::UInt256 &X, const std::vector<uint> &Sbox)
+{
+	return Fe0W(Numeric::UInt256::RotL32(X, 8), Sbox);
+}
+#endif
+
+#if defined(__AVX__)
+inline Numeric::UInt128 Fe0W(const Numeric::UInt128 &X, const std::vector<uint> &Sbox)
+{
+#	if defined(__AVX2__)
+	const __m128i IDXMSK = _mm_set1_epi32(0x1FE);
+	const int* SBXPTR = reinterpret_cast<const int*>(&Sbox[0]);
+	__m128i Y;
+
+	Y = _mm_i32gather_epi32(SBXPTR, _mm_and_si128(_mm_slli_epi32(X.xmm, 1), IDXMSK), 4);
+	Y = _mm_xor_si128(Y, _mm_i32gather_epi32(SBXPTR + 0x001, _mm_and_si128(_mm_srli_epi32(X.xmm, 7), IDXMSK), 4));
+	Y = _mm_xor_si128(Y, _mm_i32gather_epi32(SBXPTR + 0x200, _mm_and_si128(_mm_srli_epi32(X.xmm, 15), IDXMSK), 4));
+	Y = _mm_xor_si128(Y, _mm_i32gather_epi32(SBXPTR + 0x201, _mm_and_si128(_mm_srli_epi32(X.xmm, 23), IDXMSK), 4));
+
+	return Numeric::UInt128(Y);
+#	else
+	// no gather instruction; extract the lanes and use the scalar lookup
+	return Numeric::UInt128(_mm_setr_epi32(
+		Fe0(static_cast<uint>(_mm_extract_epi32(X.xmm, 0)), Sbox),
+		Fe0(static_cast<uint>(_mm_extract_epi32(X.xmm, 1)), Sbox),
+		Fe0(static_cast<uint>(_mm_extract_epi32(X.xmm, 2)), Sbox),
+		Fe0(static_cast<uint>(_mm_extract_epi32(X.xmm, 3)), Sbox)));
+#	endif
+}
+
+inline Numeric::UInt128 Fe3W(const Numeric::UInt128 &X, const std::vector<uint> &Sbox)
+{
+	return Fe0W(Numeric::UInt128::RotL32(X, 8), Sbox);
+}
+#endif
+
+//~~~Twofish Wide Transforms~~~//
+
 template<typename T>
 void THXDecryptW(const std::vector<byte> &Input, const size_t InOffset, std::vector<byte> &Output, const size_t OutOffset, std::vector<uint> &Key, std::vector<uint> &Sbox)
 {
@@ -143,111 +243,6 @@ void THXEncryptW(const std::vector<byte> &Input, const size_t InOffset, std::vec
 #endif
 }
 
-//~~~Twofish Lookup Templates~~~//
-
-// only on msc
-#if defined(CEX_COMPILER_MSC)
-	template<typename T, typename U>
-	T Fe0W(const T &X, const std::vector<U> &Sbox)
-	{
-	#if defined(__AVX512__)
-		return T(
-			Sbox[2 * X.zmm.m512i_u8[60]] ^ Sbox[2 * X.zmm.m512i_u8[61] + 0x001] ^ Sbox[2 * X.zmm.m512i_u8[62] + 0x200] ^ Sbox[2 * X.zmm.m512i_u8[63] + 0x201],
-			Sbox[2 * X.zmm.m512i_u8[56]] ^ Sbox[2 * X.zmm.m512i_u8[57] + 0x001] ^ Sbox[2 * X.zmm.m512i_u8[58] + 0x200] ^ Sbox[2 * X.zmm.m512i_u8[59] + 0x201],
-			Sbox[2 * X.zmm.m512i_u8[52]] ^ Sbox[2 * X.zmm.m512i_u8[53] + 0x001] ^ Sbox[2 * X.zmm.m512i_u8[54] + 0x200] ^ Sbox[2 * X.zmm.m512i_u8[55] + 0x201],
-			Sbox[2 * X.zmm.m512i_u8[48]] ^ Sbox[2 * X.zmm.m512i_u8[49] + 0x001] ^ Sbox[2 * X.zmm.m512i_u8[50] + 0x200] ^ Sbox[2 * X.zmm.m512i_u8[51] + 0x201],
-			Sbox[2 * X.zmm.m512i_u8[44]] ^ Sbox[2 * X.zmm.m512i_u8[45] + 0x001] ^ Sbox[2 * X.zmm.m512i_u8[46] + 0x200] ^ Sbox[2 * X.zmm.m512i_u8[47] + 0x201],
-			Sbox[2 * X.zmm.m512i_u8[40]] ^ Sbox[2 * X.zmm.m512i_u8[41] + 0x001] ^ Sbox[2 * X.zmm.m512i_u8[42] + 0x200] ^ Sbox[2 * X.zmm.m512i_u8[43] + 0x201],
-			Sbox[2 * X.zmm.m512i_u8[36]] ^ Sbox[2 * X.zmm.m512i_u8[37] + 0x001] ^ Sbox[2 * X.zmm.m512i_u8[38] + 0x200] ^ Sbox[2 * X.zmm.m512i_u8[39] + 0x201],
-			Sbox[2 * X.zmm.m512i_u8[32]] ^ Sbox[2 * X.zmm.m512i_u8[33] + 0x001] ^ Sbox[2 * X.zmm.m512i_u8[34] + 0x200] ^ Sbox[2 * X.zmm.m512i_u8[35] + 0x201]
-			Sbox[2 * X.zmm.m512i_u8[28]] ^ Sbox[2 * X.zmm.m512i_u8[29] + 0x001] ^ Sbox[2 * X.zmm.m512i_u8[30] + 0x200] ^ Sbox[2 * X.zmm.m512i_u8[31] + 0x201],
-			Sbox[2 * X.zmm.m512i_u8[24]] ^ Sbox[2 * X.zmm.m512i_u8[25] + 0x001] ^ Sbox[2 * X.zmm.m512i_u8[26] + 0x200] ^ Sbox[2 * X.zmm.m512i_u8[27] + 0x201],
-			Sbox[2 * X.zmm.m512i_u8[20]] ^ Sbox[2 * X.zmm.m512i_u8[21] + 0x001] ^ Sbox[2 * X.zmm.m512i_u8[22] + 0x200] ^ Sbox[2 * X.zmm.m512i_u8[23] + 0x201],
-			Sbox[2 * X.zmm.m512i_u8[16]] ^ Sbox[2 * X.zmm.m512i_u8[17] + 0x001] ^ Sbox[2 * X.zmm.m512i_u8[18] + 0x200] ^ Sbox[2 * X.zmm.m512i_u8[19] + 0x201],
-			Sbox[2 * X.zmm.m512i_u8[12]] ^ Sbox[2 * X.zmm.m512i_u8[13] + 0x001] ^ Sbox[2 * X.zmm.m512i_u8[14] + 0x200] ^ Sbox[2 * X.zmm.m512i_u8[15] + 0x201],
-			Sbox[2 * X.zmm.m512i_u8[8]] ^ Sbox[2 * X.zmm.m512i_u8[9] + 0x001] ^ Sbox[2 * X.zmm.m512i_u8[10] + 0x200] ^ Sbox[2 * X.zmm.m512i_u8[11] + 0x201],
-			Sbox[2 * X.zmm.m512i_u8[4]] ^ Sbox[2 * X.zmm.m512i_u8[5] + 0x001] ^ Sbox[2 * X.zmm.m512i_u8[6] + 0x200] ^ Sbox[2 * X.zmm.m512i_u8[7] + 0x201],
-			Sbox[2 * X.zmm.m512i_u8[0]] ^ Sbox[2 * X.zmm.m512i_u8[1] + 0x001] ^ Sbox[2 * X.zmm.m512i_u8[2] + 0x200] ^ Sbox[2 * X.zmm.m512i_u8[3] + 0x201]
-		);
-	#elif !defined(__AVX512__) && defined(__AVX2__)
-		return T(
-			Sbox[2 * X.ymm.m256i_u8[28]] ^ Sbox[2 * X.ymm.m256i_u8[29] + 0x001] ^ Sbox[2 * X.ymm.m256i_u8[30] + 0x200] ^ Sbox[2 * X.ymm.m256i_u8[31] + 0x201],
-			Sbox[2 * X.ymm.m256i_u8[24]] ^ Sbox[2 * X.ymm.m256i_u8[25] + 0x001] ^ Sbox[2 * X.ymm.m256i_u8[26] + 0x200] ^ Sbox[2 * X.ymm.m256i_u8[27] + 0x201],
-			Sbox[2 * X.ymm.m256i_u8[20]] ^ Sbox[2 * X.ymm.m256i_u8[21] + 0x001] ^ Sbox[2 * X.ymm.m256i_u8[22] + 0x200] ^ Sbox[2 * X.ymm.m256i_u8[23] + 0x201],
-			Sbox[2 * X.ymm.m256i_u8[16]] ^ Sbox[2 * X.ymm.m256i_u8[17] + 0x001] ^ Sbox[2 * X.ymm.m256i_u8[18] + 0x200] ^ Sbox[2 * X.ymm.m256i_u8[19] + 0x201],
-			Sbox[2 * X.ymm.m256i_u8[12]] ^ Sbox[2 * X.ymm.m256i_u8[13] + 0x001] ^ Sbox[2 * X.ymm.m256i_u8[14] + 0x200] ^ Sbox[2 * X.ymm.m256i_u8[15] + 0x201],
-			Sbox[2 * X.ymm.m256i_u8[8]] ^ Sbox[2 * X.ymm.m256i_u8[9] + 0x001] ^ Sbox[2 * X.ymm.m256i_u8[10] + 0x200] ^ Sbox[2 * X.ymm.m256i_u8[11] + 0x201],
-			Sbox[2 * X.ymm.m256i_u8[4]] ^ Sbox[2 * X.ymm.m256i_u8[5] + 0x001] ^ Sbox[2 * X.ymm.m256i_u8[6] + 0x200] ^ Sbox[2 * X.ymm.m256i_u8[7] + 0x201],
-			Sbox[2 * X.ymm.m256i_u8[0]] ^ Sbox[2 * X.ymm.m256i_u8[1] + 0x001] ^ Sbox[2 * X.ymm.m256i_u8[2] + 0x200] ^ Sbox[2 * X.ymm.m256i_u8[3] + 0x201]
-		);
-	#elif !defined(__AVX512__) && !defined(__AVX2__) && defined(__AVX__)
-		return T(
-			Sbox[2 * X.xmm.m128i_u8[12]] ^ Sbox[2 * X.xmm.m128i_u8[13] + 0x001] ^ Sbox[2 * X.xmm.m128i_u8[14] + 0x200] ^ Sbox[2 * X.xmm.m128i_u8[15] + 0x201],
-			Sbox[2 * X.xmm.m128i_u8[8]] ^ Sbox[2 * X.xmm.m128i_u8[9] + 0x001] ^ Sbox[2 * X.xmm.m128i_u8[10] + 0x200] ^ Sbox[2 * X.xmm.m128i_u8[11] + 0x201],
-			Sbox[2 * X.xmm.m128i_u8[4]] ^ Sbox[2 * X.xmm.m128i_u8[5] + 0x001] ^ Sbox[2 * X.xmm.m128i_u8[6] + 0x200] ^ Sbox[2 * X.xmm.m128i_u8[7] + 0x201],
-			Sbox[2 * X.xmm.m128i_u8[0]] ^ Sbox[2 * X.xmm.m128i_u8[1] + 0x001] ^ Sbox[2 * X.xmm.m128i_u8[2] + 0x200] ^ Sbox[2 * X.xmm.m128i_u8[3] + 0x201]
-		);
-	#endif
-	}
-#endif
-
-#if defined(CEX_COMPILER_MSC)
-	template<typename T, typename U>
-	T Fe3W(const T &X, const std::vector<U> &Sbox)
-	{
-	#if defined(__AVX512__)
-		return T(
-			Sbox[2 * X.zmm.m512i_u8[60] + 0x001] ^ Sbox[2 * X.zmm.m512i_u8[61] + 0x200] ^ Sbox[2 * X.zmm.m512i_u8[62] + 0x201] ^ Sbox[2 * X.zmm.m512i_u8[63]],
-			Sbox[2 * X.zmm.m512i_u8[56] + 0x001] ^ Sbox[2 * X.zmm.m512i_u8[57] + 0x200] ^ Sbox[2 * X.zmm.m512i_u8[58] + 0x201] ^ Sbox[2 * X.zmm.m512i_u8[59]],
-			Sbox[2 * X.zmm.m512i_u8[52] + 0x001] ^ Sbox[2 * X.zmm.m512i_u8[53] + 0x200] ^ Sbox[2 * X.zmm.m512i_u8[54] + 0x201] ^ Sbox[2 * X.zmm.m512i_u8[55]],
-			Sbox[2 * X.zmm.m512i_u8[48] + 0x001] ^ Sbox[2 * X.zmm.m512i_u8[49] + 0x200] ^ Sbox[2 * X.zmm.m512i_u8[50] + 0x201] ^ Sbox[2 * X.zmm.m512i_u8[51]],
-			Sbox[2 * X.zmm.m512i_u8[44] + 0x001] ^ Sbox[2 * X.zmm.m512i_u8[45] + 0x200] ^ Sbox[2 * X.zmm.m512i_u8[46] + 0x201] ^ Sbox[2 * X.zmm.m512i_u8[47]],
-			Sbox[2 * X.zmm.m512i_u8[40] + 0x001] ^ Sbox[2 * X.zmm.m512i_u8[41] + 0x200] ^ Sbox[2 * X.zmm.m512i_u8[42] + 0x201] ^ Sbox[2 * X.zmm.m512i_u8[43]],
-			Sbox[2 * X.zmm.m512i_u8[36] + 0x001] ^ Sbox[2 * X.zmm.m512i_u8[37] + 0x200] ^ Sbox[2 * X.zmm.m512i_u8[38] + 0x201] ^ Sbox[2 * X.zmm.m512i_u8[39]],
-			Sbox[2 * X.zmm.m512i_u8[32] + 0x001] ^ Sbox[2 * X.zmm.m512i_u8[33] + 0x200] ^ Sbox[2 * X.zmm.m512i_u8[34] + 0x201] ^ Sbox[2 * X.zmm.m512i_u8[35]]
-			Sbox[2 * X.zmm.m512i_u8[28] + 0x001] ^ Sbox[2 * X.zmm.m512i_u8[29] + 0x200] ^ Sbox[2 * X.zmm.m512i_u8[30] + 0x201] ^ Sbox[2 * X.zmm.m512i_u8[31]],
-			Sbox[2 * X.zmm.m512i_u8[24] + 0x001] ^ Sbox[2 * X.zmm.m512i_u8[25] + 0x200] ^ Sbox[2 * X.zmm.m512i_u8[26] + 0x201] ^ Sbox[2 * X.zmm.m512i_u8[27]],
-			Sbox[2 * X.zmm.m512i_u8[20] + 0x001] ^ Sbox[2 * X.zmm.m512i_u8[21] + 0x200] ^ Sbox[2 * X.zmm.m512i_u8[22] + 0x201] ^ Sbox[2 * X.zmm.m512i_u8[23]],
-			Sbox[2 * X.zmm.m512i_u8[16] + 0x001] ^ Sbox[2 * X.zmm.m512i_u8[17] + 0x200] ^ Sbox[2 * X.zmm.m512i_u8[18] + 0x201] ^ Sbox[2 * X.zmm.m512i_u8[19]],
-			Sbox[2 * X.zmm.m512i_u8[12] + 0x001] ^ Sbox[2 * X.zmm.m512i_u8[13] + 0x200] ^ Sbox[2 * X.zmm.m512i_u8[14] + 0x201] ^ Sbox[2 * X.zmm.m512i_u8[15]],
-			Sbox[2 * X.zmm.m512i_u8[8] + 0x001] ^ Sbox[2 * X.zmm.m512i_u8[9] + 0x200] ^ Sbox[2 * X.zmm.m512i_u8[10] + 0x201] ^ Sbox[2 * X.zmm.m512i_u8[11]],
-			Sbox[2 * X.zmm.m512i_u8[4] + 0x001] ^ Sbox[2 * X.zmm.m512i_u8[5] + 0x200] ^ Sbox[2 * X.zmm.m512i_u8[6] + 0x201] ^ Sbox[2 * X.zmm.m512i_u8[7]],
-			Sbox[2 * X.zmm.m512i_u8[0] + 0x001] ^ Sbox[2 * X.zmm.m512i_u8[1] + 0x200] ^ Sbox[2 * X.zmm.m512i_u8[2] + 0x201] ^ Sbox[2 * X.zmm.m512i_u8[3]]
-		);
-	#elif !defined(__AVX512__) && defined(__AVX2__)
-		return T(
-			Sbox[2 * X.ymm.m256i_u8[28] + 0x001] ^ Sbox[2 * X.ymm.m256i_u8[29] + 0x200] ^ Sbox[2 * X.ymm.m256i_u8[30] + 0x201] ^ Sbox[2 * X.ymm.m256i_u8[31]],
-			Sbox[2 * X.ymm.m256i_u8[24] + 0x001] ^ Sbox[2 * X.ymm.m256i_u8[25] + 0x200] ^ Sbox[2 * X.ymm.m256i_u8[26] + 0x201] ^ Sbox[2 * X.ymm.m256i_u8[27]],
-			Sbox[2 * X.ymm.m256i_u8[20] + 0x001] ^ Sbox[2 * X.ymm.m256i_u8[21] + 0x200] ^ Sbox[2 * X.ymm.m256i_u8[22] + 0x201] ^ Sbox[2 * X.ymm.m256i_u8[23]],
-			Sbox[2 * X.ymm.m256i_u8[16] + 0x001] ^ Sbox[2 * X.ymm.m256i_u8[17] + 0x200] ^ Sbox[2 * X.ymm.m256i_u8[18] + 0x201] ^ Sbox[2 * X.ymm.m256i_u8[19]],
-			Sbox[2 * X.ymm.m256i_u8[12] + 0x001] ^ Sbox[2 * X.ymm.m256i_u8[13] + 0x200] ^ Sbox[2 * X.ymm.m256i_u8[14] + 0x201] ^ Sbox[2 * X.ymm.m256i_u8[15]],
-			Sbox[2 * X.ymm.m256i_u8[8] + 0x001] ^ Sbox[2 * X.ymm.m256i_u8[9] + 0x200] ^ Sbox[2 * X.ymm.m256i_u8[10] + 0x201] ^ Sbox[2 * X.ymm.m256i_u8[11]],
-			Sbox[2 * X.ymm.m256i_u8[4] + 0x001] ^ Sbox[2 * X.ymm.m256i_u8[5] + 0x200] ^ Sbox[2 * X.ymm.m256i_u8[6] + 0x201] ^ Sbox[2 * X.ymm.m256i_u8[7]],
-			Sbox[2 * X.ymm.m256i_u8[0] + 0x001] ^ Sbox[2 * X.ymm.m256i_u8[1] + 0x200] ^ Sbox[2 * X.ymm.m256i_u8[2] + 0x201] ^ Sbox[2 * X.ymm.m256i_u8[3]]
-		);
-	#elif !defined(__AVX512__) && !defined(__AVX2__) && defined(__AVX__)
-		return T(
-			Sbox[2 * X.xmm.m128i_u8[12] + 0x001] ^ Sbox[2 * X.xmm.m128i_u8[13] + 0x200] ^ Sbox[2 * X.xmm.m128i_u8[14] + 0x201] ^ Sbox[2 * X.xmm.m128i_u8[15]],
-			Sbox[2 * X.xmm.m128i_u8[8] + 0x001] ^ Sbox[2 * X.xmm.m128i_u8[9] + 0x200] ^ Sbox[2 * X.xmm.m128i_u8[10] + 0x201] ^ Sbox[2 * X.xmm.m128i_u8[11]],
-			Sbox[2 * X.xmm.m128i_u8[4] + 0x001] ^ Sbox[2 * X.xmm.m128i_u8[5] + 0x200] ^ Sbox[2 * X.xmm.m128i_u8[6] + 0x201] ^ Sbox[2 * X.xmm.m128i_u8[7]],
-			Sbox[2 * X.xmm.m128i_u8[0] + 0x001] ^ Sbox[2 * X.xmm.m128i_u8[1] + 0x200] ^ Sbox[2 * X.xmm.m128i_u8[2] + 0x201] ^ Sbox[2 * X.xmm.m128i_u8[3]]
-		);
-	#endif
-	}
-#endif
-
-template<typename T, typename U>
-T Fe0(const T X, std::vector<U> &Sbox)
-{
-	return Sbox[2 * (byte)X] ^ Sbox[2 * (byte)(X >> 8) + 0x001] ^ Sbox[2 * (byte)(X >> 16) + 0x200] ^ Sbox[2 * (byte)(X >> 24) + 0x201];
-}
-
-template<typename T, typename U>
-T Fe3(const T X, const std::vector<U> &Sbox)
-{
-	return Sbox[2 * (byte)X + 0x001] ^ Sbox[2 * (byte)(X >> 8) + 0x200] ^ Sbox[2 * (byte)(X >> 16) + 0x201] ^ Sbox[2 * (byte)(X >> 24)];
-}
-
 //~~~Twofish S-Box and Lookup Tables~~~//
 
 static byte Q0[] =
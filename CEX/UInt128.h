@@ -149,6 +149,19 @@ public:
 		xmm = _mm_set_epi32((uint)Input[Offset], (uint)Input[Offset + 1], (uint)Input[Offset + 2], (uint)Input[Offset + 3]);
 	}
 
+	/// <summary>
+	/// Load 4 * 16bit unsigned integers into a register.
+	/// <para>Each integer is zero extended to a 32bit lane; the lanes are in array order.</para>
+	/// </summary>
+	///
+	/// <param name="Input">The source 16bit integer array; must be at least 64 bits in length</param>
+	/// <param name="Offset">The starting offset within the Input array</param>
+	template <typename Array>
+	inline void LoadUS(const Array &Input, size_t Offset)
+	{
+		xmm = _mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(&Input[Offset])));
+	}
+
 	/// <summary>
 	/// Transposes and loads 4 * UInt128 at 32bit boundaries into an array
 	/// </summary>
@@ -181,6 +194,32 @@ public:
 		_mm_storeu_si128(reinterpret_cast<__m128i*>(&Output[Offset]), xmm);
 	}
 
+	/// <summary>
+	/// Store the 4 * 32bit lanes of the register in a 16bit unsigned integer array.
+	/// <para>Each lane must be within the range of a 16bit unsigned integer.</para>
+	/// </summary>
+	///
+	/// <param name="Output">The destination 16bit integer array; must be at least 64 bits in length</param>
+	/// <param name="Offset">The starting offset within the Output array</param>
+	template <typename Array>
+	inline void StoreUS(Array &Output, size_t Offset) const
+	{
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(&Output[Offset]), _mm_packus_epi32(xmm, xmm));
+	}
+
+	/// <summary>
+	/// Store register in an integer array using a non-temporal hint, bypassing the cache hierarchy.
+	/// <para>Used for large outputs that will not be read back soon; a store fence is required before the data is shared with another thread.</para>
+	/// </summary>
+	///
+	/// <param name="Output">The destination integer array; the address must be aligned on a 16 byte boundary</param>
+	/// <param name="Offset">The starting offset within the Output array</param>
+	template <typename Array>
+	inline void StoreNT(Array &Output, size_t Offset) const
+	{
+		_mm_stream_si128(reinterpret_cast<__m128i*>(&Output[Offset]), xmm);
+	}
+
 	/// <summary>
 	/// Transposes and stores 4 * UInt128 to an array
 	/// </summary>
@@ -227,39 +266,7 @@ public:
 	inline static void Store16(Array &Output, size_t Offset, UInt128 &X0, UInt128 &X1, UInt128 &X2, UInt128 &X3, UInt128 &X4, UInt128 &X5,
 		UInt128 &X6, UInt128 &X7, UInt128 &X8, UInt128 &X9, UInt128 &X10, UInt128 &X11, UInt128 &X12, UInt128 &X13, UInt128 &X14, UInt128 &X15)
 	{
-		__m128i T0 = _mm_unpacklo_epi32(X0.xmm, X1.xmm);
-		__m128i T1 = _mm_unpacklo_epi32(X2.xmm, X3.xmm);
-		__m128i T2 = _mm_unpacklo_epi32(X4.xmm, X5.xmm);
-		__m128i T3 = _mm_unpacklo_epi32(X6.xmm, X7.xmm);
-		__m128i T4 = _mm_unpacklo_epi32(X8.xmm, X9.xmm);
-		__m128i T5 = _mm_unpacklo_epi32(X10.xmm, X11.xmm);
-		__m128i T6 = _mm_unpacklo_epi32(X12.xmm, X13.xmm);
-		__m128i T7 = _mm_unpacklo_epi32(X14.xmm, X15.xmm);
-		__m128i T8 = _mm_unpackhi_epi32(X0.xmm, X1.xmm);
-		__m128i T9 = _mm_unpackhi_epi32(X2.xmm, X3.xmm);
-		__m128i T10 = _mm_unpackhi_epi32(X4.xmm, X5.xmm);
-		__m128i T11 = _mm_unpackhi_epi32(X6.xmm, X7.xmm);
-		__m128i T12 = _mm_unpackhi_epi32(X8.xmm, X9.xmm);
-		__m128i T13 = _mm_unpackhi_epi32(X10.xmm, X11.xmm);
-		__m128i T14 = _mm_unpackhi_epi32(X12.xmm, X13.xmm);
-		__m128i T15 = _mm_unpackhi_epi32(X14.xmm, X15.xmm);
-
-		X0.xmm = _mm_unpacklo_epi64(T0, T1);
-		X1.xmm = _mm_unpacklo_epi64(T2, T3);
-		X2.xmm = _mm_unpacklo_epi64(T4, T5);
-		X3.xmm = _mm_unpacklo_epi64(T6, T7);
-		X4.xmm = _mm_unpackhi_epi64(T0, T1);
-		X5.xmm = _mm_unpackhi_epi64(T2, T3);
-		X6.xmm = _mm_unpackhi_epi64(T4, T5);
-		X7.xmm = _mm_unpackhi_epi64(T6, T7);
-		X8.xmm = _mm_unpacklo_epi64(T8, T9);
-		X9.xmm = _mm_unpacklo_epi64(T10, T11);
-		X10.xmm = _mm_unpacklo_epi64(T12, T13);
-		X11.xmm = _mm_unpacklo_epi64(T14, T15);
-		X12.xmm = _mm_unpackhi_epi64(T8, T9);
-		X13.xmm = _mm_unpackhi_epi64(T10, T11);
-		X14.xmm = _mm_unpackhi_epi64(T12, T13);
-		X15.xmm = _mm_unpackhi_epi64(T14, T15);
+		Transpose16(X0, X1, X2, X3, X4, X5, X6, X7, X8, X9, X10, X11, X12, X13, X14, X15);
 
 		X0.Store(Output, Offset);
 		X1.Store(Output, Offset + (16 / sizeof(Output[0])));
@@ -395,6 +402,20 @@ public:
 		return UInt128(_mm_srl_epi32(Value, _mm_set1_epi32(Shift)));
 	}
 
+	/// <summary>
+	/// Shuffles the 8bit integers in a register using the byte indices in a mask.
+	/// <para>A mask byte with the high bit set zeroes the corresponding output byte.</para>
+	/// </summary>
+	///
+	/// <param name="Value">The integers to shuffle</param>
+	/// <param name="Mask">The byte index mask</param>
+	/// 
+	/// <returns>The shuffled UInt128</returns>
+	inline static UInt128 Shuffle8(const UInt128 &Value, const UInt128 &Mask)
+	{
+		return UInt128(_mm_shuffle_epi8(Value.xmm, Mask.xmm));
+	}
+
 	/// <summary>
 	/// Performs a byte swap on 4 unsigned integers
 	/// </summary>
@@ -454,6 +475,65 @@ public:
 		X3.xmm = _mm_unpackhi_epi64(T2, T3);
 	}
 
+	/// <summary>
+	/// Transposes 16 * UInt128 registers of 32bit state words into UInt128 registers of sequential output blocks.
+	/// <para>After the transform the registers X0 to X15 hold the output in memory order.</para>
+	/// </summary>
+	///
+	/// <param name="X0">Operand 0</param>
+	/// <param name="X1">Operand 1</param>
+	/// <param name="X2">Operand 2</param>
+	/// <param name="X3">Operand 3</param>
+	/// <param name="X4">Operand 4</param>
+	/// <param name="X5">Operand 5</param>
+	/// <param name="X6">Operand 6</param>
+	/// <param name="X7">Operand 7</param>
+	/// <param name="X8">Operand 8</param>
+	/// <param name="X9">Operand 9</param>
+	/// <param name="X10">Operand 10</param>
+	/// <param name="X11">Operand 11</param>
+	/// <param name="X12">Operand 12</param>
+	/// <param name="X13">Operand 13</param>
+	/// <param name="X14">Operand 14</param>
+	/// <param name="X15">Operand 15</param>
+	inline static void Transpose16(UInt128 &X0, UInt128 &X1, UInt128 &X2, UInt128 &X3, UInt128 &X4, UInt128 &X5,
+		UInt128 &X6, UInt128 &X7, UInt128 &X8, UInt128 &X9, UInt128 &X10, UInt128 &X11, UInt128 &X12, UInt128 &X13, UInt128 &X14, UInt128 &X15)
+	{
+		__m128i T0 = _mm_unpacklo_epi32(X0.xmm, X1.xmm);
+		__m128i T1 = _mm_unpacklo_epi32(X2.xmm, X3.xmm);
+		__m128i T2 = _mm_unpacklo_epi32(X4.xmm, X5.xmm);
+		__m128i T3 = _mm_unpacklo_epi32(X6.xmm, X7.xmm);
+		__m128i T4 = _mm_unpacklo_epi32(X8.xmm, X9.xmm);
+		__m128i T5 = _mm_unpacklo_epi32(X10.xmm, X11.xmm);
+		__m128i T6 = _mm_unpacklo_epi32(X12.xmm, X13.xmm);
+		__m128i T7 = _mm_unpacklo_epi32(X14.xmm, X15.xmm);
+		__m128i T8 = _mm_unpackhi_epi32(X0.xmm, X1.xmm);
+		__m128i T9 = _mm_unpackhi_epi32(X2.xmm, X3.xmm);
+		__m128i T10 = _mm_unpackhi_epi32(X4.xmm, X5.xmm);
+		__m128i T11 = _mm_unpackhi_epi32(X6.xmm, X7.xmm);
+		__m128i T12 = _mm_unpackhi_epi32(X8.xmm, X9.xmm);
+		__m128i T13 = _mm_unpackhi_epi32(X10.xmm, X11.xmm);
+		__m128i T14 = _mm_unpackhi_epi32(X12.xmm, X13.xmm);
+		__m128i T15 = _mm_unpackhi_epi32(X14.xmm, X15.xmm);
+
+		X0.xmm = _mm_unpacklo_epi64(T0, T1);
+		X1.xmm = _mm_unpacklo_epi64(T2, T3);
+		X2.xmm = _mm_unpacklo_epi64(T4, T5);
+		X3.xmm = _mm_unpacklo_epi64(T6, T7);
+		X4.xmm = _mm_unpackhi_epi64(T0, T1);
+		X5.xmm = _mm_unpackhi_epi64(T2, T3);
+		X6.xmm = _mm_unpackhi_epi64(T4, T5);
+		X7.xmm = _mm_unpackhi_epi64(T6, T7);
+		X8.xmm = _mm_unpacklo_epi64(T8, T9);
+		X9.xmm = _mm_unpacklo_epi64(T10, T11);
+		X10.xmm = _mm_unpacklo_epi64(T12, T13);
+		X11.xmm = _mm_unpacklo_epi64(T14, T15);
+		X12.xmm = _mm_unpackhi_epi64(T8, T9);
+		X13.xmm = _mm_unpackhi_epi64(T10, T11);
+		X14.xmm = _mm_unpackhi_epi64(T12, T13);
+		X15.xmm = _mm_unpackhi_epi64(T14, T15);
+	}
+
 	//~~~ Operators~~~//
 
 	/// <summary>
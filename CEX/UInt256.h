@@ -158,6 +158,19 @@ public:
 			(uint)Input[Offset + 4], (uint)Input[Offset + 5], (uint)Input[Offset + 6], (uint)Input[Offset + 7]);
 	}
 
+	/// <summary>
+	/// Load 8 * 16bit unsigned integers into a register.
+	/// <para>Each integer is zero extended to a 32bit lane; the lanes are in array order.</para>
+	/// </summary>
+	///
+	/// <param name="Input">The source 16bit integer array; must be at least 128 bits in length</param>
+	/// <param name="Offset">The starting offset within the Input array</param>
+	template <typename Array>
+	inline void LoadUS(const Array &Input, size_t Offset)
+	{
+		ymm = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&Input[Offset])));
+	}
+
 	/// <summary>
 	/// Transposes and loads 4 * UInt256 at 32bit boundaries into an array
 	/// </summary>
@@ -190,6 +203,34 @@ public:
 		_mm256_storeu_si256(reinterpret_cast<__m256i*>(&Output[Offset]), ymm);
 	}
 
+	/// <summary>
+	/// Store the 8 * 32bit lanes of the register in a 16bit unsigned integer array.
+	/// <para>Each lane must be within the range of a 16bit unsigned integer.</para>
+	/// </summary>
+	///
+	/// <param name="Output">The destination 16bit integer array; must be at least 128 bits in length</param>
+	/// <param name="Offset">The starting offset within the Output array</param>
+	template <typename Array>
+	inline void StoreUS(Array &Output, size_t Offset) const
+	{
+		// pack each 128bit lane, then gather the low 64bits of both lanes
+		__m256i tmp = _mm256_permute4x64_epi64(_mm256_packus_epi32(ymm, ymm), 0x08);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&Output[Offset]), _mm256_castsi256_si128(tmp));
+	}
+
+	/// <summary>
+	/// Store register in an integer array using a non-temporal hint, bypassing the cache hierarchy.
+	/// <para>Used for large outputs that will not be read back soon; a store fence is required before the data is shared with another thread.</para>
+	/// </summary>
+	///
+	/// <param name="Output">The destination integer array; the address must be aligned on a 32 byte boundary</param>
+	/// <param name="Offset">The starting offset within the Output array</param>
+	template <typename Array>
+	inline void StoreNT(Array &Output, size_t Offset) const
+	{
+		_mm256_stream_si256(reinterpret_cast<__m256i*>(&Output[Offset]), ymm);
+	}
+
 	/// <summary>
 	/// Transposes and stores 4 * UInt256 to an array
 	/// </summary>
@@ -236,51 +277,23 @@ public:
 	inline static void Store16(Array &Output, size_t Offset, UInt256 &X0, UInt256 &X1, UInt256 &X2, UInt256 &X3, UInt256 &X4, UInt256 &X5,
 		UInt256 &X6, UInt256 &X7, UInt256 &X8, UInt256 &X9, UInt256 &X10, UInt256 &X11, UInt256 &X12, UInt256 &X13, UInt256 &X14, UInt256 &X15)
 	{
-		__m256i W0, W1, W2, W3, W4, W5, W6, W7, W8, W9, W10, W11, W12, W13, W14, W15;
-		__m256i Y0, Y1, Y2, Y3, Y4, Y5, Y6, Y7, Y8, Y9, Y10, Y11, Y12, Y13, Y14, Y15;
-
-		_mm256_merge_epi32(X0.ymm, X1.ymm, W0, W1);
-		_mm256_merge_epi32(X2.ymm, X3.ymm, W2, W3);
-		_mm256_merge_epi32(X4.ymm, X5.ymm, W4, W5);
-		_mm256_merge_epi32(X6.ymm, X7.ymm, W6, W7);
-		_mm256_merge_epi32(X8.ymm, X9.ymm, W8, W9);
-		_mm256_merge_epi32(X10.ymm, X11.ymm, W10, W11);
-		_mm256_merge_epi32(X12.ymm, X13.ymm, W12, W13);
-		_mm256_merge_epi32(X14.ymm, X15.ymm, W14, W15);
-
-		_mm256_merge_epi64(W0, W2, Y0, Y1);
-		_mm256_merge_epi64(W4, W6, Y2, Y3);
-		_mm256_merge_epi64(W8, W10, Y4, Y5);
-		_mm256_merge_epi64(W12, W14, Y6, Y7);
-		_mm256_merge_epi64(W1, W3, Y8, Y9);
-		_mm256_merge_epi64(W5, W7, Y10, Y11);
-		_mm256_merge_epi64(W9, W11, Y12, Y13);
-		_mm256_merge_epi64(W13, W15, Y14, Y15);
-
-		_mm256_merge_si128(Y0, Y2, X0.ymm, X1.ymm);
-		_mm256_merge_si128(Y1, Y3, X2.ymm, X3.ymm);
-		_mm256_merge_si128(Y8, Y10, X4.ymm, X5.ymm);
-		_mm256_merge_si128(Y9, Y11, X6.ymm, X7.ymm);
-		_mm256_merge_si128(Y4, Y6, X8.ymm, X9.ymm);
-		_mm256_merge_si128(Y5, Y7, X10.ymm, X11.ymm);
-		_mm256_merge_si128(Y12, Y14, X12.ymm, X13.ymm);
-		_mm256_merge_si128(Y13, Y15, X14.ymm, X15.ymm);
+		Transpose16(X0, X1, X2, X3, X4, X5, X6, X7, X8, X9, X10, X11, X12, X13, X14, X15);
 
 		X0.Store(Output, Offset);
-		X8.Store(Output, Offset + (32 / sizeof(Output[0])));
-		X1.Store(Output, Offset + (64 / sizeof(Output[0])));
-		X9.Store(Output, Offset + (96 / sizeof(Output[0])));
-		X2.Store(Output, Offset + (128 / sizeof(Output[0])));
-		X10.Store(Output, Offset + (160 / sizeof(Output[0])));
-		X3.Store(Output, Offset + (192 / sizeof(Output[0])));
-		X11.Store(Output, Offset + (224 / sizeof(Output[0])));
-		X4.Store(Output, Offset + (256 / sizeof(Output[0])));
-		X12.Store(Output, Offset + (288 / sizeof(Output[0])));
-		X5.Store(Output, Offset + (320 / sizeof(Output[0])));
-		X13.Store(Output, Offset + (352 / sizeof(Output[0])));
-		X6.Store(Output, Offset + (384 / sizeof(Output[0])));
-		X14.Store(Output, Offset + (416 / sizeof(Output[0])));
-		X7.Store(Output, Offset + (448 / sizeof(Output[0])));
+		X1.Store(Output, Offset + (32 / sizeof(Output[0])));
+		X2.Store(Output, Offset + (64 / sizeof(Output[0])));
+		X3.Store(Output, Offset + (96 / sizeof(Output[0])));
+		X4.Store(Output, Offset + (128 / sizeof(Output[0])));
+		X5.Store(Output, Offset + (160 / sizeof(Output[0])));
+		X6.Store(Output, Offset + (192 / sizeof(Output[0])));
+		X7.Store(Output, Offset + (224 / sizeof(Output[0])));
+		X8.Store(Output, Offset + (256 / sizeof(Output[0])));
+		X9.Store(Output, Offset + (288 / sizeof(Output[0])));
+		X10.Store(Output, Offset + (320 / sizeof(Output[0])));
+		X11.Store(Output, Offset + (352 / sizeof(Output[0])));
+		X12.Store(Output, Offset + (384 / sizeof(Output[0])));
+		X13.Store(Output, Offset + (416 / sizeof(Output[0])));
+		X14.Store(Output, Offset + (448 / sizeof(Output[0])));
 		X15.Store(Output, Offset + (480 / sizeof(Output[0])));
 	}
 
@@ -410,6 +423,20 @@ public:
 		return UInt256(_mm256_srl_epi32(Value, _mm_set1_epi32(Shift)));
 	}
 
+	/// <summary>
+	/// Shuffles the 8bit integers in a register using the byte indices in a mask; the shuffle is performed within each 128bit lane.
+	/// <para>A mask byte with the high bit set zeroes the corresponding output byte.</para>
+	/// </summary>
+	///
+	/// <param name="Value">The integers to shuffle</param>
+	/// <param name="Mask">The byte index mask</param>
+	/// 
+	/// <returns>The shuffled UInt256</returns>
+	inline static UInt256 Shuffle8(const UInt256 &Value, const UInt256 &Mask)
+	{
+		return UInt256(_mm256_shuffle_epi8(Value.ymm, Mask.ymm));
+	}
+
 	/// <summary>
 	/// Performs a byte swap on 4 unsigned integers
 	/// </summary>
@@ -462,6 +489,61 @@ public:
 		X3.ymm = _mm256_unpackhi_epi64(T2, T3);
 	}
 
+	/// <summary>
+	/// Transposes 16 * UInt256 registers of 32bit state words into UInt256 registers of sequential output blocks.
+	/// <para>After the transform the registers X0 to X15 hold the output in memory order.</para>
+	/// </summary>
+	///
+	/// <param name="X0">Operand 0</param>
+	/// <param name="X1">Operand 1</param>
+	/// <param name="X2">Operand 2</param>
+	/// <param name="X3">Operand 3</param>
+	/// <param name="X4">Operand 4</param>
+	/// <param name="X5">Operand 5</param>
+	/// <param name="X6">Operand 6</param>
+	/// <param name="X7">Operand 7</param>
+	/// <param name="X8">Operand 8</param>
+	/// <param name="X9">Operand 9</param>
+	/// <param name="X10">Operand 10</param>
+	/// <param name="X11">Operand 11</param>
+	/// <param name="X12">Operand 12</param>
+	/// <param name="X13">Operand 13</param>
+	/// <param name="X14">Operand 14</param>
+	/// <param name="X15">Operand 15</param>
+	inline static void Transpose16(UInt256 &X0, UInt256 &X1, UInt256 &X2, UInt256 &X3, UInt256 &X4, UInt256 &X5,
+		UInt256 &X6, UInt256 &X7, UInt256 &X8, UInt256 &X9, UInt256 &X10, UInt256 &X11, UInt256 &X12, UInt256 &X13, UInt256 &X14, UInt256 &X15)
+	{
+		__m256i W0, W1, W2, W3, W4, W5, W6, W7, W8, W9, W10, W11, W12, W13, W14, W15;
+		__m256i Y0, Y1, Y2, Y3, Y4, Y5, Y6, Y7, Y8, Y9, Y10, Y11, Y12, Y13, Y14, Y15;
+
+		_mm256_merge_epi32(X0.ymm, X1.ymm, W0, W1);
+		_mm256_merge_epi32(X2.ymm, X3.ymm, W2, W3);
+		_mm256_merge_epi32(X4.ymm, X5.ymm, W4, W5);
+		_mm256_merge_epi32(X6.ymm, X7.ymm, W6, W7);
+		_mm256_merge_epi32(X8.ymm, X9.ymm, W8, W9);
+		_mm256_merge_epi32(X10.ymm, X11.ymm, W10, W11);
+		_mm256_merge_epi32(X12.ymm, X13.ymm, W12, W13);
+		_mm256_merge_epi32(X14.ymm, X15.ymm, W14, W15);
+
+		_mm256_merge_epi64(W0, W2, Y0, Y1);
+		_mm256_merge_epi64(W4, W6, Y2, Y3);
+		_mm256_merge_epi64(W8, W10, Y4, Y5);
+		_mm256_merge_epi64(W12, W14, Y6, Y7);
+		_mm256_merge_epi64(W1, W3, Y8, Y9);
+		_mm256_merge_epi64(W5, W7, Y10, Y11);
+		_mm256_merge_epi64(W9, W11, Y12, Y13);
+		_mm256_merge_epi64(W13, W15, Y14, Y15);
+
+		_mm256_merge_si128(Y0, Y2, X0.ymm, X2.ymm);
+		_mm256_merge_si128(Y1, Y3, X4.ymm, X6.ymm);
+		_mm256_merge_si128(Y8, Y10, X8.ymm, X10.ymm);
+		_mm256_merge_si128(Y9, Y11, X12.ymm, X14.ymm);
+		_mm256_merge_si128(Y4, Y6, X1.ymm, X3.ymm);
+		_mm256_merge_si128(Y5, Y7, X5.ymm, X7.ymm);
+		_mm256_merge_si128(Y12, Y14, X9.ymm, X11.ymm);
+		_mm256_merge_si128(Y13, Y15, X13.ymm, X15.ymm);
+	}
+
 	//~~~ Operators~~~//
 
 	/// <summary>
@@ -649,7 +731,7 @@ public:
 	/// </summary>
 	///
 	/// <param name="X">The value to OR</param>
-	inline UInt256 operator | (const UInt256 &X)
+	inline UInt256 operator | (const UInt256 &X) const
 	{
 		return UInt256(_mm256_or_si256(ymm, X.ymm));
 	}
@@ -679,7 +761,7 @@ public:
 	/// </summary>
 	///
 	/// <param name="X">The value to AND</param>
-	inline UInt256 operator & (const UInt256 &X)
+	inline UInt256 operator & (const UInt256 &X) const
 	{
 		return UInt256(_mm256_and_si256(ymm, X.ymm));
 	}
@@ -70,8 +70,8 @@ public:
 	/// Initialize the register with an __m512i value
 	/// </summary>
 	///
-	/// <param name="Z">The 256bit register</param>
-	explicit UInt128(__m128i const &Z)
+	/// <param name="Z">The 512bit register</param>
+	explicit UInt512(__m512i const &Z)
 	{
 		zmm = Z;
 	}
@@ -111,7 +111,7 @@ public:
 	explicit UInt512(uint X0, uint X1, uint X2, uint X3, uint X4, uint X5, uint X6, uint X7,
 		uint X8, uint X9, uint X10, uint X11, uint X12, uint X13, uint X14, uint X15)
 	{
-		zmm = _mm512_set_epi32(X0, X1, X2, X3, X4, X5, X6, X7);
+		zmm = _mm512_set_epi32(X0, X1, X2, X3, X4, X5, X6, X7, X8, X9, X10, X11, X12, X13, X14, X15);
 	}
 
 	/// <summary>
@@ -180,6 +180,19 @@ public:
 					(uint)Input[Offset + 12], (uint)Input[Offset + 13], (uint)Input[Offset + 14], (uint)Input[Offset + 15]);
 	}
 
+	/// <summary>
+	/// Load 16 * 16bit unsigned integers into a register.
+	/// <para>Each integer is zero extended to a 32bit lane; the lanes are in array order.</para>
+	/// </summary>
+	///
+	/// <param name="Input">The source 16bit integer array; must be at least 256 bits in length</param>
+	/// <param name="Offset">The starting offset within the Input array</param>
+	template <typename Array>
+	inline void LoadUS(const Array &Input, size_t Offset)
+	{
+		zmm = _mm512_cvtepu16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&Input[Offset])));
+	}
+
 	/// <summary>
 	/// Transposes and loads 4 * UInt512 to an integer array
 	/// </summary>
@@ -212,6 +225,32 @@ public:
 		_mm512_storeu_si512(reinterpret_cast<__m512i*>(&Output[Offset]), zmm);
 	}
 
+	/// <summary>
+	/// Store the 16 * 32bit lanes of the register in a 16bit unsigned integer array.
+	/// <para>Each lane must be within the range of a 16bit unsigned integer.</para>
+	/// </summary>
+	///
+	/// <param name="Output">The destination 16bit integer array; must be at least 256 bits in length</param>
+	/// <param name="Offset">The starting offset within the Output array</param>
+	template <typename Array>
+	inline void StoreUS(Array &Output, size_t Offset) const
+	{
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(&Output[Offset]), _mm512_cvtepi32_epi16(zmm));
+	}
+
+	/// <summary>
+	/// Store register in an integer array using a non-temporal hint, bypassing the cache hierarchy.
+	/// <para>Used for large outputs that will not be read back soon; a store fence is required before the data is shared with another thread.</para>
+	/// </summary>
+	///
+	/// <param name="Output">The destination integer array; the address must be aligned on a 64 byte boundary</param>
+	/// <param name="Offset">The starting offset within the Output array</param>
+	template<typename Array>
+	inline void StoreNT(Array &Output, size_t Offset) const
+	{
+		_mm512_stream_si512(reinterpret_cast<__m512i*>(&Output[Offset]), zmm);
+	}
+
 	/// <summary>
 	/// Transposes and stores 4 * UInt512 to an integer array
 	/// </summary>
@@ -258,75 +297,7 @@ public:
 	inline static void Store16(Array &Output, size_t Offset, UInt512 &X0, UInt512 &X1, UInt512 &X2, UInt512 &X3, UInt512 &X4, UInt512 &X5,
 		UInt512 &X6, UInt512 &X7, UInt512 &X8, UInt512 &X9, UInt512 &X10, UInt512 &X11, UInt512 &X12, UInt512 &X13, UInt512 &X14, UInt512 &X15)
 	{
-		__m512i T0, T1, T2, T3, T4, T5, T6, T7, T8, T9, T10, T11, T12, T13, T14, T15;
-
-		T0 = _mm512_unpacklo_epi32(X0, X1);
-		T1 = _mm512_unpackhi_epi32(X0, X1);
-		T2 = _mm512_unpacklo_epi32(X2, X3);
-		T3 = _mm512_unpackhi_epi32(X2, X3);
-		T4 = _mm512_unpacklo_epi32(X4, X5);
-		T5 = _mm512_unpackhi_epi32(X4, X5);
-		T6 = _mm512_unpacklo_epi32(X6, X7);
-		T7 = _mm512_unpackhi_epi32(X6, X7);
-		T8 = _mm512_unpacklo_epi32(X8, X9);
-		T9 = _mm512_unpackhi_epi32(X8, X9);
-		T10 = _mm512_unpacklo_epi32(X10, X11);
-		T11 = _mm512_unpackhi_epi32(X10, X11);
-		T12 = _mm512_unpacklo_epi32(X12, X13);
-		T13 = _mm512_unpackhi_epi32(X12, X13);
-		T14 = _mm512_unpacklo_epi32(X14, X15);
-		T15 = _mm512_unpackhi_epi32(X14, X15);
-
-		X0 = _mm512_unpacklo_epi64(T0, T2);
-		X1 = _mm512_unpackhi_epi64(T0, T2);
-		X2 = _mm512_unpacklo_epi64(T1, T3);
-		X3 = _mm512_unpackhi_epi64(T1, T3);
-		X4 = _mm512_unpacklo_epi64(T4, T6);
-		X5 = _mm512_unpackhi_epi64(T4, T6);
-		X6 = _mm512_unpacklo_epi64(T5, T7);
-		X7 = _mm512_unpackhi_epi64(T5, T7);
-		X8 = _mm512_unpacklo_epi64(T8, T10);
-		X9 = _mm512_unpackhi_epi64(T8, T10);
-		X10 = _mm512_unpacklo_epi64(T9, T11);
-		X11 = _mm512_unpackhi_epi64(T9, T11);
-		X12 = _mm512_unpacklo_epi64(T12, T14);
-		X13 = _mm512_unpackhi_epi64(T12, T14);
-		X14 = _mm512_unpacklo_epi64(T13, T15);
-		X15 = _mm512_unpackhi_epi64(T13, T15);
-
-		T0 = _mm512_shuffle_i32x4(X0, X4, 0x88);
-		T1 = _mm512_shuffle_i32x4(X1, X5, 0x88);
-		T2 = _mm512_shuffle_i32x4(X2, X6, 0x88);
-		T3 = _mm512_shuffle_i32x4(X3, X7, 0x88);
-		T4 = _mm512_shuffle_i32x4(X0, X4, 0xDD);
-		T5 = _mm512_shuffle_i32x4(X1, X5, 0xDD);
-		T6 = _mm512_shuffle_i32x4(X2, X6, 0xDD);
-		T7 = _mm512_shuffle_i32x4(X3, X7, 0xDD);
-		T8 = _mm512_shuffle_i32x4(X8, X12, 0x88);
-		T9 = _mm512_shuffle_i32x4(X9, X13, 0x88);
-		T10 = _mm512_shuffle_i32x4(X10, X14, 0x88);
-		T11 = _mm512_shuffle_i32x4(X11, X15, 0x88);
-		T12 = _mm512_shuffle_i32x4(X8, X12, 0xDD);
-		T13 = _mm512_shuffle_i32x4(X9, X13, 0xDD);
-		T14 = _mm512_shuffle_i32x4(X10, X14, 0xDD);
-		T15 = _mm512_shuffle_i32x4(X11, X15, 0xDD);
-
-		X0 = _mm512_shuffle_i32x4(T0, T8, 0x88);
-		X1 = _mm512_shuffle_i32x4(T1, T9, 0x88);
-		X2 = _mm512_shuffle_i32x4(T2, T10, 0x88);
-		X3 = _mm512_shuffle_i32x4(T3, T11, 0x88);
-		X4 = _mm512_shuffle_i32x4(T4, T12, 0x88);
-		X5 = _mm512_shuffle_i32x4(T5, T13, 0x88);
-		X6 = _mm512_shuffle_i32x4(T6, T14, 0x88);
-		X7 = _mm512_shuffle_i32x4(T7, T15, 0x88);
-		X8 = _mm512_shuffle_i32x4(T0, T8, 0xDD);
-		X9 = _mm512_shuffle_i32x4(T1, T9, 0xDD);
-		X10 = _mm512_shuffle_i32x4(T2, T10, 0xDD);
-		X11 = _mm512_shuffle_i32x4(T3, T11, 0xDD);
-		X12 = _mm512_shuffle_i32x4(T4, T12, 0xDD);
-		X13 = _mm512_shuffle_i32x4(T5, T13, 0xDD);
-		X14 = _mm512_shuffle_i32x4(T6, T14, 0xDD);
-		X15 = _mm512_shuffle_i32x4(T7, T15, 0xDD);
+		Transpose16(X0, X1, X2, X3, X4, X5, X6, X7, X8, X9, X10, X11, X12, X13, X14, X15);
 
 		X0.Store(Output, Offset);
 		X1.Store(Output, Offset + (64 / sizeof(Output[0])));
@@ -372,12 +343,24 @@ public:
 		return UInt512(_mm512_andnot_si512(zmm, X.zmm));
 	}
 
+	/// <summary>
+	/// Returns the bitwise negation of 16 32bit integers
+	/// </summary>
+	///
+	/// <param name="Value">The integers to negate</param>
+	/// 
+	/// <returns>The processed UInt512</returns>
+	inline static UInt512 Negate(const UInt512 &Value)
+	{
+		return UInt512(_mm512_sub_epi32(_mm512_set1_epi32(0), Value.zmm));
+	}
+
 	/// <summary>
 	/// Returns the length of the register in bytes
 	/// </summary>
 	///
 	/// <returns>The registers size</returns>
-	const size_t size() { return sizeof(__m512i); }
+	inline static const size_t size() { return sizeof(__m512i); }
 
 	/// <summary>
 	/// Computes the 32 bit left rotation of four unsigned integers
@@ -387,7 +370,8 @@ public:
 	inline void RotL32(const int Shift)
 	{
 		CexAssert(Shift <= 32, "Shift size is too large");
-		zmm = _mm512_or_si512(_mm512_slli_epi32(zmm, static_cast<int>(Shift)), _mm512_srli_epi32(zmm, static_cast<int>(32 - Shift)));
+		// AVX-512 has a native rotate; the shift is broadcast once and each rotate is a single vprolvd
+		zmm = _mm512_rolv_epi32(zmm, _mm512_set1_epi32(Shift));
 	}
 
 	/// <summary>
@@ -401,7 +385,7 @@ public:
 	inline static  UInt512 RotL32(const UInt512 &X, const int Shift)
 	{
 		CexAssert(Shift <= 32, "Shift size is too large");
-		return UInt512(_mm512_or_si512(_mm512_slli_epi32(X.zmm, static_cast<int>(Shift)), _mm512_srli_epi32(X.zmm, static_cast<int>(32 - Shift))));
+		return UInt512(_mm512_rolv_epi32(X.zmm, _mm512_set1_epi32(Shift)));
 	}
 
 	/// <summary>
@@ -509,6 +493,101 @@ public:
 		X3.zmm = _mm512_unpackhi_epi64(T2, T3);
 	}
 
+	/// <summary>
+	/// Transposes 16 * UInt512 registers of 32bit state words into UInt512 registers of sequential output blocks.
+	/// <para>After the transform the registers X0 to X15 hold the output in memory order.</para>
+	/// </summary>
+	///
+	/// <param name="X0">Operand 0</param>
+	/// <param name="X1">Operand 1</param>
+	/// <param name="X2">Operand 2</param>
+	/// <param name="X3">Operand 3</param>
+	/// <param name="X4">Operand 4</param>
+	/// <param name="X5">Operand 5</param>
+	/// <param name="X6">Operand 6</param>
+	/// <param name="X7">Operand 7</param>
+	/// <param name="X8">Operand 8</param>
+	/// <param name="X9">Operand 9</param>
+	/// <param name="X10">Operand 10</param>
+	/// <param name="X11">Operand 11</param>
+	/// <param name="X12">Operand 12</param>
+	/// <param name="X13">Operand 13</param>
+	/// <param name="X14">Operand 14</param>
+	/// <param name="X15">Operand 15</param>
+	inline static void Transpose16(UInt512 &X0, UInt512 &X1, UInt512 &X2, UInt512 &X3, UInt512 &X4, UInt512 &X5,
+		UInt512 &X6, UInt512 &X7, UInt512 &X8, UInt512 &X9, UInt512 &X10, UInt512 &X11, UInt512 &X12, UInt512 &X13, UInt512 &X14, UInt512 &X15)
+	{
+		__m512i T0, T1, T2, T3, T4, T5, T6, T7, T8, T9, T10, T11, T12, T13, T14, T15;
+
+		T0 = _mm512_unpacklo_epi32(X0.zmm, X1.zmm);
+		T1 = _mm512_unpackhi_epi32(X0.zmm, X1.zmm);
+		T2 = _mm512_unpacklo_epi32(X2.zmm, X3.zmm);
+		T3 = _mm512_unpackhi_epi32(X2.zmm, X3.zmm);
+		T4 = _mm512_unpacklo_epi32(X4.zmm, X5.zmm);
+		T5 = _mm512_unpackhi_epi32(X4.zmm, X5.zmm);
+		T6 = _mm512_unpacklo_epi32(X6.zmm, X7.zmm);
+		T7 = _mm512_unpackhi_epi32(X6.zmm, X7.zmm);
+		T8 = _mm512_unpacklo_epi32(X8.zmm, X9.zmm);
+		T9 = _mm512_unpackhi_epi32(X8.zmm, X9.zmm);
+		T10 = _mm512_unpacklo_epi32(X10.zmm, X11.zmm);
+		T11 = _mm512_unpackhi_epi32(X10.zmm, X11.zmm);
+		T12 = _mm512_unpacklo_epi32(X12.zmm, X13.zmm);
+		T13 = _mm512_unpackhi_epi32(X12.zmm, X13.zmm);
+		T14 = _mm512_unpacklo_epi32(X14.zmm, X15.zmm);
+		T15 = _mm512_unpackhi_epi32(X14.zmm, X15.zmm);
+
+		X0.zmm = _mm512_unpacklo_epi64(T0, T2);
+		X1.zmm = _mm512_unpackhi_epi64(T0, T2);
+		X2.zmm = _mm512_unpacklo_epi64(T1, T3);
+		X3.zmm = _mm512_unpackhi_epi64(T1, T3);
+		X4.zmm = _mm512_unpacklo_epi64(T4, T6);
+		X5.zmm = _mm512_unpackhi_epi64(T4, T6);
+		X6.zmm = _mm512_unpacklo_epi64(T5, T7);
+		X7.zmm = _mm512_unpackhi_epi64(T5, T7);
+		X8.zmm = _mm512_unpacklo_epi64(T8, T10);
+		X9.zmm = _mm512_unpackhi_epi64(T8, T10);
+		X10.zmm = _mm512_unpacklo_epi64(T9, T11);
+		X11.zmm = _mm512_unpackhi_epi64(T9, T11);
+		X12.zmm = _mm512_unpacklo_epi64(T12, T14);
+		X13.zmm = _mm512_unpackhi_epi64(T12, T14);
+		X14.zmm = _mm512_unpacklo_epi64(T13, T15);
+		X15.zmm = _mm512_unpackhi_epi64(T13, T15);
+
+		T0 = _mm512_shuffle_i32x4(X0.zmm, X4.zmm, 0x88);
+		T1 = _mm512_shuffle_i32x4(X1.zmm, X5.zmm, 0x88);
+		T2 = _mm512_shuffle_i32x4(X2.zmm, X6.zmm, 0x88);
+		T3 = _mm512_shuffle_i32x4(X3.zmm, X7.zmm, 0x88);
+		T4 = _mm512_shuffle_i32x4(X0.zmm, X4.zmm, 0xDD);
+		T5 = _mm512_shuffle_i32x4(X1.zmm, X5.zmm, 0xDD);
+		T6 = _mm512_shuffle_i32x4(X2.zmm, X6.zmm, 0xDD);
+		T7 = _mm512_shuffle_i32x4(X3.zmm, X7.zmm, 0xDD);
+		T8 = _mm512_shuffle_i32x4(X8.zmm, X12.zmm, 0x88);
+		T9 = _mm512_shuffle_i32x4(X9.zmm, X13.zmm, 0x88);
+		T10 = _mm512_shuffle_i32x4(X10.zmm, X14.zmm, 0x88);
+		T11 = _mm512_shuffle_i32x4(X11.zmm, X15.zmm, 0x88);
+		T12 = _mm512_shuffle_i32x4(X8.zmm, X12.zmm, 0xDD);
+		T13 = _mm512_shuffle_i32x4(X9.zmm, X13.zmm, 0xDD);
+		T14 = _mm512_shuffle_i32x4(X10.zmm, X14.zmm, 0xDD);
+		T15 = _mm512_shuffle_i32x4(X11.zmm, X15.zmm, 0xDD);
+
+		X0.zmm = _mm512_shuffle_i32x4(T0, T8, 0x88);
+		X1.zmm = _mm512_shuffle_i32x4(T1, T9, 0x88);
+		X2.zmm = _mm512_shuffle_i32x4(T2, T10, 0x88);
+		X3.zmm = _mm512_shuffle_i32x4(T3, T11, 0x88);
+		X4.zmm = _mm512_shuffle_i32x4(T4, T12, 0x88);
+		X5.zmm = _mm512_shuffle_i32x4(T5, T13, 0x88);
+		X6.zmm = _mm512_shuffle_i32x4(T6, T14, 0x88);
+		X7.zmm = _mm512_shuffle_i32x4(T7, T15, 0x88);
+		X8.zmm = _mm512_shuffle_i32x4(T0, T8, 0xDD);
+		X9.zmm = _mm512_shuffle_i32x4(T1, T9, 0xDD);
+		X10.zmm = _mm512_shuffle_i32x4(T2, T10, 0xDD);
+		X11.zmm = _mm512_shuffle_i32x4(T3, T11, 0xDD);
+		X12.zmm = _mm512_shuffle_i32x4(T4, T12, 0xDD);
+		X13.zmm = _mm512_shuffle_i32x4(T5, T13, 0xDD);
+		X14.zmm = _mm512_shuffle_i32x4(T6, T14, 0xDD);
+		X15.zmm = _mm512_shuffle_i32x4(T7, T15, 0xDD);
+	}
+
 	//~~~ Operators~~~//
 
 	/// <summary>
@@ -580,7 +659,7 @@ public:
 	/// </summary>
 	inline UInt512 operator -- ()
 	{
-		return UInt512(zmm) - ZMM1();
+		return UInt512(zmm) - UInt512::ONE();
 	}
 
 	/// <summary>
@@ -702,7 +781,7 @@ public:
 	/// </summary>
 	///
 	/// <param name="X">The value to OR</param>
-	inline UInt512 operator | (const UInt512 &X)
+	inline UInt512 operator | (const UInt512 &X) const
 	{
 		return UInt512(_mm512_or_si512(zmm, X.zmm));
 	}
@@ -732,7 +811,7 @@ public:
 	/// </summary>
 	///
 	/// <param name="X">The value to AND</param>
-	inline UInt512 operator & (const UInt512 &X)
+	inline UInt512 operator & (const UInt512 &X) const
 	{
 		return UInt512(_mm512_and_si512(zmm, X.zmm));
 	}
@@ -812,7 +891,7 @@ public:
 	/// <param name="X">The values to compare</param>
 	inline UInt512 operator > (UInt512 const &X) const
 	{
-		return UInt512(_mm512_cmpgt_epi32_mask(zmm, X.zmm));
+		return UInt512(_mm512_maskz_set1_epi32(_mm512_cmpgt_epi32_mask(zmm, X.zmm), -1));
 	}
 
 	/// <summary>
@@ -822,7 +901,7 @@ public:
 	/// <param name="X">The values to compare</param>
 	inline UInt512 operator < (UInt512 const &X) const
 	{
-		return UInt512(_mm512_cmpgt_epi32_mask(X.zmm, zmm));
+		return UInt512(_mm512_maskz_set1_epi32(_mm512_cmpgt_epi32_mask(X.zmm, zmm), -1));
 	}
 
 	/// <summary>
@@ -852,7 +931,7 @@ public:
 	/// <param name="X">The values to compare</param>
 	inline UInt512 operator == (UInt512 const &X) const
 	{
-		return UInt512(_mm512_cmpeq_epi32_mask(zmm, X.zmm));
+		return UInt512(_mm512_maskz_set1_epi32(_mm512_cmpeq_epi32_mask(zmm, X.zmm), -1));
 	}
 
 	/// <summary>
@@ -860,7 +939,7 @@ public:
 	/// </summary>
 	inline UInt512 operator ! () const
 	{
-		return UInt512(_mm512_cmpeq_epi32(zmm, _mm512_setzero_si512()));
+		return UInt512(_mm512_maskz_set1_epi32(_mm512_cmpeq_epi32_mask(zmm, _mm512_setzero_si512()), -1));
 	}
 
 	/// <summary>
@@ -870,7 +949,7 @@ public:
 	/// <param name="X">The values to compare</param>
 	inline UInt512 operator != (const UInt512 &X) const
 	{
-		return ~UInt512(_mm512_cmpneq_epi32_mask(zmm, X.zmm));
+		return UInt512(_mm512_maskz_set1_epi32(_mm512_cmpneq_epi32_mask(zmm, X.zmm), -1));
 	}
 
 #endif
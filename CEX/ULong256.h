@@ -380,7 +380,7 @@ public:
 		_mm256_storeu_si256(reinterpret_cast<__m256i*>(&tmpB[0]), X.ymm);
 		CexAssert(tmpB[0] != 0 && tmpB[1] != 0 && tmpB[2] != 0 && tmpB[3] != 0, "Division by zero");
 
-		ymm = _mm256_set_epi64(tmpA[3] / tmpB[3], tmpA[2] / tmpB[2], tmpA[1] / tmpB[1], tmpA[0] / tmpB[0]);
+		ymm = _mm256_set_epi64x(tmpA[3] / tmpB[3], tmpA[2] / tmpB[2], tmpA[1] / tmpB[1], tmpA[0] / tmpB[0]);
 	}
 
 	/// <summary>
@@ -428,7 +428,7 @@ public:
 	/// </summary>
 	///
 	/// <param name="X">The value to OR</param>
-	inline ULong256 operator | (const ULong256 &X)
+	inline ULong256 operator | (const ULong256 &X) const
 	{
 		return ULong256(_mm256_or_si256(ymm, X.ymm));
 	}
@@ -458,7 +458,7 @@ public:
 	/// </summary>
 	///
 	/// <param name="X">The value to AND</param>
-	inline ULong256 operator & (const ULong256 &X)
+	inline ULong256 operator & (const ULong256 &X) const
 	{
 		return ULong256(_mm256_and_si256(ymm, X.ymm));
 	}
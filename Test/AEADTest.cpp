@@ -1,16 +1,25 @@
 #include "AEADTest.h"
+#include "../CEX/AeadOneShot.h"
 #include "../CEX/EAX.h"
 #include "../CEX/GCM.h"
+#include "../CEX/GCMT.h"
 #include "../CEX/GMAC.h"
+#include "../CEX/ModeContextPool.h"
 #include "../CEX/OCB.h"
+#include "../CEX/OCBT.h"
 #include "../CEX/RHX.h"
 #include "../CEX/SecureRandom.h"
+#include <future>
 
 namespace Test
 {
+	using Cipher::Symmetric::Block::Mode::AeadOneShot;
 	using Cipher::Symmetric::Block::Mode::EAX;
 	using Cipher::Symmetric::Block::Mode::GCM;
+	using Cipher::Symmetric::Block::Mode::GCMT;
+	using Cipher::Symmetric::Block::Mode::ModeContextPool;
 	using Cipher::Symmetric::Block::Mode::OCB;
+	using Cipher::Symmetric::Block::Mode::OCBT;
 	using Cipher::Symmetric::Block::RHX;
 	using Cipher::Symmetric::Block::IBlockCipher;
 
@@ -76,8 +85,30 @@ namespace Test
 			IncrementalCheck(cipher2);
 			OnProgress(std::string("AEADTest: Passed OCB auto incrementing tests.."));
 
+			OcbBatchTest();
+			OnProgress(std::string("AEADTest: Passed OCB batch Seal/Open tests.."));
+
 			delete cipher2;
 
+			OCBT<RHX>* cipher5 = new OCBT<RHX>();
+
+			for (size_t i = EAX_TESTSIZE; i < EAX_TESTSIZE + OCB_TESTSIZE; ++i)
+			{
+				CompareVector(cipher5, m_key[i], m_nonce[i], m_associatedText[i], m_plainText[i], m_cipherText[i], m_expectedCode[i]);
+			}
+			OnProgress(std::string("AEADTest: Passed OCBT known answer comparison tests.."));
+
+			StressTest(cipher5);
+			OnProgress(std::string("AEADTest: Passed OCBT stress tests.."));
+
+			ParallelTest(cipher5);
+			OnProgress(std::string("AEADTest: Passed OCBT parallel tests.."));
+
+			IncrementalCheck(cipher5);
+			OnProgress(std::string("AEADTest: Passed OCBT auto incrementing tests.."));
+
+			delete cipher5;
+
 			GCM* cipher3 = new GCM(Enumeration::BlockCiphers::Rijndael);
 
 			for (size_t i = EAX_TESTSIZE + OCB_TESTSIZE; i < EAX_TESTSIZE + OCB_TESTSIZE + GCM_TESTSIZE; ++i)
@@ -95,6 +126,34 @@ namespace Test
 
 			delete cipher3;
 
+			BatchTest();
+			OnProgress(std::string("AEADTest: Passed GCM batch Seal/Open tests.."));
+
+			GCMT<RHX>* cipher4 = new GCMT<RHX>();
+
+			for (size_t i = EAX_TESTSIZE + OCB_TESTSIZE; i < EAX_TESTSIZE + OCB_TESTSIZE + GCM_TESTSIZE; ++i)
+			{
+				CompareVector(cipher4, m_key[i], m_nonce[i], m_associatedText[i], m_plainText[i], m_cipherText[i], m_expectedCode[i]);
+			}
+			OnProgress(std::string("AEADTest: Passed GCMT known answer comparison tests.."));
+
+			StressTest(cipher4);
+			OnProgress(std::string("AEADTest: Passed GCMT stress tests.."));
+
+			ParallelTest(cipher4);
+			OnProgress(std::string("AEADTest: Passed GCMT parallel tests.."));
+
+			IncrementalCheck(cipher4);
+			OnProgress(std::string("AEADTest: Passed GCMT auto incrementing tests.."));
+
+			delete cipher4;
+
+			OneShotTest();
+			OnProgress(std::string("AEADTest: Passed one-shot Seal/Open tests.."));
+
+			CloneTest();
+			OnProgress(std::string("AEADTest: Passed cloned context and context pool tests.."));
+
 			return SUCCESS;
 		}
 		catch (TestException const &ex)
@@ -107,6 +166,300 @@ namespace Test
 		}
 	}
 
+	void AEADTest::BatchTest()
+	{
+		const size_t TAGLEN = 16;
+		GCM* cipher1 = new GCM(Enumeration::BlockCiphers::Rijndael);
+		GCM* cipher2 = new GCM(Enumeration::BlockCiphers::Rijndael);
+		std::vector<byte> assoc;
+		std::vector<byte> data;
+		std::vector<byte> decData;
+		std::vector<byte> encData1;
+		std::vector<byte> encData2;
+		std::vector<byte> key(32);
+		std::vector<Cipher::Symmetric::Block::Mode::AeadPacket> packets;
+		std::vector<byte> tags1;
+		std::vector<byte> tags2;
+		Prng::SecureRandom rng;
+
+		for (size_t i = 0; i < 10; ++i)
+		{
+			const size_t PKTCNT = rng.NextUInt32(40, 2);
+			size_t adLen = 0;
+			size_t msgLen = 0;
+
+			packets.resize(PKTCNT);
+
+			// mix of empty, partial and multi-block packets, with 96 bit and hashed nonces
+			for (size_t j = 0; j < PKTCNT; ++j)
+			{
+				packets[j].AdOffset = adLen;
+				packets[j].AdLength = rng.NextUInt32(33, 0);
+				packets[j].InOffset = msgLen;
+				packets[j].OutOffset = msgLen;
+				packets[j].Length = rng.NextUInt32(2000, 0);
+				packets[j].Nonce.resize(j % 2 == 0 ? 12 : 16);
+				packets[j].TagOffset = j * TAGLEN;
+				rng.GetBytes(packets[j].Nonce);
+				adLen += packets[j].AdLength;
+				msgLen += packets[j].Length;
+			}
+
+			assoc.resize(adLen);
+			data.resize(msgLen);
+			decData.resize(msgLen);
+			encData1.resize(msgLen);
+			encData2.resize(msgLen);
+			tags1.resize(PKTCNT * TAGLEN);
+			tags2.resize(PKTCNT * TAGLEN);
+			if (adLen != 0)
+			{
+				rng.GetBytes(assoc);
+			}
+			if (msgLen != 0)
+			{
+				rng.GetBytes(data);
+			}
+			rng.GetBytes(key);
+
+			std::vector<byte> nonce(12);
+			Key::Symmetric::SymmetricKey kp(key, nonce);
+			cipher1->Initialize(true, kp);
+			cipher1->SealBatch(packets, assoc, data, encData1, tags1, TAGLEN);
+
+			// each packet must match the output of the streaming interface
+			for (size_t j = 0; j < PKTCNT; ++j)
+			{
+				Key::Symmetric::SymmetricKey kp2(key, packets[j].Nonce);
+				cipher2->Initialize(true, kp2);
+
+				if (packets[j].AdLength != 0)
+				{
+					cipher2->SetAssociatedData(assoc, packets[j].AdOffset, packets[j].AdLength);
+				}
+
+				cipher2->Transform(data, packets[j].InOffset, encData2, packets[j].OutOffset, packets[j].Length);
+				cipher2->Finalize(tags2, packets[j].TagOffset, TAGLEN);
+			}
+
+			if (encData1 != encData2)
+			{
+				throw TestException("AEADTest: Batch encrypted output is not equal!");
+			}
+			if (tags1 != tags2)
+			{
+				throw TestException("AEADTest: Batch tags do not match!");
+			}
+
+			if (!cipher1->OpenBatch(packets, assoc, encData1, decData, tags1, TAGLEN))
+			{
+				throw TestException("AEADTest: Batch authentication has failed!");
+			}
+			if (decData != data)
+			{
+				throw TestException("AEADTest: Batch decrypted output is not equal!");
+			}
+
+			// a modified tag must fail only its own packet
+			const size_t BADPKT = rng.NextUInt32(static_cast<uint32_t>(PKTCNT - 1));
+			tags1[packets[BADPKT].TagOffset] ^= 1;
+
+			if (cipher1->OpenBatch(packets, assoc, encData1, decData, tags1, TAGLEN))
+			{
+				throw TestException("AEADTest: Batch authentication failure was not detected!");
+			}
+
+			for (size_t j = 0; j < PKTCNT; ++j)
+			{
+				if (packets[j].Authentic == (j == BADPKT))
+				{
+					throw TestException("AEADTest: Batch authentication flag is invalid!");
+				}
+			}
+
+			for (size_t j = 0; j < packets[BADPKT].Length; ++j)
+			{
+				if (decData[packets[BADPKT].OutOffset + j] != 0)
+				{
+					throw TestException("AEADTest: Unauthenticated output was released!");
+				}
+			}
+		}
+
+		delete cipher1;
+		delete cipher2;
+	}
+
+	void AEADTest::CloneTest()
+	{
+		const size_t TAGLEN = 16;
+		std::vector<byte> assoc(32);
+		std::vector<byte> data;
+		std::vector<byte> enc1;
+		std::vector<byte> enc2;
+		std::vector<byte> key(32);
+		std::vector<byte> nonce(16);
+		std::vector<byte> zero(0);
+		Prng::SecureRandom rng;
+
+		for (size_t i = 0; i < 20; ++i)
+		{
+			const size_t BLKCNT = rng.NextUInt32(MAX_ALLOC / 16, 2);
+			// ocb writes whole blocks, messages are block aligned
+			const size_t MSGLEN = BLKCNT * 16;
+			const size_t SPLIT = rng.NextUInt32(static_cast<uint32_t>(BLKCNT - 1), 1) * 16;
+			data.resize(MSGLEN);
+			enc1.resize(MSGLEN + TAGLEN);
+			enc2.resize(MSGLEN + TAGLEN);
+			rng.GetBytes(assoc);
+			rng.GetBytes(data);
+			rng.GetBytes(key);
+			rng.GetBytes(nonce);
+
+			// gcm, the gcm template, and ocb copy the complete message state, a clone taken mid-message must produce the same output and tag
+			std::vector<IAeadMode*> modes;
+			modes.push_back(new GCM(Enumeration::BlockCiphers::Rijndael));
+			modes.push_back(new OCB(Enumeration::BlockCiphers::Rijndael));
+			modes.push_back(new GCMT<RHX>());
+			std::vector<size_t> nonceLen = { 12, 15, 12 };
+
+			for (size_t j = 0; j < modes.size(); ++j)
+			{
+				std::vector<byte> iv(nonce.begin(), nonce.begin() + nonceLen[j]);
+				Key::Symmetric::SymmetricKey kp(key, iv);
+				modes[j]->Initialize(true, kp);
+				modes[j]->SetAssociatedData(assoc, 0, assoc.size());
+				modes[j]->Transform(data, 0, enc1, 0, SPLIT);
+				std::copy(enc1.begin(), enc1.begin() + SPLIT, enc2.begin());
+
+				IAeadMode* cpy = static_cast<IAeadMode*>(modes[j]->Clone());
+				modes[j]->Transform(data, SPLIT, enc1, SPLIT, MSGLEN - SPLIT);
+				modes[j]->Finalize(enc1, MSGLEN, TAGLEN);
+				// the copy owns its ciphers and hash state
+				delete modes[j];
+				cpy->Transform(data, SPLIT, enc2, SPLIT, MSGLEN - SPLIT);
+				cpy->Finalize(enc2, MSGLEN, TAGLEN);
+
+				if (enc1 != enc2)
+				{
+					delete cpy;
+					throw TestException("AEADTest: Cloned context output is not equal!");
+				}
+
+				// a nonce only key re-initializes the copy without a key
+				iv[0] ^= 1;
+				Key::Symmetric::SymmetricKey np(zero, iv);
+				cpy->Initialize(true, np);
+				cpy->Transform(data, 0, enc2, 0, MSGLEN);
+				cpy->Finalize(enc2, MSGLEN, TAGLEN);
+				delete cpy;
+
+				IAeadMode* ref = (j == 1) ? static_cast<IAeadMode*>(new OCB(Enumeration::BlockCiphers::Rijndael)) : static_cast<IAeadMode*>(new GCM(Enumeration::BlockCiphers::Rijndael));
+				Key::Symmetric::SymmetricKey rp(key, iv);
+				ref->Initialize(true, rp);
+				ref->Transform(data, 0, enc1, 0, MSGLEN);
+				ref->Finalize(enc1, MSGLEN, TAGLEN);
+				delete ref;
+
+				if (enc1 != enc2)
+				{
+					throw TestException("AEADTest: Re-initialized clone output is not equal!");
+				}
+			}
+
+			// eax is re-keyed on every initialization; the copy starts a message with the same key and nonce
+			EAX* cipher1 = new EAX(Enumeration::BlockCiphers::Rijndael);
+			Key::Symmetric::SymmetricKey kp1(key, nonce);
+			cipher1->Initialize(true, kp1);
+			IAeadMode* cpy2 = cipher1->Clone();
+			cipher1->SetAssociatedData(assoc, 0, assoc.size());
+			cipher1->Transform(data, 0, enc1, 0, MSGLEN);
+			cipher1->Finalize(enc1, MSGLEN, TAGLEN);
+			delete cipher1;
+			cpy2->SetAssociatedData(assoc, 0, assoc.size());
+			cpy2->Transform(data, 0, enc2, 0, MSGLEN);
+			cpy2->Finalize(enc2, MSGLEN, TAGLEN);
+			delete cpy2;
+
+			if (enc1 != enc2)
+			{
+				throw TestException("AEADTest: Cloned EAX output is not equal!");
+			}
+		}
+
+		// one keyed prototype shared by concurrent workers, each message must match a freshly keyed instance
+		const size_t WRKCNT = 8;
+		const size_t MSGCNT = 16;
+		std::vector<byte> keyId(16);
+		ModeContextPool pool(4);
+		rng.GetBytes(keyId);
+		data.resize(MAX_ALLOC);
+		rng.GetBytes(data);
+		rng.GetBytes(key);
+		nonce.resize(12);
+		rng.GetBytes(nonce);
+
+		GCM* proto = new GCM(Enumeration::BlockCiphers::Rijndael);
+		Key::Symmetric::SymmetricKey kp(key, nonce);
+		proto->Initialize(true, kp);
+		pool.Add(keyId, proto);
+
+		std::vector<std::vector<byte>> output(WRKCNT * MSGCNT, std::vector<byte>(data.size() + TAGLEN));
+		std::vector<std::future<void>> workers;
+		enc1.resize(data.size() + TAGLEN);
+
+		for (size_t i = 0; i < WRKCNT; ++i)
+		{
+			workers.push_back(std::async(std::launch::async, [&pool, &keyId, &data, &nonce, &output, i, MSGCNT, TAGLEN]()
+			{
+				for (size_t j = 0; j < MSGCNT; ++j)
+				{
+					IAeadMode* ctx = static_cast<IAeadMode*>(pool.Acquire(keyId));
+					std::vector<byte> iv(nonce);
+					iv[0] = static_cast<byte>(i);
+					iv[1] = static_cast<byte>(j);
+					Key::Symmetric::SymmetricKey np(std::vector<byte>(0), iv);
+					ctx->Initialize(true, np);
+					ctx->Transform(data, 0, output[(i * MSGCNT) + j], 0, data.size());
+					ctx->Finalize(output[(i * MSGCNT) + j], data.size(), TAGLEN);
+					pool.Release(keyId, ctx);
+				}
+			}));
+		}
+
+		for (size_t i = 0; i < workers.size(); ++i)
+		{
+			workers[i].get();
+		}
+
+		for (size_t i = 0; i < WRKCNT; ++i)
+		{
+			for (size_t j = 0; j < MSGCNT; ++j)
+			{
+				std::vector<byte> iv(nonce);
+				iv[0] = static_cast<byte>(i);
+				iv[1] = static_cast<byte>(j);
+				GCM cipher(Enumeration::BlockCiphers::Rijndael);
+				Key::Symmetric::SymmetricKey rp(key, iv);
+				cipher.Initialize(true, rp);
+				cipher.Transform(data, 0, enc1, 0, data.size());
+				cipher.Finalize(enc1, data.size(), TAGLEN);
+
+				if (enc1 != output[(i * MSGCNT) + j])
+				{
+					throw TestException("AEADTest: Pooled context output is not equal!");
+				}
+			}
+		}
+
+		pool.Remove(keyId);
+
+		if (pool.Contains(keyId) || pool.Count() != 0)
+		{
+			throw TestException("AEADTest: The context pool key was not removed!");
+		}
+	}
+
 	void AEADTest::CompareVector(IAeadMode* Cipher, std::vector<byte> &Key, std::vector<byte> &Nonce, std::vector<byte> &AssociatedText, std::vector<byte> &PlainText,
 		std::vector<byte> &CipherText, std::vector<byte> &MacCode)
 	{
@@ -217,6 +570,284 @@ namespace Test
 		}
 	}
 
+	void AEADTest::OcbBatchTest()
+	{
+		const size_t TAGLEN = 16;
+		OCB* cipher1 = new OCB(Enumeration::BlockCiphers::Rijndael);
+		OCB* cipher2 = new OCB(Enumeration::BlockCiphers::Rijndael);
+		std::vector<byte> assoc;
+		std::vector<byte> data;
+		std::vector<byte> decData;
+		std::vector<byte> encData1;
+		std::vector<byte> encData2;
+		std::vector<byte> key(32);
+		std::vector<byte> nonce(12);
+		std::vector<Cipher::Symmetric::Block::Mode::AeadPacket> packets;
+		std::vector<byte> tags1;
+		std::vector<byte> tags2;
+		std::vector<byte> tmpData;
+		Prng::SecureRandom rng;
+
+		for (size_t i = 0; i < 10; ++i)
+		{
+			const size_t PKTCNT = rng.NextUInt32(40, 2);
+			size_t adLen = 0;
+			size_t msgLen = 0;
+
+			packets.resize(PKTCNT);
+
+			// mix of empty, partial and multi-block packets, with every legal nonce size
+			for (size_t j = 0; j < PKTCNT; ++j)
+			{
+				packets[j].AdOffset = adLen;
+				packets[j].AdLength = rng.NextUInt32(40, 0);
+				packets[j].InOffset = msgLen;
+				packets[j].OutOffset = msgLen;
+				packets[j].Length = rng.NextUInt32(2000, 0);
+				packets[j].Nonce.resize(12 + (j % 4));
+				packets[j].TagOffset = j * TAGLEN;
+				rng.GetBytes(packets[j].Nonce);
+				adLen += packets[j].AdLength;
+				msgLen += packets[j].Length;
+			}
+
+			assoc.resize(adLen);
+			data.resize(msgLen);
+			decData.resize(msgLen);
+			encData1.resize(msgLen);
+			encData2.resize(msgLen);
+			tags1.resize(PKTCNT * TAGLEN);
+			tags2.resize(PKTCNT * TAGLEN);
+			if (adLen != 0)
+			{
+				rng.GetBytes(assoc);
+			}
+			if (msgLen != 0)
+			{
+				rng.GetBytes(data);
+			}
+			rng.GetBytes(key);
+			rng.GetBytes(nonce);
+
+			Key::Symmetric::SymmetricKey kp(key, nonce);
+			cipher1->Initialize(true, kp);
+			cipher1->SealBatch(packets, assoc, data, encData1, tags1, TAGLEN);
+
+			// each packet must match the output of the streaming interface, which writes a whole final block
+			for (size_t j = 0; j < PKTCNT; ++j)
+			{
+				Key::Symmetric::SymmetricKey kp2(key, packets[j].Nonce);
+				cipher2->Initialize(true, kp2);
+
+				if (packets[j].AdLength != 0)
+				{
+					cipher2->SetAssociatedData(assoc, packets[j].AdOffset, packets[j].AdLength);
+				}
+
+				tmpData.resize(packets[j].Length + TAGLEN);
+				cipher2->Transform(data, packets[j].InOffset, tmpData, 0, packets[j].Length);
+				cipher2->Finalize(tags2, packets[j].TagOffset, TAGLEN);
+
+				if (packets[j].Length != 0)
+				{
+					std::memcpy(&encData2[packets[j].OutOffset], &tmpData[0], packets[j].Length);
+				}
+			}
+
+			if (encData1 != encData2)
+			{
+				throw TestException("AEADTest: OCB batch encrypted output is not equal!");
+			}
+			if (tags1 != tags2)
+			{
+				throw TestException("AEADTest: OCB batch tags do not match!");
+			}
+
+			cipher1->Initialize(false, kp);
+
+			if (!cipher1->OpenBatch(packets, assoc, encData1, decData, tags1, TAGLEN))
+			{
+				throw TestException("AEADTest: OCB batch authentication has failed!");
+			}
+			if (decData != data)
+			{
+				throw TestException("AEADTest: OCB batch decrypted output is not equal!");
+			}
+
+			// a modified tag must fail only its own packet
+			const size_t BADPKT = rng.NextUInt32(static_cast<uint32_t>(PKTCNT - 1));
+			tags1[packets[BADPKT].TagOffset] ^= 1;
+
+			if (cipher1->OpenBatch(packets, assoc, encData1, decData, tags1, TAGLEN))
+			{
+				throw TestException("AEADTest: OCB batch authentication failure was not detected!");
+			}
+
+			for (size_t j = 0; j < PKTCNT; ++j)
+			{
+				if (packets[j].Authentic == (j == BADPKT))
+				{
+					throw TestException("AEADTest: OCB batch authentication flag is invalid!");
+				}
+			}
+		}
+
+		delete cipher1;
+		delete cipher2;
+	}
+
+	void AEADTest::OneShotTest()
+	{
+		const size_t TAGLEN = AeadOneShot::TAG_SIZE;
+		std::vector<byte> cpt;
+		std::vector<byte> dec;
+		std::vector<byte> exp;
+		std::vector<byte> key;
+		std::vector<byte> nonce;
+		std::vector<byte> pad;
+		std::vector<byte> assoc;
+		std::vector<byte> data;
+		Prng::SecureRandom rng;
+
+		// RFC 8439 section 2.8.2 ChaCha20-Poly1305 vector
+		HexConverter::Decode(std::string("808182838485868788898A8B8C8D8E8F909192939495969798999A9B9C9D9E9F"), key);
+		HexConverter::Decode(std::string("070000004041424344454647"), nonce);
+		HexConverter::Decode(std::string("50515253C0C1C2C3C4C5C6C7"), assoc);
+		HexConverter::Decode(std::string("D31A8D34648E60DB7B86AFBC53EF7EC2A4ADED51296E08FEA9E2B5A736EE62D63DBEA45E8CA9671282FAFB69DA92728B1A71DE0A9E060B2905D6A5B67ECD3B3692DDBD7F2D778B8C9803AEE328091B58FAB324E4FAD675945585808B4831D7BC3FF4DEF08E4B7A9DE576D26586CEC64B61161AE10B594F09E26A7E902ECBD0600691"), exp);
+		const std::string MSG = "Ladies and Gentlemen of the class of '99: If I could offer you only one tip for the future, sunscreen would be it.";
+		data.assign(MSG.begin(), MSG.end());
+		cpt.resize(data.size() + TAGLEN);
+		dec.resize(data.size());
+
+		AeadOneShot::ChaChaPolySeal(key, nonce, assoc, data, 0, cpt, 0, data.size());
+
+		if (cpt != exp)
+		{
+			throw TestException("AEADTest: ChaCha20-Poly1305 known answer test has failed!");
+		}
+		if (!AeadOneShot::ChaChaPolyOpen(key, nonce, assoc, cpt, 0, dec, 0, dec.size()) || dec != data)
+		{
+			throw TestException("AEADTest: ChaCha20-Poly1305 authentication has failed!");
+		}
+
+		for (size_t i = 0; i < 100; ++i)
+		{
+			const size_t MSGLEN = rng.NextUInt32(1000, 0);
+			const size_t ADLEN = rng.NextUInt32(40, 0);
+
+			assoc.resize(ADLEN);
+			data.resize(MSGLEN);
+			cpt.resize(MSGLEN + TAGLEN);
+			dec.resize(MSGLEN);
+			key.resize(32);
+			nonce.resize(12);
+			// empty associated data and message lengths are valid, but the generator rejects an empty buffer
+			if (ADLEN != 0)
+			{
+				rng.GetBytes(assoc);
+			}
+			if (MSGLEN != 0)
+			{
+				rng.GetBytes(data);
+			}
+			rng.GetBytes(key);
+			rng.GetBytes(nonce);
+
+			AeadOneShot::ChaChaPolySeal(key, nonce, assoc, data, 0, cpt, 0, MSGLEN);
+
+			if (!AeadOneShot::ChaChaPolyOpen(key, nonce, assoc, cpt, 0, dec, 0, MSGLEN) || dec != data)
+			{
+				throw TestException("AEADTest: ChaCha20-Poly1305 decrypted output is not equal!");
+			}
+
+			cpt[rng.NextUInt32(static_cast<uint32_t>(MSGLEN + TAGLEN - 1))] ^= 1;
+
+			if (AeadOneShot::ChaChaPolyOpen(key, nonce, assoc, cpt, 0, dec, 0, MSGLEN))
+			{
+				throw TestException("AEADTest: ChaCha20-Poly1305 authentication failure was not detected!");
+			}
+
+#if defined(__AVX__)
+			// the AES functions must match the GCM and OCB modes with a 16 byte tag
+			key.resize(16 + ((i % 3) * 8));
+			rng.GetBytes(key);
+			exp.resize(MSGLEN + TAGLEN);
+
+			GCM* cipher1 = new GCM(Enumeration::BlockCiphers::Rijndael);
+			Key::Symmetric::SymmetricKey kp1(key, nonce);
+			cipher1->Initialize(true, kp1);
+			if (ADLEN != 0)
+			{
+				cipher1->SetAssociatedData(assoc, 0, ADLEN);
+			}
+			cipher1->Transform(data, 0, exp, 0, MSGLEN);
+			cipher1->Finalize(exp, MSGLEN, TAGLEN);
+			delete cipher1;
+
+			AeadOneShot::GcmSeal(key, nonce, assoc, data, 0, cpt, 0, MSGLEN);
+
+			if (cpt != exp)
+			{
+				throw TestException("AEADTest: One-shot GCM output is not equal!");
+			}
+			if (!AeadOneShot::GcmOpen(key, nonce, assoc, cpt, 0, dec, 0, MSGLEN) || dec != data)
+			{
+				throw TestException("AEADTest: One-shot GCM decrypted output is not equal!");
+			}
+
+			cpt[rng.NextUInt32(static_cast<uint32_t>(MSGLEN + TAGLEN - 1))] ^= 1;
+
+			if (AeadOneShot::GcmOpen(key, nonce, assoc, cpt, 0, dec, 0, MSGLEN))
+			{
+				throw TestException("AEADTest: One-shot GCM authentication failure was not detected!");
+			}
+
+			// OCB writes a whole block on a partial final block, so the reference output is padded
+			nonce.resize(12 + (i % 4));
+			rng.GetBytes(nonce);
+			pad.resize(MSGLEN + (2 * TAGLEN));
+
+			OCB* cipher2 = new OCB(Enumeration::BlockCiphers::Rijndael);
+			Key::Symmetric::SymmetricKey kp2(key, nonce);
+			cipher2->Initialize(true, kp2);
+			if (ADLEN != 0)
+			{
+				cipher2->SetAssociatedData(assoc, 0, ADLEN);
+			}
+			cipher2->Transform(data, 0, pad, 0, MSGLEN);
+			cipher2->Finalize(pad, MSGLEN, TAGLEN);
+			delete cipher2;
+			pad.resize(MSGLEN + TAGLEN);
+
+			AeadOneShot::OcbSeal(key, nonce, assoc, data, 0, cpt, 0, MSGLEN);
+
+			if (cpt != pad)
+			{
+				throw TestException("AEADTest: One-shot OCB output is not equal!");
+			}
+			if (!AeadOneShot::OcbOpen(key, nonce, assoc, cpt, 0, dec, 0, MSGLEN) || dec != data)
+			{
+				throw TestException("AEADTest: One-shot OCB decrypted output is not equal!");
+			}
+
+			cpt[rng.NextUInt32(static_cast<uint32_t>(MSGLEN + TAGLEN - 1))] ^= 1;
+
+			if (AeadOneShot::OcbOpen(key, nonce, assoc, cpt, 0, dec, 0, MSGLEN))
+			{
+				throw TestException("AEADTest: One-shot OCB authentication failure was not detected!");
+			}
+#endif
+
+			for (size_t j = 0; j < MSGLEN; ++j)
+			{
+				if (dec[j] != 0)
+				{
+					throw TestException("AEADTest: Unauthenticated output was released!");
+				}
+			}
+		}
+	}
+
 	void AEADTest::ParallelTest(IAeadMode* Cipher)
 	{
 		std::vector<byte> data;
@@ -341,7 +972,7 @@ namespace Test
 
 	void AEADTest::Initialize()
 	{
-		const char* keyEncoded[44] =
+		const char* keyEncoded[45] =
 		{
 			// eax
 			("233952DEE4D5ED5F9B9C6D6FF80FF478"),
@@ -389,11 +1020,13 @@ namespace Test
 			("feffe9928665731c6d6a8f9467308308feffe9928665731c6d6a8f9467308308"),
 			("feffe9928665731c6d6a8f9467308308feffe9928665731c6d6a8f9467308308"),
 			("feffe9928665731c6d6a8f9467308308feffe9928665731c6d6a8f9467308308"),
-			("feffe9928665731c6d6a8f9467308308feffe9928665731c6d6a8f9467308308")
+			("feffe9928665731c6d6a8f9467308308feffe9928665731c6d6a8f9467308308"),
+			// long message and associated data, exercises the aggregated GHASH reduction
+			("05121F2C394653606D7A8794A1AEBBC8D5E2EFFC091623303D4A5764717E8B98")
 		};
-		HexConverter::Decode(keyEncoded, 44, m_key);
+		HexConverter::Decode(keyEncoded, 45, m_key);
 
-		const char* nonceEncoded[44] =
+		const char* nonceEncoded[45] =
 		{
 			// eax
 			("62EC67F9C3A4A407FCB2A8C49031A8B3"),
@@ -441,11 +1074,13 @@ namespace Test
 			("cafebabefacedbaddecaf888"),
 			("cafebabefacedbaddecaf888"),
 			("cafebabefacedbad"),
-			("9313225df88406e555909c5aff5269aa6a7a9538534f7da1e4c303d2a318a728c3c0c95156809539fcf0e2429a6b525416aedbf5a0de6a57a637b39b")
+			("9313225df88406e555909c5aff5269aa6a7a9538534f7da1e4c303d2a318a728c3c0c95156809539fcf0e2429a6b525416aedbf5a0de6a57a637b39b"),
+			// long message and associated data, exercises the aggregated GHASH reduction
+			("0B2845627F9CB9D6F3102D4A")
 		};
-		HexConverter::Decode(nonceEncoded, 44, m_nonce);
+		HexConverter::Decode(nonceEncoded, 45, m_nonce);
 
-		const char* assocEncoded[44] =
+		const char* assocEncoded[45] =
 		{
 			// eax
 			("6BFB914FD07EAE6B"),
@@ -493,11 +1128,13 @@ namespace Test
 			(""),
 			("feedfacedeadbeeffeedfacedeadbeefabaddad2"),
 			("feedfacedeadbeeffeedfacedeadbeefabaddad2"),
-			("feedfacedeadbeeffeedfacedeadbeefabaddad2")
+			("feedfacedeadbeeffeedfacedeadbeefabaddad2"),
+			// long message and associated data, exercises the aggregated GHASH reduction
+			("030A11181F262D343B424950575E656C737A81888F969DA4ABB2B9C0C7CED5DCE3EAF1F8FF060D141B222930373E454C535A61686F767D848B9299A0A7AEB5BCC3CAD1D8DFE6EDF4FB020910171E252C333A41484F565D646B727980878E959CA3AAB1B8BFC6CDD4DBE2E9F0F7FE050C131A21282F363D444B525960676E757C838A91989FA6ADB4BBC2C9D0D7DEE5ECF3FA01080F16")
 		};
-		HexConverter::Decode(assocEncoded, 44, m_associatedText);
+		HexConverter::Decode(assocEncoded, 45, m_associatedText);
 
-		const char* plainEncoded[44] =
+		const char* plainEncoded[45] =
 		{
 			// eax
 			(""),
@@ -545,11 +1182,13 @@ namespace Test
 			("d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b391aafd255"),
 			("d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39"),
 			("d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39"),
-			("d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39")
+			("d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39"),
+			// long message and associated data, exercises the aggregated GHASH reduction
+			("010C17222D38434E59646F7A85909BA6B1BCC7D2DDE8F3FE09141F2A35404B56616C77828D98A3AEB9C4CFDAE5F0FB06111C27323D48535E69747F8A95A0ABB6C1CCD7E2EDF8030E19242F3A45505B66717C87929DA8B3BEC9D4DFEAF5000B16212C37424D58636E79848F9AA5B0BBC6D1DCE7F2FD08131E29343F4A55606B76818C97A2ADB8C3CED9E4EFFA05101B26313C47525D68737E89949FAAB5C0CBD6E1ECF7020D18232E39444F5A65707B86919CA7B2BDC8D3DEE9F4FF0A15202B36414C57626D78838E99A4AFBAC5D0DBE6F1FC07121D28333E49545F6A75808B96A1ACB7C2CDD8E3EEF9040F1A25303B46515C67727D88939EA9B4BFCAD5E0EBF6010C17222D38434E59646F7A85909BA6B1BCC7D2DDE8F3FE09141F2A35404B56616C77828D98A3AEB9C4CFDAE5F0FB06111C27323D4853")
 		};
-		HexConverter::Decode(plainEncoded, 44, m_plainText);
+		HexConverter::Decode(plainEncoded, 45, m_plainText);
 
-		const char* cipherEncoded[44] =
+		const char* cipherEncoded[45] =
 		{
 			// eax
 			("E037830E8389F27B025A2D6527E79D01"),
@@ -597,11 +1236,13 @@ namespace Test
 			("522dc1f099567d07f47f37a32a84427d643a8cdcbfe5c0c97598a2bd2555d1aa8cb08e48590dbb3da7b08b1056828838c5f61e6393ba7a0abcc9f662898015adb094dac5d93471bdec1a502270e3cc6c"),
 			("522dc1f099567d07f47f37a32a84427d643a8cdcbfe5c0c97598a2bd2555d1aa8cb08e48590dbb3da7b08b1056828838c5f61e6393ba7a0abcc9f66276fc6ece0f4e1768cddf8853bb2d551b"),
 			("c3762df1ca787d32ae47c13bf19844cbaf1ae14d0b976afac52ff7d79bba9de0feb582d33934a4f0954cc2363bc73f7862ac430e64abe499f47c9b1f3a337dbf46a792c45e454913fe2ea8f2"),
-			("5a8def2f0c9e53f1f75d7853659e2a20eeb2b22aafde6419a058ab4f6f746bf40fc0c3b780f244452da3ebf1c5d82cdea2418997200ef82e44ae7e3fa44a8266ee1c8eb0c8b5d4cf5ae9f19a")
+			("5a8def2f0c9e53f1f75d7853659e2a20eeb2b22aafde6419a058ab4f6f746bf40fc0c3b780f244452da3ebf1c5d82cdea2418997200ef82e44ae7e3fa44a8266ee1c8eb0c8b5d4cf5ae9f19a"),
+			// long message and associated data, exercises the aggregated GHASH reduction
+			("6B5929980DD74F76B9839BC2B93558ACC3800204976247B03F69C32683D47E92CBA43CBACFD811BC50767C047BA1C9FEDEB7828DB38223F48EBB454C4249186070179B128DC111F4BCE948D39C2D869355A4A332EA298C1A3FBB103DF528A73D581D1C547E6454319438F08ABCAB9659A452E3C976B8B33CF638251D738AD7283347805B67672170B339B335377ED38C9BBC0A7A9C34A086DE3670E9685FC7DAC74565E78AAD169009F4AFD1BF53EF17F00932CC93AC8D5651CC87176E6415ABD03A4CD8800CE54523B7221CF4BF4CF25FAB3809C60F57A7ED24B5B9A2C0231BAA00552217E6C0BA799FBEB2E55E16ADD2F953067197A8E082B33AADFCBCC49C834E2E091F1E4C0D6125C99AD30B26B85F6313A931D25B0E4B6F43E2094A5EECB25320E219B83FB6F96857203AC6CE5A417F5930BDE6A87D0A221103978D74C8248E4C0C5BF259")
 		};
-		HexConverter::Decode(cipherEncoded, 44, m_cipherText);
+		HexConverter::Decode(cipherEncoded, 45, m_cipherText);
 
-		const char* codeEncoded[44] =
+		const char* codeEncoded[45] =
 		{
 			// eax
 			("E037830E8389F27B025A2D6527E79D01"),
@@ -649,9 +1290,11 @@ namespace Test
 			("b094dac5d93471bdec1a502270e3cc6c"),
 			("76fc6ece0f4e1768cddf8853bb2d551b"),
 			("3a337dbf46a792c45e454913fe2ea8f2"),
-			("a44a8266ee1c8eb0c8b5d4cf5ae9f19a")
+			("a44a8266ee1c8eb0c8b5d4cf5ae9f19a"),
+			// long message and associated data, exercises the aggregated GHASH reduction
+			("7D0A221103978D74C8248E4C0C5BF259")
 		};
-		HexConverter::Decode(codeEncoded, 44, m_expectedCode);
+		HexConverter::Decode(codeEncoded, 45, m_expectedCode);
 	}
 
 	void AEADTest::OnProgress(std::string Data)
@@ -25,7 +25,7 @@ namespace Test
 		static const size_t MAX_ALLOC = 4096;
 		static const size_t EAX_TESTSIZE = 10;
 		static const size_t OCB_TESTSIZE = 16;
-		static const size_t GCM_TESTSIZE = 18;
+		static const size_t GCM_TESTSIZE = 19;
 
 		std::vector<std::vector<byte>> m_associatedText;
 		std::vector<std::vector<byte>> m_cipherText;
@@ -63,10 +63,14 @@ namespace Test
 
 	private:
 
+		void BatchTest();
+		void CloneTest();
 		void CompareVector(IAeadMode* Cipher, std::vector<byte> &Key, std::vector<byte> &Nonce, std::vector<byte> &AssociatedText, std::vector<byte> &PlainText, std::vector<byte> &CipherText, std::vector<byte> &MacCode);
 		void IncrementalCheck(IAeadMode* Cipher);
 		void Initialize();
+		void OcbBatchTest();
 		void OnProgress(std::string Data);
+		void OneShotTest();
 		void ParallelTest(IAeadMode* Cipher);
 		void StressTest(IAeadMode* Cipher);
 	};
@@ -0,0 +1,118 @@
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	// the block size is stored ahead of each allocation; the header keeps the fundamental alignment of the returned pointer
+	const size_t HEADER_SIZE = 16;
+
+	std::atomic<size_t> g_allocCurrent(0);
+	std::atomic<size_t> g_allocPeak(0);
+
+	void* CountedAlloc(size_t Length)
+	{
+		byte* blk = static_cast<byte*>(std::malloc(Length + HEADER_SIZE));
+
+		if (blk == nullptr)
+		{
+			return nullptr;
+		}
+
+		*reinterpret_cast<size_t*>(blk) = Length;
+		size_t crr = g_allocCurrent.fetch_add(Length) + Length;
+		size_t pek = g_allocPeak.load();
+
+		while (crr > pek && !g_allocPeak.compare_exchange_weak(pek, crr))
+		{
+		}
+
+		return blk + HEADER_SIZE;
+	}
+
+	void CountedFree(void* Block)
+	{
+		if (Block != nullptr)
+		{
+			byte* blk = static_cast<byte*>(Block) - HEADER_SIZE;
+			g_allocCurrent.fetch_sub(*reinterpret_cast<size_t*>(blk));
+			std::free(blk);
+		}
+	}
+}
+
+void* operator new(size_t Length)
+{
+	void* blk = CountedAlloc(Length);
+
+	if (blk == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+
+	return blk;
+}
+
+void* operator new[](size_t Length)
+{
+	return operator new(Length);
+}
+
+void* operator new(size_t Length, const std::nothrow_t &) noexcept
+{
+	return CountedAlloc(Length);
+}
+
+void* operator new[](size_t Length, const std::nothrow_t &) noexcept
+{
+	return CountedAlloc(Length);
+}
+
+void operator delete(void* Block) noexcept
+{
+	CountedFree(Block);
+}
+
+void operator delete[](void* Block) noexcept
+{
+	CountedFree(Block);
+}
+
+void operator delete(void* Block, const std::nothrow_t &) noexcept
+{
+	CountedFree(Block);
+}
+
+void operator delete[](void* Block, const std::nothrow_t &) noexcept
+{
+	CountedFree(Block);
+}
+
+void operator delete(void* Block, size_t) noexcept
+{
+	CountedFree(Block);
+}
+
+void operator delete[](void* Block, size_t) noexcept
+{
+	CountedFree(Block);
+}
+
+namespace Test
+{
+	size_t AllocationCounter::Current()
+	{
+		return g_allocCurrent.load();
+	}
+
+	size_t AllocationCounter::Peak()
+	{
+		return g_allocPeak.load();
+	}
+
+	void AllocationCounter::ResetPeak()
+	{
+		g_allocPeak.store(g_allocCurrent.load());
+	}
+}
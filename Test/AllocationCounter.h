@@ -0,0 +1,34 @@
+#ifndef _CEXTEST_ALLOCATIONCOUNTER_H
+#define _CEXTEST_ALLOCATIONCOUNTER_H
+
+#include "../CEX/CexDomain.h"
+
+namespace Test
+{
+	/// <summary>
+	/// Counts the heap memory allocated by the test application.
+	/// <para>The global operator new and delete are replaced in the implementation file, so every allocation made through them by the library
+	/// and the tests is counted. The peak can be reset before an operation and read after it to measure the operations heap high-water mark.</para>
+	/// </summary>
+	class AllocationCounter
+	{
+	public:
+
+		/// <summary>
+		/// Get the number of heap bytes currently allocated
+		/// </summary>
+		static size_t Current();
+
+		/// <summary>
+		/// Get the largest number of heap bytes allocated at once since the last reset
+		/// </summary>
+		static size_t Peak();
+
+		/// <summary>
+		/// Reset the peak to the number of bytes currently allocated
+		/// </summary>
+		static void ResetPeak();
+	};
+}
+
+#endif
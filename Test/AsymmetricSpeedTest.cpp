@@ -1,23 +1,33 @@
 #include "AsymmetricSpeedTest.h"
-#include "../CEX/BlockCipherFromName.h"
-#include "../CEX/DigestFromName.h"
+#include "AllocationCounter.h"
 #include "../CEX/IAsymmetricKeyPair.h"
 #include "../CEX/McEliece.h"
 #include "../CEX/MPKCKeyPair.h"
-#include "../CEX/PrngFromName.h"
+#include "../CEX/ParallelUtils.h"
 #include "../CEX/RingLWE.h"
 #include "../CEX/RLWEKeyPair.h"
 #include "../CEX/SecureRandom.h"
+#include "../CEX/SysUtils.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <thread>
 
 namespace Test
 {
+	using Key::Asymmetric::IAsymmetricKeyPair;
+
 	const std::string AsymmetricSpeedTest::DESCRIPTION = "Asymmetric Cipher and Signature Scheme Speed Tests.";
 	const std::string AsymmetricSpeedTest::FAILURE = "FAILURE! ";
 	const std::string AsymmetricSpeedTest::MESSAGE = "COMPLETE! Asymmetric Speed tests have executed succesfully.";
+	const std::string AsymmetricSpeedTest::RESULT_FILE = "AsymmetricSpeedTest.csv";
+	const std::string AsymmetricSpeedTest::RESULT_HEADER = "cipher,parameters,operation,loops,threads,cycles_op,p50_ns,p99_ns,p999_ns,ops_sec,ops_sec_threads,peak_heap_bytes";
 
-	AsymmetricSpeedTest::AsymmetricSpeedTest()
+	AsymmetricSpeedTest::AsymmetricSpeedTest(size_t Threads)
 		:
-		m_progressEvent()
+		m_progressEvent(),
+		m_threadCount(Threads != 0 ? Threads : Utility::ParallelUtils::ProcessorCount())
 	{
 	}
 
@@ -29,39 +39,33 @@ namespace Test
 	{
 		try
 		{
-			std::string itrCnt = TestUtils::ToString(DEF_TEST_ITER);
-			IPrng* rngPtr = Helper::PrngFromName::GetInstance(Enumeration::Prngs::BCR, Enumeration::Providers::CSP);
-			IBlockCipher* sycPtr = Helper::BlockCipherFromName::GetInstance(Enumeration::BlockCiphers::Rijndael);
-
-			OnProgress(std::string("### Asymmetric Cipher Speed Tests in sequential and parallel modes:"));
-			OnProgress("");
+			std::ofstream out(RESULT_FILE.c_str(), std::ios::out | std::ios::trunc);
 
-			// RingLWE
-			OnProgress(std::string("***Sequential: Generating " + itrCnt + " Keypairs using RingLWE Q12289N1024***"));
-			RlweGenerateLoop(RLWEParams::Q12289N1024, DEF_TEST_ITER, false, rngPtr, sycPtr);
-			OnProgress(std::string("***Parallel: Generating " + itrCnt + " Keypairs using RingLWE Q12289N1024***"));
-			RlweGenerateLoop(RLWEParams::Q12289N1024, DEF_TEST_ITER, true, rngPtr, sycPtr);
+			if (!out.is_open())
+			{
+				throw TestException("AsymmetricSpeedTest: the result file could not be created: " + RESULT_FILE);
+			}
 
-			OnProgress(std::string("***Sequential: Encrypting " + itrCnt + " messages using RingLWE Q12289N1024 / GCM(AES256)***"));
-			RlweEncryptLoop(RLWEParams::Q12289N1024, DEF_TEST_ITER, false, rngPtr, sycPtr);
-			OnProgress(std::string("***Parallel: Encrypting " + itrCnt + " messages using RingLWE Q12289N1024 / GCM(AES256)***"));
-			RlweEncryptLoop(RLWEParams::Q12289N1024, DEF_TEST_ITER, true, rngPtr, sycPtr);
+			out << RESULT_HEADER << std::endl;
 
-			OnProgress(std::string("***Sequential: Decrypting " + itrCnt + " messages using RingLWE Q12289N1024 / GCM(AES256)***"));
-			RlweDecryptLoop(RLWEParams::Q12289N1024, DEF_TEST_ITER, false, rngPtr, sycPtr);
+			OnProgress(std::string("### Asymmetric Cipher Speed Tests, per operation latency and throughput:"));
+			OnProgress(std::string("### Results are written to " + RESULT_FILE));
+			OnProgress("");
 
-			// McEliece
-			OnProgress(std::string("***Sequential: Generating " + itrCnt + " Keypairs using McEliece M12T62***"));
-			MpkcGenerateLoop(MPKCParams::M12T62, DEF_TEST_ITER, rngPtr, sycPtr);
+			// RingLWE; the parameter sets are measured with the same loops, so the timings compare directly
+			// the Q7681N256 test set is not benchmarked, it is not a production parameter set
+			const RLWEParams RLWESETS[2] = { RLWEParams::Q12289N1024, RLWEParams::Q40961N1024 };
+			const std::string RLWENAMES[2] = { "Q12289N1024", "Q40961N1024" };
 
-			OnProgress(std::string("***Sequential: Encrypting " + itrCnt + " messages using McEliece M12T62 / GCM(AES256)***"));
-			MpkcEncryptLoop(MPKCParams::M12T62, DEF_TEST_ITER, rngPtr, sycPtr);
+			for (size_t i = 0; i < 2; ++i)
+			{
+				RlweBenchmark(RLWESETS[i], RLWENAMES[i], out);
+			}
 
-			OnProgress(std::string("***Sequential: Decrypting " + itrCnt + " messages using McEliece M12T62 / GCM(AES256)***"));
-			MpkcDecryptLoop(MPKCParams::M12T62, DEF_TEST_ITER, rngPtr, sycPtr);
+			// McEliece
+			MpkcBenchmark(MPKCParams::M12T62, "M12T62", out);
 
-			delete sycPtr;
-			delete rngPtr;
+			out.close();
 
 			return MESSAGE;
 		}
@@ -75,190 +79,220 @@ namespace Test
 		}
 	}
 
-	void AsymmetricSpeedTest::MpkcGenerateLoop(MPKCParams Params, size_t Loops, IPrng* Rng, IBlockCipher* Cipher)
+	void AsymmetricSpeedTest::Benchmark(const std::string &Cipher, const std::string &Parameters, const std::string &Operation, size_t Loops, size_t Threads, const OperationFactory &Factory, std::ofstream &Output)
 	{
-		Cipher::Asymmetric::McEliece::McEliece asyCpr(Params, Rng, Cipher);
-		Key::Asymmetric::IAsymmetricKeyPair* kp;
+		const size_t THDCNT = (Threads != 0) ? Threads : 1;
+		const bool HASTSC = Utility::SysUtils::HasRdtsc();
+		std::function<void()> op = Factory(true);
+		std::vector<ulong> cycles(Loops);
+		std::vector<ulong> nanos(Loops);
+		ulong total = 0;
 
-		uint64_t start = TestUtils::GetTimeMs64();
+		OnProgress(std::string("***" + Cipher + " " + Parameters + ": " + Operation + " " + TestUtils::ToString(Loops) + " operations***"));
 
-		for (size_t i = 0; i < Loops; ++i)
+		// warm the caches and let the cpu reach its operating frequency before sampling
+		for (size_t i = 0; i < std::max(static_cast<size_t>(1), Loops / 10); ++i)
 		{
-			kp = asyCpr.Generate();
+			op();
 		}
 
-		uint64_t dur = TestUtils::GetTimeMs64() - start;
-
-		delete kp;
-
-		std::string nlen = TestUtils::ToString(Loops);
-		std::string secs = TestUtils::ToString((double)dur / 1000.0);
-		std::string ksec = TestUtils::ToString(GetUnitsPerSecond(dur, Loops));
-		std::string resp = std::string("Generated " + nlen + " keypairs in " + secs + " seconds, avg. " + ksec + " generated per second");
-
-		OnProgress(resp);
-		OnProgress(std::string(""));
-	}
-
-	void AsymmetricSpeedTest::MpkcEncryptLoop(MPKCParams Params, size_t Loops, IPrng* Rng, IBlockCipher* Cipher)
-	{
-		Cipher::Asymmetric::McEliece::McEliece asyCpr(Params, Rng, Cipher);
-		Key::Asymmetric::IAsymmetricKeyPair* kp;
-		kp = asyCpr.Generate();
-		asyCpr.Initialize(true, kp);
-		std::vector<byte> msg(32);
-		Rng->GetBytes(msg);
-
-		uint64_t start = TestUtils::GetTimeMs64();
+		// the heap high-water mark of a single operation; only allocations made through operator new are counted
+		const size_t MEMBASE = AllocationCounter::Current();
+		AllocationCounter::ResetPeak();
+		op();
+		const size_t PEAKMEM = AllocationCounter::Peak() - MEMBASE;
 
+		// single thread latency; every operation is timed separately
 		for (size_t i = 0; i < Loops; ++i)
 		{
-			asyCpr.Encrypt(msg);
+			const std::chrono::steady_clock::time_point START = std::chrono::steady_clock::now();
+			const ulong TSCSTART = HASTSC ? Utility::SysUtils::TimeStamp(true) : 0;
+			op();
+			const ulong TSCEND = HASTSC ? Utility::SysUtils::TimeStamp(true) : 0;
+			const std::chrono::steady_clock::time_point END = std::chrono::steady_clock::now();
+
+			cycles[i] = TSCEND - TSCSTART;
+			nanos[i] = static_cast<ulong>(std::chrono::duration_cast<std::chrono::nanoseconds>(END - START).count());
+			total += nanos[i];
 		}
 
-		uint64_t dur = TestUtils::GetTimeMs64() - start;
+		std::sort(cycles.begin(), cycles.end());
+		std::sort(nanos.begin(), nanos.end());
 
-		delete kp;
+		// throughput on the configured thread count; each thread runs its own instance, so the run measures contention in the library and the memory system, not shared state.
+		// std::thread is used here, the ParallelUtils loop is an OpenMP region; with more than one thread the instances are serial, otherwise every thread would open a region on every core
+		std::vector<std::function<void()>> ops(THDCNT);
+		std::vector<std::thread> thds(0);
 
-		std::string nlen = TestUtils::ToString(Loops);
-		std::string secs = TestUtils::ToString((double)dur / 1000.0);
-		std::string ksec = TestUtils::ToString(GetUnitsPerSecond(dur, Loops));
-		std::string resp = std::string("Encrypted " + nlen + " messages in " + secs + " seconds, avg. " + ksec + " encrypted per second");
-
-		OnProgress(resp);
-		OnProgress(std::string(""));
-	}
-
-	void AsymmetricSpeedTest::MpkcDecryptLoop(MPKCParams Params, size_t Loops, IPrng* Rng, IBlockCipher* Cipher)
-	{
-		Cipher::Asymmetric::McEliece::McEliece asyCpr(Params, Rng, Cipher);
-		Key::Asymmetric::IAsymmetricKeyPair* kp;
-		kp = asyCpr.Generate();
-
-		std::vector<byte> enc;
-		std::vector<byte> dec;
-		std::vector<byte> msg(32);
-		Rng->GetBytes(msg);
-
-		asyCpr.Initialize(true, kp);
-		enc = asyCpr.Encrypt(msg);
-		asyCpr.Initialize(false, kp);
-
-		uint64_t start = TestUtils::GetTimeMs64();
-
-		for (size_t i = 0; i < Loops; ++i)
+		for (size_t i = 0; i < THDCNT; ++i)
 		{
-			dec = asyCpr.Decrypt(enc);
+			ops[i] = Factory(THDCNT == 1);
 		}
 
-		uint64_t dur = TestUtils::GetTimeMs64() - start;
+		const std::chrono::steady_clock::time_point THDSTART = std::chrono::steady_clock::now();
 
-		delete kp;
+		for (size_t i = 0; i < THDCNT; ++i)
+		{
+			std::function<void()>* thdOp = &ops[i];
+			thds.push_back(std::thread([thdOp, Loops]()
+			{
+				for (size_t j = 0; j < Loops; ++j)
+				{
+					(*thdOp)();
+				}
+			}));
+		}
 
-		std::string nlen = TestUtils::ToString(Loops);
-		std::string secs = TestUtils::ToString((double)dur / 1000.0);
-		std::string ksec = TestUtils::ToString(GetUnitsPerSecond(dur, Loops));
-		std::string resp = std::string("Decrypted " + nlen + " messages in " + secs + " seconds, avg. " + ksec + " derypted per second");
+		for (size_t i = 0; i < THDCNT; ++i)
+		{
+			thds[i].join();
+		}
 
-		OnProgress(resp);
+		const double THDSEC = std::chrono::duration<double>(std::chrono::steady_clock::now() - THDSTART).count();
+		const double OPSSEC = (total != 0) ? (static_cast<double>(Loops) * 1000000000.0) / static_cast<double>(total) : 0.0;
+		const double THDOPSSEC = (THDSEC != 0.0) ? static_cast<double>(Loops * THDCNT) / THDSEC : 0.0;
+		const ulong CYCOP = cycles[cycles.size() / 2];
+		const ulong P50 = Percentile(nanos, 0.5);
+		const ulong P99 = Percentile(nanos, 0.99);
+		const ulong P999 = Percentile(nanos, 0.999);
+
+		OnProgress(std::string("cycles/op: " + TestUtils::ToString(CYCOP) + (HASTSC ? "" : " (no time-stamp counter)")));
+		OnProgress(std::string("latency ns p50: " + TestUtils::ToString(P50) + " p99: " + TestUtils::ToString(P99) + " p99.9: " + TestUtils::ToString(P999)));
+		OnProgress(std::string("ops/sec 1 instance: " + TestUtils::ToString(static_cast<ulong>(OPSSEC)) + ", " + TestUtils::ToString(THDCNT) + " threads: " + TestUtils::ToString(static_cast<ulong>(THDOPSSEC))));
+		OnProgress(std::string("peak heap allocation (operator new) bytes: " + TestUtils::ToString(PEAKMEM)));
 		OnProgress(std::string(""));
+
+		Output << Cipher << "," << Parameters << "," << Operation << "," << Loops << "," << THDCNT << "," << CYCOP << "," << P50 << "," << P99 << "," << P999 << ","
+			<< static_cast<ulong>(OPSSEC) << "," << static_cast<ulong>(THDOPSSEC) << "," << PEAKMEM << std::endl;
 	}
 
-	void AsymmetricSpeedTest::RlweGenerateLoop(RLWEParams Params, size_t Loops, bool Parallel, IPrng* Rng, IBlockCipher* Cipher)
+	void AsymmetricSpeedTest::MpkcBenchmark(MPKCParams Params, const std::string &Name, std::ofstream &Output)
 	{
-		Cipher::Asymmetric::RLWE::RingLWE asyCpr(Params, Rng, Cipher, Parallel);
-		Key::Asymmetric::IAsymmetricKeyPair* kp;
+		using Cipher::Asymmetric::McEliece::McEliece;
 
-		uint64_t start = TestUtils::GetTimeMs64();
+		Prng::SecureRandom rnd;
+		std::vector<byte> msg(32);
+		rnd.GetBytes(msg);
 
-		for (size_t i = 0; i < Loops; ++i)
+		// the key pair and cipher-text are shared read-only by every instance
+		McEliece gen(Params);
+		std::shared_ptr<IAsymmetricKeyPair> kp(gen.Generate(), [](IAsymmetricKeyPair* Kp)
 		{
-			kp = asyCpr.Generate();
-		}
-
-		uint64_t dur = TestUtils::GetTimeMs64() - start;
-
-		delete kp;
+			delete Kp->PrivateKey();
+			delete Kp->PublicKey();
+			delete Kp;
+		});
+		gen.Initialize(true, kp.get());
+		const std::vector<byte> CPT = gen.Encrypt(msg);
+
+		// key generation is far slower than the other operations, so it runs fewer loops; with fewer than 1000 samples, p99.9 is the slowest sample
+		Benchmark("McEliece", Name, "keygen", MPKC_GEN_ITER, m_threadCount, [Params](bool Parallel)
+		{
+			std::shared_ptr<McEliece> cpr(new McEliece(Params, Enumeration::Prngs::BCR, Enumeration::BlockCiphers::Rijndael, Parallel));
+
+			return std::function<void()>([cpr]()
+			{
+				IAsymmetricKeyPair* tmp = cpr->Generate();
+				delete tmp->PrivateKey();
+				delete tmp->PublicKey();
+				delete tmp;
+			});
+		}, Output);
+
+		Benchmark("McEliece", Name, "encaps", DEF_TEST_ITER, m_threadCount, [Params, kp, msg](bool Parallel)
+		{
+			std::shared_ptr<McEliece> cpr(new McEliece(Params, Enumeration::Prngs::BCR, Enumeration::BlockCiphers::Rijndael, Parallel));
+			cpr->Initialize(true, kp.get());
 
-		std::string nlen = TestUtils::ToString(Loops);
-		std::string secs = TestUtils::ToString((double)dur / 1000.0);
-		std::string ksec = TestUtils::ToString(GetUnitsPerSecond(dur, Loops));
-		std::string resp = std::string("Generated " + nlen + " keypairs in " + secs + " seconds, avg. " + ksec + " generated per second");
+			return std::function<void()>([cpr, msg]()
+			{
+				cpr->Encrypt(msg);
+			});
+		}, Output);
 
-		OnProgress(resp);
-		OnProgress(std::string(""));
+		Benchmark("McEliece", Name, "decaps", DEF_TEST_ITER, m_threadCount, [Params, kp, CPT](bool Parallel)
+		{
+			std::shared_ptr<McEliece> cpr(new McEliece(Params, Enumeration::Prngs::BCR, Enumeration::BlockCiphers::Rijndael, Parallel));
+			cpr->Initialize(false, kp.get());
+
+			return std::function<void()>([cpr, CPT]()
+			{
+				cpr->Decrypt(CPT);
+			});
+		}, Output);
 	}
 
-	void AsymmetricSpeedTest::RlweEncryptLoop(RLWEParams Params, size_t Loops, bool Parallel, IPrng* Rng, IBlockCipher* Cipher)
+	void AsymmetricSpeedTest::OnProgress(std::string Data)
 	{
-		std::vector<byte> cpt;
-		std::vector<byte> msg(32);
-		Rng->GetBytes(msg);
-		Cipher::Asymmetric::RLWE::RingLWE asyCpr(Params, Rng, Cipher, Parallel);
-		Key::Asymmetric::IAsymmetricKeyPair* kp = asyCpr.Generate();
-		asyCpr.Initialize(true, kp);
+		m_progressEvent(Data);
+	}
 
-		uint64_t start = TestUtils::GetTimeMs64();
+	ulong AsymmetricSpeedTest::Percentile(const std::vector<ulong> &Sorted, double Fraction)
+	{
+		// nearest rank
+		size_t rnk = static_cast<size_t>(std::ceil(Fraction * static_cast<double>(Sorted.size())));
 
-		for (size_t i = 0; i < Loops; ++i)
+		if (rnk == 0)
 		{
-			cpt = asyCpr.Encrypt(msg);
+			rnk = 1;
 		}
 
-		uint64_t dur = TestUtils::GetTimeMs64() - start;
-
-		delete kp;
-
-		std::string nlen = TestUtils::ToString(Loops);
-		std::string secs = TestUtils::ToString((double)dur / 1000.0);
-		std::string ksec = TestUtils::ToString(GetUnitsPerSecond(dur, Loops));
-		std::string resp = std::string("Encrypted " + nlen + " messages in " + secs + " seconds, avg. " + ksec + " encrypted per second");
-
-		OnProgress(resp);
-		OnProgress(std::string(""));
+		return Sorted[std::min(rnk, Sorted.size()) - 1];
 	}
 
-	void AsymmetricSpeedTest::RlweDecryptLoop(RLWEParams Params, size_t Loops, bool Parallel, IPrng* Rng, IBlockCipher* Cipher)
+	void AsymmetricSpeedTest::RlweBenchmark(RLWEParams Params, const std::string &Name, std::ofstream &Output)
 	{
-		std::vector<byte> cpt;
-		Cipher::Asymmetric::RLWE::RingLWE asyCpr(Params, Rng, Cipher, Parallel);
-		Key::Asymmetric::IAsymmetricKeyPair* kp = asyCpr.Generate();
-		asyCpr.Initialize(true, kp);
-		std::vector<byte> msg(32);
-		Rng->GetBytes(msg);
-		cpt = asyCpr.Encrypt(msg);
-		asyCpr.Initialize(false , kp);
+		using Cipher::Asymmetric::RLWE::RingLWE;
 
-		uint64_t start = TestUtils::GetTimeMs64();
+		Prng::SecureRandom rnd;
+		std::vector<byte> msg(32);
+		rnd.GetBytes(msg);
 
-		for (size_t i = 0; i < Loops; ++i)
+		// the key pair and cipher-text are shared read-only by every instance
+		RingLWE gen(Params);
+		std::shared_ptr<IAsymmetricKeyPair> kp(gen.Generate(), [](IAsymmetricKeyPair* Kp)
 		{
-			msg = asyCpr.Decrypt(cpt);
-		}
-
-		uint64_t dur = TestUtils::GetTimeMs64() - start;
-
-		delete kp;
-
-		std::string nlen = TestUtils::ToString(Loops);
-		std::string secs = TestUtils::ToString((double)dur / 1000.0);
-		std::string ksec = TestUtils::ToString(GetUnitsPerSecond(dur, Loops));
-		std::string resp = std::string("Decrypted " + nlen + " messages in " + secs + " seconds, avg. " + ksec + " decrypted per second");
-
-		OnProgress(resp);
-		OnProgress(std::string(""));
-	}
-
-	uint64_t AsymmetricSpeedTest::GetUnitsPerSecond(uint64_t DurationTicks, uint64_t Count)
-	{
-		double sec = (double)DurationTicks / 1000.0;
-		double sze = (double)Count;
+			delete Kp->PrivateKey();
+			delete Kp->PublicKey();
+			delete Kp;
+		});
+		gen.Initialize(true, kp.get());
+		const std::vector<byte> CPT = gen.Encrypt(msg);
+
+		// the single message RingLWE operations are not multi-threaded by default, and are measured in that configuration by both runs
+		Benchmark("RingLWE", Name, "keygen", DEF_TEST_ITER, m_threadCount, [Params](bool)
+		{
+			std::shared_ptr<RingLWE> cpr(new RingLWE(Params));
+
+			return std::function<void()>([cpr]()
+			{
+				IAsymmetricKeyPair* tmp = cpr->Generate();
+				delete tmp->PrivateKey();
+				delete tmp->PublicKey();
+				delete tmp;
+			});
+		}, Output);
+
+		Benchmark("RingLWE", Name, "encaps", DEF_TEST_ITER, m_threadCount, [Params, kp, msg](bool)
+		{
+			std::shared_ptr<RingLWE> cpr(new RingLWE(Params));
+			cpr->Initialize(true, kp.get());
 
-		return (uint64_t)(sze / sec);
-	}
+			return std::function<void()>([cpr, msg]()
+			{
+				cpr->Encrypt(msg);
+			});
+		}, Output);
 
-	void AsymmetricSpeedTest::OnProgress(std::string Data)
-	{
-		m_progressEvent(Data);
+		Benchmark("RingLWE", Name, "decaps", DEF_TEST_ITER, m_threadCount, [Params, kp, CPT](bool)
+		{
+			std::shared_ptr<RingLWE> cpr(new RingLWE(Params));
+			cpr->Initialize(false, kp.get());
+
+			return std::function<void()>([cpr, CPT]()
+			{
+				cpr->Decrypt(CPT);
+			});
+		}, Output);
 	}
-}
\ No newline at end of file
+}
@@ -3,20 +3,23 @@
 
 #include "ITest.h"
 #include "../CEX/AsymmetricEngines.h"
-#include "../CEX/IBlockCipher.h"
 #include "../CEX/MPKCParams.h"
-#include "../CEX/IPrng.h"
 #include "../CEX/RLWEParams.h"
+#include <fstream>
+#include <functional>
 
 namespace Test
 {
-	using Cipher::Symmetric::Block::IBlockCipher;
 	using Enumeration::MPKCParams;
-	using Prng::IPrng;
 	using Enumeration::RLWEParams;
 
 	/// <summary>
 	/// Asymmetric Cipher and Signature Scheme Speed Tests
+	/// <para>Every parameter set is measured for key generation, encapsulation (Encrypt), and decapsulation (Decrypt).
+	/// Each operation reports the median cycles per operation from the RDTSC time-stamp counter, the p50, p99, and p99.9 latencies,
+	/// the operations per second of one instance (with the ciphers default threading) and of one instance per thread on the configured number of threads, and the peak heap allocation of a single operation.
+/// The peak heap figure counts only the memory allocated through operator new; stack use, and memory obtained through other allocators, are not included.
+	/// The results are also written as comma separated values to the RESULT_FILE in the working directory, one row per operation.</para>
 	/// </summary>
 	class AsymmetricSpeedTest : public ITest
 	{
@@ -24,22 +27,27 @@ namespace Test
 		static const std::string DESCRIPTION;
 		static const std::string FAILURE;
 		static const std::string MESSAGE;
-		static const uint64_t KB1 = 1000;
-		static const uint64_t MB1 = KB1 * 1000;
-		static const uint64_t MB10 = MB1 * 10;
-		static const uint64_t MB100 = MB1 * 100;
-		static const uint64_t GB1 = MB1 * 1000;
-		static const uint64_t DEF_DATA_SIZE = MB100;
+		static const std::string RESULT_FILE;
+		static const std::string RESULT_HEADER;
 #if defined (_DEBUG)
-		static const uint64_t DEF_TEST_ITER = 10;
+		static const size_t DEF_TEST_ITER = 100;
+		static const size_t MPKC_GEN_ITER = 2;
 #else
-		static const uint64_t DEF_TEST_ITER = 100;
+		static const size_t DEF_TEST_ITER = 1000;
+		static const size_t MPKC_GEN_ITER = 20;
 #endif
 
 		TestEventHandler m_progressEvent;
+		size_t m_threadCount;
 
 	public:
 
+		/// <summary>
+		/// An operation under test; the returned function performs one operation, and owns the cipher and keys it uses.
+		/// <para>The argument selects the internal multi-threading of the cipher; it is false for the instances of a throughput run with more than one thread.</para>
+		/// </summary>
+		typedef std::function<std::function<void()>(bool)> OperationFactory;
+
 		/// <summary>
 		/// Get: The test description
 		/// </summary>
@@ -53,7 +61,9 @@ namespace Test
 		/// <summary>
 		/// Initailize this class
 		/// </summary>
-		AsymmetricSpeedTest();
+		///
+		/// <param name="Threads">The number of threads used by the throughput runs; the default of zero uses one thread per processor core</param>
+		explicit AsymmetricSpeedTest(size_t Threads = 0);
 
 		/// <summary>
 		/// Destructor
@@ -65,17 +75,29 @@ namespace Test
 		/// </summary>
 		virtual std::string Run();
 
+		/// <summary>
+		/// Measure an operation and report the result
+		/// <para>The factory is called once for the latency run, and once for each thread of the throughput run, so each thread has its own cipher instance.
+		/// The latency run uses the ciphers default threading. When the throughput run uses more than one thread, its instances are created with internal multi-threading disabled,
+		/// so the threads do not oversubscribe the processor cores. The setup done by the factory is not timed.</para>
+		/// </summary>
+		///
+		/// <param name="Cipher">The cipher name written to the result</param>
+		/// <param name="Parameters">The parameter set name written to the result</param>
+		/// <param name="Operation">The operation name written to the result</param>
+		/// <param name="Loops">The number of timed operations per thread</param>
+		/// <param name="Threads">The number of threads used by the throughput run</param>
+		/// <param name="Factory">Creates an instance of the operation</param>
+		/// <param name="Output">The result file stream</param>
+		void Benchmark(const std::string &Cipher, const std::string &Parameters, const std::string &Operation, size_t Loops, size_t Threads, const OperationFactory &Factory, std::ofstream &Output);
+
 	private:
 
-		void MpkcDecryptLoop(MPKCParams Params, size_t Loops, IPrng* Rng, IBlockCipher* Cipher);
-		void MpkcEncryptLoop(MPKCParams Params, size_t Loops, IPrng* Rng, IBlockCipher* Cipher);
-		void MpkcGenerateLoop(MPKCParams Params, size_t Loops, IPrng* Rng, IBlockCipher* Cipher);
-		void RlweDecryptLoop(RLWEParams Params, size_t Loops, bool Parallel, IPrng* Rng, IBlockCipher* Cipher);
-		void RlweEncryptLoop(RLWEParams Params, size_t Loops, bool Parallel, IPrng* Rng, IBlockCipher* Cipher);
-		void RlweGenerateLoop(RLWEParams Params, size_t Loops, bool Parallel, IPrng* Rng, IBlockCipher* Cipher);
-		uint64_t GetUnitsPerSecond(uint64_t DurationTicks, uint64_t Count);
+		void MpkcBenchmark(MPKCParams Params, const std::string &Name, std::ofstream &Output);
 		void OnProgress(std::string Data);
+		static ulong Percentile(const std::vector<ulong> &Sorted, double Fraction);
+		void RlweBenchmark(RLWEParams Params, const std::string &Name, std::ofstream &Output);
 	};
 }
 
-#endif
\ No newline at end of file
+#endif
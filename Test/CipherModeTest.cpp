@@ -337,6 +337,37 @@ namespace Test
 			}
 			delete eng;
 		}
+
+		// precomputed key-stream; two blocks generated ahead on the calling thread, the rest by a background worker
+		for (size_t j = 0; j < 2; ++j)
+		{
+			RHX* eng = new RHX();
+			Mode::OFB mode(eng);
+			Key::Symmetric::SymmetricKey k(Key, iv);
+			mode.Initialize(true, k);
+			mode.Precompute(32, false);
+
+			if (mode.KeyStreamReady() != 32)
+			{
+				throw TestException("OFB Mode: Precomputed key-stream length is invalid!");
+			}
+
+			for (size_t i = 0; i < 4; i++)
+			{
+				if (i == 2)
+				{
+					mode.Precompute(32, true);
+				}
+
+				mode.Transform(Input[index - j][i], 0, outBytes, 0, outBytes.size());
+
+				if (outBytes != Output[index - j][i])
+				{
+					throw TestException("OFB Mode: Precomputed key-stream output is not equal!");
+				}
+			}
+			delete eng;
+		}
 	}
 
 	void CipherModeTest::Initialize()
@@ -2,6 +2,7 @@
 #include "../CEX/CpuDetect.h"
 #include "../CEX/CTR.h"
 #include "../CEX/AHX.h"
+#include "../CEX/KeyScheduleCache.h"
 #include "../CEX/RHX.h"
 #include "../CEX/SHX.h"
 #include "../CEX/THX.h"
@@ -43,6 +44,8 @@ namespace Test
 			{
 				AHXMonteCarlo();
 				OnProgress(std::string("AHX: Passed AES-NI Monte Carlo tests.."));
+				AHXBatch();
+				OnProgress(std::string("AHX: Passed AES-NI batch key expansion tests.."));
 			}
 #endif
 			RHXMonteCarlo();
@@ -51,6 +54,8 @@ namespace Test
 			OnProgress(std::string("SHX: Passed SHX Monte Carlo tests.."));
 			THXMonteCarlo();
 			OnProgress(std::string("THX: Passed THX Monte Carlo tests.."));
+			KeyCache();
+			OnProgress(std::string("HX: Passed key schedule cache tests.."));
 
 			return SUCCESS;
 		}
@@ -105,12 +110,256 @@ namespace Test
 		}
 	}
 
+	void HXCipherTest::KeyCache()
+	{
+		std::vector<byte> inpBytes(16, 0);
+		std::vector<byte> expBytes(16, 0);
+		std::vector<byte> outBytes(16, 0);
+		std::vector<byte> decBytes(16, 0);
+		std::vector<byte> key2(m_key);
+		key2[0] ^= 1;
+		Key::Symmetric::SymmetricKey k(m_key);
+		Key::Symmetric::SymmetricKey k2(key2);
+		KeyScheduleCache cache(1);
+
+		// RHX, uncached reference output
+		{
+			RHX eng(Digests::SHA512, 22);
+			eng.Initialize(true, k);
+			eng.EncryptBlock(inpBytes, expBytes);
+		}
+		// the first initialization adds the schedule, the second copies it
+		{
+			RHX eng1(Digests::SHA512, 22);
+			eng1.KeyCache() = &cache;
+			eng1.Initialize(true, k);
+			RHX eng2(Digests::SHA512, 22);
+			eng2.KeyCache() = &cache;
+			eng2.Initialize(true, k);
+			eng2.EncryptBlock(inpBytes, outBytes);
+
+			if (outBytes != expBytes || cache.Count() != 1)
+			{
+				throw TestException("RHX: Failed cached key schedule test!");
+			}
+
+			// the decryption schedule is inverted from the cached expansion
+			RHX eng3(Digests::SHA512, 22);
+			eng3.KeyCache() = &cache;
+			eng3.Initialize(false, k);
+			eng3.DecryptBlock(outBytes, decBytes);
+
+			if (decBytes != inpBytes)
+			{
+				throw TestException("RHX: Failed cached key schedule decryption test!");
+			}
+
+			// rekey evicts the only entry, then returns to the original key
+			eng2.Rekey(k2);
+			eng2.EncryptBlock(inpBytes, outBytes);
+
+			if (outBytes == expBytes || cache.Count() != 1)
+			{
+				throw TestException("RHX: Failed rekey test!");
+			}
+
+			eng2.Rekey(k);
+			eng2.EncryptBlock(inpBytes, outBytes);
+
+			if (outBytes != expBytes)
+			{
+				throw TestException("RHX: Failed rekey test!");
+			}
+		}
+
+		cache.Clear();
+
+		if (cache.Count() != 0)
+		{
+			throw TestException("HX: Failed key schedule cache clear test!");
+		}
+
+		// SHX, THX, and AHX share one cache; with room for two schedules, a second key does not evict the first
+		const BlockCiphers HXTYPES[3] = { BlockCiphers::SHX, BlockCiphers::THX, BlockCiphers::AHX };
+		// the expanded schedule byte sizes: 16 * (rounds + 1) for SHX and AHX, 4 * (2 * rounds + 8) for THX
+		const size_t HXSCHEDULE[3] = { 656, 192, 368 };
+		const std::string HXNAMES[3] = { "SHX", "THX", "AHX" };
+		KeyScheduleCache hxCache(2);
+		std::vector<byte> expBytes2(16, 0);
+		Common::CpuDetect detect;
+
+		auto hxCreate = [](BlockCiphers CipherType, KeyScheduleCache* Cache) -> IBlockCipher*
+		{
+			if (CipherType == BlockCiphers::SHX)
+			{
+				SHX* eng = new SHX(Digests::SHA512, 40);
+				eng->KeyCache() = Cache;
+				return eng;
+			}
+			else if (CipherType == BlockCiphers::THX)
+			{
+				THX* eng = new THX(Digests::SHA512, 20);
+				eng->KeyCache() = Cache;
+				return eng;
+			}
+			else
+			{
+				AHX* eng = new AHX(Digests::SHA512, 22);
+				eng->KeyCache() = Cache;
+				return eng;
+			}
+		};
+
+		for (size_t i = 0; i < 3; ++i)
+		{
+#if defined(__AVX__)
+			if (HXTYPES[i] == BlockCiphers::AHX && !detect.AESNI())
+			{
+				continue;
+			}
+#else
+			if (HXTYPES[i] == BlockCiphers::AHX)
+			{
+				continue;
+			}
+#endif
+			// uncached reference outputs for both keys
+			IBlockCipher* ref = hxCreate(HXTYPES[i], 0);
+			ref->Initialize(true, k);
+			ref->EncryptBlock(inpBytes, expBytes);
+			ref->Initialize(true, k2);
+			ref->EncryptBlock(inpBytes, expBytes2);
+			std::vector<byte> dstInfo = ref->DistributionCode();
+			delete ref;
+
+			// the first instance expands and adds the schedule, the second copies it
+			IBlockCipher* eng1 = hxCreate(HXTYPES[i], &hxCache);
+			eng1->Initialize(true, k);
+			eng1->EncryptBlock(inpBytes, outBytes);
+
+			if (outBytes != expBytes || hxCache.Count() != 1)
+			{
+				throw TestException(HXNAMES[i] + ": Failed key schedule cache add test!");
+			}
+
+			IBlockCipher* eng2 = hxCreate(HXTYPES[i], &hxCache);
+			eng2->Initialize(true, k);
+			eng2->EncryptBlock(inpBytes, outBytes);
+
+			if (outBytes != expBytes || hxCache.Count() != 1)
+			{
+				throw TestException(HXNAMES[i] + ": Failed cached key schedule test!");
+			}
+
+			// the decryption schedule is derived from the cached expansion
+			eng2->Initialize(false, k);
+			eng2->DecryptBlock(outBytes, decBytes);
+
+			if (decBytes != inpBytes)
+			{
+				throw TestException(HXNAMES[i] + ": Failed cached key schedule decryption test!");
+			}
+
+			// a second key is added alongside the first, and both are served from the cache
+			eng2->Initialize(true, k2);
+			eng2->EncryptBlock(inpBytes, outBytes);
+
+			if (outBytes != expBytes2 || hxCache.Count() != 2)
+			{
+				throw TestException(HXNAMES[i] + ": Failed second key schedule cache test!");
+			}
+
+			eng1->Initialize(true, k);
+			eng1->EncryptBlock(inpBytes, outBytes);
+
+			if (outBytes != expBytes || hxCache.Count() != 2)
+			{
+				throw TestException(HXNAMES[i] + ": Failed rekey test!");
+			}
+
+			// the cipher must use the stored schedule rather than expanding the key: file the schedule of the first key under the second,
+			// an instance keyed with the second key then produces the output of the first
+			std::vector<byte> sched(HXSCHEDULE[i]);
+
+			if (!hxCache.Find(HXTYPES[i], Digests::SHA512, eng1->Rounds(), m_key, dstInfo, sched))
+			{
+				throw TestException(HXNAMES[i] + ": Failed key schedule lookup test!");
+			}
+
+			hxCache.Clear();
+			hxCache.Add(HXTYPES[i], Digests::SHA512, eng1->Rounds(), key2, dstInfo, sched);
+			IBlockCipher* eng3 = hxCreate(HXTYPES[i], &hxCache);
+			eng3->Initialize(true, k2);
+			eng3->EncryptBlock(inpBytes, outBytes);
+
+			if (outBytes != expBytes)
+			{
+				throw TestException(HXNAMES[i] + ": Failed key schedule reuse test!");
+			}
+
+			hxCache.Clear();
+			delete eng1;
+			delete eng2;
+			delete eng3;
+		}
+	}
+
 	void HXCipherTest::OnProgress(std::string Data)
 	{
 		m_progressEvent(Data);
 	}
 
 #if defined(__AVX__)
+	void HXCipherTest::AHXBatch()
+	{
+		// mixed key sizes; 192 bit keys and hkdf ciphers take the individual path
+		const size_t KEYLEN[12] = { 16, 32, 64, 16, 24, 16, 32, 16, 64, 16, 16, 32 };
+		std::vector<byte> inpBytes(16, 0);
+		std::vector<byte> expBytes(16, 0);
+		std::vector<byte> outBytes(16, 0);
+		std::vector<byte> decBytes(16, 0);
+		std::vector<Key::Symmetric::SymmetricKey*> keys;
+		std::vector<ISymmetricKey*> keyParams;
+		std::vector<AHX*> enc;
+		std::vector<AHX*> dec;
+
+		for (size_t i = 0; i < 12; ++i)
+		{
+			std::vector<byte> key(m_key.begin(), m_key.begin() + KEYLEN[i]);
+			key[0] = static_cast<byte>(i);
+			keys.push_back(new Key::Symmetric::SymmetricKey(key));
+			keyParams.push_back(keys[i]);
+			enc.push_back(i == 6 ? new AHX(Digests::SHA256, 22) : new AHX());
+			dec.push_back(i == 6 ? new AHX(Digests::SHA256, 22) : new AHX());
+		}
+
+		AHX::InitializeBatch(enc, dec, keyParams);
+
+		for (size_t i = 0; i < 12; ++i)
+		{
+			AHX ref(i == 6 ? Digests::SHA256 : Digests::None, 22);
+			ref.Initialize(true, *keys[i]);
+			ref.EncryptBlock(inpBytes, expBytes);
+			enc[i]->EncryptBlock(inpBytes, outBytes);
+
+			if (outBytes != expBytes)
+			{
+				throw TestException("AHX: Failed batch key expansion encryption test!");
+			}
+
+			dec[i]->DecryptBlock(outBytes, decBytes);
+
+			if (decBytes != inpBytes)
+			{
+				throw TestException("AHX: Failed batch key expansion decryption test!");
+			}
+
+			delete enc[i];
+			delete dec[i];
+			delete keys[i];
+		}
+	}
+
 	void HXCipherTest::AHXMonteCarlo()
 	{
 		std::vector<byte> inpBytes(16, 0);
@@ -52,8 +52,10 @@ namespace Test
 
 	private:
 		void Initialize();
+		void KeyCache();
 		void OnProgress(std::string Data);
 #if defined(__AVX__)
+		void AHXBatch();
 		void AHXMonteCarlo();
 #endif
 		void RHXMonteCarlo();
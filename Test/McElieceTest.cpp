@@ -1,12 +1,19 @@
 #include "McElieceTest.h"
+#include "../CEX/AeadStream.h"
+#include "../CEX/AsymmetricKeyImage.h"
 #include "../CEX/BCR.h"
+#include "../CEX/CryptoAuthenticationFailure.h"
 #include "../CEX/McEliece.h"
 #include "../CEX/IAsymmetricKeyPair.h"
+#include "../CEX/MemoryMappedFile.h"
+#include "../CEX/MemoryStream.h"
 #include "../CEX/MPKCKeyPair.h"
 #include "../CEX/MPKCPrivateKey.h"
 #include "../CEX/MPKCPublicKey.h"
 #include "../CEX/RHX.h"
 #include "../CEX/SecureRandom.h"
+#include <cstdio>
+#include <fstream>
 
 namespace Test
 {
@@ -35,6 +42,12 @@ namespace Test
 			OnProgress(std::string("McElieceTest: Passed encryption and Decryption stress tests.."));
 			SerializationCompare();
 			OnProgress(std::string("McElieceTest: Passed key serialization tests.."));
+			BatchStress();
+			OnProgress(std::string("McElieceTest: Passed batch encryption and decryption tests.."));
+			MappedKeyStress();
+			OnProgress(std::string("McElieceTest: Passed memory mapped key image tests.."));
+			StreamStress();
+			OnProgress(std::string("McElieceTest: Passed stream encryption tests.."));
 
 			return SUCCESS;
 		}
@@ -48,6 +61,197 @@ namespace Test
 		}
 	}
 
+	void McElieceTest::BatchStress()
+	{
+		std::vector<byte> dec;
+		std::vector<std::vector<byte>> enc;
+		std::vector<std::vector<byte>> msg(16);
+		Prng::SecureRandom rnd;
+
+		McEliece cpr(Enumeration::MPKCParams::M12T62);
+		IAsymmetricKeyPair* kp = cpr.Generate();
+
+		for (size_t i = 0; i < msg.size(); ++i)
+		{
+			msg[i].resize(32 + i);
+			rnd.GetBytes(msg[i]);
+		}
+
+		cpr.Initialize(true, kp);
+		enc = cpr.Encrypt(msg);
+
+		if (enc.size() != msg.size())
+		{
+			throw TestException("McElieceTest: The encrypted batch is the wrong size!");
+		}
+
+		cpr.Initialize(false, kp);
+
+		for (size_t i = 0; i < enc.size(); ++i)
+		{
+			dec = cpr.Decrypt(enc[i]);
+
+			if (dec != msg[i])
+			{
+				throw TestException("McElieceTest: Decrypted batch output is not equal!");
+			}
+		}
+
+		// decrypt the batch, then a batch that does not fill the last group of lanes
+		std::vector<bool> valid;
+		std::vector<std::vector<byte>> decs = cpr.Decrypt(enc, valid);
+
+		if (decs != msg || valid != std::vector<bool>(msg.size(), true))
+		{
+			throw TestException("McElieceTest: Batch decryption output is not equal!");
+		}
+
+		enc.resize(7);
+		decs = cpr.Decrypt(enc, valid);
+
+		for (size_t i = 0; i < decs.size(); ++i)
+		{
+			if (decs[i] != msg[i] || !valid[i])
+			{
+				throw TestException("McElieceTest: Partial batch decryption output is not equal!");
+			}
+		}
+
+		// a mixed batch; an altered syndrome, an altered tag, and a truncated cipher-text are reported individually, the valid messages are still returned
+		enc[1][0] ^= 1;
+		enc[3][enc[3].size() - 1] ^= 1;
+		enc[5].resize(8);
+		decs = cpr.Decrypt(enc, valid);
+
+		if (decs.size() != enc.size() || valid.size() != enc.size())
+		{
+			throw TestException("McElieceTest: Mixed batch decryption returned the wrong size!");
+		}
+
+		for (size_t i = 0; i < decs.size(); ++i)
+		{
+			const bool EXPVLD = (i != 1 && i != 3 && i != 5);
+
+			if (valid[i] != EXPVLD)
+			{
+				throw TestException("McElieceTest: Mixed batch decryption authentication test has failed!");
+			}
+			if (EXPVLD ? (decs[i] != msg[i]) : (decs[i].size() != 0))
+			{
+				throw TestException("McElieceTest: Mixed batch decryption output is not equal!");
+			}
+		}
+
+		delete kp;
+	}
+
+	void McElieceTest::MappedKeyStress()
+	{
+		const std::string PRIFILE = "McElieceTest.pri";
+		const std::string PUBFILE = "McElieceTest.pub";
+		std::vector<byte> dec;
+		std::vector<byte> enc;
+		std::vector<byte> img;
+		std::vector<byte> msg(32);
+		Prng::SecureRandom rnd;
+
+		McEliece cpr(Enumeration::MPKCParams::M12T62);
+		IAsymmetricKeyPair* kp = cpr.Generate();
+		MPKCPrivateKey* priK1 = (MPKCPrivateKey*)kp->PrivateKey();
+		MPKCPublicKey* pubK1 = (MPKCPublicKey*)kp->PublicKey();
+
+		img = priK1->ToImage();
+		std::ofstream priOut(PRIFILE, std::ios::out | std::ios::binary | std::ios::trunc);
+		priOut.write(reinterpret_cast<const char*>(img.data()), img.size());
+		priOut.close();
+
+		img = pubK1->ToImage();
+		std::ofstream pubOut(PUBFILE, std::ios::out | std::ios::binary | std::ios::trunc);
+		pubOut.write(reinterpret_cast<const char*>(img.data()), img.size());
+		pubOut.close();
+
+		IO::MemoryMappedFile priMap(PRIFILE);
+		IO::MemoryMappedFile pubMap(PUBFILE);
+		MPKCPrivateKey* priK2 = new MPKCPrivateKey(priMap.View());
+		MPKCPublicKey* pubK2 = new MPKCPublicKey(pubMap.View());
+
+		if (priK1->S() != priK2->S() || priK1->Parameters() != priK2->Parameters())
+		{
+			throw TestException("McElieceTest: Mapped private key comparison has failed!");
+		}
+		if (pubK1->P() != pubK2->P() || pubK1->Parameters() != pubK2->Parameters())
+		{
+			throw TestException("McElieceTest: Mapped public key comparison has failed!");
+		}
+		// the keys must be read from the mapping, not copied out of it
+		if (priK2->S().data() != priMap.Data() + AsymmetricKeyImage::HEADER_SIZE || pubK2->P().data() != pubMap.Data() + AsymmetricKeyImage::HEADER_SIZE)
+		{
+			throw TestException("McElieceTest: Mapped key was copied!");
+		}
+
+		MPKCKeyPair* kp2 = new MPKCKeyPair(priK2, pubK2);
+
+		for (size_t i = 0; i < 10; ++i)
+		{
+			rnd.GetBytes(msg);
+			cpr.Initialize(true, kp2);
+			enc = cpr.Encrypt(msg);
+			cpr.Initialize(false, kp2);
+			dec = cpr.Decrypt(enc);
+
+			if (dec != msg)
+			{
+				throw TestException("McElieceTest: Mapped key cipher-text decryption has failed!");
+			}
+		}
+
+		// a truncated image must be rejected
+		bool status = false;
+
+		try
+		{
+			MPKCPublicKey pubK3(IO::ByteView(pubMap.Data(), pubMap.Length() / 2));
+		}
+		catch (Exception::CryptoAsymmetricException const &)
+		{
+			status = true;
+		}
+
+		if (!status)
+		{
+			throw TestException("McElieceTest: A truncated key image was accepted!");
+		}
+
+		// a private key image is not a public key
+		status = false;
+
+		try
+		{
+			MPKCPublicKey pubK4(priMap.View());
+		}
+		catch (Exception::CryptoAsymmetricException const &)
+		{
+			status = true;
+		}
+
+		if (!status)
+		{
+			throw TestException("McElieceTest: The wrong key class was accepted!");
+		}
+
+		delete kp2;
+		delete priK2;
+		delete pubK2;
+		priMap.Destroy();
+		pubMap.Destroy();
+		std::remove(PRIFILE.c_str());
+		std::remove(PUBFILE.c_str());
+
+		delete kp;
+		delete priK1;
+		delete pubK1;
+	}
+
 	void McElieceTest::SerializationCompare()
 	{
 		std::vector<byte> pkey;
@@ -78,6 +282,120 @@ namespace Test
 		delete pubK1;
 	}
 
+	void McElieceTest::StreamStress()
+	{
+		const size_t CNKSZE = Processing::AeadStream::CHUNK_SIZE;
+		const size_t TAGSZE = 16;
+		const std::vector<size_t> MSGLEN = { 0, 1, CNKSZE, CNKSZE + 1, (2 * 1024 * 1024) + 5 };
+		Prng::SecureRandom rnd;
+
+		McEliece cpr(Enumeration::MPKCParams::M12T62);
+		IAsymmetricKeyPair* kp = cpr.Generate();
+		// the stream begins with the syndrome
+		const size_t HDRSZE = (cpr.ParamSet().GF * cpr.ParamSet().T) / 8;
+
+		for (size_t i = 0; i < MSGLEN.size(); ++i)
+		{
+			std::vector<byte> msg(MSGLEN[i]);
+
+			if (msg.size() != 0)
+			{
+				rnd.GetBytes(msg);
+			}
+
+
+			IO::MemoryStream inp(msg);
+			IO::MemoryStream enc;
+			cpr.Initialize(true, kp);
+			cpr.Encrypt(&inp, &enc);
+
+			if (enc.Length() != HDRSZE + Processing::AeadStream::SealedLength(msg.size(), TAGSZE))
+			{
+				throw TestException("McElieceTest: The encrypted stream is the wrong size!");
+			}
+
+			IO::MemoryStream ctx(enc.ToArray());
+			IO::MemoryStream dec;
+			cpr.Initialize(false, kp);
+			cpr.Decrypt(&ctx, &dec);
+
+			if (dec.ToArray() != msg)
+			{
+				throw TestException("McElieceTest: Decrypted stream output is not equal!");
+			}
+
+			// an altered byte in the first chunk must fail authentication
+			std::vector<byte> cpt = enc.ToArray();
+			cpt[HDRSZE] ^= 1;
+			IO::MemoryStream alt(cpt);
+			IO::MemoryStream out;
+			bool status = false;
+
+			try
+			{
+				cpr.Decrypt(&alt, &out);
+			}
+			catch (Exception::CryptoAuthenticationFailure const &)
+			{
+				status = true;
+			}
+
+			if (!status || out.Length() != 0)
+			{
+				throw TestException("McElieceTest: Stream authentication test has failed!");
+			}
+
+			// a stream cut on a chunk boundary must fail authentication
+			if (msg.size() > CNKSZE)
+			{
+				cpt = enc.ToArray();
+				cpt.resize(HDRSZE + CNKSZE + TAGSZE);
+				IO::MemoryStream trn(cpt);
+				IO::MemoryStream trd;
+				status = false;
+
+				try
+				{
+					cpr.Decrypt(&trn, &trd);
+				}
+				catch (Exception::CryptoAuthenticationFailure const &)
+				{
+					status = true;
+				}
+
+				if (!status || trd.Length() != 0)
+				{
+					throw TestException("McElieceTest: Stream truncation test has failed!");
+				}
+			}
+
+			// data appended to the stream must be rejected, including a fragment the size of a tag
+			cpt = enc.ToArray();
+			cpt.resize(cpt.size() + TAGSZE);
+			IO::MemoryStream apd(cpt);
+			IO::MemoryStream apo;
+			status = false;
+
+			try
+			{
+				cpr.Decrypt(&apd, &apo);
+			}
+			catch (Exception::CryptoAuthenticationFailure const &)
+			{
+				status = true;
+			}
+
+			if (!status)
+			{
+				throw TestException("McElieceTest: Stream extension test has failed!");
+			}
+		}
+
+		delete kp->PrivateKey();
+		delete kp->PublicKey();
+		delete kp;
+	}
+
 	void McElieceTest::StressLoop()
 	{
 		std::vector<byte> enc;
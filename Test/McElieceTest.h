@@ -45,7 +45,10 @@ namespace Test
 
 	private:
 
+		void BatchStress();
+		void MappedKeyStress();
 		void OnProgress(std::string Data);
+		void StreamStress();
 		void StressLoop();
 		void SerializationCompare();
 	};
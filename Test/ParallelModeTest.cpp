@@ -4,13 +4,18 @@
 #	include "../CEX/AHX.h"
 #endif
 #include "../CEX/CBC.h"
+#include "../CEX/CBCT.h"
 #include "../CEX/CFB.h"
 #include "../CEX/ChaCha20.h"
 #include "../CEX/CpuDetect.h"
 #include "../CEX/CSP.h"
 #include "../CEX/CTR.h"
+#include "../CEX/CTRT.h"
 #include "../CEX/ECB.h"
+#include "../CEX/ECBT.h"
 #include "../CEX/ICM.h"
+#include "../CEX/ICMT.h"
+#include "../CEX/OFB.h"
 #include "../CEX/ParallelUtils.h"
 #include "../CEX/RHX.h"
 #include "../CEX/SecureRandom.h"
@@ -130,6 +135,12 @@ namespace Test
 			OnProgress(std::string("ParallelModeTest: Passed CBC/CFB/CTR/ICM Parallel encryption and decryption looping Integrity tests.."));
 			CompareParallelOutput();
 			OnProgress(std::string("ParallelModeTest: Passed CBC/CFB/CTR/ICM Parallel output encryption and decryption tests.."));
+			CompareSeek();
+			OnProgress(std::string("ParallelModeTest: Passed CTR/ICM/ChaCha/Salsa positional key-stream tests.."));
+			CompareTemplate();
+			OnProgress(std::string("ParallelModeTest: Passed CBCT/CTRT/ECBT/ICMT template mode comparison tests.."));
+			CompareClone();
+			OnProgress(std::string("ParallelModeTest: Passed CBC/CTR/ICM/OFB cloned context comparison tests.."));
 
 			return SUCCESS;
 		}
@@ -1159,6 +1170,100 @@ namespace Test
 		OnProgress(std::string("ParallelModeTest: Passed Parallel CFB decryption tests"));
 	}
 
+	void ParallelModeTest::CompareSeek()
+	{
+		// compares random access output with the sequential key-stream
+		const std::string NAMES[4] = { "CTR", "ICM", "ChaCha", "Salsa" };
+		std::vector<byte> data;
+		std::vector<byte> enc;
+		std::vector<byte> key;
+		std::vector<byte> iv;
+		std::vector<byte> nonce;
+		Prng::SecureRandom rng;
+
+		GetBytes(32, key);
+		GetBytes(16, iv);
+		GetBytes(8, nonce);
+		GetBytes(MAX_ALLOC * 4, data);
+		enc.resize(data.size());
+
+		for (size_t c = 0; c < 4; ++c)
+		{
+			SeekTransform cipher = GetSeekCipher(c, key, (c < 2) ? iv : nonce);
+			cipher(false, 0, data, 0, enc, 0, data.size());
+
+			for (size_t i = 0; i < TEST_LOOPS; ++i)
+			{
+				const size_t POS = rng.NextUInt32(static_cast<uint>(data.size() - 1));
+				const size_t LEN = rng.NextUInt32(static_cast<uint>(data.size() - POS), 1);
+				std::vector<byte> tmp(LEN);
+
+				cipher(i % 2 == 0, POS, data, POS, tmp, 0, LEN);
+
+				if (!std::equal(tmp.begin(), tmp.end(), enc.begin() + POS))
+				{
+					throw TestException("Seek " + NAMES[c] + ": Positional output is not equal!");
+				}
+			}
+		}
+
+		// the block mode counters are offset by the seek position; offsets and counters with 0xFF bytes carry across several bytes of the counter,
+		// so the output at the offset is compared with a cipher keyed with the counter added in the test
+		const ulong CTROFF[4] = { 0x01ULL, 0xFF01ULL, 0xFFFFFF01ULL, 0x00FFFFFFFFFFFF01ULL };
+		const byte CTRLOW[4] = { 0xFF, 0xFF, 0x10, 0xFF };
+
+		for (size_t c = 0; c < 2; ++c)
+		{
+			for (size_t i = 0; i < 4 + TEST_LOOPS; ++i)
+			{
+				// fixed carry cases, then random offsets with runs of 0xFF in the counter
+				const ulong BLKOFF = (i < 4) ? CTROFF[i] : rng.NextUInt64(0x0FFFFFFFFFFFFFFFULL);
+				const size_t LEN = rng.NextUInt32(static_cast<uint>(data.size()), 1);
+				std::vector<byte> ctr(iv);
+				std::vector<byte> exp(LEN);
+				std::vector<byte> tmp(LEN);
+
+				// CTR uses a big endian counter, ICM a little endian counter
+				for (size_t j = 0; j < ctr.size() / 2; ++j)
+				{
+					const size_t IDX = (c == 0) ? ctr.size() - 1 - j : j;
+
+					if (i < 4)
+					{
+						ctr[IDX] = (j == 1) ? CTRLOW[i] : 0xFF;
+					}
+					else if ((rng.NextUInt32() & 1) == 0)
+					{
+						ctr[IDX] = 0xFF;
+					}
+				}
+
+				SeekTransform cipher = GetSeekCipher(c, key, ctr);
+				cipher(i % 2 == 0, BLKOFF * 16, data, 0, tmp, 0, LEN);
+
+				uint carry = 0;
+				ulong inc = BLKOFF;
+
+				for (size_t j = 0; j < ctr.size(); ++j)
+				{
+					const size_t IDX = (c == 0) ? ctr.size() - 1 - j : j;
+					const uint SUM = static_cast<uint>(ctr[IDX]) + static_cast<uint>(inc & 0xFF) + carry;
+					ctr[IDX] = static_cast<byte>(SUM);
+					carry = SUM >> 8;
+					inc >>= 8;
+				}
+
+				SeekTransform expected = GetSeekCipher(c, key, ctr);
+				expected(false, 0, data, 0, exp, 0, LEN);
+
+				if (exp != tmp)
+				{
+					throw TestException("Seek " + NAMES[c] + ": The counter carry is incorrect!");
+				}
+			}
+		}
+	}
+
 	void ParallelModeTest::CompareStmKat(IStreamCipher* Engine, std::vector<byte> Expected)
 	{
 		size_t blkSize = 4096;
@@ -1268,6 +1373,217 @@ namespace Test
 		}
 	}
 
+	void ParallelModeTest::CompareClone()
+	{
+		// a clone taken mid-stream must continue with the same output as the original
+		std::vector<byte> data;
+		std::vector<byte> enc1;
+		std::vector<byte> enc2;
+		std::vector<byte> iv(16);
+		Prng::SecureRandom rng;
+
+		data.reserve(MAX_ALLOC * 2);
+		enc1.reserve(MAX_ALLOC * 2);
+		enc2.reserve(MAX_ALLOC * 2);
+
+		for (size_t i = 0; i < TEST_LOOPS; ++i)
+		{
+			std::vector<ICipherMode*> modes;
+			// standard and hkdf key schedules, the copies must not share the kdf engine
+			modes.push_back(new Mode::CBC(new RHX()));
+			modes.push_back(new Mode::CTR(new RHX(Enumeration::Digests::SHA256, 22)));
+			modes.push_back(new Mode::ICM(new SHX(Enumeration::Digests::SHA512, 40)));
+			modes.push_back(new Mode::OFB(new THX()));
+			modes.push_back(new Mode::CTRT<RHX>(Enumeration::Digests::SHA256, 22));
+
+			const size_t BLKCNT = rng.NextUInt32(MAX_ALLOC / 16, 2);
+			const size_t SPLIT = rng.NextUInt32(static_cast<uint>(BLKCNT - 1), 1) * 16;
+			data.resize(BLKCNT * 16);
+			enc1.resize(BLKCNT * 16);
+			enc2.resize(BLKCNT * 16);
+			rng.GetBytes(data);
+			GetBytes(16, iv);
+
+			for (size_t j = 0; j < modes.size(); ++j)
+			{
+				Key::Symmetric::SymmetricKeySize keySize = modes[j]->LegalKeySizes()[modes[j]->LegalKeySizes().size() - 1];
+				std::vector<byte> key(keySize.KeySize());
+				GetBytes(key.size(), key);
+				Key::Symmetric::SymmetricKey keyParam(key, iv);
+
+				modes[j]->ParallelProfile().IsParallel() = false;
+				modes[j]->Initialize(true, keyParam);
+				modes[j]->Transform(data, 0, enc1, 0, SPLIT);
+				std::copy(enc1.begin(), enc1.begin() + SPLIT, enc2.begin());
+
+				ICipherMode* cpy = modes[j]->Clone();
+				modes[j]->Transform(data, SPLIT, enc1, SPLIT, data.size() - SPLIT);
+				// the copy owns its cipher; destroying the original must not affect it
+				delete modes[j];
+				cpy->Transform(data, SPLIT, enc2, SPLIT, data.size() - SPLIT);
+
+				if (enc1 != enc2)
+				{
+					delete cpy;
+					throw TestException("CompareClone: Cloned context output is not equal!");
+				}
+
+				IBlockCipher* eng = cpy->Engine()->Clone();
+
+				if (eng->Name() != cpy->Engine()->Name() || eng->Rounds() != cpy->Engine()->Rounds())
+				{
+					delete eng;
+					delete cpy;
+					throw TestException("CompareClone: Cloned cipher settings are not equal!");
+				}
+
+				delete eng;
+				delete cpy;
+			}
+		}
+	}
+
+	void ParallelModeTest::CompareTemplate()
+	{
+		// compares the cipher specialized counter mode with CTR over the interface
+		std::vector<byte> data;
+		std::vector<byte> dec;
+		std::vector<byte> enc1;
+		std::vector<byte> enc2;
+		std::vector<byte> key(32);
+		std::vector<byte> iv(16);
+		Prng::SecureRandom rng;
+
+		data.reserve(MAX_ALLOC * 4);
+		dec.reserve(MAX_ALLOC * 4);
+		enc1.reserve(MAX_ALLOC * 4);
+		enc2.reserve(MAX_ALLOC * 4);
+
+		Mode::CTR cpr1(BlockCiphers::Rijndael);
+		Mode::CTRT<RHX> cpr2;
+#if defined(__AVX__)
+		Mode::CTRT<AHX> cpr3;
+#endif
+
+		for (size_t i = 0; i < TEST_LOOPS; ++i)
+		{
+			const size_t SMPSZE = rng.NextUInt32(MAX_ALLOC * 4, 1);
+			data.resize(SMPSZE);
+			dec.resize(SMPSZE);
+			enc1.resize(SMPSZE);
+			enc2.resize(SMPSZE);
+			rng.GetBytes(data);
+			GetBytes(32, key);
+			GetBytes(16, iv);
+			Key::Symmetric::SymmetricKey keyParam(key, iv);
+
+			cpr1.ParallelProfile().IsParallel() = false;
+			cpr1.Initialize(true, keyParam);
+			cpr1.Transform(data, 0, enc1, 0, data.size());
+
+			cpr2.ParallelProfile().IsParallel() = (i % 2 == 0);
+			cpr2.Initialize(true, keyParam);
+			cpr2.Transform(data, 0, enc2, 0, data.size());
+
+			if (enc1 != enc2)
+			{
+				throw TestException("Template CTR: Encrypted output is not equal!");
+			}
+
+			// random access, and a nonce-only re-initialization of the keyed cipher
+			const size_t POS = rng.NextUInt32(static_cast<uint>(SMPSZE - 1));
+			std::vector<byte> zero(0);
+			Key::Symmetric::SymmetricKey nonceParam(zero, iv);
+			cpr2.Initialize(false, nonceParam);
+			cpr2.Transform(POS, enc2, POS, dec, POS, SMPSZE - POS);
+			cpr2.Transform(0, enc2, 0, dec, 0, POS);
+
+			if (dec != data)
+			{
+				throw TestException("Template CTR: Decrypted output is not equal!");
+			}
+
+#if defined(__AVX__)
+			if (m_hasAESNI)
+			{
+				cpr3.ParallelProfile().IsParallel() = (i % 2 != 0);
+				cpr3.Initialize(true, keyParam);
+				cpr3.Transform(data, 0, enc2, 0, data.size());
+
+				if (enc1 != enc2)
+				{
+					throw TestException("Template CTR: AES-NI encrypted output is not equal!");
+				}
+			}
+#endif
+		}
+
+		// the block aligned modes, each template against its interface mode
+		std::vector<std::pair<ICipherMode*, ICipherMode*>> modes;
+		modes.push_back(std::make_pair(new Mode::CBC(new RHX()), new Mode::CBCT<RHX>()));
+		modes.push_back(std::make_pair(new Mode::ECB(new RHX()), new Mode::ECBT<RHX>()));
+		modes.push_back(std::make_pair(new Mode::ICM(new RHX()), new Mode::ICMT<RHX>()));
+#if defined(__AVX__)
+		if (m_hasAESNI)
+		{
+			modes.push_back(std::make_pair(new Mode::CBC(BlockCiphers::Rijndael), new Mode::CBCT<AHX>()));
+			modes.push_back(std::make_pair(new Mode::ECB(BlockCiphers::Rijndael), new Mode::ECBT<AHX>()));
+			modes.push_back(std::make_pair(new Mode::ICM(BlockCiphers::Rijndael), new Mode::ICMT<AHX>()));
+		}
+#endif
+
+		for (size_t i = 0; i < modes.size(); ++i)
+		{
+			ICipherMode* mode1 = modes[i].first;
+			ICipherMode* mode2 = modes[i].second;
+
+			for (size_t j = 0; j < TEST_LOOPS; ++j)
+			{
+				// a parallel block and a remainder of whole blocks
+				const size_t SMPSZE = mode2->ParallelBlockSize() + (rng.NextUInt32(MAX_ALLOC / 16, 1) * 16);
+				data.resize(SMPSZE);
+				dec.resize(SMPSZE);
+				enc1.resize(SMPSZE);
+				enc2.resize(SMPSZE);
+				rng.GetBytes(data);
+				GetBytes(32, key);
+				GetBytes(16, iv);
+				Key::Symmetric::SymmetricKey keyParam(key, iv);
+
+				mode1->ParallelProfile().IsParallel() = false;
+				mode1->Initialize(true, keyParam);
+				mode1->Transform(data, 0, enc1, 0, data.size());
+
+				mode2->ParallelProfile().IsParallel() = (j % 2 == 0);
+				mode2->Initialize(true, keyParam);
+				mode2->Transform(data, 0, enc2, 0, data.size());
+
+				if (enc1 != enc2)
+				{
+					std::string name = mode2->Name();
+					delete mode1;
+					delete mode2;
+					throw TestException("Template " + name + ": Encrypted output is not equal!");
+				}
+
+				mode2->ParallelProfile().IsParallel() = true;
+				mode2->Initialize(false, keyParam);
+				mode2->Transform(enc2, 0, dec, 0, enc2.size());
+
+				if (dec != data)
+				{
+					std::string name = mode2->Name();
+					delete mode1;
+					delete mode2;
+					throw TestException("Template " + name + ": Decrypted output is not equal!");
+				}
+			}
+
+			delete mode1;
+			delete mode2;
+		}
+	}
+
 	//~~~Helpers~~~//
 
 	void ParallelModeTest::BlockCTR(Mode::ICipherMode* Cipher, const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset)
@@ -1331,6 +1647,59 @@ namespace Test
 		}
 	}
 
+	ParallelModeTest::SeekTransform ParallelModeTest::GetSeekCipher(size_t Index, const std::vector<byte> &Key, const std::vector<byte> &Nonce)
+	{
+		Key::Symmetric::SymmetricKey kp(Key, Nonce);
+
+		switch (Index)
+		{
+			case 0:
+			{
+				std::shared_ptr<Mode::CTR> cpr(new Mode::CTR(BlockCiphers::Rijndael));
+				cpr->Initialize(true, kp);
+
+				return [cpr](bool Parallel, ulong Position, const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset, size_t Length)
+				{
+					cpr->ParallelProfile().IsParallel() = Parallel;
+					cpr->Transform(Position, Input, InOffset, Output, OutOffset, Length);
+				};
+			}
+			case 1:
+			{
+				std::shared_ptr<Mode::ICM> cpr(new Mode::ICM(BlockCiphers::Rijndael));
+				cpr->Initialize(true, kp);
+
+				return [cpr](bool Parallel, ulong Position, const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset, size_t Length)
+				{
+					cpr->ParallelProfile().IsParallel() = Parallel;
+					cpr->Transform(Position, Input, InOffset, Output, OutOffset, Length);
+				};
+			}
+			case 2:
+			{
+				std::shared_ptr<ChaCha20> cpr(new ChaCha20());
+				cpr->Initialize(kp);
+
+				return [cpr](bool Parallel, ulong Position, const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset, size_t Length)
+				{
+					cpr->ParallelProfile().IsParallel() = Parallel;
+					cpr->Transform(Position, Input, InOffset, Output, OutOffset, Length);
+				};
+			}
+			default:
+			{
+				std::shared_ptr<Salsa20> cpr(new Salsa20());
+				cpr->Initialize(kp);
+
+				return [cpr](bool Parallel, ulong Position, const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset, size_t Length)
+				{
+					cpr->ParallelProfile().IsParallel() = Parallel;
+					cpr->Transform(Position, Input, InOffset, Output, OutOffset, Length);
+				};
+			}
+		}
+	}
+
 	void ParallelModeTest::GetBytes(size_t Size, std::vector<byte> &Output)
 	{
 		Output.resize(Size, 0);
@@ -5,6 +5,7 @@
 #include "../CEX/IBlockCipher.h"
 #include "../CEX/ICipherMode.h"
 #include "../CEX/IStreamCipher.h"
+#include <functional>
 
 namespace Test
 {
@@ -36,6 +37,9 @@ namespace Test
 		size_t m_processorCount;
 		TestEventHandler m_progressEvent;
 
+		// a keyed CTR/ICM/ChaCha/Salsa instance; sets the parallel mode and runs the positional transform
+		typedef std::function<void(bool, ulong, const std::vector<byte>&, size_t, std::vector<byte>&, size_t, size_t)> SeekTransform;
+
     public:
 		/// <summary>
 		/// Get: The test description
@@ -74,14 +78,20 @@ namespace Test
 		void CompareBcrSimd(IBlockCipher* Engine);
 		// Looping integrity tests, compares CBC Decrypt multi-threaded/SIMD with sequentially generated output
 		void CompareCbcDecrypt(IBlockCipher* Engine1, IBlockCipher* Engine2);
+		// Looping integrity test, compares cloned CBC/CTR/ICM/OFB contexts with the output of the original instance
+		void CompareClone();
 		// Looping CBC/CFB/CTR integrity tests, compares sequential to parallel output
 		void CompareParallelLoop();
 		// Compares CBC/CFB/CTR output check, compares output across each block access method 
 		void CompareParallelOutput();
+		// Looping random access test, compares CTR/ICM/ChaCha/Salsa positional transform output with sequentially generated output, and checks the CTR/ICM counter carry
+		void CompareSeek();
 		// Looping reduction Kat, compares parallel Salsa/Chacha with vectors generated in sequential mode
 		void CompareStmKat(IStreamCipher* Engine, std::vector<byte> Expected);
 		// Looping integrity test, compares Salsa/Chacha multi-threaded/SIMD with sequentially generated output
 		void CompareStmSimd(IStreamCipher* Engine);
+		// Looping integrity test, compares the cipher specialized CBCT, CTRT, ECBT, and ICMT templates with the CBC, CTR, ECB, and ICM output
+		void CompareTemplate();
 		// test each cipher modes access methods, e.g. sequential and parallel Transform() api
 		void AccessCheck(ICipherMode* Cipher);
 
@@ -89,6 +99,7 @@ namespace Test
 		void BlockDecrypt(Mode::ICipherMode* Cipher, const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset);
 		void BlockEncrypt(Mode::ICipherMode* Cipher, const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset);
 		void GetBytes(size_t Size, std::vector<byte> &Output);
+		SeekTransform GetSeekCipher(size_t Index, const std::vector<byte> &Key, const std::vector<byte> &Nonce);
 		void Initialize();
 		void OnProgress(std::string Data);
 		void ParallelCTR(Mode::ICipherMode* Cipher, const std::vector<byte> &Input, size_t InOffset, std::vector<byte> &Output, size_t OutOffset);
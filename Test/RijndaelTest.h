@@ -50,6 +50,7 @@ namespace Test
 		virtual std::string Run();
         
     private:
+		void CompareParallel();
 		void CompareVector(std::vector<byte> &Key, std::vector<byte> &Input, std::vector<byte> &Output);
 		void Initialize();
 		void OnProgress(std::string Data);
@@ -1,13 +1,18 @@
 #include "RingLWETest.h"
+#include "HexConverter.h"
+#include "../CEX/AeadStream.h"
 #include "../CEX/BCR.h"
+#include "../CEX/CryptoAuthenticationFailure.h"
 #include "../CEX/DrbgFromName.h"
 #include "../CEX/IAsymmetricKeyPair.h"
+#include "../CEX/MemoryStream.h"
 #include "../CEX/RHX.h"
 #include "../CEX/RingLWE.h"
 #include "../CEX/RLWEKeyPair.h"
 #include "../CEX/RLWEPrivateKey.h"
 #include "../CEX/RLWEPublicKey.h"
 #include "../CEX/SecureRandom.h"
+#include "../CEX/SHA256.h"
 
 namespace Test
 {
@@ -17,6 +22,11 @@ namespace Test
 	const std::string RingLWETest::DESCRIPTION = "RingLWE key generation, encryption, and decryption tests..";
 	const std::string RingLWETest::FAILURE = "FAILURE! ";
 	const std::string RingLWETest::SUCCESS = "SUCCESS! RingLWE tests have executed succesfully.";
+#if defined(CEX_RLWE_TESTSETS)
+	const std::vector<Enumeration::RLWEParams> RingLWETest::PARAMSETS = { Enumeration::RLWEParams::Q12289N1024, Enumeration::RLWEParams::Q40961N1024, Enumeration::RLWEParams::Q7681N256 };
+#else
+	const std::vector<Enumeration::RLWEParams> RingLWETest::PARAMSETS = { Enumeration::RLWEParams::Q12289N1024, Enumeration::RLWEParams::Q40961N1024 };
+#endif
 
 	RingLWETest::RingLWETest()
 		:
@@ -32,10 +42,18 @@ namespace Test
 	{
 		try
 		{
+			KnownAnswer();
+			OnProgress(std::string("RingLWETest: Passed parameter set known answer tests.."));
 			StressLoop();
 			OnProgress(std::string("RingLWETest: Passed encryption and Decryption stress tests.."));
+			BatchStress();
+			OnProgress(std::string("RingLWETest: Passed batch key generation and encryption tests.."));
 			SerializationCompare();
 			OnProgress(std::string("RingLWETest: Passed key serialization tests.."));
+			ExpansionCache();
+			OnProgress(std::string("RingLWETest: Passed public polynomial expansion cache tests.."));
+			StreamStress();
+			OnProgress(std::string("RingLWETest: Passed stream encryption tests.."));
 
 			return SUCCESS;
 		}
@@ -49,6 +67,177 @@ namespace Test
 		}
 	}
 
+	void RingLWETest::BatchStress()
+	{
+		std::vector<byte> dec;
+		std::vector<std::vector<byte>> enc;
+		std::vector<std::vector<byte>> msg(16);
+		Prng::SecureRandom rnd;
+
+		for (size_t i = 0; i < msg.size(); ++i)
+		{
+			msg[i].resize(16 + i);
+			rnd.GetBytes(msg[i]);
+		}
+
+		for (size_t s = 0; s < PARAMSETS.size(); ++s)
+		{
+			RingLWE cpr(PARAMSETS[s]);
+			std::vector<IAsymmetricKeyPair*> kps = cpr.Generate(8);
+
+			if (kps.size() != 8 || cpr.Generate(0).size() != 0)
+			{
+				throw TestException("RingLWETest: The key-pair batch is the wrong size!");
+			}
+
+			for (size_t i = 0; i < kps.size(); ++i)
+			{
+				cpr.Initialize(true, kps[i]);
+				enc = cpr.Encrypt(msg);
+
+				if (enc.size() != msg.size())
+				{
+					throw TestException("RingLWETest: The encrypted batch is the wrong size!");
+				}
+
+				cpr.Initialize(false, kps[i]);
+
+				for (size_t j = 0; j < enc.size(); ++j)
+				{
+					dec = cpr.Decrypt(enc[j]);
+
+					if (dec != msg[j])
+					{
+						throw TestException("RingLWETest: Decrypted batch output is not equal!");
+					}
+				}
+
+				FreeKeys(kps[i]);
+			}
+		}
+	}
+
+	void RingLWETest::ExpansionCache()
+	{
+		std::vector<byte> dec;
+		std::vector<byte> enc;
+		std::vector<byte> msg(64);
+		Prng::SecureRandom rnd;
+
+		RingLWE cpr1(Enumeration::RLWEParams::Q12289N1024);
+		RingLWE cpr2(Enumeration::RLWEParams::Q12289N1024);
+
+		for (size_t i = 0; i < 10; ++i)
+		{
+			rnd.GetBytes(msg);
+			IAsymmetricKeyPair* kp1 = cpr1.Generate();
+			RLWEPublicKey* pubK1 = (RLWEPublicKey*)kp1->PublicKey();
+			// the generated key carries the expansion, a deserialized key is expanded by Initialize
+			RLWEPublicKey* pubK2 = new RLWEPublicKey(pubK1->ToBytes());
+			std::vector<byte> tag = kp1->Tag();
+			IAsymmetricKeyPair* kp2 = new RLWEKeyPair(nullptr, pubK2, tag);
+
+			if (pubK2->A().size() != 0)
+			{
+				throw TestException("RingLWETest: The expanded polynomial was serialized!");
+			}
+
+			cpr2.Initialize(true, kp2);
+
+			if (pubK1->A() != pubK2->A())
+			{
+				throw TestException("RingLWETest: The cached public polynomial expansion is not equal!");
+			}
+
+			enc = cpr2.Encrypt(msg);
+			cpr1.Initialize(false, kp1);
+			dec = cpr1.Decrypt(enc);
+
+			FreeKeys(kp1);
+			FreeKeys(kp2);
+
+			if (dec != msg)
+			{
+				throw TestException("RingLWETest: Decrypted output is not equal!");
+			}
+		}
+	}
+
+	void RingLWETest::FreeKeys(IAsymmetricKeyPair* KeyPair)
+	{
+		// the key pair and the cipher do not own the keys
+		delete KeyPair->PrivateKey();
+		delete KeyPair->PublicKey();
+		delete KeyPair;
+	}
+
+	void RingLWETest::KnownAnswer()
+	{
+		// the SHA256 hashes of the public key and cipher-text of each parameter set, created from a seeded generator;
+		// the scalar and SIMD transforms must produce the same output
+		const std::vector<std::string> EXPECTED =
+		{
+			"C2802E1413E3F2AE5B2F7840181DF7F621B86ED1234C6C7FB33C31C605291952",
+			"75769846F9F129752E484EE45254C837FD81A4325F8AB38AA199E6DE907F0F3B",
+			"81591AD58EE7F9EEC204AB48BBACAB0EA89C2324581B54CF6A3011225C480671",
+			"31DEBC1AC9B423411EF571F57863C4986018E1FDBDD8000F604D4DDB655AE4B3",
+			"488395459089DC9E26D5BF54A5CE8D987EE269763DAD36A5CF692E9DC110555F",
+			"AC80650FD2D3E98DAC330F1B8CB0C532DE09DE3887F0CD0DC31700C319DDED66"
+		};
+		std::vector<byte> dec;
+		std::vector<byte> enc;
+		std::vector<byte> exp;
+		std::vector<byte> hash(32);
+		std::vector<byte> msg(32);
+		std::vector<byte> seed(32);
+		Digest::SHA256 dgt;
+
+		for (size_t i = 0; i < seed.size(); ++i)
+		{
+			seed[i] = static_cast<byte>(i);
+			msg[i] = static_cast<byte>(0xFF - i);
+		}
+
+		for (size_t s = 0; s < PARAMSETS.size(); ++s)
+		{
+			Prng::BCR* rngPtr = new Prng::BCR(seed, Enumeration::BlockCiphers::Rijndael, false);
+			Cipher::Symmetric::Block::RHX* sycPtr = new Cipher::Symmetric::Block::RHX();
+			RingLWE* cpr = new RingLWE(PARAMSETS[s], rngPtr, sycPtr, false);
+			IAsymmetricKeyPair* kp = cpr->Generate();
+
+			cpr->Initialize(true, kp);
+			enc = cpr->Encrypt(msg);
+			dgt.Compute(((RLWEPublicKey*)kp->PublicKey())->P(), hash);
+			HexConverter::Decode(EXPECTED[2 * s], exp);
+
+			if (hash != exp)
+			{
+				throw TestException("RingLWETest: The public key does not match the known answer!");
+			}
+
+			dgt.Compute(enc, hash);
+			HexConverter::Decode(EXPECTED[(2 * s) + 1], exp);
+
+			if (hash != exp)
+			{
+				throw TestException("RingLWETest: The cipher-text does not match the known answer!");
+			}
+
+			cpr->Initialize(false, kp);
+			dec = cpr->Decrypt(enc);
+
+			delete cpr;
+			FreeKeys(kp);
+			delete rngPtr;
+			delete sycPtr;
+
+			if (dec != msg)
+			{
+				throw TestException("RingLWETest: Decrypted output is not equal!");
+			}
+		}
+	}
+
 	void RingLWETest::SerializationCompare()
 	{
 		std::vector<byte> skey;
@@ -67,6 +256,14 @@ namespace Test
 				throw TestException("RingLWETest: Private key serialization test has failed!");
 			}
 
+			skey = priK1->ToImage();
+			RLWEPrivateKey priK3((IO::ByteView(skey)));
+
+			if (priK1->R() != priK3.R() || priK1->Parameters() != priK3.Parameters())
+			{
+				throw TestException("RingLWETest: Private key image test has failed!");
+			}
+
 			RLWEPublicKey* pubK1 = (RLWEPublicKey*)kp->PublicKey();
 			skey = pubK1->ToBytes();
 			RLWEPublicKey pubK2(skey);
@@ -76,9 +273,130 @@ namespace Test
 				throw TestException("RingLWETest: Public key serialization test has failed!");
 			}
 
-			delete kp;
-			delete priK1;
-			delete pubK1;
+			skey = pubK1->ToImage();
+			RLWEPublicKey pubK3((IO::ByteView(skey)));
+
+			if (pubK1->P() != pubK3.P() || pubK1->Parameters() != pubK3.Parameters())
+			{
+				throw TestException("RingLWETest: Public key image test has failed!");
+			}
+
+			FreeKeys(kp);
+		}
+	}
+
+	void RingLWETest::StreamStress()
+	{
+		const size_t CNKSZE = Processing::AeadStream::CHUNK_SIZE;
+		const size_t TAGSZE = 16;
+		// empty, single byte, either side of a chunk boundary, and several windows
+		const std::vector<size_t> MSGLEN = { 0, 1, CNKSZE - 1, CNKSZE, CNKSZE + 1, (3 * 1024 * 1024) + 17 };
+		Prng::SecureRandom rnd;
+
+		for (size_t s = 0; s < PARAMSETS.size(); ++s)
+		{
+			RingLWE cpr(PARAMSETS[s]);
+			IAsymmetricKeyPair* kp = cpr.Generate();
+			const size_t HDRSZE = cpr.ParamSet().ReturnMessageSize;
+
+			for (size_t i = 0; i < MSGLEN.size(); ++i)
+			{
+				std::vector<byte> msg(MSGLEN[i]);
+
+				if (msg.size() != 0)
+				{
+					rnd.GetBytes(msg);
+				}
+
+
+				IO::MemoryStream inp(msg);
+				IO::MemoryStream enc;
+				cpr.Initialize(true, kp);
+				cpr.Encrypt(&inp, &enc);
+
+				if (enc.Length() != HDRSZE + Processing::AeadStream::SealedLength(msg.size(), TAGSZE))
+				{
+					throw TestException("RingLWETest: The encrypted stream is the wrong size!");
+				}
+
+				IO::MemoryStream ctx(enc.ToArray());
+				IO::MemoryStream dec;
+				cpr.Initialize(false, kp);
+				cpr.Decrypt(&ctx, &dec);
+
+				if (dec.ToArray() != msg)
+				{
+					throw TestException("RingLWETest: Decrypted stream output is not equal!");
+				}
+
+				// an altered byte in the last chunk must fail authentication
+				std::vector<byte> cpt = enc.ToArray();
+				cpt[cpt.size() - 1] ^= 1;
+				IO::MemoryStream alt(cpt);
+				IO::MemoryStream out;
+				bool status = false;
+
+				try
+				{
+					cpr.Decrypt(&alt, &out);
+				}
+				catch (Exception::CryptoAuthenticationFailure const &)
+				{
+					status = true;
+				}
+
+				if (!status)
+				{
+					throw TestException("RingLWETest: Stream authentication test has failed!");
+				}
+
+				// a stream cut on a chunk boundary must fail authentication
+				if (msg.size() > CNKSZE)
+				{
+					cpt = enc.ToArray();
+					cpt.resize(HDRSZE + CNKSZE + TAGSZE);
+					IO::MemoryStream trn(cpt);
+					IO::MemoryStream trd;
+					status = false;
+
+					try
+					{
+						cpr.Decrypt(&trn, &trd);
+					}
+					catch (Exception::CryptoAuthenticationFailure const &)
+					{
+						status = true;
+					}
+
+					if (!status || trd.Length() != 0)
+					{
+						throw TestException("RingLWETest: Stream truncation test has failed!");
+					}
+				}
+
+				// data appended to the stream must be rejected, including a fragment the size of a tag
+				cpt = enc.ToArray();
+				cpt.resize(cpt.size() + TAGSZE);
+				IO::MemoryStream apd(cpt);
+				IO::MemoryStream apo;
+				status = false;
+
+				try
+				{
+					cpr.Decrypt(&apd, &apo);
+				}
+				catch (Exception::CryptoAuthenticationFailure const &)
+				{
+					status = true;
+				}
+
+				if (!status)
+				{
+					throw TestException("RingLWETest: Stream extension test has failed!");
+				}
+			}
+
+			FreeKeys(kp);
 		}
 	}
 
@@ -108,7 +426,7 @@ namespace Test
 			cpr1.Initialize(false, kp);
 			dec = cpr1.Decrypt(enc);
 
-			delete kp;
+			FreeKeys(kp);
 
 			if (dec != msg)
 			{
@@ -116,27 +434,55 @@ namespace Test
 			}
 		}
 
-		// test the standard cipher implementation
-		RingLWE cpr2(Enumeration::RLWEParams::Q12289N1024, Enumeration::Prngs::BCR, Enumeration::BlockCiphers::Rijndael);
+		// test the standard cipher implementation with each parameter set
 		msg.resize(64);
 
-		for (size_t i = 0; i < 100; ++i)
+		for (size_t s = 0; s < PARAMSETS.size(); ++s)
 		{
-			rnd.GetBytes(msg);
-			IAsymmetricKeyPair* kp = cpr2.Generate();
+			RingLWE cpr2(PARAMSETS[s], Enumeration::Prngs::BCR, Enumeration::BlockCiphers::Rijndael);
 
-			cpr2.Initialize(true, kp);
-			enc = cpr2.Encrypt(msg);
+			for (size_t i = 0; i < 100; ++i)
+			{
+				rnd.GetBytes(msg);
+				IAsymmetricKeyPair* kp = cpr2.Generate();
 
-			cpr2.Initialize(false, kp);
-			dec = cpr2.Decrypt(enc);
+				cpr2.Initialize(true, kp);
+				enc = cpr2.Encrypt(msg);
 
-			delete kp;
+				cpr2.Initialize(false, kp);
+				dec = cpr2.Decrypt(enc);
 
-			if (dec != msg)
+				FreeKeys(kp);
+
+				if (dec != msg)
+				{
+					throw TestException("RingLWETest: Decrypted output is not equal!");
+				}
+			}
+
+			// a key from another parameter set must be rejected
+			RingLWE cpr3(PARAMSETS[(s + 1) % PARAMSETS.size()]);
+			IAsymmetricKeyPair* kp = cpr2.Generate();
+
+			try
 			{
-				throw TestException("RingLWETest: Decrypted output is not equal!");
+				cpr3.Initialize(true, kp);
+				throw TestException("RingLWETest: A public key from another parameter set was accepted!");
 			}
+			catch (Exception::CryptoAsymmetricException const &)
+			{
+			}
+
+			try
+			{
+				cpr3.Initialize(false, kp);
+				throw TestException("RingLWETest: A private key from another parameter set was accepted!");
+			}
+			catch (Exception::CryptoAsymmetricException const &)
+			{
+			}
+
+			FreeKeys(kp);
 		}
 
 		if (rngPtr == nullptr)
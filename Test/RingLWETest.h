@@ -2,6 +2,8 @@
 #define _CEXTEST_RINGLWETEST_H
 
 #include "ITest.h"
+#include "../CEX/IAsymmetricKeyPair.h"
+#include "../CEX/RLWEParams.h"
 
 namespace Test
 {
@@ -14,6 +16,7 @@ namespace Test
 		static const std::string DESCRIPTION;
 		static const std::string FAILURE;
 		static const std::string SUCCESS;
+		static const std::vector<Enumeration::RLWEParams> PARAMSETS;
 
 		TestEventHandler m_progressEvent;
 
@@ -45,7 +48,12 @@ namespace Test
 
 	private:
 
+		void BatchStress();
+		void ExpansionCache();
+		static void FreeKeys(Key::Asymmetric::IAsymmetricKeyPair* KeyPair);
+		void KnownAnswer();
 		void OnProgress(std::string Data);
+		void StreamStress();
 		void StressLoop();
 		void SerializationCompare();
 	};
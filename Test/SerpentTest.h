@@ -51,6 +51,7 @@ namespace Test
     private:
 		void CompareMonteCarlo(std::vector<byte> &Key, std::vector<byte> &Input, std::vector<byte> &Output, size_t Count = 100);
 		void CompareOutput();
+		void CompareParallel();
 		void CompareVector(std::vector<byte> &Key, std::vector<byte> &Input, std::vector<byte> &Output);
 		void OnProgress(std::string Data);
     };
@@ -1,5 +1,6 @@
 #include "TwofishTest.h"
 #include "../CEX/THX.h"
+#include "../CEX/SecureRandom.h"
 
 namespace Test
 {
@@ -118,6 +119,9 @@ namespace Test
 			CompareMonteCarlo(key, m_plainText, output, false);
 			OnProgress(std::string("TwofishTest: Passed 10,000 round 256 bit key Monte Carlo decryption test.."));
 
+			CompareParallel();
+			OnProgress(std::string("TwofishTest: Passed 512, 1024 and 2048bit parallel transform comparison tests.."));
+
 			return SUCCESS;
 		}
 		catch (TestException const &ex)
@@ -150,6 +154,92 @@ namespace Test
 		}
 	}
 
+	void TwofishTest::CompareParallel()
+	{
+		const size_t DATLEN = 1024;
+		std::vector<byte> data(DATLEN);
+		std::vector<byte> dec1(DATLEN);
+		std::vector<byte> dec2(DATLEN);
+		std::vector<byte> enc1(DATLEN);
+		std::vector<byte> enc2(DATLEN);
+		THX engine;
+		std::vector<Key::Symmetric::SymmetricKeySize> keySizes = engine.LegalKeySizes();
+		Prng::SecureRandom rng;
+
+		// the wide transforms must match the sequential block transform for every key size
+		for (size_t i = 0; i < keySizes.size(); ++i)
+		{
+			std::vector<byte> key(keySizes[i].KeySize());
+			rng.GetBytes(key);
+			rng.GetBytes(data);
+			Key::Symmetric::SymmetricKey k(key);
+
+			engine.Initialize(true, k);
+
+			for (size_t j = 0; j < DATLEN; j += 16)
+			{
+				engine.Transform(data, j, enc1, j);
+			}
+
+			for (size_t j = 0; j < DATLEN; j += 64)
+			{
+				engine.Transform512(data, j, enc2, j);
+			}
+
+			if (enc1 != enc2)
+			{
+				throw TestException("TwofishTest: Transform512 encrypted arrays are not equal!");
+			}
+
+			for (size_t j = 0; j < DATLEN; j += 128)
+			{
+				engine.Transform1024(data, j, enc2, j);
+			}
+
+			if (enc1 != enc2)
+			{
+				throw TestException("TwofishTest: Transform1024 encrypted arrays are not equal!");
+			}
+
+			for (size_t j = 0; j < DATLEN; j += 256)
+			{
+				engine.Transform2048(data, j, enc2, j);
+			}
+
+			if (enc1 != enc2)
+			{
+				throw TestException("TwofishTest: Transform2048 encrypted arrays are not equal!");
+			}
+
+			engine.Initialize(false, k);
+
+			for (size_t j = 0; j < DATLEN; j += 16)
+			{
+				engine.Transform(enc1, j, dec1, j);
+			}
+
+			for (size_t j = 0; j < DATLEN; j += 256)
+			{
+				engine.Transform2048(enc1, j, dec2, j);
+			}
+
+			if (dec1 != data || dec2 != data)
+			{
+				throw TestException("TwofishTest: Decrypted arrays are not equal!");
+			}
+
+			for (size_t j = 0; j < DATLEN; j += 128)
+			{
+				engine.Transform1024(enc1, j, dec2, j);
+			}
+
+			if (dec2 != data)
+			{
+				throw TestException("TwofishTest: Transform1024 decrypted arrays are not equal!");
+			}
+		}
+	}
+
 	void TwofishTest::CompareVector(std::vector<byte> &Key, std::vector<byte> &Input, std::vector<byte> &Output)
 	{
 		std::vector<byte> outBytes(Input.size(), 0);